@@ -16,11 +16,17 @@
 //                Global (public) functions:
 //                  AM2305_Init();
 //                  AM2305_GetHumidityTemperature();
+//                  AM2305_Decode();
+//                  AM2305_DecoderReset();
+//                  AM2305_DecoderPush();
+//                  AM2305_DecoderGetResult();
 //
 //                Local (private) functions:
 //                  AM2305_DQLow();
 //                  AM2305_DQInput();
 //                  AM2305_DQGetValue();
+//                  AM2305_CapturePolling();
+//                  AM2305_CaptureDMA();
 //                  
 //
 //--------------------------------------------------------------------------------------------------
@@ -50,7 +56,14 @@
 // Verification of the imported configuration parameters
 //**************************************************************************************************
 
-// None.
+#if ((AM2305_CAPTURE_POLLING != AM2305_CAPTURE_MODE) && (AM2305_CAPTURE_DMA != AM2305_CAPTURE_MODE))
+#error "AM2305_CAPTURE_MODE must be AM2305_CAPTURE_POLLING or AM2305_CAPTURE_DMA"
+#endif
+
+// Windows of the signal "0" and "1" must not overlap: (30 + tol) < (68 - tol)
+#if ((2U * AM2305_TIME_TOLERANCE_US) >= (68U - 30U))
+#error "AM2305_TIME_TOLERANCE_US is too big"
+#endif
 
 
 
@@ -68,14 +81,12 @@
 
 typedef enum AM2305_SIGNAL_STATUS_enum
 {
-    AM2305_SIGNAL_STATUS_START=0,
-    AM2305_SIGNAL_STATUS_GO,
-    AM2305_SIGNAL_STATUS_RESPONSE_LOW,
+    AM2305_SIGNAL_STATUS_RESPONSE_LOW=0,
     AM2305_SIGNAL_STATUS_RESPONSE_HIGH,
-    AM2305_SIGNAL_STATUS_SIGNAL_0_1_LOW,
-    AM2305_SIGNAL_STATUS_SIGNAL_0_HIGH,
-    AM2305_SIGNAL_STATUS_SIGNAL_1_HIGH,
-    AM2305_SIGNAL_STATUS_END
+    AM2305_SIGNAL_STATUS_SIGNAL_LOW,
+    AM2305_SIGNAL_STATUS_SIGNAL_HIGH,
+    AM2305_SIGNAL_STATUS_END,
+    AM2305_SIGNAL_STATUS_ERROR
 }AM2305_SIGNAL_STATUS;
 
 
@@ -138,6 +149,14 @@ typedef enum AM2305_SIGNAL_STATUS_enum
 #define AM2305_QTY_MEAS             (100U)
 // General time measure
 #define AM2305_TIME_MEAS_US         (6000U)
+// Host the start signal down time when the task sleeps, ms
+#define AM2305_TIME_T_BE_MS         (2U)
+// Timeout of the end of the measurement, ms
+#define AM2305_CAPTURE_TIMEOUT_MS   ((AM2305_TIME_MEAS_US / 1000U) + 4U)
+// Duration is in the window of the pulse widened by the tolerance
+#define AM2305_IN_RANGE(duration, min, max) \
+    (((uint32_t)(duration) + AM2305_TIME_TOLERANCE_US >= (uint32_t)(min)) && \
+     ((uint32_t)(duration) <= (uint32_t)(max) + AM2305_TIME_TOLERANCE_US))
 
 
 //**************************************************************************************************
@@ -150,6 +169,17 @@ void (*pAM2305_Delay)(uint32_t us);
 // Tim handler
 static TIM_HandleTypeDef    AM2305_TimDelayHandle;
 
+#if (AM2305_CAPTURE_DMA == AM2305_CAPTURE_MODE)
+// Captures of the edges of the signal
+static uint16_t AM2305_aMeasurements[AM2305_QTY_MEAS];
+
+// DMA handler of the capture channel
+static DMA_HandleTypeDef    AM2305_DmaHandle;
+
+// Task waiting for the end of the measurement
+static TaskHandle_t AM2305_hTask = NULL;
+#endif
+
 
 
 //**************************************************************************************************
@@ -165,12 +195,20 @@ static void AM2305_DQInput(void);
 // Get DQ value
 static GPIO_PinState AM2305_DQGetValue(void);
 
+#if (AM2305_CAPTURE_DMA == AM2305_CAPTURE_MODE)
+// Capture the signal by DMA and decode it
+static void AM2305_CaptureDMA(AM2305_DECODER *const pDecoder);
+#else
 // Delay function
 static void AM2305_Delay(uint32_t microseconds);
 
 // capture time.
 static STD_RESULT AM2305_CaptureTime(uint32_t *const microseconds);
 
+// Capture the signal by polling and decode it
+static void AM2305_CapturePolling(AM2305_DECODER *const pDecoder);
+#endif
+
 
 
 //**************************************************************************************************
@@ -234,6 +272,25 @@ void AM2305_Init(void)
     // Enable capture
     HAL_TIM_IC_Start(&AM2305_TimDelayHandle, TIM_CHANNEL_1);
 
+#if (AM2305_CAPTURE_DMA == AM2305_CAPTURE_MODE)
+    // Configure DMA CCR1 -> memory
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    AM2305_DmaHandle.Instance                 = AM2305_DMA_CHANNEL;
+    AM2305_DmaHandle.Init.Request             = AM2305_DMA_REQUEST;
+    AM2305_DmaHandle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    AM2305_DmaHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    AM2305_DmaHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    AM2305_DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    AM2305_DmaHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    AM2305_DmaHandle.Init.Mode                = DMA_NORMAL;
+    AM2305_DmaHandle.Init.Priority            = DMA_PRIORITY_HIGH;
+    HAL_DMA_Init(&AM2305_DmaHandle);
+
+    // Timer update ends the measurement
+    HAL_NVIC_SetPriority(AM2305_TIMER_IRQn, AM2305_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(AM2305_TIMER_IRQn);
+#endif
+
 }// end of AM2305_Init();
 
 
@@ -253,136 +310,229 @@ void AM2305_Init(void)
 //**************************************************************************************************
 STD_RESULT AM2305_GetHumidityTemperature(float *const humidity,float *const temperature)
 {
-    STD_RESULT result = RESULT_OK;
-    AM2305_SIGNAL_STATUS AM2305_SignalStatus = AM2305_SIGNAL_STATUS_RESPONSE_LOW;
-    uint8_t data[AM2305_QTY_DATA_BITS/8];
-    uint8_t cntBit=0;
-    uint8_t cntByte=0;
-    uint32_t time=0;
-    uint32_t timesOld=0;
-    uint32_t cnt=0;
-    uint16_t measurements[AM2305_QTY_MEAS];
-    uint8_t bit=0;
+    STD_RESULT result = RESULT_NOT_OK;
+    AM2305_DECODER stDecoder;
 
+    AM2305_DecoderReset(&stDecoder);
+
+    // Capture and decode durations between the edges of the signal
+#if (AM2305_CAPTURE_DMA == AM2305_CAPTURE_MODE)
+    AM2305_CaptureDMA(&stDecoder);
+#else
+    AM2305_CapturePolling(&stDecoder);
+#endif
+
+    // Parse received data
+    result = AM2305_DecoderGetResult(&stDecoder, humidity, temperature);
+
+    return result;
+
+}// end of AM2305_GetHumidityTemperature()
 
-    // Start communicate. Getting response from sensor
-    // Start signal
-    AM2305_DQLow();
-    
-    // Host the start signal down time
-    AM2305_Delay(AM2305_TIME_T_BE_US);
-    
-    // High DQ
-    AM2305_DQInput();
-    AM2305_TIMER->SR = (uint16_t)~(TIM_FLAG_CC1|TIM_FLAG_UPDATE);
-    AM2305_TIMER->CNT = 0;
 
-    while(AM2305_TIMER->CNT < AM2305_TIME_MEAS_US)
+
+//**************************************************************************************************
+// @Function      AM2305_Decode()
+//--------------------------------------------------------------------------------------------------
+// @Description   Decode humidity and temperature from the durations between the edges.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Feeds the table to the incremental decoder.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - all bits were received and parity byte is correct
+//                RESULT_NOT_OK - otherwise
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pDurations - durations between the edges, us
+//                qty - quantity of durations
+//                humidity - get the humidity
+//                temperature - get the temperature
+//**************************************************************************************************
+STD_RESULT AM2305_Decode(const uint16_t *const pDurations,
+                         const uint32_t qty,
+                         float *const humidity,
+                         float *const temperature)
+{
+    AM2305_DECODER stDecoder;
+    AM2305_DECODE_STATUS enStatus = AM2305_DECODE_BUSY;
+
+    AM2305_DecoderReset(&stDecoder);
+
+    for (uint32_t i = 0; (i < qty) && (AM2305_DECODE_BUSY == enStatus); i++)
     {
-        result = AM2305_CaptureTime(&time);
-        if (RESULT_OK == result)
-        {
-            //AM2305_DQGetValue();
-            measurements[cnt] = time - timesOld;
-            timesOld = time;
-            if (cnt == (AM2305_QTY_MEAS-1))
-                break;
-            cnt++;
-        }
-        else
-        {
-            break;
-        }
+        enStatus = AM2305_DecoderPush(&stDecoder, pDurations[i]);
     }
-    // End communicate.
 
-    // Start parsing received data.
-    if (0 != cnt)
+    return AM2305_DecoderGetResult(&stDecoder, humidity, temperature);
+}// end of AM2305_Decode()
+
+
+
+//**************************************************************************************************
+// @Function      AM2305_DecoderReset()
+//--------------------------------------------------------------------------------------------------
+// @Description   Prepare the decoder for a new measurement.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pDecoder - decoder
+//**************************************************************************************************
+void AM2305_DecoderReset(AM2305_DECODER *const pDecoder)
+{
+    pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_RESPONSE_LOW;
+    pDecoder->nBit = 0;
+
+    for (int i=0; i < AM2305_QTY_DATA_BYTES; i++)
     {
-        // Clear buf
-        for (int i=0; i < AM2305_QTY_DATA_BITS/8; i++)
-        {
-            data[i] = 0;
-        }
-        for(int i = 0; i<AM2305_QTY_MEAS;i++)
-        {
-            switch(AM2305_SignalStatus)
+        pDecoder->aData[i] = 0;
+    }
+}// end of AM2305_DecoderReset()
+
+
+
+//**************************************************************************************************
+// @Function      AM2305_DecoderPush()
+//--------------------------------------------------------------------------------------------------
+// @Description   Decode the next duration between the edges.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Durations before the response of the sensor are skipped. A duration out of
+//                the tolerance of the expected pulse stops the decoder with an error.
+//                A host release of 70..90 us is taken for the response low, then the response
+//                high comes before the first bit and the decoder stays on the first bit.
+//                The decoder ignores durations after it is done or failed.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   AM2305_DECODE_BUSY - more durations are needed
+//                AM2305_DECODE_DONE - all bits were received
+//                AM2305_DECODE_ERROR - pulse out of the tolerance
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pDecoder - decoder
+//                nDuration - duration between the edges, us
+//**************************************************************************************************
+AM2305_DECODE_STATUS AM2305_DecoderPush(AM2305_DECODER *const pDecoder, const uint16_t nDuration)
+{
+    AM2305_DECODE_STATUS enStatus = AM2305_DECODE_BUSY;
+
+    switch ((AM2305_SIGNAL_STATUS)pDecoder->nState)
+    {
+        case AM2305_SIGNAL_STATUS_RESPONSE_LOW :
+            // Skip the host release and the sensor reaction time
+            if (AM2305_IN_RANGE(nDuration, AM2305_TIME_T_REL_MIN_US, AM2305_TIME_T_REL_MAX_US))
             {
-                case AM2305_SIGNAL_STATUS_RESPONSE_LOW :
-                    if ((measurements[i] >= AM2305_TIME_T_REL_MIN_US) && \
-                        (measurements[i] <= AM2305_TIME_T_REL_MAX_US))
-                    {
-                        AM2305_SignalStatus = AM2305_SIGNAL_STATUS_RESPONSE_HIGH;
-                    }
-                    break;
-                case AM2305_SIGNAL_STATUS_RESPONSE_HIGH :
-                    if ((measurements[i] >= AM2305_TIME_T_REH_MIN_US) && \
-                        (measurements[i] <= AM2305_TIME_T_REH_MAX_US))
-                    {
-                        AM2305_SignalStatus = AM2305_SIGNAL_STATUS_SIGNAL_0_1_LOW;
-                    }
-                    break;
-                case AM2305_SIGNAL_STATUS_SIGNAL_0_1_LOW :
-                    if ((measurements[i] >= AM2305_TIME_T_LOW_MIN_US) && \
-                        (measurements[i] <= AM2305_TIME_T_LOW_MAX_US))
-                    {
-                        AM2305_SignalStatus = AM2305_SIGNAL_STATUS_SIGNAL_0_HIGH;
-                    }
-                    break;
-                case AM2305_SIGNAL_STATUS_SIGNAL_0_HIGH :
-                case AM2305_SIGNAL_STATUS_SIGNAL_1_HIGH :
-                    if ((measurements[i] >= AM2305_TIME_T_H0_MIN_US) && \
-                        (measurements[i] <= AM2305_TIME_T_H0_MAX_US))
-                    {
-                        bit = 0;
-                    }
-                    else if ((measurements[i] >= AM2305_TIME_T_H1_MIN_US) && \
-                             (measurements[i] <= AM2305_TIME_T_H1_MAX_US))
-                    {
-                        bit = 1;
-                    }
-                    AM2305_SignalStatus = AM2305_SIGNAL_STATUS_SIGNAL_0_1_LOW;
-                    if (cntBit == 8U)
-                    {
-                        cntByte++;
-                        cntBit=0;
-                        data[cntByte] = 0;
-                    }
-                    data[cntByte] |= bit << (7U-cntBit);
-                    if ((AM2305_QTY_DATA_BITS/8 == cntByte) && (7U == cntBit))
-                    {
-                        AM2305_SignalStatus = AM2305_SIGNAL_STATUS_END;
-                    }
-                    else
-                    {
-                        cntBit++;
-                    }
-                    break;
-                case AM2305_SIGNAL_STATUS_END :
-                    i = AM2305_QTY_MEAS;
-                    break;
-                default:
-                    AM2305_SignalStatus = AM2305_SIGNAL_STATUS_SIGNAL_0_1_LOW;
-                    break;
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_RESPONSE_HIGH;
             }
-        }
+            break;
+        case AM2305_SIGNAL_STATUS_RESPONSE_HIGH :
+            if (AM2305_IN_RANGE(nDuration, AM2305_TIME_T_REH_MIN_US, AM2305_TIME_T_REH_MAX_US))
+            {
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_SIGNAL_LOW;
+            }
+            else
+            {
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_ERROR;
+            }
+            break;
+        case AM2305_SIGNAL_STATUS_SIGNAL_LOW :
+            if (AM2305_IN_RANGE(nDuration, AM2305_TIME_T_LOW_MIN_US, AM2305_TIME_T_LOW_MAX_US))
+            {
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_SIGNAL_HIGH;
+            }
+            else if ((0U == pDecoder->nBit) &&
+                     AM2305_IN_RANGE(nDuration, AM2305_TIME_T_REH_MIN_US, AM2305_TIME_T_REH_MAX_US))
+            {
+                // Response high after the host release out of the tolerance
+                DoNothing();
+            }
+            else
+            {
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_ERROR;
+            }
+            break;
+        case AM2305_SIGNAL_STATUS_SIGNAL_HIGH :
+            if (AM2305_IN_RANGE(nDuration, AM2305_TIME_T_H1_MIN_US, AM2305_TIME_T_H1_MAX_US))
+            {
+                // MSB first
+                pDecoder->aData[pDecoder->nBit / 8U] |= (uint8_t)(1U << (7U - (pDecoder->nBit % 8U)));
+                pDecoder->nBit++;
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_SIGNAL_LOW;
+            }
+            else if (AM2305_IN_RANGE(nDuration, AM2305_TIME_T_H0_MIN_US, AM2305_TIME_T_H0_MAX_US))
+            {
+                pDecoder->nBit++;
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_SIGNAL_LOW;
+            }
+            else
+            {
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_ERROR;
+            }
+
+            if (AM2305_QTY_DATA_BITS == pDecoder->nBit)
+            {
+                pDecoder->nState = (uint8_t)AM2305_SIGNAL_STATUS_END;
+            }
+            break;
+        case AM2305_SIGNAL_STATUS_END :
+        case AM2305_SIGNAL_STATUS_ERROR :
+        default:
+            break;
+    }
+
+    if ((uint8_t)AM2305_SIGNAL_STATUS_END == pDecoder->nState)
+    {
+        enStatus = AM2305_DECODE_DONE;
+    }
+    else if ((uint8_t)AM2305_SIGNAL_STATUS_ERROR == pDecoder->nState)
+    {
+        enStatus = AM2305_DECODE_ERROR;
+    }
+    else
+    {
+        enStatus = AM2305_DECODE_BUSY;
+    }
 
+    return enStatus;
+}// end of AM2305_DecoderPush()
+
+
+
+//**************************************************************************************************
+// @Function      AM2305_DecoderGetResult()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get humidity and temperature from the decoder.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - all bits were received and parity byte is correct
+//                RESULT_NOT_OK - otherwise
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pDecoder - decoder
+//                humidity - get the humidity
+//                temperature - get the temperature
+//**************************************************************************************************
+STD_RESULT AM2305_DecoderGetResult(const AM2305_DECODER *const pDecoder,
+                                   float *const humidity,
+                                   float *const temperature)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    const uint8_t *const data = pDecoder->aData;
+    uint8_t sum=0;
+
+    if ((uint8_t)AM2305_SIGNAL_STATUS_END == pDecoder->nState)
+    {
         // calculate party byte
-        uint8_t sum=0;
-        for(uint8_t i = 0; i < (AM2305_QTY_DATA_BITS/8)-1; i++)
+        for(uint8_t i = 0; i < AM2305_QTY_DATA_BYTES-1; i++)
         {
             sum += data[i];
         }
-        if ( data[(AM2305_QTY_DATA_BITS/8)-1] == sum)
+        if ( data[AM2305_QTY_DATA_BYTES-1] == sum)
         {
             uint16_t temp = (((uint16_t)data[0])<<8) | data[1];
             *humidity = (float)(temp)/10;
 
             temp = (((uint16_t)data[2])<<8) | data[3];
-            // if temperature < 0
+            // if temperature < 0, bit 15 is the sign
             if ((temp & (1<<15)) == 1<<15)
             {
-                *temperature = -(float)(temp)/10;
+                *temperature = -(float)(temp & ~(1<<15))/10;
             }
             else
             {
@@ -397,8 +547,43 @@ STD_RESULT AM2305_GetHumidityTemperature(float *const humidity,float *const temp
     }
 
     return result;
+}// end of AM2305_DecoderGetResult()
+
 
-}// end of AM2305_GetHumidityTemperature()
+
+#if (AM2305_CAPTURE_DMA == AM2305_CAPTURE_MODE)
+//**************************************************************************************************
+// @Function      AM2305_TIMER_IRQHandler()
+//--------------------------------------------------------------------------------------------------
+// @Description   Timer update interrupt, end of the measurement window.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void AM2305_TIMER_IRQHandler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if ((0U != LL_TIM_IsActiveFlag_UPDATE(AM2305_TIMER)) &&
+        (0U != LL_TIM_IsEnabledIT_UPDATE(AM2305_TIMER)))
+    {
+        LL_TIM_ClearFlag_UPDATE(AM2305_TIMER);
+        // Stop capture
+        LL_TIM_DisableIT_UPDATE(AM2305_TIMER);
+        LL_TIM_DisableDMAReq_CC1(AM2305_TIMER);
+
+        if (NULL != AM2305_hTask)
+        {
+            vTaskNotifyGiveFromISR(AM2305_hTask, &xHigherPriorityTaskWoken);
+        }
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}// end of AM2305_TIMER_IRQHandler()
+#endif
 
 //**************************************************************************************************
 //==================================================================================================
@@ -494,6 +679,7 @@ static GPIO_PinState AM2305_DQGetValue(void)
 
 
 
+#if (AM2305_CAPTURE_POLLING == AM2305_CAPTURE_MODE)
 //**************************************************************************************************
 // @Function      AM2305_Delay()
 //--------------------------------------------------------------------------------------------------
@@ -587,4 +773,118 @@ static STD_RESULT AM2305_CaptureTime(uint32_t *const microseconds)
 
     return result;
 }// end of AM2305_CaptureTime
+#endif
+
+
+
+#if (AM2305_CAPTURE_DMA == AM2305_CAPTURE_MODE)
+//**************************************************************************************************
+// @Function      AM2305_CaptureDMA()
+//--------------------------------------------------------------------------------------------------
+// @Description   Capture the signal by DMA and decode it.
+//--------------------------------------------------------------------------------------------------
+// @Notes         DMA stores the capture of every edge, the task sleeps until the timer update
+//                at the end of the measurement window. Call from the task only.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pDecoder - decoder
+//**************************************************************************************************
+static void AM2305_CaptureDMA(AM2305_DECODER *const pDecoder)
+{
+    uint16_t captureOld = 0;
+    uint32_t qty = 0;
+    AM2305_DECODE_STATUS enStatus = AM2305_DECODE_BUSY;
+
+    // Start signal, the task sleeps
+    AM2305_DQLow();
+    AM2305_Sleep(AM2305_TIME_T_BE_MS);
+
+    AM2305_hTask = xTaskGetCurrentTaskHandle();
+    // Drop a notification of the previous measurement
+    (void)ulTaskNotifyTake(pdTRUE, 0U);
+
+    // The measurement window is one period of the timer
+    AM2305_TIMER->CR1 &= (uint16_t) (~((uint16_t) TIM_CR1_CEN));
+    AM2305_TIMER->ARR = AM2305_TIME_MEAS_US;
+    AM2305_TIMER->CNT = 0;
+    AM2305_TIMER->SR = (uint16_t)~(TIM_FLAG_CC1|TIM_FLAG_UPDATE);
+
+    HAL_DMA_Start(&AM2305_DmaHandle,
+                  (uint32_t)(uintptr_t)&AM2305_TIMER->CCR1,
+                  (uint32_t)(uintptr_t)AM2305_aMeasurements,
+                  AM2305_QTY_MEAS);
+    LL_TIM_EnableDMAReq_CC1(AM2305_TIMER);
+    LL_TIM_EnableIT_UPDATE(AM2305_TIMER);
+    AM2305_TIMER->CR1 |= TIM_CR1_CEN;
+
+    // High DQ, the sensor answers
+    AM2305_DQInput();
+
+    (void)ulTaskNotifyTake(pdTRUE, AM2305_CAPTURE_TIMEOUT_MS / portTICK_RATE_MS);
+
+    // Stop capture if the interrupt was lost
+    LL_TIM_DisableIT_UPDATE(AM2305_TIMER);
+    LL_TIM_DisableDMAReq_CC1(AM2305_TIMER);
+    qty = AM2305_QTY_MEAS - __HAL_DMA_GET_COUNTER(&AM2305_DmaHandle);
+    HAL_DMA_Abort(&AM2305_DmaHandle);
+    AM2305_TIMER->ARR = AM2305_TIMER_PERIOD;
+    AM2305_hTask = NULL;
+    // End communicate.
+
+    // Decode durations between the captures in one pass
+    for (uint32_t i = 0; (i < qty) && (AM2305_DECODE_BUSY == enStatus); i++)
+    {
+        enStatus = AM2305_DecoderPush(pDecoder, (uint16_t)(AM2305_aMeasurements[i] - captureOld));
+        captureOld = AM2305_aMeasurements[i];
+    }
+}// end of AM2305_CaptureDMA()
+
+#else
+//**************************************************************************************************
+// @Function      AM2305_CapturePolling()
+//--------------------------------------------------------------------------------------------------
+// @Description   Capture the signal by polling and decode it.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The caller must protect it by the critical section. Every duration is decoded
+//                as soon as it is captured, the capture stops at the end of the data or
+//                at the first pulse out of the tolerance.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pDecoder - decoder
+//**************************************************************************************************
+static void AM2305_CapturePolling(AM2305_DECODER *const pDecoder)
+{
+    uint32_t time=0;
+    uint32_t timesOld=0;
+    AM2305_DECODE_STATUS enStatus = AM2305_DECODE_BUSY;
+
+    // Start communicate. Getting response from sensor
+    // Start signal
+    AM2305_DQLow();
+
+    // Host the start signal down time
+    AM2305_Delay(AM2305_TIME_T_BE_US);
+
+    // High DQ
+    AM2305_DQInput();
+    AM2305_TIMER->SR = (uint16_t)~(TIM_FLAG_CC1|TIM_FLAG_UPDATE);
+    AM2305_TIMER->CNT = 0;
+
+    while((AM2305_TIMER->CNT < AM2305_TIME_MEAS_US) && (AM2305_DECODE_BUSY == enStatus))
+    {
+        if (RESULT_OK == AM2305_CaptureTime(&time))
+        {
+            enStatus = AM2305_DecoderPush(pDecoder, (uint16_t)(time - timesOld));
+            timesOld = time;
+        }
+        else
+        {
+            break;
+        }
+    }
+    // End communicate.
+}// end of AM2305_CapturePolling()
+#endif
 //****************************************** end of file *******************************************
@@ -38,7 +38,24 @@
 // Declarations of global (public) data types
 //**************************************************************************************************
 
-// None.
+// quantity data bytes: humidity, temperature, parity
+#define AM2305_QTY_DATA_BYTES               (5U)
+
+// Status of the decoder
+typedef enum AM2305_DECODE_STATUS_enum
+{
+    AM2305_DECODE_BUSY=0,
+    AM2305_DECODE_DONE,
+    AM2305_DECODE_ERROR
+}AM2305_DECODE_STATUS;
+
+// Incremental decoder of the signal
+typedef struct AM2305_DECODER_str
+{
+    uint8_t nState;
+    uint8_t nBit;
+    uint8_t aData[AM2305_QTY_DATA_BYTES];
+}AM2305_DECODER;
 
 
 
@@ -65,6 +82,20 @@
 extern void AM2305_Init(void);
 // Get humidity and temperature
 extern STD_RESULT AM2305_GetHumidityTemperature(float *const humidity,float *const temperature);
+// Decode humidity and temperature from the durations between the edges
+extern STD_RESULT AM2305_Decode(const uint16_t *const pDurations,
+                                const uint32_t qty,
+                                float *const humidity,
+                                float *const temperature);
+// Prepare the decoder for a new measurement
+extern void AM2305_DecoderReset(AM2305_DECODER *const pDecoder);
+// Decode the next duration between the edges
+extern AM2305_DECODE_STATUS AM2305_DecoderPush(AM2305_DECODER *const pDecoder,
+                                               const uint16_t nDuration);
+// Get humidity and temperature from the decoder
+extern STD_RESULT AM2305_DecoderGetResult(const AM2305_DECODER *const pDecoder,
+                                          float *const humidity,
+                                          float *const temperature);
 
 #endif // #ifndef AM2305_H
 
@@ -16,6 +16,10 @@
 #ifndef AM2305_CFG_H
 #define AM2305_CFG_H
 
+// Get RTOS interface
+#include "FreeRTOS.h"
+#include "task.h"
+
 
 
 //**************************************************************************************************
@@ -49,6 +53,44 @@
 #define AM2305_TIMER_PERIOD                       (0xFFFFU)
 
 
+// Capture mode of the sensor signal
+// AM2305_CAPTURE_POLLING - the CPU polls the capture flag, the caller must protect
+//                          the measurement by the critical section
+// AM2305_CAPTURE_DMA     - DMA stores the edges in the background, the timer update
+//                          ends the measurement and notifies the sleeping task
+#define AM2305_CAPTURE_POLLING                    (0U)
+#define AM2305_CAPTURE_DMA                        (1U)
+#define AM2305_CAPTURE_MODE                       (AM2305_CAPTURE_DMA)
+
+// DMA of the capture channel, see the DMA request mapping of the reference manual
+#define AM2305_DMA_CHANNEL                        DMA1_Channel5
+#define AM2305_DMA_REQUEST                        DMA_REQUEST_7
+
+// Interrupt of the timer update
+#define AM2305_TIMER_IRQn                         TIM1_BRK_TIM15_IRQn
+#define AM2305_TIMER_IRQHandler                   TIM1_BRK_TIM15_IRQHandler
+
+// Priority of the timer interrupt, the interrupt uses the RTOS API
+// Valid values: [configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY ; 15]
+#define AM2305_IRQ_PRIORITY                       (5U)
+
+// Tolerance of the pulse widths of the sensor, us. A pulse out of the datasheet window
+// widened by the tolerance aborts the measurement.
+#define AM2305_TIME_TOLERANCE_US                  (5U)
+
+// User specify sleep function, ms
+#define AM2305_Sleep(ms)                          vTaskDelay((ms) / portTICK_RATE_MS)
+
+// User specify protection of the measurement
+#if (AM2305_CAPTURE_DMA == AM2305_CAPTURE_MODE)
+#define AM2305_EnterCritical()
+#define AM2305_ExitCritical()
+#else
+#define AM2305_EnterCritical()                    taskENTER_CRITICAL()
+#define AM2305_ExitCritical()                     taskEXIT_CRITICAL()
+#endif
+
+
 #endif // #ifndef AM2305_CFG_H
 
 //****************************************** end of file *******************************************
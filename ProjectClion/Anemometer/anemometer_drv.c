@@ -0,0 +1,389 @@
+//**************************************************************************************************
+// @Module        ANEMOMETER
+// @Filename      anemometer_drv.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      STM32
+//--------------------------------------------------------------------------------------------------
+// @Compatible    STM32L476
+//--------------------------------------------------------------------------------------------------
+// @Description   Implementation of the ANEMOMETER functionality.
+//                The pulses of the cup anemometer are counted by the low power timer.
+//                The timer is clocked by LSE and keeps counting in STOP2. The wake up timer
+//                of RTC interrupts every gust window, in STOP2 too: the interrupt takes the
+//                pulses of the window and keeps the max, the CPU stops again. STANDBY resets
+//                the timer and drops the supply of the anemometer, the master doesn't enter
+//                it in the pulse mode. The time of the mean is taken from RTC.
+//
+//                Abbreviations:
+//                  LPTIM - low power timer.
+//                  WUT - wake up timer of RTC.
+//
+//
+//                Global (public) functions:
+//                  ANEMOMETER_Init();
+//                  ANEMOMETER_WINDOW_IRQHandler();
+//                  ANEMOMETER_GetWind();
+//
+//                Local (private) functions:
+//                  ANEMOMETER_StartWindowTimer();
+//                  ANEMOMETER_TakePulses();
+//                  ANEMOMETER_ReadCounter();
+//
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "anemometer_drv.h"
+
+// Get LL LPTIM, RCC, RTC, EXTI
+#include "stm32l4xx_ll_lptim.h"
+#include "stm32l4xx_ll_rcc.h"
+#include "stm32l4xx_ll_rtc.h"
+#include "stm32l4xx_ll_exti.h"
+
+// Get RTC time
+#include "time_drv.h"
+
+
+
+//**************************************************************************************************
+// Verification of the imported configuration parameters
+//**************************************************************************************************
+
+#if (ANEMOMETER_GUST_WINDOW_MS < 1U)
+#error "ANEMOMETER_GUST_WINDOW_MS must not be 0"
+#endif
+
+#if (ANEMOMETER_GUST_WINDOW_MS > 32000U)
+#error "ANEMOMETER_GUST_WINDOW_MS doesn't fit into the wake up timer"
+#endif
+
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Auto-reload of the counter, the counter wraps at 16 bits
+#define ANEMOMETER_LPTIM_ARR              (0xFFFFU)
+
+// Clock of the wake up timer, RTCCLK / 16, Hz
+#define ANEMOMETER_WUT_CLOCK_HZ           (ANEMOMETER_LSE_HZ / 16U)
+
+// Auto-reload of the wake up timer, the interrupt comes every ARR + 1 clocks
+#define ANEMOMETER_WUT_ARR                (((ANEMOMETER_GUST_WINDOW_MS * ANEMOMETER_WUT_CLOCK_HZ) / 1000U) - 1U)
+
+// Milliseconds in the second
+#define ANEMOMETER_MS_IN_S                (1000.0f)
+
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// Counter of the last take of the pulses
+static uint16_t ANEMOMETER_nLastCount = 0U;
+
+// Start of the interval of ANEMOMETER_GetWind(), ms
+static uint32_t ANEMOMETER_nStartTimeMs = 0U;
+
+// Pulses since the last call of ANEMOMETER_GetWind()
+static uint32_t ANEMOMETER_nPulses = 0U;
+
+// Pulses of the current gust window
+static uint32_t ANEMOMETER_nGustPulses = 0U;
+
+// Max pulses of the gust windows closed since the last call of ANEMOMETER_GetWind()
+static uint32_t ANEMOMETER_nMaxGustPulses = 0U;
+
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+// Start the periodic interrupt of the gust windows
+static void ANEMOMETER_StartWindowTimer(void);
+
+// Take the pulses counted since the last take
+static void ANEMOMETER_TakePulses(void);
+
+// Read the counter of the pulses
+static uint16_t ANEMOMETER_ReadCounter(void);
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+//**************************************************************************************************
+// @Function      ANEMOMETER_Init()
+//--------------------------------------------------------------------------------------------------
+// @Description   Init GPIO, start the pulse counter and the wake up of the gust windows.
+//--------------------------------------------------------------------------------------------------
+// @Notes         LSE must be on, it is started by the TIME module for RTC.
+//                The counter is clocked by the input edges, LSE clocks the input filter.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void ANEMOMETER_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct;
+
+    __HAL_RCC_LPTIM1_CLK_ENABLE();
+    LL_RCC_SetLPTIMClockSource(LL_RCC_LPTIM1_CLKSOURCE_LSE);
+
+    // Config the input, the reed contact pulls it low
+    GPIO_InitStruct.Pin  = ANEMOMETER_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Alternate = ANEMOMETER_GPIO_AF;
+    HAL_GPIO_Init(ANEMOMETER_GPIO_PORT, &GPIO_InitStruct);
+
+    // Count the falling edges of the input
+    LL_LPTIM_SetClockSource(ANEMOMETER_LPTIM, LL_LPTIM_CLK_SOURCE_INTERNAL);
+    LL_LPTIM_SetCounterMode(ANEMOMETER_LPTIM, LL_LPTIM_COUNTER_MODE_EXTERNAL);
+    LL_LPTIM_ConfigClock(ANEMOMETER_LPTIM, ANEMOMETER_LPTIM_FILTER, LL_LPTIM_CLK_POLARITY_FALLING);
+    LL_LPTIM_SetPrescaler(ANEMOMETER_LPTIM, LL_LPTIM_PRESCALER_DIV1);
+
+    // ARR is written only when the timer is enabled
+    LL_LPTIM_Enable(ANEMOMETER_LPTIM);
+    LL_LPTIM_SetAutoReload(ANEMOMETER_LPTIM, ANEMOMETER_LPTIM_ARR);
+    LL_LPTIM_StartCounter(ANEMOMETER_LPTIM, LL_LPTIM_OPERATING_MODE_CONTINUOUS);
+
+    ANEMOMETER_nLastCount = ANEMOMETER_ReadCounter();
+    ANEMOMETER_nStartTimeMs = ANEMOMETER_GetTimeMs();
+    ANEMOMETER_nPulses = 0U;
+    ANEMOMETER_nGustPulses = 0U;
+    ANEMOMETER_nMaxGustPulses = 0U;
+
+    ANEMOMETER_StartWindowTimer();
+}// end of ANEMOMETER_Init()
+
+
+
+//**************************************************************************************************
+// @Function      ANEMOMETER_WINDOW_IRQHandler()
+//--------------------------------------------------------------------------------------------------
+// @Description   Interrupt of the wake up timer, closes the gust window.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Comes every ANEMOMETER_GUST_WINDOW_MS, the windows are counted by the timer
+//                and not by RTOS, so the max is kept over STOP2 too. The max is kept in pulses,
+//                the speed is calculated by ANEMOMETER_GetWind().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void ANEMOMETER_WINDOW_IRQHandler(void)
+{
+    LL_RTC_ClearFlag_WUT(RTC);
+    LL_EXTI_ClearFlag_0_31(ANEMOMETER_WINDOW_EXTI_LINE);
+
+    ANEMOMETER_TakePulses();
+
+    if (ANEMOMETER_nGustPulses > ANEMOMETER_nMaxGustPulses)
+    {
+        ANEMOMETER_nMaxGustPulses = ANEMOMETER_nGustPulses;
+    }
+    else
+    {
+        DoNothing();
+    }
+    ANEMOMETER_nGustPulses = 0U;
+}// end of ANEMOMETER_WINDOW_IRQHandler()
+
+
+
+//**************************************************************************************************
+// @Function      ANEMOMETER_GetWind()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get mean wind speed and gust since the last call.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The mean is counted over the whole interval, the gust is the max of the
+//                gust windows closed in it. The pulses of the open window are in the mean of
+//                the interval, the window itself goes to the gust of the next one. The
+//                interval starts again after the call.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - the wind is calculated
+//                RESULT_NOT_OK - no time has passed since the last call
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pMean - mean wind speed, m/s
+//                pGust - wind gust, m/s
+//**************************************************************************************************
+STD_RESULT ANEMOMETER_GetWind(float *const pMean, float *const pGust)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint32_t nTimeMs = 0U;
+    uint32_t nElapsedMs = 0U;
+    float fGust = 0.0f;
+
+    ANEMOMETER_EnterCritical();
+
+    ANEMOMETER_TakePulses();
+
+    // Unsigned arithmetic handles the wrap of the time
+    nTimeMs = ANEMOMETER_GetTimeMs();
+    nElapsedMs = nTimeMs - ANEMOMETER_nStartTimeMs;
+
+    if (0U != nElapsedMs)
+    {
+        *pMean = (((float)ANEMOMETER_nPulses * ANEMOMETER_MS_IN_S) / (float)nElapsedMs) * \
+                   ANEMOMETER_SPEED_PER_HZ;
+        fGust = (((float)ANEMOMETER_nMaxGustPulses * ANEMOMETER_MS_IN_S) / (float)ANEMOMETER_GUST_WINDOW_MS) * \
+                  ANEMOMETER_SPEED_PER_HZ;
+        // The interval is shorter than the gust window
+        *pGust = (fGust > *pMean) ? fGust : *pMean;
+
+        ANEMOMETER_nStartTimeMs = nTimeMs;
+        ANEMOMETER_nPulses = 0U;
+        ANEMOMETER_nMaxGustPulses = 0U;
+        result = RESULT_OK;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    ANEMOMETER_ExitCritical();
+
+    return result;
+}// end of ANEMOMETER_GetWind()
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+//**************************************************************************************************
+// @Function      ANEMOMETER_StartWindowTimer()
+//--------------------------------------------------------------------------------------------------
+// @Description   Start the periodic interrupt of the gust windows.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The wake up timer is clocked by RTCCLK / 16. EXTI line of the timer wakes up
+//                the CPU from STOP2 by the interrupt.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void ANEMOMETER_StartWindowTimer(void)
+{
+    LL_RTC_DisableWriteProtection(RTC);
+
+    // The reload is written only when the timer is stopped
+    LL_RTC_WAKEUP_Disable(RTC);
+    while (0U == LL_RTC_IsActiveFlag_WUTW(RTC))
+    {
+        DoNothing();
+    }
+    LL_RTC_WAKEUP_SetAutoReload(RTC, ANEMOMETER_WUT_ARR);
+    LL_RTC_WAKEUP_SetClock(RTC, LL_RTC_WAKEUPCLOCK_DIV_16);
+    LL_RTC_ClearFlag_WUT(RTC);
+    LL_RTC_EnableIT_WUT(RTC);
+    LL_RTC_WAKEUP_Enable(RTC);
+
+    LL_RTC_EnableWriteProtection(RTC);
+
+    LL_EXTI_ClearFlag_0_31(ANEMOMETER_WINDOW_EXTI_LINE);
+    LL_EXTI_EnableIT_0_31(ANEMOMETER_WINDOW_EXTI_LINE);
+    LL_EXTI_EnableRisingTrig_0_31(ANEMOMETER_WINDOW_EXTI_LINE);
+
+    HAL_NVIC_SetPriority(ANEMOMETER_WINDOW_IRQn, ANEMOMETER_WINDOW_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(ANEMOMETER_WINDOW_IRQn);
+}// end of ANEMOMETER_StartWindowTimer()
+
+
+
+//**************************************************************************************************
+// @Function      ANEMOMETER_TakePulses()
+//--------------------------------------------------------------------------------------------------
+// @Description   Take the pulses counted since the last take.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called by the interrupt of the window and by the task in the critical section.
+//                The window is much shorter than the wrap of the 16-bit counter.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void ANEMOMETER_TakePulses(void)
+{
+    const uint16_t nCount = ANEMOMETER_ReadCounter();
+    // Unsigned arithmetic handles the wrap of the counter
+    const uint32_t nPulses = (uint16_t)(nCount - ANEMOMETER_nLastCount);
+
+    ANEMOMETER_nLastCount = nCount;
+    ANEMOMETER_nPulses += nPulses;
+    ANEMOMETER_nGustPulses += nPulses;
+}// end of ANEMOMETER_TakePulses()
+
+
+
+//**************************************************************************************************
+// @Function      ANEMOMETER_ReadCounter()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read the counter of the pulses.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The counter is asynchronous to APB, it's valid when two reads are equal.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Counter of the pulses.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static uint16_t ANEMOMETER_ReadCounter(void)
+{
+    uint16_t nCount = 0U;
+    uint16_t nCountCheck = 0U;
+
+    do
+    {
+        nCount = (uint16_t)LL_LPTIM_GetCounter(ANEMOMETER_LPTIM);
+        nCountCheck = (uint16_t)LL_LPTIM_GetCounter(ANEMOMETER_LPTIM);
+    }
+    while (nCount != nCountCheck);
+
+    return nCount;
+}// end of ANEMOMETER_ReadCounter()
+
+//****************************************** end of file *******************************************
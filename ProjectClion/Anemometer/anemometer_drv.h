@@ -0,0 +1,81 @@
+//**************************************************************************************************
+// @Module        ANEMOMETER
+// @Filename      anemometer_drv.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the ANEMOMETER module.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef ANEMOMETER_H
+#define ANEMOMETER_H
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "stm32l4xx_hal.h"
+
+#include "compiler.h"
+
+
+#include "general_types.h"
+
+// Get configuration of the program module
+#include "anemometer_drv_cfg.h"
+
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Declarations of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// Init GPIO, start the pulse counter and the wake up of the gust windows
+extern void ANEMOMETER_Init(void);
+// Interrupt of the wake up timer, closes the gust window
+extern void ANEMOMETER_WINDOW_IRQHandler(void);
+// Get mean wind speed and gust since the last call
+extern STD_RESULT ANEMOMETER_GetWind(float *const pMean, float *const pGust);
+// Get mean wind speed and gust of the window of the samples of the analog anemometer
+extern STD_RESULT ANEMOMETER_GetWindOfSamples(const uint32_t *const pSamples,
+                                              const uint32_t nStride,
+                                              const uint32_t nQtySamples,
+                                              const uint32_t nQtyGust,
+                                              const float fSpeedPerCount,
+                                              float *const pMean,
+                                              float *const pGust);
+
+#endif // #ifndef ANEMOMETER_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,71 @@
+//**************************************************************************************************
+// @Module        ANEMOMETER
+// @Filename      anemometer_drv_cfg.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Configuration of the required functionality of the ANEMOMETER module.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef ANEMOMETER_CFG_H
+#define ANEMOMETER_CFG_H
+
+// Get RTOS interface
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// The user specify port and pin of the pulse output of the anemometer, LPTIM1_IN1
+#define ANEMOMETER_GPIO_PORT                      GPIOB
+#define ANEMOMETER_PIN                            (GPIO_PIN_5)
+// Specify GPIO_AF
+#define ANEMOMETER_GPIO_AF                        GPIO_AF1_LPTIM1
+
+// Low power timer counting the pulses. LPTIM1 keeps counting in STOP2, but is reset by STANDBY,
+// so the master enters STOP2 instead of STANDBY when the pulse anemometer is selected.
+#define ANEMOMETER_LPTIM                          LPTIM1
+
+// Digital filter of the input, suppresses the bounce of the reed contact
+#define ANEMOMETER_LPTIM_FILTER                   LL_LPTIM_CLK_FILTER_8
+
+// Wind speed for one pulse per second, (m/s)/Hz
+#define ANEMOMETER_SPEED_PER_HZ                   (float)(0.667)
+
+// Window of the gust, ms. The analog anemometer takes the running mean of its samples over it.
+// Valid values: [1 ; 32000], the wake up timer of RTC counts it by RTCCLK / 16
+#define ANEMOMETER_GUST_WINDOW_MS                 (3000U)
+
+// Periodic interrupt closing the gust windows of the pulse anemometer, the wake up timer of RTC.
+// LPTIM1 is clocked by the pulses and LPTIM2 doesn't run in STOP2, RTC runs from LSE in STOP2.
+#define ANEMOMETER_WINDOW_IRQHandler              RTC_WKUP_IRQHandler
+#define ANEMOMETER_WINDOW_IRQn                    RTC_WKUP_IRQn
+#define ANEMOMETER_WINDOW_EXTI_LINE               LL_EXTI_LINE_20
+// Valid values: [configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY ; 15], the critical section of the
+// task masks it
+#define ANEMOMETER_WINDOW_IRQ_PRIORITY            (5U)
+
+// Frequency of LSE clocking RTC, Hz
+#define ANEMOMETER_LSE_HZ                         (32768U)
+
+// User specify time of the system, ms. It must keep counting in STOP2, the ticks of RTOS don't.
+#define ANEMOMETER_GetTimeMs()                    TIME_GetTimeMs()
+
+// User specify protection of the counters shared by the tasks
+#define ANEMOMETER_EnterCritical()                taskENTER_CRITICAL()
+#define ANEMOMETER_ExitCritical()                 taskEXIT_CRITICAL()
+
+
+#endif // #ifndef ANEMOMETER_CFG_H
+
+//****************************************** end of file *******************************************
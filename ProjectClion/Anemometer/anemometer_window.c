@@ -0,0 +1,131 @@
+//**************************************************************************************************
+// @Module        ANEMOMETER
+// @Filename      anemometer_window.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      STM32
+//--------------------------------------------------------------------------------------------------
+// @Compatible    STM32L476
+//--------------------------------------------------------------------------------------------------
+// @Description   Mean wind speed and gust of the window of the samples of the analog anemometer.
+//                The samples are taken by the ADC, the module only computes, so it is built for
+//                the host tests as is.
+//
+//
+//                Global (public) functions:
+//                  ANEMOMETER_GetWindOfSamples();
+//
+//                Local (private) functions:
+//                  None.
+//
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "anemometer_drv.h"
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+//**************************************************************************************************
+// @Function      ANEMOMETER_GetWindOfSamples()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get mean wind speed and gust of the window of the samples.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The samples are interleaved with the other channels of the ADC sequence.
+//                The gust is the max of the running mean over nQtyGust samples, as the gust
+//                window of the pulse anemometer. The sums are kept in the ADC counts, so the
+//                mean doesn't depend on the order and the length of the window.
+//                A window shorter than the gust gives the mean as the gust.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - the wind is calculated
+//                RESULT_NOT_OK - no samples
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pSamples - the first sample of the anemometer channel
+//                nStride - distance of the samples, quantity of the channels of the sequence
+//                nQtySamples - quantity of the samples in the window
+//                nQtyGust - quantity of the samples in the gust
+//                fSpeedPerCount - wind speed of one ADC count, m/s
+//                pMean - mean wind speed, m/s
+//                pGust - wind gust, m/s
+//**************************************************************************************************
+STD_RESULT ANEMOMETER_GetWindOfSamples(const uint32_t *const pSamples,
+                                       const uint32_t nStride,
+                                       const uint32_t nQtySamples,
+                                       const uint32_t nQtyGust,
+                                       const float fSpeedPerCount,
+                                       float *const pMean,
+                                       float *const pGust)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint32_t nSum = 0U;
+    uint32_t nGustSum = 0U;
+    uint32_t nMaxGustSum = 0U;
+    uint32_t nSample = 0U;
+
+    if ((0U != nStride) && (0U != nQtySamples) && (0U != nQtyGust))
+    {
+        for (nSample = 0U; nSample < nQtySamples; nSample++)
+        {
+            nSum += pSamples[nSample * nStride];
+            nGustSum += pSamples[nSample * nStride];
+
+            if (nSample >= nQtyGust)
+            {
+                // The sample leaves the gust
+                nGustSum -= pSamples[(nSample - nQtyGust) * nStride];
+            }
+            else
+            {
+                DoNothing();
+            }
+
+            // The first sums have less samples, they don't exceed the full ones
+            if (nGustSum > nMaxGustSum)
+            {
+                nMaxGustSum = nGustSum;
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+
+        *pMean = ((float)nSum * fSpeedPerCount) / (float)nQtySamples;
+        if (nQtySamples >= nQtyGust)
+        {
+            *pGust = ((float)nMaxGustSum * fSpeedPerCount) / (float)nQtyGust;
+        }
+        else
+        {
+            *pGust = *pMean;
+        }
+        result = RESULT_OK;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return result;
+}// end of ANEMOMETER_GetWindOfSamples()
+
+//****************************************** end of file *******************************************
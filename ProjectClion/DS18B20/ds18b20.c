@@ -96,7 +96,6 @@
 // Read power supply
 #define DS18B20_READ_POWER_SUPPLY           (0xB4U)
 
-#define DS18B20_CONVERSION_TIME_US          (1000000U)
 // Size scratchpad
 #define DS18B20_SCRATCHPAD_SIZE             (9U)
 // Size scratchpad allow writing
@@ -111,6 +110,14 @@
 #define DS18B20_NUM_BITS_TEMPERATURE        (11U)
 // number bytes ID
 #define DS18B20_SIZE_ID_BYTES               (8U)
+// Position of the resolution bits in config
+#define DS18B20_RESOLUTION_POS              (5U)
+// Mask of the resolution bits in config
+#define DS18B20_RESOLUTION_MASK             (3U)
+// Family code of DS18B20, the low byte of ID
+#define DS18B20_FAMILY_CODE                 (0x28U)
+// number bits ID
+#define DS18B20_SIZE_ID_BITS                (64U)
 
 
 
@@ -118,7 +125,8 @@
 // Definitions of static global (private) variables
 //**************************************************************************************************
 
-// None.
+// Max conversion time for 9, 10, 11, 12 bits, ms
+static const uint16_t DS18B20_aConversionTimeMs[] = {94U, 188U, 375U, 750U};
 
 
 
@@ -131,12 +139,12 @@ static STD_RESULT DS18B20_MatchID(const uint8_t nCh, uint64_t ID);
 // Skip ROM function
 static void DS18B20_SkipID(const uint8_t nCh);
 
+// One pass of the Search ROM algorithm
+static STD_RESULT DS18B20_SearchPass(const uint8_t nCh, uint64_t *const ID, uint8_t *const pLastDiscrepancy);
+
 // Read scratchpad
 static void DS18B20_ReadScratchPad(const uint8_t nCh, uint8_t* data);
 
-// Start convert T
-static STD_RESULT DS18B20_ConvertT(const uint8_t nCh);
-
 // Get temperature value from scratchpad
 static float DS18B20_GetTemFromScratchpad(const uint8_t* scratchpad);
 
@@ -214,12 +222,88 @@ STD_RESULT DS18B20_GetID(const uint8_t nCh, uint64_t *const ID)
 
 
 
+//**************************************************************************************************
+// @Function      DS18B20_SearchROM()
+//--------------------------------------------------------------------------------------------------
+// @Description   Enumerate ID of all DS18B20 sensors on the bus by Search ROM
+//--------------------------------------------------------------------------------------------------
+// @Notes         Devices of the other families are skipped. Every pass is done in the critical
+//                section, the RTOS runs between the passes. If a device leaves the bus during
+//                the search, the pass which should find it finds one of the found devices again,
+//                such ID is skipped.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - at least one sensor was found, all found ID have correct crc
+//                RESULT_NOT_OK - no sensors or the bus error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - channel One Wire
+//                pID - array to store ID
+//                nMaxQty - size of the array
+//                pQty - quantity of the found sensors
+//**************************************************************************************************
+STD_RESULT DS18B20_SearchROM(const uint8_t nCh, uint64_t *const pID, const uint8_t nMaxQty, uint8_t *const pQty)
+{
+    STD_RESULT result = RESULT_OK;
+    uint8_t nLastDiscrepancy = 0U;
+    uint64_t ID = 0U;
+    BOOLEAN bNew = FALSE;
+    uint8_t i = 0U;
+
+    *pQty = 0U;
+
+    do
+    {
+        DS18B20_EnterCritical();
+        result = DS18B20_SearchPass(nCh, &ID, &nLastDiscrepancy);
+        DS18B20_ExitCritical();
+
+        bNew = TRUE;
+        for (i = 0U; i < *pQty; i++)
+        {
+            if (pID[i] == ID)
+            {
+                bNew = FALSE;
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+
+        if ((RESULT_OK == result) &&
+            (TRUE == bNew) &&
+            (DS18B20_FAMILY_CODE == (uint8_t)ID))
+        {
+            pID[*pQty] = ID;
+            (*pQty)++;
+        }
+        else
+        {
+            DoNothing();
+        }
+    } while ((RESULT_OK == result) && (0U != nLastDiscrepancy) && (*pQty < nMaxQty));
+
+    if (0U == *pQty)
+    {
+        result = RESULT_NOT_OK;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return result;
+}
+// end of DS18B20_SearchROM()
+
+
+
 //**************************************************************************************************
 // @Function      DS18B20_GetTemperature()
 //--------------------------------------------------------------------------------------------------
-// @Description   Read scratchpad
+// @Description   Convert and read temperature
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         Sleeps until the conversion is done, see DS18B20_StartConversion() and
+//                DS18B20_ReadResult() to do something else while the sensor converts.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
@@ -227,6 +311,238 @@ STD_RESULT DS18B20_GetID(const uint8_t nCh, uint64_t *const ID)
 //                ID - ID of sensor
 //**************************************************************************************************
 STD_RESULT DS18B20_GetTemperature(uint8_t nCh, const uint64_t *const ID, float *const t )
+{
+    STD_RESULT result = RESULT_NOT_OK;
+
+    DS18B20_EnterCritical();
+    result = DS18B20_StartConversion(nCh, ID);
+    DS18B20_ExitCritical();
+
+    // The longest time covers any resolution
+    if ((RESULT_OK == result) &&
+        (RESULT_OK == DS18B20_WaitConversion(nCh, DS18B20_RESOLUTION_12_BIT)))
+    {
+        DS18B20_EnterCritical();
+        result = DS18B20_ReadResult(nCh, ID, t);
+        DS18B20_ExitCritical();
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    return result;
+}
+// end of DS18B20_GetTemperature
+
+
+
+//**************************************************************************************************
+// @Function      DS18B20_StartConversion()
+//--------------------------------------------------------------------------------------------------
+// @Description   Start conversion of the temperature
+//--------------------------------------------------------------------------------------------------
+// @Notes         The result is ready after DS18B20_GetConversionTime(), the bus is free
+//                while the sensor converts.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - conversion is started
+//                RESULT_NOT_OK - sensor doesn't presence
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - channel One Wire
+//                ID - ID of sensor
+//**************************************************************************************************
+STD_RESULT DS18B20_StartConversion(const uint8_t nCh, const uint64_t *const ID)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+
+    // Detect sensor/sensors
+    enONE_WIRE_PRESENCE status;
+    if (RESULT_OK == ONE_WIRE_reset(nCh,&status))
+    {
+        if (ONE_WIRE_PRESENCE == status)
+        {
+            // Match ROM ID
+            if (RESULT_OK == DS18B20_MatchID(nCh,*ID))
+            {
+                // Send command Convert T
+                result = ONE_WIRE_writeByte(nCh,DS18B20_CONVERT_T);
+            }
+            else
+            {
+                result = RESULT_NOT_OK;
+            }
+        }
+        else
+        {
+            result = RESULT_NOT_OK;
+        }
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    return result;
+}
+// end of DS18B20_StartConversion()
+
+
+
+//**************************************************************************************************
+// @Function      DS18B20_StartConversionAll()
+//--------------------------------------------------------------------------------------------------
+// @Description   Start conversion of the temperature by all sensors on the bus
+//--------------------------------------------------------------------------------------------------
+// @Notes         SKIP ROM + CONVERT T, all sensors convert at the same time. Read every
+//                sensor by DS18B20_ReadResult() after DS18B20_GetConversionTime().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - conversion is started
+//                RESULT_NOT_OK - sensors don't presence
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - channel One Wire
+//**************************************************************************************************
+STD_RESULT DS18B20_StartConversionAll(const uint8_t nCh)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+
+    // Detect sensors
+    enONE_WIRE_PRESENCE status;
+    if (RESULT_OK == ONE_WIRE_reset(nCh,&status))
+    {
+        if (ONE_WIRE_PRESENCE == status)
+        {
+            // Address all sensors
+            DS18B20_SkipID(nCh);
+            // Send command Convert T
+            result = ONE_WIRE_writeByte(nCh,DS18B20_CONVERT_T);
+        }
+        else
+        {
+            result = RESULT_NOT_OK;
+        }
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    return result;
+}
+// end of DS18B20_StartConversionAll()
+
+
+
+//**************************************************************************************************
+// @Function      DS18B20_IsConversionDone()
+//--------------------------------------------------------------------------------------------------
+// @Description   Check the end of the conversion by a read time slot
+//--------------------------------------------------------------------------------------------------
+// @Notes         The sensor holds the bus low while it converts. Works with the external
+//                power only, a sensor on the parasite power always reads as done.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - bus was read
+//                RESULT_NOT_OK - 1-Wire error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - channel One Wire
+//                bDone - TRUE if the conversion is done
+//**************************************************************************************************
+STD_RESULT DS18B20_IsConversionDone(const uint8_t nCh, BOOLEAN *const bDone)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint8_t bitVal = 0;
+
+    DS18B20_EnterCritical();
+    result = ONE_WIRE_readBit(nCh,&bitVal);
+    DS18B20_ExitCritical();
+
+    *bDone = (LOGIC_1 == bitVal) ? TRUE : FALSE;
+
+    return result;
+}
+// end of DS18B20_IsConversionDone()
+
+
+
+//**************************************************************************************************
+// @Function      DS18B20_WaitConversion()
+//--------------------------------------------------------------------------------------------------
+// @Description   Wait for the end of the conversion
+//--------------------------------------------------------------------------------------------------
+// @Notes         Polls the bus every DS18B20_POLL_PERIOD_MS and sleeps between polls, so the
+//                other tasks run while the sensor converts. Must not be called from a
+//                critical section.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - conversion is done
+//                RESULT_NOT_OK - timeout or 1-Wire error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - channel One Wire
+//                resolution - DS18B20_RESOLUTION_9_BIT..DS18B20_RESOLUTION_12_BIT
+//**************************************************************************************************
+STD_RESULT DS18B20_WaitConversion(const uint8_t nCh, const uint8_t resolution)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    BOOLEAN bDone = FALSE;
+    const uint32_t nTimeoutMs = DS18B20_GetConversionTime(resolution) + DS18B20_CONVERSION_MARGIN_MS;
+    uint32_t nElapsedMs = 0U;
+
+    while (RESULT_OK == DS18B20_IsConversionDone(nCh, &bDone))
+    {
+        if (TRUE == bDone)
+        {
+            result = RESULT_OK;
+            break;
+        }
+        else if (nElapsedMs >= nTimeoutMs)
+        {
+            break;
+        }
+        else
+        {
+            DS18B20_Sleep(DS18B20_POLL_PERIOD_MS);
+            nElapsedMs += DS18B20_POLL_PERIOD_MS;
+        }
+    }
+
+    return result;
+}
+// end of DS18B20_WaitConversion()
+
+
+
+//**************************************************************************************************
+// @Function      DS18B20_GetConversionTime()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get max conversion time of the resolution
+//--------------------------------------------------------------------------------------------------
+// @Notes         94/188/375/750 ms for 9/10/11/12 bits.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Conversion time, ms
+//--------------------------------------------------------------------------------------------------
+// @Parameters    resolution - DS18B20_RESOLUTION_9_BIT..DS18B20_RESOLUTION_12_BIT
+//**************************************************************************************************
+uint32_t DS18B20_GetConversionTime(const uint8_t resolution)
+{
+    return DS18B20_aConversionTimeMs[(resolution >> DS18B20_RESOLUTION_POS) & DS18B20_RESOLUTION_MASK];
+}
+// end of DS18B20_GetConversionTime()
+
+
+
+//**************************************************************************************************
+// @Function      DS18B20_ReadResult()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read temperature from scratchpad
+//--------------------------------------------------------------------------------------------------
+// @Notes         The conversion must be finished, see DS18B20_StartConversion().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - crc correct and sensor presence
+//                RESULT_NOT_OK - crc doesn't correct or sensor doesn't presence
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - channel One Wire
+//                ID - ID of sensor
+//                *t - Pointer data to store temperature
+//**************************************************************************************************
+STD_RESULT DS18B20_ReadResult(const uint8_t nCh, const uint64_t *const ID, float *const t)
 {
     STD_RESULT result = RESULT_NOT_OK;
     uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE];
@@ -240,34 +556,15 @@ STD_RESULT DS18B20_GetTemperature(uint8_t nCh, const uint64_t *const ID, float *
         {
             // Match ROM ID
             DS18B20_MatchID(nCh,*ID);
-            // Convert T
-            if (RESULT_OK == DS18B20_ConvertT(nCh))
+            // read scratchpad
+            DS18B20_ReadScratchPad(nCh,scratchpad);
+            // calculate crc
+            crc = DS18B20_CalculateCRC(scratchpad, DS18B20_SCRATCHPAD_SIZE-1);
+            if (crc == scratchpad[8])
             {
-                // Detect sensor/sensors
-                ONE_WIRE_reset(nCh,&status);
-                if (ONE_WIRE_PRESENCE == status)
-                {
-                    // Match ROM ID
-                    DS18B20_MatchID(nCh,*ID);
-                    // read scratchpad
-                    DS18B20_ReadScratchPad(nCh,scratchpad);
-                    // calculate crc
-                    crc = DS18B20_CalculateCRC(scratchpad, DS18B20_SCRATCHPAD_SIZE-1);
-                    if (crc == scratchpad[8])
-                    {
-                        // Get temperature
-                        *t = DS18B20_GetTemFromScratchpad(scratchpad);
-                        result = RESULT_OK;
-                    }
-                    else
-                    {
-                        result = RESULT_NOT_OK;
-                    }
-                }
-                else
-                {
-                    result = RESULT_NOT_OK;
-                }
+                // Get temperature
+                *t = DS18B20_GetTemFromScratchpad(scratchpad);
+                result = RESULT_OK;
             }
             else
             {
@@ -286,7 +583,7 @@ STD_RESULT DS18B20_GetTemperature(uint8_t nCh, const uint64_t *const ID, float *
 
     return result;
 }
-// end of DS18B20_GetTemperature
+// end of DS18B20_ReadResult()
 
 
 
@@ -301,7 +598,7 @@ STD_RESULT DS18B20_GetTemperature(uint8_t nCh, const uint64_t *const ID, float *
 //--------------------------------------------------------------------------------------------------
 // @Parameters    resolution - pointer data resolution
 //**************************************************************************************************
-STD_RESULT DS18B20_SetResolution(uint8_t nCh, const uint8_t* ID,const uint8_t* resolution)
+STD_RESULT DS18B20_SetResolution(uint8_t nCh, const uint64_t *const ID,const uint8_t* resolution)
 {
     STD_RESULT result = RESULT_NOT_OK;
     uint8_t scratchPad[DS18B20_SCRATCHPAD_SIZE];
@@ -362,30 +659,16 @@ STD_RESULT DS18B20_SetResolution(uint8_t nCh, const uint8_t* ID,const uint8_t* r
 //**************************************************************************************************
 static STD_RESULT DS18B20_MatchID(const uint8_t nCh, uint64_t ID)
 {
-    STD_RESULT result = RESULT_OK;
-    uint8_t temp=0;
+    uint8_t aCmd[1U + DS18B20_SIZE_ID_BYTES];
 
-    // Send command MATCH ROM
-
-    if (RESULT_OK == ONE_WIRE_writeByte(nCh,DS18B20_MATCH_ROM_CMD))
-    {
-        for(int i=0;i<64;i++)
-        {
-            temp = ID >> i;
-            temp &= 0x01;
-            if (RESULT_NOT_OK == ONE_WIRE_writeBit(nCh,temp))
-            {
-                result = RESULT_NOT_OK;
-                break;
-            }
-        }
-    }
-    else
+    // Command MATCH ROM and ID, LSB first, by one block
+    aCmd[0] = DS18B20_MATCH_ROM_CMD;
+    for (int i=0;i<DS18B20_SIZE_ID_BYTES;i++)
     {
-        result = RESULT_NOT_OK;
+        aCmd[1 + i] = (uint8_t)(ID >> (i*8));
     }
 
-    return result;
+    return ONE_WIRE_writeBytes(nCh, aCmd, sizeof(aCmd));
 }
 //end of DS18B20_MatchID()
 
@@ -411,6 +694,127 @@ static void DS18B20_SkipID(const uint8_t nCh)
 
 
 
+//**************************************************************************************************
+// @Function      DS18B20_SearchPass()
+//--------------------------------------------------------------------------------------------------
+// @Description   One pass of the Search ROM algorithm
+//--------------------------------------------------------------------------------------------------
+// @Notes         Every pass finds the next ID. The pass goes in the 1 direction at the
+//                discrepancy found by the previous pass and in the 0 direction at the new ones.
+//                Start with ID and pLastDiscrepancy = 0, the last device returns
+//                pLastDiscrepancy = 0.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - ID was found and crc is correct
+//                RESULT_NOT_OK - no devices or the bus error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - channel One Wire
+//                ID - ID of the previous pass / found ID
+//                pLastDiscrepancy - bit number of the last discrepancy 1..64, 0 - none
+//**************************************************************************************************
+static STD_RESULT DS18B20_SearchPass(const uint8_t nCh, uint64_t *const ID, uint8_t *const pLastDiscrepancy)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint8_t nLastZero = 0U;
+    uint8_t idBit = 0U;
+    uint8_t cmpBit = 0U;
+    uint8_t dirBit = 0U;
+    uint8_t nBit = 0U;
+    uint8_t crc = 0U;
+
+    // Detect sensors
+    enONE_WIRE_PRESENCE status;
+    if ((RESULT_OK == ONE_WIRE_reset(nCh,&status)) &&
+        (ONE_WIRE_PRESENCE == status) &&
+        (RESULT_OK == ONE_WIRE_writeByte(nCh,DS18B20_SEARCH_ROM_CMD)))
+    {
+        result = RESULT_OK;
+
+        for (nBit = 1U; nBit <= DS18B20_SIZE_ID_BITS; nBit++)
+        {
+            // Read bit and its complement from all devices
+            if ((RESULT_OK != ONE_WIRE_readBit(nCh,&idBit)) ||
+                (RESULT_OK != ONE_WIRE_readBit(nCh,&cmpBit)) ||
+                ((1U == idBit) && (1U == cmpBit)))
+            {
+                // No devices answered
+                result = RESULT_NOT_OK;
+                break;
+            }
+
+            if (idBit != cmpBit)
+            {
+                // All devices have the same bit
+                dirBit = idBit;
+            }
+            else
+            {
+                // Discrepancy
+                if (nBit < *pLastDiscrepancy)
+                {
+                    dirBit = (uint8_t)((*ID >> (nBit - 1U)) & 1U);
+                }
+                else
+                {
+                    dirBit = (nBit == *pLastDiscrepancy) ? 1U : 0U;
+                }
+
+                if (0U == dirBit)
+                {
+                    nLastZero = nBit;
+                }
+                else
+                {
+                    DoNothing();
+                }
+            }
+
+            if (0U == dirBit)
+            {
+                *ID &= ~((uint64_t)1U << (nBit - 1U));
+            }
+            else
+            {
+                *ID |= ((uint64_t)1U << (nBit - 1U));
+            }
+
+            // Devices with the other bit leave the search
+            if (RESULT_OK != ONE_WIRE_writeBit(nCh,dirBit))
+            {
+                result = RESULT_NOT_OK;
+                break;
+            }
+        }
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    if (RESULT_OK == result)
+    {
+        *pLastDiscrepancy = nLastZero;
+
+        crc = DS18B20_CalculateCRC((uint8_t*)ID, DS18B20_SIZE_ID_BYTES-1);
+        if (crc != (uint8_t)(*ID >> (DS18B20_SIZE_ID_BYTES*8-8)))
+        {
+            result = RESULT_NOT_OK;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else
+    {
+        *pLastDiscrepancy = 0U;
+    }
+
+    return result;
+}
+//end of DS18B20_SearchPass()
+
+
+
 //**************************************************************************************************
 // @Function      DS18B20_ReadScratchPad()
 //--------------------------------------------------------------------------------------------------
@@ -426,13 +830,8 @@ static void DS18B20_ReadScratchPad(uint8_t nCh, uint8_t* data)
 {
     // Send command READ SCRATCHPAD
     ONE_WIRE_writeByte(nCh, DS18B20_READ_SCRATCHPAD);
-    for(int i=0;i<DS18B20_SCRATCHPAD_SIZE;i++)
-    {
-        uint8_t byteVal=0;
-        ONE_WIRE_readByte(nCh,&byteVal);
-        *data = byteVal;
-        data++;
-    }
+    // Read scratchpad by one block
+    ONE_WIRE_readBytes(nCh, data, DS18B20_SCRATCHPAD_SIZE);
 }
 // end of DS18B20_ReadScratchPad()
 
@@ -454,10 +853,10 @@ static void DS18B20_WriteScratchPad(const uint8_t nCh, uint8_t TL,uint8_t TH, ui
 {
     // Send command WRITE SCRATCHPAD
     ONE_WIRE_writeByte(nCh,DS18B20_WRITE_SCRATCHPAD);
+    // write TH, the scratchpad is written from byte 2
+    ONE_WIRE_writeByte(nCh,TH);
     // write TL
     ONE_WIRE_writeByte(nCh,TL);
-    // write TH
-    ONE_WIRE_writeByte(nCh,TH);
     // write config
     ONE_WIRE_writeByte(nCh,resolution);
 }
@@ -465,47 +864,6 @@ static void DS18B20_WriteScratchPad(const uint8_t nCh, uint8_t TL,uint8_t TH, ui
 
 
 
-//**************************************************************************************************
-// @Function      DS18B20_ConvertT()
-//--------------------------------------------------------------------------------------------------
-// @Description   Start conversion temperature.
-//--------------------------------------------------------------------------------------------------
-// @Notes         None.
-//--------------------------------------------------------------------------------------------------
-// @ReturnValue   None.
-//--------------------------------------------------------------------------------------------------
-// @Parameters    None.
-//**************************************************************************************************
-static STD_RESULT DS18B20_ConvertT(const uint8_t nCh)
-{
-    STD_RESULT result = RESULT_NOT_OK;
-    // Send command Convert T
-    if (RESULT_OK == ONE_WIRE_writeByte(nCh,DS18B20_CONVERT_T))
-    {
-        // Delay conversion
-        DS18B20_Delay(DS18B20_CONVERSION_TIME_US);
-        uint8_t bitVal = 0;
-        ONE_WIRE_readBit(nCh,&bitVal);
-        if (LOGIC_1 == bitVal)
-        {
-            result = RESULT_OK;
-        }
-        else
-        {
-            result = RESULT_NOT_OK;
-        }
-    }
-    else
-    {
-        result = RESULT_NOT_OK;
-    }
-
-    return result;
-}
-//end of DS18B20_ConvertT()
-
-
-
 //**************************************************************************************************
 // @Function      DS18B20_GetTemFromScratchpad()
 //--------------------------------------------------------------------------------------------------
@@ -522,9 +880,13 @@ static float DS18B20_GetTemFromScratchpad( const uint8_t* scratchpad)
     uint16_t tempScratchPad = 0;
     float temperature = 0.0f;
 
-    tempScratchPad = *scratchpad;
-    scratchpad++;
-    tempScratchPad |= ((uint16_t)*scratchpad) << 8;
+    tempScratchPad = scratchpad[0];
+    tempScratchPad |= ((uint16_t)scratchpad[1]) << 8;
+
+    // Low bits are undefined below 12 bits resolution
+    tempScratchPad &= (uint16_t)~((1U << (DS18B20_RESOLUTION_MASK -
+                                  ((scratchpad[DS18B20_SCRATCHPAD_TL_CONFIG] >> DS18B20_RESOLUTION_POS) &
+                                   DS18B20_RESOLUTION_MASK))) - 1U);
 
     temperature += ((tempScratchPad & 0x01) == 0x01) ? 1.0f/16.0f : 0.0f;
     temperature += ((tempScratchPad & 0x02) == 0x02) ? 1.0f/8.0f : 0.0f;
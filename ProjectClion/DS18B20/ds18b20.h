@@ -62,10 +62,24 @@
 
 // Read ROM ID
 extern STD_RESULT DS18B20_GetID(const uint8_t nCh, uint64_t *const ID);
+// Enumerate ID of all sensors on the bus
+extern STD_RESULT DS18B20_SearchROM(const uint8_t nCh, uint64_t *const pID, const uint8_t nMaxQty, uint8_t *const pQty);
 // Get temperature
 extern STD_RESULT DS18B20_GetTemperature(uint8_t nCh, const uint64_t *const ID, float *const t );
+// Start conversion of the temperature
+extern STD_RESULT DS18B20_StartConversion(const uint8_t nCh, const uint64_t *const ID);
+// Start conversion of all sensors on the bus
+extern STD_RESULT DS18B20_StartConversionAll(const uint8_t nCh);
+// Check conversion is done
+extern STD_RESULT DS18B20_IsConversionDone(const uint8_t nCh, BOOLEAN *const bDone);
+// Wait for the end of the conversion, yields to the RTOS
+extern STD_RESULT DS18B20_WaitConversion(const uint8_t nCh, const uint8_t resolution);
+// Get max conversion time of the resolution, ms
+extern uint32_t DS18B20_GetConversionTime(const uint8_t resolution);
+// Read temperature after the conversion
+extern STD_RESULT DS18B20_ReadResult(const uint8_t nCh, const uint64_t *const ID, float *const t);
 // Set Resolution
-extern STD_RESULT DS18B20_SetResolution(uint8_t nCh, const uint8_t* ID,const uint8_t* resolution);
+extern STD_RESULT DS18B20_SetResolution(uint8_t nCh, const uint64_t *const ID,const uint8_t* resolution);
 
 #endif // #ifndef DS18B20_H
 
@@ -18,6 +18,13 @@
 
 #include "Init.h"
 
+// Get RTOS interface
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Get 1-Wire backend
+#include "OneWire_cfg.h"
+
 //**************************************************************************************************
 // Definitions of global (public) constants
 //**************************************************************************************************
@@ -35,6 +42,26 @@
 // User specify pointer delay function
 #define DS18B20_Delay                           (INIT_Delay)
 
+// User specify sleep function, ms. It's called while the sensor converts
+// and should yield to the RTOS.
+#define DS18B20_Sleep(ms)                       vTaskDelay((ms) / portTICK_RATE_MS)
+
+// User specify protection of the 1-Wire time slots. The UART backend times
+// the slots by hardware and sleeps while DMA works, so it isn't protected.
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+#define DS18B20_EnterCritical()
+#define DS18B20_ExitCritical()
+#else
+#define DS18B20_EnterCritical()                 taskENTER_CRITICAL()
+#define DS18B20_ExitCritical()                  taskEXIT_CRITICAL()
+#endif
+
+// Period of the conversion done polling, ms
+#define DS18B20_POLL_PERIOD_MS                  (10U)
+
+// Margin of the conversion time over the datasheet maximum, ms
+#define DS18B20_CONVERSION_MARGIN_MS            (50U)
+
 
 
 #endif // #ifndef DS18B20_CFG_H
@@ -21,9 +21,12 @@
 //                  EMEEP_GetJobResult()
 //                  EMEEP_GetMemoryStatus()
 //                  EMEEP_SetMemoryStatus()
+//                  EMEEP_GetBankArea()
 //
 //                Local (private) functions:
 //                  EMEEP_FindLastValidRecord()
+//                  EMEEP_FindBanksOffset()
+//                  EMEEP_IsBankFormatted()
 //                  EMEEP_FindPreviousValidRecord()
 //                  EMEEP_GetNextRecordAddr()
 //                  EMEEP_GetPrevRecordAddr()
@@ -364,7 +367,12 @@ static const uint8_t EMEEP_moduleID[] = "EMEEP";
                                                  EMEEP_BANK_##nBankNumber##_SECTOR_EW_ENDURANCE}
 
 // Memory bank static configuration container
+#if (ON == EMEEP_BANKS_AT_FLASH_END)
+// Addresses are moved to the end of the flash memory where the banks are found at EMEEP_Init()
+static EMEEP_BANK_STATIC_CFG EMEEP_banksStaticCfg[EMEEP_USED_BANKS_QTY] =
+#else
 static const EMEEP_BANK_STATIC_CFG EMEEP_banksStaticCfg[EMEEP_USED_BANKS_QTY] = 
+#endif // #if (ON == EMEEP_BANKS_AT_FLASH_END)
 {
     EMEEP_BANK_CONFIGURE(0)
     #if (EMEEP_USED_BANKS_QTY >= 2)
@@ -386,6 +394,11 @@ static const EMEEP_BANK_STATIC_CFG EMEEP_banksStaticCfg[EMEEP_USED_BANKS_QTY] =
 // Program module initialization state
 static BOOLEAN EMEEP_bInitialized = FALSE;
 
+#if (ON == EMEEP_BANKS_AT_FLASH_END)
+// Offset of the banks from the configured addresses
+static uint32_t EMEEP_nBanksOffset = 0UL;
+#endif // #if (ON == EMEEP_BANKS_AT_FLASH_END)
+
 #if (ON == EMEEP_INTERNAL_DIAGNOSTICS)
 // Diagnostic counters
 static EMEEP_DIAG_COUNTERS EMEEP_diagCounters[EMEEP_USED_BANKS_QTY];
@@ -427,6 +440,15 @@ static EMEEP_BANK_PARAMS EMEEP_banksParams[EMEEP_USED_BANKS_QTY];
 // Finds the last valid record in the memory
 static void EMEEP_FindLastValidRecord(const uint8_t nBankNumber);
 
+#if (ON == EMEEP_BANKS_AT_FLASH_END)
+// Find the end of the flash memory the banks were formatted at
+static uint32_t EMEEP_FindBanksOffset(void);
+
+// Checks whether the bank has a valid record at the offset
+static BOOLEAN EMEEP_IsBankFormatted(const uint8_t  nBankNumber,
+                                     const uint32_t nOffset);
+#endif // #if (ON == EMEEP_BANKS_AT_FLASH_END)
+
 // Finds previous valid record in the memory,
 // starting downwards from the specified record.
 static uint32_t EMEEP_FindPreviousValidRecord(const uint8_t  nBankNumber,
@@ -507,6 +529,21 @@ void EMEEP_Init(void)
         EMEEP_nJobResult = MEM_JOB_RESULT_OK;
         EMEEP_nCurrentJob = EMEEP_JOB_IDLE;
 
+        #if (ON == EMEEP_BANKS_AT_FLASH_END)
+        {
+            // Move banks to the end of the flash memory they were formatted at
+            uint32_t nOffset = EMEEP_FindBanksOffset();
+
+            for (nBankNumber = 0U; nBankNumber < EMEEP_USED_BANKS_QTY; nBankNumber ++)
+            {
+                EMEEP_banksStaticCfg[nBankNumber].nStartAddress += nOffset - EMEEP_nBanksOffset;
+                EMEEP_banksStaticCfg[nBankNumber].nEndAddress += nOffset - EMEEP_nBanksOffset;
+            }
+
+            EMEEP_nBanksOffset = nOffset;
+        }
+        #endif // #if (ON == EMEEP_BANKS_AT_FLASH_END)
+
         for (nBankNumber = 0U; nBankNumber < EMEEP_USED_BANKS_QTY; nBankNumber ++)
         {
             // Find the last valid record
@@ -865,7 +902,7 @@ STD_RESULT EMEEP_Store(const uint32_t nTargetAddress,
                                                             (EMEEP_NUMBER_FIELD_SIZE +
                                                             EMEEP_banksStaticCfg[nBankNumber].nRecordDataSize));
 
-                                nSectorSize = W25Q_CAPACITY_SECTOR_BYTES;
+                                nSectorSize = W25Q_GetGeometry()->nSectorBytes;
 
                                 if ((EMEEP_banksParams[nBankNumber].nNextRecordAddress & (nSectorSize - 1U)) == 0U)
                                 {
@@ -892,7 +929,7 @@ STD_RESULT EMEEP_Store(const uint32_t nTargetAddress,
 
                                         if (RESULT_OK ==
                                                 W25Q_EraseBlock(EMEEP_banksParams[nBankNumber].nNextRecordAddress,
-                                                                W25Q_CAPACITY_SECTOR_BYTES))
+                                                                W25Q_BLOCK_MEMORY_4KB))
                                         {
                                             // Wait for callback erase event
                                             EMEEP_FlashCallback(EMEEP_ERASE_EVENT_ID, MEM_JOB_RESULT_OK);
@@ -1118,6 +1155,54 @@ void EMEEP_SetMemoryStatus(const uint32_t nStatusMask)
 
 
 
+//**************************************************************************************************
+// @Function      EMEEP_GetBankArea()
+//--------------------------------------------------------------------------------------------------
+// @Description   Returns the flash memory area of the specified bank.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Addresses are valid after EMEEP_Init() only.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - function succeeded
+//                RESULT_NOT_OK - function NOT succeeded
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nBankNumber - bank number
+//                pStartAddress - pointer to a buffer receiving start address of the bank
+//                pEndAddress - pointer to a buffer receiving end address of the bank
+//**************************************************************************************************
+STD_RESULT EMEEP_GetBankArea(const uint8_t nBankNumber,
+                             uint32_t* const pStartAddress,
+                             uint32_t* const pEndAddress)
+{
+    STD_RESULT enFuncResult = RESULT_NOT_OK;
+
+    // Checking whether initialization is done or not
+    if (TRUE == EMEEP_bInitialized)
+    {
+        if ((nBankNumber < EMEEP_USED_BANKS_QTY) &&
+            (NULL_PTR != pStartAddress) && (NULL_PTR != pEndAddress))
+        {
+            *pStartAddress = EMEEP_banksStaticCfg[nBankNumber].nStartAddress;
+            *pEndAddress = EMEEP_banksStaticCfg[nBankNumber].nEndAddress;
+
+            enFuncResult = RESULT_OK;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else
+    {
+        // Program module is not initialized
+        SEGGER_RTT_printf(0, "Program module is not initialized");
+    }
+
+    return enFuncResult;
+
+} // end of EMEEP_GetBankArea()
+
+
+
 //**************************************************************************************************
 //==================================================================================================
 // Definitions of local (private) functions
@@ -1230,7 +1315,7 @@ static void EMEEP_FindLastValidRecord(const uint8_t nBankNumber)
                     EMEEP_GetNumberFieldValue(EMEEP_banksParams[nBankNumber].nLastValidRecordAddress);
                 #endif // #if (ON == EMEEP_INTERNAL_DIAGNOSTICS)
 
-                nSectorSize = W25Q_CAPACITY_SECTOR_BYTES;
+                nSectorSize = W25Q_GetGeometry()->nSectorBytes;
 
                 // Find blank memory for the next record OR the next sector boundary
                 do
@@ -1287,6 +1372,101 @@ static void EMEEP_FindLastValidRecord(const uint8_t nBankNumber)
 
 
 
+#if (ON == EMEEP_BANKS_AT_FLASH_END)
+//**************************************************************************************************
+// @Function      EMEEP_FindBanksOffset()
+//--------------------------------------------------------------------------------------------------
+// @Description   Finds the end of the flash memory the banks were formatted at.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The end of the detected flash memory is checked first, then the ends of the
+//                smaller parts: the banks of a flash formatted with a smaller geometry are kept
+//                where they are. The banks of a new flash are placed at the end of the detected
+//                flash memory.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Offset of the banks from the configured addresses.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static uint32_t EMEEP_FindBanksOffset(void)
+{
+    const uint32_t nCapacityBytes = W25Q_GetGeometry()->nCapacityBytes;
+    // Unsigned wrap-around also handles parts smaller than the default one
+    uint32_t nOffset = nCapacityBytes - W25Q_CAPACITY_ALL_MEMORY_BYTES;
+    uint32_t nBanksBytes = 0UL;
+    uint32_t nEndBytes = 0UL;
+    BOOLEAN bFound = FALSE;
+    uint8_t nBankNumber = 0U;
+
+    // Size of the banks area down from the end of the flash memory
+    for (nBankNumber = 0U; nBankNumber < EMEEP_USED_BANKS_QTY; nBankNumber ++)
+    {
+        uint32_t nStartAddress = EMEEP_banksStaticCfg[nBankNumber].nStartAddress - EMEEP_nBanksOffset;
+
+        if ((W25Q_CAPACITY_ALL_MEMORY_BYTES - nStartAddress) > nBanksBytes)
+        {
+            nBanksBytes = W25Q_CAPACITY_ALL_MEMORY_BYTES - nStartAddress;
+        }
+    }
+
+    for (nEndBytes = nCapacityBytes; (nEndBytes >= nBanksBytes) && (FALSE == bFound); nEndBytes >>= 1U)
+    {
+        for (nBankNumber = 0U; (nBankNumber < EMEEP_USED_BANKS_QTY) && (FALSE == bFound); nBankNumber ++)
+        {
+            if (TRUE == EMEEP_IsBankFormatted(nBankNumber, nEndBytes - W25Q_CAPACITY_ALL_MEMORY_BYTES))
+            {
+                nOffset = nEndBytes - W25Q_CAPACITY_ALL_MEMORY_BYTES;
+                bFound = TRUE;
+            }
+        }
+    }
+
+    return nOffset;
+
+} // end of EMEEP_FindBanksOffset()
+
+
+
+//**************************************************************************************************
+// @Function      EMEEP_IsBankFormatted()
+//--------------------------------------------------------------------------------------------------
+// @Description   Checks whether the bank has a valid record at the offset.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The signature and the checksum are checked: the data of the other users of the
+//                flash memory are not taken as a record.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE - valid record is found, FALSE - no valid records.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nBankNumber - bank number
+//                nOffset     - offset of the bank from the configured addresses
+//**************************************************************************************************
+static BOOLEAN EMEEP_IsBankFormatted(const uint8_t  nBankNumber,
+                                     const uint32_t nOffset)
+{
+    BOOLEAN bFormatted = FALSE;
+    uint32_t nRecordIndex = 0UL;
+    uint32_t nRecordAddress = EMEEP_banksStaticCfg[nBankNumber].nStartAddress - EMEEP_nBanksOffset + nOffset;
+
+    while ((nRecordIndex < EMEEP_banksStaticCfg[nBankNumber].nMemoryCapacity) && (FALSE == bFormatted))
+    {
+        if ((TRUE == EMEEP_IsSignatureValid(nRecordAddress)) &&
+            (TRUE == EMEEP_IsChecksumValid(nBankNumber, nRecordAddress)))
+        {
+            bFormatted = TRUE;
+        }
+        else
+        {
+            nRecordAddress += EMEEP_banksStaticCfg[nBankNumber].nRecordSize;
+            nRecordIndex++;
+        }
+    }
+
+    return bFormatted;
+
+} // end of EMEEP_IsBankFormatted()
+#endif // #if (ON == EMEEP_BANKS_AT_FLASH_END)
+
+
+
 //**************************************************************************************************
 // @Function      EMEEP_FindPreviousValidRecord()
 //--------------------------------------------------------------------------------------------------
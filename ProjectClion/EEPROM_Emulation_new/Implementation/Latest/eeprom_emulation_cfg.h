@@ -32,7 +32,7 @@
 
 // Specify a used emulated EEPROM banks quantity
 // Valid values: [1 ; 4]
-#define EMEEP_USED_BANKS_QTY                    (1U)
+#define EMEEP_USED_BANKS_QTY                    (2U)
 
 
 
@@ -58,15 +58,24 @@
 
 
 
+// Place the banks relative to the end of the flash memory detected at run time.
+// The bank addresses are specified for the W25Q_CAPACITY_ALL_MEMORY_BYTES part
+// and are moved by the difference between the detected and this capacity.
+// The banks already formatted at the end of a smaller part are kept there.
+// Valid values: ON / OFF
+#define EMEEP_BANKS_AT_FLASH_END                (ON)
+
 #define EMEEP_BANK_0_START_ADDRESS              (W25Q_CAPACITY_ALL_MEMORY_BYTES - (2U * W25Q_CAPACITY_SECTOR_BYTES))
 #define EMEEP_BANK_0_END_ADDRESS                (W25Q_CAPACITY_ALL_MEMORY_BYTES - 1U)
 #define EMEEP_BANK_0_RECORD_DATA_ARRAY_SIZE     (32U - 12U)
 #define EMEEP_BANK_0_SECTOR_EW_ENDURANCE        (500000UL)
 
-#define EMEEP_BANK_1_START_ADDRESS              (0x00000000UL)
-#define EMEEP_BANK_1_END_ADDRESS                (0x00000000UL)
-#define EMEEP_BANK_1_RECORD_DATA_ARRAY_SIZE     (0U)
-#define EMEEP_BANK_1_SECTOR_EW_ENDURANCE        (0UL)
+// Bank 1 keeps the rarely changed configuration (ROM table of the 1-Wire sensors, layout version
+// of the records). A change of the size formats the bank again, the ROM table is enumerated again.
+#define EMEEP_BANK_1_START_ADDRESS              (W25Q_CAPACITY_ALL_MEMORY_BYTES - (4U * W25Q_CAPACITY_SECTOR_BYTES))
+#define EMEEP_BANK_1_END_ADDRESS                (W25Q_CAPACITY_ALL_MEMORY_BYTES - (2U * W25Q_CAPACITY_SECTOR_BYTES) - 1U)
+#define EMEEP_BANK_1_RECORD_DATA_ARRAY_SIZE     (128U - 12U)
+#define EMEEP_BANK_1_SECTOR_EW_ENDURANCE        (500000UL)
 
 #define EMEEP_BANK_2_START_ADDRESS              (0x00000000UL)
 #define EMEEP_BANK_2_END_ADDRESS                (0x00000000UL)
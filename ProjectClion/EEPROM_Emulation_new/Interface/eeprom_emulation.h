@@ -94,6 +94,11 @@ extern U32 EMEEP_GetMemoryStatus(void);
 // Sets a new memory status mask
 extern void EMEEP_SetMemoryStatus(const U32 nStatusMask);
 
+// Returns the flash memory area of the specified bank
+extern STD_RESULT EMEEP_GetBankArea(const U8 nBankNumber,
+                                    U32* const pStartAddress,
+                                    U32* const pEndAddress);
+
 
 
 #endif // #ifndef EEPROM_EMULATION_H
@@ -0,0 +1,1021 @@
+//**************************************************************************************************
+// @Module        GSM_AT
+// @Filename      gsm_at.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      STM32
+//--------------------------------------------------------------------------------------------------
+// @Compatible    STM32L476
+//--------------------------------------------------------------------------------------------------
+// @Description   Implementation of the GSM_AT functionality.
+//                The bytes received from the modem are put to the ring buffer by the UART
+//                interrupt, which wakes up the waiting task. The task assembles the response
+//                lines and finishes the command as soon as the modem answers.
+//                The data of the TCP connection comes in the same stream as "+IPD,<len>:<data>"
+//                (AT+CIPHEAD=1), the data is moved to the separate data ring buffer.
+//                In the transparent mode (AT+CIPMODE=1) all received bytes are the TCP data
+//                until the modem reports "CLOSED".
+//                The data is transmitted by DMA, the chunks of data are chained in the DMA
+//                interrupt, the task sleeps until the last chunk is sent.
+//
+//                Abbreviations:
+//                  URC - unsolicited result code.
+//
+//
+//                Global (public) functions:
+//                  GSM_AT_Init();
+//                  GSM_AT_Purge();
+//                  GSM_AT_Write();
+//                  GSM_AT_WriteV();
+//                  GSM_AT_Command();
+//                  GSM_AT_Read();
+//                  GSM_AT_IsClosed();
+//                  GSM_AT_GetResponse();
+//                  GSM_AT_SetDataMode();
+//                  GSM_AT_IRQHandler();
+//                  GSM_AT_DMA_TX_IRQHandler();
+//
+//                Local (private) functions:
+//                  GSM_AT_StartTxChunk();
+//                  GSM_AT_TxCplt();
+//                  GSM_AT_TxError();
+//                  GSM_AT_ParseRx();
+//                  GSM_AT_ParseChar();
+//                  GSM_AT_ParseLine();
+//
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "gsm_at.h"
+
+// Get ring buffer interface
+#include "circ_buffer.h"
+
+// Get LL USART
+#include "stm32l4xx_ll_usart.h"
+
+#include "string.h"
+#include "stdlib.h"
+
+
+
+//**************************************************************************************************
+// Verification of the imported configuration parameters
+//**************************************************************************************************
+
+#if (GSM_AT_SIZE_LINE < 16U)
+#error "GSM_AT_SIZE_LINE is too small for the responses of the modem"
+#endif
+
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Default response of the command
+#define GSM_AT_OK                         ("OK")
+
+// Header of the received data, "+IPD,<len>:"
+#define GSM_AT_IPD                        ("+IPD,")
+
+// URC of the closed connection
+#define GSM_AT_CLOSED                     ("CLOSED")
+
+// URC of the closed connection in the transparent mode
+#define GSM_AT_CLOSED_DATA                ("\r\nCLOSED\r\n")
+
+// Max quantity of bytes of one DMA transfer
+#define GSM_AT_MAX_SIZE_DMA               (0xFFFFU)
+
+// Bits of one byte on the UART line, 8N1
+#define GSM_AT_BITS_PER_BYTE              (10U)
+
+// Quantity of the error responses
+#define GSM_AT_QTY_ERRORS                 (3U)
+
+// Responses finishing the command with the error, "+CME ERROR", "CONNECT FAIL", "SEND FAIL" etc.
+static const char *const GSM_AT_aErrors[GSM_AT_QTY_ERRORS] =
+{
+    "ERROR",
+    "FAIL",
+    "CLOSED"
+};
+
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// RX ring buffer
+static stCIRCBUF GSM_AT_stRxBuf;
+static uint8_t GSM_AT_aRxBuf[GSM_AT_SIZE_RX_BUF];
+
+// Ring buffer of the received TCP data
+static stCIRCBUF GSM_AT_stDataBuf;
+static uint8_t GSM_AT_aDataBuf[GSM_AT_SIZE_DATA_BUF];
+
+// Bytes of the current "+IPD" frame still expected
+static uint32_t GSM_AT_nDataLeft = 0U;
+
+// The connection was closed by the server or the network
+static BOOLEAN GSM_AT_bClosed = FALSE;
+
+// All received bytes are the TCP data, transparent mode
+static BOOLEAN GSM_AT_bDataMode = FALSE;
+
+// Quantity of the matched chars of "CLOSED" in the transparent mode
+static uint32_t GSM_AT_nClosedMatch = 0U;
+
+// "\n" of "CONNECT\r\n" may follow in the transparent mode, it is not the data
+static BOOLEAN GSM_AT_bSkipLf = FALSE;
+
+// Current response line
+static char GSM_AT_aLine[GSM_AT_SIZE_LINE];
+static uint32_t GSM_AT_nLineLen = 0U;
+
+// Task waiting for the response
+static TaskHandle_t GSM_AT_hTask = NULL;
+
+// DMA handler of the transmitter
+static DMA_HandleTypeDef GSM_AT_DmaTxHandle;
+
+// Next chunk to send and quantity of the chunks left
+static const GSM_AT_TYPE_TX_CHUNK *GSM_AT_pTxChunk = NULL;
+static uint32_t GSM_AT_nTxLeft = 0U;
+
+// State of the transmission, set by the DMA interrupt
+static volatile BOOLEAN GSM_AT_bTxDone = FALSE;
+static volatile BOOLEAN GSM_AT_bTxError = FALSE;
+
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+// Parse the received data
+static BOOLEAN GSM_AT_ParseRx(const char *const pExpected,
+                              GSM_AT_RESPONSE *const pResp);
+
+// Put the received char to the line and check the line
+static BOOLEAN GSM_AT_ParseChar(const char cData,
+                                const char *const pExpected,
+                                GSM_AT_RESPONSE *const pResp);
+
+// Check the complete line
+static BOOLEAN GSM_AT_ParseLine(const char *const pExpected,
+                                GSM_AT_RESPONSE *const pResp);
+
+// Start DMA of the next not empty chunk
+static void GSM_AT_StartTxChunk(void);
+
+// DMA transfer complete callback
+static void GSM_AT_TxCplt(DMA_HandleTypeDef *hdma);
+
+// DMA transfer error callback
+static void GSM_AT_TxError(DMA_HandleTypeDef *hdma);
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_Init()
+//--------------------------------------------------------------------------------------------------
+// @Description   Init RX ring buffer, enable UART RX interrupt and init DMA of the transmitter.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The UART must be initialized before.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void GSM_AT_Init(void)
+{
+    GSM_AT_stRxBuf.itemSize = 1U;
+    GSM_AT_stDataBuf.itemSize = 1U;
+
+    // Init ring buffers
+    CIRCBUF_Init(&GSM_AT_stRxBuf,
+                 GSM_AT_aRxBuf,
+                 GSM_AT_SIZE_RX_BUF);
+    CIRCBUF_Init(&GSM_AT_stDataBuf,
+                 GSM_AT_aDataBuf,
+                 GSM_AT_SIZE_DATA_BUF);
+
+    GSM_AT_nLineLen = 0U;
+    GSM_AT_nDataLeft = 0U;
+    GSM_AT_bClosed = FALSE;
+    GSM_AT_bDataMode = FALSE;
+    GSM_AT_nClosedMatch = 0U;
+
+    // Enable RX interrupt
+    LL_USART_EnableIT_RXNE(GSM_AT_USART);
+    HAL_NVIC_SetPriority(GSM_AT_USART_IRQn, GSM_AT_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(GSM_AT_USART_IRQn);
+
+    // Configure DMA memory -> TDR
+    GSM_AT_DMA_CLK_ENABLE();
+    GSM_AT_DmaTxHandle.Instance                 = GSM_AT_DMA_TX_CHANNEL;
+    GSM_AT_DmaTxHandle.Init.Request             = GSM_AT_DMA_TX_REQUEST;
+    GSM_AT_DmaTxHandle.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    GSM_AT_DmaTxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    GSM_AT_DmaTxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    GSM_AT_DmaTxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    GSM_AT_DmaTxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    GSM_AT_DmaTxHandle.Init.Mode                = DMA_NORMAL;
+    GSM_AT_DmaTxHandle.Init.Priority            = DMA_PRIORITY_LOW;
+    HAL_DMA_Init(&GSM_AT_DmaTxHandle);
+    GSM_AT_DmaTxHandle.XferCpltCallback = GSM_AT_TxCplt;
+    GSM_AT_DmaTxHandle.XferErrorCallback = GSM_AT_TxError;
+
+    HAL_NVIC_SetPriority(GSM_AT_DMA_TX_IRQn, GSM_AT_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(GSM_AT_DMA_TX_IRQn);
+    LL_USART_EnableDMAReq_TX(GSM_AT_USART);
+} // end of GSM_AT_Init()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_Purge()
+//--------------------------------------------------------------------------------------------------
+// @Description   Drop the received data and the TCP data, clear the closed state and leave
+//                the transparent mode.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The data is taken from the tail of the buffer, so the interrupt may put new
+//                data at the same time. Call before the new connection.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void GSM_AT_Purge(void)
+{
+    uint8_t nData = 0U;
+
+    while (CIRCBUF_NO_ERR == CIRCBUF_GetData(&nData, &GSM_AT_stRxBuf))
+    {
+        DoNothing();
+    }
+
+    while (CIRCBUF_NO_ERR == CIRCBUF_GetData(&nData, &GSM_AT_stDataBuf))
+    {
+        DoNothing();
+    }
+
+    GSM_AT_nLineLen = 0U;
+    GSM_AT_nDataLeft = 0U;
+    GSM_AT_bClosed = FALSE;
+    GSM_AT_bDataMode = FALSE;
+    GSM_AT_nClosedMatch = 0U;
+} // end of GSM_AT_Purge()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_Write()
+//--------------------------------------------------------------------------------------------------
+// @Description   Write raw data to the modem.
+//--------------------------------------------------------------------------------------------------
+// @Notes         See GSM_AT_WriteV().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - data was sent
+//                RESULT_NOT_OK - DMA error or timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pData - data to send
+//                nSize - quantity of bytes
+//**************************************************************************************************
+STD_RESULT GSM_AT_Write(const void *const pData, const uint32_t nSize)
+{
+    GSM_AT_TYPE_TX_CHUNK stChunk;
+
+    stChunk.pData = pData;
+    stChunk.nSize = nSize;
+
+    return GSM_AT_WriteV(&stChunk, 1U);
+} // end of GSM_AT_Write()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_WriteV()
+//--------------------------------------------------------------------------------------------------
+// @Description   Write the chunks of data to the modem one after another without copying
+//                them to one buffer.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The next chunk is started by the DMA interrupt, the calling task sleeps until
+//                the last chunk is sent, so the data must not be changed before the return.
+//                The task waiting for the response is restored after the transmission.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - data was sent
+//                RESULT_NOT_OK - DMA error or timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pChunks - chunks of data to send
+//                nQty    - quantity of chunks
+//**************************************************************************************************
+STD_RESULT GSM_AT_WriteV(const GSM_AT_TYPE_TX_CHUNK *const pChunks, const uint32_t nQty)
+{
+    STD_RESULT enResult = RESULT_OK;
+    TaskHandle_t hPrevTask = GSM_AT_hTask;
+    TickType_t nStartTick = 0U;
+    TickType_t nTimeoutTick = 0U;
+    TickType_t nElapsedTick = 0U;
+    uint32_t nTotalSize = 0U;
+    uint32_t nItem = 0U;
+
+    for (nItem = 0U; nItem < nQty; nItem++)
+    {
+        if (pChunks[nItem].nSize > GSM_AT_MAX_SIZE_DMA)
+        {
+            enResult = RESULT_NOT_OK;
+        }
+        else
+        {
+            nTotalSize += pChunks[nItem].nSize;
+        }
+    }
+
+    if ((RESULT_OK == enResult) && (0U != nTotalSize))
+    {
+        // Transfer time of the data and the margin
+        nTimeoutTick = (GSM_AT_TX_TIMEOUT_MS +
+                        ((nTotalSize * GSM_AT_BITS_PER_BYTE * 1000U) /
+                         GSM_AT_UART_HANDLE.Init.BaudRate)) / portTICK_RATE_MS;
+
+        // Register the task for the wakeup and drop the stale notification
+        GSM_AT_hTask = xTaskGetCurrentTaskHandle();
+        (void)ulTaskNotifyTake(pdTRUE, 0U);
+
+        GSM_AT_pTxChunk = pChunks;
+        GSM_AT_nTxLeft = nQty;
+        GSM_AT_bTxDone = FALSE;
+        GSM_AT_bTxError = FALSE;
+        nStartTick = xTaskGetTickCount();
+        GSM_AT_StartTxChunk();
+
+        // The RX interrupt also wakes up the task, wait for the end of the transmission
+        while ((FALSE == GSM_AT_bTxDone) &&
+               (FALSE == GSM_AT_bTxError) &&
+               (nElapsedTick < nTimeoutTick))
+        {
+            (void)ulTaskNotifyTake(pdTRUE, nTimeoutTick - nElapsedTick);
+            nElapsedTick = xTaskGetTickCount() - nStartTick;
+        }
+
+        if (TRUE != GSM_AT_bTxDone)
+        {
+            HAL_DMA_Abort(&GSM_AT_DmaTxHandle);
+            enResult = RESULT_NOT_OK;
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        GSM_AT_hTask = hPrevTask;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return enResult;
+} // end of GSM_AT_WriteV()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_Command()
+//--------------------------------------------------------------------------------------------------
+// @Description   Send the command and wait for the response of the modem.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The command finishes on the first line starting with the expected response,
+//                on the error response or on the timeout. Other lines (echo, URC, "OK" of the
+//                commands with the final response) are skipped.
+//                The lines received before the command are dropped, the TCP data is kept.
+//                Not used in the transparent mode, the modem doesn't answer the commands.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   GSM_AT_RESP_OK      - expected response received
+//                GSM_AT_RESP_ERROR   - error response received or UART error
+//                GSM_AT_RESP_TIMEOUT - no response during the timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pCommand   - command with "\r", NULL - wait for the response only
+//                pExpected  - expected response, NULL - "OK"
+//                nTimeoutMs - timeout, ms
+//**************************************************************************************************
+GSM_AT_RESPONSE GSM_AT_Command(const char *const pCommand,
+                               const char *const pExpected,
+                               const uint32_t nTimeoutMs)
+{
+    GSM_AT_RESPONSE enResp = GSM_AT_RESP_TIMEOUT;
+    BOOLEAN bDone = FALSE;
+    const char *pWait = (NULL != pExpected) ? pExpected : GSM_AT_OK;
+    TickType_t nStartTick = xTaskGetTickCount();
+    TickType_t nTimeoutTick = nTimeoutMs / portTICK_RATE_MS;
+    TickType_t nElapsedTick = 0U;
+
+    // Register the task for the wakeup and drop the stale notification
+    GSM_AT_hTask = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTake(pdTRUE, 0U);
+
+    if (NULL != pCommand)
+    {
+        // Drop the old lines
+        (void)GSM_AT_ParseRx(NULL, &enResp);
+
+        if (RESULT_OK != GSM_AT_Write(pCommand, strlen(pCommand)))
+        {
+            enResp = GSM_AT_RESP_ERROR;
+            bDone = TRUE;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    while (FALSE == bDone)
+    {
+        // Parse all received data
+        bDone = GSM_AT_ParseRx(pWait, &enResp);
+
+        if (FALSE == bDone)
+        {
+            nElapsedTick = xTaskGetTickCount() - nStartTick;
+            if (nElapsedTick < nTimeoutTick)
+            {
+                // Wait for the next data
+                (void)ulTaskNotifyTake(pdTRUE, nTimeoutTick - nElapsedTick);
+            }
+            else
+            {
+                enResp = GSM_AT_RESP_TIMEOUT;
+                bDone = TRUE;
+            }
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    GSM_AT_hTask = NULL;
+
+    return enResp;
+} // end of GSM_AT_Command()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_Read()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read the TCP data received from the server.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Waits until nSize bytes are received or the timeout. The lines received
+//                meanwhile are dropped.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Quantity of bytes read, 0 - no data during the timeout,
+//                -1 - no data and the connection is closed
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pData      - [out] data
+//                nSize      - max quantity of bytes
+//                nTimeoutMs - timeout, ms
+//**************************************************************************************************
+int32_t GSM_AT_Read(void *const pData, const uint32_t nSize, const uint32_t nTimeoutMs)
+{
+    GSM_AT_RESPONSE enResp = GSM_AT_RESP_TIMEOUT;
+    TickType_t nStartTick = xTaskGetTickCount();
+    TickType_t nTimeoutTick = nTimeoutMs / portTICK_RATE_MS;
+    TickType_t nElapsedTick = 0U;
+    uint32_t nQty = 0U;
+    BOOLEAN bDone = FALSE;
+    int32_t nResult = 0;
+
+    // Register the task for the wakeup and drop the stale notification
+    GSM_AT_hTask = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTake(pdTRUE, 0U);
+
+    while (FALSE == bDone)
+    {
+        (void)GSM_AT_ParseRx(NULL, &enResp);
+
+        while ((nQty < nSize) &&
+               (CIRCBUF_NO_ERR == CIRCBUF_GetData((uint8_t*)pData + nQty, &GSM_AT_stDataBuf)))
+        {
+            nQty++;
+        }
+
+        nElapsedTick = xTaskGetTickCount() - nStartTick;
+        if ((nQty >= nSize) || (TRUE == GSM_AT_bClosed) || (nElapsedTick >= nTimeoutTick))
+        {
+            bDone = TRUE;
+        }
+        else
+        {
+            // Wait for the next data
+            (void)ulTaskNotifyTake(pdTRUE, nTimeoutTick - nElapsedTick);
+        }
+    }
+
+    GSM_AT_hTask = NULL;
+
+    if ((0U == nQty) && (TRUE == GSM_AT_bClosed))
+    {
+        nResult = -1;
+    }
+    else
+    {
+        nResult = (int32_t)nQty;
+    }
+
+    return nResult;
+} // end of GSM_AT_Read()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_IsClosed()
+//--------------------------------------------------------------------------------------------------
+// @Description   Check that the connection was closed by the server or the network.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The state is updated by GSM_AT_Command() and GSM_AT_Read().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE - "CLOSED" was received after GSM_AT_Purge()
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+BOOLEAN GSM_AT_IsClosed(void)
+{
+    return GSM_AT_bClosed;
+} // end of GSM_AT_IsClosed()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_GetResponse()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get the line which finished the last command, e.g. "+CSQ: 20,0".
+//--------------------------------------------------------------------------------------------------
+// @Notes         Valid until the next call of GSM_AT_Command() or GSM_AT_Read().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Response line.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+const char* GSM_AT_GetResponse(void)
+{
+    return GSM_AT_aLine;
+} // end of GSM_AT_GetResponse()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_SetDataMode()
+//--------------------------------------------------------------------------------------------------
+// @Description   Switch the parser to the transparent mode or back to the command mode.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Set after "CONNECT" of AT+CIPSTART with AT+CIPMODE=1 and reset before the
+//                escape sequence "+++". The parser leaves the transparent mode itself on
+//                "CLOSED". "CONNECT" is finished by "\r", the "\n" after it is dropped.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    bDataMode - TRUE - transparent mode, FALSE - command mode
+//**************************************************************************************************
+void GSM_AT_SetDataMode(const BOOLEAN bDataMode)
+{
+    GSM_AT_nLineLen = 0U;
+    GSM_AT_nClosedMatch = 0U;
+    GSM_AT_bSkipLf = bDataMode;
+    GSM_AT_bDataMode = bDataMode;
+} // end of GSM_AT_SetDataMode()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_IRQHandler()
+//--------------------------------------------------------------------------------------------------
+// @Description   UART interrupt handler. Puts the received byte to the ring buffer and wakes
+//                up the waiting task.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The byte is lost if the ring buffer is full.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void GSM_AT_IRQHandler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint8_t nData = 0U;
+
+    if (0U != (GSM_AT_USART->ISR & USART_ISR_RXNE))
+    {
+        nData = (uint8_t)GSM_AT_USART->RDR;
+        (void)CIRCBUF_PutData(&nData, &GSM_AT_stRxBuf);
+
+        if (NULL != GSM_AT_hTask)
+        {
+            vTaskNotifyGiveFromISR(GSM_AT_hTask, &xHigherPriorityTaskWoken);
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+    LL_USART_ClearFlag_ORE(GSM_AT_USART);
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+} // end of GSM_AT_IRQHandler()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_DMA_TX_IRQHandler()
+//--------------------------------------------------------------------------------------------------
+// @Description   DMA interrupt of the transmitter.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void GSM_AT_DMA_TX_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&GSM_AT_DmaTxHandle);
+} // end of GSM_AT_DMA_TX_IRQHandler()
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_ParseRx()
+//--------------------------------------------------------------------------------------------------
+// @Description   Parse the received data until the command is finished or the RX buffer is
+//                empty.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE  - the command is finished, *pResp is valid
+//                FALSE - wait for the next data
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pExpected - expected response, NULL - no command is waiting
+//                pResp     - [out] result of the command
+//**************************************************************************************************
+static BOOLEAN GSM_AT_ParseRx(const char *const pExpected,
+                              GSM_AT_RESPONSE *const pResp)
+{
+    BOOLEAN bDone = FALSE;
+    uint8_t nData = 0U;
+
+    while ((FALSE == bDone) &&
+           (CIRCBUF_NO_ERR == CIRCBUF_GetData(&nData, &GSM_AT_stRxBuf)))
+    {
+        bDone = GSM_AT_ParseChar((char)nData, pExpected, pResp);
+    }
+
+    return bDone;
+} // end of GSM_AT_ParseRx()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_ParseChar()
+//--------------------------------------------------------------------------------------------------
+// @Description   Put the received char to the line and check the line at the end of line.
+//                The data of the "+IPD" frame is put to the data ring buffer.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The prompt ">" of the modem and the header "+IPD,<len>:" are not terminated
+//                by the end of line, they are checked as soon as they are received.
+//                The data is lost if the data ring buffer is full.
+//                In the transparent mode "CLOSED" is also put to the data ring buffer, it
+//                doesn't matter as the connection is lost.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE  - the command is finished, *pResp is valid
+//                FALSE - wait for the next data
+//--------------------------------------------------------------------------------------------------
+// @Parameters    cData     - received char
+//                pExpected - expected response, NULL - no command is waiting
+//                pResp     - [out] result of the command
+//**************************************************************************************************
+static BOOLEAN GSM_AT_ParseChar(const char cData,
+                                const char *const pExpected,
+                                GSM_AT_RESPONSE *const pResp)
+{
+    BOOLEAN bDone = FALSE;
+
+    if ((TRUE == GSM_AT_bDataMode) && (TRUE == GSM_AT_bSkipLf) && ('\n' == cData))
+    {
+        // End of the line of "CONNECT"
+        GSM_AT_bSkipLf = FALSE;
+    }
+    else if (TRUE == GSM_AT_bDataMode)
+    {
+        GSM_AT_bSkipLf = FALSE;
+        (void)CIRCBUF_PutData(&cData, &GSM_AT_stDataBuf);
+
+        if (cData == GSM_AT_CLOSED_DATA[GSM_AT_nClosedMatch])
+        {
+            GSM_AT_nClosedMatch++;
+            if ((sizeof(GSM_AT_CLOSED_DATA) - 1U) == GSM_AT_nClosedMatch)
+            {
+                // The modem is back in the command mode
+                GSM_AT_bClosed = TRUE;
+                GSM_AT_bDataMode = FALSE;
+                GSM_AT_nClosedMatch = 0U;
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+        else
+        {
+            GSM_AT_nClosedMatch = ('\r' == cData) ? 1U : 0U;
+        }
+    }
+    else if (0U != GSM_AT_nDataLeft)
+    {
+        (void)CIRCBUF_PutData(&cData, &GSM_AT_stDataBuf);
+        GSM_AT_nDataLeft--;
+    }
+    else if (('\r' == cData) || ('\n' == cData))
+    {
+        if (0U != GSM_AT_nLineLen)
+        {
+            GSM_AT_aLine[GSM_AT_nLineLen] = '\0';
+            GSM_AT_nLineLen = 0U;
+            bDone = GSM_AT_ParseLine(pExpected, pResp);
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else if ((0U == GSM_AT_nLineLen) && (' ' == cData))
+    {
+        // Skip the leading spaces, e.g. after the prompt
+        DoNothing();
+    }
+    else
+    {
+        // The tail of the long line is truncated
+        if (GSM_AT_nLineLen < (GSM_AT_SIZE_LINE - 1U))
+        {
+            GSM_AT_aLine[GSM_AT_nLineLen] = cData;
+            GSM_AT_nLineLen++;
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        if ((1U == GSM_AT_nLineLen) && ('>' == cData))
+        {
+            GSM_AT_aLine[GSM_AT_nLineLen] = '\0';
+            GSM_AT_nLineLen = 0U;
+            bDone = GSM_AT_ParseLine(pExpected, pResp);
+        }
+        else if ((':' == cData) &&
+                 (0 == strncmp(GSM_AT_aLine, GSM_AT_IPD, sizeof(GSM_AT_IPD) - 1U)))
+        {
+            // Start of the data frame, the length is after the comma
+            GSM_AT_aLine[GSM_AT_nLineLen] = '\0';
+            GSM_AT_nDataLeft = (uint32_t)strtoul(&GSM_AT_aLine[sizeof(GSM_AT_IPD) - 1U], NULL, 10);
+            GSM_AT_nLineLen = 0U;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    return bDone;
+} // end of GSM_AT_ParseChar()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_ParseLine()
+//--------------------------------------------------------------------------------------------------
+// @Description   Check the complete line for the expected and the error responses.
+//--------------------------------------------------------------------------------------------------
+// @Notes         "CLOSED" is remembered also when no command is waiting.
+//                The error responses are checked first, so "CONNECT FAIL" doesn't match
+//                the expected "CONNECT".
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE  - the command is finished, *pResp is valid
+//                FALSE - the line is skipped
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pExpected - expected response, NULL - no command is waiting
+//                pResp     - [out] result of the command
+//**************************************************************************************************
+static BOOLEAN GSM_AT_ParseLine(const char *const pExpected,
+                                GSM_AT_RESPONSE *const pResp)
+{
+    BOOLEAN bDone = FALSE;
+    uint32_t nItem = 0U;
+
+    if (NULL != strstr(GSM_AT_aLine, GSM_AT_CLOSED))
+    {
+        GSM_AT_bClosed = TRUE;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    if (NULL == pExpected)
+    {
+        // No command is waiting, the line is dropped
+        DoNothing();
+    }
+    else
+    {
+        for (nItem = 0U; (nItem < GSM_AT_QTY_ERRORS) && (FALSE == bDone); nItem++)
+        {
+            if (NULL != strstr(GSM_AT_aLine, GSM_AT_aErrors[nItem]))
+            {
+                *pResp = GSM_AT_RESP_ERROR;
+                bDone = TRUE;
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+
+        if ((FALSE == bDone) &&
+            (0 == strncmp(GSM_AT_aLine, pExpected, strlen(pExpected))))
+        {
+            *pResp = GSM_AT_RESP_OK;
+            bDone = TRUE;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    return bDone;
+} // end of GSM_AT_ParseLine()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_StartTxChunk()
+//--------------------------------------------------------------------------------------------------
+// @Description   Start DMA of the next not empty chunk, the transmission is done if there
+//                are no more chunks.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called by the task for the first chunk and by the DMA interrupt for the next.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void GSM_AT_StartTxChunk(void)
+{
+    while ((0U != GSM_AT_nTxLeft) && (0U == GSM_AT_pTxChunk->nSize))
+    {
+        GSM_AT_pTxChunk++;
+        GSM_AT_nTxLeft--;
+    }
+
+    if (0U == GSM_AT_nTxLeft)
+    {
+        GSM_AT_bTxDone = TRUE;
+    }
+    else if (HAL_OK == HAL_DMA_Start_IT(&GSM_AT_DmaTxHandle,
+                                        (uint32_t)(uintptr_t)GSM_AT_pTxChunk->pData,
+                                        LL_USART_DMA_GetRegAddr(GSM_AT_USART, LL_USART_DMA_REG_DATA_TRANSMIT),
+                                        GSM_AT_pTxChunk->nSize))
+    {
+        GSM_AT_pTxChunk++;
+        GSM_AT_nTxLeft--;
+    }
+    else
+    {
+        GSM_AT_bTxError = TRUE;
+    }
+} // end of GSM_AT_StartTxChunk()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_TxCplt()
+//--------------------------------------------------------------------------------------------------
+// @Description   DMA transfer complete callback, starts the next chunk or wakes up the task.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called from the interrupt.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hdma - DMA handler
+//**************************************************************************************************
+static void GSM_AT_TxCplt(DMA_HandleTypeDef *hdma)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    (void)hdma;
+    GSM_AT_StartTxChunk();
+
+    if (((TRUE == GSM_AT_bTxDone) || (TRUE == GSM_AT_bTxError)) &&
+        (NULL != GSM_AT_hTask))
+    {
+        vTaskNotifyGiveFromISR(GSM_AT_hTask, &xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+} // end of GSM_AT_TxCplt()
+
+
+
+//**************************************************************************************************
+// @Function      GSM_AT_TxError()
+//--------------------------------------------------------------------------------------------------
+// @Description   DMA transfer error callback, wakes up the task.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called from the interrupt.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hdma - DMA handler
+//**************************************************************************************************
+static void GSM_AT_TxError(DMA_HandleTypeDef *hdma)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    (void)hdma;
+    GSM_AT_bTxError = TRUE;
+
+    if (NULL != GSM_AT_hTask)
+    {
+        vTaskNotifyGiveFromISR(GSM_AT_hTask, &xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+} // end of GSM_AT_TxError()
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,108 @@
+//**************************************************************************************************
+// @Module        GSM_AT
+// @Filename      gsm_at.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the GSM_AT module.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef GSM_AT_H
+#define GSM_AT_H
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "stm32l4xx_hal.h"
+
+#include "compiler.h"
+
+
+#include "general_types.h"
+
+// Get configuration of the program module
+#include "gsm_at_cfg.h"
+
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+// Result of the AT command
+typedef enum
+{
+    // Expected response received
+    GSM_AT_RESP_OK = 0U,
+    // Modem answered ERROR or FAIL
+    GSM_AT_RESP_ERROR,
+    // No expected response during the timeout
+    GSM_AT_RESP_TIMEOUT
+} GSM_AT_RESPONSE;
+
+// Chunk of the data to send
+typedef struct
+{
+    const void *pData;
+    uint32_t nSize;
+} GSM_AT_TYPE_TX_CHUNK;
+
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// Expected response of the data prompt of the modem
+#define GSM_AT_PROMPT                             (">")
+
+
+
+//**************************************************************************************************
+// Declarations of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// Init RX ring buffer and enable UART RX interrupt
+extern void GSM_AT_Init(void);
+// Drop the received data
+extern void GSM_AT_Purge(void);
+// Write raw data to the modem
+extern STD_RESULT GSM_AT_Write(const void *const pData, const uint32_t nSize);
+// Write the chunks of data to the modem one after another
+extern STD_RESULT GSM_AT_WriteV(const GSM_AT_TYPE_TX_CHUNK *const pChunks, const uint32_t nQty);
+// Send the command and wait for the response
+extern GSM_AT_RESPONSE GSM_AT_Command(const char *const pCommand,
+                                      const char *const pExpected,
+                                      const uint32_t nTimeoutMs);
+// Read the received TCP data
+extern int32_t GSM_AT_Read(void *const pData, const uint32_t nSize, const uint32_t nTimeoutMs);
+// Check that the connection is closed
+extern BOOLEAN GSM_AT_IsClosed(void);
+// Get the response line of the last command
+extern const char* GSM_AT_GetResponse(void);
+// Switch to the transparent mode or back to the command mode
+extern void GSM_AT_SetDataMode(const BOOLEAN bDataMode);
+// UART interrupt handler
+extern void GSM_AT_IRQHandler(void);
+// DMA interrupt handler of the transmitter
+extern void GSM_AT_DMA_TX_IRQHandler(void);
+
+#endif // #ifndef GSM_AT_H
+
+//****************************************** end of file *******************************************
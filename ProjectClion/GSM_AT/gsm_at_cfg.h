@@ -0,0 +1,64 @@
+//**************************************************************************************************
+// @Module        GSM_AT
+// @Filename      gsm_at_cfg.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Configuration of the required functionality of the GSM_AT module.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef GSM_AT_CFG_H
+#define GSM_AT_CFG_H
+
+// Get RTOS interface
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Get UART handler of the modem
+#include "Init.h"
+
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// The user specify UART of the modem, the UART is initialized by Init()
+#define GSM_AT_UART_HANDLE                        UartGSMHandler
+#define GSM_AT_USART                              USART3
+#define GSM_AT_USART_IRQn                         USART3_IRQn
+#define GSM_AT_IRQHandler                         USART3_IRQHandler
+
+// DMA of the UART transmitter, see the DMA request mapping of the reference manual
+#define GSM_AT_DMA_CLK_ENABLE()                   __HAL_RCC_DMA1_CLK_ENABLE()
+#define GSM_AT_DMA_TX_CHANNEL                     DMA1_Channel2
+#define GSM_AT_DMA_TX_REQUEST                     DMA_REQUEST_2
+#define GSM_AT_DMA_TX_IRQn                        DMA1_Channel2_IRQn
+#define GSM_AT_DMA_TX_IRQHandler                  DMA1_Channel2_IRQHandler
+
+// Priority of the UART and DMA interrupts, must not be higher than
+// configMAX_SYSCALL_INTERRUPT_PRIORITY
+#define GSM_AT_IRQ_PRIORITY                       (5U)
+
+// Size of the RX ring buffer, bytes
+#define GSM_AT_SIZE_RX_BUF                        (256U)
+
+// Size of the ring buffer of the received TCP data, bytes
+#define GSM_AT_SIZE_DATA_BUF                      (256U)
+
+// Max length of the response line, longer lines are truncated
+#define GSM_AT_SIZE_LINE                          (64U)
+
+// Timeout of the UART transmission in addition to the transfer time of the data, ms
+#define GSM_AT_TX_TIMEOUT_MS                      (1000U)
+
+
+#endif // #ifndef GSM_AT_CFG_H
+
+//****************************************** end of file *******************************************
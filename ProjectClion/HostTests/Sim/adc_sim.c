@@ -0,0 +1,201 @@
+//**************************************************************************************************
+// @Module        ADC_SIM
+// @Filename      adc_sim.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Simulator of the ADC of the board (Init_cfg.h) for the host tests.
+//
+//                The simulator is the ADC HAL of the host. The trigger timer starts a sequence
+//                of INIT_ADC_QTY_CH channels every period of its auto-reload, the first one a
+//                period after the start of the DMA. The DMA stores the sequences to the buffer,
+//                the last one calls the interrupt of the DMA channel of the task.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "adc_sim.h"
+
+#include "Init.h"
+#include "task_read_sensors_cfg.h"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static uint32_t ADC_SIM_aCounts[INIT_ADC_QTY_CH][ADC_SIM_MAX_COUNTS];
+static uint32_t ADC_SIM_aQtyCounts[INIT_ADC_QTY_CH];
+static ADC_HandleTypeDef *ADC_SIM_pHandle = NULL;
+static uint32_t *ADC_SIM_pBuffer = NULL;
+static ADC_SIM_STAT ADC_SIM_Stat;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void ADC_SIM_TimeHook(const uint64_t nTimeUs);
+static void ADC_SIM_DmaCplt(DMA_HandleTypeDef *hdma);
+static uint32_t ADC_SIM_GetCount(const uint32_t nChannel, const uint32_t nSequence);
+
+// Interrupt of the ADC DMA
+extern void TASK_READ_SEN_ADC_DMA_IRQHandler(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+void ADC_SIM_Init(void)
+{
+    memset(&ADC_SIM_Stat, 0, sizeof(ADC_SIM_Stat));
+    memset(ADC_SIM_aQtyCounts, 0, sizeof(ADC_SIM_aQtyCounts));
+    ADC_SIM_pHandle = NULL;
+    ADC_SIM_pBuffer = NULL;
+    HOST_pTimeHook = ADC_SIM_TimeHook;
+}
+
+void ADC_SIM_SetCounts(const uint32_t nChannel, const uint32_t *const pCounts, const uint32_t nQty)
+{
+    memcpy(ADC_SIM_aCounts[nChannel], pCounts, nQty * sizeof(pCounts[0]));
+    ADC_SIM_aQtyCounts[nChannel] = nQty;
+}
+
+void ADC_SIM_GetStat(ADC_SIM_STAT *const pStat)
+{
+    *pStat = ADC_SIM_Stat;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t SingleDiff)
+{
+    (void)hadc;
+    (void)SingleDiff;
+
+    ADC_SIM_Stat.nCalibrations++;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    HAL_StatusTypeDef status = HAL_BUSY;
+    DMA_Channel_TypeDef *const pDma = hadc->DMA_Handle->Instance;
+
+    if (0U == (pDma->CCR & DMA_CCR_EN))
+    {
+        // The buffer of the host doesn't fit in CMAR, the simulator keeps it
+        ADC_SIM_pHandle = hadc;
+        ADC_SIM_pBuffer = pData;
+        hadc->DMA_Handle->XferCpltCallback = ADC_SIM_DmaCplt;
+        pDma->CNDTR = Length;
+        pDma->CCR |= DMA_CCR_EN;
+
+        ADC_SIM_Stat.nStarts++;
+        ADC_SIM_Stat.nStartUs = HOST_nTimeUs;
+        ADC_SIM_Stat.nSequences = 0U;
+        status = HAL_OK;
+    }
+
+    return status;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc)
+{
+    hadc->DMA_Handle->Instance->CCR &= ~DMA_CCR_EN;
+
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetError(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+
+    return HAL_ADC_ERROR_NONE;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// The sequences of the trigger periods up to the time
+static void ADC_SIM_TimeHook(const uint64_t nTimeUs)
+{
+    DMA_Channel_TypeDef *pDma = NULL;
+    uint64_t nPeriodUs = 0U;
+    uint64_t nSequenceUs = 0U;
+
+    if (NULL != ADC_SIM_pHandle)
+    {
+        pDma = ADC_SIM_pHandle->DMA_Handle->Instance;
+        nPeriodUs = ((uint64_t)(INIT_ADC_TRIGGER_TIM->ARR + 1U) * 1000U) / INIT_ADC_TRIGGER_TICKS_PER_MS;
+        nSequenceUs = ADC_SIM_Stat.nStartUs + ((ADC_SIM_Stat.nSequences + 1U) * nPeriodUs);
+
+        while ((0U != (INIT_ADC_TRIGGER_TIM->CR1 & TIM_CR1_CEN)) &&
+               (0U != (pDma->CCR & DMA_CCR_EN)) &&
+               (0U != pDma->CNDTR) &&
+               (nSequenceUs <= nTimeUs))
+        {
+            const BOOLEAN bPowered = (0U != (INIT_PWR_ANEMOMETER_PORT->ODR & INIT_PWR_ANEMOMETER_PIN)) ? TRUE : FALSE;
+
+            for (uint32_t nCh = 0U; (nCh < INIT_ADC_QTY_CH) && (0U != pDma->CNDTR); nCh++)
+            {
+                *ADC_SIM_pBuffer++ = ((INIT_ANEMOMETER_INDEX == nCh) && (FALSE == bPowered)) ?
+                                     0U : ADC_SIM_GetCount(nCh, ADC_SIM_Stat.nSequences);
+                pDma->CNDTR--;
+            }
+
+            if (FALSE == bPowered)
+            {
+                ADC_SIM_Stat.nUnpowered++;
+            }
+            ADC_SIM_Stat.nLastSequenceUs = nSequenceUs;
+            ADC_SIM_Stat.nSequences++;
+            nSequenceUs += nPeriodUs;
+
+            if (0U == pDma->CNDTR)
+            {
+                TASK_READ_SEN_ADC_DMA_IRQHandler();
+            }
+        }
+    }
+}
+
+// End of the DMA transfer of the sequences
+static void ADC_SIM_DmaCplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+
+    HAL_ADC_ConvCpltCallback(ADC_SIM_pHandle);
+}
+
+static uint32_t ADC_SIM_GetCount(const uint32_t nChannel, const uint32_t nSequence)
+{
+    const uint32_t nQty = ADC_SIM_aQtyCounts[nChannel];
+
+    return (0U == nQty) ? 0U : ADC_SIM_aCounts[nChannel][(nSequence < nQty) ? nSequence : (nQty - 1U)];
+}
+
+//****************************************** end of file *******************************************
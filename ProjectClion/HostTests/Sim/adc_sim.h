@@ -0,0 +1,68 @@
+//**************************************************************************************************
+// @Module        ADC_SIM
+// @Filename      adc_sim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the simulator of the ADC sequences of the board for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef ADC_SIM_H
+#define ADC_SIM_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "compiler.h"
+#include "general_types.h"
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+typedef struct ADC_SIM_STAT_str
+{
+    uint32_t nCalibrations;     // Quantity of the calibrations
+    uint32_t nStarts;           // Quantity of the DMA starts
+    uint64_t nStartUs;          // Last DMA start
+    uint32_t nSequences;        // Sequences of the last start
+    uint64_t nLastSequenceUs;   // Last sequence of the last start
+    uint32_t nUnpowered;        // Sequences with the anemometer off
+}ADC_SIM_STAT;
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// Max quantity of the counts of one channel
+#define ADC_SIM_MAX_COUNTS              (64U)
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// ADC stopped, all channels read 0
+extern void ADC_SIM_Init(void);
+
+// Counts of the channel for the sequences since the start, the last one repeats. The anemometer
+// channel reads 0 while its power is off.
+extern void ADC_SIM_SetCounts(const uint32_t nChannel, const uint32_t *const pCounts, const uint32_t nQty);
+
+// Statistics
+extern void ADC_SIM_GetStat(ADC_SIM_STAT *const pStat);
+
+#endif // #ifndef ADC_SIM_H
+
+//****************************************** end of file *******************************************
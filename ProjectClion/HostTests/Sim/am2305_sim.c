@@ -0,0 +1,228 @@
+//**************************************************************************************************
+// @Module        AM2305_SIM
+// @Filename      am2305_sim.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Simulator of the AM2305 and of the input capture of its timer for the host
+//                tests.
+//
+//                The host pulls DQ low for the start signal and releases it to the input capture
+//                of the timer. After a start signal of at least 800 us the sensor plays the trace
+//                of the edges. The timer counts 1 us from the release, every edge is stored by
+//                the DMA request of the capture channel to CMAR of the DMA channel. The update
+//                of the timer calls the interrupt handler of the driver.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "am2305_sim.h"
+
+#include "am2305_drv.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#define AM2305_SIM_QTY_BITS             (40U)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static uint32_t AM2305_SIM_aTrace[AM2305_SIM_QTY_EDGES * 2U];
+static uint32_t AM2305_SIM_nQtyEdges = 0U;
+static AM2305_SIM_STAT AM2305_SIM_Stat;
+static BOOLEAN AM2305_SIM_bHostLow = FALSE;
+static uint64_t AM2305_SIM_nFallUs = 0U;
+static uint64_t AM2305_SIM_nBaseUs = 0U;
+static BOOLEAN AM2305_SIM_bAnswer = FALSE;
+static uint32_t AM2305_SIM_nNextEdge = 0U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void AM2305_SIM_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel);
+static void AM2305_SIM_TimeHook(const uint64_t nTimeUs);
+static uint32_t AM2305_SIM_Jitter(const uint32_t nUs, const uint32_t nJitterUs);
+
+// Interrupt of the driver
+extern void AM2305_TIMER_IRQHandler(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+void AM2305_SIM_Init(void)
+{
+    memset(&AM2305_SIM_Stat, 0, sizeof(AM2305_SIM_Stat));
+    AM2305_SIM_nQtyEdges = 0U;
+    AM2305_SIM_bHostLow = FALSE;
+    AM2305_SIM_bAnswer = FALSE;
+
+    HOST_pGpioHook = AM2305_SIM_GpioHook;
+    HOST_pTimeHook = AM2305_SIM_TimeHook;
+}
+
+uint32_t AM2305_SIM_MakeTrace(const uint8_t *const pData, const uint32_t nGoUs,
+                              const uint32_t nJitterUs, uint32_t *const pEdgeUs)
+{
+    uint32_t nTimeUs = nGoUs;
+    uint32_t nQty = 0U;
+
+    // Response low and high
+    pEdgeUs[nQty++] = nTimeUs;
+    nTimeUs += AM2305_SIM_Jitter(AM2305_SIM_T_REL_US, nJitterUs);
+    pEdgeUs[nQty++] = nTimeUs;
+    nTimeUs += AM2305_SIM_Jitter(AM2305_SIM_T_REH_US, nJitterUs);
+
+    // Bits, MSB first: low, then the high of the width of the bit
+    for (uint32_t i = 0U; i < AM2305_SIM_QTY_BITS; i++)
+    {
+        const BOOLEAN bOne = (0U != (pData[i / 8U] & (0x80U >> (i % 8U)))) ? TRUE : FALSE;
+
+        pEdgeUs[nQty++] = nTimeUs;
+        nTimeUs += AM2305_SIM_Jitter(AM2305_SIM_T_LOW_US, nJitterUs);
+        pEdgeUs[nQty++] = nTimeUs;
+        nTimeUs += AM2305_SIM_Jitter((TRUE == bOne) ? AM2305_SIM_T_H1_US : AM2305_SIM_T_H0_US,
+                                     nJitterUs);
+    }
+
+    // The sensor releases the bus
+    pEdgeUs[nQty++] = nTimeUs;
+    nTimeUs += AM2305_SIM_Jitter(AM2305_SIM_T_EN_US, nJitterUs);
+    pEdgeUs[nQty++] = nTimeUs;
+
+    return nQty;
+}
+
+void AM2305_SIM_SetTrace(const uint32_t *const pEdgeUs, const uint32_t nQty)
+{
+    memcpy(AM2305_SIM_aTrace, pEdgeUs, nQty * sizeof(pEdgeUs[0]));
+    AM2305_SIM_nQtyEdges = nQty;
+}
+
+void AM2305_SIM_GetStat(AM2305_SIM_STAT *const pStat)
+{
+    *pStat = AM2305_SIM_Stat;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void AM2305_SIM_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel)
+{
+    if ((AM2305_GPIO_PORT == pPort) && (0U != (nPin & AM2305_PIN)))
+    {
+        if ((0U == nLevel) && (FALSE == AM2305_SIM_bHostLow))
+        {
+            AM2305_SIM_bHostLow = TRUE;
+            AM2305_SIM_nFallUs = HOST_nTimeUs;
+        }
+        else if ((0U != nLevel) && (TRUE == AM2305_SIM_bHostLow))
+        {
+            // The driver starts the timer from 0 just before the release
+            AM2305_SIM_bHostLow = FALSE;
+            AM2305_SIM_nBaseUs = HOST_nTimeUs;
+            AM2305_SIM_nNextEdge = 0U;
+            AM2305_SIM_bAnswer = FALSE;
+
+            if (((HOST_nTimeUs - AM2305_SIM_nFallUs) >= AM2305_SIM_T_BE_MIN_US) &&
+                (0U != AM2305_SIM_nQtyEdges))
+            {
+                AM2305_SIM_Stat.nStarts++;
+                AM2305_SIM_bAnswer = TRUE;
+            }
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+}
+
+static void AM2305_SIM_TimeHook(const uint64_t nTimeUs)
+{
+    DMA_Channel_TypeDef *const pDma = AM2305_DMA_CHANNEL;
+    const uint64_t nElapsedUs = nTimeUs - AM2305_SIM_nBaseUs;
+    const BOOLEAN bRun = (0U != (AM2305_TIMER->CR1 & TIM_CR1_CEN)) ? TRUE : FALSE;
+
+    // Edges of the answer up to the current time
+    while ((TRUE == bRun) &&
+           (TRUE == AM2305_SIM_bAnswer) &&
+           (AM2305_SIM_nNextEdge < AM2305_SIM_nQtyEdges) &&
+           (AM2305_SIM_aTrace[AM2305_SIM_nNextEdge] <= nElapsedUs))
+    {
+        const uint16_t nCapture = (uint16_t)AM2305_SIM_aTrace[AM2305_SIM_nNextEdge];
+
+        AM2305_TIMER->CCR1 = nCapture;
+
+        if ((0U != (AM2305_TIMER->DIER & TIM_DIER_CC1DE)) &&
+            (0U != (pDma->CCR & DMA_CCR_EN)) &&
+            (0U != pDma->CNDTR))
+        {
+            *(uint16_t *)(uintptr_t)pDma->CMAR = nCapture;
+            pDma->CMAR += sizeof(uint16_t);
+            pDma->CNDTR--;
+            AM2305_SIM_Stat.nCaptured++;
+        }
+        else
+        {
+            AM2305_TIMER->SR |= TIM_SR_CC1IF;
+            AM2305_SIM_Stat.nLost++;
+        }
+        AM2305_SIM_nNextEdge++;
+    }
+
+    // Update of the timer
+    if ((TRUE == bRun) &&
+        (nElapsedUs >= AM2305_TIMER->ARR) &&
+        (0U != (AM2305_TIMER->DIER & TIM_DIER_UIE)))
+    {
+        AM2305_TIMER->SR |= TIM_SR_UIF;
+        AM2305_TIMER_IRQHandler();
+    }
+}
+
+static uint32_t AM2305_SIM_Jitter(const uint32_t nUs, const uint32_t nJitterUs)
+{
+    int32_t nError = 0;
+
+    if (0U != nJitterUs)
+    {
+        nError = (int32_t)((uint32_t)rand() % (2U * nJitterUs + 1U)) - (int32_t)nJitterUs;
+    }
+
+    return (uint32_t)((int32_t)nUs + nError);
+}
+
+//****************************************** end of file *******************************************
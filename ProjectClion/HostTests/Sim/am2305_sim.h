@@ -0,0 +1,79 @@
+//**************************************************************************************************
+// @Module        AM2305_SIM
+// @Filename      am2305_sim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the AM2305 simulator of the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef AM2305_SIM_H
+#define AM2305_SIM_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "compiler.h"
+#include "general_types.h"
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+typedef struct AM2305_SIM_STAT_str
+{
+    uint32_t nStarts;           // Quantity of the valid start signals
+    uint32_t nCaptured;         // Edges stored by DMA
+    uint32_t nLost;             // Edges without the DMA request
+}AM2305_SIM_STAT;
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// Edges of the answer: response low and high, 40 bits, the end of the last bit, the release
+#define AM2305_SIM_QTY_EDGES            (84U)
+
+// Timings of the AM2305 datasheet, us
+#define AM2305_SIM_T_BE_MIN_US          (800U)
+#define AM2305_SIM_T_GO_US              (30U)
+#define AM2305_SIM_T_REL_US             (80U)
+#define AM2305_SIM_T_REH_US             (80U)
+#define AM2305_SIM_T_LOW_US             (50U)
+#define AM2305_SIM_T_H0_US              (26U)
+#define AM2305_SIM_T_H1_US              (70U)
+#define AM2305_SIM_T_EN_US              (50U)
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// No sensor on the bus
+extern void AM2305_SIM_Init(void);
+
+// Times of the edges of the answer after the release of the start signal, us. Every pulse
+// gets a random error in [-nJitterUs, nJitterUs]. Returns the quantity of the edges.
+extern uint32_t AM2305_SIM_MakeTrace(const uint8_t *const pData, const uint32_t nGoUs,
+                                     const uint32_t nJitterUs, uint32_t *const pEdgeUs);
+
+// The sensor answers every start signal by the edges, 0 edges - no sensor
+extern void AM2305_SIM_SetTrace(const uint32_t *const pEdgeUs, const uint32_t nQty);
+
+// Statistics
+extern void AM2305_SIM_GetStat(AM2305_SIM_STAT *const pStat);
+
+#endif // #ifndef AM2305_SIM_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,322 @@
+//**************************************************************************************************
+// @Module        BMP280_SIM
+// @Filename      bmp280_sim.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Simulator of the BMP280 on the I2C bus for the host tests.
+//
+//                The simulator is the I2C HAL of the host: the memory transfers read and write
+//                the registers of the sensor. The transfer ends at once, the completion callback
+//                is called before the HAL function returns, the time of the bus isn't counted.
+//                A write is the register and the data, then the pairs of the register and of the
+//                data, as the sensor takes them. A read increments the register.
+//
+//                The forced mode starts a measurement of the max time of the datasheet for the
+//                oversampling, the status register shows it. The data registers get the raw
+//                values at the end of the measurement, a read before it is counted as early.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "bmp280_sim.h"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#define BMP280_SIM_REG_CALIB            (0x88U)
+#define BMP280_SIM_REG_CHIP_ID          (0xD0U)
+#define BMP280_SIM_REG_RESET            (0xE0U)
+#define BMP280_SIM_REG_STATUS           (0xF3U)
+#define BMP280_SIM_REG_CTRL_MEAS        (0xF4U)
+#define BMP280_SIM_REG_DATA             (0xF7U)
+#define BMP280_SIM_REG_DATA_END         (0xFCU)
+
+#define BMP280_SIM_CHIP_ID              (0x58U)
+#define BMP280_SIM_RESET_CMD            (0xB6U)
+#define BMP280_SIM_STATUS_MEASURING     (0x08U)
+#define BMP280_SIM_MODE_MASK            (0x03U)
+#define BMP280_SIM_MODE_SLEEP           (0x00U)
+#define BMP280_SIM_MODE_NORMAL          (0x03U)
+
+// Reset value of the data registers
+#define BMP280_SIM_ADC_RESET            (0x80000L)
+
+// Max measurement time of the datasheet: 1.25 ms, 2.3 ms for every temperature and pressure
+// sample and 0.575 ms for the pressure, us
+#define BMP280_SIM_T_BASE_US            (1250U)
+#define BMP280_SIM_T_SAMPLE_US          (2300U)
+#define BMP280_SIM_T_PRESSURE_US        (575U)
+
+#define BMP280_SIM_QTY_REGS             (256U)
+
+// Calibration of the datasheet example: dig_T1..dig_T3, dig_P1..dig_P9
+#define BMP280_SIM_QTY_CALIB            (12U)
+static const int32_t BMP280_SIM_aCalib[BMP280_SIM_QTY_CALIB] =
+{
+    27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000
+};
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static uint8_t BMP280_SIM_aReg[BMP280_SIM_QTY_REGS];
+static uint8_t BMP280_SIM_nAddress = 0U;
+static int32_t BMP280_SIM_nAdcT = BMP280_SIM_ADC_T;
+static int32_t BMP280_SIM_nAdcP = BMP280_SIM_ADC_P;
+static BOOLEAN BMP280_SIM_bMeasuring = FALSE;
+static uint32_t BMP280_SIM_nError = HAL_I2C_ERROR_NONE;
+static BMP280_SIM_STAT BMP280_SIM_Stat;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void BMP280_SIM_Reset(void);
+static void BMP280_SIM_Update(void);
+static void BMP280_SIM_Write(const uint8_t nReg, const uint8_t nValue);
+static void BMP280_SIM_SetAdc(const uint8_t nReg, const int32_t nAdc);
+static uint32_t BMP280_SIM_GetSamples(const uint8_t nOversampling);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+void BMP280_SIM_Init(const uint8_t nAddress)
+{
+    memset(&BMP280_SIM_Stat, 0, sizeof(BMP280_SIM_Stat));
+    BMP280_SIM_nAddress = nAddress;
+    BMP280_SIM_nAdcT = BMP280_SIM_ADC_T;
+    BMP280_SIM_nAdcP = BMP280_SIM_ADC_P;
+    BMP280_SIM_nError = HAL_I2C_ERROR_NONE;
+    BMP280_SIM_Reset();
+
+    for (uint32_t i = 0U; i < BMP280_SIM_QTY_CALIB; i++)
+    {
+        BMP280_SIM_aReg[BMP280_SIM_REG_CALIB + (2U * i)] = (uint8_t)BMP280_SIM_aCalib[i];
+        BMP280_SIM_aReg[BMP280_SIM_REG_CALIB + (2U * i) + 1U] = (uint8_t)(BMP280_SIM_aCalib[i] >> 8);
+    }
+}
+
+void BMP280_SIM_SetRaw(const int32_t nAdcT, const int32_t nAdcP)
+{
+    BMP280_SIM_nAdcT = nAdcT;
+    BMP280_SIM_nAdcP = nAdcP;
+}
+
+void BMP280_SIM_GetStat(BMP280_SIM_STAT *const pStat)
+{
+    *pStat = BMP280_SIM_Stat;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+    (void)MemAddSize;
+
+    BMP280_SIM_Stat.nTransfers++;
+    BMP280_SIM_Update();
+
+    if ((uint16_t)(BMP280_SIM_nAddress << 1) == DevAddress)
+    {
+        BMP280_SIM_nError = HAL_I2C_ERROR_NONE;
+
+        for (uint32_t i = 0U; i < Size; i++)
+        {
+            pData[i] = BMP280_SIM_aReg[(uint8_t)(MemAddress + i)];
+        }
+
+        // The read of the data registers
+        if (((MemAddress + Size) > BMP280_SIM_REG_DATA) && (MemAddress <= BMP280_SIM_REG_DATA_END))
+        {
+            BMP280_SIM_Stat.nReadUs = HOST_nTimeUs;
+            if ((TRUE == BMP280_SIM_bMeasuring) || (0U == BMP280_SIM_Stat.nMeasurements))
+            {
+                BMP280_SIM_Stat.nEarlyReads++;
+            }
+        }
+
+        HAL_I2C_MemRxCpltCallback(hi2c);
+    }
+    else
+    {
+        // No acknowledge of the address
+        BMP280_SIM_nError = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(hi2c);
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+    (void)MemAddSize;
+
+    BMP280_SIM_Stat.nTransfers++;
+    BMP280_SIM_Update();
+
+    if (((uint16_t)(BMP280_SIM_nAddress << 1) == DevAddress) && (0U != Size))
+    {
+        BMP280_SIM_nError = HAL_I2C_ERROR_NONE;
+
+        BMP280_SIM_Write((uint8_t)MemAddress, pData[0]);
+        for (uint32_t i = 1U; (i + 1U) < Size; i += 2U)
+        {
+            BMP280_SIM_Write(pData[i], pData[i + 1U]);
+        }
+
+        HAL_I2C_MemTxCpltCallback(hi2c);
+    }
+    else
+    {
+        BMP280_SIM_nError = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(hi2c);
+    }
+
+    return HAL_OK;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+
+    return BMP280_SIM_nError;
+}
+
+void HAL_I2C_EV_IRQHandler(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+}
+
+void HAL_I2C_ER_IRQHandler(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void BMP280_SIM_Reset(void)
+{
+    memset(&BMP280_SIM_aReg[BMP280_SIM_REG_STATUS], 0, BMP280_SIM_QTY_REGS - BMP280_SIM_REG_STATUS);
+    BMP280_SIM_aReg[BMP280_SIM_REG_CHIP_ID] = BMP280_SIM_CHIP_ID;
+    BMP280_SIM_SetAdc(BMP280_SIM_REG_DATA, BMP280_SIM_ADC_RESET);
+    BMP280_SIM_SetAdc(BMP280_SIM_REG_DATA + 3U, BMP280_SIM_ADC_RESET);
+    BMP280_SIM_bMeasuring = FALSE;
+}
+
+// The end of the measurement latches the data and returns to the sleep mode
+static void BMP280_SIM_Update(void)
+{
+    if ((TRUE == BMP280_SIM_bMeasuring) && (HOST_nTimeUs >= BMP280_SIM_Stat.nEndUs))
+    {
+        BMP280_SIM_bMeasuring = FALSE;
+        BMP280_SIM_aReg[BMP280_SIM_REG_STATUS] &= (uint8_t)~BMP280_SIM_STATUS_MEASURING;
+        BMP280_SIM_aReg[BMP280_SIM_REG_CTRL_MEAS] &= (uint8_t)~BMP280_SIM_MODE_MASK;
+        BMP280_SIM_SetAdc(BMP280_SIM_REG_DATA, BMP280_SIM_nAdcP);
+        BMP280_SIM_SetAdc(BMP280_SIM_REG_DATA + 3U, BMP280_SIM_nAdcT);
+    }
+}
+
+static void BMP280_SIM_Write(const uint8_t nReg, const uint8_t nValue)
+{
+    const uint8_t nMode = nValue & BMP280_SIM_MODE_MASK;
+
+    if (BMP280_SIM_REG_RESET == nReg)
+    {
+        if (BMP280_SIM_RESET_CMD == nValue)
+        {
+            BMP280_SIM_Reset();
+        }
+    }
+    else if (BMP280_SIM_REG_CTRL_MEAS == nReg)
+    {
+        BMP280_SIM_aReg[nReg] = nValue;
+
+        // Forced mode is 01 or 10, the normal mode isn't used by the task
+        if ((BMP280_SIM_MODE_SLEEP != nMode) && (BMP280_SIM_MODE_NORMAL != nMode) &&
+            (FALSE == BMP280_SIM_bMeasuring))
+        {
+            const uint32_t nSamplesT = BMP280_SIM_GetSamples((uint8_t)(nValue >> 5));
+            const uint32_t nSamplesP = BMP280_SIM_GetSamples((uint8_t)((nValue >> 2) & 7U));
+
+            BMP280_SIM_bMeasuring = TRUE;
+            BMP280_SIM_aReg[BMP280_SIM_REG_STATUS] |= BMP280_SIM_STATUS_MEASURING;
+            BMP280_SIM_Stat.nMeasurements++;
+            BMP280_SIM_Stat.nStartUs = HOST_nTimeUs;
+            BMP280_SIM_Stat.nEndUs = HOST_nTimeUs + BMP280_SIM_T_BASE_US +
+                                     (BMP280_SIM_T_SAMPLE_US * nSamplesT) +
+                                     ((0U != nSamplesP) ?
+                                      ((BMP280_SIM_T_SAMPLE_US * nSamplesP) + BMP280_SIM_T_PRESSURE_US) : 0U);
+        }
+    }
+    else if ((BMP280_SIM_REG_STATUS < nReg) && (BMP280_SIM_REG_DATA > nReg))
+    {
+        // config
+        BMP280_SIM_aReg[nReg] = nValue;
+    }
+    else
+    {
+        // Read only
+    }
+}
+
+// 20 bits of the raw value, MSB, LSB, XLSB
+static void BMP280_SIM_SetAdc(const uint8_t nReg, const int32_t nAdc)
+{
+    BMP280_SIM_aReg[nReg] = (uint8_t)(nAdc >> 12);
+    BMP280_SIM_aReg[nReg + 1U] = (uint8_t)(nAdc >> 4);
+    BMP280_SIM_aReg[nReg + 2U] = (uint8_t)((nAdc & 0x0F) << 4);
+}
+
+// Samples of the oversampling setting: skipped, x1, x2, x4, x8, x16
+static uint32_t BMP280_SIM_GetSamples(const uint8_t nOversampling)
+{
+    return (0U == nOversampling) ? 0U : (1UL << ((nOversampling > 5U) ? 4U : (nOversampling - 1U)));
+}
+
+//****************************************** end of file *******************************************
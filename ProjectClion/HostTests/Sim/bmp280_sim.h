@@ -0,0 +1,68 @@
+//**************************************************************************************************
+// @Module        BMP280_SIM
+// @Filename      bmp280_sim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the BMP280 simulator of the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef BMP280_SIM_H
+#define BMP280_SIM_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "compiler.h"
+#include "general_types.h"
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+typedef struct BMP280_SIM_STAT_str
+{
+    uint32_t nTransfers;        // Quantity of the I2C transfers
+    uint32_t nMeasurements;     // Quantity of the forced measurements
+    uint64_t nStartUs;          // Start of the last measurement
+    uint64_t nEndUs;            // End of the last measurement
+    uint64_t nReadUs;           // Last read of the data registers
+    uint32_t nEarlyReads;       // Reads of the data registers during the measurement
+}BMP280_SIM_STAT;
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// Raw values of the datasheet example, 25.08 C and 100653.27 Pa with its calibration
+#define BMP280_SIM_ADC_T                (519888L)
+#define BMP280_SIM_ADC_P                (415148L)
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// Sensor with the calibration of the datasheet example on the address, sleep mode
+extern void BMP280_SIM_Init(const uint8_t nAddress);
+
+// Raw values of the next measurement
+extern void BMP280_SIM_SetRaw(const int32_t nAdcT, const int32_t nAdcP);
+
+// Statistics
+extern void BMP280_SIM_GetStat(BMP280_SIM_STAT *const pStat);
+
+#endif // #ifndef BMP280_SIM_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,986 @@
+//**************************************************************************************************
+// @Module        GSM_SIM
+// @Filename      gsm_sim.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Simulator of the SIM800 modem on USART3 and of the MQTT broker behind it for
+//                the host tests.
+//
+//                The DMA channel of the transmitter gives the bytes to the modem at the baud
+//                rate, the end of the transfer calls the DMA interrupt of GSM_AT. The answers
+//                of the modem are given byte by byte by RDR and the UART interrupt. The modem
+//                answers the commands used by TASK_GSM, sends the data by AT+CIPSEND or in
+//                the transparent mode (AT+CIPMODE=1, "+++" with the guard time) and gives the
+//                data of the server as "+IPD,<len>:" or as is in the transparent mode.
+//                The network delays every byte by the latency. The broker answers CONNECT,
+//                PUBLISH QoS 1, PINGREQ and closes the connection after DISCONNECT, it keeps
+//                the payloads and counts the duplicates. The credentials of CONNECT are not
+//                parsed. The script replaces the answers of the modem to the chosen commands:
+//                the error, the silence, the late answer, the URC inside the answer. The DMA
+//                of the target may fail once on the chosen byte.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "gsm_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// Bytes with the time they are ready
+typedef struct
+{
+    uint8_t aData[0x4000U];
+    uint64_t aTimeUs[0x4000U];
+    uint32_t nHead;
+    uint32_t nTail;
+} GSM_SIM_QUEUE;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#define GSM_SIM_SIZE_QUEUE              (0x4000U)
+
+// Byte of the UART, 8N1
+#define GSM_SIM_BYTE_US                 ((10U * 1000000U) / GSM_SIM_BAUD_RATE)
+
+// Time of the modem to answer the command, us
+#define GSM_SIM_ANSWER_US               (5000U)
+
+// Time of the broker to answer the packet, us
+#define GSM_SIM_BROKER_US               (1000U)
+
+// Max hold of the swapped PUBACK, us
+#define GSM_SIM_HOLD_ACK_US             (500000U)
+
+// Max data of AT+CIPSEND and of one segment of the transparent mode
+#define GSM_SIM_MAX_SEGMENT             (1460U)
+
+#define GSM_SIM_SIZE_LINE               (128U)
+#define GSM_SIM_SIZE_PACKET             (512U)
+
+// MQTT packets
+#define GSM_SIM_MQTT_CONNECT            (1U)
+#define GSM_SIM_MQTT_PUBLISH            (3U)
+#define GSM_SIM_MQTT_PINGREQ            (12U)
+#define GSM_SIM_MQTT_DISCONNECT         (14U)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static GSM_SIM_CFG GSM_SIM_Cfg;
+static GSM_SIM_STAT GSM_SIM_Stat;
+
+// Modem to the target, modem to the broker, broker to the modem
+static GSM_SIM_QUEUE GSM_SIM_stUart;
+static GSM_SIM_QUEUE GSM_SIM_stUplink;
+static GSM_SIM_QUEUE GSM_SIM_stDownlink;
+
+// Modem
+static BOOLEAN GSM_SIM_bOn = FALSE;
+static uint64_t GSM_SIM_nPowerOnUs = 0U;
+static uint64_t GSM_SIM_nLastUs = 0U;
+static uint64_t GSM_SIM_nTxFreeUs = 0U;
+static uint64_t GSM_SIM_nRxFreeUs = 0U;
+static BOOLEAN GSM_SIM_bEcho = TRUE;
+static BOOLEAN GSM_SIM_bCipMode = FALSE;
+static BOOLEAN GSM_SIM_bTcpOpen = FALSE;
+static BOOLEAN GSM_SIM_bDataMode = FALSE;
+static char GSM_SIM_aLine[GSM_SIM_SIZE_LINE];
+static uint32_t GSM_SIM_nLineLen = 0U;
+static uint32_t GSM_SIM_nSendLeft = 0U;
+static uint64_t GSM_SIM_nConnectUs = 0U;
+static uint64_t GSM_SIM_nCloseUs = 0U;
+static uint64_t GSM_SIM_nLastDataUs = 0U;
+static uint32_t GSM_SIM_nPlus = 0U;
+static uint8_t GSM_SIM_aSegment[GSM_SIM_MAX_SEGMENT];
+static uint32_t GSM_SIM_nSegmentLen = 0U;
+static BOOLEAN GSM_SIM_bPowerLoss = FALSE;
+
+// Broker
+static BOOLEAN GSM_SIM_bBrokerOpen = FALSE;
+static BOOLEAN GSM_SIM_bSession = FALSE;
+static uint8_t GSM_SIM_aPacket[GSM_SIM_SIZE_PACKET];
+static uint32_t GSM_SIM_nPacketState = 0U;
+static uint32_t GSM_SIM_nRemaining = 0U;
+static uint32_t GSM_SIM_nLenShift = 0U;
+static uint32_t GSM_SIM_nBodyLen = 0U;
+static BOOLEAN GSM_SIM_bHeldAck = FALSE;
+static uint16_t GSM_SIM_nHeldAckId = 0U;
+static uint64_t GSM_SIM_nHeldAckUs = 0U;
+static uint64_t GSM_SIM_nDownlinkUs = 0U;
+
+// Script of the answers
+static const GSM_SIM_STEP *GSM_SIM_pScript = NULL;
+static uint32_t GSM_SIM_nScriptLeft = 0U;
+
+static char GSM_SIM_aPayloads[GSM_SIM_QTY_PAYLOADS][GSM_SIM_SIZE_PAYLOAD];
+static uint32_t GSM_SIM_nQtyPayloads = 0U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void GSM_SIM_TimeHook(const uint64_t nTimeUs);
+static void GSM_SIM_PowerOn(const uint64_t nTimeUs);
+static void GSM_SIM_PowerOff(const uint64_t nTimeUs);
+static void GSM_SIM_ProcessTx(const uint64_t nTimeUs);
+static void GSM_SIM_ProcessModem(const uint64_t nTimeUs);
+static void GSM_SIM_ProcessDownlink(const uint64_t nTimeUs);
+static void GSM_SIM_ProcessRx(const uint64_t nTimeUs);
+static void GSM_SIM_ModemRx(const uint8_t nData, const uint64_t nTimeUs);
+static void GSM_SIM_DataModeRx(const uint8_t nData, const uint64_t nTimeUs);
+static void GSM_SIM_Command(const uint64_t nTimeUs);
+static void GSM_SIM_Answer(const char *const pText, const uint64_t nTimeUs);
+static void GSM_SIM_SendSegment(const uint64_t nTimeUs);
+static void GSM_SIM_TcpClose(void);
+static void GSM_SIM_BrokerRx(const uint8_t nData, const uint64_t nTimeUs);
+static void GSM_SIM_BrokerPacket(const uint64_t nTimeUs);
+static void GSM_SIM_BrokerPublish(const uint64_t nTimeUs);
+static void GSM_SIM_BrokerPubAck(const uint16_t nPacketId, const uint64_t nTimeUs);
+static void GSM_SIM_BrokerSend(const uint8_t *const pData, const uint32_t nSize, const uint64_t nTimeUs);
+static void GSM_SIM_BrokerClose(const uint64_t nTimeUs);
+static void GSM_SIM_Put(GSM_SIM_QUEUE *const pQueue, const uint8_t nData, const uint64_t nTimeUs);
+static BOOLEAN GSM_SIM_IsReady(const GSM_SIM_QUEUE *const pQueue, const uint64_t nTimeUs);
+static uint8_t GSM_SIM_Get(GSM_SIM_QUEUE *const pQueue, uint64_t *const pTimeUs);
+
+// Interrupts of GSM_AT
+extern void USART3_IRQHandler(void);
+extern void DMA1_Channel2_IRQHandler(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+void GSM_SIM_Init(const GSM_SIM_CFG *const pCfg)
+{
+    GSM_SIM_Cfg = *pCfg;
+    memset(&GSM_SIM_Stat, 0, sizeof(GSM_SIM_Stat));
+    memset(&GSM_SIM_stUart, 0, sizeof(GSM_SIM_stUart));
+    memset(&GSM_SIM_stUplink, 0, sizeof(GSM_SIM_stUplink));
+    memset(&GSM_SIM_stDownlink, 0, sizeof(GSM_SIM_stDownlink));
+    GSM_SIM_nQtyPayloads = 0U;
+    GSM_SIM_bSession = FALSE;
+    GSM_SIM_bBrokerOpen = FALSE;
+    GSM_SIM_bPowerLoss = FALSE;
+    GSM_SIM_pScript = NULL;
+    GSM_SIM_nScriptLeft = 0U;
+
+    // The board keeps the modem off
+    GSM_SIM_POWER_PORT->ODR |= GSM_SIM_POWER_PIN;
+    GSM_SIM_bOn = FALSE;
+    GSM_SIM_nLastUs = HOST_nTimeUs;
+    GSM_SIM_nTxFreeUs = HOST_nTimeUs;
+    GSM_SIM_nRxFreeUs = HOST_nTimeUs;
+    GSM_SIM_nDownlinkUs = HOST_nTimeUs;
+
+    HOST_pTimeHook = GSM_SIM_TimeHook;
+}
+
+void GSM_SIM_GetDefaultCfg(GSM_SIM_CFG *const pCfg)
+{
+    memset(pCfg, 0, sizeof(*pCfg));
+    pCfg->nBootUs = 3000000U;
+    pCfg->nAttachUs = 8000000U;
+    pCfg->nConnectUs = 1500000U;
+    pCfg->nLatencyUs = 300000U;
+    pCfg->nCsq = 20U;
+    pCfg->bRefuse = FALSE;
+    pCfg->bPubAck = TRUE;
+    pCfg->bSwapAcks = FALSE;
+}
+
+void GSM_SIM_SetCfg(const GSM_SIM_CFG *const pCfg)
+{
+    GSM_SIM_Cfg = *pCfg;
+}
+
+void GSM_SIM_SetScript(const GSM_SIM_STEP *const pSteps, const uint32_t nQty)
+{
+    GSM_SIM_pScript = pSteps;
+    GSM_SIM_nScriptLeft = nQty;
+}
+
+uint32_t GSM_SIM_GetScriptLeft(void)
+{
+    return GSM_SIM_nScriptLeft;
+}
+
+void GSM_SIM_GetStat(GSM_SIM_STAT *const pStat)
+{
+    *pStat = GSM_SIM_Stat;
+
+    if (TRUE == GSM_SIM_bOn)
+    {
+        pStat->nOnUs += HOST_nTimeUs - GSM_SIM_nPowerOnUs;
+    }
+}
+
+uint32_t GSM_SIM_GetQtyPayloads(void)
+{
+    return GSM_SIM_nQtyPayloads;
+}
+
+const char* GSM_SIM_GetPayload(const uint32_t nIndex)
+{
+    return ((nIndex < GSM_SIM_nQtyPayloads) && (nIndex < GSM_SIM_QTY_PAYLOADS)) ?
+           GSM_SIM_aPayloads[nIndex] : NULL;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// The stages run in the order of the data path, every stage keeps the times of its bytes
+static void GSM_SIM_TimeHook(const uint64_t nTimeUs)
+{
+    const BOOLEAN bPowered = (0U == (GSM_SIM_POWER_PORT->ODR & GSM_SIM_POWER_PIN)) ? TRUE : FALSE;
+
+    if ((TRUE == bPowered) && (FALSE == GSM_SIM_bOn))
+    {
+        GSM_SIM_PowerOn(GSM_SIM_nLastUs);
+    }
+    else if ((FALSE == bPowered) && (TRUE == GSM_SIM_bOn))
+    {
+        GSM_SIM_PowerOff(GSM_SIM_nLastUs);
+    }
+
+    GSM_SIM_ProcessTx(nTimeUs);
+    GSM_SIM_ProcessModem(nTimeUs);
+
+    while (TRUE == GSM_SIM_IsReady(&GSM_SIM_stUplink, nTimeUs))
+    {
+        uint64_t nByteUs = 0U;
+        const uint8_t nData = GSM_SIM_Get(&GSM_SIM_stUplink, &nByteUs);
+
+        GSM_SIM_BrokerRx(nData, nByteUs);
+    }
+
+    if ((TRUE == GSM_SIM_bHeldAck) && (nTimeUs >= (GSM_SIM_nHeldAckUs + GSM_SIM_HOLD_ACK_US)))
+    {
+        GSM_SIM_bHeldAck = FALSE;
+        GSM_SIM_BrokerPubAck(GSM_SIM_nHeldAckId, GSM_SIM_nHeldAckUs + GSM_SIM_HOLD_ACK_US);
+    }
+
+    GSM_SIM_ProcessDownlink(nTimeUs);
+    GSM_SIM_ProcessRx(nTimeUs);
+    GSM_SIM_nLastUs = nTimeUs;
+
+    if (TRUE == GSM_SIM_bPowerLoss)
+    {
+        // Reset of the board: the modem is off, the task is dropped
+        GSM_SIM_bPowerLoss = FALSE;
+        GSM_SIM_POWER_PORT->ODR |= GSM_SIM_POWER_PIN;
+        GSM_SIM_PowerOff(nTimeUs);
+        HOST_TaskKill();
+    }
+}
+
+static void GSM_SIM_PowerOn(const uint64_t nTimeUs)
+{
+    GSM_SIM_bOn = TRUE;
+    GSM_SIM_nPowerOnUs = nTimeUs;
+    GSM_SIM_Stat.nPowerOn++;
+
+    GSM_SIM_bEcho = TRUE;
+    GSM_SIM_bCipMode = FALSE;
+    GSM_SIM_bTcpOpen = FALSE;
+    GSM_SIM_bDataMode = FALSE;
+    GSM_SIM_nLineLen = 0U;
+    GSM_SIM_nSendLeft = 0U;
+    GSM_SIM_nConnectUs = 0U;
+    GSM_SIM_nCloseUs = 0U;
+    GSM_SIM_nPlus = 0U;
+    GSM_SIM_nSegmentLen = 0U;
+}
+
+static void GSM_SIM_PowerOff(const uint64_t nTimeUs)
+{
+    if (TRUE == GSM_SIM_bOn)
+    {
+        GSM_SIM_Stat.nOnUs += nTimeUs - GSM_SIM_nPowerOnUs;
+    }
+    GSM_SIM_bOn = FALSE;
+    GSM_SIM_TcpClose();
+    GSM_SIM_nConnectUs = 0U;
+    GSM_SIM_stUart.nTail = GSM_SIM_stUart.nHead;
+}
+
+// The DMA gives the bytes at the baud rate, the modem gets them only when it is powered
+static void GSM_SIM_ProcessTx(const uint64_t nTimeUs)
+{
+    DMA_Channel_TypeDef *const pDma = DMA1_Channel2;
+
+    while ((0U != (pDma->CCR & DMA_CCR_EN)) &&
+           (0U != pDma->CNDTR) &&
+           ((GSM_SIM_nTxFreeUs + GSM_SIM_BYTE_US) <= nTimeUs))
+    {
+        const uint8_t nData = *(const uint8_t *)(uintptr_t)pDma->CMAR;
+
+        if ((GSM_SIM_Stat.nTxBytes + 1U) == GSM_SIM_Cfg.nTxErrorAt)
+        {
+            // The byte is lost, the channel stops
+            GSM_SIM_Cfg.nTxErrorAt = 0U;
+            GSM_SIM_nTxFreeUs += GSM_SIM_BYTE_US;
+            pDma->ISR |= DMA_ISR_TEIF1;
+            DMA1_Channel2_IRQHandler();
+        }
+        else
+        {
+            pDma->CMAR++;
+            pDma->CNDTR--;
+            GSM_SIM_nTxFreeUs += GSM_SIM_BYTE_US;
+            GSM_SIM_Stat.nTxBytes++;
+
+            if (TRUE == GSM_SIM_bOn)
+            {
+                GSM_SIM_ModemRx(nData, GSM_SIM_nTxFreeUs);
+            }
+
+            if (0U == pDma->CNDTR)
+            {
+                // May start the next chunk
+                DMA1_Channel2_IRQHandler();
+            }
+        }
+    }
+
+    if ((0U == (pDma->CCR & DMA_CCR_EN)) || (0U == pDma->CNDTR))
+    {
+        // Idle line, the next transfer starts not before now
+        GSM_SIM_nTxFreeUs = nTimeUs;
+    }
+}
+
+// Timers of the modem: the TCP connection, the escape and the segments of the transparent mode
+static void GSM_SIM_ProcessModem(const uint64_t nTimeUs)
+{
+    uint64_t nEventUs = 0U;
+
+    if ((FALSE == GSM_SIM_bOn) || (0U == GSM_SIM_nConnectUs) || (nTimeUs < GSM_SIM_nConnectUs))
+    {
+        DoNothing();
+    }
+    else if (TRUE == GSM_SIM_Cfg.bRefuse)
+    {
+        GSM_SIM_nConnectUs = 0U;
+        GSM_SIM_Answer("\r\nCONNECT FAIL\r\n", nTimeUs);
+    }
+    else
+    {
+        nEventUs = GSM_SIM_nConnectUs;
+        GSM_SIM_nConnectUs = 0U;
+        GSM_SIM_bTcpOpen = TRUE;
+        GSM_SIM_Stat.nTcpConnects++;
+
+        GSM_SIM_bBrokerOpen = TRUE;
+        GSM_SIM_nPacketState = 0U;
+        GSM_SIM_bHeldAck = FALSE;
+
+        if (TRUE == GSM_SIM_bCipMode)
+        {
+            GSM_SIM_Answer("\r\nCONNECT\r\n", nEventUs);
+            GSM_SIM_bDataMode = TRUE;
+            GSM_SIM_nLastDataUs = nEventUs;
+            GSM_SIM_nPlus = 0U;
+        }
+        else
+        {
+            GSM_SIM_Answer("\r\nCONNECT OK\r\n", nEventUs);
+        }
+    }
+
+    if ((TRUE == GSM_SIM_bDataMode) &&
+        (0U != GSM_SIM_nSegmentLen) &&
+        (nTimeUs >= (GSM_SIM_nLastDataUs + GSM_SIM_TRANSPARENT_WAIT_US)))
+    {
+        GSM_SIM_SendSegment(GSM_SIM_nLastDataUs + GSM_SIM_TRANSPARENT_WAIT_US);
+    }
+
+    if ((TRUE == GSM_SIM_bDataMode) &&
+        (3U == GSM_SIM_nPlus) &&
+        (nTimeUs >= (GSM_SIM_nLastDataUs + GSM_SIM_GUARD_US)))
+    {
+        // The connection is kept, the modem answers the commands
+        GSM_SIM_bDataMode = FALSE;
+        GSM_SIM_nPlus = 0U;
+        GSM_SIM_Stat.nEscapes++;
+        GSM_SIM_Answer("\r\nOK\r\n", GSM_SIM_nLastDataUs + GSM_SIM_GUARD_US);
+    }
+}
+
+// Data of the broker, the close of the broker after its data
+static void GSM_SIM_ProcessDownlink(const uint64_t nTimeUs)
+{
+    char aHeader[24];
+    uint8_t aData[GSM_SIM_MAX_SEGMENT];
+    uint32_t nSize = 0U;
+    uint64_t nFrameUs = 0U;
+    uint64_t nByteUs = 0U;
+
+    while (TRUE == GSM_SIM_IsReady(&GSM_SIM_stDownlink, nTimeUs))
+    {
+        // The bytes sent by the broker at once are one frame
+        nFrameUs = GSM_SIM_stDownlink.aTimeUs[GSM_SIM_stDownlink.nTail];
+        nSize = 0U;
+        while ((nSize < sizeof(aData)) &&
+               (TRUE == GSM_SIM_IsReady(&GSM_SIM_stDownlink, nTimeUs)) &&
+               (nFrameUs == GSM_SIM_stDownlink.aTimeUs[GSM_SIM_stDownlink.nTail]))
+        {
+            aData[nSize++] = GSM_SIM_Get(&GSM_SIM_stDownlink, &nByteUs);
+        }
+
+        if ((FALSE == GSM_SIM_bTcpOpen) || ((TRUE == GSM_SIM_bCipMode) && (FALSE == GSM_SIM_bDataMode)))
+        {
+            // No connection or the transparent mode is escaped, the data is dropped
+            DoNothing();
+        }
+        else
+        {
+            if (FALSE == GSM_SIM_bDataMode)
+            {
+                (void)snprintf(aHeader, sizeof(aHeader), "\r\n+IPD,%lu:", (unsigned long)nSize);
+                GSM_SIM_Answer(aHeader, nFrameUs);
+            }
+
+            for (uint32_t i = 0U; i < nSize; i++)
+            {
+                GSM_SIM_Put(&GSM_SIM_stUart, aData[i], nFrameUs);
+            }
+        }
+    }
+
+    if ((0U != GSM_SIM_nCloseUs) && (nTimeUs >= GSM_SIM_nCloseUs))
+    {
+        if (TRUE == GSM_SIM_bTcpOpen)
+        {
+            // The modem leaves the transparent mode itself
+            GSM_SIM_Answer("\r\nCLOSED\r\n", GSM_SIM_nCloseUs);
+        }
+        GSM_SIM_TcpClose();
+    }
+}
+
+// Bytes to the target at the baud rate, lost without the RX interrupt
+static void GSM_SIM_ProcessRx(const uint64_t nTimeUs)
+{
+    uint64_t nByteUs = 0U;
+    uint64_t nEndUs = 0U;
+    uint8_t nData = 0U;
+
+    while (GSM_SIM_stUart.nTail != GSM_SIM_stUart.nHead)
+    {
+        nByteUs = GSM_SIM_stUart.aTimeUs[GSM_SIM_stUart.nTail];
+        nEndUs = ((nByteUs > GSM_SIM_nRxFreeUs) ? nByteUs : GSM_SIM_nRxFreeUs) + GSM_SIM_BYTE_US;
+        if (nEndUs > nTimeUs)
+        {
+            break;
+        }
+
+        nData = GSM_SIM_Get(&GSM_SIM_stUart, &nByteUs);
+        GSM_SIM_nRxFreeUs = nEndUs;
+
+        if (0U != (USART3->CR1 & USART_CR1_RXNEIE))
+        {
+            GSM_SIM_Stat.nRxBytes++;
+            USART3->RDR = nData;
+            USART3->ISR |= USART_ISR_RXNE;
+            USART3_IRQHandler();
+            USART3->ISR &= ~USART_ISR_RXNE;
+        }
+    }
+}
+
+static void GSM_SIM_ModemRx(const uint8_t nData, const uint64_t nTimeUs)
+{
+    if (TRUE == GSM_SIM_bDataMode)
+    {
+        GSM_SIM_DataModeRx(nData, nTimeUs);
+    }
+    else if (0U != GSM_SIM_nSendLeft)
+    {
+        // Data of AT+CIPSEND, "SEND OK" after the ack of TCP
+        GSM_SIM_aSegment[GSM_SIM_nSegmentLen++] = nData;
+        GSM_SIM_nSendLeft--;
+        if (0U == GSM_SIM_nSendLeft)
+        {
+            GSM_SIM_SendSegment(nTimeUs);
+            GSM_SIM_Answer("\r\nSEND OK\r\n", nTimeUs + (2U * (uint64_t)GSM_SIM_Cfg.nLatencyUs));
+        }
+    }
+    else if (nTimeUs < (GSM_SIM_nPowerOnUs + GSM_SIM_Cfg.nBootUs))
+    {
+        // Not booted yet
+        DoNothing();
+    }
+    else
+    {
+        if (TRUE == GSM_SIM_bEcho)
+        {
+            GSM_SIM_Put(&GSM_SIM_stUart, nData, nTimeUs);
+        }
+
+        if ('\r' == nData)
+        {
+            GSM_SIM_aLine[GSM_SIM_nLineLen] = '\0';
+            GSM_SIM_Command(nTimeUs);
+            GSM_SIM_nLineLen = 0U;
+        }
+        else if (('\n' != nData) && (GSM_SIM_nLineLen < (GSM_SIM_SIZE_LINE - 1U)))
+        {
+            GSM_SIM_aLine[GSM_SIM_nLineLen++] = (char)nData;
+        }
+    }
+}
+
+// "+++" is the escape with the guard time of silence before and after it, otherwise it is data
+static void GSM_SIM_DataModeRx(const uint8_t nData, const uint64_t nTimeUs)
+{
+    if (('+' == nData) &&
+        (GSM_SIM_nPlus < 3U) &&
+        ((0U != GSM_SIM_nPlus) || (nTimeUs >= (GSM_SIM_nLastDataUs + GSM_SIM_GUARD_US))))
+    {
+        GSM_SIM_nPlus++;
+    }
+    else
+    {
+        while (0U != GSM_SIM_nPlus)
+        {
+            GSM_SIM_aSegment[GSM_SIM_nSegmentLen++] = '+';
+            GSM_SIM_nPlus--;
+        }
+
+        GSM_SIM_aSegment[GSM_SIM_nSegmentLen++] = nData;
+        if (GSM_SIM_nSegmentLen >= (GSM_SIM_MAX_SEGMENT - 3U))
+        {
+            GSM_SIM_SendSegment(nTimeUs);
+        }
+    }
+    GSM_SIM_nLastDataUs = nTimeUs;
+}
+
+static void GSM_SIM_Command(const uint64_t nTimeUs)
+{
+    char aAnswer[GSM_SIM_SIZE_LINE];
+    const char *const pCommand = strstr(GSM_SIM_aLine, "AT");
+    const uint64_t nAnswerUs = nTimeUs + GSM_SIM_ANSWER_US;
+    const BOOLEAN bAttached = (nTimeUs >= (GSM_SIM_nPowerOnUs + GSM_SIM_Cfg.nAttachUs)) ? TRUE : FALSE;
+    uint32_t nSize = 0U;
+
+    if (NULL == pCommand)
+    {
+        // Garbage or the empty line
+        if (0U != GSM_SIM_nLineLen)
+        {
+            GSM_SIM_Answer("\r\nERROR\r\n", nAnswerUs);
+        }
+        return;
+    }
+
+    GSM_SIM_Stat.nCommands++;
+
+    if ((0U != GSM_SIM_nScriptLeft) &&
+        (0 == strncmp(pCommand, GSM_SIM_pScript->pCommand, strlen(GSM_SIM_pScript->pCommand))))
+    {
+        if (NULL != GSM_SIM_pScript->pAnswer)
+        {
+            GSM_SIM_Answer(GSM_SIM_pScript->pAnswer, nTimeUs + GSM_SIM_pScript->nDelayUs);
+        }
+        GSM_SIM_pScript++;
+        GSM_SIM_nScriptLeft--;
+        return;
+    }
+
+    if ((0 == strcmp(pCommand, "AT")) || (0 == strcmp(pCommand, "AT+CIPHEAD=1")))
+    {
+        GSM_SIM_Answer("\r\nOK\r\n", nAnswerUs);
+    }
+    else if (0 == strcmp(pCommand, "ATE0"))
+    {
+        GSM_SIM_bEcho = FALSE;
+        GSM_SIM_Answer("\r\nOK\r\n", nAnswerUs);
+    }
+    else if (0 == strncmp(pCommand, "AT+CIPMODE=", 11U))
+    {
+        GSM_SIM_bCipMode = ('1' == pCommand[11]) ? TRUE : FALSE;
+        GSM_SIM_Answer("\r\nOK\r\n", nAnswerUs);
+    }
+    else if (0 == strcmp(pCommand, "AT+CGATT?"))
+    {
+        (void)snprintf(aAnswer, sizeof(aAnswer), "\r\n+CGATT: %u\r\n\r\nOK\r\n", (TRUE == bAttached) ? 1U : 0U);
+        GSM_SIM_Answer(aAnswer, nAnswerUs);
+    }
+    else if (0 == strcmp(pCommand, "AT+CSQ"))
+    {
+        (void)snprintf(aAnswer, sizeof(aAnswer), "\r\n+CSQ: %lu,0\r\n\r\nOK\r\n", (unsigned long)GSM_SIM_Cfg.nCsq);
+        GSM_SIM_Answer(aAnswer, nAnswerUs);
+    }
+    else if (0 == strcmp(pCommand, "AT+CIPSHUT"))
+    {
+        GSM_SIM_TcpClose();
+        GSM_SIM_nConnectUs = 0U;
+        GSM_SIM_Answer("\r\nSHUT OK\r\n", nAnswerUs);
+    }
+    else if (0 == strncmp(pCommand, "AT+CIPSTART=", 12U))
+    {
+        (void)snprintf(GSM_SIM_Stat.aServer, sizeof(GSM_SIM_Stat.aServer), "%s", &pCommand[12]);
+        if (FALSE == bAttached)
+        {
+            GSM_SIM_Answer("\r\nERROR\r\n", nAnswerUs);
+        }
+        else if ((TRUE == GSM_SIM_bTcpOpen) || (0U != GSM_SIM_nConnectUs))
+        {
+            GSM_SIM_Answer("\r\nERROR\r\n\r\nALREADY CONNECT\r\n", nAnswerUs);
+        }
+        else
+        {
+            GSM_SIM_Answer("\r\nOK\r\n", nAnswerUs);
+            GSM_SIM_nConnectUs = nAnswerUs + GSM_SIM_Cfg.nConnectUs;
+        }
+    }
+    else if (0 == strcmp(pCommand, "AT+CIPSTATUS"))
+    {
+        (void)snprintf(aAnswer, sizeof(aAnswer), "\r\nOK\r\n\r\nSTATE: %s\r\n",
+                       (TRUE == GSM_SIM_bTcpOpen) ? "CONNECT OK" : "TCP CLOSED");
+        GSM_SIM_Answer(aAnswer, nAnswerUs);
+    }
+    else if (0 == strncmp(pCommand, "AT+CIPSEND=", 11U))
+    {
+        nSize = (uint32_t)strtoul(&pCommand[11], NULL, 10);
+        if ((TRUE == GSM_SIM_bTcpOpen) && (FALSE == GSM_SIM_bCipMode) &&
+            (0U != nSize) && (nSize <= GSM_SIM_MAX_SEGMENT))
+        {
+            GSM_SIM_nSendLeft = nSize;
+            GSM_SIM_nSegmentLen = 0U;
+            GSM_SIM_Answer("\r\n> ", nAnswerUs);
+        }
+        else
+        {
+            GSM_SIM_Answer("\r\nERROR\r\n", nAnswerUs);
+        }
+    }
+    else if (0 == strcmp(pCommand, "AT+CIPCLOSE"))
+    {
+        if (TRUE == GSM_SIM_bTcpOpen)
+        {
+            GSM_SIM_TcpClose();
+            GSM_SIM_Answer("\r\nCLOSE OK\r\n", nAnswerUs);
+        }
+        else
+        {
+            GSM_SIM_Answer("\r\nERROR\r\n", nAnswerUs);
+        }
+    }
+    else
+    {
+        GSM_SIM_Answer("\r\nERROR\r\n", nAnswerUs);
+    }
+}
+
+static void GSM_SIM_Answer(const char *const pText, const uint64_t nTimeUs)
+{
+    for (const char *p = pText; '\0' != *p; p++)
+    {
+        GSM_SIM_Put(&GSM_SIM_stUart, (uint8_t)*p, nTimeUs);
+    }
+}
+
+static void GSM_SIM_SendSegment(const uint64_t nTimeUs)
+{
+    if (TRUE == GSM_SIM_bTcpOpen)
+    {
+        for (uint32_t i = 0U; i < GSM_SIM_nSegmentLen; i++)
+        {
+            GSM_SIM_Put(&GSM_SIM_stUplink, GSM_SIM_aSegment[i], nTimeUs + GSM_SIM_Cfg.nLatencyUs);
+        }
+    }
+    GSM_SIM_nSegmentLen = 0U;
+}
+
+// The connection is closed by the modem or the broker, the broker drops the packet in progress
+static void GSM_SIM_TcpClose(void)
+{
+    GSM_SIM_bTcpOpen = FALSE;
+    GSM_SIM_bDataMode = FALSE;
+    GSM_SIM_bBrokerOpen = FALSE;
+    GSM_SIM_bHeldAck = FALSE;
+    GSM_SIM_nCloseUs = 0U;
+    GSM_SIM_nSendLeft = 0U;
+    GSM_SIM_nSegmentLen = 0U;
+    GSM_SIM_nPlus = 0U;
+    GSM_SIM_stUplink.nTail = GSM_SIM_stUplink.nHead;
+    GSM_SIM_stDownlink.nTail = GSM_SIM_stDownlink.nHead;
+}
+
+// Fixed header, remaining length, body
+static void GSM_SIM_BrokerRx(const uint8_t nData, const uint64_t nTimeUs)
+{
+    if (FALSE == GSM_SIM_bBrokerOpen)
+    {
+        return;
+    }
+
+    switch (GSM_SIM_nPacketState)
+    {
+        case 0U:
+            GSM_SIM_aPacket[0] = nData;
+            GSM_SIM_nRemaining = 0U;
+            GSM_SIM_nLenShift = 0U;
+            GSM_SIM_nBodyLen = 0U;
+            GSM_SIM_nPacketState = 1U;
+            break;
+        case 1U:
+            GSM_SIM_nRemaining |= (uint32_t)(nData & 0x7FU) << GSM_SIM_nLenShift;
+            GSM_SIM_nLenShift += 7U;
+            if (0U == (nData & 0x80U))
+            {
+                GSM_SIM_nPacketState = 2U;
+                if (0U == GSM_SIM_nRemaining)
+                {
+                    GSM_SIM_nPacketState = 0U;
+                    GSM_SIM_BrokerPacket(nTimeUs);
+                }
+            }
+            break;
+        default:
+            if (GSM_SIM_nBodyLen < (GSM_SIM_SIZE_PACKET - 1U))
+            {
+                GSM_SIM_aPacket[1U + GSM_SIM_nBodyLen] = nData;
+            }
+            GSM_SIM_nBodyLen++;
+            if (GSM_SIM_nBodyLen == GSM_SIM_nRemaining)
+            {
+                GSM_SIM_nPacketState = 0U;
+                GSM_SIM_BrokerPacket(nTimeUs);
+            }
+            break;
+    }
+}
+
+static void GSM_SIM_BrokerPacket(const uint64_t nTimeUs)
+{
+    const uint8_t *const pBody = &GSM_SIM_aPacket[1];
+    const uint64_t nAnswerUs = nTimeUs + GSM_SIM_BROKER_US;
+    uint8_t aAnswer[4];
+    BOOLEAN bPresent = FALSE;
+
+    switch (GSM_SIM_aPacket[0] >> 4)
+    {
+        case GSM_SIM_MQTT_CONNECT:
+            // Protocol name "MQTT" with its length, level, flags; bit 1 - clean session
+            GSM_SIM_Stat.nMqttConnects++;
+            bPresent = ((0U == (pBody[7] & 0x02U)) && (TRUE == GSM_SIM_bSession)) ? TRUE : FALSE;
+            GSM_SIM_bSession = (0U == (pBody[7] & 0x02U)) ? TRUE : FALSE;
+            if (TRUE == bPresent)
+            {
+                GSM_SIM_Stat.nSessionPresent++;
+            }
+            aAnswer[0] = 0x20U;
+            aAnswer[1] = 0x02U;
+            aAnswer[2] = (TRUE == bPresent) ? 1U : 0U;
+            aAnswer[3] = 0x00U;
+            GSM_SIM_BrokerSend(aAnswer, 4U, nAnswerUs);
+            break;
+        case GSM_SIM_MQTT_PUBLISH:
+            GSM_SIM_BrokerPublish(nAnswerUs);
+            break;
+        case GSM_SIM_MQTT_PINGREQ:
+            GSM_SIM_Stat.nPingReqs++;
+            aAnswer[0] = 0xD0U;
+            aAnswer[1] = 0x00U;
+            GSM_SIM_BrokerSend(aAnswer, 2U, nAnswerUs);
+            break;
+        case GSM_SIM_MQTT_DISCONNECT:
+            GSM_SIM_Stat.nDisconnects++;
+            GSM_SIM_BrokerClose(nAnswerUs);
+            break;
+        default:
+            DoNothing();
+            break;
+    }
+}
+
+static void GSM_SIM_BrokerPublish(const uint64_t nTimeUs)
+{
+    const uint8_t *const pBody = &GSM_SIM_aPacket[1];
+    const uint32_t nQos = (GSM_SIM_aPacket[0] >> 1) & 0x03U;
+    const uint32_t nTopicLen = ((uint32_t)pBody[0] << 8) | pBody[1];
+    uint32_t nPos = 2U + nTopicLen;
+    uint16_t nPacketId = 0U;
+    char aPayload[GSM_SIM_SIZE_PAYLOAD];
+    uint32_t nPayloadLen = 0U;
+    uint32_t nItem = 0U;
+    const uint32_t nQtyKept = (GSM_SIM_nQtyPayloads < GSM_SIM_QTY_PAYLOADS) ?
+                              GSM_SIM_nQtyPayloads : GSM_SIM_QTY_PAYLOADS;
+
+    GSM_SIM_Stat.nPublishes++;
+    if (nQos > GSM_SIM_Stat.nMaxQos)
+    {
+        GSM_SIM_Stat.nMaxQos = nQos;
+    }
+    (void)snprintf(GSM_SIM_Stat.aTopic, sizeof(GSM_SIM_Stat.aTopic), "%.*s", (int)nTopicLen, (const char *)&pBody[2]);
+
+    if (0U != nQos)
+    {
+        nPacketId = (uint16_t)(((uint32_t)pBody[nPos] << 8) | pBody[nPos + 1U]);
+        nPos += 2U;
+    }
+
+    nPayloadLen = GSM_SIM_nRemaining - nPos;
+    if (nPayloadLen >= sizeof(aPayload))
+    {
+        nPayloadLen = sizeof(aPayload) - 1U;
+    }
+    memcpy(aPayload, &pBody[nPos], nPayloadLen);
+    aPayload[nPayloadLen] = '\0';
+
+    while ((nItem < nQtyKept) && (0 != strcmp(aPayload, GSM_SIM_aPayloads[nItem])))
+    {
+        nItem++;
+    }
+    if (nItem < nQtyKept)
+    {
+        GSM_SIM_Stat.nDuplicates++;
+    }
+    else
+    {
+        if (GSM_SIM_nQtyPayloads < GSM_SIM_QTY_PAYLOADS)
+        {
+            memcpy(GSM_SIM_aPayloads[GSM_SIM_nQtyPayloads], aPayload, nPayloadLen + 1U);
+        }
+        GSM_SIM_nQtyPayloads++;
+    }
+
+    if (GSM_SIM_Cfg.nPowerLossAt == GSM_SIM_Stat.nPublishes)
+    {
+        GSM_SIM_bPowerLoss = TRUE;
+    }
+    else if (GSM_SIM_Cfg.nCloseAt == GSM_SIM_Stat.nPublishes)
+    {
+        GSM_SIM_BrokerClose(nTimeUs);
+    }
+    else if ((1U == nQos) && (TRUE == GSM_SIM_Cfg.bPubAck))
+    {
+        if (FALSE == GSM_SIM_Cfg.bSwapAcks)
+        {
+            GSM_SIM_BrokerPubAck(nPacketId, nTimeUs);
+        }
+        else if (FALSE == GSM_SIM_bHeldAck)
+        {
+            GSM_SIM_bHeldAck = TRUE;
+            GSM_SIM_nHeldAckId = nPacketId;
+            GSM_SIM_nHeldAckUs = nTimeUs;
+        }
+        else
+        {
+            GSM_SIM_BrokerPubAck(nPacketId, nTimeUs);
+            GSM_SIM_BrokerPubAck(GSM_SIM_nHeldAckId, nTimeUs);
+            GSM_SIM_bHeldAck = FALSE;
+        }
+    }
+}
+
+static void GSM_SIM_BrokerPubAck(const uint16_t nPacketId, const uint64_t nTimeUs)
+{
+    uint8_t aAnswer[4];
+
+    GSM_SIM_Stat.nPubAcks++;
+    aAnswer[0] = 0x40U;
+    aAnswer[1] = 0x02U;
+    aAnswer[2] = (uint8_t)(nPacketId >> 8);
+    aAnswer[3] = (uint8_t)nPacketId;
+    GSM_SIM_BrokerSend(aAnswer, 4U, nTimeUs);
+}
+
+// The network keeps the order of the bytes
+static void GSM_SIM_BrokerSend(const uint8_t *const pData, const uint32_t nSize, const uint64_t nTimeUs)
+{
+    uint64_t nArriveUs = nTimeUs + GSM_SIM_Cfg.nLatencyUs;
+
+    if (nArriveUs < GSM_SIM_nDownlinkUs)
+    {
+        nArriveUs = GSM_SIM_nDownlinkUs;
+    }
+    GSM_SIM_nDownlinkUs = nArriveUs;
+
+    for (uint32_t i = 0U; i < nSize; i++)
+    {
+        GSM_SIM_Put(&GSM_SIM_stDownlink, pData[i], nArriveUs);
+    }
+}
+
+static void GSM_SIM_BrokerClose(const uint64_t nTimeUs)
+{
+    uint64_t nArriveUs = nTimeUs + GSM_SIM_Cfg.nLatencyUs;
+
+    if (nArriveUs < GSM_SIM_nDownlinkUs)
+    {
+        nArriveUs = GSM_SIM_nDownlinkUs;
+    }
+
+    GSM_SIM_bBrokerOpen = FALSE;
+    GSM_SIM_bHeldAck = FALSE;
+    GSM_SIM_nCloseUs = nArriveUs;
+}
+
+static void GSM_SIM_Put(GSM_SIM_QUEUE *const pQueue, const uint8_t nData, const uint64_t nTimeUs)
+{
+    const uint32_t nNext = (pQueue->nHead + 1U) % GSM_SIM_SIZE_QUEUE;
+
+    if (nNext != pQueue->nTail)
+    {
+        pQueue->aData[pQueue->nHead] = nData;
+        pQueue->aTimeUs[pQueue->nHead] = nTimeUs;
+        pQueue->nHead = nNext;
+    }
+}
+
+static BOOLEAN GSM_SIM_IsReady(const GSM_SIM_QUEUE *const pQueue, const uint64_t nTimeUs)
+{
+    return ((pQueue->nTail != pQueue->nHead) && (pQueue->aTimeUs[pQueue->nTail] <= nTimeUs)) ? TRUE : FALSE;
+}
+
+static uint8_t GSM_SIM_Get(GSM_SIM_QUEUE *const pQueue, uint64_t *const pTimeUs)
+{
+    const uint8_t nData = pQueue->aData[pQueue->nTail];
+
+    *pTimeUs = pQueue->aTimeUs[pQueue->nTail];
+    pQueue->nTail = (pQueue->nTail + 1U) % GSM_SIM_SIZE_QUEUE;
+
+    return nData;
+}
+
+//****************************************** end of file *******************************************
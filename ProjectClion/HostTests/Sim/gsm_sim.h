@@ -0,0 +1,135 @@
+//**************************************************************************************************
+// @Module        GSM_SIM
+// @Filename      gsm_sim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the simulator of the SIM800 modem and of the MQTT broker of the
+//                host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef GSM_SIM_H
+#define GSM_SIM_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "compiler.h"
+#include "general_types.h"
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+typedef struct GSM_SIM_CFG_str
+{
+    uint32_t nBootUs;           // Power on to the first answer to "AT"
+    uint32_t nAttachUs;         // Power on to the GPRS attach
+    uint32_t nConnectUs;        // AT+CIPSTART to "CONNECT OK"
+    uint32_t nLatencyUs;        // One way latency of the network
+    uint32_t nCsq;              // RSSI of AT+CSQ
+    BOOLEAN bRefuse;            // The TCP connection is refused, "CONNECT FAIL"
+    BOOLEAN bPubAck;            // The broker acknowledges QoS 1, otherwise QoS 0 only
+    BOOLEAN bSwapAcks;          // PUBACK of every odd PUBLISH is sent after the next one
+    uint32_t nCloseAt;          // The broker closes the connection instead of the ack of the
+                                // PUBLISH number, 0 - never
+    uint32_t nPowerLossAt;      // The target is reset when the broker gets the PUBLISH number,
+                                // 0 - never
+    uint32_t nTxErrorAt;        // The DMA of the target fails once on the byte number of
+                                // GSM_SIM_STAT.nTxBytes + 1, 0 - never
+}GSM_SIM_CFG;
+
+typedef struct GSM_SIM_STAT_str
+{
+    uint64_t nOnUs;             // Time of the powered modem
+    uint32_t nPowerOn;          // Quantity of the power on
+    uint32_t nCommands;         // AT commands
+    uint32_t nTcpConnects;      // TCP connections to the broker
+    uint32_t nMqttConnects;     // CONNECT packets
+    uint32_t nSessionPresent;   // CONNACK with the session present
+    uint32_t nPublishes;        // PUBLISH packets
+    uint32_t nDuplicates;       // PUBLISH of the payload received before
+    uint32_t nPubAcks;          // PUBACK packets
+    uint32_t nPingReqs;         // PINGREQ packets
+    uint32_t nDisconnects;      // DISCONNECT packets
+    uint32_t nEscapes;          // "+++" of the transparent mode
+    uint32_t nTxBytes;          // Bytes from the target to the modem
+    uint32_t nRxBytes;          // Bytes from the modem to the target
+    uint32_t nMaxQos;           // Max QoS of PUBLISH
+    char aServer[64];           // Server of the last AT+CIPSTART
+    char aTopic[64];            // Topic of the last PUBLISH
+}GSM_SIM_STAT;
+
+// Scripted answer of the modem
+typedef struct GSM_SIM_STEP_str
+{
+    const char *pCommand;       // Start of the command line, e.g. "AT+CSQ"
+    const char *pAnswer;        // Answer with "\r\n", NULL - no answer
+    uint32_t nDelayUs;          // Command to the answer
+}GSM_SIM_STEP;
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// UART of the modem, 8N1
+#define GSM_SIM_BAUD_RATE               (9600U)
+
+// Power switch of the modem, low - on
+#define GSM_SIM_POWER_PORT              GPIOC
+#define GSM_SIM_POWER_PIN               GPIO_PIN_4
+
+// Guard time of "+++", us
+#define GSM_SIM_GUARD_US                (1000000U)
+
+// Idle time of the UART before the modem sends the data of the transparent mode, us
+#define GSM_SIM_TRANSPARENT_WAIT_US     (200000U)
+
+// Payloads kept by the broker, the next are only counted
+#define GSM_SIM_QTY_PAYLOADS            (2048U)
+#define GSM_SIM_SIZE_PAYLOAD            (128U)
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// Modem is off, new broker. The modem answers after the timings of the configuration.
+extern void GSM_SIM_Init(const GSM_SIM_CFG *const pCfg);
+
+// Default configuration: the good network, QoS 1 broker
+extern void GSM_SIM_GetDefaultCfg(GSM_SIM_CFG *const pCfg);
+
+// Change the configuration, the state of the modem and of the broker is kept
+extern void GSM_SIM_SetCfg(const GSM_SIM_CFG *const pCfg);
+
+// Script of the answers. The command which starts as the current step is answered by the
+// step and the script goes to the next step, the other commands are answered by the modem.
+extern void GSM_SIM_SetScript(const GSM_SIM_STEP *const pSteps, const uint32_t nQty);
+
+// Quantity of the steps of the script not used yet
+extern uint32_t GSM_SIM_GetScriptLeft(void);
+
+// Statistics
+extern void GSM_SIM_GetStat(GSM_SIM_STAT *const pStat);
+
+// Quantity of the different payloads received by the broker
+extern uint32_t GSM_SIM_GetQtyPayloads(void);
+
+// Payload in the order of the first receiving, NULL - not kept
+extern const char* GSM_SIM_GetPayload(const uint32_t nIndex);
+
+#endif // #ifndef GSM_SIM_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,742 @@
+//**************************************************************************************************
+// @Module        ONE_WIRE_SIM
+// @Filename      onewire_sim.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Simulator of the 1-Wire bus with DS18B20 devices for the host tests.
+//
+//                The bus is simulated at the pin level, so the GPIO backend of ONE_WIRE runs
+//                against it unchanged. The master pulls DQ low by the reset of the output pin
+//                and releases it by the input mode. The length of the low pulse is the reset
+//                (>= 480 us), the write 0 (>= 15 us) or the write 1 / read slot. At the falling
+//                edge every device which sends a 0 holds DQ low for 30 us, the level of DQ is
+//                the wired AND of the master and of all devices. The devices support the ROM
+//                commands Read, Match, Skip and Search ROM, and the function commands Convert T,
+//                Read and Write Scratchpad. Read slots return 0 while the conversion runs.
+//
+//                With the UART backend the simulator is also the loopback of the half-duplex
+//                UART. Every byte of the TX DMA is a frame on DQ: the start bit, the data bits
+//                LSB first and the stop bit at the bit time of BRR. The low bits of the frame
+//                are the pulses of the master, the receiver samples DQ in the middle of every
+//                data bit and the RX DMA stores the read back byte. The last byte calls the
+//                interrupt of the RX DMA channel.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "onewire_sim.h"
+
+#include "OneWire.h"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+typedef enum
+{
+    ONE_WIRE_SIM_IDLE = 0,          // Not selected, waits for the reset
+    ONE_WIRE_SIM_ROM_CMD,           // Receives the ROM command
+    ONE_WIRE_SIM_READ_ROM,          // Sends the ROM code
+    ONE_WIRE_SIM_MATCH_ROM,         // Receives the ROM code
+    ONE_WIRE_SIM_SEARCH_ROM,        // Sends the bit and its complement, receives the direction
+    ONE_WIRE_SIM_FUNC_CMD,          // Selected, receives the function command
+    ONE_WIRE_SIM_CONVERT,           // Converts, read slots return 0 until the end
+    ONE_WIRE_SIM_READ_SCRATCHPAD,   // Sends the scratchpad
+    ONE_WIRE_SIM_WRITE_SCRATCHPAD   // Receives TH, TL and config
+}enONE_WIRE_SIM_STATE;
+
+typedef struct ONE_WIRE_SIM_DEVICE_str
+{
+    uint64_t nRom;
+    uint8_t  aScratchpad[9];
+    int16_t  nTemperature;          // Raw value of the next conversion, 1/16 C
+    BOOLEAN  bAttached;
+    uint32_t nResetsToDetach;       // 0 - stays on the bus
+    enONE_WIRE_SIM_STATE state;
+    uint32_t nBit;                  // Bit of the current state
+    uint8_t  nRxByte;               // Byte being received, LSB first
+    uint8_t  nShift;                // Received bits of the byte
+    uint8_t  nSearchPhase;          // 0 - bit, 1 - complement, 2 - direction
+    uint64_t nConvertEndUs;
+    uint32_t nBusySlots;            // Read slots of the conversion, 0 - the conversion time
+    uint32_t nBusyLeft;             // Read slots left of the conversion
+    uint64_t nHoldUntilUs;          // Device holds DQ low until the time
+}ONE_WIRE_SIM_DEVICE;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#define ONE_WIRE_SIM_READ_ROM_CMD       (0x33U)
+#define ONE_WIRE_SIM_MATCH_ROM_CMD      (0x55U)
+#define ONE_WIRE_SIM_SKIP_ROM_CMD       (0xCCU)
+#define ONE_WIRE_SIM_SEARCH_ROM_CMD     (0xF0U)
+#define ONE_WIRE_SIM_CONVERT_T_CMD      (0x44U)
+#define ONE_WIRE_SIM_READ_SCR_CMD       (0xBEU)
+#define ONE_WIRE_SIM_WRITE_SCR_CMD      (0x4EU)
+
+#define ONE_WIRE_SIM_ROM_BITS           (64U)
+#define ONE_WIRE_SIM_SCRATCHPAD_BITS    (72U)
+#define ONE_WIRE_SIM_WRITE_BITS         (24U)
+
+// Bits of the UART frame: start, 8 data, stop
+#define ONE_WIRE_SIM_UART_FRAME_BITS    (10U)
+
+// Power-on value of the temperature, 85 C
+#define ONE_WIRE_SIM_POWER_ON_T         (0x0550)
+
+// Max conversion time for 9, 10, 11, 12 bits, us
+static const uint32_t ONE_WIRE_SIM_aConversionUs[] = {93750U, 187500U, 375000U, 750000U};
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static ONE_WIRE_SIM_DEVICE ONE_WIRE_SIM_aDevice[ONE_WIRE_SIM_MAX_DEVICES];
+static uint32_t ONE_WIRE_SIM_nDevices = 0U;
+static ONE_WIRE_SIM_STAT ONE_WIRE_SIM_Stat;
+static BOOLEAN ONE_WIRE_SIM_bMasterLow = FALSE;
+static uint64_t ONE_WIRE_SIM_nFallUs = 0U;
+static uint64_t ONE_WIRE_SIM_nPresenceFromUs = 0U;
+static uint64_t ONE_WIRE_SIM_nPresenceToUs = 0U;
+
+// Time of the bus event being processed
+static uint64_t ONE_WIRE_SIM_nNowUs = 0U;
+
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+// Last time of the time hook, the DMA transfer starts there
+static uint64_t ONE_WIRE_SIM_nUartLastUs = 0U;
+// Transfer of the DMA is in progress, its length and the start of its next frame
+static BOOLEAN ONE_WIRE_SIM_bUartBusy = FALSE;
+static uint32_t ONE_WIRE_SIM_nUartQty = 0U;
+static uint64_t ONE_WIRE_SIM_nUartNextUs = 0U;
+#endif
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void ONE_WIRE_SIM_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel);
+static void ONE_WIRE_SIM_TimeHook(const uint64_t nTimeUs);
+static void ONE_WIRE_SIM_Edge(const uint32_t nLevel);
+static void ONE_WIRE_SIM_UpdatePin(void);
+static BOOLEAN ONE_WIRE_SIM_IsLow(void);
+static void ONE_WIRE_SIM_Reset(void);
+static uint8_t ONE_WIRE_SIM_Output(ONE_WIRE_SIM_DEVICE *const pDev);
+static void ONE_WIRE_SIM_Slot(ONE_WIRE_SIM_DEVICE *const pDev, const uint8_t nBit);
+static BOOLEAN ONE_WIRE_SIM_ReceiveByte(ONE_WIRE_SIM_DEVICE *const pDev, const uint8_t nBit,
+                                        uint8_t *const pByte);
+static void ONE_WIRE_SIM_Command(ONE_WIRE_SIM_DEVICE *const pDev, const uint8_t nCmd);
+static void ONE_WIRE_SIM_LatchConversion(ONE_WIRE_SIM_DEVICE *const pDev);
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+static void ONE_WIRE_SIM_Uart(const uint64_t nTimeUs);
+static uint8_t ONE_WIRE_SIM_UartFrame(const uint8_t nByte, const uint64_t nStartUs);
+static uint64_t ONE_WIRE_SIM_UartTimeUs(const uint32_t nHalfBits);
+
+// Interrupt of the RX DMA of the backend
+extern void ONE_WIRE_UART_DMA_RX_IRQHandler(void);
+#endif
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+void ONE_WIRE_SIM_Init(void)
+{
+    memset(ONE_WIRE_SIM_aDevice, 0, sizeof(ONE_WIRE_SIM_aDevice));
+    memset(&ONE_WIRE_SIM_Stat, 0, sizeof(ONE_WIRE_SIM_Stat));
+    ONE_WIRE_SIM_nDevices = 0U;
+    ONE_WIRE_SIM_bMasterLow = FALSE;
+    ONE_WIRE_SIM_nPresenceFromUs = 0U;
+    ONE_WIRE_SIM_nPresenceToUs = 0U;
+    ONE_WIRE_SIM_nNowUs = HOST_nTimeUs;
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    ONE_WIRE_SIM_nUartLastUs = HOST_nTimeUs;
+    ONE_WIRE_SIM_bUartBusy = FALSE;
+#endif
+
+    HOST_pGpioHook = ONE_WIRE_SIM_GpioHook;
+    HOST_pTimeHook = ONE_WIRE_SIM_TimeHook;
+    ONE_WIRE_SIM_UpdatePin();
+}
+
+uint32_t ONE_WIRE_SIM_AddDevice(const uint64_t nRom, const int16_t nTemperature)
+{
+    ONE_WIRE_SIM_DEVICE *pDev = &ONE_WIRE_SIM_aDevice[ONE_WIRE_SIM_nDevices];
+
+    memset(pDev, 0, sizeof(*pDev));
+    pDev->nRom = nRom;
+    pDev->nTemperature = nTemperature;
+    pDev->bAttached = TRUE;
+    pDev->state = ONE_WIRE_SIM_IDLE;
+
+    // Power-on scratchpad: 85 C, TH 75, TL 70, 12 bits
+    pDev->aScratchpad[0] = (uint8_t)ONE_WIRE_SIM_POWER_ON_T;
+    pDev->aScratchpad[1] = (uint8_t)(ONE_WIRE_SIM_POWER_ON_T >> 8);
+    pDev->aScratchpad[2] = 75U;
+    pDev->aScratchpad[3] = 70U;
+    pDev->aScratchpad[4] = 0x7FU;
+    pDev->aScratchpad[5] = 0xFFU;
+    pDev->aScratchpad[7] = 0x10U;
+    pDev->aScratchpad[8] = ONE_WIRE_SIM_Crc(pDev->aScratchpad, 8U);
+
+    return ONE_WIRE_SIM_nDevices++;
+}
+
+void ONE_WIRE_SIM_Detach(const uint32_t nIndex, const uint32_t nAfterResets)
+{
+    if (0U == nAfterResets)
+    {
+        ONE_WIRE_SIM_aDevice[nIndex].bAttached = FALSE;
+    }
+    else
+    {
+        ONE_WIRE_SIM_aDevice[nIndex].nResetsToDetach = nAfterResets;
+    }
+}
+
+void ONE_WIRE_SIM_SetBusySlots(const uint32_t nIndex, const uint32_t nSlots)
+{
+    ONE_WIRE_SIM_aDevice[nIndex].nBusySlots = nSlots;
+}
+
+uint8_t ONE_WIRE_SIM_Crc(const uint8_t *pData, const uint32_t nLen)
+{
+    uint8_t nCrc = 0U;
+
+    for (uint32_t i = 0U; i < nLen; i++)
+    {
+        uint8_t nByte = pData[i];
+
+        for (uint32_t j = 0U; j < 8U; j++)
+        {
+            uint8_t nMix = (uint8_t)((nCrc ^ nByte) & 0x01U);
+
+            nCrc >>= 1;
+            if (0U != nMix)
+            {
+                nCrc ^= 0x8CU;
+            }
+            nByte >>= 1;
+        }
+    }
+
+    return nCrc;
+}
+
+uint64_t ONE_WIRE_SIM_MakeRom(const uint8_t nFamily, const uint64_t nSerial)
+{
+    uint8_t aRom[8];
+    uint64_t nRom = (uint64_t)nFamily | ((nSerial & 0xFFFFFFFFFFFFULL) << 8);
+
+    for (uint32_t i = 0U; i < 7U; i++)
+    {
+        aRom[i] = (uint8_t)(nRom >> (i * 8U));
+    }
+
+    return nRom | ((uint64_t)ONE_WIRE_SIM_Crc(aRom, 7U) << 56);
+}
+
+void ONE_WIRE_SIM_GetStat(ONE_WIRE_SIM_STAT *const pStat)
+{
+    *pStat = ONE_WIRE_SIM_Stat;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void ONE_WIRE_SIM_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel)
+{
+    if ((ONE_WIRE_GPIO_PORT_CH0 == pPort) && (0U != (nPin & ONE_WIRE_PIN_CH0)))
+    {
+        ONE_WIRE_SIM_nNowUs = HOST_nTimeUs;
+        ONE_WIRE_SIM_Edge(nLevel);
+        ONE_WIRE_SIM_UpdatePin();
+    }
+}
+
+// Edge of the master at ONE_WIRE_SIM_nNowUs, 0 - pulls DQ low, 1 - releases it
+static void ONE_WIRE_SIM_Edge(const uint32_t nLevel)
+{
+    if ((0U == nLevel) && (FALSE == ONE_WIRE_SIM_bMasterLow))
+    {
+        // Falling edge: the devices which send a 0 hold DQ
+        ONE_WIRE_SIM_bMasterLow = TRUE;
+        ONE_WIRE_SIM_nFallUs = ONE_WIRE_SIM_nNowUs;
+
+        for (uint32_t i = 0U; i < ONE_WIRE_SIM_nDevices; i++)
+        {
+            ONE_WIRE_SIM_DEVICE *pDev = &ONE_WIRE_SIM_aDevice[i];
+
+            if ((TRUE == pDev->bAttached) && (0U == ONE_WIRE_SIM_Output(pDev)))
+            {
+                pDev->nHoldUntilUs = ONE_WIRE_SIM_nNowUs + ONE_WIRE_SIM_HOLD_US;
+            }
+        }
+    }
+    else if ((0U != nLevel) && (TRUE == ONE_WIRE_SIM_bMasterLow))
+    {
+        // Rising edge: the length of the pulse is the reset or the bit of the master
+        const uint64_t nLowUs = ONE_WIRE_SIM_nNowUs - ONE_WIRE_SIM_nFallUs;
+
+        ONE_WIRE_SIM_bMasterLow = FALSE;
+
+        if (nLowUs >= ONE_WIRE_SIM_RESET_MIN_US)
+        {
+            ONE_WIRE_SIM_Reset();
+        }
+        else
+        {
+            BOOLEAN bBusy = FALSE;
+
+            if (nLowUs > ONE_WIRE_SIM_SLOT_MAX_US)
+            {
+                ONE_WIRE_SIM_Stat.nViolations++;
+            }
+
+            ONE_WIRE_SIM_Stat.nSlots++;
+            for (uint32_t i = 0U; i < ONE_WIRE_SIM_nDevices; i++)
+            {
+                if ((TRUE == ONE_WIRE_SIM_aDevice[i].bAttached) &&
+                    (ONE_WIRE_SIM_CONVERT == ONE_WIRE_SIM_aDevice[i].state) &&
+                    (ONE_WIRE_SIM_nFallUs < ONE_WIRE_SIM_aDevice[i].nConvertEndUs))
+                {
+                    bBusy = TRUE;
+                }
+            }
+            if (TRUE == bBusy)
+            {
+                ONE_WIRE_SIM_Stat.nBusySlots++;
+            }
+
+            for (uint32_t i = 0U; i < ONE_WIRE_SIM_nDevices; i++)
+            {
+                if (TRUE == ONE_WIRE_SIM_aDevice[i].bAttached)
+                {
+                    ONE_WIRE_SIM_Slot(&ONE_WIRE_SIM_aDevice[i],
+                                      (nLowUs >= ONE_WIRE_SIM_SAMPLE_US) ? 0U : 1U);
+                }
+            }
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+
+}
+
+static void ONE_WIRE_SIM_TimeHook(const uint64_t nTimeUs)
+{
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    ONE_WIRE_SIM_Uart(nTimeUs);
+#endif
+    ONE_WIRE_SIM_nNowUs = nTimeUs;
+    ONE_WIRE_SIM_UpdatePin();
+}
+
+static void ONE_WIRE_SIM_UpdatePin(void)
+{
+    if (TRUE == ONE_WIRE_SIM_IsLow())
+    {
+        ONE_WIRE_GPIO_PORT_CH0->IDR &= ~(uint32_t)ONE_WIRE_PIN_CH0;
+    }
+    else
+    {
+        ONE_WIRE_GPIO_PORT_CH0->IDR |= ONE_WIRE_PIN_CH0;
+    }
+}
+
+// Wired AND of the master, the presence pulse and the devices at ONE_WIRE_SIM_nNowUs
+static BOOLEAN ONE_WIRE_SIM_IsLow(void)
+{
+    BOOLEAN bLow = ONE_WIRE_SIM_bMasterLow;
+
+    if ((ONE_WIRE_SIM_nNowUs >= ONE_WIRE_SIM_nPresenceFromUs) &&
+        (ONE_WIRE_SIM_nNowUs < ONE_WIRE_SIM_nPresenceToUs))
+    {
+        bLow = TRUE;
+    }
+
+    for (uint32_t i = 0U; i < ONE_WIRE_SIM_nDevices; i++)
+    {
+        if ((TRUE == ONE_WIRE_SIM_aDevice[i].bAttached) &&
+            (ONE_WIRE_SIM_nNowUs < ONE_WIRE_SIM_aDevice[i].nHoldUntilUs))
+        {
+            bLow = TRUE;
+        }
+    }
+
+    return bLow;
+}
+
+static void ONE_WIRE_SIM_Reset(void)
+{
+    BOOLEAN bPresence = FALSE;
+
+    ONE_WIRE_SIM_Stat.nResets++;
+
+    for (uint32_t i = 0U; i < ONE_WIRE_SIM_nDevices; i++)
+    {
+        ONE_WIRE_SIM_DEVICE *pDev = &ONE_WIRE_SIM_aDevice[i];
+
+        if ((0U != pDev->nResetsToDetach) && (0U == --pDev->nResetsToDetach))
+        {
+            pDev->bAttached = FALSE;
+        }
+
+        if (TRUE == pDev->bAttached)
+        {
+            ONE_WIRE_SIM_LatchConversion(pDev);
+            pDev->state = ONE_WIRE_SIM_ROM_CMD;
+            pDev->nBit = 0U;
+            pDev->nShift = 0U;
+            pDev->nSearchPhase = 0U;
+            pDev->nHoldUntilUs = 0U;
+            bPresence = TRUE;
+        }
+    }
+
+    if (TRUE == bPresence)
+    {
+        ONE_WIRE_SIM_nPresenceFromUs = ONE_WIRE_SIM_nNowUs + ONE_WIRE_SIM_PRESENCE_DELAY_US;
+        ONE_WIRE_SIM_nPresenceToUs = ONE_WIRE_SIM_nPresenceFromUs + ONE_WIRE_SIM_PRESENCE_US;
+    }
+    else
+    {
+        ONE_WIRE_SIM_nPresenceFromUs = 0U;
+        ONE_WIRE_SIM_nPresenceToUs = 0U;
+    }
+}
+
+// Level which the device puts on DQ in the next slot, 0 - holds DQ low
+static uint8_t ONE_WIRE_SIM_Output(ONE_WIRE_SIM_DEVICE *const pDev)
+{
+    uint8_t nOut = 1U;
+    uint8_t nRomBit = (uint8_t)((pDev->nRom >> (pDev->nBit % ONE_WIRE_SIM_ROM_BITS)) & 1U);
+
+    switch (pDev->state)
+    {
+        case ONE_WIRE_SIM_READ_ROM:
+            nOut = nRomBit;
+            break;
+
+        case ONE_WIRE_SIM_SEARCH_ROM:
+            if (0U == pDev->nSearchPhase)
+            {
+                nOut = nRomBit;
+            }
+            else if (1U == pDev->nSearchPhase)
+            {
+                nOut = (uint8_t)(nRomBit ^ 1U);
+            }
+            else
+            {
+                nOut = 1U;
+            }
+            break;
+
+        case ONE_WIRE_SIM_CONVERT:
+            nOut = (ONE_WIRE_SIM_nNowUs < pDev->nConvertEndUs) ? 0U : 1U;
+            break;
+
+        case ONE_WIRE_SIM_READ_SCRATCHPAD:
+            if (pDev->nBit < ONE_WIRE_SIM_SCRATCHPAD_BITS)
+            {
+                nOut = (uint8_t)((pDev->aScratchpad[pDev->nBit / 8U] >> (pDev->nBit % 8U)) & 1U);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return nOut;
+}
+
+// The device processes the slot, nBit is the bit of the master
+static void ONE_WIRE_SIM_Slot(ONE_WIRE_SIM_DEVICE *const pDev, const uint8_t nBit)
+{
+    uint8_t nByte = 0U;
+    uint8_t nRomBit = (uint8_t)((pDev->nRom >> (pDev->nBit % ONE_WIRE_SIM_ROM_BITS)) & 1U);
+
+    switch (pDev->state)
+    {
+        case ONE_WIRE_SIM_ROM_CMD:
+        case ONE_WIRE_SIM_FUNC_CMD:
+            if (TRUE == ONE_WIRE_SIM_ReceiveByte(pDev, nBit, &nByte))
+            {
+                ONE_WIRE_SIM_Command(pDev, nByte);
+            }
+            break;
+
+        case ONE_WIRE_SIM_READ_ROM:
+        case ONE_WIRE_SIM_MATCH_ROM:
+            if ((ONE_WIRE_SIM_MATCH_ROM == pDev->state) && (nBit != nRomBit))
+            {
+                pDev->state = ONE_WIRE_SIM_IDLE;
+            }
+            else if (++pDev->nBit == ONE_WIRE_SIM_ROM_BITS)
+            {
+                pDev->state = ONE_WIRE_SIM_FUNC_CMD;
+                pDev->nBit = 0U;
+            }
+            break;
+
+        case ONE_WIRE_SIM_SEARCH_ROM:
+            if (2U != pDev->nSearchPhase)
+            {
+                pDev->nSearchPhase++;
+            }
+            else if (nBit != nRomBit)
+            {
+                // The master went the other way
+                pDev->state = ONE_WIRE_SIM_IDLE;
+            }
+            else
+            {
+                pDev->nSearchPhase = 0U;
+                if (++pDev->nBit == ONE_WIRE_SIM_ROM_BITS)
+                {
+                    pDev->state = ONE_WIRE_SIM_FUNC_CMD;
+                    pDev->nBit = 0U;
+                }
+            }
+            break;
+
+        case ONE_WIRE_SIM_CONVERT:
+            // The conversion of the slots ends with the last busy one
+            if ((0U != pDev->nBusyLeft) && (ONE_WIRE_SIM_BUSY_FOREVER != pDev->nBusyLeft) &&
+                (0U == --pDev->nBusyLeft))
+            {
+                pDev->nConvertEndUs = ONE_WIRE_SIM_nNowUs;
+            }
+            break;
+
+        case ONE_WIRE_SIM_READ_SCRATCHPAD:
+            pDev->nBit++;
+            break;
+
+        case ONE_WIRE_SIM_WRITE_SCRATCHPAD:
+            if (TRUE == ONE_WIRE_SIM_ReceiveByte(pDev, nBit, &nByte))
+            {
+                // TH, TL and config are written to the bytes 2..4
+                pDev->aScratchpad[2U + pDev->nBit] = nByte;
+                pDev->aScratchpad[8] = ONE_WIRE_SIM_Crc(pDev->aScratchpad, 8U);
+                if (++pDev->nBit == (ONE_WIRE_SIM_WRITE_BITS / 8U))
+                {
+                    pDev->state = ONE_WIRE_SIM_IDLE;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static BOOLEAN ONE_WIRE_SIM_ReceiveByte(ONE_WIRE_SIM_DEVICE *const pDev, const uint8_t nBit,
+                                        uint8_t *const pByte)
+{
+    BOOLEAN bDone = FALSE;
+
+    // LSB first
+    pDev->nRxByte = (uint8_t)((pDev->nRxByte >> 1) | (nBit << 7));
+
+    if (8U == ++pDev->nShift)
+    {
+        *pByte = pDev->nRxByte;
+        pDev->nShift = 0U;
+        bDone = TRUE;
+    }
+
+    return bDone;
+}
+
+static void ONE_WIRE_SIM_Command(ONE_WIRE_SIM_DEVICE *const pDev, const uint8_t nCmd)
+{
+    pDev->nBit = 0U;
+
+    if (ONE_WIRE_SIM_ROM_CMD == pDev->state)
+    {
+        switch (nCmd)
+        {
+            case ONE_WIRE_SIM_READ_ROM_CMD:
+                pDev->state = ONE_WIRE_SIM_READ_ROM;
+                break;
+            case ONE_WIRE_SIM_MATCH_ROM_CMD:
+                pDev->state = ONE_WIRE_SIM_MATCH_ROM;
+                break;
+            case ONE_WIRE_SIM_SKIP_ROM_CMD:
+                pDev->state = ONE_WIRE_SIM_FUNC_CMD;
+                break;
+            case ONE_WIRE_SIM_SEARCH_ROM_CMD:
+                pDev->state = ONE_WIRE_SIM_SEARCH_ROM;
+                pDev->nSearchPhase = 0U;
+                break;
+            default:
+                pDev->state = ONE_WIRE_SIM_IDLE;
+                break;
+        }
+    }
+    else
+    {
+        switch (nCmd)
+        {
+            case ONE_WIRE_SIM_CONVERT_T_CMD:
+                pDev->state = ONE_WIRE_SIM_CONVERT;
+                pDev->nBusyLeft = pDev->nBusySlots;
+                pDev->nConvertEndUs = (0U != pDev->nBusySlots) ? UINT64_MAX :
+                                      (ONE_WIRE_SIM_nNowUs + ONE_WIRE_SIM_aConversionUs[(pDev->aScratchpad[4] >> 5) & 3U]);
+                ONE_WIRE_SIM_Stat.nConversions++;
+                ONE_WIRE_SIM_Stat.nConvertStartUs = ONE_WIRE_SIM_nNowUs;
+                ONE_WIRE_SIM_Stat.nConvertEndUs = pDev->nConvertEndUs;
+                break;
+            case ONE_WIRE_SIM_READ_SCR_CMD:
+                pDev->state = ONE_WIRE_SIM_READ_SCRATCHPAD;
+                ONE_WIRE_SIM_Stat.nReadUs = ONE_WIRE_SIM_nNowUs;
+                if (0U != pDev->nConvertEndUs)
+                {
+                    ONE_WIRE_SIM_Stat.nEarlyReads++;
+                }
+                break;
+            case ONE_WIRE_SIM_WRITE_SCR_CMD:
+                pDev->state = ONE_WIRE_SIM_WRITE_SCRATCHPAD;
+                break;
+            default:
+                pDev->state = ONE_WIRE_SIM_IDLE;
+                break;
+        }
+    }
+}
+
+// The result of the finished conversion gets to the scratchpad
+static void ONE_WIRE_SIM_LatchConversion(ONE_WIRE_SIM_DEVICE *const pDev)
+{
+    if ((0U != pDev->nConvertEndUs) && (ONE_WIRE_SIM_nNowUs >= pDev->nConvertEndUs))
+    {
+        // Low bits are undefined below 12 bits, the device clears them
+        const uint8_t nClear = (uint8_t)(3U - ((pDev->aScratchpad[4] >> 5) & 3U));
+        const uint16_t nRaw = (uint16_t)pDev->nTemperature & (uint16_t)~((1U << nClear) - 1U);
+
+        pDev->aScratchpad[0] = (uint8_t)nRaw;
+        pDev->aScratchpad[1] = (uint8_t)(nRaw >> 8);
+        pDev->aScratchpad[8] = ONE_WIRE_SIM_Crc(pDev->aScratchpad, 8U);
+        pDev->nConvertEndUs = 0U;
+    }
+}
+
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+// The frames of the DMA transfer which end up to the time
+static void ONE_WIRE_SIM_Uart(const uint64_t nTimeUs)
+{
+    DMA_Channel_TypeDef *const pTx = ONE_WIRE_UART_DMA_TX_CHANNEL;
+    DMA_Channel_TypeDef *const pRx = ONE_WIRE_UART_DMA_RX_CHANNEL;
+    const uint32_t nDmaReq = USART_CR3_DMAT | USART_CR3_DMAR;
+    BOOLEAN bActive = FALSE;
+
+    do
+    {
+        bActive = ((nDmaReq == (ONE_WIRE_UART_NUM->CR3 & nDmaReq)) &&
+                   (0U != (ONE_WIRE_UART_NUM->CR1 & USART_CR1_UE)) &&
+                   (0U != (pTx->CCR & DMA_CCR_EN)) && (0U != (pRx->CCR & DMA_CCR_EN)) &&
+                   (0U != pTx->CNDTR) && (0U != pRx->CNDTR)) ? TRUE : FALSE;
+
+        if (FALSE == bActive)
+        {
+            ONE_WIRE_SIM_bUartBusy = FALSE;
+        }
+        else if (FALSE == ONE_WIRE_SIM_bUartBusy)
+        {
+            // The task started the transfer after the last advance of the time
+            ONE_WIRE_SIM_bUartBusy = TRUE;
+            ONE_WIRE_SIM_nUartQty = pTx->CNDTR;
+            ONE_WIRE_SIM_nUartNextUs = ONE_WIRE_SIM_nUartLastUs;
+        }
+        else if ((ONE_WIRE_SIM_nUartNextUs + ONE_WIRE_SIM_UartTimeUs(2U * ONE_WIRE_SIM_UART_FRAME_BITS)) <= nTimeUs)
+        {
+            const uint32_t nIndex = ONE_WIRE_SIM_nUartQty - pTx->CNDTR;
+            const uint8_t nTx = ((const uint8_t *)(uintptr_t)pTx->CMAR)[nIndex];
+
+            ((uint8_t *)(uintptr_t)pRx->CMAR)[nIndex] = ONE_WIRE_SIM_UartFrame(nTx, ONE_WIRE_SIM_nUartNextUs);
+            ONE_WIRE_SIM_nUartNextUs += ONE_WIRE_SIM_UartTimeUs(2U * ONE_WIRE_SIM_UART_FRAME_BITS);
+            pTx->CNDTR--;
+            pRx->CNDTR--;
+
+            if (0U == pRx->CNDTR)
+            {
+                ONE_WIRE_UART_DMA_RX_IRQHandler();
+            }
+        }
+        else
+        {
+            // The next frame ends later
+            bActive = FALSE;
+        }
+    } while (TRUE == bActive);
+
+    ONE_WIRE_SIM_nUartLastUs = nTimeUs;
+}
+
+// The master sends the frame of the byte on DQ, returns the byte read back
+static uint8_t ONE_WIRE_SIM_UartFrame(const uint8_t nByte, const uint64_t nStartUs)
+{
+    // Start bit 0, stop bit 1
+    const uint32_t nFrame = ((uint32_t)nByte << 1) | (1UL << (ONE_WIRE_SIM_UART_FRAME_BITS - 1U));
+    uint8_t nRx = 0U;
+
+    for (uint32_t nBit = 0U; nBit < ONE_WIRE_SIM_UART_FRAME_BITS; nBit++)
+    {
+        ONE_WIRE_SIM_nNowUs = nStartUs + ONE_WIRE_SIM_UartTimeUs(2U * nBit);
+        ONE_WIRE_SIM_Edge((nFrame >> nBit) & 1U);
+
+        if ((0U != nBit) && (nBit < (ONE_WIRE_SIM_UART_FRAME_BITS - 1U)))
+        {
+            ONE_WIRE_SIM_nNowUs = nStartUs + ONE_WIRE_SIM_UartTimeUs((2U * nBit) + 1U);
+            if (FALSE == ONE_WIRE_SIM_IsLow())
+            {
+                nRx |= (uint8_t)(1U << (nBit - 1U));
+            }
+        }
+    }
+
+    return nRx;
+}
+
+// Time of the half bits of the frame at the baud rate of BRR
+static uint64_t ONE_WIRE_SIM_UartTimeUs(const uint32_t nHalfBits)
+{
+    return ((uint64_t)nHalfBits * ONE_WIRE_UART_NUM->BRR * 1000000U) / (2U * (uint64_t)HAL_RCC_GetPCLK1Freq());
+}
+#endif
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,95 @@
+//**************************************************************************************************
+// @Module        ONE_WIRE_SIM
+// @Filename      onewire_sim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the 1-Wire bus simulator of the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef ONE_WIRE_SIM_H
+#define ONE_WIRE_SIM_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "compiler.h"
+#include "general_types.h"
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+typedef struct ONE_WIRE_SIM_STAT_str
+{
+    uint32_t nResets;           // Quantity of the reset pulses
+    uint32_t nSlots;            // Quantity of the time slots
+    uint32_t nViolations;       // Low pulses longer than a slot and shorter than a reset
+    uint32_t nConversions;      // Quantity of the CONVERT T commands
+    uint64_t nConvertStartUs;   // Last CONVERT T
+    uint64_t nConvertEndUs;     // End of the last conversion
+    uint32_t nBusySlots;        // Slots held low by a converting device
+    uint64_t nReadUs;           // Last READ SCRATCHPAD
+    uint32_t nEarlyReads;       // READ SCRATCHPAD during the conversion
+}ONE_WIRE_SIM_STAT;
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// Max quantity of the devices on the bus
+#define ONE_WIRE_SIM_MAX_DEVICES        (32U)
+
+// Timings of the DS18B20, us
+#define ONE_WIRE_SIM_RESET_MIN_US       (480U)
+#define ONE_WIRE_SIM_SAMPLE_US          (15U)
+#define ONE_WIRE_SIM_SLOT_MAX_US        (120U)
+#define ONE_WIRE_SIM_PRESENCE_DELAY_US  (30U)
+#define ONE_WIRE_SIM_PRESENCE_US        (120U)
+#define ONE_WIRE_SIM_HOLD_US            (30U)
+
+// Busy slots of the conversion which never ends
+#define ONE_WIRE_SIM_BUSY_FOREVER       (0xFFFFFFFFU)
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// Empty bus, the pin of the channel 0 is released
+extern void ONE_WIRE_SIM_Init(void);
+
+// Connect a DS18B20 with the ROM code. The low byte is the family code, the high byte is the crc,
+// it isn't checked, so a device with the wrong crc can be connected. Returns the index.
+extern uint32_t ONE_WIRE_SIM_AddDevice(const uint64_t nRom, const int16_t nTemperature);
+
+// Disconnect the device after the quantity of the reset pulses, 0 - at once
+extern void ONE_WIRE_SIM_Detach(const uint32_t nIndex, const uint32_t nAfterResets);
+
+// The next conversions of the device hold the quantity of the read slots low instead of the
+// conversion time, ONE_WIRE_SIM_BUSY_FOREVER - the conversion never ends, 0 - the conversion time
+extern void ONE_WIRE_SIM_SetBusySlots(const uint32_t nIndex, const uint32_t nSlots);
+
+// CRC of the 1-Wire, x^8 + x^5 + x^4 + 1
+extern uint8_t ONE_WIRE_SIM_Crc(const uint8_t *pData, const uint32_t nLen);
+
+// ROM code of the family and the serial number with the correct crc
+extern uint64_t ONE_WIRE_SIM_MakeRom(const uint8_t nFamily, const uint64_t nSerial);
+
+// Statistics
+extern void ONE_WIRE_SIM_GetStat(ONE_WIRE_SIM_STAT *const pStat);
+
+#endif // #ifndef ONE_WIRE_SIM_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,688 @@
+//**************************************************************************************************
+// @Module        W25Q_SIM
+// @Filename      w25q_sim.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Simulator of the W25Q128 and W25Q256 for the host tests.
+//
+//                The chip is driven at the byte level by the LL SPI functions and the chip
+//                select pin, and at the command level by the HAL QUADSPI functions, so both
+//                backends of the driver run against the same chip. The simulator counts the
+//                clocks of the bus and the protocol errors: an instruction while the chip is
+//                busy or in deep power-down, a program or erase without the write enable and
+//                a transaction without the mutex of the driver after the scheduler start.
+//                The chip keeps its state over W25Q_Init() as over the reset of the MCU: the
+//                W25Q256 stays in 4-byte addressing until W25Q_SIM_InitPart().
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "w25q_sim.h"
+
+#include "stm32l4xx_ll_spi.h"
+#include "W25Q_drv_cfg.h"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+typedef struct W25Q_SIM_TRANSACTION_str
+{
+    BOOLEAN  bActive;
+    uint32_t nIndex;            // Index of the byte in the transaction
+    uint8_t  nCmd;
+    uint32_t nAdrBytes;
+    uint32_t nDummyBytes;
+    uint32_t nAddress;
+    uint32_t nDataIndex;
+    BOOLEAN  bIgnored;          // Instruction is ignored by the chip
+    uint8_t  aPage[256];        // Page buffer of the program
+    uint32_t nPageBytes;
+}W25Q_SIM_TRANSACTION;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#define W25Q_SIM_SR1_BUSY           (0x01U)
+#define W25Q_SIM_SR1_WEL            (0x02U)
+#define W25Q_SIM_SR2_QE             (0x02U)
+#define W25Q_SIM_SR3_ADS            (0x01U)
+
+#define W25Q_SIM_PAGE_BYTES         (256U)
+#define W25Q_SIM_SFDP_BYTES         (0xC0U)
+#define W25Q_SIM_SFDP_BFPT_ADR      (0x80U)
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// Memory-mapped window of the QUADSPI
+uint8_t *HOST_pQspiMapped = NULL;
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static uint8_t W25Q_SIM_aMem[W25Q_SIM_MAX_CAPACITY_BYTES];
+static uint32_t W25Q_SIM_nCapacity = W25Q_SIM_CAPACITY_BYTES;
+static uint8_t W25Q_SIM_aSfdp[W25Q_SIM_SFDP_BYTES];
+static W25Q_SIM_TRANSACTION W25Q_SIM_Tr;
+static W25Q_SIM_STAT W25Q_SIM_Stat;
+static uint8_t W25Q_SIM_nSR1 = 0U;
+static uint8_t W25Q_SIM_nSR2 = 0U;
+static uint8_t W25Q_SIM_nSR3 = 0U;
+static BOOLEAN W25Q_SIM_bSrWriteEn = FALSE;
+static BOOLEAN W25Q_SIM_bPoweredDown = FALSE;
+static BOOLEAN W25Q_SIM_b4ByteMode = FALSE;
+static BOOLEAN W25Q_SIM_bIgnore4ByteMode = FALSE;
+static uint32_t W25Q_SIM_nSfdpFails = 0U;
+static uint64_t W25Q_SIM_nBusyUntilUs = 0U;
+static uint8_t W25Q_SIM_nRxByte = 0U;
+
+// Pending QUADSPI data phase
+static uint32_t W25Q_SIM_nQspiDataLines = 1U;
+static uint32_t W25Q_SIM_nQspiDataBytes = 0U;
+
+static const uint8_t W25Q_SIM_aUniqueId[8] = {0xD2, 0x64, 0x38, 0x4C, 0x1B, 0x27, 0x35, 0x2A};
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void W25Q_SIM_SetDword(const uint32_t nAdr, const uint32_t nValue);
+static BOOLEAN W25Q_SIM_IsBusy(void);
+static void W25Q_SIM_Begin(void);
+static void W25Q_SIM_End(void);
+static uint8_t W25Q_SIM_Byte(const uint8_t nIn);
+static void W25Q_SIM_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel);
+static uint32_t W25Q_SIM_QspiLines(const uint32_t nMode);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+void W25Q_SIM_Init(void)
+{
+    W25Q_SIM_InitPart(W25Q_SIM_CAPACITY_BYTES);
+}
+
+void W25Q_SIM_InitPart(const uint32_t nCapacityBytes)
+{
+    const BOOLEAN bLarge = (W25Q_SIM_CAPACITY_BYTES < nCapacityBytes) ? TRUE : FALSE;
+
+    W25Q_SIM_nCapacity = (W25Q_SIM_MAX_CAPACITY_BYTES < nCapacityBytes) ? W25Q_SIM_MAX_CAPACITY_BYTES :
+                                                                           nCapacityBytes;
+    memset(W25Q_SIM_aMem, 0xFF, W25Q_SIM_nCapacity);
+    memset(&W25Q_SIM_Tr, 0, sizeof(W25Q_SIM_Tr));
+    memset(&W25Q_SIM_Stat, 0, sizeof(W25Q_SIM_Stat));
+    W25Q_SIM_nSR1 = 0U;
+    W25Q_SIM_nSR2 = 0U;
+    W25Q_SIM_nSR3 = 0U;
+    W25Q_SIM_bSrWriteEn = FALSE;
+    W25Q_SIM_bPoweredDown = FALSE;
+    W25Q_SIM_b4ByteMode = FALSE;
+    W25Q_SIM_bIgnore4ByteMode = FALSE;
+    W25Q_SIM_nSfdpFails = 0U;
+    W25Q_SIM_nBusyUntilUs = 0U;
+
+    // SFDP of the W25Q128JV or of the W25Q256JV: header, BFPT parameter header, 11 DWORDs
+    // of the BFPT. The W25Q256JV supports 3-byte and 4-byte addressing (DWORD1 bits 17-18).
+    memset(W25Q_SIM_aSfdp, 0xFF, sizeof(W25Q_SIM_aSfdp));
+    W25Q_SIM_SetDword(0x00U, 0x50444653UL);
+    W25Q_SIM_SetDword(0x04U, 0xFF000106UL);
+    W25Q_SIM_SetDword(0x08U, 0x0B010600UL);
+    W25Q_SIM_SetDword(0x0CU, 0xFF000000UL | W25Q_SIM_SFDP_BFPT_ADR);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x00U, (TRUE == bLarge) ? 0xFFFB20E5UL : 0xFFF920E5UL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x04U, (W25Q_SIM_nCapacity * 8UL) - 1UL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x08U, 0x6B08EB44UL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x0CU, 0xBB423B08UL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x10U, 0xFFFFFFFEUL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x14U, 0x0000FFFFUL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x18U, 0xEB40FFFFUL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x1CU, 0x520F200CUL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x20U, 0x0000D810UL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x24U, 0x00A60236UL);
+    W25Q_SIM_SetDword(W25Q_SIM_SFDP_BFPT_ADR + 0x28U, 0xEA14C981UL);
+
+    HOST_pQspiMapped = W25Q_SIM_aMem;
+    HOST_pGpioHook = W25Q_SIM_GpioHook;
+    W25Q_SPI_CS_PORT->ODR |= W25Q_SPI_CS_PIN;
+}
+
+uint8_t* W25Q_SIM_GetMemory(void)
+{
+    return W25Q_SIM_aMem;
+}
+
+void W25Q_SIM_GetStat(W25Q_SIM_STAT *const pStat)
+{
+    *pStat = W25Q_SIM_Stat;
+}
+
+void W25Q_SIM_ResetStat(void)
+{
+    memset(&W25Q_SIM_Stat, 0, sizeof(W25Q_SIM_Stat));
+}
+
+BOOLEAN W25Q_SIM_IsPoweredDown(void)
+{
+    return W25Q_SIM_bPoweredDown;
+}
+
+void W25Q_SIM_FailSfdp(const uint32_t nQtyReads)
+{
+    W25Q_SIM_nSfdpFails = nQtyReads;
+}
+
+void W25Q_SIM_Ignore4ByteMode(const BOOLEAN bIgnore)
+{
+    W25Q_SIM_bIgnore4ByteMode = bIgnore;
+}
+
+BOOLEAN W25Q_SIM_Is4ByteMode(void)
+{
+    return W25Q_SIM_b4ByteMode;
+}
+
+
+//**************************************************************************************************
+// SPI and QUADSPI of the MCU
+//**************************************************************************************************
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+
+    return HAL_OK;
+}
+
+void LL_SPI_Enable(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+}
+
+uint32_t LL_SPI_IsActiveFlag_TXE(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+
+    return 1U;
+}
+
+uint32_t LL_SPI_IsActiveFlag_RXNE(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+
+    return 1U;
+}
+
+uint32_t LL_SPI_IsActiveFlag_BSY(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+
+    return 0U;
+}
+
+void LL_SPI_TransmitData8(SPI_TypeDef *SPIx, uint8_t TxData)
+{
+    (void)SPIx;
+
+    W25Q_SIM_Stat.nBusClocks += 8U;
+    if (TRUE == W25Q_SIM_Tr.bActive)
+    {
+        W25Q_SIM_nRxByte = W25Q_SIM_Byte(TxData);
+    }
+    else
+    {
+        // Clocks without the chip select
+        W25Q_SIM_Stat.nViolations++;
+        W25Q_SIM_nRxByte = 0U;
+    }
+}
+
+uint8_t LL_SPI_ReceiveData8(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+
+    return W25Q_SIM_nRxByte;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Init(QSPI_HandleTypeDef *hqspi)
+{
+    (void)hqspi;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+                                   uint32_t Timeout)
+{
+    const uint32_t nAdrBytes = (QSPI_ADDRESS_NONE != cmd->AddressMode) ? (cmd->AddressSize + 1U) : 0U;
+
+    (void)hqspi;
+    (void)Timeout;
+
+    W25Q_SIM_Begin();
+
+    if (QSPI_INSTRUCTION_NONE != cmd->InstructionMode)
+    {
+        W25Q_SIM_Stat.nBusClocks += 8U / W25Q_SIM_QspiLines(cmd->InstructionMode);
+        (void)W25Q_SIM_Byte((uint8_t)cmd->Instruction);
+    }
+    for (uint32_t i = 0U; i < nAdrBytes; i++)
+    {
+        W25Q_SIM_Stat.nBusClocks += 8U / W25Q_SIM_QspiLines(cmd->AddressMode);
+        (void)W25Q_SIM_Byte((uint8_t)(cmd->Address >> (8U * (nAdrBytes - 1U - i))));
+    }
+    W25Q_SIM_Stat.nBusClocks += cmd->DummyCycles;
+    for (uint32_t i = 0U; i < (cmd->DummyCycles / 8U); i++)
+    {
+        (void)W25Q_SIM_Byte(0xFFU);
+    }
+
+    // The quad output read needs the QE bit
+    if ((QSPI_DATA_4_LINES == cmd->DataMode) && (0U == (W25Q_SIM_nSR2 & W25Q_SIM_SR2_QE)))
+    {
+        W25Q_SIM_Stat.nViolations++;
+    }
+
+    if (QSPI_DATA_NONE == cmd->DataMode)
+    {
+        W25Q_SIM_End();
+    }
+    else
+    {
+        W25Q_SIM_nQspiDataLines = W25Q_SIM_QspiLines(cmd->DataMode);
+        W25Q_SIM_nQspiDataBytes = cmd->NbData;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Transmit(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout)
+{
+    const uint32_t nQty = W25Q_SIM_nQspiDataBytes;
+
+    (void)hqspi;
+    (void)Timeout;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        (void)W25Q_SIM_Byte(pData[i]);
+    }
+    W25Q_SIM_Stat.nBusClocks += ((uint64_t)nQty * 8U) / W25Q_SIM_nQspiDataLines;
+    W25Q_SIM_End();
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Receive(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout)
+{
+    const uint32_t nQty = W25Q_SIM_nQspiDataBytes;
+
+    (void)hqspi;
+    (void)Timeout;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        pData[i] = W25Q_SIM_Byte(0xFFU);
+    }
+    W25Q_SIM_Stat.nBusClocks += ((uint64_t)nQty * 8U) / W25Q_SIM_nQspiDataLines;
+    W25Q_SIM_End();
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_MemoryMapped(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+                                        QSPI_MemoryMappedTypeDef *cfg)
+{
+    (void)hqspi;
+    (void)cfg;
+
+    // The reads of the window are not clocked by the simulator
+    W25Q_SIM_Begin();
+    (void)W25Q_SIM_Byte((uint8_t)cmd->Instruction);
+    W25Q_SIM_End();
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Abort(QSPI_HandleTypeDef *hqspi)
+{
+    (void)hqspi;
+
+    return HAL_OK;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void W25Q_SIM_SetDword(const uint32_t nAdr, const uint32_t nValue)
+{
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        W25Q_SIM_aSfdp[nAdr + i] = (uint8_t)(nValue >> (8U * i));
+    }
+}
+
+static BOOLEAN W25Q_SIM_IsBusy(void)
+{
+    return (HOST_nTimeUs < W25Q_SIM_nBusyUntilUs) ? TRUE : FALSE;
+}
+
+static void W25Q_SIM_Begin(void)
+{
+    memset(&W25Q_SIM_Tr, 0, sizeof(W25Q_SIM_Tr));
+    W25Q_SIM_Tr.bActive = TRUE;
+    W25Q_SIM_Stat.nTransactions++;
+
+    if ((taskSCHEDULER_NOT_STARTED != HOST_nSchedulerState) && (0U == HOST_GetRecursiveDepth()))
+    {
+        W25Q_SIM_Stat.nUnlocked++;
+    }
+}
+
+static void W25Q_SIM_End(void)
+{
+    uint32_t nSize = 0U;
+    uint64_t nBusyUs = 0U;
+    const uint8_t nCmd = W25Q_SIM_Tr.nCmd;
+    const BOOLEAN bWel = (0U != (W25Q_SIM_nSR1 & W25Q_SIM_SR1_WEL)) ? TRUE : FALSE;
+
+    W25Q_SIM_Tr.bActive = FALSE;
+
+    if ((0U == W25Q_SIM_Tr.nIndex) || (TRUE == W25Q_SIM_Tr.bIgnored))
+    {
+        return;
+    }
+
+    switch (nCmd)
+    {
+        case 0x06U: W25Q_SIM_nSR1 |= W25Q_SIM_SR1_WEL; break;
+        case 0x04U: W25Q_SIM_nSR1 &= (uint8_t)~W25Q_SIM_SR1_WEL; break;
+        case 0x50U: W25Q_SIM_bSrWriteEn = TRUE; break;
+        case 0xB9U:
+            W25Q_SIM_bPoweredDown = TRUE;
+            W25Q_SIM_Stat.nPowerDownCnt++;
+            break;
+        case 0xABU: W25Q_SIM_bPoweredDown = FALSE; break;
+        case 0xB7U:
+            if ((W25Q_SIM_CAPACITY_BYTES < W25Q_SIM_nCapacity) && (FALSE == W25Q_SIM_bIgnore4ByteMode))
+            {
+                W25Q_SIM_b4ByteMode = TRUE;
+            }
+            break;
+        case 0x5AU:
+            if (0U != W25Q_SIM_nSfdpFails)
+            {
+                W25Q_SIM_nSfdpFails--;
+            }
+            break;
+        case 0x98U: W25Q_SIM_nSR1 &= (uint8_t)~W25Q_SIM_SR1_WEL; break;
+        case 0x01U:
+        case 0x31U:
+        case 0x11U:
+            if ((TRUE == bWel) || (TRUE == W25Q_SIM_bSrWriteEn))
+            {
+                if (0U != W25Q_SIM_Tr.nPageBytes)
+                {
+                    if (0x01U == nCmd)
+                    {
+                        W25Q_SIM_nSR1 = (uint8_t)((W25Q_SIM_nSR1 & 0x03U) | (W25Q_SIM_Tr.aPage[0] & 0xFCU));
+                    }
+                    else if (0x31U == nCmd)
+                    {
+                        W25Q_SIM_nSR2 = W25Q_SIM_Tr.aPage[0];
+                    }
+                    else
+                    {
+                        W25Q_SIM_nSR3 = W25Q_SIM_Tr.aPage[0];
+                    }
+                }
+            }
+            else
+            {
+                W25Q_SIM_Stat.nViolations++;
+            }
+            W25Q_SIM_bSrWriteEn = FALSE;
+            W25Q_SIM_nSR1 &= (uint8_t)~W25Q_SIM_SR1_WEL;
+            break;
+        case 0x02U:
+            if (TRUE == bWel)
+            {
+                // The address wraps inside of the page, the program clears bits only
+                for (uint32_t i = 0U; i < W25Q_SIM_Tr.nPageBytes; i++)
+                {
+                    const uint32_t nAdr = (W25Q_SIM_Tr.nAddress & ~(W25Q_SIM_PAGE_BYTES - 1U)) |
+                                          ((W25Q_SIM_Tr.nAddress + i) & (W25Q_SIM_PAGE_BYTES - 1U));
+                    W25Q_SIM_aMem[nAdr % W25Q_SIM_nCapacity] &= W25Q_SIM_Tr.aPage[i];
+                }
+                nBusyUs = W25Q_SIM_PAGE_PROGRAM_US;
+            }
+            else
+            {
+                W25Q_SIM_Stat.nViolations++;
+            }
+            W25Q_SIM_nSR1 &= (uint8_t)~W25Q_SIM_SR1_WEL;
+            break;
+        case 0x20U:
+        case 0x52U:
+        case 0xD8U:
+        case 0xC7U:
+            if (TRUE == bWel)
+            {
+                switch (nCmd)
+                {
+                    case 0x20U: nSize = 4096U;    nBusyUs = W25Q_SIM_ERASE_4K_US; break;
+                    case 0x52U: nSize = 32768U;   nBusyUs = W25Q_SIM_ERASE_32K_US; break;
+                    case 0xD8U: nSize = 65536U;   nBusyUs = W25Q_SIM_ERASE_64K_US; break;
+                    default:    nSize = W25Q_SIM_nCapacity; nBusyUs = W25Q_SIM_ERASE_CHIP_US; break;
+                }
+                memset(&W25Q_SIM_aMem[(W25Q_SIM_Tr.nAddress % W25Q_SIM_nCapacity) & ~(nSize - 1U)],
+                       0xFF, nSize);
+            }
+            else
+            {
+                W25Q_SIM_Stat.nViolations++;
+            }
+            W25Q_SIM_nSR1 &= (uint8_t)~W25Q_SIM_SR1_WEL;
+            break;
+        default:
+            break;
+    }
+
+    if (0U != nBusyUs)
+    {
+        W25Q_SIM_nBusyUntilUs = HOST_nTimeUs + nBusyUs;
+    }
+}
+
+static uint8_t W25Q_SIM_Byte(const uint8_t nIn)
+{
+    // MISO is pulled down while the chip doesn't drive it
+    uint8_t nOut = 0x00U;
+    const uint32_t nIndex = W25Q_SIM_Tr.nIndex++;
+
+    if (0U == nIndex)
+    {
+        W25Q_SIM_Tr.nCmd = nIn;
+        W25Q_SIM_Stat.aCmdCnt[nIn]++;
+
+        switch (nIn)
+        {
+            case 0x03U:
+            case 0x02U:
+            case 0x20U:
+            case 0x52U:
+            case 0xD8U:
+            case 0x3DU:
+                W25Q_SIM_Tr.nAdrBytes = (TRUE == W25Q_SIM_b4ByteMode) ? 4U : 3U;
+                break;
+            case 0x0BU:
+            case 0x6BU:
+                W25Q_SIM_Tr.nAdrBytes = (TRUE == W25Q_SIM_b4ByteMode) ? 4U : 3U;
+                W25Q_SIM_Tr.nDummyBytes = 1U;
+                break;
+            case 0x5AU:
+                W25Q_SIM_Tr.nAdrBytes = 3U;
+                W25Q_SIM_Tr.nDummyBytes = 1U;
+                break;
+            case 0x90U:
+                W25Q_SIM_Tr.nAdrBytes = 3U;
+                break;
+            case 0x4BU:
+                W25Q_SIM_Tr.nDummyBytes = 4U;
+                break;
+            default:
+                break;
+        }
+
+        // Only the release is accepted in deep power-down, only the status while busy
+        if ((TRUE == W25Q_SIM_bPoweredDown) && (0xABU != nIn))
+        {
+            W25Q_SIM_Stat.nViolations++;
+            W25Q_SIM_Tr.bIgnored = TRUE;
+        }
+        else if ((TRUE == W25Q_SIM_IsBusy()) &&
+                 (0x05U != nIn) && (0x35U != nIn) && (0x15U != nIn))
+        {
+            W25Q_SIM_Stat.nViolations++;
+            W25Q_SIM_Tr.bIgnored = TRUE;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else if (TRUE == W25Q_SIM_Tr.bIgnored)
+    {
+        DoNothing();
+    }
+    else if (nIndex <= W25Q_SIM_Tr.nAdrBytes)
+    {
+        W25Q_SIM_Tr.nAddress = (W25Q_SIM_Tr.nAddress << 8U) | nIn;
+    }
+    else if (nIndex <= (W25Q_SIM_Tr.nAdrBytes + W25Q_SIM_Tr.nDummyBytes))
+    {
+        DoNothing();
+    }
+    else
+    {
+        const uint32_t nData = W25Q_SIM_Tr.nDataIndex++;
+
+        W25Q_SIM_Stat.nDataBytes++;
+
+        switch (W25Q_SIM_Tr.nCmd)
+        {
+            case 0x03U:
+            case 0x0BU:
+            case 0x6BU:
+                nOut = W25Q_SIM_aMem[(W25Q_SIM_Tr.nAddress + nData) % W25Q_SIM_nCapacity];
+                break;
+            case 0x05U:
+                nOut = W25Q_SIM_nSR1 | ((TRUE == W25Q_SIM_IsBusy()) ? W25Q_SIM_SR1_BUSY : 0U);
+                break;
+            case 0x35U: nOut = W25Q_SIM_nSR2; break;
+            case 0x15U:
+                nOut = W25Q_SIM_nSR3 | ((TRUE == W25Q_SIM_b4ByteMode) ? W25Q_SIM_SR3_ADS : 0U);
+                break;
+            case 0x9FU:
+                nOut = (0U == nData) ? 0xEFU : ((1U == nData) ? 0x40U :
+                       ((W25Q_SIM_CAPACITY_BYTES < W25Q_SIM_nCapacity) ? 0x19U : 0x18U));
+                break;
+            case 0x90U:
+                nOut = (0U == (nData & 1U)) ? 0xEFU : 0x17U;
+                break;
+            case 0x4BU:
+                nOut = W25Q_SIM_aUniqueId[nData % sizeof(W25Q_SIM_aUniqueId)];
+                break;
+            case 0x5AU:
+                nOut = (((W25Q_SIM_Tr.nAddress + nData) < W25Q_SIM_SFDP_BYTES) && (0U == W25Q_SIM_nSfdpFails)) ?
+                        W25Q_SIM_aSfdp[W25Q_SIM_Tr.nAddress + nData] : 0xFFU;
+                break;
+            case 0x3DU:
+                nOut = 0x00U;
+                break;
+            case 0x02U:
+            case 0x01U:
+            case 0x31U:
+            case 0x11U:
+                // The last 256 bytes are programmed
+                W25Q_SIM_Tr.aPage[nData % W25Q_SIM_PAGE_BYTES] = nIn;
+                if (W25Q_SIM_Tr.nPageBytes < W25Q_SIM_PAGE_BYTES)
+                {
+                    W25Q_SIM_Tr.nPageBytes++;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return nOut;
+}
+
+static void W25Q_SIM_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel)
+{
+    if ((W25Q_SPI_CS_PORT == pPort) && (0U != (nPin & W25Q_SPI_CS_PIN)))
+    {
+        if ((0U == nLevel) && (FALSE == W25Q_SIM_Tr.bActive))
+        {
+            W25Q_SIM_Begin();
+        }
+        else if ((0U != nLevel) && (TRUE == W25Q_SIM_Tr.bActive))
+        {
+            W25Q_SIM_End();
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+}
+
+static uint32_t W25Q_SIM_QspiLines(const uint32_t nMode)
+{
+    uint32_t nLines = 1U;
+
+    switch (nMode)
+    {
+        case QSPI_DATA_2_LINES: nLines = 2U; break;
+        case QSPI_DATA_4_LINES: nLines = 4U; break;
+        default:                nLines = 1U; break;
+    }
+
+    return nLines;
+}
+
+//****************************************** end of file *******************************************
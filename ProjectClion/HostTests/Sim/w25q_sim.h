@@ -0,0 +1,92 @@
+//**************************************************************************************************
+// @Module        W25Q_SIM
+// @Filename      w25q_sim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the W25Q128 and W25Q256 simulator of the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef W25Q_SIM_H
+#define W25Q_SIM_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "compiler.h"
+#include "general_types.h"
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+typedef struct W25Q_SIM_STAT_str
+{
+    uint32_t nTransactions;     // Quantity of the chip select cycles
+    uint64_t nBusClocks;        // Clocks of the bus, instruction, address, dummy and data
+    uint64_t nDataBytes;        // Bytes of the data phases
+    uint32_t nViolations;       // Protocol errors: access while busy or powered down, no WEL
+    uint32_t nUnlocked;         // Transactions without the mutex of the driver
+    uint32_t nPowerDownCnt;     // Quantity of the deep power-down entries
+    uint32_t aCmdCnt[256];      // Quantity of the instructions
+}W25Q_SIM_STAT;
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// Capacity of the simulated chip, bytes: W25Q128JV by default, W25Q256JV is the largest one
+#define W25Q_SIM_CAPACITY_BYTES         (16777216UL)
+#define W25Q_SIM_MAX_CAPACITY_BYTES     (33554432UL)
+
+// Typical times of the W25Q128JV, us
+#define W25Q_SIM_PAGE_PROGRAM_US        (700UL)
+#define W25Q_SIM_ERASE_4K_US            (45000UL)
+#define W25Q_SIM_ERASE_32K_US           (120000UL)
+#define W25Q_SIM_ERASE_64K_US           (150000UL)
+#define W25Q_SIM_ERASE_CHIP_US          (40000000UL)
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// Reset the chip: erased memory, no power-down, 3-byte addressing
+extern void W25Q_SIM_Init(void);
+
+// Reset the chip of the capacity, up to W25Q_SIM_MAX_CAPACITY_BYTES
+extern void W25Q_SIM_InitPart(const uint32_t nCapacityBytes);
+
+// The next reads of the SFDP table return the blank bytes (glitch of the bus)
+extern void W25Q_SIM_FailSfdp(const uint32_t nQtyReads);
+
+// The chip ignores the Enter 4-Byte Address Mode instruction
+extern void W25Q_SIM_Ignore4ByteMode(const BOOLEAN bIgnore);
+
+// TRUE if the chip is in 4-byte addressing
+extern BOOLEAN W25Q_SIM_Is4ByteMode(void);
+
+// Raw memory of the chip
+extern uint8_t* W25Q_SIM_GetMemory(void);
+
+// Statistics
+extern void W25Q_SIM_GetStat(W25Q_SIM_STAT *const pStat);
+extern void W25Q_SIM_ResetStat(void);
+
+// TRUE if the chip is in deep power-down
+extern BOOLEAN W25Q_SIM_IsPoweredDown(void);
+
+#endif // #ifndef W25Q_SIM_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,45 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      FreeRTOS.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the FreeRTOS kernel header for the host tests.
+//                Time is virtual, see host_stubs.h.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t      TickType_t;
+typedef long          BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint16_t      configSTACK_DEPTH_TYPE;
+
+#define pdTRUE                      (1)
+#define pdFALSE                     (0)
+#define pdPASS                      (1)
+#define pdFAIL                      (0)
+#define portMAX_DELAY               (0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS          (1U)
+#define portTICK_RATE_MS            portTICK_PERIOD_MS
+#define pdMS_TO_TICKS(x)            ((TickType_t)(x))
+#define configASSERT(x)             do { if (!(x)) { HOST_Assert(__FILE__, __LINE__); } } while (0)
+#define portYIELD_FROM_ISR(x)       ((void)(x))
+#define configMAX_PRIORITIES        (7)
+#define configMINIMAL_STACK_SIZE    (128U)
+
+extern void HOST_Assert(const char *pFile, int nLine);
+
+#endif // #ifndef HOST_FREERTOS_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,25 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      SEGGER_RTT.h
+//--------------------------------------------------------------------------------------------------
+// @Description   RTT output of the host tests goes to stdout.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_SEGGER_RTT_H
+#define HOST_SEGGER_RTT_H
+
+#include <stdio.h>
+
+#define SEGGER_RTT_printf(BufferIndex, ...)     ((void)(BufferIndex), printf(__VA_ARGS__))
+
+#endif // #ifndef HOST_SEGGER_RTT_H
+
+//****************************************** end of file *******************************************
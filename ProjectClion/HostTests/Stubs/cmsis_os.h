@@ -0,0 +1,27 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      cmsis_os.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the CMSIS-RTOS header for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_CMSIS_OS_H
+#define HOST_CMSIS_OS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+typedef TaskHandle_t xTaskHandle;
+
+#endif // #ifndef HOST_CMSIS_OS_H
+
+//****************************************** end of file *******************************************
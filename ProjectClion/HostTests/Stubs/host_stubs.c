@@ -0,0 +1,675 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      host_stubs.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Host environment of the host tests.
+//
+//                The tests run in one thread. The time is virtual: it advances only by the
+//                delays and by the waits of the tested code, the simulators of the devices
+//                run from HOST_pTimeHook. A mutex which is already taken can't be taken
+//                again (the target would block), such takes are counted as contention.
+//
+//                One task can run in its own context (ucontext) on the static stack: the test
+//                switches to it by vTaskResume(), the task switches back by vTaskSuspend().
+//                The stack is filled by the pattern to measure its use. The stack is static,
+//                so its addresses fit the 32-bit registers of the DMA in the not PIE tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "host_stubs.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include "stm32l4xx_ll_gpio.h"
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+struct HOST_MUTEX_str
+{
+    uint32_t nDepth;
+    uint32_t nTakes;
+    uint32_t bRecursive;
+};
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Max quantity of the mutexes
+#define HOST_QTY_MUTEXES                (16U)
+
+// Pattern of the not used stack of the task
+#define HOST_STACK_FILL                 (0xA5U)
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+uint32_t HOST_nChecks = 0U;
+uint32_t HOST_nFailures = 0U;
+uint64_t HOST_nTimeUs = 0U;
+BaseType_t HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+uint32_t HOST_nCriticalDepth = 0U;
+uint32_t HOST_nDelayInCritical = 0U;
+HOST_TIME_HOOK HOST_pTimeHook = NULL;
+HOST_GPIO_HOOK HOST_pGpioHook = NULL;
+HOST_PERIPH HOST_aPeriph[HOST_QTY_PERIPH];
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static struct HOST_MUTEX_str HOST_aMutex[HOST_QTY_MUTEXES];
+static uint32_t HOST_nQtyMutexes = 0U;
+static uint32_t HOST_nMutexContention = 0U;
+static uint32_t HOST_nNotify = 0U;
+static int HOST_nTaskHandle = 0;
+static ucontext_t HOST_stMainContext;
+static ucontext_t HOST_stTaskContext;
+static uint8_t HOST_aTaskStack[HOST_SIZE_TASK_STACK] __attribute__((aligned(16)));
+static TaskFunction_t HOST_pTask = NULL;
+static void *HOST_pTaskParameters = NULL;
+static uint32_t HOST_bTaskCreated = 0U;
+static uint32_t HOST_bInTask = 0U;
+static ucontext_t HOST_stIsrContext;
+static uint8_t HOST_aIsrStack[HOST_SIZE_ISR_STACK] __attribute__((aligned(16)));
+static uint32_t HOST_bIsrCreated = 0U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void HOST_TaskEntry(void);
+static void HOST_IsrEntry(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+void HOST_Assert(const char *pFile, int nLine)
+{
+    printf("%s:%d: configASSERT failed\n", pFile, nLine);
+    exit(2);
+}
+
+void HOST_AdvanceUs(const uint64_t nUs)
+{
+    if (0U != HOST_nCriticalDepth)
+    {
+        HOST_nDelayInCritical++;
+    }
+
+    HOST_nTimeUs += nUs;
+
+    if (NULL == HOST_pTimeHook)
+    {
+        // No simulators
+    }
+    else if (0U != HOST_bInTask)
+    {
+        // The interrupts of the target don't use the stack of the task
+        if (0U == HOST_bIsrCreated)
+        {
+            (void)getcontext(&HOST_stIsrContext);
+            HOST_stIsrContext.uc_stack.ss_sp = HOST_aIsrStack;
+            HOST_stIsrContext.uc_stack.ss_size = sizeof(HOST_aIsrStack);
+            HOST_stIsrContext.uc_link = NULL;
+            makecontext(&HOST_stIsrContext, HOST_IsrEntry, 0);
+            HOST_bIsrCreated = 1U;
+        }
+        (void)swapcontext(&HOST_stTaskContext, &HOST_stIsrContext);
+    }
+    else
+    {
+        HOST_pTimeHook(HOST_nTimeUs);
+    }
+}
+
+uint32_t HOST_GetRecursiveDepth(void)
+{
+    uint32_t nDepth = 0U;
+
+    for (uint32_t i = 0U; i < HOST_nQtyMutexes; i++)
+    {
+        if (0U != HOST_aMutex[i].bRecursive)
+        {
+            nDepth += HOST_aMutex[i].nDepth;
+        }
+    }
+
+    return nDepth;
+}
+
+uint32_t HOST_GetRecursiveTakes(void)
+{
+    uint32_t nTakes = 0U;
+
+    for (uint32_t i = 0U; i < HOST_nQtyMutexes; i++)
+    {
+        if (0U != HOST_aMutex[i].bRecursive)
+        {
+            nTakes += HOST_aMutex[i].nTakes;
+        }
+    }
+
+    return nTakes;
+}
+
+uint32_t HOST_GetMutexContention(void)
+{
+    return HOST_nMutexContention;
+}
+
+void HOST_TaskCreate(TaskFunction_t pTask, void *pParameters)
+{
+    memset(HOST_aTaskStack, HOST_STACK_FILL, sizeof(HOST_aTaskStack));
+    HOST_pTask = pTask;
+    HOST_pTaskParameters = pParameters;
+
+    (void)getcontext(&HOST_stTaskContext);
+    HOST_stTaskContext.uc_stack.ss_sp = HOST_aTaskStack;
+    HOST_stTaskContext.uc_stack.ss_size = sizeof(HOST_aTaskStack);
+    HOST_stTaskContext.uc_link = NULL;
+    makecontext(&HOST_stTaskContext, HOST_TaskEntry, 0);
+
+    HOST_bTaskCreated = 1U;
+}
+
+void HOST_TaskKill(void)
+{
+    if (0U != HOST_bInTask)
+    {
+        HOST_bTaskCreated = 0U;
+        HOST_bInTask = 0U;
+        HOST_nCriticalDepth = 0U;
+        (void)setcontext(&HOST_stMainContext);
+    }
+}
+
+uint32_t HOST_TaskGetStackUsed(void)
+{
+    uint32_t nFree = 0U;
+
+    // The stack grows down, the bottom is used last
+    while ((nFree < sizeof(HOST_aTaskStack)) && (HOST_STACK_FILL == HOST_aTaskStack[nFree]))
+    {
+        nFree++;
+    }
+
+    return (uint32_t)sizeof(HOST_aTaskStack) - nFree;
+}
+
+int HOST_Result(const char *const pName)
+{
+    printf("%s: %lu checks, %lu failed\n",
+           pName, (unsigned long)HOST_nChecks, (unsigned long)HOST_nFailures);
+
+    return (0U == HOST_nFailures) ? 0 : 1;
+}
+
+void INIT_Delay(uint32_t us)
+{
+    HOST_AdvanceUs(us);
+}
+
+void HOST_EnterCritical(void)
+{
+    HOST_nCriticalDepth++;
+}
+
+void HOST_ExitCritical(void)
+{
+    if (0U != HOST_nCriticalDepth)
+    {
+        HOST_nCriticalDepth--;
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(HOST_nTimeUs / 1000U);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return HOST_PCLK1_HZ;
+}
+
+// Single wire mode, the receiver reads the TX pin
+HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart)
+{
+    huart->Instance->CR3 |= USART_CR3_HDSEL;
+    huart->Instance->BRR = (HOST_PCLK1_HZ + (huart->Init.BaudRate / 2U)) / huart->Init.BaudRate;
+    huart->Instance->CR1 |= USART_CR1_UE;
+
+    return HAL_OK;
+}
+
+// The DMA channel only keeps the transfer, the simulators move the data by CMAR and CNDTR.
+// As on the target, CMAR is the memory of both directions.
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    hdma->Instance->CCR = 0U;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress,
+                                uint32_t DstAddress, uint32_t DataLength)
+{
+    if (DMA_MEMORY_TO_PERIPH == hdma->Init.Direction)
+    {
+        hdma->Instance->CPAR = DstAddress;
+        hdma->Instance->CMAR = SrcAddress;
+    }
+    else
+    {
+        hdma->Instance->CPAR = SrcAddress;
+        hdma->Instance->CMAR = DstAddress;
+    }
+    hdma->Instance->CNDTR = DataLength;
+    hdma->Instance->CCR |= DMA_CCR_EN;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress,
+                                   uint32_t DstAddress, uint32_t DataLength)
+{
+    return HAL_DMA_Start(hdma, SrcAddress, DstAddress, DataLength);
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    hdma->Instance->CCR &= ~DMA_CCR_EN;
+
+    return HAL_OK;
+}
+
+// The simulator calls the interrupt of the channel when it has moved the last item or when it has
+// set the transfer error flag
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    if (0U != (hdma->Instance->ISR & DMA_ISR_TEIF1))
+    {
+        hdma->Instance->ISR &= ~DMA_ISR_TEIF1;
+        hdma->Instance->CCR &= ~DMA_CCR_EN;
+
+        if (NULL != hdma->XferErrorCallback)
+        {
+            hdma->XferErrorCallback(hdma);
+        }
+    }
+    else if ((0U != (hdma->Instance->CCR & DMA_CCR_EN)) && (0U == hdma->Instance->CNDTR))
+    {
+        hdma->Instance->CCR &= ~DMA_CCR_EN;
+
+        if (NULL != hdma->XferCpltCallback)
+        {
+            hdma->XferCpltCallback(hdma);
+        }
+    }
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->ARR = htim->Init.Period;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *sConfig,
+                                           uint32_t Channel)
+{
+    (void)htim;
+    (void)sConfig;
+    (void)Channel;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    (void)Channel;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+
+    return HAL_OK;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    // The input and the open drain alternate function (input capture) release the pin,
+    // the open drain bus reads it as the high level
+    if (((GPIO_MODE_INPUT == GPIO_Init->Mode) || (GPIO_MODE_AF_OD == GPIO_Init->Mode)) &&
+        (NULL != HOST_pGpioHook))
+    {
+        HOST_pGpioHook(GPIOx, GPIO_Init->Pin, 1U);
+    }
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (GPIO_PIN_SET == PinState)
+    {
+        LL_GPIO_SetOutputPin(GPIOx, GPIO_Pin);
+    }
+    else
+    {
+        LL_GPIO_ResetOutputPin(GPIOx, GPIO_Pin);
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (0U != (GPIOx->IDR & GPIO_Pin)) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void LL_GPIO_SetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+    GPIOx->ODR |= PinMask;
+
+    if (NULL != HOST_pGpioHook)
+    {
+        HOST_pGpioHook(GPIOx, PinMask, 1U);
+    }
+}
+
+void LL_GPIO_ResetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+    GPIOx->ODR &= ~PinMask;
+
+    if (NULL != HOST_pGpioHook)
+    {
+        HOST_pGpioHook(GPIOx, PinMask, 0U);
+    }
+}
+
+uint32_t LL_GPIO_IsInputPinSet(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+    return (0U != (GPIOx->IDR & PinMask)) ? 1U : 0U;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(HOST_nTimeUs / 1000U);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    return HOST_nSchedulerState;
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    HOST_AdvanceUs((uint64_t)xTicksToDelay * 1000U);
+}
+
+// Without the host task the tested code runs in the test, suspend and resume do nothing
+void vTaskSuspend(TaskHandle_t xTask)
+{
+    (void)xTask;
+
+    if (0U != HOST_bInTask)
+    {
+        HOST_bInTask = 0U;
+        (void)swapcontext(&HOST_stTaskContext, &HOST_stMainContext);
+    }
+}
+
+void vTaskResume(TaskHandle_t xTask)
+{
+    (void)xTask;
+
+    if ((0U != HOST_bTaskCreated) && (0U == HOST_bInTask))
+    {
+        HOST_bInTask = 1U;
+        (void)swapcontext(&HOST_stMainContext, &HOST_stTaskContext);
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return &HOST_nTaskHandle;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    uint32_t nValue = 0U;
+    uint64_t nWaitUs = 0U;
+    const uint64_t nTimeoutUs = (uint64_t)xTicksToWait * 1000U;
+
+    while ((0U == HOST_nNotify) && (nWaitUs < nTimeoutUs))
+    {
+        HOST_AdvanceUs(HOST_WAIT_STEP_US);
+        nWaitUs += HOST_WAIT_STEP_US;
+    }
+
+    nValue = HOST_nNotify;
+    if (0U != nValue)
+    {
+        HOST_nNotify = (pdFALSE != xClearCountOnExit) ? 0U : (HOST_nNotify - 1U);
+    }
+
+    return nValue;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTask, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    (void)xTask;
+    HOST_nNotify++;
+
+    if (NULL != pxHigherPriorityTaskWoken)
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTask)
+{
+    (void)xTask;
+    HOST_nNotify++;
+
+    return pdPASS;
+}
+
+// Free stack of the host task in the words of the target
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    (void)xTask;
+
+    return (0U != HOST_bTaskCreated) ?
+           ((sizeof(HOST_aTaskStack) - HOST_TaskGetStackUsed()) / sizeof(uint32_t)) : 0U;
+}
+
+void vTaskGetInfo(TaskHandle_t xTask, TaskStatus_t *pxTaskStatus,
+                  BaseType_t xGetFreeStackSpace, eTaskState eState)
+{
+    (void)xGetFreeStackSpace;
+    memset(pxTaskStatus, 0, sizeof(*pxTaskStatus));
+    pxTaskStatus->xHandle = xTask;
+    pxTaskStatus->eCurrentState = eState;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t pMutex = NULL;
+
+    if (HOST_nQtyMutexes < HOST_QTY_MUTEXES)
+    {
+        pMutex = &HOST_aMutex[HOST_nQtyMutexes++];
+        pMutex->nDepth = 0U;
+        pMutex->nTakes = 0U;
+        pMutex->bRecursive = 0U;
+    }
+
+    return pMutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    SemaphoreHandle_t pMutex = xSemaphoreCreateMutex();
+
+    if (NULL != pMutex)
+    {
+        pMutex->bRecursive = 1U;
+    }
+
+    return pMutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime)
+{
+    BaseType_t nResult = pdFALSE;
+
+    (void)xBlockTime;
+
+    if (0U == xSemaphore->nDepth)
+    {
+        xSemaphore->nDepth = 1U;
+        xSemaphore->nTakes++;
+        nResult = pdTRUE;
+    }
+    else
+    {
+        HOST_nMutexContention++;
+    }
+
+    return nResult;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+    BaseType_t nResult = pdFALSE;
+
+    if (0U != xSemaphore->nDepth)
+    {
+        xSemaphore->nDepth = 0U;
+        nResult = pdTRUE;
+    }
+
+    return nResult;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xBlockTime)
+{
+    (void)xBlockTime;
+    xMutex->nDepth++;
+    xMutex->nTakes++;
+
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex)
+{
+    BaseType_t nResult = pdFALSE;
+
+    if (0U != xMutex->nDepth)
+    {
+        xMutex->nDepth--;
+        nResult = pdTRUE;
+    }
+
+    return nResult;
+}
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void HOST_TaskEntry(void)
+{
+    HOST_pTask(HOST_pTaskParameters);
+
+    // The task of FreeRTOS never returns
+    HOST_Assert(__FILE__, __LINE__);
+}
+
+// Time hook called by the task. The reset of the target in the hook leaves the loop, the
+// next call starts from the last switch back to the task.
+static void HOST_IsrEntry(void)
+{
+    for (;;)
+    {
+        HOST_pTimeHook(HOST_nTimeUs);
+        (void)swapcontext(&HOST_stIsrContext, &HOST_stTaskContext);
+    }
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,129 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      host_stubs.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the host environment of the host tests: virtual time,
+//                scheduler state, mutexes, critical sections, GPIO and the check macros.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "stm32l4xx_hal.h"
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+// Called when the virtual time advances, the simulators run their devices from it
+typedef void (*HOST_TIME_HOOK)(const uint64_t nTimeUs);
+
+// Called when an output pin changes
+typedef void (*HOST_GPIO_HOOK)(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel);
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// Step of the virtual time while a task waits for a notification, us
+#define HOST_WAIT_STEP_US               (100U)
+
+// Stack of the host task, bytes
+#define HOST_SIZE_TASK_STACK            (0x10000U)
+
+// Stack of the time hook called by the task, bytes
+#define HOST_SIZE_ISR_STACK             (0x10000U)
+
+// Check of the host tests, the failure is printed and counted
+#define TEST_CHECK(cond)                                                                \
+    do                                                                                  \
+    {                                                                                   \
+        HOST_nChecks++;                                                                 \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            HOST_nFailures++;                                                           \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);             \
+        }                                                                               \
+    } while (0)
+
+
+//**************************************************************************************************
+// Declarations of global (public) variables
+//**************************************************************************************************
+
+// Quantity of the checks and of the failed checks
+extern uint32_t HOST_nChecks;
+extern uint32_t HOST_nFailures;
+
+// Virtual time, us
+extern uint64_t HOST_nTimeUs;
+
+// Scheduler state returned by xTaskGetSchedulerState()
+extern BaseType_t HOST_nSchedulerState;
+
+// Nesting of the critical sections and the delays made inside them
+extern uint32_t HOST_nCriticalDepth;
+extern uint32_t HOST_nDelayInCritical;
+
+// Hooks of the simulators
+extern HOST_TIME_HOOK HOST_pTimeHook;
+extern HOST_GPIO_HOOK HOST_pGpioHook;
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+// Advance the virtual time
+extern void HOST_AdvanceUs(const uint64_t nUs);
+
+// Nesting of all recursive mutexes
+extern uint32_t HOST_GetRecursiveDepth(void);
+
+// Quantity of the takes of all recursive mutexes
+extern uint32_t HOST_GetRecursiveTakes(void);
+
+// Quantity of the takes of a mutex which would block on the target
+extern uint32_t HOST_GetMutexContention(void);
+
+// Run the task on its own stack. The task runs from vTaskResume() of the test until it
+// suspends itself, the previous task is dropped
+extern void HOST_TaskCreate(TaskFunction_t pTask, void *pParameters);
+
+// Drop the running task as the reset of the target, the test continues after vTaskResume()
+extern void HOST_TaskKill(void);
+
+// Max stack used by the task since HOST_TaskCreate(), bytes. The time hook called by the
+// task runs on its own stack as the interrupts of the target, it is not counted.
+extern uint32_t HOST_TaskGetStackUsed(void);
+
+// Print the result of the checks, returns the exit code of the test
+extern int HOST_Result(const char *const pName);
+
+// Delay of the board, us
+extern void INIT_Delay(uint32_t us);
+
+#endif // #ifndef HOST_STUBS_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,23 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      printf.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the embedded printf library, the C library is used.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_PRINTF_H
+#define HOST_PRINTF_H
+
+#include <stdio.h>
+
+#endif // #ifndef HOST_PRINTF_H
+
+//****************************************** end of file *******************************************
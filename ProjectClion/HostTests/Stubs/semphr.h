@@ -0,0 +1,34 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      semphr.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the FreeRTOS semaphore API for the host tests.
+//                The host tests run in one thread, the mutexes only count the nesting.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_SEMPHR_H
+#define HOST_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef struct HOST_MUTEX_str* SemaphoreHandle_t;
+typedef SemaphoreHandle_t xSemaphoreHandle;
+
+extern SemaphoreHandle_t xSemaphoreCreateMutex(void);
+extern SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+extern BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime);
+extern BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+extern BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xBlockTime);
+extern BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex);
+
+#endif // #ifndef HOST_SEMPHR_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,557 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_hal.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 HAL for the host tests.
+//                Only the types and functions used by the tested modules are declared.
+//                The peripherals are plain structures, the simulators in HostTests/Sim
+//                implement the data path of the peripherals they model.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_HAL_H
+#define HOST_STM32L4XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//**************************************************************************************************
+// Peripherals
+//**************************************************************************************************
+
+typedef struct
+{
+    volatile uint32_t ODR;
+    volatile uint32_t IDR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t ISR;
+    volatile uint32_t ICR;
+    volatile uint32_t CNT;
+    volatile uint32_t CNDTR;
+    volatile uint32_t CCR;
+    volatile uint32_t TDR;
+    volatile uint32_t RDR;
+    volatile uint32_t SR;
+    volatile uint32_t DIER;
+    volatile uint32_t ARR;
+    volatile uint32_t CCR1;
+    volatile uint32_t CPAR;
+    volatile uint32_t CMAR;
+    volatile uint32_t BRR;
+} HOST_PERIPH;
+
+typedef HOST_PERIPH GPIO_TypeDef;
+typedef HOST_PERIPH SPI_TypeDef;
+typedef HOST_PERIPH USART_TypeDef;
+typedef HOST_PERIPH TIM_TypeDef;
+typedef HOST_PERIPH I2C_TypeDef;
+typedef HOST_PERIPH ADC_TypeDef;
+typedef HOST_PERIPH LPTIM_TypeDef;
+typedef HOST_PERIPH QUADSPI_TypeDef;
+typedef HOST_PERIPH DMA_Channel_TypeDef;
+typedef HOST_PERIPH RTC_TypeDef;
+
+extern HOST_PERIPH HOST_aPeriph[];
+
+#define GPIOA           (&HOST_aPeriph[0])
+#define GPIOB           (&HOST_aPeriph[1])
+#define GPIOC           (&HOST_aPeriph[2])
+#define SPI1            (&HOST_aPeriph[3])
+#define QUADSPI         (&HOST_aPeriph[4])
+#define USART1          (&HOST_aPeriph[5])
+#define USART2          (&HOST_aPeriph[6])
+#define USART3          (&HOST_aPeriph[7])
+#define UART4           (&HOST_aPeriph[8])
+#define TIM6            (&HOST_aPeriph[9])
+#define TIM15           (&HOST_aPeriph[10])
+#define I2C1            (&HOST_aPeriph[11])
+#define ADC1            (&HOST_aPeriph[12])
+#define LPTIM1          (&HOST_aPeriph[13])
+#define DMA1_Channel1   (&HOST_aPeriph[14])
+#define DMA1_Channel2   (&HOST_aPeriph[15])
+#define DMA1_Channel3   (&HOST_aPeriph[16])
+#define DMA1_Channel4   (&HOST_aPeriph[17])
+#define DMA1_Channel5   (&HOST_aPeriph[18])
+#define DMA1_Channel6   (&HOST_aPeriph[19])
+#define DMA1_Channel7   (&HOST_aPeriph[20])
+#define TIM2            (&HOST_aPeriph[21])
+#define DMA2_Channel3   (&HOST_aPeriph[22])
+#define DMA2_Channel5   (&HOST_aPeriph[23])
+#define RTC             (&HOST_aPeriph[24])
+#define EXTI            (&HOST_aPeriph[25])
+#define HOST_QTY_PERIPH (26U)
+
+typedef enum
+{
+    RTC_WKUP_IRQn = 3,
+    DMA1_Channel1_IRQn = 11,
+    DMA1_Channel2_IRQn,
+    DMA1_Channel3_IRQn,
+    DMA1_Channel4_IRQn,
+    DMA1_Channel5_IRQn,
+    DMA1_Channel6_IRQn,
+    DMA1_Channel7_IRQn,
+    USART3_IRQn = 39,
+    LPTIM1_IRQn = 65,
+    TIM1_BRK_TIM15_IRQn = 24,
+    I2C1_EV_IRQn = 31,
+    I2C1_ER_IRQn = 32,
+    DMA2_Channel5_IRQn = 60,
+} IRQn_Type;
+
+//**************************************************************************************************
+// Common
+//**************************************************************************************************
+
+typedef enum
+{
+    RESET = 0,
+    SET = !RESET
+} FlagStatus, ITStatus;
+
+typedef enum
+{
+    DISABLE = 0,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+typedef enum
+{
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define __disable_irq()                 HOST_EnterCritical()
+#define __enable_irq()                  HOST_ExitCritical()
+#define __NOP()                         do {} while (0)
+
+extern void HOST_EnterCritical(void);
+extern void HOST_ExitCritical(void);
+extern uint32_t HAL_GetTick(void);
+extern void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+extern void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+extern void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()    do {} while (0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()    do {} while (0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()    do {} while (0)
+#define __HAL_RCC_SPI1_CLK_ENABLE()     do {} while (0)
+#define __HAL_RCC_QSPI_CLK_ENABLE()     do {} while (0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()     do {} while (0)
+#define __HAL_RCC_DMA2_CLK_ENABLE()     do {} while (0)
+#define __HAL_RCC_USART3_CLK_ENABLE()   do {} while (0)
+#define __HAL_RCC_UART4_CLK_ENABLE()    do {} while (0)
+#define __HAL_RCC_TIM15_CLK_ENABLE()    do {} while (0)
+#define __HAL_RCC_LPTIM1_CLK_ENABLE()   do {} while (0)
+
+//**************************************************************************************************
+// GPIO
+//**************************************************************************************************
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_PIN_0                  ((uint16_t)0x0001)
+#define GPIO_PIN_1                  ((uint16_t)0x0002)
+#define GPIO_PIN_2                  ((uint16_t)0x0004)
+#define GPIO_PIN_3                  ((uint16_t)0x0008)
+#define GPIO_PIN_4                  ((uint16_t)0x0010)
+#define GPIO_PIN_5                  ((uint16_t)0x0020)
+#define GPIO_PIN_6                  ((uint16_t)0x0040)
+#define GPIO_PIN_7                  ((uint16_t)0x0080)
+#define GPIO_PIN_8                  ((uint16_t)0x0100)
+#define GPIO_PIN_9                  ((uint16_t)0x0200)
+#define GPIO_PIN_10                 ((uint16_t)0x0400)
+#define GPIO_PIN_11                 ((uint16_t)0x0800)
+#define GPIO_PIN_12                 ((uint16_t)0x1000)
+#define GPIO_PIN_13                 ((uint16_t)0x2000)
+#define GPIO_PIN_14                 ((uint16_t)0x4000)
+#define GPIO_PIN_15                 ((uint16_t)0x8000)
+
+#define GPIO_MODE_INPUT             (0x00000000U)
+#define GPIO_MODE_OUTPUT_PP         (0x00000001U)
+#define GPIO_MODE_OUTPUT_OD         (0x00000011U)
+#define GPIO_MODE_AF_PP             (0x00000002U)
+#define GPIO_MODE_AF_OD             (0x00000012U)
+#define GPIO_MODE_ANALOG            (0x00000003U)
+#define GPIO_MODE_ANALOG_ADC_CONTROL (0x0000000BU)
+#define GPIO_NOPULL                 (0x00000000U)
+#define GPIO_PULLUP                 (0x00000001U)
+#define GPIO_PULLDOWN               (0x00000002U)
+#define GPIO_SPEED_FREQ_LOW         (0x00000000U)
+#define GPIO_SPEED_FREQ_MEDIUM      (0x00000001U)
+#define GPIO_SPEED_FREQ_HIGH        (0x00000002U)
+#define GPIO_SPEED_FREQ_VERY_HIGH   (0x00000003U)
+#define GPIO_AF1_LPTIM1             ((uint8_t)0x01)
+#define GPIO_AF4_I2C1               ((uint8_t)0x04)
+#define GPIO_AF5_SPI1               ((uint8_t)0x05)
+#define GPIO_AF7_USART1             ((uint8_t)0x07)
+#define GPIO_AF7_USART2             ((uint8_t)0x07)
+#define GPIO_AF7_USART3             ((uint8_t)0x07)
+#define GPIO_AF8_UART4              ((uint8_t)0x08)
+#define GPIO_AF10_QUADSPI           ((uint8_t)0x0A)
+#define GPIO_AF14_TIM15             ((uint8_t)0x0E)
+
+extern void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+extern void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+extern GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+//**************************************************************************************************
+// DMA
+//**************************************************************************************************
+
+typedef struct
+{
+    uint32_t Request;
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+    DMA_Channel_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+    void *Parent;
+    void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferHalfCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferErrorCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferAbortCallback)(struct __DMA_HandleTypeDef *hdma);
+} DMA_HandleTypeDef;
+
+#define DMA_REQUEST_2               (2U)
+#define DMA_REQUEST_7               (7U)
+#define DMA_PERIPH_TO_MEMORY        (0x00000000U)
+#define DMA_MEMORY_TO_PERIPH        (0x00000010U)
+#define DMA_PINC_DISABLE            (0x00000000U)
+#define DMA_MINC_ENABLE             (0x00000080U)
+#define DMA_PDATAALIGN_BYTE         (0x00000000U)
+#define DMA_PDATAALIGN_HALFWORD     (0x00000100U)
+#define DMA_MDATAALIGN_BYTE         (0x00000000U)
+#define DMA_MDATAALIGN_HALFWORD     (0x00000400U)
+#define DMA_NORMAL                  (0x00000000U)
+#define DMA_PRIORITY_LOW            (0x00000000U)
+#define DMA_PRIORITY_HIGH           (0x00002000U)
+#define DMA_PRIORITY_VERY_HIGH      (0x00003000U)
+#define DMA_CCR_EN                  (0x00000001U)
+// Transfer error flag, the simulators set it in ISR of the channel
+#define DMA_ISR_TEIF1               (0x00000008U)
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__)   ((__HANDLE__)->Instance->CNDTR)
+
+extern HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+extern HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress,
+                                       uint32_t DstAddress, uint32_t DataLength);
+extern HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress,
+                                          uint32_t DstAddress, uint32_t DataLength);
+extern HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+extern void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+//**************************************************************************************************
+// SPI
+//**************************************************************************************************
+
+typedef struct
+{
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+    uint32_t TIMode;
+    uint32_t CRCCalculation;
+    uint32_t CRCPolynomial;
+    uint32_t CRCLength;
+    uint32_t NSSPMode;
+} SPI_InitTypeDef;
+
+typedef struct
+{
+    SPI_TypeDef *Instance;
+    SPI_InitTypeDef Init;
+} SPI_HandleTypeDef;
+
+#define SPI_MODE_MASTER             (1U)
+#define SPI_DIRECTION_2LINES        (0U)
+#define SPI_DATASIZE_8BIT           (7U)
+#define SPI_POLARITY_LOW            (0U)
+#define SPI_PHASE_1EDGE             (0U)
+#define SPI_NSS_SOFT                (1U)
+#define SPI_BAUDRATEPRESCALER_2     (0U)
+#define SPI_FIRSTBIT_MSB            (0U)
+#define SPI_TIMODE_DISABLE          (0U)
+#define SPI_CRCCALCULATION_DISABLE  (0U)
+#define SPI_CRC_LENGTH_8BIT         (1U)
+#define SPI_NSS_PULSE_DISABLE       (0U)
+
+extern HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+
+//**************************************************************************************************
+// QUADSPI
+//**************************************************************************************************
+
+typedef struct
+{
+    uint32_t ClockPrescaler;
+    uint32_t FifoThreshold;
+    uint32_t SampleShifting;
+    uint32_t FlashSize;
+    uint32_t ChipSelectHighTime;
+    uint32_t ClockMode;
+} QSPI_InitTypeDef;
+
+typedef struct
+{
+    QUADSPI_TypeDef *Instance;
+    QSPI_InitTypeDef Init;
+} QSPI_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t Instruction;
+    uint32_t Address;
+    uint32_t AlternateBytes;
+    uint32_t AddressSize;
+    uint32_t AlternateBytesSize;
+    uint32_t DummyCycles;
+    uint32_t InstructionMode;
+    uint32_t AddressMode;
+    uint32_t AlternateByteMode;
+    uint32_t DataMode;
+    uint32_t NbData;
+    uint32_t DdrMode;
+    uint32_t DdrHoldHalfCycle;
+    uint32_t SIOOMode;
+} QSPI_CommandTypeDef;
+
+typedef struct
+{
+    uint32_t TimeOutPeriod;
+    uint32_t TimeOutActivation;
+} QSPI_MemoryMappedTypeDef;
+
+#define QSPI_SAMPLE_SHIFTING_HALFCYCLE  (1U)
+#define QSPI_CS_HIGH_TIME_2_CYCLE       (1U)
+#define QSPI_CLOCK_MODE_0               (0U)
+#define QSPI_INSTRUCTION_NONE           (0U)
+#define QSPI_INSTRUCTION_1_LINE         (1U)
+#define QSPI_ADDRESS_NONE               (0U)
+#define QSPI_ADDRESS_1_LINE             (1U)
+#define QSPI_ADDRESS_4_LINES            (3U)
+#define QSPI_ADDRESS_8_BITS             (0U)
+#define QSPI_ADDRESS_16_BITS            (1U)
+#define QSPI_ADDRESS_24_BITS            (2U)
+#define QSPI_ADDRESS_32_BITS            (3U)
+#define QSPI_ALTERNATE_BYTES_NONE       (0U)
+#define QSPI_DATA_NONE                  (0U)
+#define QSPI_DATA_1_LINE                (1U)
+#define QSPI_DATA_2_LINES               (2U)
+#define QSPI_DATA_4_LINES               (3U)
+#define QSPI_DDR_MODE_DISABLE           (0U)
+#define QSPI_DDR_HHC_ANALOG_DELAY       (0U)
+#define QSPI_SIOO_INST_EVERY_CMD        (0U)
+#define QSPI_TIMEOUT_COUNTER_ENABLE     (1U)
+#define QSPI_BASE                       ((uintptr_t)HOST_pQspiMapped)
+
+extern uint8_t *HOST_pQspiMapped;
+extern HAL_StatusTypeDef HAL_QSPI_Init(QSPI_HandleTypeDef *hqspi);
+extern HAL_StatusTypeDef HAL_QSPI_Command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+                                          uint32_t Timeout);
+extern HAL_StatusTypeDef HAL_QSPI_Transmit(QSPI_HandleTypeDef *hqspi, uint8_t *pData,
+                                           uint32_t Timeout);
+extern HAL_StatusTypeDef HAL_QSPI_Receive(QSPI_HandleTypeDef *hqspi, uint8_t *pData,
+                                          uint32_t Timeout);
+extern HAL_StatusTypeDef HAL_QSPI_MemoryMapped(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+                                               QSPI_MemoryMappedTypeDef *cfg);
+extern HAL_StatusTypeDef HAL_QSPI_Abort(QSPI_HandleTypeDef *hqspi);
+
+//**************************************************************************************************
+// TIM
+//**************************************************************************************************
+
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+} TIM_Base_InitTypeDef;
+
+typedef enum
+{
+    HAL_TIM_ACTIVE_CHANNEL_1 = 0x01U,
+    HAL_TIM_ACTIVE_CHANNEL_CLEARED = 0x00U
+} HAL_TIM_ActiveChannel;
+
+typedef struct
+{
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+    HAL_TIM_ActiveChannel Channel;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t ICPolarity;
+    uint32_t ICSelection;
+    uint32_t ICPrescaler;
+    uint32_t ICFilter;
+} TIM_IC_InitTypeDef;
+
+#define TIM_CR1_CEN                 (0x0001U)
+#define TIM_SR_UIF                  (0x0001U)
+#define TIM_SR_CC1IF                (0x0002U)
+#define TIM_DIER_UIE                (0x0001U)
+#define TIM_DIER_CC1DE              (0x0200U)
+#define TIM_FLAG_UPDATE             TIM_SR_UIF
+#define TIM_FLAG_CC1                TIM_SR_CC1IF
+#define TIM_CHANNEL_1               (0x00000000U)
+#define TIM_COUNTERMODE_UP          (0x00000000U)
+#define TIM_ICPOLARITY_BOTHEDGE     (0x0000000AU)
+#define TIM_ICSELECTION_DIRECTTI    (0x00000001U)
+#define TIM_ICPSC_DIV1              (0x00000000U)
+
+extern HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+extern HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim);
+extern HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *sConfig,
+                                                  uint32_t Channel);
+extern HAL_StatusTypeDef HAL_TIM_IC_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+extern HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+extern HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim);
+
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__) \
+    do { (__HANDLE__)->Instance->ARR = (__AUTORELOAD__); (__HANDLE__)->Init.Period = (__AUTORELOAD__); } while (0)
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __COUNTER__)      ((__HANDLE__)->Instance->CNT = (__COUNTER__))
+
+//**************************************************************************************************
+// UART, I2C, ADC: handles, the UART of the modem also RX and TX DMA flags
+//**************************************************************************************************
+
+typedef struct
+{
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct
+{
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+} UART_HandleTypeDef;
+
+typedef UART_HandleTypeDef USART_HandleTypeDef;
+
+#define USART_ISR_RXNE              (0x00000020U)
+#define USART_ISR_ORE               (0x00000008U)
+#define USART_CR1_RXNEIE            (0x00000020U)
+#define USART_CR3_DMAT              (0x00000080U)
+#define USART_CR3_DMAR              (0x00000040U)
+#define USART_CR3_HDSEL             (0x00000008U)
+#define USART_CR1_UE                (0x00000001U)
+
+#define UART_WORDLENGTH_8B          (0x00000000U)
+#define UART_STOPBITS_1             (0x00000000U)
+#define UART_PARITY_NONE            (0x00000000U)
+#define UART_MODE_TX_RX             (0x0000000CU)
+#define UART_HWCONTROL_NONE         (0x00000000U)
+#define UART_OVERSAMPLING_16        (0x00000000U)
+
+// Clock of the USART baud rate, the board runs at 80 MHz
+#define HOST_PCLK1_HZ               (80000000U)
+
+extern HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart);
+extern uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+typedef struct
+{
+    I2C_TypeDef *Instance;
+} I2C_HandleTypeDef;
+
+typedef struct
+{
+    ADC_TypeDef *Instance;
+    DMA_HandleTypeDef *DMA_Handle;
+} ADC_HandleTypeDef;
+
+// The simulators of the devices on the bus and of the ADC define the functions
+#define I2C_MEMADD_SIZE_8BIT        (0x00000001U)
+#define HAL_I2C_ERROR_NONE          (0x00000000U)
+#define HAL_I2C_ERROR_AF            (0x00000004U)
+
+extern HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+extern HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+extern HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                             uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+extern HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                              uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+extern uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+extern void HAL_I2C_EV_IRQHandler(I2C_HandleTypeDef *hi2c);
+extern void HAL_I2C_ER_IRQHandler(I2C_HandleTypeDef *hi2c);
+extern void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+extern void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+extern void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+#define ADC_SINGLE_ENDED            (0x7FU)
+#define HAL_ADC_ERROR_NONE          (0x00U)
+#define HAL_ADC_ERROR_OVR           (0x02U)
+
+extern HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t SingleDiff);
+extern HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+extern HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+extern uint32_t HAL_ADC_GetError(ADC_HandleTypeDef *hadc);
+extern void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+extern void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc);
+
+//**************************************************************************************************
+// RTC: the alarms of time_drv_cfg.h only
+//**************************************************************************************************
+
+#define RTC_ALARM_A                 (0x00000100U)
+#define RTC_ALARM_B                 (0x00000200U)
+#define RTC_ALARMMASK_NONE          (0x00000000U)
+#define RTC_ALARMMASK_DATEWEEKDAY   (0x80000000U)
+#define RTC_ALARMMASK_HOURS         (0x00800000U)
+#define RTC_ALARMMASK_MINUTES       (0x00008000U)
+#define RTC_ALARMMASK_SECONDS       (0x00000080U)
+
+#endif // #ifndef HOST_STM32L4XX_HAL_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,41 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_exti.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL EXTI driver for the host tests, the lines 0..31 only.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_EXTI_H
+#define HOST_STM32L4XX_LL_EXTI_H
+
+#include "stm32l4xx_hal.h"
+
+// CR1 is EXTI_IMR1, CR2 is EXTI_RTSR1, ISR is EXTI_PR1
+#define LL_EXTI_LINE_20                     (0x00100000U)
+
+static inline void LL_EXTI_EnableIT_0_31(uint32_t ExtiLine)
+{
+    EXTI->CR1 |= ExtiLine;
+}
+
+static inline void LL_EXTI_EnableRisingTrig_0_31(uint32_t ExtiLine)
+{
+    EXTI->CR2 |= ExtiLine;
+}
+
+static inline void LL_EXTI_ClearFlag_0_31(uint32_t ExtiLine)
+{
+    EXTI->ISR &= ~ExtiLine;
+}
+
+#endif // #ifndef HOST_STM32L4XX_LL_EXTI_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,27 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_gpio.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL GPIO driver for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_GPIO_H
+#define HOST_STM32L4XX_LL_GPIO_H
+
+#include "stm32l4xx_hal.h"
+
+extern void LL_GPIO_SetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask);
+extern void LL_GPIO_ResetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask);
+extern uint32_t LL_GPIO_IsInputPinSet(GPIO_TypeDef *GPIOx, uint32_t PinMask);
+
+#endif // #ifndef HOST_STM32L4XX_LL_GPIO_H
+
+//****************************************** end of file *******************************************
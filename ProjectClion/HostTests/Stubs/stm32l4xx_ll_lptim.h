@@ -0,0 +1,76 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_lptim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL LPTIM driver for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_LPTIM_H
+#define HOST_STM32L4XX_LL_LPTIM_H
+
+#include "stm32l4xx_hal.h"
+
+// The counter is CNT, the test sets it as the pulses come, the configuration isn't modeled
+#define LL_LPTIM_CLK_SOURCE_INTERNAL        (0x00000000U)
+#define LL_LPTIM_COUNTER_MODE_EXTERNAL      (0x00800000U)
+#define LL_LPTIM_CLK_FILTER_8               (0x00000018U)
+#define LL_LPTIM_CLK_POLARITY_FALLING       (0x00000002U)
+#define LL_LPTIM_PRESCALER_DIV1             (0x00000000U)
+#define LL_LPTIM_OPERATING_MODE_CONTINUOUS  (0x00000004U)
+
+static inline void LL_LPTIM_SetClockSource(LPTIM_TypeDef *LPTIMx, uint32_t ClockSource)
+{
+    (void)LPTIMx;
+    (void)ClockSource;
+}
+
+static inline void LL_LPTIM_SetCounterMode(LPTIM_TypeDef *LPTIMx, uint32_t CounterMode)
+{
+    (void)LPTIMx;
+    (void)CounterMode;
+}
+
+static inline void LL_LPTIM_ConfigClock(LPTIM_TypeDef *LPTIMx, uint32_t ClockFilter, uint32_t ClockPolarity)
+{
+    (void)LPTIMx;
+    (void)ClockFilter;
+    (void)ClockPolarity;
+}
+
+static inline void LL_LPTIM_SetPrescaler(LPTIM_TypeDef *LPTIMx, uint32_t Prescaler)
+{
+    (void)LPTIMx;
+    (void)Prescaler;
+}
+
+static inline void LL_LPTIM_Enable(LPTIM_TypeDef *LPTIMx)
+{
+    LPTIMx->CR1 |= 0x1U;
+}
+
+static inline void LL_LPTIM_SetAutoReload(LPTIM_TypeDef *LPTIMx, uint32_t AutoReload)
+{
+    LPTIMx->ARR = AutoReload;
+}
+
+static inline void LL_LPTIM_StartCounter(LPTIM_TypeDef *LPTIMx, uint32_t OperatingMode)
+{
+    LPTIMx->CR1 |= OperatingMode;
+}
+
+static inline uint32_t LL_LPTIM_GetCounter(LPTIM_TypeDef *LPTIMx)
+{
+    return LPTIMx->CNT & 0xFFFFU;
+}
+
+#endif // #ifndef HOST_STM32L4XX_LL_LPTIM_H
+
+//****************************************** end of file *******************************************
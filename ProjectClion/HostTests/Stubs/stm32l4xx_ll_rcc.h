@@ -0,0 +1,30 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_rcc.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL RCC driver for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_RCC_H
+#define HOST_STM32L4XX_LL_RCC_H
+
+#include "stm32l4xx_hal.h"
+
+#define LL_RCC_LPTIM1_CLKSOURCE_LSE         (0x000C0000U)
+
+static inline void LL_RCC_SetLPTIMClockSource(uint32_t LPTIMxSource)
+{
+    (void)LPTIMxSource;
+}
+
+#endif // #ifndef HOST_STM32L4XX_LL_RCC_H
+
+//****************************************** end of file *******************************************
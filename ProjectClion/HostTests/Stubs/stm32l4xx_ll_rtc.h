@@ -0,0 +1,102 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_rtc.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL RTC driver for the host tests, the wake up timer only.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_RTC_H
+#define HOST_STM32L4XX_LL_RTC_H
+
+#include "stm32l4xx_hal.h"
+
+// CR1 is RTC_CR, ISR is RTC_ISR, ARR is RTC_WUTR. The write protection is counted in CCR1:
+// 0 - protected, the timer bits written while it is protected are lost.
+#define RTC_CR_WUCKSEL                      (0x00000007U)
+#define RTC_CR_WUTE                         (0x00000400U)
+#define RTC_CR_WUTIE                        (0x00004000U)
+#define RTC_ISR_WUTWF                       (0x00000004U)
+#define RTC_ISR_WUTF                        (0x00000400U)
+#define LL_RTC_WAKEUPCLOCK_DIV_16           (0x00000000U)
+
+static inline void LL_RTC_DisableWriteProtection(RTC_TypeDef *RTCx)
+{
+    RTCx->CCR1 = 1U;
+}
+
+static inline void LL_RTC_EnableWriteProtection(RTC_TypeDef *RTCx)
+{
+    RTCx->CCR1 = 0U;
+}
+
+static inline void LL_RTC_WAKEUP_Disable(RTC_TypeDef *RTCx)
+{
+    if (0U != RTCx->CCR1)
+    {
+        RTCx->CR1 &= ~RTC_CR_WUTE;
+        RTCx->ISR |= RTC_ISR_WUTWF;
+    }
+}
+
+static inline void LL_RTC_WAKEUP_Enable(RTC_TypeDef *RTCx)
+{
+    if (0U != RTCx->CCR1)
+    {
+        RTCx->CR1 |= RTC_CR_WUTE;
+        RTCx->ISR &= ~RTC_ISR_WUTWF;
+    }
+}
+
+static inline uint32_t LL_RTC_IsActiveFlag_WUTW(RTC_TypeDef *RTCx)
+{
+    return (0U != (RTCx->ISR & RTC_ISR_WUTWF)) ? 1U : 0U;
+}
+
+static inline void LL_RTC_WAKEUP_SetAutoReload(RTC_TypeDef *RTCx, uint32_t Value)
+{
+    if ((0U != RTCx->CCR1) && (0U != (RTCx->ISR & RTC_ISR_WUTWF)))
+    {
+        RTCx->ARR = Value;
+    }
+}
+
+static inline void LL_RTC_WAKEUP_SetClock(RTC_TypeDef *RTCx, uint32_t WakeupClock)
+{
+    if ((0U != RTCx->CCR1) && (0U != (RTCx->ISR & RTC_ISR_WUTWF)))
+    {
+        RTCx->CR1 = (RTCx->CR1 & ~RTC_CR_WUCKSEL) | WakeupClock;
+    }
+}
+
+static inline void LL_RTC_EnableIT_WUT(RTC_TypeDef *RTCx)
+{
+    if (0U != RTCx->CCR1)
+    {
+        RTCx->CR1 |= RTC_CR_WUTIE;
+    }
+}
+
+static inline void LL_RTC_DisableIT_WUT(RTC_TypeDef *RTCx)
+{
+    if (0U != RTCx->CCR1)
+    {
+        RTCx->CR1 &= ~RTC_CR_WUTIE;
+    }
+}
+
+static inline void LL_RTC_ClearFlag_WUT(RTC_TypeDef *RTCx)
+{
+    RTCx->ISR &= ~RTC_ISR_WUTF;
+}
+
+#endif // #ifndef HOST_STM32L4XX_LL_RTC_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,31 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_spi.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL SPI driver for the host tests.
+//                The data path is implemented by the simulator of the connected device.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_SPI_H
+#define HOST_STM32L4XX_LL_SPI_H
+
+#include "stm32l4xx_hal.h"
+
+extern void LL_SPI_Enable(SPI_TypeDef *SPIx);
+extern uint32_t LL_SPI_IsActiveFlag_TXE(SPI_TypeDef *SPIx);
+extern uint32_t LL_SPI_IsActiveFlag_RXNE(SPI_TypeDef *SPIx);
+extern uint32_t LL_SPI_IsActiveFlag_BSY(SPI_TypeDef *SPIx);
+extern void LL_SPI_TransmitData8(SPI_TypeDef *SPIx, uint8_t TxData);
+extern uint8_t LL_SPI_ReceiveData8(SPI_TypeDef *SPIx);
+
+#endif // #ifndef HOST_STM32L4XX_LL_SPI_H
+
+//****************************************** end of file *******************************************
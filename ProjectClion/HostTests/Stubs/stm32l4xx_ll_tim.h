@@ -0,0 +1,68 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_tim.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL TIM driver for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_TIM_H
+#define HOST_STM32L4XX_LL_TIM_H
+
+#include "stm32l4xx_hal.h"
+
+static inline uint32_t LL_TIM_IsActiveFlag_UPDATE(TIM_TypeDef *TIMx)
+{
+    return (0U != (TIMx->SR & TIM_SR_UIF)) ? 1U : 0U;
+}
+
+static inline uint32_t LL_TIM_IsActiveFlag_CC1(TIM_TypeDef *TIMx)
+{
+    return (0U != (TIMx->SR & TIM_SR_CC1IF)) ? 1U : 0U;
+}
+
+static inline void LL_TIM_ClearFlag_UPDATE(TIM_TypeDef *TIMx)
+{
+    TIMx->SR &= ~TIM_SR_UIF;
+}
+
+static inline void LL_TIM_ClearFlag_CC1(TIM_TypeDef *TIMx)
+{
+    TIMx->SR &= ~TIM_SR_CC1IF;
+}
+
+static inline void LL_TIM_EnableIT_UPDATE(TIM_TypeDef *TIMx)
+{
+    TIMx->DIER |= TIM_DIER_UIE;
+}
+
+static inline void LL_TIM_DisableIT_UPDATE(TIM_TypeDef *TIMx)
+{
+    TIMx->DIER &= ~TIM_DIER_UIE;
+}
+
+static inline uint32_t LL_TIM_IsEnabledIT_UPDATE(TIM_TypeDef *TIMx)
+{
+    return (0U != (TIMx->DIER & TIM_DIER_UIE)) ? 1U : 0U;
+}
+
+static inline void LL_TIM_EnableDMAReq_CC1(TIM_TypeDef *TIMx)
+{
+    TIMx->DIER |= TIM_DIER_CC1DE;
+}
+
+static inline void LL_TIM_DisableDMAReq_CC1(TIM_TypeDef *TIMx)
+{
+    TIMx->DIER &= ~TIM_DIER_CC1DE;
+}
+
+#endif // #ifndef HOST_STM32L4XX_LL_TIM_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,87 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      stm32l4xx_ll_usart.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the STM32L4 LL USART driver for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_STM32L4XX_LL_USART_H
+#define HOST_STM32L4XX_LL_USART_H
+
+#include "stm32l4xx_hal.h"
+
+#define LL_USART_DMA_REG_DATA_TRANSMIT  (0U)
+#define LL_USART_DMA_REG_DATA_RECEIVE   (1U)
+#define LL_USART_OVERSAMPLING_16        (0U)
+
+static inline void LL_USART_Enable(USART_TypeDef *USARTx)
+{
+    USARTx->CR1 |= USART_CR1_UE;
+}
+
+static inline void LL_USART_Disable(USART_TypeDef *USARTx)
+{
+    USARTx->CR1 &= ~USART_CR1_UE;
+}
+
+// BRR of the oversampling by 16, the simulators get the bit time from it
+static inline void LL_USART_SetBaudRate(USART_TypeDef *USARTx, uint32_t PeriphClk, uint32_t OverSampling,
+                                        uint32_t BaudRate)
+{
+    (void)OverSampling;
+    USARTx->BRR = (PeriphClk + (BaudRate / 2U)) / BaudRate;
+}
+
+static inline void LL_USART_RequestRxDataFlush(USART_TypeDef *USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_RXNE;
+}
+
+static inline void LL_USART_EnableIT_RXNE(USART_TypeDef *USARTx)
+{
+    USARTx->CR1 |= USART_CR1_RXNEIE;
+}
+
+static inline void LL_USART_ClearFlag_ORE(USART_TypeDef *USARTx)
+{
+    USARTx->ISR &= ~USART_ISR_ORE;
+}
+
+static inline void LL_USART_EnableDMAReq_TX(USART_TypeDef *USARTx)
+{
+    USARTx->CR3 |= USART_CR3_DMAT;
+}
+
+static inline void LL_USART_DisableDMAReq_TX(USART_TypeDef *USARTx)
+{
+    USARTx->CR3 &= ~USART_CR3_DMAT;
+}
+
+static inline void LL_USART_EnableDMAReq_RX(USART_TypeDef *USARTx)
+{
+    USARTx->CR3 |= USART_CR3_DMAR;
+}
+
+static inline void LL_USART_DisableDMAReq_RX(USART_TypeDef *USARTx)
+{
+    USARTx->CR3 &= ~USART_CR3_DMAR;
+}
+
+// The address is 32 bits as on the target, the tests with the DMA of the UART are not PIE
+static inline uint32_t LL_USART_DMA_GetRegAddr(USART_TypeDef *USARTx, uint32_t Direction)
+{
+    return (LL_USART_DMA_REG_DATA_TRANSMIT == Direction) ? (uint32_t)(uintptr_t)&USARTx->TDR :
+                                                            (uint32_t)(uintptr_t)&USARTx->RDR;
+}
+
+#endif // #ifndef HOST_STM32L4XX_LL_USART_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,73 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      task.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Host replacement of the FreeRTOS task API for the host tests.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef HOST_TASK_H
+#define HOST_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum
+{
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted,
+    eInvalid
+} eTaskState;
+
+typedef struct
+{
+    TaskHandle_t xHandle;
+    const char *pcTaskName;
+    UBaseType_t xTaskNumber;
+    eTaskState eCurrentState;
+    UBaseType_t uxCurrentPriority;
+    UBaseType_t uxBasePriority;
+    uint32_t ulRunTimeCounter;
+    void *pxStackBase;
+    configSTACK_DEPTH_TYPE usStackHighWaterMark;
+} TaskStatus_t;
+
+#define taskSCHEDULER_SUSPENDED     (0)
+#define taskSCHEDULER_NOT_STARTED   (1)
+#define taskSCHEDULER_RUNNING       (2)
+
+#define taskENTER_CRITICAL()        HOST_EnterCritical()
+#define taskEXIT_CRITICAL()         HOST_ExitCritical()
+
+extern void HOST_EnterCritical(void);
+extern void HOST_ExitCritical(void);
+
+extern TickType_t xTaskGetTickCount(void);
+extern TickType_t xTaskGetTickCountFromISR(void);
+extern BaseType_t xTaskGetSchedulerState(void);
+extern void vTaskDelay(const TickType_t xTicksToDelay);
+extern void vTaskSuspend(TaskHandle_t xTask);
+extern void vTaskResume(TaskHandle_t xTask);
+extern TaskHandle_t xTaskGetCurrentTaskHandle(void);
+extern uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+extern void vTaskNotifyGiveFromISR(TaskHandle_t xTask, BaseType_t *pxHigherPriorityTaskWoken);
+extern BaseType_t xTaskNotifyGive(TaskHandle_t xTask);
+extern UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+extern void vTaskGetInfo(TaskHandle_t xTask, TaskStatus_t *pxTaskStatus,
+                         BaseType_t xGetFreeStackSpace, eTaskState eState);
+
+#endif // #ifndef HOST_TASK_H
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,348 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      bench_gsm_policy.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Month of the upload policy on the configured alarms.
+//
+//                The records come with the period of the alarm of the sensors, the upload
+//                opportunities with the period of the GSM alarm, both are taken from
+//                time_drv_cfg.h. Every opportunity asks TASK_GSM_IsUploadDue(), the session
+//                runs against the simulated modem and the mock broker. The month is made of
+//                the weeks of the good network, of the poor signal on the slow network, of
+//                the low battery and of the outage of the broker. The charge of the modem and
+//                the data latency, the time from the record to its acknowledgement, are
+//                reported per week. The charge is the modem on time by the mean current of
+//                the session, the sleep current of the modem switched off is not counted.
+//                The poor signal and the low battery double the wait of the upload, at
+//                least every other alarm is skipped.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+#include "gsm_sim.h"
+#include "time_drv_cfg.h"
+
+// Modules under test
+#include "record_manager.c"
+#include "task_GSM.c"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// UART of the modem, the baud rate gives the timeout of the transmission
+UART_HandleTypeDef UartGSMHandler;
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// Conditions of the part of the month
+typedef struct
+{
+    const char *pName;
+    uint32_t nDays;
+    uint32_t nCsq;
+    uint32_t nLatencyUs;
+    float fBatteryVoltage;
+    BOOLEAN bRefuse;
+    BOOLEAN bSkips;
+} BENCH_TYPE_PHASE;
+
+// Results of the part of the month
+typedef struct
+{
+    uint32_t nOpportunities;
+    uint32_t nSessions;
+    uint32_t nDelivered;
+    uint64_t nOnUs;
+    uint64_t nLatencySumS;
+    uint32_t nLatencyMaxS;
+} BENCH_TYPE_RESULT;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Start of the month, unix time
+#define BENCH_START_S                   (1700000000U)
+
+// Mean current of SIM800 during the session: the attach, the idle and the GPRS transfer, mA
+#define BENCH_MODEM_CURRENT_MA          (100U)
+
+#define BENCH_QTY_PHASES                (5U)
+
+static const BENCH_TYPE_PHASE BENCH_aPhase[BENCH_QTY_PHASES] =
+{
+    { "good",        7U, 20U, 300000U,  4.0F, FALSE, FALSE },
+    { "poor signal", 7U,  8U, 1000000U, 4.0F, FALSE, TRUE  },
+    { "low battery", 7U, 20U, 300000U,  3.5F, FALSE, TRUE  },
+    { "outage",      3U, 20U, 300000U,  4.0F, TRUE,  FALSE },
+    { "recovery",    6U, 20U, 300000U,  4.0F, FALSE, FALSE },
+};
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// Periods of the alarms, s
+static uint32_t BENCH_nRecordPeriodS = 0U;
+static uint32_t BENCH_nGsmPeriodS = 0U;
+
+// Records stored in the flash
+static uint32_t BENCH_nQtyStored = 0U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static uint32_t BENCH_GetAlarmPeriodS(const uint32_t nHours, const uint32_t nMinutes,
+                                      const uint32_t nSeconds, const uint32_t nMask);
+static void BENCH_StoreRecord(const uint32_t nTimeS, const float fBatteryVoltage);
+static uint32_t BENCH_GetCursor(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    GSM_SIM_CFG stCfg;
+    GSM_SIM_STAT stBefore;
+    GSM_SIM_STAT stAfter;
+    BENCH_TYPE_RESULT aResult[BENCH_QTY_PHASES];
+    BENCH_TYPE_RESULT *pResult = NULL;
+    const BENCH_TYPE_PHASE *pPhase = NULL;
+    uint32_t nNowS = BENCH_START_S;
+    uint32_t nNextRecordS = BENCH_START_S;
+    uint32_t nNextGsmS = BENCH_START_S;
+    uint32_t nEndS = BENCH_START_S;
+    uint32_t nCursor = 0U;
+    uint32_t nCursorPrev = 0U;
+    uint32_t nLatencyS = 0U;
+    uint32_t nPendingPrev = 0U;
+    BOOLEAN bOutage = FALSE;
+
+    BENCH_nRecordPeriodS = BENCH_GetAlarmPeriodS(TIME_ALARM_SENS_HOURS, TIME_ALARM_SENS_MINUTES,
+                                                 TIME_ALARM_SENS_SECONDS, TIME_ALARM_SENS_MASK);
+    BENCH_nGsmPeriodS = BENCH_GetAlarmPeriodS(TIME_ALARM_GSM_HOURS, TIME_ALARM_GSM_MINUTES,
+                                              TIME_ALARM_GSM_SECONDS, TIME_ALARM_GSM_MASK);
+    nNextGsmS += BENCH_nGsmPeriodS;
+
+    UartGSMHandler.Init.BaudRate = GSM_SIM_BAUD_RATE;
+    GSM_SIM_GetDefaultCfg(&stCfg);
+    GSM_SIM_Init(&stCfg);
+    W25Q_SIM_Init();
+    GSM_AT_DMA_TX_CHANNEL->CCR = 0U;
+    GSM_AT_DMA_TX_CHANNEL->CNDTR = 0U;
+    RECORD_MAN_xMutex = xSemaphoreCreateMutex();
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    RECORD_MAN_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+    HOST_TaskCreate(vTaskGSM, NULL);
+    memset(aResult, 0, sizeof(aResult));
+
+    for (uint32_t i = 0U; i < BENCH_QTY_PHASES; i++)
+    {
+        pPhase = &BENCH_aPhase[i];
+        pResult = &aResult[i];
+        bOutage = (TRUE == pPhase->bRefuse) ? TRUE : bOutage;
+        stCfg.nCsq = pPhase->nCsq;
+        stCfg.nLatencyUs = pPhase->nLatencyUs;
+        stCfg.bRefuse = pPhase->bRefuse;
+        GSM_SIM_SetCfg(&stCfg);
+        nEndS += pPhase->nDays * 86400U;
+
+        while (nNowS < nEndS)
+        {
+            if (nNextRecordS <= nNextGsmS)
+            {
+                nNowS = (nNowS > nNextRecordS) ? nNowS : nNextRecordS;
+                BENCH_StoreRecord(nNextRecordS, pPhase->fBatteryVoltage);
+                nNextRecordS += BENCH_nRecordPeriodS;
+            }
+            else
+            {
+                nNowS = (nNowS > nNextGsmS) ? nNowS : nNextGsmS;
+                nNextGsmS += BENCH_nGsmPeriodS;
+                pResult->nOpportunities++;
+
+                if (TRUE == TASK_GSM_IsUploadDue())
+                {
+                    GSM_SIM_GetStat(&stBefore);
+                    vTaskResume(TASK_GSM_hHandlerTask);
+                    GSM_SIM_GetStat(&stAfter);
+                    TEST_CHECK(1U == (stAfter.nPowerOn - stBefore.nPowerOn));
+                    pResult->nSessions++;
+                    pResult->nOnUs += stAfter.nOnUs - stBefore.nOnUs;
+                    nNowS += (uint32_t)((stAfter.nOnUs - stBefore.nOnUs) / 1000000U);
+
+                    // The records of the sessions are acknowledged at the end of the wakeup
+                    nCursor = BENCH_GetCursor();
+                    for (uint32_t nRecord = nCursorPrev; nRecord < nCursor; nRecord++)
+                    {
+                        nLatencyS = nNowS - (BENCH_START_S + (nRecord * BENCH_nRecordPeriodS));
+                        pResult->nLatencySumS += nLatencyS;
+                        pResult->nLatencyMaxS = (nLatencyS > pResult->nLatencyMaxS) ? nLatencyS : pResult->nLatencyMaxS;
+                    }
+                    pResult->nDelivered += nCursor - nCursorPrev;
+                    nCursorPrev = nCursor;
+
+                    // The backlog doesn't grow on the working network, it is taken by one
+                    // wakeup before the outage
+                    if (FALSE == pPhase->bRefuse)
+                    {
+                        TEST_CHECK((BENCH_nQtyStored - nCursor) <= nPendingPrev);
+                        TEST_CHECK((TRUE == bOutage) || (BENCH_nQtyStored == nCursor));
+                    }
+                    else
+                    {
+                        DoNothing();
+                    }
+                    nPendingPrev = BENCH_nQtyStored - nCursor;
+                }
+                else
+                {
+                    DoNothing();
+                }
+            }
+        }
+    }
+
+    // The backlog of the outage is taken, nothing is lost or sent twice
+    GSM_SIM_GetStat(&stAfter);
+    TEST_CHECK(nCursor == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK((BENCH_nQtyStored - nCursor) <= ((BENCH_nGsmPeriodS / BENCH_nRecordPeriodS) + 1U));
+    TEST_CHECK(0U == stAfter.nDuplicates);
+
+    bOutage = FALSE;
+    printf("bench_gsm_policy: record every %lu s, GSM alarm every %lu s, %lu records\n",
+           (unsigned long)BENCH_nRecordPeriodS, (unsigned long)BENCH_nGsmPeriodS,
+           (unsigned long)BENCH_nQtyStored);
+    for (uint32_t i = 0U; i < BENCH_QTY_PHASES; i++)
+    {
+        pResult = &aResult[i];
+        printf("bench_gsm_policy: %-11s %lu days: %2lu of %2lu alarms, modem on %5lu s, %6.1f mAh, "
+               "latency mean %5.1f h, max %5.1f h\n",
+               BENCH_aPhase[i].pName, (unsigned long)BENCH_aPhase[i].nDays,
+               (unsigned long)pResult->nSessions, (unsigned long)pResult->nOpportunities,
+               (unsigned long)(pResult->nOnUs / 1000000U),
+               (double)pResult->nOnUs * BENCH_MODEM_CURRENT_MA / 3.6e9,
+               (0U != pResult->nDelivered) ? ((double)pResult->nLatencySumS / pResult->nDelivered / 3600.0) : 0.0,
+               (double)pResult->nLatencyMaxS / 3600.0);
+
+        // The doubled wait skips the alarms, the first alarm of the part may be taken
+        if (TRUE == BENCH_aPhase[i].bSkips)
+        {
+            TEST_CHECK(pResult->nSessions <= ((pResult->nOpportunities / 2U) + 1U));
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        // The latency is limited on the working network until the outage
+        bOutage = (TRUE == BENCH_aPhase[i].bRefuse) ? TRUE : bOutage;
+        if (FALSE == bOutage)
+        {
+            TEST_CHECK(pResult->nLatencyMaxS <= (TASK_GSM_POLICY_MAX_AGE_S + BENCH_nGsmPeriodS));
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    return HOST_Result("bench_gsm_policy");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Period of the alarm set by TIME_SetAlarm(): the fields not masked are the current time plus
+// the offsets of the alarm, the alarm comes again when the first masked field changes
+static uint32_t BENCH_GetAlarmPeriodS(const uint32_t nHours, const uint32_t nMinutes,
+                                      const uint32_t nSeconds, const uint32_t nMask)
+{
+    uint32_t nPeriodS = 0U;
+
+    TEST_CHECK(0U != (nMask & RTC_ALARMMASK_DATEWEEKDAY));
+
+    if (0U != (nMask & RTC_ALARMMASK_MINUTES))
+    {
+        nPeriodS = nSeconds % 60U;
+        nPeriodS = (0U != nPeriodS) ? nPeriodS : 60U;
+    }
+    else if (0U != (nMask & RTC_ALARMMASK_HOURS))
+    {
+        nPeriodS = ((nMinutes * 60U) + nSeconds) % 3600U;
+        nPeriodS = (0U != nPeriodS) ? nPeriodS : 3600U;
+    }
+    else
+    {
+        nPeriodS = ((nHours * 3600U) + (nMinutes * 60U) + nSeconds) % 86400U;
+        nPeriodS = (0U != nPeriodS) ? nPeriodS : 86400U;
+    }
+
+    return nPeriodS;
+}
+
+// The temperature is the number of the record, it is the first field of the payload
+static void BENCH_StoreRecord(const uint32_t nTimeS, const float fBatteryVoltage)
+{
+    RECORD_MAN_TYPE_RECORD stRecord;
+    uint8_t aRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nQtyRecords = 0U;
+
+    memset(aRecord, 0, sizeof(aRecord));
+    memset(&stRecord, 0, sizeof(stRecord));
+    stRecord.nUnixTime = nTimeS;
+    stRecord.fTemperature = (float)BENCH_nQtyStored;
+    stRecord.fBatteryVoltage = fBatteryVoltage;
+    memcpy(aRecord, &stRecord, sizeof(stRecord));
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQtyRecords));
+    BENCH_nQtyStored++;
+}
+
+static uint32_t BENCH_GetCursor(void)
+{
+    uint32_t nCursor = 0U;
+
+    TEST_CHECK(RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD, (U8*)&nCursor, sizeof(nCursor)));
+
+    return nCursor;
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,181 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      bench_gsm_window.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Upload rate of the sliding window of QoS 1 on the links of high latency.
+//
+//                The file is built once per TASK_GSM_WINDOW_SIZE against the simulated modem
+//                and the mock broker. For every latency two backlogs of different size are
+//                uploaded, the rate is the difference of the records over the difference of
+//                the modem on time, so the start of the modem and the connection are not
+//                counted. The records are checked, so the benchmark is also a test of the
+//                window.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+#include "gsm_sim.h"
+
+// Modules under test
+#include "record_manager.c"
+#include "task_GSM.c"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// UART of the modem, the baud rate gives the timeout of the transmission
+UART_HandleTypeDef UartGSMHandler;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#if (TASK_GSM_MQTT_QOS_1 != TASK_GSM_MQTT_QOS)
+#error "The window is used with QoS 1 only"
+#endif
+
+// Backlogs of one latency, the records 10 min apart are older than the wait of the upload
+#define BENCH_QTY_SMALL                 (120U)
+#define BENCH_QTY_LARGE                 (BENCH_QTY_SMALL + 100U)
+
+#define BENCH_QTY_LATENCIES             (3U)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// One way latency of the network, us
+static const uint32_t BENCH_aLatencyUs[BENCH_QTY_LATENCIES] = {100000U, 300000U, 1000000U};
+
+// Records stored in the flash
+static uint32_t BENCH_nQtyStored = 0U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void BENCH_StoreRecords(const uint32_t nQty);
+static uint64_t BENCH_Upload(const uint32_t nQty);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    GSM_SIM_CFG stCfg;
+    double aRate[BENCH_QTY_LATENCIES];
+    uint64_t nSmallUs = 0U;
+    uint64_t nLargeUs = 0U;
+
+    UartGSMHandler.Init.BaudRate = GSM_SIM_BAUD_RATE;
+    GSM_SIM_GetDefaultCfg(&stCfg);
+    GSM_SIM_Init(&stCfg);
+    W25Q_SIM_Init();
+    GSM_AT_DMA_TX_CHANNEL->CCR = 0U;
+    GSM_AT_DMA_TX_CHANNEL->CNDTR = 0U;
+    RECORD_MAN_xMutex = xSemaphoreCreateMutex();
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    RECORD_MAN_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+    HOST_TaskCreate(vTaskGSM, NULL);
+
+    for (uint32_t i = 0U; i < BENCH_QTY_LATENCIES; i++)
+    {
+        stCfg.nLatencyUs = BENCH_aLatencyUs[i];
+        GSM_SIM_SetCfg(&stCfg);
+        nSmallUs = BENCH_Upload(BENCH_QTY_SMALL);
+        nLargeUs = BENCH_Upload(BENCH_QTY_LARGE);
+        TEST_CHECK(nLargeUs > nSmallUs);
+        aRate[i] = (double)(BENCH_QTY_LARGE - BENCH_QTY_SMALL) * 1e6 / (double)(nLargeUs - nSmallUs);
+    }
+
+    // The records reach the broker once in order
+    TEST_CHECK(BENCH_nQtyStored == GSM_SIM_GetQtyPayloads());
+    for (uint32_t i = 0U; i < GSM_SIM_GetQtyPayloads(); i++)
+    {
+        TEST_CHECK(((float)i == strtof(&GSM_SIM_GetPayload(i)[7], NULL)));
+    }
+
+    for (uint32_t i = 0U; i < BENCH_QTY_LATENCIES; i++)
+    {
+        printf("bench_gsm_window: window %u, latency %4lu ms: %6.2f records/s\n",
+               (unsigned)TASK_GSM_WINDOW_SIZE, (unsigned long)(BENCH_aLatencyUs[i] / 1000U), aRate[i]);
+    }
+
+    return HOST_Result("bench_gsm_window");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// The temperature is the number of the record, it is the first field of the payload
+static void BENCH_StoreRecords(const uint32_t nQty)
+{
+    RECORD_MAN_TYPE_RECORD stRecord;
+    uint8_t aRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nQtyRecords = 0U;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        memset(aRecord, 0, sizeof(aRecord));
+        memset(&stRecord, 0, sizeof(stRecord));
+        stRecord.nUnixTime = 1700000000U + (BENCH_nQtyStored * 600U);
+        stRecord.fTemperature = (float)BENCH_nQtyStored;
+        stRecord.fBatteryVoltage = 4.0f;
+        memcpy(aRecord, &stRecord, sizeof(stRecord));
+        TEST_CHECK(RESULT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQtyRecords));
+        BENCH_nQtyStored++;
+    }
+}
+
+// Modem on time of the upload of the backlog by one GSM alarm
+static uint64_t BENCH_Upload(const uint32_t nQty)
+{
+    GSM_SIM_STAT stBefore;
+    GSM_SIM_STAT stAfter;
+
+    BENCH_StoreRecords(nQty);
+    GSM_SIM_GetStat(&stBefore);
+    TEST_CHECK(TRUE == TASK_GSM_IsUploadDue());
+    vTaskResume(TASK_GSM_hHandlerTask);
+    GSM_SIM_GetStat(&stAfter);
+    TEST_CHECK(1U == (stAfter.nPowerOn - stBefore.nPowerOn));
+    TEST_CHECK(BENCH_nQtyStored == GSM_SIM_GetQtyPayloads());
+
+    return stAfter.nOnUs - stBefore.nOnUs;
+}
+
+//****************************************** end of file *******************************************
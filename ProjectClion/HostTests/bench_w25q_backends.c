@@ -0,0 +1,147 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      bench_w25q_backends.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Throughput of the SPI and QUADSPI backends of the W25Q driver.
+//
+//                The file is built once per backend against the same simulator. A 64 KB
+//                area is programmed and read back in chunks of 16, 256 and 4096 bytes. The
+//                time of the bus is computed from the clocks counted by the simulator, the
+//                time of the program includes the busy time of the chip. The data is
+//                checked, so the benchmark is also a test of the backend.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+#include "W25Q_drv.h"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// System clock of the board, Hz
+#define BENCH_SYSCLK_HZ             (80000000.0)
+
+#if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+#define BENCH_BACKEND_NAME          "QSPI"
+#define BENCH_BUS_CLK_HZ            (BENCH_SYSCLK_HZ / (W25Q_QSPI_CLOCK_PRESCALER + 1U))
+// Quad output read: 2 clocks per byte and the overhead of the command
+#define BENCH_MAX_CLK_PER_BYTE      (2.1)
+#define BENCH_MIN_CLK_PER_BYTE      (2.0)
+#else
+#define BENCH_BACKEND_NAME          "SPI"
+// SPI1 on APB2, prescaler 2
+#define BENCH_BUS_CLK_HZ            (BENCH_SYSCLK_HZ / 2.0)
+#define BENCH_MAX_CLK_PER_BYTE      (8.1)
+#define BENCH_MIN_CLK_PER_BYTE      (8.0)
+#endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+
+#define BENCH_BASE_ADR              (0x00200000UL)
+#define BENCH_AREA_BYTES            (65536UL)
+#define BENCH_QTY_CHUNKS            (3U)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static uint8_t BENCH_aPattern[BENCH_AREA_BYTES];
+static uint8_t BENCH_aData[BENCH_AREA_BYTES];
+static const uint32_t BENCH_aChunk[BENCH_QTY_CHUNKS] = {16U, 256U, 4096U};
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    W25Q_SIM_STAT stat;
+    uint64_t nStartUs = 0U;
+    double fBusUs = 0.0;
+    double fClkPerByte = 0.0;
+    STD_RESULT enResult = RESULT_OK;
+
+    W25Q_SIM_Init();
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    W25Q_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+
+    for (uint32_t i = 0U; i < BENCH_AREA_BYTES; i++)
+    {
+        BENCH_aPattern[i] = (uint8_t)((i * 7U) ^ (i >> 8U));
+    }
+
+    // Program, the driver overwrites the buffer, a copy is passed
+    memcpy(BENCH_aData, BENCH_aPattern, BENCH_AREA_BYTES);
+    W25Q_SIM_ResetStat();
+    nStartUs = HOST_nTimeUs;
+    TEST_CHECK(RESULT_OK == W25Q_WriteData(BENCH_BASE_ADR, BENCH_aData, BENCH_AREA_BYTES));
+    W25Q_SIM_GetStat(&stat);
+    fBusUs = (double)stat.nBusClocks * 1e6 / BENCH_BUS_CLK_HZ;
+    TEST_CHECK(0 == memcmp(&W25Q_SIM_GetMemory()[BENCH_BASE_ADR], BENCH_aPattern, BENCH_AREA_BYTES));
+    TEST_CHECK(0U == stat.nViolations);
+    printf("%-4s program %6lu B:        %9lu clocks, bus %8.1f us, with busy %9.1f us, %7.3f MB/s\n",
+           BENCH_BACKEND_NAME, (unsigned long)BENCH_AREA_BYTES, (unsigned long)stat.nBusClocks,
+           fBusUs, fBusUs + (double)(HOST_nTimeUs - nStartUs),
+           (double)BENCH_AREA_BYTES / (fBusUs + (double)(HOST_nTimeUs - nStartUs)));
+
+    // Reads in chunks, the page cache serves the chunks up to a line
+    for (uint32_t c = 0U; c < BENCH_QTY_CHUNKS; c++)
+    {
+        #if (ON == W25Q_CACHE_EN)
+        W25Q_ResetCache();
+        #endif // #if (ON == W25Q_CACHE_EN)
+        memset(BENCH_aData, 0, BENCH_AREA_BYTES);
+        W25Q_SIM_ResetStat();
+        enResult = RESULT_OK;
+        for (uint32_t nAdr = 0U; nAdr < BENCH_AREA_BYTES; nAdr += BENCH_aChunk[c])
+        {
+            if (RESULT_OK != W25Q_ReadData(BENCH_BASE_ADR + nAdr, &BENCH_aData[nAdr], BENCH_aChunk[c]))
+            {
+                enResult = RESULT_NOT_OK;
+            }
+        }
+        W25Q_SIM_GetStat(&stat);
+        fBusUs = (double)stat.nBusClocks * 1e6 / BENCH_BUS_CLK_HZ;
+        fClkPerByte = (double)stat.nBusClocks / (double)BENCH_AREA_BYTES;
+        TEST_CHECK(RESULT_OK == enResult);
+        TEST_CHECK(0 == memcmp(BENCH_aData, BENCH_aPattern, BENCH_AREA_BYTES));
+        TEST_CHECK(0U == stat.nViolations);
+        printf("%-4s read %6lu B by %4lu: %9lu clocks, bus %8.1f us, %5.2f clk/B, %7.3f MB/s\n",
+               BENCH_BACKEND_NAME, (unsigned long)BENCH_AREA_BYTES, (unsigned long)BENCH_aChunk[c],
+               (unsigned long)stat.nBusClocks, fBusUs, fClkPerByte,
+               (double)BENCH_AREA_BYTES / fBusUs);
+    }
+
+    // The long reads bypass the cache, the cost is the data phase and the command
+    TEST_CHECK(fClkPerByte >= BENCH_MIN_CLK_PER_BYTE);
+    TEST_CHECK(fClkPerByte <= BENCH_MAX_CLK_PER_BYTE);
+
+    return HOST_Result("bench_w25q_" BENCH_BACKEND_NAME);
+}
+
+//****************************************** end of file *******************************************
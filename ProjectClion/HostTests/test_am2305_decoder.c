@@ -0,0 +1,405 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_am2305_decoder.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the streaming decoder of the AM2305 and of the DMA capture.
+//
+//                The edge timings are made as the sensor sends them, with the jitter of every
+//                pulse. The decoder must return the values of the frame for any jitter inside
+//                AM2305_TIME_TOLERANCE_US, reject the wrong parity, and never return wrong
+//                values when the jitter is bigger, an edge is missing, a glitch adds two edges
+//                or the trace is cut. The same traces run through AM2305_GetHumidityTemperature()
+//                with the timer and the DMA of the simulator.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "am2305_sim.h"
+
+#include "am2305_drv.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#define TEST_MAX_EDGES                  (AM2305_SIM_QTY_EDGES + 4U)
+#define TEST_RANDOM_FRAMES              (2000U)
+// Jitter out of the tolerance, us
+#define TEST_BIG_JITTER_US              (15U)
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Frame(const uint16_t nHumidity, const int16_t nTemperature, uint8_t *const pData);
+static STD_RESULT TEST_Decode(const uint32_t *const pEdgeUs, const uint32_t nQty,
+                              float *const pHumidity, float *const pTemperature);
+static BOOLEAN TEST_IsFrame(const uint8_t *const pData, const float humidity, const float temperature);
+static void TEST_Streaming(void);
+static void TEST_Tolerance(void);
+static void TEST_Capture(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    uint8_t aData[AM2305_QTY_DATA_BYTES];
+    uint32_t aEdge[TEST_MAX_EDGES];
+    uint32_t aCut[TEST_MAX_EDGES];
+    uint32_t nQty = 0U;
+    uint32_t nRejected = 0U;
+    uint32_t nWrong = 0U;
+    float humidity = 0.0f;
+    float temperature = 0.0f;
+
+    srand(1U);
+
+    // Nominal timings: positive, negative temperature, parity with the carry
+    TEST_Frame(653U, 237, aData);
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    TEST_CHECK(AM2305_SIM_QTY_EDGES == nQty);
+    TEST_CHECK(RESULT_OK == TEST_Decode(aEdge, nQty, &humidity, &temperature));
+    TEST_CHECK((65.3f == humidity) && (23.7f == temperature));
+
+    TEST_Frame(1000U, -101, aData);
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    TEST_CHECK(RESULT_OK == TEST_Decode(aEdge, nQty, &humidity, &temperature));
+    TEST_CHECK((100.0f == humidity) && (-10.1f == temperature));
+
+    TEST_Frame(999U, 500, aData);
+    TEST_CHECK(0xDFU == aData[4]);
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    TEST_CHECK(RESULT_OK == TEST_Decode(aEdge, nQty, &humidity, &temperature));
+    TEST_CHECK(TRUE == TEST_IsFrame(aData, humidity, temperature));
+
+    // Wrong parity, one bit of the data flipped
+    TEST_Frame(653U, 237, aData);
+    aData[4]++;
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    TEST_CHECK(RESULT_NOT_OK == TEST_Decode(aEdge, nQty, &humidity, &temperature));
+    TEST_Frame(653U, 237, aData);
+    aData[2] ^= 0x10U;
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    TEST_CHECK(RESULT_NOT_OK == TEST_Decode(aEdge, nQty, &humidity, &temperature));
+
+    // Host release time of the datasheet, 20..200 us
+    TEST_Frame(411U, -5, aData);
+    for (uint32_t nGoUs = 20U; nGoUs <= 200U; nGoUs++)
+    {
+        nQty = AM2305_SIM_MakeTrace(aData, nGoUs, 0U, aEdge);
+        if ((RESULT_OK != TEST_Decode(aEdge, nQty, &humidity, &temperature)) ||
+            (FALSE == TEST_IsFrame(aData, humidity, temperature)))
+        {
+            printf("T_GO %lu us: not decoded\n", (unsigned long)nGoUs);
+            nWrong++;
+        }
+    }
+    TEST_CHECK(0U == nWrong);
+
+    // Jitter inside the tolerance: every frame is decoded
+    nWrong = 0U;
+    for (uint32_t i = 0U; i < TEST_RANDOM_FRAMES; i++)
+    {
+        TEST_Frame((uint16_t)(rand() % 1001), (int16_t)((rand() % 1250) - 400), aData);
+        nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, AM2305_TIME_TOLERANCE_US, aEdge);
+        if ((RESULT_OK != TEST_Decode(aEdge, nQty, &humidity, &temperature)) ||
+            (FALSE == TEST_IsFrame(aData, humidity, temperature)))
+        {
+            nWrong++;
+        }
+    }
+    TEST_CHECK(0U == nWrong);
+
+    // Jitter out of the tolerance: rejected or right, never wrong values
+    nWrong = 0U;
+    for (uint32_t i = 0U; i < TEST_RANDOM_FRAMES; i++)
+    {
+        TEST_Frame((uint16_t)(rand() % 1001), (int16_t)((rand() % 1250) - 400), aData);
+        nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, TEST_BIG_JITTER_US, aEdge);
+        if (RESULT_OK != TEST_Decode(aEdge, nQty, &humidity, &temperature))
+        {
+            nRejected++;
+        }
+        else if (FALSE == TEST_IsFrame(aData, humidity, temperature))
+        {
+            nWrong++;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    TEST_CHECK(0U == nWrong);
+    TEST_CHECK(0U != nRejected);
+
+    // A missing edge merges two pulses. Only the last edge, the release of the bus after the
+    // data, can be lost without an error.
+    nWrong = 0U;
+    TEST_Frame(653U, 237, aData);
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    for (uint32_t nMissing = 0U; nMissing < nQty; nMissing++)
+    {
+        const uint32_t nCutQty = nQty - 1U;
+        STD_RESULT result = RESULT_NOT_OK;
+
+        memcpy(aCut, aEdge, nMissing * sizeof(aEdge[0]));
+        memcpy(&aCut[nMissing], &aEdge[nMissing + 1U], (nCutQty - nMissing) * sizeof(aEdge[0]));
+        result = TEST_Decode(aCut, nCutQty, &humidity, &temperature);
+
+        if ((nMissing + 1U) == nQty)
+        {
+            TEST_CHECK((RESULT_OK == result) && (TRUE == TEST_IsFrame(aData, humidity, temperature)));
+        }
+        else if (RESULT_OK == result)
+        {
+            printf("missing edge %lu: decoded\n", (unsigned long)nMissing);
+            nWrong++;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    TEST_CHECK(0U == nWrong);
+
+    // A glitch of 2 us in every pulse of the data
+    nWrong = 0U;
+    for (uint32_t nPulse = 2U; (nPulse + 2U) < nQty; nPulse++)
+    {
+        memcpy(aCut, aEdge, (nPulse + 1U) * sizeof(aEdge[0]));
+        aCut[nPulse + 1U] = aEdge[nPulse] + 10U;
+        aCut[nPulse + 2U] = aEdge[nPulse] + 12U;
+        memcpy(&aCut[nPulse + 3U], &aEdge[nPulse + 1U], (nQty - nPulse - 1U) * sizeof(aEdge[0]));
+        if (RESULT_OK == TEST_Decode(aCut, nQty + 2U, &humidity, &temperature))
+        {
+            nWrong++;
+        }
+    }
+    TEST_CHECK(0U == nWrong);
+
+    // Cut trace: the end of the measurement window before the last bit
+    for (uint32_t nCutQty = 0U; nCutQty < (nQty - 1U); nCutQty++)
+    {
+        TEST_CHECK(RESULT_NOT_OK == TEST_Decode(aEdge, nCutQty, &humidity, &temperature));
+    }
+
+    TEST_Streaming();
+    TEST_Tolerance();
+    TEST_Capture();
+
+    return HOST_Result("test_am2305_decoder");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Frame of the sensor: humidity and temperature x10, sign and magnitude, parity
+static void TEST_Frame(const uint16_t nHumidity, const int16_t nTemperature, uint8_t *const pData)
+{
+    const uint16_t nT = (nTemperature < 0) ? (uint16_t)(0x8000U | (uint16_t)(-nTemperature)) :
+                                             (uint16_t)nTemperature;
+
+    pData[0] = (uint8_t)(nHumidity >> 8);
+    pData[1] = (uint8_t)nHumidity;
+    pData[2] = (uint8_t)(nT >> 8);
+    pData[3] = (uint8_t)nT;
+    pData[4] = (uint8_t)(pData[0] + pData[1] + pData[2] + pData[3]);
+}
+
+// Durations between the edges as the driver gets them from the captures
+static STD_RESULT TEST_Decode(const uint32_t *const pEdgeUs, const uint32_t nQty,
+                              float *const pHumidity, float *const pTemperature)
+{
+    uint16_t aDuration[TEST_MAX_EDGES + 2U];
+    uint16_t nOld = 0U;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        aDuration[i] = (uint16_t)((uint16_t)pEdgeUs[i] - nOld);
+        nOld = (uint16_t)pEdgeUs[i];
+    }
+
+    return AM2305_Decode(aDuration, nQty, pHumidity, pTemperature);
+}
+
+static BOOLEAN TEST_IsFrame(const uint8_t *const pData, const float humidity, const float temperature)
+{
+    const uint16_t nH = (uint16_t)(((uint16_t)pData[0] << 8) | pData[1]);
+    const uint16_t nT = (uint16_t)(((uint16_t)pData[2] << 8) | pData[3]);
+    float t = (float)(nT & 0x7FFFU) / 10;
+
+    t = (0U != (nT & 0x8000U)) ? -t : t;
+
+    return (((float)nH / 10 == humidity) && (t == temperature)) ? TRUE : FALSE;
+}
+
+// The decoder is busy up to the last bit, then the status and the result don't change
+static void TEST_Streaming(void)
+{
+    uint8_t aData[AM2305_QTY_DATA_BYTES];
+    uint32_t aEdge[TEST_MAX_EDGES];
+    uint32_t nQty = 0U;
+    uint32_t nOld = 0U;
+    AM2305_DECODER stDecoder;
+    AM2305_DECODE_STATUS enStatus = AM2305_DECODE_BUSY;
+    BOOLEAN bBusy = TRUE;
+    float humidity = 0.0f;
+    float temperature = 0.0f;
+
+    TEST_Frame(653U, 237, aData);
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+
+    AM2305_DecoderReset(&stDecoder);
+    // The last bit ends by the edge before the release of the bus
+    for (uint32_t i = 0U; i < (nQty - 1U); i++)
+    {
+        enStatus = AM2305_DecoderPush(&stDecoder, (uint16_t)(aEdge[i] - nOld));
+        nOld = aEdge[i];
+        if (((i + 2U) < nQty) && (AM2305_DECODE_BUSY != enStatus))
+        {
+            bBusy = FALSE;
+        }
+    }
+    TEST_CHECK(TRUE == bBusy);
+    TEST_CHECK(AM2305_DECODE_DONE == enStatus);
+
+    // The end of the data and noise after it are ignored
+    TEST_CHECK(AM2305_DECODE_DONE == AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_EN_US));
+    TEST_CHECK(AM2305_DECODE_DONE == AM2305_DecoderPush(&stDecoder, 3U));
+    TEST_CHECK(AM2305_DECODE_DONE == AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_H1_US));
+    TEST_CHECK(RESULT_OK == AM2305_DecoderGetResult(&stDecoder, &humidity, &temperature));
+    TEST_CHECK((65.3f == humidity) && (23.7f == temperature));
+
+    // The error stays
+    AM2305_DecoderReset(&stDecoder);
+    TEST_CHECK(AM2305_DECODE_BUSY == AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_GO_US));
+    TEST_CHECK(AM2305_DECODE_BUSY == AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_REL_US));
+    TEST_CHECK(AM2305_DECODE_ERROR == AM2305_DecoderPush(&stDecoder, 200U));
+    TEST_CHECK(AM2305_DECODE_ERROR == AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_REH_US));
+    TEST_CHECK(RESULT_NOT_OK == AM2305_DecoderGetResult(&stDecoder, &humidity, &temperature));
+}
+
+// Bounds of the windows of the datasheet widened by the tolerance
+static void TEST_Tolerance(void)
+{
+    const uint16_t aBit[][2] =
+    {
+        // High time, expected status: 0 - bit 0, 1 - bit 1, 2 - error
+        {22U - AM2305_TIME_TOLERANCE_US, 0U},
+        {22U - AM2305_TIME_TOLERANCE_US - 1U, 2U},
+        {30U + AM2305_TIME_TOLERANCE_US, 0U},
+        {30U + AM2305_TIME_TOLERANCE_US + 1U, 2U},
+        {68U - AM2305_TIME_TOLERANCE_US, 1U},
+        {68U - AM2305_TIME_TOLERANCE_US - 1U, 2U},
+        {75U + AM2305_TIME_TOLERANCE_US, 1U},
+        {75U + AM2305_TIME_TOLERANCE_US + 1U, 2U},
+    };
+    AM2305_DECODER stDecoder;
+    AM2305_DECODE_STATUS enStatus = AM2305_DECODE_BUSY;
+
+    for (uint32_t i = 0U; i < (sizeof(aBit) / sizeof(aBit[0])); i++)
+    {
+        AM2305_DecoderReset(&stDecoder);
+        (void)AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_GO_US);
+        (void)AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_REL_US);
+        (void)AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_REH_US);
+        (void)AM2305_DecoderPush(&stDecoder, AM2305_SIM_T_LOW_US);
+        enStatus = AM2305_DecoderPush(&stDecoder, aBit[i][0]);
+
+        if (2U == aBit[i][1])
+        {
+            TEST_CHECK(AM2305_DECODE_ERROR == enStatus);
+        }
+        else
+        {
+            TEST_CHECK((AM2305_DECODE_BUSY == enStatus) &&
+                       (1U == stDecoder.nBit) &&
+                       ((aBit[i][1] << 7) == stDecoder.aData[0]));
+        }
+    }
+}
+
+// The same traces by the timer capture and the DMA
+static void TEST_Capture(void)
+{
+    uint8_t aData[AM2305_QTY_DATA_BYTES];
+    uint32_t aEdge[TEST_MAX_EDGES];
+    uint32_t nQty = 0U;
+    uint64_t nStartUs = 0U;
+    float humidity = 0.0f;
+    float temperature = 0.0f;
+    AM2305_SIM_STAT stat;
+
+    AM2305_SIM_Init();
+    AM2305_Init();
+
+    // Good frame with the jitter
+    TEST_Frame(482U, -37, aData);
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, AM2305_TIME_TOLERANCE_US, aEdge);
+    AM2305_SIM_SetTrace(aEdge, nQty);
+    nStartUs = HOST_nTimeUs;
+    TEST_CHECK(RESULT_OK == AM2305_GetHumidityTemperature(&humidity, &temperature));
+    TEST_CHECK((48.2f == humidity) && (-3.7f == temperature));
+    AM2305_SIM_GetStat(&stat);
+    TEST_CHECK((1U == stat.nStarts) && (nQty == stat.nCaptured) && (0U == stat.nLost));
+    // Start signal and one timer period, the update interrupt wakes the task
+    TEST_CHECK((HOST_nTimeUs - nStartUs) <= (2000U + 6000U + HOST_WAIT_STEP_US));
+
+    // Wrong parity
+    aData[4] ^= 0x01U;
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    AM2305_SIM_SetTrace(aEdge, nQty);
+    TEST_CHECK(RESULT_NOT_OK == AM2305_GetHumidityTemperature(&humidity, &temperature));
+
+    // Missing edge in the middle of the data
+    aData[4] ^= 0x01U;
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    memmove(&aEdge[40], &aEdge[41], (nQty - 41U) * sizeof(aEdge[0]));
+    AM2305_SIM_SetTrace(aEdge, nQty - 1U);
+    TEST_CHECK(RESULT_NOT_OK == AM2305_GetHumidityTemperature(&humidity, &temperature));
+
+    // The next measurement is good again
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    AM2305_SIM_SetTrace(aEdge, nQty);
+    TEST_CHECK(RESULT_OK == AM2305_GetHumidityTemperature(&humidity, &temperature));
+    TEST_CHECK((48.2f == humidity) && (-3.7f == temperature));
+
+    // No sensor
+    AM2305_SIM_SetTrace(aEdge, 0U);
+    nStartUs = HOST_nTimeUs;
+    TEST_CHECK(RESULT_NOT_OK == AM2305_GetHumidityTemperature(&humidity, &temperature));
+    TEST_CHECK((HOST_nTimeUs - nStartUs) <= (2000U + 6000U + HOST_WAIT_STEP_US));
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,184 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_anemometer_pulse.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the pulse anemometer.
+//
+//                The pulses are added to the counter of LPTIM1, the wake up timer of RTC is
+//                its interrupt called at the end of every gust window with the time of RTC
+//                moved by the window. The mean and the gust are checked after a long sleep
+//                with one strong window, over the wrap of the 16-bit counter, with the window
+//                open at the call and on the interval shorter than the window.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+
+#include "anemometer_drv.h"
+#include "stm32l4xx_ll_rtc.h"
+#include "stm32l4xx_ll_exti.h"
+#include "time_drv.h"
+
+#include <math.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Counter before the start, it wraps in the first interval
+#define TEST_START_COUNT                (0xFF00U)
+
+// Sleep between the measurements: windows of the calm wind and one strong window
+#define TEST_QTY_SLEEP_WINDOWS          (200U)
+#define TEST_CALM_PULSES                (6U)
+#define TEST_STRONG_WINDOW              (120U)
+#define TEST_STRONG_PULSES              (30U)
+
+// Error of the float result, m/s
+#define TEST_MAX_ERROR                  (0.001f)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// Time of RTC, ms
+static U32 TEST_nTimeMs = 5000U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Pulses(const uint32_t nPulses, const uint32_t nTimeMs);
+static void TEST_Window(const uint32_t nPulses);
+static float TEST_Speed(const uint32_t nPulses, const uint32_t nTimeMs);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    float fMean = 0.0f;
+    float fGust = 0.0f;
+    uint32_t nPulses = 0U;
+
+    LPTIM1->CNT = TEST_START_COUNT;
+    ANEMOMETER_Init();
+
+    // The wake up timer interrupts every gust window from RTCCLK / 16
+    TEST_CHECK(0xFFFFU == LPTIM1->ARR);
+    TEST_CHECK(((ANEMOMETER_GUST_WINDOW_MS * 2048U) / 1000U - 1U) == RTC->ARR);
+    TEST_CHECK((RTC_CR_WUTE | RTC_CR_WUTIE) == (RTC->CR1 & (RTC_CR_WUTE | RTC_CR_WUTIE)));
+    TEST_CHECK(LL_RTC_WAKEUPCLOCK_DIV_16 == (RTC->CR1 & RTC_CR_WUCKSEL));
+    TEST_CHECK(0U == RTC->CCR1);
+    TEST_CHECK(0U != (EXTI->CR1 & ANEMOMETER_WINDOW_EXTI_LINE));
+    TEST_CHECK(0U != (EXTI->CR2 & ANEMOMETER_WINDOW_EXTI_LINE));
+
+    // No time has passed
+    TEST_CHECK(RESULT_NOT_OK == ANEMOMETER_GetWind(&fMean, &fGust));
+
+    // Sleep over the wrap of the counter, the 43rd window wraps from 0xFFFC to 0x0002: the gust is
+    // the strong window, not the mean
+    for (uint32_t nWindow = 0U; nWindow < TEST_QTY_SLEEP_WINDOWS; nWindow++)
+    {
+        TEST_Window((TEST_STRONG_WINDOW == nWindow) ? TEST_STRONG_PULSES : TEST_CALM_PULSES);
+        nPulses += (TEST_STRONG_WINDOW == nWindow) ? TEST_STRONG_PULSES : TEST_CALM_PULSES;
+    }
+    TEST_CHECK(LPTIM1->CNT < TEST_START_COUNT);
+    TEST_CHECK(0U == (RTC->ISR & RTC_ISR_WUTF));
+    TEST_CHECK(RESULT_OK == ANEMOMETER_GetWind(&fMean, &fGust));
+    TEST_CHECK(fabsf(TEST_Speed(nPulses, TEST_QTY_SLEEP_WINDOWS * ANEMOMETER_GUST_WINDOW_MS) - fMean) < TEST_MAX_ERROR);
+    TEST_CHECK(fabsf(TEST_Speed(TEST_STRONG_PULSES, ANEMOMETER_GUST_WINDOW_MS) - fGust) < TEST_MAX_ERROR);
+
+    // The window open at the call: its pulses are in the mean of both intervals, the window in
+    // the gust of the next one. The closed window is weaker than the mean, the gust is the mean.
+    TEST_Window(3U);
+    TEST_Pulses(15U, ANEMOMETER_GUST_WINDOW_MS / 2U);
+    TEST_CHECK(RESULT_OK == ANEMOMETER_GetWind(&fMean, &fGust));
+    TEST_CHECK(fabsf(TEST_Speed(18U, ANEMOMETER_GUST_WINDOW_MS + (ANEMOMETER_GUST_WINDOW_MS / 2U)) - fMean) < TEST_MAX_ERROR);
+    TEST_CHECK(fMean == fGust);
+    TEST_Pulses(3U, ANEMOMETER_GUST_WINDOW_MS / 2U);
+    TEST_Window(0U);
+    TEST_CHECK(RESULT_OK == ANEMOMETER_GetWind(&fMean, &fGust));
+    TEST_CHECK(fabsf(TEST_Speed(3U, ANEMOMETER_GUST_WINDOW_MS / 2U) - fMean) < TEST_MAX_ERROR);
+    TEST_CHECK(fabsf(TEST_Speed(18U, ANEMOMETER_GUST_WINDOW_MS) - fGust) < TEST_MAX_ERROR);
+
+    // The interval shorter than the window: the gust is the mean
+    TEST_Pulses(4U, 1000U);
+    TEST_CHECK(RESULT_OK == ANEMOMETER_GetWind(&fMean, &fGust));
+    TEST_CHECK(fabsf(TEST_Speed(4U, 1000U) - fMean) < TEST_MAX_ERROR);
+    TEST_CHECK(fMean == fGust);
+
+    TEST_CHECK(0U == HOST_nCriticalDepth);
+
+    return HOST_Result("test_anemometer_pulse");
+}
+
+// Time of RTC for the mean
+U32 TIME_GetTimeMs(void)
+{
+    return TEST_nTimeMs;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Pulses counted by LPTIM1 over the time
+static void TEST_Pulses(const uint32_t nPulses, const uint32_t nTimeMs)
+{
+    LPTIM1->CNT = (LPTIM1->CNT + nPulses) & 0xFFFFU;
+    TEST_nTimeMs += nTimeMs;
+}
+
+// Rest of the gust window up to its interrupt
+static void TEST_Window(const uint32_t nPulses)
+{
+    static U32 nEndMs = 0U;
+
+    if (0U == nEndMs)
+    {
+        nEndMs = TEST_nTimeMs;
+    }
+    nEndMs += ANEMOMETER_GUST_WINDOW_MS;
+    TEST_Pulses(nPulses, nEndMs - TEST_nTimeMs);
+
+    RTC->ISR |= RTC_ISR_WUTF;
+    EXTI->ISR |= ANEMOMETER_WINDOW_EXTI_LINE;
+    ANEMOMETER_WINDOW_IRQHandler();
+    TEST_CHECK(0U == (EXTI->ISR & ANEMOMETER_WINDOW_EXTI_LINE));
+}
+
+// Wind speed of the pulses over the time
+static float TEST_Speed(const uint32_t nPulses, const uint32_t nTimeMs)
+{
+    return (((float)nPulses * 1000.0f) / (float)nTimeMs) * ANEMOMETER_SPEED_PER_HZ;
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,245 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_anemometer_window.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the mean wind speed and gust of the window of the analog anemometer.
+//
+//                The samples are interleaved with the battery channel as the ADC sequence
+//                stores them. The mean is checked on the constant wind, on the ramp and on the
+//                spikes at the ends of the window, the gust on the running mean of 1 and of 3
+//                samples, the short and the empty windows. The random windows are compared
+//                with the reference in double.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+
+#include "anemometer_drv.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Sequence of the ADC: battery, anemometer
+#define TEST_QTY_CH                     (2U)
+#define TEST_BAT_COUNT                  (1023U)
+
+// Wind speed of one count, m/s
+#define TEST_SPEED_PER_COUNT            (0.0886f)
+
+#define TEST_MAX_QTY_SAMPLES            (1000U)
+#define TEST_LONG_QTY_SAMPLES           (100000U)
+#define TEST_RANDOM_WINDOWS             (2000U)
+
+// Relative error of the float result
+#define TEST_REL_ERROR                  (1.0e-5)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static uint32_t TEST_aSequence[TEST_LONG_QTY_SAMPLES * TEST_QTY_CH];
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_SetSamples(const uint32_t *const pCounts, const uint32_t nQty);
+static STD_RESULT TEST_GetWind(const uint32_t nQty, const uint32_t nQtyGust, float *const pMean, float *const pGust);
+static BOOLEAN TEST_IsNear(const float fValue, const double dExpected);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    uint32_t aCounts[TEST_MAX_QTY_SAMPLES];
+    float fMean = 0.0f;
+    float fGust = 0.0f;
+    uint32_t nSample = 0U;
+    uint32_t nWindow = 0U;
+    uint32_t nQty = 0U;
+    uint32_t nQtyGust = 0U;
+    uint32_t nWrong = 0U;
+    double dSum = 0.0;
+    double dGustSum = 0.0;
+    double dMaxGust = 0.0;
+
+    // Constant wind: the mean and the gust are the same for any gust
+    for (nSample = 0U; nSample < 10U; nSample++)
+    {
+        aCounts[nSample] = 500U;
+    }
+    TEST_SetSamples(aCounts, 10U);
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 1U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fMean, 500.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 500.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 3U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 500.0 * TEST_SPEED_PER_COUNT));
+
+    // Spike in the middle: the gust of 1 sample is the spike, of 3 samples is the running mean
+    for (nSample = 0U; nSample < 10U; nSample++)
+    {
+        aCounts[nSample] = 100U;
+    }
+    aCounts[4] = 700U;
+    TEST_SetSamples(aCounts, 10U);
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 1U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fMean, 160.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 700.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 3U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fMean, 160.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 300.0 * TEST_SPEED_PER_COUNT));
+
+    // Spikes at the ends of the window are in the gust
+    aCounts[4] = 100U;
+    aCounts[0] = 400U;
+    TEST_SetSamples(aCounts, 10U);
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 3U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 200.0 * TEST_SPEED_PER_COUNT));
+    aCounts[0] = 100U;
+    aCounts[9] = 1000U;
+    TEST_SetSamples(aCounts, 10U);
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 3U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 400.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(TRUE == TEST_IsNear(fMean, 190.0 * TEST_SPEED_PER_COUNT));
+
+    // Ramp: the gust is the mean of the last samples
+    for (nSample = 0U; nSample < 10U; nSample++)
+    {
+        aCounts[nSample] = nSample * 10U;
+    }
+    TEST_SetSamples(aCounts, 10U);
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 3U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fMean, 45.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 80.0 * TEST_SPEED_PER_COUNT));
+
+    // Window shorter than the gust: the gust is the mean
+    TEST_CHECK(RESULT_OK == TEST_GetWind(2U, 3U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fMean, 5.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, 5.0 * TEST_SPEED_PER_COUNT));
+
+    // Calm: zero wind
+    for (nSample = 0U; nSample < 10U; nSample++)
+    {
+        aCounts[nSample] = 0U;
+    }
+    TEST_SetSamples(aCounts, 10U);
+    TEST_CHECK(RESULT_OK == TEST_GetWind(10U, 3U, &fMean, &fGust));
+    TEST_CHECK((0.0f == fMean) && (0.0f == fGust));
+
+    // No samples: the results are not changed
+    fMean = -1.0f;
+    fGust = -1.0f;
+    TEST_CHECK(RESULT_NOT_OK == TEST_GetWind(0U, 3U, &fMean, &fGust));
+    TEST_CHECK(RESULT_NOT_OK == TEST_GetWind(10U, 0U, &fMean, &fGust));
+    TEST_CHECK(RESULT_NOT_OK == ANEMOMETER_GetWindOfSamples(&TEST_aSequence[1], 0U, 10U, 3U,
+                                                            TEST_SPEED_PER_COUNT, &fMean, &fGust));
+    TEST_CHECK((-1.0f == fMean) && (-1.0f == fGust));
+
+    // Random windows against the reference
+    srand(39U);
+    for (nWindow = 0U; nWindow < TEST_RANDOM_WINDOWS; nWindow++)
+    {
+        nQty = 1U + ((uint32_t)rand() % TEST_MAX_QTY_SAMPLES);
+        nQtyGust = 1U + ((uint32_t)rand() % 10U);
+        dSum = 0.0;
+        dGustSum = 0.0;
+        dMaxGust = 0.0;
+        for (nSample = 0U; nSample < nQty; nSample++)
+        {
+            aCounts[nSample] = (uint32_t)rand() % (TEST_BAT_COUNT + 1U);
+            dSum += (double)aCounts[nSample];
+            dGustSum += (double)aCounts[nSample];
+            if (nSample >= nQtyGust)
+            {
+                dGustSum -= (double)aCounts[nSample - nQtyGust];
+            }
+            if (((nSample + 1U) >= nQtyGust) && (dGustSum > dMaxGust))
+            {
+                dMaxGust = dGustSum;
+            }
+        }
+        dSum = (dSum * TEST_SPEED_PER_COUNT) / (double)nQty;
+        dMaxGust = (nQty >= nQtyGust) ? ((dMaxGust * TEST_SPEED_PER_COUNT) / (double)nQtyGust) : dSum;
+
+        TEST_SetSamples(aCounts, nQty);
+        if ((RESULT_OK != TEST_GetWind(nQty, nQtyGust, &fMean, &fGust)) ||
+            (FALSE == TEST_IsNear(fMean, dSum)) ||
+            (FALSE == TEST_IsNear(fGust, dMaxGust)) ||
+            (fGust < fMean))
+        {
+            nWrong++;
+        }
+    }
+    TEST_CHECK(0U == nWrong);
+
+    // Long window of the full scale: the sums are exact
+    for (nSample = 0U; nSample < TEST_LONG_QTY_SAMPLES; nSample++)
+    {
+        TEST_aSequence[nSample * TEST_QTY_CH] = 0U;
+        TEST_aSequence[(nSample * TEST_QTY_CH) + 1U] = ((nSample % 2U) == 0U) ? TEST_BAT_COUNT : 1U;
+    }
+    TEST_CHECK(RESULT_OK == TEST_GetWind(TEST_LONG_QTY_SAMPLES, 3U, &fMean, &fGust));
+    TEST_CHECK(TRUE == TEST_IsNear(fMean, 512.0 * TEST_SPEED_PER_COUNT));
+    TEST_CHECK(TRUE == TEST_IsNear(fGust, (2047.0 / 3.0) * TEST_SPEED_PER_COUNT));
+
+    return HOST_Result("test_anemometer_window");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Sequences of the ADC: the battery channel and the anemometer channel
+static void TEST_SetSamples(const uint32_t *const pCounts, const uint32_t nQty)
+{
+    for (uint32_t nSample = 0U; nSample < nQty; nSample++)
+    {
+        TEST_aSequence[nSample * TEST_QTY_CH] = TEST_BAT_COUNT;
+        TEST_aSequence[(nSample * TEST_QTY_CH) + 1U] = pCounts[nSample];
+    }
+}
+
+static STD_RESULT TEST_GetWind(const uint32_t nQty, const uint32_t nQtyGust, float *const pMean, float *const pGust)
+{
+    return ANEMOMETER_GetWindOfSamples(&TEST_aSequence[1], TEST_QTY_CH, nQty, nQtyGust,
+                                       TEST_SPEED_PER_COUNT, pMean, pGust);
+}
+
+static BOOLEAN TEST_IsNear(const float fValue, const double dExpected)
+{
+    return (fabs((double)fValue - dExpected) <= (TEST_REL_ERROR * (fabs(dExpected) + 1.0))) ? TRUE : FALSE;
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,295 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_bmp2_compensation.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Accuracy of the double and the 64-bit integer compensation of the BMP280.
+//
+//                The file is built once per compensation of bmp2.c. The calibrations are the
+//                example of the datasheet and random sets around it, every coefficient within
+//                +-25 %. The ADC values of the temperature and the pressure are swept over the
+//                whole 20-bit range, the points out of -40..85 degC and 300..1100 hPa are
+//                skipped. The result is compared with the formulas of the datasheet in long
+//                double without the rounding of t_fine. The pressure is also checked after the
+//                conversion to the integer of the record. The time of the compensation is not
+//                measured: the time of the host says nothing of the Cortex-M4F.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "compiler.h"
+#include "general_types.h"
+#include "bmp2.h"
+#include "record_manager_cfg.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#ifdef BMP2_64BIT_COMPENSATION
+#define TEST_NAME                  "int64"
+// Pressure Pa x 256, temperature centi-degC
+#define TEST_PRESSURE_PA(p)        ((long double)(p) / 256.0L)
+#define TEST_TEMPERATURE_C(t)      ((long double)(t) / 100.0L)
+#define TEST_RECORD_PA(p)          ((long double)(((uint32_t)(p) * RECORD_MAN_PRESSURE_SCALE) >> 8U) / \
+                                     (long double)RECORD_MAN_PRESSURE_SCALE)
+// Resolution 0.01 degC and 1/256 Pa, the truncated divisions of the formulas add ~0.01 degC and
+// ~0.5 Pa
+#define TEST_MAX_ERROR_C           (0.02L)
+#define TEST_MAX_ERROR_PA          (1.0L)
+#else
+#define TEST_NAME                  "double"
+#define TEST_PRESSURE_PA(p)        ((long double)(p))
+#define TEST_TEMPERATURE_C(t)      ((long double)(t))
+#define TEST_RECORD_PA(p)          ((long double)(uint32_t)((p) * RECORD_MAN_PRESSURE_SCALE) / \
+                                     (long double)RECORD_MAN_PRESSURE_SCALE)
+// The pressure gets t_fine truncated to an integer
+#define TEST_MAX_ERROR_C           (0.0002L)
+#define TEST_MAX_ERROR_PA          (0.05L)
+#endif // #ifdef BMP2_64BIT_COMPENSATION
+
+// The record keeps 0.01 Pa, truncated
+#define TEST_MAX_RECORD_ERROR_PA   (TEST_MAX_ERROR_PA + 0.01L)
+
+#define TEST_QTY_CALIB             (64U)
+#define TEST_ADC_STEP              (0x0FF1)
+#define TEST_SPREAD                (0.25)
+
+// Range of the sensor, the bounds are cut by the error of the paths, so no result is clamped
+#define TEST_MIN_C                 (-40.0L + 0.1L)
+#define TEST_MAX_C                 (85.0L - 0.1L)
+#define TEST_MIN_PA                (30000.0L + 10.0L)
+#define TEST_MAX_PA                (110000.0L - 10.0L)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// Calibration of the datasheet example
+static const struct bmp2_calib_param TEST_stCalib =
+{
+    27504U, 26435, -1000, 36477U, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000, 0
+};
+
+static struct bmp2_dev TEST_stDev;
+static struct bmp2_uncomp_data TEST_aUncomp[(BMP2_ST_ADC_T_MAX / TEST_ADC_STEP + 1) *
+                                             (BMP2_ST_ADC_P_MAX / TEST_ADC_STEP + 1)];
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static BMP2_INTF_RET_TYPE TEST_Read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr);
+static BMP2_INTF_RET_TYPE TEST_Write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length,
+                                      void *intf_ptr);
+static void TEST_Delay(uint32_t period, void *intf_ptr);
+static int16_t TEST_Spread(const int16_t nValue);
+static BOOLEAN TEST_Reference(const struct bmp2_calib_param *const pCalib, const int32_t nAdcT,
+                               const int32_t nAdcP, long double *const pTemperature,
+                               long double *const pPressure);
+static long double TEST_Abs(const long double value);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    struct bmp2_data stData;
+    long double fTemperature = 0.0L;
+    long double fPressure = 0.0L;
+    long double fMaxErrorC = 0.0L;
+    long double fMaxErrorPa = 0.0L;
+    long double fMaxRecordErrorPa = 0.0L;
+    uint32_t nQtyPoints = 0U;
+    uint32_t nQtyFailed = 0U;
+
+    srand(1U);
+    memset(&TEST_stDev, 0, sizeof(TEST_stDev));
+    TEST_stDev.read = TEST_Read;
+    TEST_stDev.write = TEST_Write;
+    TEST_stDev.delay_us = TEST_Delay;
+
+    for (uint32_t nCalib = 0U; nCalib < TEST_QTY_CALIB; nCalib++)
+    {
+        struct bmp2_calib_param *const pCalib = &TEST_stDev.calib_param;
+        uint32_t nQtyUncomp = 0U;
+
+        *pCalib = TEST_stCalib;
+        if (0U != nCalib)
+        {
+            pCalib->dig_t1 = (uint16_t)TEST_Spread((int16_t)(TEST_stCalib.dig_t1 / 2U)) * 2U;
+            pCalib->dig_t2 = TEST_Spread(TEST_stCalib.dig_t2);
+            pCalib->dig_t3 = TEST_Spread(TEST_stCalib.dig_t3);
+            pCalib->dig_p1 = (uint16_t)TEST_Spread((int16_t)(TEST_stCalib.dig_p1 / 2U)) * 2U;
+            pCalib->dig_p2 = TEST_Spread(TEST_stCalib.dig_p2);
+            pCalib->dig_p3 = TEST_Spread(TEST_stCalib.dig_p3);
+            pCalib->dig_p4 = TEST_Spread(TEST_stCalib.dig_p4);
+            pCalib->dig_p5 = TEST_Spread(TEST_stCalib.dig_p5);
+            pCalib->dig_p6 = TEST_Spread(TEST_stCalib.dig_p6);
+            pCalib->dig_p7 = TEST_Spread(TEST_stCalib.dig_p7);
+            pCalib->dig_p8 = TEST_Spread(TEST_stCalib.dig_p8);
+            pCalib->dig_p9 = TEST_Spread(TEST_stCalib.dig_p9);
+        }
+
+        // Points inside the range of the sensor
+        for (int32_t nAdcT = BMP2_ST_ADC_T_MIN; nAdcT <= BMP2_ST_ADC_T_MAX; nAdcT += TEST_ADC_STEP)
+        {
+            for (int32_t nAdcP = BMP2_ST_ADC_P_MIN; nAdcP <= BMP2_ST_ADC_P_MAX; nAdcP += TEST_ADC_STEP)
+            {
+                if (TRUE == TEST_Reference(pCalib, nAdcT, nAdcP, &fTemperature, &fPressure))
+                {
+                    TEST_aUncomp[nQtyUncomp].temperature = nAdcT;
+                    TEST_aUncomp[nQtyUncomp].pressure = nAdcP;
+                    nQtyUncomp++;
+                }
+            }
+        }
+
+        for (uint32_t i = 0U; i < nQtyUncomp; i++)
+        {
+            long double fError = 0.0L;
+
+            (void)TEST_Reference(pCalib, TEST_aUncomp[i].temperature, TEST_aUncomp[i].pressure,
+                                  &fTemperature, &fPressure);
+            if (BMP2_OK != bmp2_compensate_data(&TEST_aUncomp[i], &stData, &TEST_stDev))
+            {
+                nQtyFailed++;
+            }
+            else
+            {
+                fError = TEST_Abs(TEST_TEMPERATURE_C(stData.temperature) - fTemperature);
+                fMaxErrorC = (fError > fMaxErrorC) ? fError : fMaxErrorC;
+                fError = TEST_Abs(TEST_PRESSURE_PA(stData.pressure) - fPressure);
+                fMaxErrorPa = (fError > fMaxErrorPa) ? fError : fMaxErrorPa;
+                fError = TEST_Abs((long double)TEST_RECORD_PA(stData.pressure) - fPressure);
+                fMaxRecordErrorPa = (fError > fMaxRecordErrorPa) ? fError : fMaxRecordErrorPa;
+            }
+        }
+        nQtyPoints += nQtyUncomp;
+    }
+
+    printf("%-6s %lu calibrations, %lu points\n",
+           TEST_NAME, (unsigned long)TEST_QTY_CALIB, (unsigned long)nQtyPoints);
+    printf("%-6s max error: %.5f degC, %.4f Pa, %.4f Pa in the record\n",
+           TEST_NAME, (double)fMaxErrorC, (double)fMaxErrorPa, (double)fMaxRecordErrorPa);
+
+    TEST_CHECK(0U != nQtyPoints);
+    TEST_CHECK(0U == nQtyFailed);
+    TEST_CHECK(fMaxErrorC <= TEST_MAX_ERROR_C);
+    TEST_CHECK(fMaxErrorPa <= TEST_MAX_ERROR_PA);
+    TEST_CHECK(fMaxRecordErrorPa <= TEST_MAX_RECORD_ERROR_PA);
+
+    return HOST_Result("test_bmp2_" TEST_NAME);
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// The bus isn't used by the compensation, the pointers are checked by bmp2.c
+static BMP2_INTF_RET_TYPE TEST_Read(uint8_t reg_addr, uint8_t *reg_data, uint32_t length, void *intf_ptr)
+{
+    (void)reg_addr;
+    (void)reg_data;
+    (void)length;
+    (void)intf_ptr;
+
+    return BMP2_INTF_RET_SUCCESS;
+}
+
+static BMP2_INTF_RET_TYPE TEST_Write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t length,
+                                      void *intf_ptr)
+{
+    (void)reg_addr;
+    (void)reg_data;
+    (void)length;
+    (void)intf_ptr;
+
+    return BMP2_INTF_RET_SUCCESS;
+}
+
+static void TEST_Delay(uint32_t period, void *intf_ptr)
+{
+    (void)period;
+    (void)intf_ptr;
+}
+
+static int16_t TEST_Spread(const int16_t nValue)
+{
+    const double fFactor = 1.0 + TEST_SPREAD * (2.0 * (double)rand() / (double)RAND_MAX - 1.0);
+
+    return (int16_t)((double)nValue * fFactor);
+}
+
+// Formulas of the datasheet, t_fine isn't rounded. FALSE - the point is out of the range.
+static BOOLEAN TEST_Reference(const struct bmp2_calib_param *const pCalib, const int32_t nAdcT,
+                               const int32_t nAdcP, long double *const pTemperature,
+                               long double *const pPressure)
+{
+    long double var1 = ((long double)nAdcT / 16384.0L - (long double)pCalib->dig_t1 / 1024.0L) *
+                       (long double)pCalib->dig_t2;
+    long double var2 = ((long double)nAdcT / 131072.0L - (long double)pCalib->dig_t1 / 8192.0L);
+    long double fTFine = 0.0L;
+    long double p = 0.0L;
+
+    var2 = var2 * var2 * (long double)pCalib->dig_t3;
+    fTFine = var1 + var2;
+    *pTemperature = fTFine / 5120.0L;
+
+    var1 = fTFine / 2.0L - 64000.0L;
+    var2 = var1 * var1 * (long double)pCalib->dig_p6 / 32768.0L;
+    var2 = var2 + var1 * (long double)pCalib->dig_p5 * 2.0L;
+    var2 = var2 / 4.0L + (long double)pCalib->dig_p4 * 65536.0L;
+    var1 = ((long double)pCalib->dig_p3 * var1 * var1 / 524288.0L + (long double)pCalib->dig_p2 * var1) /
+           524288.0L;
+    var1 = (1.0L + var1 / 32768.0L) * (long double)pCalib->dig_p1;
+
+    if (0.0L != var1)
+    {
+        p = 1048576.0L - (long double)nAdcP;
+        p = (p - var2 / 4096.0L) * 6250.0L / var1;
+        var1 = (long double)pCalib->dig_p9 * p * p / 2147483648.0L;
+        var2 = p * (long double)pCalib->dig_p8 / 32768.0L;
+        p = p + (var1 + var2 + (long double)pCalib->dig_p7) / 16.0L;
+    }
+    *pPressure = p;
+
+    return ((*pTemperature >= TEST_MIN_C) && (*pTemperature <= TEST_MAX_C) &&
+            (p >= TEST_MIN_PA) && (p <= TEST_MAX_PA)) ? TRUE : FALSE;
+}
+
+static long double TEST_Abs(const long double value)
+{
+    return (value < 0.0L) ? -value : value;
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,336 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_ds18b20_search.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the DS18B20 Search ROM enumeration on the simulated 1-Wire bus.
+//
+//                The GPIO backend of ONE_WIRE drives the bus simulator, the UART backend
+//                drives it through the loopback of the half-duplex UART. The fixed ROM sets
+//                have the discrepancies at the same bit position in the different branches
+//                of the search tree, the random sets share long prefixes. Every set must be
+//                found completely by one pass per device, the devices of the other families
+//                are skipped, a wrong crc is reported, a device lost during the search isn't
+//                reported and doesn't duplicate the others.
+//                The conversion of all sensors and the read of the results run at the end.
+//                The wait of the conversion is checked against a sensor which holds the read
+//                slots low for a quantity of polls, up to the timeout and forever.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "onewire_sim.h"
+
+#include "OneWire.h"
+#include "ds18b20.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+#define TEST_CH                         (0U)
+#define TEST_FAMILY_DS18B20             (0x28U)
+#define TEST_FAMILY_DS18S20             (0x10U)
+#define TEST_MAX_QTY                    (ONE_WIRE_SIM_MAX_DEVICES)
+#define TEST_RANDOM_SETS                (300U)
+
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+#define TEST_NAME                       "test_ds18b20_search_uart"
+#else
+#define TEST_NAME                       "test_ds18b20_search"
+#endif
+
+// Polls of the wait before its timeout at 12 bits
+#define TEST_TIMEOUT_POLLS              ((750U + DS18B20_CONVERSION_MARGIN_MS) / DS18B20_POLL_PERIOD_MS)
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Bus(const uint64_t *const pRom, const uint32_t nQty);
+static BOOLEAN TEST_IsFound(const uint64_t nRom, const uint64_t *const pID, const uint8_t nQty);
+static void TEST_SearchSet(const uint64_t *const pSerial, const uint32_t nQty);
+static uint64_t TEST_Random(void);
+static void TEST_BusySlots(const uint32_t nSlots, const STD_RESULT expected);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    uint64_t aRom[TEST_MAX_QTY];
+    uint64_t aID[TEST_MAX_QTY];
+    uint64_t aSerial[TEST_MAX_QTY];
+    uint64_t nID = 0U;
+    uint8_t nQty = 0U;
+    ONE_WIRE_SIM_STAT stat;
+
+    ONE_WIRE_init();
+
+    // Empty bus
+    TEST_Bus(NULL, 0U);
+    TEST_CHECK(RESULT_NOT_OK == DS18B20_SearchROM(TEST_CH, aID, TEST_MAX_QTY, &nQty));
+    TEST_CHECK(0U == nQty);
+
+    // One device, Read ROM and Search ROM agree
+    aRom[0] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x0000A1B2C3D4ULL);
+    TEST_Bus(aRom, 1U);
+    TEST_CHECK(RESULT_OK == DS18B20_GetID(TEST_CH, &nID));
+    TEST_CHECK(aRom[0] == nID);
+    TEST_CHECK(RESULT_OK == DS18B20_SearchROM(TEST_CH, aID, TEST_MAX_QTY, &nQty));
+    TEST_CHECK((1U == nQty) && (aRom[0] == aID[0]));
+
+    // Serial bits 4 and 0 (ROM bits 12 and 8) split both branches at the same positions
+    {
+        const uint64_t aSet[] = {0x00U, 0x01U, 0x10U, 0x11U};
+        TEST_SearchSet(aSet, 4U);
+    }
+
+    // All 8 values of the serial bits 20..22 under the same prefix, and a pair which differs
+    // only by the last serial bit
+    for (uint32_t i = 0U; i < 8U; i++)
+    {
+        aSerial[i] = 0x5A5A00000000ULL | ((uint64_t)i << 20);
+    }
+    aSerial[8] = 0x000000000001ULL;
+    aSerial[9] = 0x800000000001ULL;
+    TEST_SearchSet(aSerial, 10U);
+
+    // Serials which differ by one bit at every position
+    for (uint32_t i = 0U; i < 32U; i++)
+    {
+        aSerial[i] = (uint64_t)1U << (i + 8U);
+    }
+    TEST_SearchSet(aSerial, 32U);
+
+    // The DS18S20 is skipped, the search goes on behind it
+    aRom[0] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x10U);
+    aRom[1] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18S20, 0x10U);
+    aRom[2] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x11U);
+    TEST_Bus(aRom, 3U);
+    TEST_CHECK(RESULT_OK == DS18B20_SearchROM(TEST_CH, aID, TEST_MAX_QTY, &nQty));
+    TEST_CHECK((2U == nQty) && TEST_IsFound(aRom[0], aID, nQty) && TEST_IsFound(aRom[2], aID, nQty));
+
+    // The array is full before the end of the search
+    for (uint32_t i = 0U; i < 5U; i++)
+    {
+        aRom[i] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x100U + i);
+    }
+    TEST_Bus(aRom, 5U);
+    TEST_CHECK(RESULT_OK == DS18B20_SearchROM(TEST_CH, aID, 3U, &nQty));
+    TEST_CHECK(3U == nQty);
+
+    // Wrong crc
+    aRom[0] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x20U);
+    aRom[1] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x21U) ^ (1ULL << 60);
+    TEST_Bus(aRom, 2U);
+    TEST_CHECK(RESULT_NOT_OK == DS18B20_SearchROM(TEST_CH, aID, TEST_MAX_QTY, &nQty));
+
+    // The device of the second pass leaves the bus after the first pass. The second pass
+    // follows the first device again, it must not be reported twice.
+    aRom[0] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x30U);
+    aRom[1] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x31U);
+    TEST_Bus(aRom, 2U);
+    TEST_CHECK(RESULT_OK == DS18B20_SearchROM(TEST_CH, aID, TEST_MAX_QTY, &nQty));
+    TEST_CHECK(2U == nQty);
+    ONE_WIRE_SIM_Detach((aRom[0] == aID[1]) ? 0U : 1U, 2U);
+    nID = aID[0];
+    TEST_CHECK(RESULT_OK == DS18B20_SearchROM(TEST_CH, aID, TEST_MAX_QTY, &nQty));
+    TEST_CHECK((1U == nQty) && (nID == aID[0]));
+
+    // Random sets with long common prefixes
+    srand(1U);
+    for (uint32_t nSet = 0U; nSet < TEST_RANDOM_SETS; nSet++)
+    {
+        const uint32_t nDevices = 1U + ((uint32_t)rand() % TEST_MAX_QTY);
+        const uint64_t nBase = TEST_Random();
+
+        for (uint32_t i = 0U; i < nDevices; i++)
+        {
+            BOOLEAN bUnique = FALSE;
+
+            while (FALSE == bUnique)
+            {
+                // Only a few low or high bits differ from the base
+                aSerial[i] = nBase ^ ((0U == (rand() & 1)) ? (TEST_Random() & 0x3FU) :
+                                                             (TEST_Random() & 0xFC0000000000ULL));
+                bUnique = TRUE;
+                for (uint32_t j = 0U; j < i; j++)
+                {
+                    bUnique = (aSerial[j] == aSerial[i]) ? FALSE : bUnique;
+                }
+            }
+        }
+        TEST_SearchSet(aSerial, nDevices);
+    }
+
+    // Conversion of all sensors and the results by Match ROM
+    aRom[0] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x40U);
+    aRom[1] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x41U);
+    aRom[2] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x42U);
+    TEST_Bus(NULL, 0U);
+    ONE_WIRE_SIM_AddDevice(aRom[0], 25 * 16 + 1);
+    ONE_WIRE_SIM_AddDevice(aRom[1], -10 * 16 - 2);
+    ONE_WIRE_SIM_AddDevice(aRom[2], 125 * 16);
+    {
+        const uint8_t nResolution = DS18B20_RESOLUTION_9_BIT;
+        uint64_t nStartUs = 0U;
+        float t = 0.0f;
+
+        TEST_CHECK(RESULT_OK == DS18B20_SetResolution(TEST_CH, &aRom[1], &nResolution));
+        nStartUs = HOST_nTimeUs;
+        TEST_CHECK(RESULT_OK == DS18B20_StartConversionAll(TEST_CH));
+        TEST_CHECK(RESULT_OK == DS18B20_WaitConversion(TEST_CH, DS18B20_RESOLUTION_12_BIT));
+        // 12 bits of two sensors, polled every 10 ms
+        TEST_CHECK((HOST_nTimeUs - nStartUs) >= 750000U);
+        TEST_CHECK((HOST_nTimeUs - nStartUs) < 770000U);
+        TEST_CHECK(0U == HOST_nCriticalDepth);
+
+        TEST_CHECK((RESULT_OK == DS18B20_ReadResult(TEST_CH, &aRom[0], &t)) && (25.0625f == t));
+        // 9 bits: 0.5 C steps
+        TEST_CHECK((RESULT_OK == DS18B20_ReadResult(TEST_CH, &aRom[1], &t)) && (-10.5f == t));
+        TEST_CHECK((RESULT_OK == DS18B20_ReadResult(TEST_CH, &aRom[2], &t)) && (125.0f == t));
+    }
+
+    ONE_WIRE_SIM_GetStat(&stat);
+    TEST_CHECK(0U == stat.nViolations);
+
+    // The sensor is busy for the polls of the wait: one poll every 10 ms, the last one at the
+    // timeout of 12 bits, 750 ms and the margin
+    TEST_BusySlots(1U, RESULT_OK);
+    TEST_BusySlots(5U, RESULT_OK);
+    TEST_BusySlots(TEST_TIMEOUT_POLLS, RESULT_OK);
+    TEST_BusySlots(TEST_TIMEOUT_POLLS + 1U, RESULT_NOT_OK);
+    TEST_BusySlots(ONE_WIRE_SIM_BUSY_FOREVER, RESULT_NOT_OK);
+
+    return HOST_Result(TEST_NAME);
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// The bus with the devices, 0 C
+static void TEST_Bus(const uint64_t *const pRom, const uint32_t nQty)
+{
+    ONE_WIRE_SIM_Init();
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        ONE_WIRE_SIM_AddDevice(pRom[i], 0);
+    }
+}
+
+static BOOLEAN TEST_IsFound(const uint64_t nRom, const uint64_t *const pID, const uint8_t nQty)
+{
+    BOOLEAN bFound = FALSE;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        bFound = (nRom == pID[i]) ? TRUE : bFound;
+    }
+
+    return bFound;
+}
+
+// Every device is found once, by one pass per device
+static void TEST_SearchSet(const uint64_t *const pSerial, const uint32_t nQty)
+{
+    uint64_t aRom[TEST_MAX_QTY];
+    uint64_t aID[TEST_MAX_QTY];
+    uint8_t nQtyFound = 0U;
+    BOOLEAN bAll = TRUE;
+    ONE_WIRE_SIM_STAT stat;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        aRom[i] = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, pSerial[i]);
+    }
+    TEST_Bus(aRom, nQty);
+
+    TEST_CHECK(RESULT_OK == DS18B20_SearchROM(TEST_CH, aID, TEST_MAX_QTY, &nQtyFound));
+    TEST_CHECK(nQty == nQtyFound);
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        bAll = (FALSE == TEST_IsFound(aRom[i], aID, nQtyFound)) ? FALSE : bAll;
+    }
+    TEST_CHECK(TRUE == bAll);
+
+    ONE_WIRE_SIM_GetStat(&stat);
+    TEST_CHECK(nQty == stat.nResets);
+}
+
+static uint64_t TEST_Random(void)
+{
+    return (((uint64_t)rand() << 32) ^ ((uint64_t)rand() << 16) ^ (uint64_t)rand()) & 0xFFFFFFFFFFFFULL;
+}
+
+// The sensor holds the read slots low for nSlots polls, the wait must end at the first free one or
+// at the timeout
+static void TEST_BusySlots(const uint32_t nSlots, const STD_RESULT expected)
+{
+    const uint32_t nTimeoutUs = (750U + DS18B20_CONVERSION_MARGIN_MS) * 1000U;
+    uint64_t nRom = ONE_WIRE_SIM_MakeRom(TEST_FAMILY_DS18B20, 0x50U);
+    uint64_t nStartUs = 0U;
+    uint64_t nElapsedUs = 0U;
+    ONE_WIRE_SIM_STAT stat;
+    float t = 0.0f;
+
+    TEST_Bus(NULL, 0U);
+    ONE_WIRE_SIM_SetBusySlots(ONE_WIRE_SIM_AddDevice(nRom, 20 * 16 + 4), nSlots);
+    TEST_CHECK(RESULT_OK == DS18B20_StartConversionAll(TEST_CH));
+    nStartUs = HOST_nTimeUs;
+    TEST_CHECK(expected == DS18B20_WaitConversion(TEST_CH, DS18B20_RESOLUTION_12_BIT));
+    nElapsedUs = HOST_nTimeUs - nStartUs;
+    ONE_WIRE_SIM_GetStat(&stat);
+    TEST_CHECK(0U == HOST_nCriticalDepth);
+    TEST_CHECK(0U == stat.nViolations);
+
+    if (RESULT_OK == expected)
+    {
+        // The sleeps after the busy polls and a slot of every poll
+        TEST_CHECK(nSlots == stat.nBusySlots);
+        TEST_CHECK(nElapsedUs >= ((uint64_t)nSlots * DS18B20_POLL_PERIOD_MS * 1000U));
+        TEST_CHECK(nElapsedUs <= ((uint64_t)nSlots * ((DS18B20_POLL_PERIOD_MS * 1000U) + ONE_WIRE_SIM_SLOT_MAX_US)) +
+                                 ONE_WIRE_SIM_SLOT_MAX_US);
+        TEST_CHECK((RESULT_OK == DS18B20_ReadResult(TEST_CH, &nRom, &t)) && (20.25f == t));
+    }
+    else
+    {
+        // Every poll up to the timeout is busy, the wait gives up after the last one
+        TEST_CHECK((TEST_TIMEOUT_POLLS + 1U) == stat.nBusySlots);
+        TEST_CHECK(nElapsedUs >= nTimeoutUs);
+        TEST_CHECK(nElapsedUs <= (nTimeoutUs + ((TEST_TIMEOUT_POLLS + 1U) * ONE_WIRE_SIM_SLOT_MAX_US)));
+    }
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,320 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_gsm_at.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the AT command engine against the scripted modem.
+//
+//                The script replaces the answers of the modem: the error, the silence, the
+//                late answer, the URC and the echo inside the answer. Every command must
+//                finish on the answer, not on the timeout, the silent command exactly on the
+//                timeout. The data prompt, "SEND OK", "+IPD" and "CLOSED" are checked on the
+//                connection to the mock broker. The session of the commands of one upload
+//                must take a few seconds of the modem on time, the open loop delays of the
+//                old sequence took about a minute.
+//
+//                In the transparent mode the data comes without "+IPD", "+++" after the guard
+//                time returns the modem to the commands, "CLOSED" inside the data finishes
+//                the read and returns the parser to the commands.
+//
+//                The packet sent in the chunks with the empty one between them comes to the
+//                broker whole, the transfer error of the DMA in the second chunk finishes the
+//                write at once and the chunks after it are not started.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "gsm_sim.h"
+
+#include "gsm_at.h"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// UART of the modem, the baud rate gives the timeout of the transmission
+UART_HandleTypeDef UartGSMHandler;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Timeout of the commands, ms
+#define TEST_TIMEOUT_MS                 (5000U)
+
+// Timeout of AT+CIPSTART, ms
+#define TEST_CONNECT_TIMEOUT_MS         (30000U)
+
+// Max time of the command answered at once: the command and the answer at 9600 baud, us
+#define TEST_MAX_COMMAND_US             (100000U)
+
+// Delay of the late answer, us
+#define TEST_LATE_US                    (2500000U)
+
+// Max modem on time of the commands of one upload, us
+#define TEST_MAX_SESSION_US             (5000000U)
+
+// Guard time of the escape sequence "+++", ms
+#define TEST_GUARD_MS                   (1200U)
+
+// MQTT PINGREQ, PINGRESP and DISCONNECT
+static const uint8_t TEST_aPingReq[] = { 0xC0U, 0x00U };
+static const uint8_t TEST_aPingResp[] = { 0xD0U, 0x00U };
+static const uint8_t TEST_aDisconnect[] = { 0xE0U, 0x00U };
+
+// PINGREQ and DISCONNECT in the chunks, the empty chunk is skipped
+static const GSM_AT_TYPE_TX_CHUNK TEST_aPingChunks[] =
+{
+    { &TEST_aPingReq[0], 1U },
+    { NULL,              0U },
+    { &TEST_aPingReq[1], 1U },
+};
+static const GSM_AT_TYPE_TX_CHUNK TEST_aDisconnectChunks[] =
+{
+    { &TEST_aDisconnect[0], 1U },
+    { &TEST_aDisconnect[1], 1U },
+    { TEST_aPingReq,        sizeof(TEST_aPingReq) },
+};
+
+// Answers of the modem to replace
+static const GSM_SIM_STEP TEST_aScript[] =
+{
+    { "AT+CIPSHUT",  "\r\nERROR\r\n",                                     0U          },
+    { "AT+CSQ",      NULL,                                                0U          },
+    { "AT+CGATT?",   "\r\n+CREG: 1\r\n\r\n+CGATT: 1\r\n\r\nOK\r\n",       5000U       },
+    { "AT+CIPHEAD",  "AT+CIPHEAD=1\r\r\nOK\r\n",                          5000U       },
+    { "AT+CSQ",      "\r\n+CSQ: 17,0\r\n\r\nOK\r\n",                      TEST_LATE_US },
+    { "AT+CIPSTART", "\r\nOK\r\n\r\nCONNECT FAIL\r\n",                    5000U       },
+};
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static GSM_AT_RESPONSE TEST_Command(const char *const pCommand, const char *const pExpected,
+                                    const uint32_t nTimeoutMs, uint64_t *const pTimeUs);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    GSM_SIM_CFG stCfg;
+    GSM_SIM_STAT stStat;
+    uint8_t aData[8];
+    char aClosed[16];
+    int32_t nRead = 0;
+    uint32_t nQty = 0U;
+    uint64_t nTimeUs = 0U;
+    uint64_t nStartUs = 0U;
+
+    UartGSMHandler.Init.BaudRate = GSM_SIM_BAUD_RATE;
+    GSM_SIM_GetDefaultCfg(&stCfg);
+    stCfg.nBootUs = 0U;
+    stCfg.nAttachUs = 0U;
+    GSM_SIM_Init(&stCfg);
+    GSM_AT_DMA_TX_CHANNEL->CCR = 0U;
+    GSM_AT_DMA_TX_CHANNEL->CNDTR = 0U;
+    GSM_AT_Init();
+
+    // Power on, the modem answers at once
+    HAL_GPIO_WritePin(GSM_SIM_POWER_PORT, GSM_SIM_POWER_PIN, GPIO_PIN_RESET);
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT\r", NULL, TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+
+    // The echo is skipped, the command finishes on "OK"
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("ATE0\r", NULL, TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+
+    GSM_SIM_SetScript(TEST_aScript, sizeof(TEST_aScript) / sizeof(TEST_aScript[0]));
+
+    // "ERROR" finishes the command at once
+    TEST_CHECK(GSM_AT_RESP_ERROR == TEST_Command("AT+CIPSHUT\r", "SHUT OK", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+
+    // No answer: the command finishes on the timeout
+    TEST_CHECK(GSM_AT_RESP_TIMEOUT == TEST_Command("AT+CSQ\r", "+CSQ:", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs >= (((uint64_t)TEST_TIMEOUT_MS - 1U) * 1000U));
+    TEST_CHECK(nTimeUs < (((uint64_t)TEST_TIMEOUT_MS * 1000U) + 2000U));
+
+    // URC before the response: the response line is kept, "OK" after it is dropped
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CGATT?\r", "+CGATT:", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(0 == strncmp(GSM_AT_GetResponse(), "+CGATT: 1", 9U));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+
+    // Echo of the command is not the response
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPHEAD=1\r", NULL, TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+
+    // Late answer: the command finishes on the answer
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CSQ\r", "+CSQ:", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(0 == strncmp(GSM_AT_GetResponse(), "+CSQ: 17,0", 10U));
+    TEST_CHECK(nTimeUs >= TEST_LATE_US);
+    TEST_CHECK(nTimeUs < (TEST_LATE_US + TEST_MAX_COMMAND_US));
+
+    // "FAIL" after "OK" finishes the command waiting for "CONNECT OK"
+    TEST_CHECK(GSM_AT_RESP_ERROR == TEST_Command("AT+CIPSTART=\"TCP\",\"host\",\"1883\"\r", "CONNECT OK",
+                                                 TEST_CONNECT_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+    TEST_CHECK(0U == GSM_SIM_GetScriptLeft());
+
+    // The session of one upload on the modem: the connection, one packet, the close
+    nStartUs = HOST_nTimeUs;
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT\r", NULL, TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CGATT?\r", "+CGATT: 1", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CSQ\r", "+CSQ:", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPSHUT\r", "SHUT OK", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPSTART=\"TCP\",\"host\",\"1883\"\r", "CONNECT OK",
+                                              TEST_CONNECT_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < (stCfg.nConnectUs + TEST_MAX_COMMAND_US));
+    TEST_CHECK(FALSE == GSM_AT_IsClosed());
+
+    // Prompt, the data, "SEND OK", the answer of the broker in "+IPD"
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPSEND=2\r", GSM_AT_PROMPT, TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(RESULT_OK == GSM_AT_Write(TEST_aPingReq, sizeof(TEST_aPingReq)));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command(NULL, "SEND OK", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < ((2U * (uint64_t)stCfg.nLatencyUs) + TEST_MAX_COMMAND_US));
+    memset(aData, 0, sizeof(aData));
+    TEST_CHECK((int32_t)sizeof(TEST_aPingResp) == GSM_AT_Read(aData, sizeof(TEST_aPingResp), TEST_TIMEOUT_MS));
+    TEST_CHECK(0 == memcmp(aData, TEST_aPingResp, sizeof(TEST_aPingResp)));
+    printf("test_gsm_at: commands of the upload, modem on %lu ms\n",
+           (unsigned long)((HOST_nTimeUs - nStartUs) / 1000U));
+    TEST_CHECK((HOST_nTimeUs - nStartUs) < TEST_MAX_SESSION_US);
+
+    // DISCONNECT: the broker closes the connection, "CLOSED" finishes the read at once
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPSEND=2\r", GSM_AT_PROMPT, TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(RESULT_OK == GSM_AT_Write(TEST_aDisconnect, sizeof(TEST_aDisconnect)));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command(NULL, "SEND OK", TEST_TIMEOUT_MS, &nTimeUs));
+    nStartUs = HOST_nTimeUs;
+    TEST_CHECK(-1 == GSM_AT_Read(aData, sizeof(aData), TEST_TIMEOUT_MS));
+    TEST_CHECK((HOST_nTimeUs - nStartUs) < ((uint64_t)TEST_TIMEOUT_MS * 1000U));
+    TEST_CHECK(TRUE == GSM_AT_IsClosed());
+    TEST_CHECK(GSM_AT_RESP_ERROR == TEST_Command("AT+CIPCLOSE\r", "CLOSE OK", TEST_TIMEOUT_MS, &nTimeUs));
+
+    // Transparent mode: "CONNECT" switches the modem to the data, no "+IPD" in the answer
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPMODE=1\r", NULL, TEST_TIMEOUT_MS, &nTimeUs));
+    GSM_AT_Purge();
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPSTART=\"TCP\",\"host\",\"1883\"\r", "CONNECT",
+                                              TEST_CONNECT_TIMEOUT_MS, &nTimeUs));
+    GSM_AT_SetDataMode(TRUE);
+    TEST_CHECK(FALSE == GSM_AT_IsClosed());
+    TEST_CHECK(RESULT_OK == GSM_AT_Write(TEST_aPingReq, sizeof(TEST_aPingReq)));
+    memset(aData, 0, sizeof(aData));
+    TEST_CHECK((int32_t)sizeof(TEST_aPingResp) == GSM_AT_Read(aData, sizeof(aData), TEST_TIMEOUT_MS));
+    TEST_CHECK(0 == memcmp(aData, TEST_aPingResp, sizeof(TEST_aPingResp)));
+
+    // "+++" with the guard time before and after it, "OK" of the command mode
+    vTaskDelay(TEST_GUARD_MS);
+    GSM_AT_SetDataMode(FALSE);
+    TEST_CHECK(RESULT_OK == GSM_AT_Write("+++", 3U));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command(NULL, NULL, TEST_GUARD_MS + TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs >= (GSM_SIM_GUARD_US - TEST_MAX_COMMAND_US));
+    TEST_CHECK(nTimeUs < (GSM_SIM_GUARD_US + TEST_MAX_COMMAND_US));
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(1U == stStat.nEscapes);
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPCLOSE\r", "CLOSE OK", TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+
+    // The broker closes the transparent connection: "CLOSED" is found in the data
+    GSM_AT_Purge();
+    memset(aClosed, 0, sizeof(aClosed));
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPSTART=\"TCP\",\"host\",\"1883\"\r", "CONNECT",
+                                              TEST_CONNECT_TIMEOUT_MS, &nTimeUs));
+    GSM_AT_SetDataMode(TRUE);
+    TEST_CHECK(FALSE == GSM_AT_IsClosed());
+    TEST_CHECK(RESULT_OK == GSM_AT_Write(TEST_aDisconnect, sizeof(TEST_aDisconnect)));
+    nStartUs = HOST_nTimeUs;
+    nQty = 0U;
+    do
+    {
+        // "CLOSED" can't be told from the data before its end, the reader gets it too
+        nRead = GSM_AT_Read(&aClosed[nQty], sizeof(aClosed) - 1U - nQty, TEST_TIMEOUT_MS);
+        nQty += (nRead > 0) ? (uint32_t)nRead : 0U;
+    } while ((nRead > 0) && (nQty < (sizeof(aClosed) - 1U)));
+    TEST_CHECK(-1 == nRead);
+    TEST_CHECK(0 == strcmp(aClosed, "\r\nCLOSED\r\n"));
+    TEST_CHECK((HOST_nTimeUs - nStartUs) < ((uint64_t)TEST_TIMEOUT_MS * 1000U));
+    TEST_CHECK(TRUE == GSM_AT_IsClosed());
+
+    // The parser is back in the command mode without "+++"
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT\r", NULL, TEST_TIMEOUT_MS, &nTimeUs));
+    TEST_CHECK(nTimeUs < TEST_MAX_COMMAND_US);
+
+    // The chunks of PINGREQ: the DMA interrupt starts the next one, the broker gets the packet
+    GSM_AT_Purge();
+    TEST_CHECK(GSM_AT_RESP_OK == TEST_Command("AT+CIPSTART=\"TCP\",\"host\",\"1883\"\r", "CONNECT",
+                                              TEST_CONNECT_TIMEOUT_MS, &nTimeUs));
+    GSM_AT_SetDataMode(TRUE);
+    TEST_CHECK(RESULT_OK == GSM_AT_WriteV(TEST_aPingChunks, sizeof(TEST_aPingChunks) / sizeof(TEST_aPingChunks[0])));
+    TEST_CHECK(0U == (GSM_AT_DMA_TX_CHANNEL->CCR & DMA_CCR_EN));
+    memset(aData, 0, sizeof(aData));
+    TEST_CHECK((int32_t)sizeof(TEST_aPingResp) == GSM_AT_Read(aData, sizeof(aData), TEST_TIMEOUT_MS));
+    TEST_CHECK(0 == memcmp(aData, TEST_aPingResp, sizeof(TEST_aPingResp)));
+
+    // The transfer error in the second chunk: no timeout, the third chunk is not sent
+    GSM_SIM_GetStat(&stStat);
+    nQty = stStat.nTxBytes;
+    stCfg.nTxErrorAt = nQty + 2U;
+    GSM_SIM_SetCfg(&stCfg);
+    nStartUs = HOST_nTimeUs;
+    TEST_CHECK(RESULT_NOT_OK == GSM_AT_WriteV(TEST_aDisconnectChunks,
+                                              sizeof(TEST_aDisconnectChunks) / sizeof(TEST_aDisconnectChunks[0])));
+    TEST_CHECK((HOST_nTimeUs - nStartUs) < TEST_MAX_COMMAND_US);
+    TEST_CHECK(0U == (GSM_AT_DMA_TX_CHANNEL->CCR & DMA_CCR_EN));
+    vTaskDelay(TEST_GUARD_MS);
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK((nQty + 1U) == stStat.nTxBytes);
+
+    TEST_CHECK(4U == stStat.nTcpConnects);
+    TEST_CHECK(3U == stStat.nPingReqs);
+    TEST_CHECK(2U == stStat.nDisconnects);
+    TEST_CHECK(1U == stStat.nEscapes);
+
+    return HOST_Result("test_gsm_at");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Command and its time from the start of the transmission to the result
+static GSM_AT_RESPONSE TEST_Command(const char *const pCommand, const char *const pExpected,
+                                    const uint32_t nTimeoutMs, uint64_t *const pTimeUs)
+{
+    const uint64_t nStartUs = HOST_nTimeUs;
+    const GSM_AT_RESPONSE enResp = GSM_AT_Command(pCommand, pExpected, nTimeoutMs);
+
+    *pTimeUs = HOST_nTimeUs - nStartUs;
+
+    return enResp;
+}
+
+//****************************************** end of file *******************************************
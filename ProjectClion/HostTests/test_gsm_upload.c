@@ -0,0 +1,374 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_gsm_upload.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the upload of the backlog by the GSM task against the simulated modem
+//                and the mock broker.
+//
+//                The task runs on its own stack from the GSM alarm until it suspends itself.
+//                The records of the flash must reach the broker in order, the cursor must
+//                follow the acknowledged records and the modem must be off after the
+//                wakeup. The next wakeup sends only the new records. The broker closes the
+//                connection in the middle of the batch: the upload resumes from the cursor,
+//                only the records not confirmed are sent twice, the window of QoS 1 or the
+//                batch of QoS 0. The target loses the power in the middle of the batch: the
+//                acknowledged records of the batch are sent twice as the cursor is stored
+//                once per batch. The connection refused after the acknowledged batches
+//                doesn't move the cursor. PUBACK out of order is checked with QoS 1.
+//                "CLOSED" after DISCONNECT ends the transparent mode without "+++".
+//                The upload waits for the period of the GSM alarm, the doubled wait after the
+//                failed session skips the alarm. The records older than
+//                TASK_GSM_POLICY_MAX_AGE_S are sent before the end of the wait.
+//                The stack used by the task must fit TASK_GSM_STACK_DEPTH.
+//                The test is built for the default QoS 0 and for QoS 1. The modules are
+//                included to restart them.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+#include "gsm_sim.h"
+
+// Modules under test
+#include "record_manager.c"
+#include "task_GSM.c"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// UART of the modem, the baud rate gives the timeout of the transmission
+UART_HandleTypeDef UartGSMHandler;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Records of the first wakeup, more than one cycle of the session
+#define TEST_QTY_FIRST                  (150U)
+
+// Records of the next wakeups
+#define TEST_QTY_NEXT                   (70U)
+
+// Period of the records, s
+#define TEST_RECORD_PERIOD_S            (600U)
+
+// Records of the half period of the GSM alarm, the upload waits for them
+#define TEST_QTY_SHORT                  ((TIME_ALARM_GSM_PERIOD_S / 2U) / TEST_RECORD_PERIOD_S)
+
+// Records of the wakeup after the failed session, the wait is doubled
+#define TEST_QTY_RETRY                  ((2U * TIME_ALARM_GSM_PERIOD_S) / TEST_RECORD_PERIOD_S)
+
+// Records sent but not confirmed: the window of QoS 1, the batch of QoS 0
+#if (TASK_GSM_MQTT_QOS_1 == TASK_GSM_MQTT_QOS)
+#define TEST_QTY_NOT_CONFIRMED          (TASK_GSM_WINDOW_SIZE)
+#else
+#define TEST_QTY_NOT_CONFIRMED          (TASK_GSM_BATCH_QTY_RECORDS)
+#endif
+
+// Max time of the wakeup, us
+#define TEST_MAX_WAKEUP_US              (600000000U)
+
+// Stack of the host task to the stack of the target: the frames of x86-64 and the printf of
+// the C library take about twice the stack of the target
+#define TEST_HOST_STACK_RATIO           (2U)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// Records stored in the flash
+static uint32_t TEST_nQtyStored = 0U;
+
+// Shift of the time of the next records, s
+static uint32_t TEST_nShiftS = 0U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Boot(void);
+static void TEST_Restart(void);
+static void TEST_StoreRecords(const uint32_t nQty);
+static BOOLEAN TEST_Wakeup(void);
+static uint32_t TEST_GetCursor(void);
+static BOOLEAN TEST_IsInOrder(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    GSM_SIM_CFG stCfg;
+    GSM_SIM_STAT stStat;
+    uint32_t nQtyDuplicates = 0U;
+    uint32_t nCursor = 0U;
+
+    UartGSMHandler.Init.BaudRate = GSM_SIM_BAUD_RATE;
+    GSM_SIM_GetDefaultCfg(&stCfg);
+    GSM_SIM_Init(&stCfg);
+    W25Q_SIM_Init();
+    TEST_Boot();
+
+    // Nothing to send: the modem is not powered
+    TEST_CHECK(FALSE == TEST_Wakeup());
+
+    // Younger than the wait: the opportunity is skipped
+    TEST_StoreRecords(TEST_QTY_SHORT);
+    TEST_CHECK(FALSE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(0U == stStat.nPowerOn);
+
+    // Backlog of two cycles on one connection
+    TEST_StoreRecords(TEST_QTY_FIRST - TEST_QTY_SHORT);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(TEST_QTY_FIRST == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK(TRUE == TEST_IsInOrder());
+    TEST_CHECK(0U == stStat.nDuplicates);
+    TEST_CHECK(TEST_QTY_FIRST == TEST_GetCursor());
+    TEST_CHECK(1U == stStat.nPowerOn);
+    TEST_CHECK(1U == stStat.nMqttConnects);
+    TEST_CHECK(1U == stStat.nDisconnects);
+    // The broker closes the connection after DISCONNECT, "+++" of the transparent mode is
+    // not sent to the modem already in the command mode
+    TEST_CHECK(0U == stStat.nEscapes);
+    TEST_CHECK(0 == strcmp(stStat.aTopic, TASK_GSM_TOPIC_PUBLISH));
+    TEST_CHECK(NULL != strstr(stStat.aServer, "\"mqtt3.thingspeak.com\",\"1883\""));
+    TEST_CHECK(TASK_GSM_MQTT_QOS == stStat.nMaxQos);
+#if (TASK_GSM_MQTT_QOS_0 == TASK_GSM_MQTT_QOS)
+    // PINGRESP confirms every batch
+    TEST_CHECK(stStat.nPingReqs >= (TEST_QTY_FIRST / TASK_GSM_BATCH_QTY_RECORDS));
+#endif
+    TEST_CHECK(0U != (GSM_SIM_POWER_PORT->ODR & GSM_SIM_POWER_PIN));
+    printf("test_gsm_upload: %lu records, modem on %lu ms, stack %lu bytes\n",
+           (unsigned long)TEST_QTY_FIRST, (unsigned long)(stStat.nOnUs / 1000U),
+           (unsigned long)HOST_TaskGetStackUsed());
+    TEST_CHECK(HOST_TaskGetStackUsed() <= (TASK_GSM_STACK_DEPTH * sizeof(uint32_t) * TEST_HOST_STACK_RATIO));
+
+    // The next wakeup sends only the new records, the session is kept by the broker
+    TEST_StoreRecords(TEST_QTY_NEXT);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(TEST_nQtyStored == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK(TRUE == TEST_IsInOrder());
+    TEST_CHECK(0U == stStat.nDuplicates);
+    TEST_CHECK(TEST_nQtyStored == TEST_GetCursor());
+    TEST_CHECK(2U == stStat.nPowerOn);
+    TEST_CHECK(1U == stStat.nSessionPresent);
+
+    // The broker closes the connection instead of PUBACK: the cursor stops before the record
+    TEST_StoreRecords(TEST_QTY_NEXT);
+    stCfg.nCloseAt = stStat.nPublishes + 15U;
+    GSM_SIM_SetCfg(&stCfg);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(TEST_GetCursor() < (stCfg.nCloseAt - stStat.nDuplicates));
+    TEST_CHECK(TEST_GetCursor() >= (stCfg.nCloseAt - TEST_QTY_NOT_CONFIRMED));
+    TEST_CHECK(0U != (GSM_SIM_POWER_PORT->ODR & GSM_SIM_POWER_PIN));
+
+    // The backlog older than one wait but younger than the doubled one: the alarm is skipped
+    stCfg.nCloseAt = 0U;
+    GSM_SIM_SetCfg(&stCfg);
+    TEST_StoreRecords(TEST_QTY_SHORT);
+    nCursor = TEST_GetCursor();
+    TEST_CHECK(((TEST_nQtyStored - nCursor) * TEST_RECORD_PERIOD_S) > TIME_ALARM_GSM_PERIOD_S);
+    TEST_CHECK(((TEST_nQtyStored - nCursor) * TEST_RECORD_PERIOD_S) < (TIME_ALARM_GSM_PERIOD_S * 3U / 2U));
+    TEST_CHECK(FALSE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(3U == stStat.nPowerOn);
+
+    // The next session resumes from the cursor
+    TEST_StoreRecords(TEST_QTY_RETRY - TEST_QTY_SHORT);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(TEST_nQtyStored == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK(TRUE == TEST_IsInOrder());
+    TEST_CHECK(stStat.nDuplicates <= TEST_QTY_NOT_CONFIRMED);
+    TEST_CHECK(TEST_nQtyStored == TEST_GetCursor());
+
+    // Power loss in the middle of the batch: the board restarts, the upload resumes
+    nQtyDuplicates = stStat.nDuplicates;
+    TEST_StoreRecords(TEST_QTY_NEXT);
+    stCfg.nPowerLossAt = stStat.nPublishes + 25U;
+    GSM_SIM_SetCfg(&stCfg);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    TEST_CHECK(TEST_GetCursor() < TEST_nQtyStored);
+    stCfg.nPowerLossAt = 0U;
+    GSM_SIM_SetCfg(&stCfg);
+    TEST_Boot();
+    TEST_StoreRecords(TEST_QTY_NEXT);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(TEST_nQtyStored == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK(TRUE == TEST_IsInOrder());
+    TEST_CHECK((stStat.nDuplicates - nQtyDuplicates) <= TASK_GSM_BATCH_QTY_RECORDS);
+    TEST_CHECK(TEST_nQtyStored == TEST_GetCursor());
+    TEST_CHECK(0U != (GSM_SIM_POWER_PORT->ODR & GSM_SIM_POWER_PIN));
+
+    // The connection is refused after the acknowledged batches: the flags of the last batch
+    // don't move the cursor over the records not sent
+    nCursor = TEST_GetCursor();
+    TEST_StoreRecords(TEST_QTY_NEXT);
+    stCfg.bRefuse = TRUE;
+    GSM_SIM_SetCfg(&stCfg);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    TEST_CHECK(nCursor == TEST_GetCursor());
+    stCfg.bRefuse = FALSE;
+    GSM_SIM_SetCfg(&stCfg);
+    TEST_StoreRecords(TEST_QTY_RETRY);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    TEST_CHECK(TEST_nQtyStored == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK(TRUE == TEST_IsInOrder());
+    TEST_CHECK(TEST_nQtyStored == TEST_GetCursor());
+
+#if (TASK_GSM_MQTT_QOS_1 == TASK_GSM_MQTT_QOS)
+    // PUBACK out of order: the window moves on any PUBACK, the cursor on the first records
+    GSM_SIM_GetStat(&stStat);
+    nQtyDuplicates = stStat.nDuplicates;
+    stCfg.bSwapAcks = TRUE;
+    GSM_SIM_SetCfg(&stCfg);
+    TEST_StoreRecords(TEST_QTY_FIRST);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    GSM_SIM_GetStat(&stStat);
+    TEST_CHECK(TEST_nQtyStored == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK(TRUE == TEST_IsInOrder());
+    TEST_CHECK(nQtyDuplicates == stStat.nDuplicates);
+    TEST_CHECK(TEST_nQtyStored == TEST_GetCursor());
+#endif
+
+    // Few records older than the max age are sent before the end of the wait
+    TEST_StoreRecords(1U);
+    TEST_CHECK(FALSE == TEST_Wakeup());
+    TEST_nShiftS += TASK_GSM_POLICY_MAX_AGE_S;
+    TEST_StoreRecords(1U);
+    TEST_CHECK(TRUE == TEST_Wakeup());
+    TEST_CHECK(TEST_nQtyStored == GSM_SIM_GetQtyPayloads());
+    TEST_CHECK(TEST_nQtyStored == TEST_GetCursor());
+
+    return HOST_Result("test_gsm_upload");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Start of the board: the mutex, the record manager and the GSM task which waits for the alarm
+static void TEST_Boot(void)
+{
+    GSM_AT_DMA_TX_CHANNEL->CCR = 0U;
+    GSM_AT_DMA_TX_CHANNEL->CNDTR = 0U;
+    RECORD_MAN_xMutex = xSemaphoreCreateMutex();
+    TEST_Restart();
+    TASK_GSM_enLink = TASK_GSM_LINK_OFF;
+    HOST_TaskCreate(vTaskGSM, NULL);
+}
+
+static void TEST_Restart(void)
+{
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    EMEEP_DeInit();
+    RECORD_MAN_bInitialezed = FALSE;
+    RECORD_MAN_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+}
+
+// The temperature is the number of the record, it is the first field of the payload
+static void TEST_StoreRecords(const uint32_t nQty)
+{
+    RECORD_MAN_TYPE_RECORD stRecord;
+    uint8_t aRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nQtyRecords = 0U;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        memset(aRecord, 0, sizeof(aRecord));
+        stRecord.nUnixTime = 1700000000U + (TEST_nQtyStored * TEST_RECORD_PERIOD_S) + TEST_nShiftS;
+        stRecord.fTemperature = (float)TEST_nQtyStored;
+        stRecord.fHumidity = 55.5f;
+        stRecord.nPressure = 10132507U;
+        stRecord.fWindSpeed = 3.25f;
+        stRecord.fBatteryVoltage = 4.0f;
+        stRecord.fWindGust = 7.5f;
+        memcpy(aRecord, &stRecord, sizeof(stRecord));
+        TEST_CHECK(RESULT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQtyRecords));
+        TEST_nQtyStored++;
+    }
+}
+
+// GSM alarm: the task runs until it suspends itself or the target is reset
+static BOOLEAN TEST_Wakeup(void)
+{
+    BOOLEAN bDue = TASK_GSM_IsUploadDue();
+    const uint64_t nStartUs = HOST_nTimeUs;
+
+    if (TRUE == bDue)
+    {
+        vTaskResume(TASK_GSM_hHandlerTask);
+        TEST_CHECK((HOST_nTimeUs - nStartUs) < TEST_MAX_WAKEUP_US);
+    }
+
+    return bDue;
+}
+
+static uint32_t TEST_GetCursor(void)
+{
+    uint32_t nCursor = 0U;
+
+    TEST_CHECK(RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD, (U8*)&nCursor, sizeof(nCursor)));
+
+    return nCursor;
+}
+
+// The broker got every record once in the order of the flash, the pressure printed from the
+// integer of the record
+static BOOLEAN TEST_IsInOrder(void)
+{
+    char aExpected[32];
+    BOOLEAN bInOrder = TRUE;
+
+    for (uint32_t i = 0U; i < GSM_SIM_GetQtyPayloads(); i++)
+    {
+        (void)snprintf(aExpected, sizeof(aExpected), "field1=%lu.000&", (unsigned long)i);
+        if ((NULL == GSM_SIM_GetPayload(i)) ||
+            (0 != strncmp(GSM_SIM_GetPayload(i), aExpected, strlen(aExpected))) ||
+            (NULL == strstr(GSM_SIM_GetPayload(i), "&field3=101325.07&")))
+        {
+            bInOrder = FALSE;
+        }
+    }
+
+    return bInOrder;
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,283 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_read_sensors_cycle.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the order and of the timing of the measurement cycle of the sensor
+//                task.
+//
+//                The task runs against the simulators of the DS18B20 bus, of the AM2305, of the
+//                BMP280 and of the ADC of the anemometer. The cycle from the resume of the task
+//                to its suspend is the second one, the ROM table is enumerated by the first.
+//                All conversions must be started together with the power of the anemometer,
+//                every result must be read after the end of its conversion, and the last one
+//                before the end of the settling of the anemometer. The cycle must end at the
+//                last sequence of the wind window, the conversions add nothing to it.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+#include "onewire_sim.h"
+#include "am2305_sim.h"
+#include "bmp280_sim.h"
+#include "adc_sim.h"
+
+#include "OneWire.h"
+
+// The private constants of the window are checked
+#include "task_read_sensors.c"
+
+#include <math.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Temperature of both DS18B20, 1/16 C
+#define TEST_DS18B20_RAW            (21 * 16 + 8)
+
+// AM2305 answer: 65.2 %, 21.3 C
+#define TEST_AM2305_HUMIDITY        (652U)
+#define TEST_AM2305_TEMPERATURE     (213U)
+
+// Pressure of the raw values of the datasheet example in the record, the 64-bit compensation
+// gives 25767240 / 256 Pa = 100653.28 Pa
+#define TEST_PRESSURE               (10065328U)
+
+// Time of the record
+#define TEST_UNIX_TIME              (1700000000UL)
+
+// Start of the cycle to the start of the last conversion, the reset and two bytes of the
+// 1-Wire, us
+#define TEST_MAX_START_US           (5000U)
+
+// End of the window to the suspend of the task: the collection and the store of the record, us
+#define TEST_MAX_STORE_US           (20000U)
+
+// Wind samples of the window, counts. The gust is the 3 s of 40 counts.
+#define TEST_QTY_WIND_COUNTS        (10U)
+static const uint32_t TEST_aWindCounts[TEST_QTY_WIND_COUNTS] = { 10U, 10U, 10U, 40U, 40U, 40U, 10U, 10U, 10U, 10U };
+#define TEST_WIND_MEAN_COUNTS       (19.0f)
+#define TEST_WIND_GUST_COUNTS       (40.0f)
+#define TEST_BAT_COUNTS             (272U)
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// Handles of Init.c
+I2C_HandleTypeDef I2CBMP280Handler = { I2C1 };
+DMA_HandleTypeDef ADC_DmaHandle = { DMA1_Channel1 };
+ADC_HandleTypeDef ADC_Handle = { ADC1, &ADC_DmaHandle };
+TIM_HandleTypeDef ADC_TriggerTimHandle = { INIT_ADC_TRIGGER_TIM };
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// Hooks of the simulators
+static HOST_GPIO_HOOK TEST_pOneWireGpio = NULL;
+static HOST_TIME_HOOK TEST_pOneWireTime = NULL;
+static HOST_GPIO_HOOK TEST_pAm2305Gpio = NULL;
+static HOST_TIME_HOOK TEST_pAm2305Time = NULL;
+static HOST_TIME_HOOK TEST_pAdcTime = NULL;
+
+// Power on of the anemometer and the last start signal of the AM2305
+static uint64_t TEST_nPowerOnUs = 0U;
+static uint64_t TEST_nAm2305StartUs = 0U;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Boot(void);
+static void TEST_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel);
+static void TEST_TimeHook(const uint64_t nTimeUs);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    const uint64_t nWindowUs = (uint64_t)TASK_READ_SEN_WIND_QTY_SEQUENCES * TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS * 1000U;
+    ONE_WIRE_SIM_STAT stOneWire;
+    AM2305_SIM_STAT stAm2305;
+    BMP280_SIM_STAT stBmp280;
+    ADC_SIM_STAT stAdc;
+    uint64_t nStartUs = 0U;
+    uint64_t nConversionsEndUs = 0U;
+    uint32_t nConversions = 0U;
+
+    TEST_Boot();
+
+    // First cycle: the ROM table is enumerated and stored
+    vTaskResume(TASK_READ_SEN_hHandlerTask);
+    TEST_CHECK(0U == HOST_nCriticalDepth);
+
+    // Second cycle
+    ONE_WIRE_SIM_GetStat(&stOneWire);
+    nConversions = stOneWire.nConversions;
+    nStartUs = HOST_nTimeUs;
+    vTaskResume(TASK_READ_SEN_hHandlerTask);
+
+    ONE_WIRE_SIM_GetStat(&stOneWire);
+    AM2305_SIM_GetStat(&stAm2305);
+    BMP280_SIM_GetStat(&stBmp280);
+    ADC_SIM_GetStat(&stAdc);
+
+    // Start: the anemometer and its samples, BMP280, then one CONVERT T for all DS18B20
+    TEST_CHECK(nStartUs == TEST_nPowerOnUs);
+    TEST_CHECK(TEST_nPowerOnUs == stAdc.nStartUs);
+    TEST_CHECK(stAdc.nStartUs <= stBmp280.nStartUs);
+    TEST_CHECK(stBmp280.nStartUs <= stOneWire.nConvertStartUs);
+    TEST_CHECK((stOneWire.nConvertStartUs - nStartUs) < TEST_MAX_START_US);
+    TEST_CHECK(2U == (stOneWire.nConversions - nConversions));
+
+    // Collection in the order of readiness, every result after the end of its conversion
+    TEST_CHECK(0U == stBmp280.nEarlyReads);
+    TEST_CHECK(stBmp280.nReadUs >= stBmp280.nEndUs);
+    TEST_CHECK(TEST_nAm2305StartUs >= stBmp280.nReadUs);
+    TEST_CHECK(2U == stAm2305.nStarts);
+    TEST_CHECK(0U == stOneWire.nEarlyReads);
+    TEST_CHECK(stOneWire.nReadUs >= stOneWire.nConvertEndUs);
+    TEST_CHECK(stOneWire.nReadUs > TEST_nAm2305StartUs);
+    TEST_CHECK(0U == stOneWire.nViolations);
+
+    // The conversions end within the settling of the anemometer
+    nConversionsEndUs = stOneWire.nReadUs;
+    TEST_CHECK((nConversionsEndUs - nStartUs) < ((uint64_t)TASK_READ_SEN_ANEMOMETER_SETTLE_MS * 1000U));
+
+    // The window is sampled with the power on, the cycle ends at its last sequence
+    TEST_CHECK(TASK_READ_SEN_WIND_QTY_SEQUENCES == stAdc.nSequences);
+    TEST_CHECK(0U == stAdc.nUnpowered);
+    TEST_CHECK((stAdc.nLastSequenceUs - nStartUs) == nWindowUs);
+    TEST_CHECK((HOST_nTimeUs - nStartUs) >= nWindowUs);
+    TEST_CHECK((HOST_nTimeUs - nStartUs) < (nWindowUs + TEST_MAX_STORE_US));
+    TEST_CHECK(0U == (INIT_PWR_ANEMOMETER_PORT->ODR & INIT_PWR_ANEMOMETER_PIN));
+
+    // Record of the cycle
+    TEST_CHECK(((float)TEST_DS18B20_RAW / 16.0f) == TASK_READ_SENS_stMeasData.fTemperature);
+    TEST_CHECK(((float)TEST_AM2305_HUMIDITY / 10.0f) == TASK_READ_SENS_stMeasData.fHumidity);
+    TEST_CHECK(TEST_PRESSURE == TASK_READ_SENS_stMeasData.nPressure);
+    TEST_CHECK(fabsf((TEST_WIND_MEAN_COUNTS * TASK_READ_SEN_ANEMOMETER_SPEED_PER_COUNT) - TASK_READ_SENS_stMeasData.fWindSpeed) < 0.001f);
+    TEST_CHECK(fabsf((TEST_WIND_GUST_COUNTS * TASK_READ_SEN_ANEMOMETER_SPEED_PER_COUNT) - TASK_READ_SENS_stMeasData.fWindGust) < 0.001f);
+    TEST_CHECK(TEST_UNIX_TIME == TASK_READ_SENS_stMeasData.nUnixTime);
+    TEST_CHECK(0U == HOST_nCriticalDepth);
+
+    printf("test_read_sensors_cycle: conversions end at %lu ms, cycle %lu ms, settling %u ms, "
+           "window %lu ms\n",
+           (unsigned long)((nConversionsEndUs - nStartUs) / 1000U),
+           (unsigned long)((HOST_nTimeUs - nStartUs) / 1000U),
+           (unsigned)TASK_READ_SEN_ANEMOMETER_SETTLE_MS,
+           (unsigned long)(nWindowUs / 1000U));
+
+    return HOST_Result("test_read_sensors_cycle");
+}
+
+// Clock of the board
+U32 TIME_GetUnixTimestamp(void)
+{
+    return TEST_UNIX_TIME;
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Devices, drivers, the record manager and the task which waits for the alarm
+static void TEST_Boot(void)
+{
+    uint8_t aData[AM2305_QTY_DATA_BYTES];
+    uint32_t aEdge[AM2305_SIM_QTY_EDGES];
+    uint32_t nQty = 0U;
+
+    W25Q_SIM_Init();
+    RECORD_MAN_xMutex = xSemaphoreCreateMutex();
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    RECORD_MAN_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+
+    // Every simulator takes the hooks, the test calls all of them
+    ONE_WIRE_SIM_Init();
+    TEST_pOneWireGpio = HOST_pGpioHook;
+    TEST_pOneWireTime = HOST_pTimeHook;
+    AM2305_SIM_Init();
+    TEST_pAm2305Gpio = HOST_pGpioHook;
+    TEST_pAm2305Time = HOST_pTimeHook;
+    ADC_SIM_Init();
+    TEST_pAdcTime = HOST_pTimeHook;
+    HOST_pGpioHook = TEST_GpioHook;
+    HOST_pTimeHook = TEST_TimeHook;
+    BMP280_SIM_Init(TASK_READ_SEN_BMP280_ADR);
+
+    (void)ONE_WIRE_SIM_AddDevice(ONE_WIRE_SIM_MakeRom(0x28U, 0x101U), TEST_DS18B20_RAW);
+    (void)ONE_WIRE_SIM_AddDevice(ONE_WIRE_SIM_MakeRom(0x28U, 0x102U), TEST_DS18B20_RAW);
+
+    aData[0] = (uint8_t)(TEST_AM2305_HUMIDITY >> 8);
+    aData[1] = (uint8_t)TEST_AM2305_HUMIDITY;
+    aData[2] = (uint8_t)(TEST_AM2305_TEMPERATURE >> 8);
+    aData[3] = (uint8_t)TEST_AM2305_TEMPERATURE;
+    aData[4] = (uint8_t)(aData[0] + aData[1] + aData[2] + aData[3]);
+    nQty = AM2305_SIM_MakeTrace(aData, AM2305_SIM_T_GO_US, 0U, aEdge);
+    AM2305_SIM_SetTrace(aEdge, nQty);
+
+    ADC_SIM_SetCounts(INIT_ANEMOMETER_INDEX, TEST_aWindCounts, TEST_QTY_WIND_COUNTS);
+    ADC_SIM_SetCounts(INIT_BAT_INDEX, (const uint32_t[]){ TEST_BAT_COUNTS }, 1U);
+
+    ONE_WIRE_init();
+    AM2305_Init();
+
+    HOST_TaskCreate(vTaskReadSensors, NULL);
+}
+
+static void TEST_GpioHook(GPIO_TypeDef *const pPort, const uint32_t nPin, const uint32_t nLevel)
+{
+    if ((INIT_PWR_ANEMOMETER_PORT == pPort) && (0U != (nPin & INIT_PWR_ANEMOMETER_PIN)) && (0U != nLevel))
+    {
+        TEST_nPowerOnUs = HOST_nTimeUs;
+    }
+    if ((AM2305_GPIO_PORT == pPort) && (0U != (nPin & AM2305_PIN)) && (0U == nLevel))
+    {
+        TEST_nAm2305StartUs = HOST_nTimeUs;
+    }
+
+    TEST_pOneWireGpio(pPort, nPin, nLevel);
+    TEST_pAm2305Gpio(pPort, nPin, nLevel);
+}
+
+static void TEST_TimeHook(const uint64_t nTimeUs)
+{
+    TEST_pOneWireTime(nTimeUs);
+    TEST_pAm2305Time(nTimeUs);
+    TEST_pAdcTime(nTimeUs);
+}
+
+//****************************************** end of file *******************************************
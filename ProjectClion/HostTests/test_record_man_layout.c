@@ -0,0 +1,333 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_record_man_layout.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the layout version of the records.
+//
+//                The flash is prepared as the old builds left it: 28-byte records of the
+//                version 1 or 32-byte records of the version 2 with the float Pa of the
+//                pressure, EMEEP bank 1 without the version or with the version 2. After the
+//                restart the unsent old records must be converted, the records of the current
+//                version must be kept as they are and the version must be stored. The module is
+//                included to restart it.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+
+// Module under test
+#include "record_manager.c"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Records of the version 1 in the flash
+#define TEST_QTY_V1_RECORDS             (500U)
+
+// Records of the version 1 already sent
+#define TEST_QTY_V1_SENT                (380U)
+
+// Record of the version 1 with the broken CRC
+#define TEST_V1_BROKEN_RECORD           (450U)
+
+// Items of the version 1
+#define TEST_V1_ITEMS_BYTES             (6U * RECORD_MAN_SIZEOF_ITEM)
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// Record of the version 2, the version 1 without the gust
+typedef struct TEST_RECORD_V2_struct
+{
+    uint32_t nUnixTime;
+    float fTemperature;
+    float fHumidity;
+    float fPressure;
+    float fWindSpeed;
+    float fBatteryVoltage;
+    float fWindGust;
+}TEST_RECORD_V2;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Restart(void);
+static void TEST_EraseBank1(void);
+static uint32_t TEST_LoadU32(const uint32_t nVirAdr);
+static void TEST_StoreU32(const uint32_t nVirAdr, uint32_t nValue);
+static void TEST_MakeOldRecord(const uint32_t nNumber, TEST_RECORD_V2 *const pRecord);
+static void TEST_MakeRecord(const uint32_t nNumber, RECORD_MAN_TYPE_RECORD *const pRecord);
+static void TEST_WriteOldRecords(const uint32_t nQty, const uint32_t nSizeRecord);
+static BOOLEAN TEST_IsConverted(const uint32_t nBase, const uint32_t nFirst, const uint32_t nEnd,
+                                const uint32_t nBroken);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    RECORD_MAN_TYPE_RECORD stRecord;
+    uint8_t aRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint8_t aLoaded[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nQty = 0U;
+    uint32_t nBytes = 0U;
+    uint32_t nBase = 0U;
+    uint32_t nRecord = 0U;
+    uint32_t nMaxQtyV1 = 0U;
+    uint8_t *pMem = NULL;
+
+    TEST_CHECK(32U == RECORD_MAN_SIZE_OF_RECORD_BYTES);
+    TEST_CHECK(28U == RECORD_MAN_V1_SIZE_OF_RECORD_BYTES);
+
+    // New flash: the version is stored, the numbers start from 0
+    W25Q_SIM_Init();
+    pMem = W25Q_SIM_GetMemory();
+    TEST_Restart();
+    TEST_CHECK(RECORD_MAN_LAYOUT_VERSION == TEST_LoadU32(RECORD_MAN_VIR_ADR_LAYOUT));
+    TEST_CHECK(0U == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(0U == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+
+    // Version 1: the unsent records are converted after the old ones
+    TEST_WriteOldRecords(TEST_QTY_V1_RECORDS, RECORD_MAN_V1_SIZE_OF_RECORD_BYTES);
+    pMem[(TEST_V1_BROKEN_RECORD * RECORD_MAN_V1_SIZE_OF_RECORD_BYTES) + 5U] ^= 0x10U;
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD, TEST_QTY_V1_RECORDS);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_LAST_RECORD, TEST_QTY_V1_SENT);
+    TEST_EraseBank1();
+    TEST_Restart();
+
+    nBase = ((TEST_QTY_V1_RECORDS * 28U) + 31U) / 32U;
+    TEST_CHECK(RECORD_MAN_LAYOUT_VERSION == TEST_LoadU32(RECORD_MAN_VIR_ADR_LAYOUT));
+    TEST_CHECK(nBase == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+    TEST_CHECK((nBase + (TEST_QTY_V1_RECORDS - TEST_QTY_V1_SENT - 1U)) ==
+               TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+
+    TEST_CHECK(TRUE == TEST_IsConverted(nBase, TEST_QTY_V1_SENT, TEST_QTY_V1_RECORDS, TEST_V1_BROKEN_RECORD));
+    nRecord = nBase + (TEST_QTY_V1_RECORDS - TEST_QTY_V1_SENT - 1U);
+
+    // The gust of the old records is the mean, the pressure is the integer of the float Pa
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Load(nBase, aLoaded, &nBytes));
+    memcpy(&stRecord, aLoaded, sizeof(stRecord));
+    TEST_CHECK(stRecord.fWindGust == stRecord.fWindSpeed);
+    TEST_CHECK(((98000U + TEST_QTY_V1_SENT) * RECORD_MAN_PRESSURE_SCALE + 25U) == stRecord.nPressure);
+
+    // The log continues after the converted records
+    TEST_MakeRecord(9999U, (RECORD_MAN_TYPE_RECORD *)aRecord);
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQty));
+    TEST_CHECK((nRecord + 1U) == nQty);
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Load(nRecord, aLoaded, &nBytes));
+    TEST_CHECK(0 == memcmp(aRecord, aLoaded, sizeof(stRecord)));
+
+    // The version is kept, the next restart changes nothing
+    TEST_Restart();
+    TEST_CHECK(nBase == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+    TEST_CHECK((nRecord + 1U) == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+
+    // Version 2: the unsent records are converted after the old ones of the same size
+    W25Q_SIM_Init();
+    TEST_Restart();
+    TEST_WriteOldRecords(TEST_QTY_V1_RECORDS, RECORD_MAN_SIZE_OF_RECORD_BYTES);
+    pMem[(TEST_V1_BROKEN_RECORD * RECORD_MAN_SIZE_OF_RECORD_BYTES) + 5U] ^= 0x10U;
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD, TEST_QTY_V1_RECORDS);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_LAST_RECORD, TEST_QTY_V1_SENT);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR_LAYOUT, 2U);
+    TEST_Restart();
+    TEST_CHECK(RECORD_MAN_LAYOUT_VERSION == TEST_LoadU32(RECORD_MAN_VIR_ADR_LAYOUT));
+    TEST_CHECK(TEST_QTY_V1_RECORDS == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+    TEST_CHECK((TEST_QTY_V1_RECORDS + (TEST_QTY_V1_RECORDS - TEST_QTY_V1_SENT - 1U)) ==
+               TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(TRUE == TEST_IsConverted(TEST_QTY_V1_RECORDS, TEST_QTY_V1_SENT, TEST_QTY_V1_RECORDS,
+                                        TEST_V1_BROKEN_RECORD));
+
+    // The records of the current version are kept by the next restart
+    nRecord = TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD) - 1U;
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Load(nRecord, aRecord, &nBytes));
+    TEST_Restart();
+    TEST_CHECK(TEST_QTY_V1_RECORDS == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+    TEST_CHECK((nRecord + 1U) == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Load(nRecord, aLoaded, &nBytes));
+    TEST_CHECK(0 == memcmp(aRecord, aLoaded, sizeof(stRecord)));
+
+    // 32-byte records without the version are of the builds before the marker: version 2
+    W25Q_SIM_Init();
+    TEST_Restart();
+    TEST_WriteOldRecords(TEST_QTY_V1_RECORDS, RECORD_MAN_SIZE_OF_RECORD_BYTES);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD, TEST_QTY_V1_RECORDS);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_LAST_RECORD, TEST_QTY_V1_SENT);
+    TEST_EraseBank1();
+    TEST_Restart();
+    TEST_CHECK(RECORD_MAN_LAYOUT_VERSION == TEST_LoadU32(RECORD_MAN_VIR_ADR_LAYOUT));
+    TEST_CHECK(TEST_QTY_V1_RECORDS == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+    TEST_CHECK(TRUE == TEST_IsConverted(TEST_QTY_V1_RECORDS, TEST_QTY_V1_SENT, TEST_QTY_V1_RECORDS,
+                                        TEST_QTY_V1_RECORDS));
+
+    // Version 1, all records sent: the log continues after the old records
+    W25Q_SIM_Init();
+    TEST_Restart();
+    TEST_WriteOldRecords(TEST_QTY_V1_RECORDS, RECORD_MAN_V1_SIZE_OF_RECORD_BYTES);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD, TEST_QTY_V1_RECORDS);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_LAST_RECORD, TEST_QTY_V1_RECORDS);
+    TEST_EraseBank1();
+    TEST_Restart();
+    TEST_CHECK(nBase == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(nBase == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQty));
+    TEST_CHECK((nBase + 1U) == nQty);
+
+    // Version 1 up to the end of the area: no room for the unsent records
+    W25Q_SIM_Init();
+    TEST_Restart();
+    nMaxQtyV1 = (RECORD_MAN_nMaxQtyRecords * 32U) / 28U;
+    TEST_WriteOldRecords(nMaxQtyV1, RECORD_MAN_V1_SIZE_OF_RECORD_BYTES);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD, nMaxQtyV1);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_LAST_RECORD, nMaxQtyV1 - 10U);
+    TEST_EraseBank1();
+    TEST_Restart();
+    TEST_CHECK(RECORD_MAN_LAYOUT_VERSION == TEST_LoadU32(RECORD_MAN_VIR_ADR_LAYOUT));
+    TEST_CHECK(RECORD_MAN_nMaxQtyRecords == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(RECORD_MAN_nMaxQtyRecords == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+    TEST_CHECK(RESULT_NOT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQty));
+
+    return HOST_Result("test_record_man_layout");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void TEST_Restart(void)
+{
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    EMEEP_DeInit();
+    RECORD_MAN_bInitialezed = FALSE;
+    RECORD_MAN_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+}
+
+static void TEST_EraseBank1(void)
+{
+    memset(&W25Q_SIM_GetMemory()[W25Q_SIM_CAPACITY_BYTES - (4U * W25Q_CAPACITY_SECTOR_BYTES)], 0xFF,
+           2U * W25Q_CAPACITY_SECTOR_BYTES);
+}
+
+static uint32_t TEST_LoadU32(const uint32_t nVirAdr)
+{
+    uint32_t nValue = 0U;
+
+    TEST_CHECK(RESULT_OK == EMEEP_Load(nVirAdr, (U8*)&nValue, sizeof(nValue)));
+
+    return nValue;
+}
+
+static void TEST_StoreU32(const uint32_t nVirAdr, uint32_t nValue)
+{
+    TEST_CHECK(RESULT_OK == EMEEP_Store(nVirAdr, (U8*)&nValue, sizeof(nValue)));
+}
+
+// Old record, the gust of the version 2 is the mean as after the conversion of the version 1
+static void TEST_MakeOldRecord(const uint32_t nNumber, TEST_RECORD_V2 *const pRecord)
+{
+    pRecord->nUnixTime = 1700000000UL + (nNumber * 600UL);
+    pRecord->fTemperature = -20.0f + ((float)nNumber * 0.125f);
+    pRecord->fHumidity = 30.0f + (float)(nNumber % 60U);
+    pRecord->fPressure = 98000.25f + (float)nNumber;
+    pRecord->fWindSpeed = (float)(nNumber % 17U) * 0.5f;
+    pRecord->fBatteryVoltage = 3.3f + ((float)(nNumber % 8U) * 0.1f);
+    pRecord->fWindGust = pRecord->fWindSpeed;
+}
+
+// Record of the current version converted from the old record
+static void TEST_MakeRecord(const uint32_t nNumber, RECORD_MAN_TYPE_RECORD *const pRecord)
+{
+    TEST_RECORD_V2 stOld;
+
+    TEST_MakeOldRecord(nNumber, &stOld);
+    pRecord->nUnixTime = stOld.nUnixTime;
+    pRecord->fTemperature = stOld.fTemperature;
+    pRecord->fHumidity = stOld.fHumidity;
+    pRecord->nPressure = ((98000U + nNumber) * RECORD_MAN_PRESSURE_SCALE) + 25U;
+    pRecord->fWindSpeed = stOld.fWindSpeed;
+    pRecord->fBatteryVoltage = stOld.fBatteryVoltage;
+    pRecord->fWindGust = stOld.fWindGust;
+}
+
+// Old records from the start of the flash as the previous builds stored them
+static void TEST_WriteOldRecords(const uint32_t nQty, const uint32_t nSizeRecord)
+{
+    TEST_RECORD_V2 stRecord;
+    const uint32_t nItemsBytes = (RECORD_MAN_V1_SIZE_OF_RECORD_BYTES == nSizeRecord) ?
+                                 TEST_V1_ITEMS_BYTES : sizeof(stRecord);
+    uint8_t *const pMem = W25Q_SIM_GetMemory();
+    uint8_t *pRecord = NULL;
+
+    for (uint32_t nNumber = 0U; nNumber < nQty; nNumber++)
+    {
+        pRecord = &pMem[nNumber * nSizeRecord];
+        TEST_MakeOldRecord(nNumber, &stRecord);
+        memcpy(pRecord, &stRecord, nItemsBytes);
+        memset(&pRecord[nItemsBytes], 0, nSizeRecord - 1U - nItemsBytes);
+        pRecord[nSizeRecord - 1U] = CH_SUM_CalculateCRC8(pRecord, nSizeRecord - 1U);
+    }
+}
+
+// The old records from the first one up to the end, but the broken one, follow the base
+static BOOLEAN TEST_IsConverted(const uint32_t nBase, const uint32_t nFirst, const uint32_t nEnd,
+                                const uint32_t nBroken)
+{
+    RECORD_MAN_TYPE_RECORD stRecord;
+    uint8_t aLoaded[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nBytes = 0U;
+    uint32_t nRecord = nBase;
+    BOOLEAN bSame = TRUE;
+
+    for (uint32_t nNumber = nFirst; nNumber < nEnd; nNumber++)
+    {
+        if (nBroken != nNumber)
+        {
+            TEST_MakeRecord(nNumber, &stRecord);
+            if ((RESULT_OK != RECORD_MAN_Load(nRecord, aLoaded, &nBytes)) ||
+                (RECORD_MAN_SIZE_OF_RECORD_BYTES != nBytes) ||
+                (0 != memcmp(&stRecord, aLoaded, sizeof(stRecord))))
+            {
+                bSame = FALSE;
+            }
+            nRecord++;
+        }
+    }
+
+    return bSame;
+}
+
+//****************************************** end of file *******************************************
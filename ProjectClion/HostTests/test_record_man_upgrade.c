@@ -0,0 +1,157 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_record_man_upgrade.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the upgrade from the layout with 3 reserved sectors.
+//
+//                The flash is prepared as the previous layout left it: records logged into
+//                the sectors which are now EMEEP bank 1 and the spare sector, the next and the
+//                last sent record numbers above the records area. After the restart the
+//                numbers must be cut to the records area, the records below must be kept and
+//                bank 1 must work over the old record data. The module is included to restart
+//                it.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+
+// Module under test
+#include "record_manager.c"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Records area of the previous layout, 3 reserved sectors
+#define TEST_OLD_QTY_RESERVED_SECTORS   (3U)
+
+// Records logged above the new records area
+#define TEST_QTY_LOST_RECORDS           (200U)
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Restart(void);
+static uint32_t TEST_LoadU32(const uint32_t nVirAdr);
+static void TEST_StoreU32(const uint32_t nVirAdr, uint32_t nValue);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    uint8_t aRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint8_t aLoaded[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nQty = 0U;
+    uint32_t nBytes = 0U;
+    uint32_t nOldMax = 0U;
+    uint8_t *pMem = NULL;
+
+    W25Q_SIM_Init();
+    pMem = W25Q_SIM_GetMemory();
+    TEST_Restart();
+
+    nOldMax = (W25Q_SIM_CAPACITY_BYTES - (TEST_OLD_QTY_RESERVED_SECTORS * W25Q_CAPACITY_SECTOR_BYTES)) /
+              RECORD_MAN_SIZE_OF_RECORD_BYTES;
+    TEST_CHECK(RECORD_MAN_nMaxQtyRecords < nOldMax);
+    TEST_CHECK((RECORD_MAN_nMaxQtyRecords + TEST_QTY_LOST_RECORDS) <= nOldMax);
+
+    // Numbers inside of the area are not changed
+    memset(aRecord, 0x5A, sizeof(aRecord));
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQty));
+    TEST_CHECK(1U == nQty);
+    TEST_Restart();
+    TEST_CHECK(1U == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(0U == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+
+    // Previous layout: records up to the old end, bank 1 sectors hold record data
+    memset(&pMem[RECORD_MAN_nMaxQtyRecords * RECORD_MAN_SIZE_OF_RECORD_BYTES], 0x21,
+           TEST_QTY_LOST_RECORDS * RECORD_MAN_SIZE_OF_RECORD_BYTES);
+    memset(&pMem[W25Q_SIM_CAPACITY_BYTES - (4U * W25Q_CAPACITY_SECTOR_BYTES)], 0x21,
+           2U * W25Q_CAPACITY_SECTOR_BYTES);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD, RECORD_MAN_nMaxQtyRecords + TEST_QTY_LOST_RECORDS);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_LAST_RECORD, RECORD_MAN_nMaxQtyRecords + 10U);
+
+    TEST_Restart();
+    TEST_CHECK(RECORD_MAN_nMaxQtyRecords == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(RECORD_MAN_nMaxQtyRecords == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+
+    // The area is full as before the upgrade, the old records are kept
+    TEST_CHECK(RESULT_NOT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQty));
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Load(0U, aLoaded, &nBytes));
+    TEST_CHECK(0 == memcmp(aRecord, aLoaded, sizeof(aRecord) - 1U));
+    TEST_CHECK(RESULT_NOT_OK == RECORD_MAN_Load(RECORD_MAN_nMaxQtyRecords, aLoaded, &nBytes));
+
+    // Bank 1 is formatted over the old record data
+    TEST_StoreU32(RECORD_MAN_VIR_ADR_DS18B20_QTY, 2U);
+    TEST_Restart();
+    TEST_CHECK(2U == TEST_LoadU32(RECORD_MAN_VIR_ADR_DS18B20_QTY));
+
+    // Last sent record below the end is kept
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD, RECORD_MAN_nMaxQtyRecords + 1U);
+    TEST_StoreU32(RECORD_MAN_VIR_ADR32_LAST_RECORD, 7U);
+    TEST_Restart();
+    TEST_CHECK(RECORD_MAN_nMaxQtyRecords == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(7U == TEST_LoadU32(RECORD_MAN_VIR_ADR32_LAST_RECORD));
+
+    return HOST_Result("test_record_man_upgrade");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void TEST_Restart(void)
+{
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    EMEEP_DeInit();
+    RECORD_MAN_bInitialezed = FALSE;
+    RECORD_MAN_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+}
+
+static uint32_t TEST_LoadU32(const uint32_t nVirAdr)
+{
+    uint32_t nValue = 0U;
+
+    TEST_CHECK(RESULT_OK == EMEEP_Load(nVirAdr, (U8*)&nValue, sizeof(nValue)));
+
+    return nValue;
+}
+
+static void TEST_StoreU32(const uint32_t nVirAdr, uint32_t nValue)
+{
+    TEST_CHECK(RESULT_OK == EMEEP_Store(nVirAdr, (U8*)&nValue, sizeof(nValue)));
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,281 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_w25q_cache.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Stress test of the page cache of the W25Q driver.
+//
+//                Random reads, programs and erases over a small window, so the cache lines
+//                are hit, replaced and invalidated all the time. Every read is cross-checked
+//                against the raw memory of the simulator, the programs and erases against a
+//                shadow copy. After every operation the mutex of the driver must be free and
+//                the simulator must not see a transaction without the mutex, an access to
+//                the chip in deep power-down or a delay inside of a critical section.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+#include "W25Q_drv.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Window of the test, 4 blocks of 64 KB
+#define TEST_BASE_ADR               (0x00100000UL)
+#define TEST_WINDOW_BYTES           (0x00040000UL)
+
+// Quantity of the random operations
+#define TEST_QTY_OPERATIONS         (20000U)
+
+// Longest read, longer than a cache line to cover the bypass
+#define TEST_MAX_READ_BYTES         (600U)
+
+// Longest program, crosses up to 3 pages
+#define TEST_MAX_WRITE_BYTES        (600U)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+static uint8_t TEST_aShadow[TEST_WINDOW_BYTES];
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static uint32_t TEST_Random(const uint32_t nRange);
+static void TEST_CheckRead(const uint32_t nAdr, const uint32_t nLen);
+static void TEST_CheckState(void);
+static void TEST_Write(const uint32_t nAdr, const uint32_t nLen);
+static void TEST_Erase(const uint32_t nAdr, const W25Q_TYPE_BLOCKS enType, const uint32_t nSize);
+static void TEST_Deterministic(void);
+static void TEST_RandomOperations(void);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    const W25Q_GEOMETRY *pGeometry = NULL;
+
+    srand(29U);
+    W25Q_SIM_Init();
+    memset(TEST_aShadow, 0xFF, sizeof(TEST_aShadow));
+
+    // The driver is started before the scheduler as in main()
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    W25Q_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+
+    pGeometry = W25Q_GetGeometry();
+    TEST_CHECK(TRUE == pGeometry->bSfdpValid);
+    TEST_CHECK(W25Q_SIM_CAPACITY_BYTES == pGeometry->nCapacityBytes);
+    TEST_CHECK(4096U == pGeometry->nSectorBytes);
+    TEST_CHECK(65536U == pGeometry->nBlockBytes);
+    TEST_CHECK(256U == pGeometry->nPageBytes);
+
+    TEST_Deterministic();
+    TEST_RandomOperations();
+
+    return HOST_Result("test_w25q_cache");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static uint32_t TEST_Random(const uint32_t nRange)
+{
+    return (uint32_t)rand() % nRange;
+}
+
+static void TEST_CheckRead(const uint32_t nAdr, const uint32_t nLen)
+{
+    static uint8_t aData[TEST_MAX_READ_BYTES];
+
+    memset(aData, 0xA5, nLen);
+    TEST_CHECK(RESULT_OK == W25Q_ReadData(TEST_BASE_ADR + nAdr, aData, nLen));
+    TEST_CHECK(0 == memcmp(aData, &W25Q_SIM_GetMemory()[TEST_BASE_ADR + nAdr], nLen));
+    TEST_CHECK(0 == memcmp(aData, &TEST_aShadow[nAdr], nLen));
+}
+
+static void TEST_CheckState(void)
+{
+    W25Q_SIM_STAT stat;
+
+    W25Q_SIM_GetStat(&stat);
+    TEST_CHECK(0U == HOST_GetRecursiveDepth());
+    TEST_CHECK(0U == stat.nUnlocked);
+    TEST_CHECK(0U == stat.nViolations);
+    TEST_CHECK(0U == HOST_nDelayInCritical);
+    TEST_CHECK(0U == HOST_nCriticalDepth);
+}
+
+static void TEST_Write(const uint32_t nAdr, const uint32_t nLen)
+{
+    static uint8_t aData[TEST_MAX_WRITE_BYTES];
+
+    for (uint32_t i = 0U; i < nLen; i++)
+    {
+        aData[i] = (uint8_t)TEST_Random(256U);
+        TEST_aShadow[nAdr + i] &= aData[i];
+    }
+
+    // The driver overwrites the buffer with MISO, the shadow keeps the data
+    TEST_CHECK(RESULT_OK == W25Q_WriteData(TEST_BASE_ADR + nAdr, aData, nLen));
+}
+
+static void TEST_Erase(const uint32_t nAdr, const W25Q_TYPE_BLOCKS enType, const uint32_t nSize)
+{
+    const uint32_t nStart = nAdr & ~(nSize - 1U);
+
+    memset(&TEST_aShadow[nStart], 0xFF, nSize);
+    TEST_CHECK(RESULT_OK == W25Q_EraseBlock(TEST_BASE_ADR + nAdr, enType));
+}
+
+static void TEST_Deterministic(void)
+{
+    W25Q_CACHE_STAT stat;
+    W25Q_SIM_STAT simStat;
+    uint32_t nTakes = 0U;
+
+    W25Q_ResetCache();
+
+    // Miss, then a hit without SPI traffic but with the mutex taken
+    TEST_CheckRead(0x100U, 16U);
+    W25Q_SIM_GetStat(&simStat);
+    nTakes = HOST_GetRecursiveTakes();
+    TEST_CheckRead(0x108U, 8U);
+    TEST_CHECK(HOST_GetRecursiveTakes() > nTakes);
+    {
+        W25Q_SIM_STAT simStat2;
+        W25Q_SIM_GetStat(&simStat2);
+        TEST_CHECK(simStat.nTransactions == simStat2.nTransactions);
+    }
+    W25Q_GetCacheStat(&stat);
+    TEST_CHECK(1U == stat.nMisses);
+    TEST_CHECK(1U == stat.nHits);
+
+    // Program of the cached page must be seen by the next read
+    TEST_Write(0x104U, 8U);
+    TEST_CheckRead(0x100U, 16U);
+
+    // Erase of the sector with the cached page
+    TEST_CheckRead(0x1000U, 32U);
+    TEST_Erase(0x1010U, W25Q_BLOCK_MEMORY_4KB, 4096U);
+    TEST_CheckRead(0x1000U, 32U);
+
+    // Idle flash enters deep power-down and wakes up on the next access
+    #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+    HOST_AdvanceUs((W25Q_POWER_DOWN_IDLE_MS + 1U) * 1000U);
+    W25Q_PowerProcess();
+    TEST_CHECK(TRUE == W25Q_SIM_IsPoweredDown());
+    TEST_CHECK(0U == HOST_GetRecursiveDepth());
+    // Cached page is read without the chip
+    TEST_CheckRead(0x100U, 16U);
+    TEST_CHECK(TRUE == W25Q_SIM_IsPoweredDown());
+    TEST_CheckRead(0x2000U, 16U);
+    TEST_CHECK(FALSE == W25Q_SIM_IsPoweredDown());
+    #endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+
+    TEST_CheckState();
+}
+
+static void TEST_RandomOperations(void)
+{
+    W25Q_CACHE_STAT stat;
+    W25Q_SIM_STAT simStat;
+    uint32_t nAdr = 0U;
+    uint32_t nLen = 0U;
+    uint32_t nOp = 0U;
+
+    W25Q_ResetCache();
+    W25Q_SIM_ResetStat();
+
+    for (uint32_t i = 0U; i < TEST_QTY_OPERATIONS; i++)
+    {
+        nOp = TEST_Random(100U);
+
+        if (nOp < 65U)
+        {
+            // Mostly short reads near each other to hit the cache
+            nLen = (nOp < 55U) ? (1U + TEST_Random(64U)) : (1U + TEST_Random(TEST_MAX_READ_BYTES));
+            nAdr = (nOp < 40U) ? TEST_Random(4U * 256U) : TEST_Random(TEST_WINDOW_BYTES - nLen);
+            TEST_CheckRead(nAdr, nLen);
+        }
+        else if (nOp < 90U)
+        {
+            nLen = 1U + TEST_Random(TEST_MAX_WRITE_BYTES);
+            nAdr = (nOp < 80U) ? TEST_Random(4U * 256U) : TEST_Random(TEST_WINDOW_BYTES - nLen);
+            TEST_Write(nAdr, nLen);
+        }
+        else if (nOp < 97U)
+        {
+            TEST_Erase(TEST_Random(TEST_WINDOW_BYTES), W25Q_BLOCK_MEMORY_4KB, 4096U);
+        }
+        else if (nOp < 98U)
+        {
+            TEST_Erase(TEST_Random(TEST_WINDOW_BYTES), W25Q_BLOCK_MEMORY_32KB, 32768U);
+        }
+        else if (nOp < 99U)
+        {
+            TEST_Erase(TEST_Random(TEST_WINDOW_BYTES), W25Q_BLOCK_MEMORY_64KB, 65536U);
+        }
+        else
+        {
+            #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+            HOST_AdvanceUs((W25Q_POWER_DOWN_IDLE_MS + 1U) * 1000U);
+            W25Q_PowerProcess();
+            TEST_CHECK(TRUE == W25Q_SIM_IsPoweredDown());
+            #endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+        }
+
+        TEST_CheckState();
+    }
+
+    TEST_CHECK(0 == memcmp(TEST_aShadow, &W25Q_SIM_GetMemory()[TEST_BASE_ADR], TEST_WINDOW_BYTES));
+
+    W25Q_GetCacheStat(&stat);
+    W25Q_SIM_GetStat(&simStat);
+    TEST_CHECK(0U != stat.nHits);
+    TEST_CHECK(0U != stat.nInvalidations);
+    TEST_CHECK(0U != simStat.nPowerDownCnt);
+    printf("cache: %lu hits, %lu misses, %lu bypass, %lu invalidations, hit rate %lu%%\n",
+           (unsigned long)stat.nHits, (unsigned long)stat.nMisses, (unsigned long)stat.nBypass,
+           (unsigned long)stat.nInvalidations, (unsigned long)stat.nHitRatePercent);
+    printf("chip: %lu transactions, %lu power-downs\n",
+           (unsigned long)simStat.nTransactions, (unsigned long)simStat.nPowerDownCnt);
+}
+
+//****************************************** end of file *******************************************
@@ -0,0 +1,253 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_w25q_geometry.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the geometry detection of the W25Q driver and of the placement of the
+//                EMEEP banks.
+//
+//                The W25Q256JV of the simulator needs 4-byte addressing above 16 MB. The data
+//                above 16 MB must land at its own address and not at the alias of the lower
+//                16 MB. A glitch of the SFDP read is retried, a persistent SFDP or 4-byte mode
+//                error must not mount the records: no program or erase of the flash, the
+//                numbers of the records are kept for the next restart. The banks formatted at
+//                the end of the 16 MB part must be kept there on the 32 MB part, the records
+//                area ends below them. The module is included to restart it.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+
+// Module under test
+#include "record_manager.c"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Capacity of the W25Q256JV
+#define TEST_CAPACITY_32MB              (W25Q_SIM_MAX_CAPACITY_BYTES)
+
+// Data above 16 MB and its alias of 3-byte addressing
+#define TEST_HIGH_ADR                   (0x01800100UL)
+#define TEST_ALIAS_ADR                  (TEST_HIGH_ADR - W25Q_SIM_CAPACITY_BYTES)
+
+// Records stored before the restarts
+#define TEST_QTY_RECORDS                (10U)
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static void TEST_Restart(void);
+static void TEST_InitPart(const uint32_t nCapacityBytes);
+static void TEST_StoreRecords(const uint32_t nQty);
+static uint32_t TEST_GetFlashWrites(void);
+static uint32_t TEST_LoadU32(const uint32_t nVirAdr);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    uint8_t aData[16];
+    uint8_t aLoaded[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nBytes = 0U;
+    uint32_t nWrites = 0U;
+    uint32_t nStart = 0U;
+    uint32_t nEnd = 0U;
+    uint32_t nMaxQty16 = 0U;
+    uint8_t *pMem = NULL;
+    uint8_t *pImage = NULL;
+    const W25Q_GEOMETRY *pGeometry = W25Q_GetGeometry();
+
+    // 16 MB part: 3-byte addressing, the banks at the end of the flash
+    TEST_InitPart(W25Q_SIM_CAPACITY_BYTES);
+    TEST_Restart();
+    TEST_CHECK(TRUE == RECORD_MAN_bInitialezed);
+    TEST_CHECK(TRUE == pGeometry->bSfdpValid);
+    TEST_CHECK(W25Q_SIM_CAPACITY_BYTES == pGeometry->nCapacityBytes);
+    TEST_CHECK(3U == pGeometry->nAddressBytes);
+    TEST_CHECK(FALSE == W25Q_SIM_Is4ByteMode());
+    TEST_CHECK(RESULT_OK == EMEEP_GetBankArea(0U, &nStart, &nEnd));
+    TEST_CHECK((W25Q_SIM_CAPACITY_BYTES - 1U) == nEnd);
+    TEST_StoreRecords(TEST_QTY_RECORDS);
+    nMaxQty16 = RECORD_MAN_nMaxQtyRecords;
+
+    // 32 MB part: 4-byte addressing, the data above 16 MB is not written to its alias
+    TEST_InitPart(TEST_CAPACITY_32MB);
+    pMem = W25Q_SIM_GetMemory();
+    TEST_Restart();
+    TEST_CHECK(TRUE == RECORD_MAN_bInitialezed);
+    TEST_CHECK(TEST_CAPACITY_32MB == pGeometry->nCapacityBytes);
+    TEST_CHECK(4U == pGeometry->nAddressBytes);
+    TEST_CHECK(TRUE == W25Q_SIM_Is4ByteMode());
+    TEST_CHECK((TEST_CAPACITY_32MB / W25Q_CAPACITY_SECTOR_BYTES) == pGeometry->nQtySectors);
+
+    // The transfer takes the received bytes into the buffer of the data
+    memset(aData, 0xA5, sizeof(aData));
+    TEST_CHECK(RESULT_OK == W25Q_WriteData(TEST_HIGH_ADR, aData, sizeof(aData)));
+    memset(aData, 0xA5, sizeof(aData));
+    TEST_CHECK(0 == memcmp(&pMem[TEST_HIGH_ADR], aData, sizeof(aData)));
+    TEST_CHECK(0xFFU == pMem[TEST_ALIAS_ADR]);
+    memset(aData, 0, sizeof(aData));
+    TEST_CHECK(RESULT_OK == W25Q_ReadData(TEST_HIGH_ADR, aData, sizeof(aData)));
+    TEST_CHECK((0xA5U == aData[0]) && (0xA5U == aData[sizeof(aData) - 1U]));
+    TEST_CHECK(RESULT_OK == W25Q_EraseBlock(TEST_HIGH_ADR, W25Q_BLOCK_MEMORY_4KB));
+    TEST_CHECK(0xFFU == pMem[TEST_HIGH_ADR]);
+
+    // The banks of the new flash are at the end of the 32 MB, the records go above 16 MB
+    TEST_CHECK(RESULT_OK == EMEEP_GetBankArea(0U, &nStart, &nEnd));
+    TEST_CHECK((TEST_CAPACITY_32MB - 1U) == nEnd);
+    TEST_CHECK(RECORD_MAN_nMaxQtyRecords > (2U * nMaxQty16));
+    TEST_StoreRecords(TEST_QTY_RECORDS);
+
+    // Glitch of the SFDP read: detected by the next attempt
+    W25Q_SIM_FailSfdp(W25Q_SFDP_QTY_ATTEMPTS - 1U);
+    TEST_Restart();
+    TEST_CHECK(TRUE == RECORD_MAN_bInitialezed);
+    TEST_CHECK(TEST_CAPACITY_32MB == pGeometry->nCapacityBytes);
+    TEST_CHECK(TEST_QTY_RECORDS == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+
+    // SFDP error: the part is left in 4-byte mode, nothing is mounted or written
+    W25Q_SIM_FailSfdp(W25Q_SFDP_QTY_ATTEMPTS);
+    nWrites = TEST_GetFlashWrites();
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    TEST_CHECK(RESULT_NOT_OK == W25Q_Init());
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+    TEST_CHECK(FALSE == pGeometry->bSfdpValid);
+    W25Q_SIM_FailSfdp(W25Q_SFDP_QTY_ATTEMPTS);
+    TEST_Restart();
+    TEST_CHECK(FALSE == RECORD_MAN_bInitialezed);
+    TEST_CHECK(TRUE == W25Q_SIM_Is4ByteMode());
+    memset(aLoaded, 0x11, sizeof(aLoaded));
+    TEST_CHECK(RESULT_NOT_OK == RECORD_MAN_Store(aLoaded, sizeof(aLoaded), &nBytes));
+    TEST_CHECK(RESULT_NOT_OK == RECORD_MAN_Load(0U, aLoaded, &nBytes));
+    TEST_CHECK(nWrites == TEST_GetFlashWrites());
+
+    // The next restart finds the records where they were
+    TEST_Restart();
+    TEST_CHECK(TRUE == RECORD_MAN_bInitialezed);
+    TEST_CHECK(TEST_QTY_RECORDS == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(RESULT_OK == EMEEP_GetBankArea(0U, &nStart, &nEnd));
+    TEST_CHECK((TEST_CAPACITY_32MB - 1U) == nEnd);
+
+    // 4-byte mode error: the upper 16 MB are not reachable, nothing is mounted
+    TEST_InitPart(TEST_CAPACITY_32MB);
+    W25Q_SIM_Ignore4ByteMode(TRUE);
+    TEST_Restart();
+    TEST_CHECK(FALSE == RECORD_MAN_bInitialezed);
+    TEST_CHECK(FALSE == pGeometry->bSfdpValid);
+    TEST_CHECK(0U == TEST_GetFlashWrites());
+
+    // 32 MB part formatted at the end of 16 MB (the fixed geometry): the banks are kept,
+    // the records area ends below them
+    TEST_InitPart(W25Q_SIM_CAPACITY_BYTES);
+    TEST_Restart();
+    TEST_StoreRecords(TEST_QTY_RECORDS);
+    pImage = malloc(W25Q_SIM_CAPACITY_BYTES);
+    TEST_CHECK(NULL != pImage);
+    memcpy(pImage, W25Q_SIM_GetMemory(), W25Q_SIM_CAPACITY_BYTES);
+    TEST_InitPart(TEST_CAPACITY_32MB);
+    memcpy(pMem, pImage, W25Q_SIM_CAPACITY_BYTES);
+    free(pImage);
+    TEST_Restart();
+    TEST_CHECK(TRUE == RECORD_MAN_bInitialezed);
+    TEST_CHECK(TEST_CAPACITY_32MB == pGeometry->nCapacityBytes);
+    TEST_CHECK(RESULT_OK == EMEEP_GetBankArea(0U, &nStart, &nEnd));
+    TEST_CHECK((W25Q_SIM_CAPACITY_BYTES - 1U) == nEnd);
+    TEST_CHECK(nMaxQty16 == RECORD_MAN_nMaxQtyRecords);
+    TEST_CHECK(TEST_QTY_RECORDS == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(RESULT_OK == RECORD_MAN_Load(TEST_QTY_RECORDS - 1U, aLoaded, &nBytes));
+    TEST_CHECK((uint8_t)(TEST_QTY_RECORDS - 1U) == aLoaded[0]);
+    TEST_StoreRecords(TEST_QTY_RECORDS);
+    TEST_CHECK((2U * TEST_QTY_RECORDS) == TEST_LoadU32(RECORD_MAN_VIR_ADR32_NEXT_RECORD));
+    TEST_CHECK(0xFFU == pMem[TEST_CAPACITY_32MB - 1U]);
+
+    return HOST_Result("test_w25q_geometry");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+static void TEST_Restart(void)
+{
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    EMEEP_DeInit();
+    RECORD_MAN_bInitialezed = FALSE;
+    RECORD_MAN_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+}
+
+// New chip, the pages of the previous one are not cached
+static void TEST_InitPart(const uint32_t nCapacityBytes)
+{
+    W25Q_SIM_InitPart(nCapacityBytes);
+    W25Q_ResetCache();
+}
+
+// Records numbered by the first byte
+static void TEST_StoreRecords(const uint32_t nQty)
+{
+    uint8_t aRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    uint32_t nQtyRecord = 0U;
+
+    for (uint32_t i = 0U; i < nQty; i++)
+    {
+        memset(aRecord, 0x3C, sizeof(aRecord));
+        aRecord[0] = (uint8_t)i;
+        TEST_CHECK(RESULT_OK == RECORD_MAN_Store(aRecord, sizeof(aRecord), &nQtyRecord));
+    }
+}
+
+// Program and erase instructions since the reset of the chip
+static uint32_t TEST_GetFlashWrites(void)
+{
+    W25Q_SIM_STAT stStat;
+
+    W25Q_SIM_GetStat(&stStat);
+
+    return stStat.aCmdCnt[0x02U] + stStat.aCmdCnt[0x20U] + stStat.aCmdCnt[0x52U] +
+           stStat.aCmdCnt[0xD8U] + stStat.aCmdCnt[0xC7U];
+}
+
+static uint32_t TEST_LoadU32(const uint32_t nVirAdr)
+{
+    uint32_t nValue = 0U;
+
+    TEST_CHECK(RESULT_OK == EMEEP_Load(nVirAdr, (U8*)&nValue, sizeof(nValue)));
+
+    return nValue;
+}
+
+//****************************************** end of file *******************************************
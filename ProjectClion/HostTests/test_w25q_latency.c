@@ -0,0 +1,256 @@
+//**************************************************************************************************
+// @Module        HOST
+// @Filename      test_w25q_latency.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      host
+//--------------------------------------------------------------------------------------------------
+// @Compatible    gcc, clang
+//--------------------------------------------------------------------------------------------------
+// @Description   Test of the adaptive BUSY polling and of the latency histogram of the W25Q
+//                driver.
+//
+//                The simulator keeps the chip busy for the typical tPP and tSE of the
+//                W25Q128JV, the virtual time advances only by the delays of the driver. The
+//                latency of every operation must be the schedule of the adaptive polling:
+//                the first delay W25Q_POLL_INITIAL_US, every next one doubled and limited by
+//                the datasheet time. The histogram must hold every operation in the log2
+//                bucket of its latency. The latency and the status polls are compared with
+//                the fixed polling of the first release, one delay of the datasheet time
+//                plus 10% between the polls.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          XX.XX.XXXX
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "host_stubs.h"
+#include "w25q_sim.h"
+#include "W25Q_drv.h"
+
+#include <string.h>
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// Operation of the test and the times of the simulator and of the datasheet
+typedef struct
+{
+    const char *pName;
+    W25Q_OPERATION enOperation;
+    uint32_t nBusyUs;
+    uint32_t nDatasheetUs;
+    uint32_t nQty;
+} TEST_TYPE_OPERATION;
+
+// Latency and status polls of one operation
+typedef struct
+{
+    uint32_t nLatencyUs;
+    uint32_t nPolls;
+} TEST_TYPE_SCHEDULE;
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Area of the test
+#define TEST_BASE_ADR               (0x00200000UL)
+
+// Datasheet times of the driver, us
+#define TEST_PAGE_PRM_TIME_US       (3000UL)
+#define TEST_4KB_ER_TIME_US         (10000UL)
+#define TEST_32KB_ER_TIME_US        (1600000UL)
+#define TEST_64KB_ER_TIME_US        (2000000UL)
+#define TEST_CHIP_ER_TIME_US        (200000000UL)
+
+#define TEST_QTY_OPERATIONS         (5U)
+
+static const TEST_TYPE_OPERATION TEST_aOperation[TEST_QTY_OPERATIONS] =
+{
+    { "page program", W25Q_OP_PAGE_PROGRAM, W25Q_SIM_PAGE_PROGRAM_US, TEST_PAGE_PRM_TIME_US,  16U },
+    { "erase 4 KB",   W25Q_OP_ERASE_4KB,    W25Q_SIM_ERASE_4K_US,     TEST_4KB_ER_TIME_US,    8U },
+    { "erase 32 KB",  W25Q_OP_ERASE_32KB,   W25Q_SIM_ERASE_32K_US,    TEST_32KB_ER_TIME_US,   4U },
+    { "erase 64 KB",  W25Q_OP_ERASE_64KB,   W25Q_SIM_ERASE_64K_US,    TEST_64KB_ER_TIME_US,   4U },
+    { "erase chip",   W25Q_OP_ERASE_CHIP,   W25Q_SIM_ERASE_CHIP_US,   TEST_CHIP_ER_TIME_US,   1U },
+};
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+static TEST_TYPE_SCHEDULE TEST_GetAdaptive(const uint32_t nBusyUs, const uint32_t nDatasheetUs);
+static TEST_TYPE_SCHEDULE TEST_GetFixed(const uint32_t nBusyUs, const uint32_t nDatasheetUs);
+static uint32_t TEST_GetBucket(const uint32_t nLatencyUs);
+static void TEST_Run(const TEST_TYPE_OPERATION *const pOperation, const uint32_t nIndex);
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+int main(void)
+{
+    const TEST_TYPE_OPERATION *pOperation = NULL;
+    W25Q_LATENCY_HIST stHist;
+    W25Q_SIM_STAT stStat;
+    TEST_TYPE_SCHEDULE stAdaptive;
+    TEST_TYPE_SCHEDULE stFixed;
+    uint8_t aData[16];
+
+    W25Q_SIM_Init();
+    HOST_nSchedulerState = taskSCHEDULER_NOT_STARTED;
+    W25Q_Init();
+    HOST_nSchedulerState = taskSCHEDULER_RUNNING;
+
+    // Wrong parameters
+    TEST_CHECK(RESULT_NOT_OK == W25Q_GetLatencyHist(W25Q_OP_QTY, &stHist));
+    TEST_CHECK(RESULT_NOT_OK == W25Q_GetLatencyHist(W25Q_OP_PAGE_PROGRAM, NULL));
+
+    for (uint32_t i = 0U; i < TEST_QTY_OPERATIONS; i++)
+    {
+        pOperation = &TEST_aOperation[i];
+        W25Q_ResetLatencyHist();
+        for (uint32_t j = 0U; j < pOperation->nQty; j++)
+        {
+            TEST_Run(pOperation, j);
+        }
+
+        // Every operation is in the bucket of the latency of the adaptive schedule
+        stAdaptive = TEST_GetAdaptive(pOperation->nBusyUs, pOperation->nDatasheetUs);
+        stFixed = TEST_GetFixed(pOperation->nBusyUs, pOperation->nDatasheetUs);
+        TEST_CHECK(RESULT_OK == W25Q_GetLatencyHist(pOperation->enOperation, &stHist));
+        TEST_CHECK(pOperation->nQty == stHist.nCount);
+        TEST_CHECK(pOperation->nQty == stHist.aBuckets[TEST_GetBucket(stAdaptive.nLatencyUs)]);
+        TEST_CHECK(0U == stHist.nTimeouts);
+        TEST_CHECK(stAdaptive.nLatencyUs == stHist.nMaxUs);
+        TEST_CHECK(((uint64_t)stAdaptive.nLatencyUs * pOperation->nQty) == stHist.nTotalUs);
+        TEST_CHECK((stAdaptive.nPolls * pOperation->nQty) == stHist.nPolls);
+
+        // The chip is not polled long after the end of the operation
+        TEST_CHECK(stAdaptive.nLatencyUs >= pOperation->nBusyUs);
+        TEST_CHECK(stAdaptive.nLatencyUs < ((2U * pOperation->nBusyUs) + W25Q_POLL_INITIAL_US));
+        TEST_CHECK(stAdaptive.nLatencyUs <= stFixed.nLatencyUs);
+
+        printf("test_w25q_latency: %-12s tSIM %9lu us: adaptive %9lu us %2lu polls, "
+               "fixed %9lu us %2lu polls\n",
+               pOperation->pName, (unsigned long)pOperation->nBusyUs,
+               (unsigned long)stAdaptive.nLatencyUs, (unsigned long)stAdaptive.nPolls,
+               (unsigned long)stFixed.nLatencyUs, (unsigned long)stFixed.nPolls);
+    }
+
+    // The page program is the hot path of the records: 4 times faster
+    stAdaptive = TEST_GetAdaptive(W25Q_SIM_PAGE_PROGRAM_US, TEST_PAGE_PRM_TIME_US);
+    stFixed = TEST_GetFixed(W25Q_SIM_PAGE_PROGRAM_US, TEST_PAGE_PRM_TIME_US);
+    TEST_CHECK((stAdaptive.nLatencyUs * 4U) <= stFixed.nLatencyUs);
+
+    // The read of the idle chip polls the status once without a delay
+    W25Q_ResetLatencyHist();
+    TEST_CHECK(RESULT_OK == W25Q_ReadData(TEST_BASE_ADR + 0x10000U, aData, sizeof(aData)));
+    TEST_CHECK(RESULT_OK == W25Q_GetLatencyHist(W25Q_OP_WAIT_READY, &stHist));
+    TEST_CHECK(1U == stHist.nCount);
+    TEST_CHECK(1U == stHist.nPolls);
+    TEST_CHECK(1U == stHist.aBuckets[0]);
+    TEST_CHECK(0U == stHist.nMaxUs);
+
+    // The chip is never accessed while busy
+    W25Q_SIM_GetStat(&stStat);
+    TEST_CHECK(0U == stStat.nViolations);
+
+    return HOST_Result("test_w25q_latency");
+}
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+// Delays of the adaptive polling until the end of the busy time
+static TEST_TYPE_SCHEDULE TEST_GetAdaptive(const uint32_t nBusyUs, const uint32_t nDatasheetUs)
+{
+    TEST_TYPE_SCHEDULE stSchedule = { 0U, 1U };
+    const uint32_t nMaxStepUs = nDatasheetUs + (nDatasheetUs / 10U);
+    uint32_t nStepUs = W25Q_POLL_INITIAL_US;
+
+    while (stSchedule.nLatencyUs < nBusyUs)
+    {
+        stSchedule.nLatencyUs += (nStepUs < nMaxStepUs) ? nStepUs : nMaxStepUs;
+        stSchedule.nPolls++;
+        nStepUs <<= 1U;
+    }
+
+    return stSchedule;
+}
+
+// Delays of the fixed polling of the first release until the end of the busy time
+static TEST_TYPE_SCHEDULE TEST_GetFixed(const uint32_t nBusyUs, const uint32_t nDatasheetUs)
+{
+    TEST_TYPE_SCHEDULE stSchedule = { 0U, 1U };
+    const uint32_t nStepUs = nDatasheetUs + (nDatasheetUs / 10U);
+
+    while (stSchedule.nLatencyUs < nBusyUs)
+    {
+        stSchedule.nLatencyUs += nStepUs;
+        stSchedule.nPolls++;
+    }
+
+    return stSchedule;
+}
+
+// Bucket N holds 2^N..2^(N+1)-1 us
+static uint32_t TEST_GetBucket(const uint32_t nLatencyUs)
+{
+    uint32_t nBucket = 0U;
+
+    while (((nLatencyUs >> nBucket) > 1U) && (nBucket < (W25Q_LATENCY_HISTOGRAM_BUCKETS - 1U)))
+    {
+        nBucket++;
+    }
+
+    return nBucket;
+}
+
+// One operation in its own page or block of the area
+static void TEST_Run(const TEST_TYPE_OPERATION *const pOperation, const uint32_t nIndex)
+{
+    uint8_t aPage[256];
+
+    switch (pOperation->enOperation)
+    {
+        case W25Q_OP_PAGE_PROGRAM:
+            memset(aPage, (int)nIndex, sizeof(aPage));
+            TEST_CHECK(RESULT_OK == W25Q_WriteData(TEST_BASE_ADR + (nIndex * sizeof(aPage)), aPage, sizeof(aPage)));
+            break;
+        case W25Q_OP_ERASE_4KB:
+            TEST_CHECK(RESULT_OK == W25Q_EraseBlock(TEST_BASE_ADR + (nIndex * 4096U), W25Q_BLOCK_MEMORY_4KB));
+            break;
+        case W25Q_OP_ERASE_32KB:
+            TEST_CHECK(RESULT_OK == W25Q_EraseBlock(TEST_BASE_ADR + (nIndex * 32768U), W25Q_BLOCK_MEMORY_32KB));
+            break;
+        case W25Q_OP_ERASE_64KB:
+            TEST_CHECK(RESULT_OK == W25Q_EraseBlock(TEST_BASE_ADR + (nIndex * 65536U), W25Q_BLOCK_MEMORY_64KB));
+            break;
+        default:
+            TEST_CHECK(RESULT_OK == W25Q_EraseBlock(0U, W25Q_BLOCK_MEMORY_ALL));
+            break;
+    }
+}
+
+//****************************************** end of file *******************************************
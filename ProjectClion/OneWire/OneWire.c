@@ -20,6 +20,8 @@
 //                  ONE_WIRE_writeBit()
 //                  ONE_WIRE_readByte()
 //                  ONE_WIRE_writeByte()
+//                  ONE_WIRE_readBytes()
+//                  ONE_WIRE_writeBytes()
 //
 //                Local (private) functions:
 //                  ONE_WIRE_GpioInit()
@@ -48,15 +50,26 @@
 // Get LL GPIO HAL
 #include "stm32l4xx_ll_gpio.h"
 
+// Get UART backend
+#include "OneWire_uart.h"
+
 #include "Init.h"
 
+#include <string.h>
+
 
 
 //**************************************************************************************************
 // Verification of the imported configuration parameters
 //**************************************************************************************************
 
-// None.
+#if ((ONE_WIRE_BACKEND_GPIO != ONE_WIRE_BACKEND) && (ONE_WIRE_BACKEND_UART != ONE_WIRE_BACKEND))
+#error "ONE_WIRE_BACKEND must be ONE_WIRE_BACKEND_GPIO or ONE_WIRE_BACKEND_UART"
+#endif
+
+#if ((ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND) && (ONE_WIRE_CH1_EN == ON))
+#error "UART backend supports channel 0 only"
+#endif
 
 
 
@@ -94,6 +107,8 @@
 #define ONE_WIRE_WRITE_SAMPLE_TIME_US                     (60U)
 // rest time slot
 #define ONE_WIRE_REST_TIME_SLOT_US                        (2U)
+// byte of read time slots
+#define ONE_WIRE_READ_BYTE                                (0xFFU)
 // channel number
 #define ONE_WIRE_CH0                                      (0U)
 #define ONE_WIRE_CH1                                      (1U)
@@ -112,6 +127,7 @@
 // Declarations of local (private) functions
 //**************************************************************************************************
 
+#if (ONE_WIRE_BACKEND_GPIO == ONE_WIRE_BACKEND)
 // Init gpio
 static void ONE_WIRE_GpioInit(void);
 // Set low level on DQ pin
@@ -120,6 +136,7 @@ static STD_RESULT ONE_WIRE_DQLow(uint8_t nCh);
 static STD_RESULT ONE_WIRE_DQInput(uint8_t nCh);
 // Get value on DQ input
 static STD_RESULT ONE_WIRE_DQGetValue(uint8_t nCh, uint8_t *const bitStatus);
+#endif // #if (ONE_WIRE_BACKEND_GPIO == ONE_WIRE_BACKEND)
 
 
 
@@ -142,8 +159,13 @@ static STD_RESULT ONE_WIRE_DQGetValue(uint8_t nCh, uint8_t *const bitStatus);
 //**************************************************************************************************
 void ONE_WIRE_init(void)
 {
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    // UART and DMA init
+    ONE_WIRE_UART_Init();
+#else
     // Gpio init
     ONE_WIRE_GpioInit();
+#endif
 
 }// end of ONE_WIRE_init()
 
@@ -166,6 +188,16 @@ STD_RESULT ONE_WIRE_reset(uint8_t nCh, enONE_WIRE_PRESENCE *const status)
 {
     STD_RESULT result = RESULT_NOT_OK;
 
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    if (ONE_WIRE_CH0 == nCh)
+    {
+        result = ONE_WIRE_UART_Reset(status);
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+#else
     //pull DQ line low
     if (RESULT_OK == ONE_WIRE_DQLow(nCh))
     {
@@ -206,6 +238,7 @@ STD_RESULT ONE_WIRE_reset(uint8_t nCh, enONE_WIRE_PRESENCE *const status)
     {
         result = RESULT_NOT_OK;
     }
+#endif
 
     return result;
 }
@@ -230,6 +263,18 @@ STD_RESULT ONE_WIRE_readBit(uint8_t nCh, uint8_t *const bitVal)
 {
     STD_RESULT result = RESULT_NOT_OK;
 
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    if (ONE_WIRE_CH0 == nCh)
+    {
+        // read time slot is write 1
+        *bitVal = 1U;
+        result = ONE_WIRE_UART_Bit(bitVal);
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+#else
     // pull DQ low to start timeslot
     if (RESULT_OK == ONE_WIRE_DQLow(nCh))
     {
@@ -261,6 +306,7 @@ STD_RESULT ONE_WIRE_readBit(uint8_t nCh, uint8_t *const bitVal)
     {
         result = RESULT_NOT_OK;
     }
+#endif
 
     return result;
 }
@@ -285,6 +331,16 @@ STD_RESULT ONE_WIRE_writeBit(uint8_t nCh, uint8_t bitVal)
 {
     STD_RESULT result = RESULT_NOT_OK;
 
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    if (ONE_WIRE_CH0 == nCh)
+    {
+        result = ONE_WIRE_UART_Bit(&bitVal);
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+#else
     // pull DQ low to start timeslot
     if (RESULT_OK == ONE_WIRE_DQLow(nCh))
     {
@@ -316,6 +372,7 @@ STD_RESULT ONE_WIRE_writeBit(uint8_t nCh, uint8_t bitVal)
     {
         result = RESULT_NOT_OK;
     }
+#endif
 
     return result;
 }
@@ -340,6 +397,19 @@ STD_RESULT ONE_WIRE_readByte(uint8_t nCh, uint8_t *const byteVal)
 {
     STD_RESULT result = RESULT_OK;
 
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    uint8_t temp = ONE_WIRE_READ_BYTE;
+
+    if ((ONE_WIRE_CH0 == nCh) &&
+        (RESULT_OK == ONE_WIRE_UART_Bytes(&temp, 1U)))
+    {
+        *byteVal |= temp;
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+#else
     for (int i=0;i<8;i++)
     {
         uint8_t bitVal=0;
@@ -358,6 +428,7 @@ STD_RESULT ONE_WIRE_readByte(uint8_t nCh, uint8_t *const byteVal)
         // wait for rest of timeslot
         ONE_WIRE_Delay(ONE_WIRE_REST_TIME_SLOT_US);
     }
+#endif
 
     return result;
 }
@@ -379,6 +450,17 @@ STD_RESULT ONE_WIRE_writeByte(uint8_t nCh, uint8_t byteVal)
 {
     STD_RESULT result = RESULT_OK;
 
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    if ((ONE_WIRE_CH0 == nCh) &&
+        (RESULT_OK == ONE_WIRE_UART_Bytes(&byteVal, 1U)))
+    {
+        result = RESULT_OK;
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+#else
     uint8_t temp = 0;
 
     for(int i=0;i<8;i++)
@@ -396,6 +478,7 @@ STD_RESULT ONE_WIRE_writeByte(uint8_t nCh, uint8_t byteVal)
             break;
         }
     }
+#endif
 
     return result;
 }
@@ -403,13 +486,111 @@ STD_RESULT ONE_WIRE_writeByte(uint8_t nCh, uint8_t byteVal)
 
 
 
+//**************************************************************************************************
+// @Function      ONE_WIRE_readBytes()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read bytes
+//--------------------------------------------------------------------------------------------------
+// @Notes         UART backend reads the block by one DMA transaction.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - function completed successfully
+//                RESULT_NOT_OK - function didn't complete successfully
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - number of channel
+//                pData - values being read
+//                qty - quantity of bytes
+//**************************************************************************************************
+STD_RESULT ONE_WIRE_readBytes(uint8_t nCh, uint8_t *const pData, const uint32_t qty)
+{
+    STD_RESULT result = RESULT_OK;
+    uint32_t i = 0U;
+
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    for (i = 0U; i < qty; i++)
+    {
+        pData[i] = ONE_WIRE_READ_BYTE;
+    }
+
+    if (ONE_WIRE_CH0 == nCh)
+    {
+        result = ONE_WIRE_UART_Bytes(pData, qty);
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+#else
+    for (i = 0U; (i < qty) && (RESULT_OK == result); i++)
+    {
+        pData[i] = 0U;
+        result = ONE_WIRE_readByte(nCh, &pData[i]);
+    }
+#endif
+
+    return result;
+}
+//end of ONE_WIRE_readBytes()
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_writeBytes()
+//--------------------------------------------------------------------------------------------------
+// @Description   Write bytes
+//--------------------------------------------------------------------------------------------------
+// @Notes         UART backend writes the block by one DMA transaction.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - function completed successfully
+//                RESULT_NOT_OK - function didn't complete successfully
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCh - number of channel
+//                pData - values being written
+//                qty - quantity of bytes
+//**************************************************************************************************
+STD_RESULT ONE_WIRE_writeBytes(uint8_t nCh, const uint8_t *const pData, const uint32_t qty)
+{
+    STD_RESULT result = RESULT_OK;
+    uint32_t i = 0U;
+
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+    uint8_t aData[ONE_WIRE_UART_MAX_BYTES];
+    uint32_t nBytes = 0U;
+
+    // The bus is read back to the buffer, the source is kept
+    for (i = 0U; (i < qty) && (RESULT_OK == result); i += nBytes)
+    {
+        nBytes = ((qty - i) > ONE_WIRE_UART_MAX_BYTES) ? ONE_WIRE_UART_MAX_BYTES : (qty - i);
+        memcpy(aData, &pData[i], nBytes);
+
+        if (ONE_WIRE_CH0 == nCh)
+        {
+            result = ONE_WIRE_UART_Bytes(aData, nBytes);
+        }
+        else
+        {
+            result = RESULT_NOT_OK;
+        }
+    }
+#else
+    for (i = 0U; (i < qty) && (RESULT_OK == result); i++)
+    {
+        result = ONE_WIRE_writeByte(nCh, pData[i]);
+    }
+#endif
+
+    return result;
+}
+//end of ONE_WIRE_writeBytes()
+
+
+
 //**************************************************************************************************
 //==================================================================================================
 // Definitions of local (private) functions
 //==================================================================================================
 //**************************************************************************************************
 
-
+#if (ONE_WIRE_BACKEND_GPIO == ONE_WIRE_BACKEND)
 
 //**************************************************************************************************
 // @Function      ONE_WIRE_GpioInit()
@@ -578,4 +759,6 @@ static STD_RESULT ONE_WIRE_DQGetValue(uint8_t nCh, uint8_t *const bitStatus)
     return result;
 }// end of ONE_WIRE_DQGetValue()
 
+#endif // #if (ONE_WIRE_BACKEND_GPIO == ONE_WIRE_BACKEND)
+
 //****************************************** end of file *******************************************
\ No newline at end of file
@@ -75,6 +75,10 @@ extern STD_RESULT ONE_WIRE_writeBit(uint8_t nCh, uint8_t bitVal);
 extern STD_RESULT ONE_WIRE_readByte(uint8_t nCh, uint8_t *const byteVal);
 // Write byte
 extern STD_RESULT ONE_WIRE_writeByte(uint8_t nCh, uint8_t byteVal);
+// Read bytes
+extern STD_RESULT ONE_WIRE_readBytes(uint8_t nCh, uint8_t *const pData, const uint32_t qty);
+// Write bytes
+extern STD_RESULT ONE_WIRE_writeBytes(uint8_t nCh, const uint8_t *const pData, const uint32_t qty);
 // Delay in us
 extern void ONE_WIRE_Delay(uint32_t us);
 
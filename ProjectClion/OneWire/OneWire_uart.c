@@ -0,0 +1,545 @@
+//**************************************************************************************************
+// @Module        ONE_WIRE
+// @Filename      OneWire_uart.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      stm32
+//--------------------------------------------------------------------------------------------------
+// @Compatible    stm32l4
+//--------------------------------------------------------------------------------------------------
+// @Description   UART backend of the oneWire functionality.
+//
+//                The USART works in half-duplex mode, DQ is the TX pin and the receiver
+//                reads the bus back. One UART byte is one time slot at 115200 baud:
+//                0xFF - write 1 or read slot, 0x00 - write 0. A slave pulls the line low
+//                during a read slot, so the read back byte is not 0xFF for 0.
+//                Reset is byte 0xF0 at 9600 baud, the presence pulse changes the read
+//                back byte. DMA moves all time slots of a transaction, the calling
+//                task sleeps until the DMA interrupt.
+//
+//
+//                Abbreviations:
+//                  None.
+//
+//
+//                Global (public) functions:
+//                  ONE_WIRE_UART_Init()
+//                  ONE_WIRE_UART_Reset()
+//                  ONE_WIRE_UART_Bit()
+//                  ONE_WIRE_UART_Bytes()
+//
+//                Local (private) functions:
+//                  ONE_WIRE_UART_SetBaudRate()
+//                  ONE_WIRE_UART_Transfer()
+//                  ONE_WIRE_UART_RxCplt()
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          xx.xx.xxxx
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "OneWire_uart.h"
+
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+
+// Get LL USART HAL
+#include "stm32l4xx_ll_usart.h"
+
+// Get RTOS interface
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "Init.h"
+
+
+
+//**************************************************************************************************
+// Verification of the imported configuration parameters
+//**************************************************************************************************
+
+#if (ONE_WIRE_UART_MAX_BYTES == 0U)
+#error "ONE_WIRE_UART_MAX_BYTES must be more than 0"
+#endif
+
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Baud rate of the reset
+#define ONE_WIRE_UART_RESET_BAUD                          (9600U)
+// Baud rate of the time slots
+#define ONE_WIRE_UART_SLOT_BAUD                           (115200U)
+// Reset byte
+#define ONE_WIRE_UART_RESET_BYTE                          (0xF0U)
+// Time slot of write 1 and read
+#define ONE_WIRE_UART_SLOT_1                              (0xFFU)
+// Time slot of write 0
+#define ONE_WIRE_UART_SLOT_0                              (0x00U)
+// Number bits in byte
+#define ONE_WIRE_UART_BITS_IN_BYTE                        (8U)
+// Quantity of time slots in one DMA transaction
+#define ONE_WIRE_UART_MAX_SLOTS                           (ONE_WIRE_UART_MAX_BYTES * ONE_WIRE_UART_BITS_IN_BYTE)
+// Poll period when the RTOS isn't running, us
+#define ONE_WIRE_UART_POLL_PERIOD_US                      (100U)
+
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// UART handler
+static UART_HandleTypeDef ONE_WIRE_UART_Handle;
+
+// DMA handlers
+static DMA_HandleTypeDef ONE_WIRE_UART_DmaTxHandle;
+static DMA_HandleTypeDef ONE_WIRE_UART_DmaRxHandle;
+
+// Time slots to send
+static uint8_t ONE_WIRE_UART_aTx[ONE_WIRE_UART_MAX_SLOTS];
+
+// Time slots read back
+static uint8_t ONE_WIRE_UART_aRx[ONE_WIRE_UART_MAX_SLOTS];
+
+// Task waiting for the end of the transaction
+static TaskHandle_t ONE_WIRE_UART_hTask = NULL;
+
+// Transaction is done
+static volatile BOOLEAN ONE_WIRE_UART_bDone = FALSE;
+
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+// Set baud rate
+static void ONE_WIRE_UART_SetBaudRate(const uint32_t nBaudRate);
+// Send time slots and read the bus back
+static STD_RESULT ONE_WIRE_UART_Transfer(const uint32_t qty);
+// DMA receive complete callback
+static void ONE_WIRE_UART_RxCplt(DMA_HandleTypeDef *hdma);
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_Init()
+//--------------------------------------------------------------------------------------------------
+// @Description   Init UART in half-duplex mode and DMA
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void ONE_WIRE_UART_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    ONE_WIRE_UART_CLK_ENABLE();
+    ONE_WIRE_UART_DMA_CLK_ENABLE();
+
+    // DQ is open drain, a slave can pull it low
+    GPIO_InitStruct.Pin       = ONE_WIRE_UART_TX_PIN;
+    GPIO_InitStruct.Mode      = GPIO_MODE_AF_OD;
+    GPIO_InitStruct.Pull      = GPIO_PULLUP;
+    GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+    GPIO_InitStruct.Alternate = ONE_WIRE_UART_TX_AF;
+    HAL_GPIO_Init(ONE_WIRE_UART_TX_PORT, &GPIO_InitStruct);
+
+    // Configure UART, the receiver reads the TX pin back
+    ONE_WIRE_UART_Handle.Instance            = ONE_WIRE_UART_NUM;
+    ONE_WIRE_UART_Handle.Init.BaudRate       = ONE_WIRE_UART_SLOT_BAUD;
+    ONE_WIRE_UART_Handle.Init.WordLength     = UART_WORDLENGTH_8B;
+    ONE_WIRE_UART_Handle.Init.StopBits       = UART_STOPBITS_1;
+    ONE_WIRE_UART_Handle.Init.Parity         = UART_PARITY_NONE;
+    ONE_WIRE_UART_Handle.Init.Mode           = UART_MODE_TX_RX;
+    ONE_WIRE_UART_Handle.Init.HwFlowCtl      = UART_HWCONTROL_NONE;
+    ONE_WIRE_UART_Handle.Init.OverSampling   = UART_OVERSAMPLING_16;
+    HAL_HalfDuplex_Init(&ONE_WIRE_UART_Handle);
+
+    // Configure DMA memory -> TDR
+    ONE_WIRE_UART_DmaTxHandle.Instance                 = ONE_WIRE_UART_DMA_TX_CHANNEL;
+    ONE_WIRE_UART_DmaTxHandle.Init.Request             = ONE_WIRE_UART_DMA_REQUEST;
+    ONE_WIRE_UART_DmaTxHandle.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    ONE_WIRE_UART_DmaTxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    ONE_WIRE_UART_DmaTxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    ONE_WIRE_UART_DmaTxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    ONE_WIRE_UART_DmaTxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    ONE_WIRE_UART_DmaTxHandle.Init.Mode                = DMA_NORMAL;
+    ONE_WIRE_UART_DmaTxHandle.Init.Priority            = DMA_PRIORITY_HIGH;
+    HAL_DMA_Init(&ONE_WIRE_UART_DmaTxHandle);
+
+    // Configure DMA RDR -> memory
+    ONE_WIRE_UART_DmaRxHandle.Instance                 = ONE_WIRE_UART_DMA_RX_CHANNEL;
+    ONE_WIRE_UART_DmaRxHandle.Init.Request             = ONE_WIRE_UART_DMA_REQUEST;
+    ONE_WIRE_UART_DmaRxHandle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    ONE_WIRE_UART_DmaRxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    ONE_WIRE_UART_DmaRxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    ONE_WIRE_UART_DmaRxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    ONE_WIRE_UART_DmaRxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    ONE_WIRE_UART_DmaRxHandle.Init.Mode                = DMA_NORMAL;
+    ONE_WIRE_UART_DmaRxHandle.Init.Priority            = DMA_PRIORITY_VERY_HIGH;
+    HAL_DMA_Init(&ONE_WIRE_UART_DmaRxHandle);
+    ONE_WIRE_UART_DmaRxHandle.XferCpltCallback = ONE_WIRE_UART_RxCplt;
+
+    HAL_NVIC_SetPriority(ONE_WIRE_UART_DMA_RX_IRQn, ONE_WIRE_UART_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(ONE_WIRE_UART_DMA_RX_IRQn);
+}// end of ONE_WIRE_UART_Init()
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_Reset()
+//--------------------------------------------------------------------------------------------------
+// @Description   Detect slaves
+//--------------------------------------------------------------------------------------------------
+// @Notes         Byte 0xF0 at 9600 baud is the reset pulse, the presence pulse of the slaves
+//                pulls some of the high bits low.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - function completed successfully
+//                RESULT_NOT_OK - function didn't complete successfully
+//--------------------------------------------------------------------------------------------------
+// @Parameters    status - one wire presence pulse or not
+//**************************************************************************************************
+STD_RESULT ONE_WIRE_UART_Reset(enONE_WIRE_PRESENCE *const status)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+
+    ONE_WIRE_UART_SetBaudRate(ONE_WIRE_UART_RESET_BAUD);
+
+    ONE_WIRE_UART_aTx[0] = ONE_WIRE_UART_RESET_BYTE;
+    if (RESULT_OK == ONE_WIRE_UART_Transfer(1U))
+    {
+        if (ONE_WIRE_UART_RESET_BYTE == ONE_WIRE_UART_aRx[0])
+        {
+            *status = ONE_WIRE_NOT_PRESENCE;
+        }
+        else
+        {
+            *status = ONE_WIRE_PRESENCE;
+        }
+        result = RESULT_OK;
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    ONE_WIRE_UART_SetBaudRate(ONE_WIRE_UART_SLOT_BAUD);
+
+    return result;
+}
+// end of ONE_WIRE_UART_Reset()
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_Bit()
+//--------------------------------------------------------------------------------------------------
+// @Description   Write bit and read the bus
+//--------------------------------------------------------------------------------------------------
+// @Notes         Write 1 to read the bit.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - function completed successfully
+//                RESULT_NOT_OK - function didn't complete successfully
+//--------------------------------------------------------------------------------------------------
+// @Parameters    bitVal - value being written / read value
+//**************************************************************************************************
+STD_RESULT ONE_WIRE_UART_Bit(uint8_t *const bitVal)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+
+    ONE_WIRE_UART_aTx[0] = (0U != *bitVal) ? ONE_WIRE_UART_SLOT_1 : ONE_WIRE_UART_SLOT_0;
+    if (RESULT_OK == ONE_WIRE_UART_Transfer(1U))
+    {
+        *bitVal = (ONE_WIRE_UART_SLOT_1 == ONE_WIRE_UART_aRx[0]) ? 1U : 0U;
+        result = RESULT_OK;
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    return result;
+}
+// end of ONE_WIRE_UART_Bit()
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_Bytes()
+//--------------------------------------------------------------------------------------------------
+// @Description   Write bytes and read the bus
+//--------------------------------------------------------------------------------------------------
+// @Notes         LSB first. Write 0xFF to read the byte. Up to ONE_WIRE_UART_MAX_BYTES
+//                are sent by one DMA transaction.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - function completed successfully
+//                RESULT_NOT_OK - function didn't complete successfully
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pData - values being written / read values
+//                qty - quantity of bytes
+//**************************************************************************************************
+STD_RESULT ONE_WIRE_UART_Bytes(uint8_t *const pData, const uint32_t qty)
+{
+    STD_RESULT result = RESULT_OK;
+    uint32_t nDone = 0U;
+    uint32_t nBytes = 0U;
+    uint32_t nByte = 0U;
+    uint32_t nBit = 0U;
+
+    while ((RESULT_OK == result) && (nDone < qty))
+    {
+        nBytes = qty - nDone;
+        if (nBytes > ONE_WIRE_UART_MAX_BYTES)
+        {
+            nBytes = ONE_WIRE_UART_MAX_BYTES;
+        }
+
+        // One time slot per bit
+        for (nByte = 0U; nByte < nBytes; nByte++)
+        {
+            for (nBit = 0U; nBit < ONE_WIRE_UART_BITS_IN_BYTE; nBit++)
+            {
+                ONE_WIRE_UART_aTx[(nByte * ONE_WIRE_UART_BITS_IN_BYTE) + nBit] =
+                    (0U != (pData[nDone + nByte] & (1U << nBit))) ? ONE_WIRE_UART_SLOT_1 : ONE_WIRE_UART_SLOT_0;
+            }
+        }
+
+        result = ONE_WIRE_UART_Transfer(nBytes * ONE_WIRE_UART_BITS_IN_BYTE);
+
+        if (RESULT_OK == result)
+        {
+            for (nByte = 0U; nByte < nBytes; nByte++)
+            {
+                pData[nDone + nByte] = 0U;
+                for (nBit = 0U; nBit < ONE_WIRE_UART_BITS_IN_BYTE; nBit++)
+                {
+                    if (ONE_WIRE_UART_SLOT_1 == ONE_WIRE_UART_aRx[(nByte * ONE_WIRE_UART_BITS_IN_BYTE) + nBit])
+                    {
+                        pData[nDone + nByte] |= (uint8_t)(1U << nBit);
+                    }
+                }
+            }
+            nDone += nBytes;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    return result;
+}
+// end of ONE_WIRE_UART_Bytes()
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_DMA_RX_IRQHandler()
+//--------------------------------------------------------------------------------------------------
+// @Description   DMA interrupt of the received time slots
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void ONE_WIRE_UART_DMA_RX_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&ONE_WIRE_UART_DmaRxHandle);
+}// end of ONE_WIRE_UART_DMA_RX_IRQHandler()
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_SetBaudRate()
+//--------------------------------------------------------------------------------------------------
+// @Description   Set baud rate
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nBaudRate - baud rate
+//**************************************************************************************************
+static void ONE_WIRE_UART_SetBaudRate(const uint32_t nBaudRate)
+{
+    LL_USART_Disable(ONE_WIRE_UART_NUM);
+    LL_USART_SetBaudRate(ONE_WIRE_UART_NUM,
+                         HAL_RCC_GetPCLK1Freq(),
+                         LL_USART_OVERSAMPLING_16,
+                         nBaudRate);
+    LL_USART_Enable(ONE_WIRE_UART_NUM);
+}// end of ONE_WIRE_UART_SetBaudRate()
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_Transfer()
+//--------------------------------------------------------------------------------------------------
+// @Description   Send time slots and read the bus back
+//--------------------------------------------------------------------------------------------------
+// @Notes         The calling task sleeps until the DMA interrupt. Before the scheduler is
+//                started the end of the transaction is polled. Don't call from a critical
+//                section while the scheduler is running.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - all time slots were read back
+//                RESULT_NOT_OK - timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    qty - quantity of time slots in ONE_WIRE_UART_aTx
+//**************************************************************************************************
+static STD_RESULT ONE_WIRE_UART_Transfer(const uint32_t qty)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    const BOOLEAN bRtos = (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) ? TRUE : FALSE;
+    uint32_t nPoll = 0U;
+
+    ONE_WIRE_UART_bDone = FALSE;
+    if (TRUE == bRtos)
+    {
+        ONE_WIRE_UART_hTask = xTaskGetCurrentTaskHandle();
+        // Drop a notification of the previous transaction
+        (void)ulTaskNotifyTake(pdTRUE, 0U);
+    }
+    else
+    {
+        ONE_WIRE_UART_hTask = NULL;
+    }
+
+    // Drop data received before
+    LL_USART_RequestRxDataFlush(ONE_WIRE_UART_NUM);
+    LL_USART_ClearFlag_ORE(ONE_WIRE_UART_NUM);
+
+    if ((HAL_OK == HAL_DMA_Start_IT(&ONE_WIRE_UART_DmaRxHandle,
+                                    LL_USART_DMA_GetRegAddr(ONE_WIRE_UART_NUM, LL_USART_DMA_REG_DATA_RECEIVE),
+                                    (uint32_t)(uintptr_t)ONE_WIRE_UART_aRx,
+                                    qty)) &&
+        (HAL_OK == HAL_DMA_Start(&ONE_WIRE_UART_DmaTxHandle,
+                                 (uint32_t)(uintptr_t)ONE_WIRE_UART_aTx,
+                                 LL_USART_DMA_GetRegAddr(ONE_WIRE_UART_NUM, LL_USART_DMA_REG_DATA_TRANSMIT),
+                                 qty)))
+    {
+        LL_USART_EnableDMAReq_RX(ONE_WIRE_UART_NUM);
+        LL_USART_EnableDMAReq_TX(ONE_WIRE_UART_NUM);
+
+        if (TRUE == bRtos)
+        {
+            (void)ulTaskNotifyTake(pdTRUE, ONE_WIRE_UART_TIMEOUT_MS / portTICK_RATE_MS);
+        }
+        else
+        {
+            while ((FALSE == ONE_WIRE_UART_bDone) &&
+                   (nPoll < ((ONE_WIRE_UART_TIMEOUT_MS * 1000U) / ONE_WIRE_UART_POLL_PERIOD_US)))
+            {
+                ONE_WIRE_Delay(ONE_WIRE_UART_POLL_PERIOD_US);
+                nPoll++;
+            }
+        }
+
+        result = (TRUE == ONE_WIRE_UART_bDone) ? RESULT_OK : RESULT_NOT_OK;
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    LL_USART_DisableDMAReq_TX(ONE_WIRE_UART_NUM);
+    LL_USART_DisableDMAReq_RX(ONE_WIRE_UART_NUM);
+    // Tx channel is done if Rx is, abort makes it ready for the next transaction
+    HAL_DMA_Abort(&ONE_WIRE_UART_DmaTxHandle);
+    if (RESULT_OK != result)
+    {
+        HAL_DMA_Abort(&ONE_WIRE_UART_DmaRxHandle);
+    }
+    else
+    {
+        DoNothing();
+    }
+    ONE_WIRE_UART_hTask = NULL;
+
+    return result;
+}// end of ONE_WIRE_UART_Transfer()
+
+
+
+//**************************************************************************************************
+// @Function      ONE_WIRE_UART_RxCplt()
+//--------------------------------------------------------------------------------------------------
+// @Description   DMA receive complete callback, wakes the waiting task
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called from the interrupt.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hdma - DMA handler
+//**************************************************************************************************
+static void ONE_WIRE_UART_RxCplt(DMA_HandleTypeDef *hdma)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    (void)hdma;
+    ONE_WIRE_UART_bDone = TRUE;
+
+    if (NULL != ONE_WIRE_UART_hTask)
+    {
+        vTaskNotifyGiveFromISR(ONE_WIRE_UART_hTask, &xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}// end of ONE_WIRE_UART_RxCplt()
+
+#endif // #if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+
+//****************************************** end of file *******************************************
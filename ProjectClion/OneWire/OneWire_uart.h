@@ -0,0 +1,66 @@
+//**************************************************************************************************
+// @Module        ONE_WIRE
+// @Filename      OneWire_uart.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the UART backend of the one wire interface.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          xx.xx.xxxx
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef ONE_WIRE_UART_H
+#define ONE_WIRE_UART_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "OneWire.h"
+
+
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+#if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+// Init UART and DMA
+extern void ONE_WIRE_UART_Init(void);
+// Reset
+extern STD_RESULT ONE_WIRE_UART_Reset(enONE_WIRE_PRESENCE *const status);
+// Write bit and read the bus
+extern STD_RESULT ONE_WIRE_UART_Bit(uint8_t *const bitVal);
+// Write bytes and read the bus
+extern STD_RESULT ONE_WIRE_UART_Bytes(uint8_t *const pData, const uint32_t qty);
+#endif // #if (ONE_WIRE_BACKEND_UART == ONE_WIRE_BACKEND)
+
+#endif // #ifndef ONE_WIRE_UART_H
+
+//****************************************** end of file *******************************************
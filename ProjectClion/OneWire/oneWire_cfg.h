@@ -50,6 +50,46 @@
 #define ONE_WIRE_Delay                          (INIT_Delay)
 
 
+
+// Backend of the 1-Wire master
+// ONE_WIRE_BACKEND_GPIO - bit-bang of the time slots by GPIO and delays, channels 0 and 1
+// ONE_WIRE_BACKEND_UART - USART in half-duplex mode with DMA, channel 0 only.
+//                         Every time slot is one UART byte, reset is sent at 9600 baud,
+//                         time slots at 115200 baud.
+#define ONE_WIRE_BACKEND_GPIO                   (0U)
+#define ONE_WIRE_BACKEND_UART                   (1U)
+#define ONE_WIRE_BACKEND                        (ONE_WIRE_BACKEND_GPIO)
+
+// UART backend. DQ is connected to the TX pin, the pin is open drain with
+// the external pull-up. The board has DQ on PA10 (ONE_WIRE_PIN_CH0), the only
+// USART function of PA10 is USART1_RX and USART1 is the TLM port on PB6/PB7,
+// so no UART TX can drive PA10. The backend needs the board rework: DQ and its
+// pull-up are wired to PA0 (UART4_TX, AF8), PA10 is left unconnected.
+#define ONE_WIRE_UART_NUM                       UART4
+#define ONE_WIRE_UART_TX_PORT                   GPIOA
+#define ONE_WIRE_UART_TX_PIN                    GPIO_PIN_0
+#define ONE_WIRE_UART_TX_AF                     GPIO_AF8_UART4
+#define ONE_WIRE_UART_CLK_ENABLE()              __HAL_RCC_UART4_CLK_ENABLE()
+
+// DMA of the UART backend, see the DMA request mapping of the reference manual
+#define ONE_WIRE_UART_DMA_CLK_ENABLE()          __HAL_RCC_DMA2_CLK_ENABLE()
+#define ONE_WIRE_UART_DMA_TX_CHANNEL            DMA2_Channel3
+#define ONE_WIRE_UART_DMA_RX_CHANNEL            DMA2_Channel5
+#define ONE_WIRE_UART_DMA_REQUEST               DMA_REQUEST_2
+#define ONE_WIRE_UART_DMA_RX_IRQn               DMA2_Channel5_IRQn
+#define ONE_WIRE_UART_DMA_RX_IRQHandler         DMA2_Channel5_IRQHandler
+
+// Priority of the DMA interrupt, the interrupt uses the RTOS API
+// Valid values: [configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY ; 15]
+#define ONE_WIRE_UART_IRQ_PRIORITY              (5U)
+
+// Max quantity of bytes in one DMA transaction, longer blocks are split
+#define ONE_WIRE_UART_MAX_BYTES                 (9U)
+
+// Timeout of one DMA transaction, ms
+#define ONE_WIRE_UART_TIMEOUT_MS                (20U)
+
+
 #endif // #ifndef ONE_WIRE_CFG_H
 
 //****************************************** end of file *******************************************
@@ -46,6 +46,8 @@
 
 #include "printf.h"
 #include "stdlib.h"
+#include "string.h"
+#include "stddef.h"
 #include "ftoa.h"
 
 // Get eeprom emulation interface
@@ -116,6 +118,23 @@ typedef struct TEST_EE_METEO_DATA_struct
 // Size of Dump
 #define RECORD_MAN_SIZE_DUMP                                (W25Q_CAPACITY_SECTOR_BYTES * 2U)
 
+// Size of the record of the layout version 1: 6 items + checksum
+#define RECORD_MAN_V1_SIZE_OF_RECORD_BYTES                  (RECORD_MAN_SIZEOF_ITEM * (6U + 1U))
+
+// Layout version 2, the records have the current size and the float Pa of the pressure
+#define RECORD_MAN_LAYOUT_VERSION_2                         (2U)
+
+// The float Pa of the old records out of the range is stored as 0
+#define RECORD_MAN_MAX_OLD_PRESSURE_PA                      (1.0e7f)
+
+// Offsets of the pressure, of the wind speed and of the wind gust in the record
+#define RECORD_MAN_OFFSET_PRESSURE                          (offsetof(RECORD_MAN_TYPE_RECORD, nPressure))
+#define RECORD_MAN_OFFSET_WIND_SPEED                        (offsetof(RECORD_MAN_TYPE_RECORD, fWindSpeed))
+#define RECORD_MAN_OFFSET_WIND_GUST                         (offsetof(RECORD_MAN_TYPE_RECORD, fWindGust))
+
+// Quantity of the records before the next one checked to find the layout in the flash
+#define RECORD_MAN_QTY_PROBE_RECORDS                        (4U)
+
 
 
 //**************************************************************************************************
@@ -135,6 +154,9 @@ static uint8_t RECORD_MAN_aRecordDataPackage[RECORD_MAN_MAX_SIZE_RECORD];
 // Dump memory W25Q
 static uint8_t RECORD_MAN_aDump[RECORD_MAN_SIZE_DUMP];
 
+// Max quantity of records in flash
+static uint32_t RECORD_MAN_nMaxQtyRecords = 0U;
+
 
 
 //**************************************************************************************************
@@ -154,6 +176,21 @@ static STD_RESULT RECORD_MAN_ParsingRecord(const uint8_t *pDataRecord,
                                            uint8_t *pData,
                                            uint32_t *pSizeData);
 
+// Fit the record numbers into the records area
+static void RECORD_MAN_UpgradeLayout(void);
+
+// Check the layout version of the records
+static void RECORD_MAN_CheckLayout(const uint32_t nAreaBytes);
+
+// Quantity of the valid records of the size before the next one
+static uint32_t RECORD_MAN_ProbeRecords(const uint32_t nNext, const uint32_t nSizeRecord);
+
+// Copy the unsent records of an old layout as the records of the current version
+static void RECORD_MAN_ConvertRecords(const uint32_t nLast, const uint32_t nNext, const uint32_t nSizeOld);
+
+// Check the slot of the record is erased
+static BOOLEAN RECORD_MAN_IsSlotBlank(const uint32_t nNumberRecord);
+
 
 
 //**************************************************************************************************
@@ -178,75 +215,94 @@ void RECORD_MAN_Init(void)
     uint64_t ID;
     uint16_t ManufID;
     uint32_t nVar = 0U;
+    uint32_t nAreaBytes = 0U;
+    uint32_t nBankStart = 0U;
+    uint32_t nBankEnd = 0U;
+    const W25Q_GEOMETRY *pGeometry = NULL;
 
     if (FALSE == RECORD_MAN_bInitialezed)
     {
-        // Init W25Q
-        W25Q_Init();
-
-        // Read ID W25Q
-        W25Q_ReadUniqueID(&ID);
+        // Init W25Q. The records and EEPROM are not mounted on an unknown geometry:
+        // the default one would move the banks and the records
+        if (RESULT_OK == W25Q_Init())
+        {
+            // Read ID W25Q
+            W25Q_ReadUniqueID(&ID);
 
-        // Read manufacture ID
-        W25Q_ReadManufactureID(&ManufID);
+            // Read manufacture ID
+            W25Q_ReadManufactureID(&ManufID);
 
-        // Update dump eeprom
-        RECORD_MAN_UpdateDumpMem();
+//            W25Q_EraseBlock(0,W25Q_BLOCK_MEMORY_ALL);
+//            W25Q_EraseBlock(0xffe000,W25Q_BLOCK_MEMORY_4KB);
+//            W25Q_EraseBlock(0xfff000,W25Q_BLOCK_MEMORY_4KB);
 
-//        W25Q_EraseBlock(0,W25Q_BLOCK_MEMORY_ALL);
-//        W25Q_EraseBlock(0xffe000,W25Q_BLOCK_MEMORY_4KB);
-//        W25Q_EraseBlock(0xfff000,W25Q_BLOCK_MEMORY_4KB);
+            // Init eeprom emulation
+            EMEEP_Init();
 
-        // Init eeprom emulation
-        EMEEP_Init();
+            // Size of records area below the banks found by EMEEP
+            pGeometry = W25Q_GetGeometry();
+            (void) EMEEP_GetBankArea(0U, &nBankStart, &nBankEnd);
+            nAreaBytes = (nBankEnd + 1U) - (RECORD_MAN_QTY_RESERVED_SECTORS * pGeometry->nSectorBytes);
+            RECORD_MAN_nMaxQtyRecords = nAreaBytes / RECORD_MAN_SIZE_OF_RECORD_BYTES;
 
-        // Update dump eeprom
-        RECORD_MAN_UpdateDumpMem();
+            // Update dump eeprom
+            RECORD_MAN_UpdateDumpMem();
 
-        // Check variables exist in EEPROM
-        if (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
-        {
-            if (0xFFFFFFFF == nVar)
+            // Check variables exist in EEPROM
+            if (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
             {
-                nVar = 0U;
-                // No init
-                if (RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR32_LAST_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
-                {
-                    DoNothing();
-                }
-                else
+                if (0xFFFFFFFF == nVar)
                 {
-                    printf("EMEEP_Store ERROR\r\n");
+                    nVar = 0U;
+                    // No init
+                    if (RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR32_LAST_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
+                    {
+                        DoNothing();
+                    }
+                    else
+                    {
+                        printf("EMEEP_Store ERROR\r\n");
+                    }
                 }
             }
-        }
-        else
-        {
-            printf("EMEEP_Load ERROR\r\n");
-        }
+            else
+            {
+                printf("EMEEP_Load ERROR\r\n");
+            }
 
-        if (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
-        {
-            if (0xFFFFFFFF == nVar)
+            if (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
             {
-                nVar = 0U;
-                // No init
-                if (RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR32_NEXT_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
-                {
-                    DoNothing();
-                }
-                else
+                if (0xFFFFFFFF == nVar)
                 {
-                    printf("EMEEP_Store ERROR\r\n");
+                    nVar = 0U;
+                    // No init
+                    if (RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR32_NEXT_RECORD,(U8*)&(nVar),RECORD_MAN_SIZE_VIR_ADR))
+                    {
+                        DoNothing();
+                    }
+                    else
+                    {
+                        printf("EMEEP_Store ERROR\r\n");
+                    }
                 }
             }
+            else
+            {
+                printf("EMEEP_Load ERROR\r\n");
+            }
+
+            // Records of the previous version are converted while the numbers count them
+            RECORD_MAN_CheckLayout(nAreaBytes);
+
+            // Records of the previous layout above the records area are dropped
+            RECORD_MAN_UpgradeLayout();
+
+            RECORD_MAN_bInitialezed = TRUE;
         }
         else
         {
-            printf("EMEEP_Load ERROR\r\n");
+            printf("W25Q_Init ERROR\r\n");
         }
-
-        RECORD_MAN_bInitialezed = TRUE;
     }
     else
     {
@@ -281,9 +337,10 @@ STD_RESULT RECORD_MAN_Store(const uint8_t *pData,
         if (RECORD_MAN_SIZE_OF_RECORD_BYTES == nDataQty)
         {
             // Get next record number
-            if (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
-                                        (U8*)&(nNumberNextRecord),
-                                        RECORD_MAN_SIZE_VIR_ADR))
+            if ((RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                         (U8*)&(nNumberNextRecord),
+                                         RECORD_MAN_SIZE_VIR_ADR)) &&
+                (nNumberNextRecord < RECORD_MAN_nMaxQtyRecords))
             {
                 // Create record
                 for (int nItem = 0U; nItem < nDataQty - 1U; nItem++)
@@ -362,10 +419,23 @@ STD_RESULT RECORD_MAN_Store(const uint8_t *pData,
 STD_RESULT RECORD_MAN_UpdateDumpMem(void)
 {
     STD_RESULT enResult = RESULT_NOT_OK;
+    uint32_t nStartAddress = 0U;
+    uint32_t nEndAddress = 0U;
+    uint32_t nSize = 0U;
 
-    if (RESULT_OK == W25Q_ReadData(EMEEP_BANK_0_START_ADDRESS,
-                                   RECORD_MAN_aDump,
-                                   (EMEEP_BANK_0_END_ADDRESS - EMEEP_BANK_0_START_ADDRESS) + 1U))
+    if (RESULT_OK == EMEEP_GetBankArea(0U, &nStartAddress, &nEndAddress))
+    {
+        nSize = (nEndAddress - nStartAddress) + 1U;
+        if (nSize > RECORD_MAN_SIZE_DUMP)
+        {
+            nSize = RECORD_MAN_SIZE_DUMP;
+        }
+    }
+
+    if ((0U != nSize) &&
+        (RESULT_OK == W25Q_ReadData(nStartAddress,
+                                    RECORD_MAN_aDump,
+                                    nSize)))
     {
         printf("RECORD_MAN_UpdateDumpMem: dump updated\r");
     }
@@ -397,7 +467,7 @@ STD_RESULT RECORD_MAN_Load(uint32_t nNumberRecord,
     STD_RESULT enResult = RESULT_NOT_OK;
     uint32_t nAdrRecord = 0U;
 
-    if (TRUE == RECORD_MAN_bInitialezed)
+    if ((TRUE == RECORD_MAN_bInitialezed) && (nNumberRecord < RECORD_MAN_nMaxQtyRecords))
     {
 #if (RECORD_MAN_MODE_STORAGE_FIXED == RECORD_MAN_MODE_STORAGE)
         // Calculate record address
@@ -676,4 +746,348 @@ static STD_RESULT RECORD_MAN_ParsingRecord(const uint8_t *pDataRecord,
 
 
 
+//**************************************************************************************************
+// @Function      RECORD_MAN_UpgradeLayout()
+//--------------------------------------------------------------------------------------------------
+// @Description   Fits the numbers of the next and of the last sent record into the records area.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The previous layout reserved 3 sectors at the end of the flash, now
+//                RECORD_MAN_QTY_RESERVED_SECTORS (5) are reserved and EMEEP bank 1 takes the
+//                sectors N-4 and N-3. A device which logged into the sectors N-5 and N-4 (the
+//                last 8 KB of the previous records area) loses these records: the next record
+//                number is cut to the end of the records area, so the area is full as it was
+//                before the upgrade, and the last sent record is cut to it too. EMEEP finds no
+//                valid record in the old record data of bank 1 and erases the sector before
+//                the first store. The other records are kept.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void RECORD_MAN_UpgradeLayout(void)
+{
+    uint32_t nNext = 0U;
+    uint32_t nLast = 0U;
+
+    if ((RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                 (U8*)&(nNext),
+                                 RECORD_MAN_SIZE_VIR_ADR)) &&
+        (nNext > RECORD_MAN_nMaxQtyRecords))
+    {
+        printf("RECORD_MAN: %lu records above the records area are dropped\r\n",
+               (unsigned long)(nNext - RECORD_MAN_nMaxQtyRecords));
+
+        nNext = RECORD_MAN_nMaxQtyRecords;
+        if (RESULT_OK != EMEEP_Store(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                     (U8*)&(nNext),
+                                     RECORD_MAN_SIZE_VIR_ADR))
+        {
+            printf("EMEEP_Store ERROR\r\n");
+        }
+
+        if ((RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                                     (U8*)&(nLast),
+                                     RECORD_MAN_SIZE_VIR_ADR)) &&
+            (nLast > nNext))
+        {
+            if (RESULT_OK != EMEEP_Store(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                                         (U8*)&(nNext),
+                                         RECORD_MAN_SIZE_VIR_ADR))
+            {
+                printf("EMEEP_Store ERROR\r\n");
+            }
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+} // end of RECORD_MAN_UpgradeLayout()
+
+
+
+//**************************************************************************************************
+// @Function      RECORD_MAN_CheckLayout()
+//--------------------------------------------------------------------------------------------------
+// @Description   Checks the layout version of the records kept in EMEEP.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The version 1 had no marker and 28-byte records, the version 2 adds fWindGust
+//                and takes 32 bytes, the version 3 keeps the pressure as an integer in the same
+//                size. Without the version 2 marker the records before the next one are checked
+//                in both sizes, the records of the version 1 win if more of them pass the CRC.
+//                Else the 32-byte records are of the version 2: the builds before the marker
+//                and the builds of the version 2 had the float pressure. The unsent records of
+//                an old version are converted, then the version is stored. A reset during the
+//                conversion may lose a part of the unsent records, the CRC check of the upload
+//                skips the slots written partially.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nAreaBytes - size of the records area
+//**************************************************************************************************
+static void RECORD_MAN_CheckLayout(const uint32_t nAreaBytes)
+{
+    const uint32_t nMaxQtyRecordsV1 = nAreaBytes / RECORD_MAN_V1_SIZE_OF_RECORD_BYTES;
+    uint32_t nVersion = 0U;
+    uint32_t nNext = 0U;
+    uint32_t nLast = 0U;
+    uint32_t nNextV1 = 0U;
+    uint32_t nNextV2 = 0U;
+    uint32_t nQtyV1 = 0U;
+
+    if ((RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR_LAYOUT,
+                                 (U8*)&(nVersion),
+                                 RECORD_MAN_SIZE_VIR_ADR)) &&
+        (RECORD_MAN_LAYOUT_VERSION != nVersion) &&
+        (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                 (U8*)&(nNext),
+                                 RECORD_MAN_SIZE_VIR_ADR)) &&
+        (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                                 (U8*)&(nLast),
+                                 RECORD_MAN_SIZE_VIR_ADR)))
+    {
+        nNextV1 = (nNext < nMaxQtyRecordsV1) ? nNext : nMaxQtyRecordsV1;
+        nNextV2 = (nNext < RECORD_MAN_nMaxQtyRecords) ? nNext : RECORD_MAN_nMaxQtyRecords;
+
+        if (RECORD_MAN_LAYOUT_VERSION_2 != nVersion)
+        {
+            nQtyV1 = RECORD_MAN_ProbeRecords(nNextV1, RECORD_MAN_V1_SIZE_OF_RECORD_BYTES);
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        if (nQtyV1 > RECORD_MAN_ProbeRecords(nNextV2, RECORD_MAN_SIZE_OF_RECORD_BYTES))
+        {
+            RECORD_MAN_ConvertRecords((nLast < nNextV1) ? nLast : nNextV1, nNextV1,
+                                      RECORD_MAN_V1_SIZE_OF_RECORD_BYTES);
+        }
+        else if (nLast < nNextV2)
+        {
+            RECORD_MAN_ConvertRecords(nLast, nNextV2, RECORD_MAN_SIZE_OF_RECORD_BYTES);
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        nVersion = RECORD_MAN_LAYOUT_VERSION;
+        if (RESULT_OK != EMEEP_Store(RECORD_MAN_VIR_ADR_LAYOUT,
+                                     (U8*)&(nVersion),
+                                     RECORD_MAN_SIZE_VIR_ADR))
+        {
+            printf("EMEEP_Store ERROR\r\n");
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+} // end of RECORD_MAN_CheckLayout()
+
+
+
+//**************************************************************************************************
+// @Function      RECORD_MAN_ProbeRecords()
+//--------------------------------------------------------------------------------------------------
+// @Description   Counts the valid records of the size before the next one.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Up to RECORD_MAN_QTY_PROBE_RECORDS records are checked, erased ones don't count.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Quantity of the records passed the CRC.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nNext - number of the record to be written next
+//                nSizeRecord - size of the record with the checksum, bytes
+//**************************************************************************************************
+static uint32_t RECORD_MAN_ProbeRecords(const uint32_t nNext, const uint32_t nSizeRecord)
+{
+    uint32_t nQtyValid = 0U;
+    uint32_t nRecord = nNext;
+    uint32_t nByte = 0U;
+    BOOLEAN bBlank = TRUE;
+
+    while ((0U != nRecord) && ((nNext - nRecord) < RECORD_MAN_QTY_PROBE_RECORDS))
+    {
+        nRecord--;
+
+        if (RESULT_OK == W25Q_ReadData(nRecord * nSizeRecord,
+                                       RECORD_MAN_aRecordDataPackage,
+                                       nSizeRecord))
+        {
+            bBlank = TRUE;
+            for (nByte = 0U; nByte < nSizeRecord; nByte++)
+            {
+                if (0xFFU != RECORD_MAN_aRecordDataPackage[nByte])
+                {
+                    bBlank = FALSE;
+                }
+            }
+
+            if ((FALSE == bBlank) &&
+                (RECORD_MAN_aRecordDataPackage[nSizeRecord - 1U] == \
+                 CH_SUM_CalculateCRC8(RECORD_MAN_aRecordDataPackage, nSizeRecord - 1U)))
+            {
+                nQtyValid++;
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    return nQtyValid;
+} // end of RECORD_MAN_ProbeRecords()
+
+
+
+//**************************************************************************************************
+// @Function      RECORD_MAN_ConvertRecords()
+//--------------------------------------------------------------------------------------------------
+// @Description   Copies the unsent records of an old layout as the records of the current
+//                version.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The flash is not erased, the copies go to the erased slots after the end of
+//                the old records. The gust of the record of the version 1 is its mean wind
+//                speed. The float Pa of the pressure is rounded to RECORD_MAN_PRESSURE_SCALE,
+//                a value out of the range is stored as 0. The records which don't fit into the
+//                area and the records failed the CRC are dropped. The next record number is
+//                stored first, a reset before the last sent one leaves the old records to the
+//                CRC check of the upload.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nLast - number of the first unsent old record
+//                nNext - number of the next old record
+//                nSizeOld - size of the old record with the checksum, bytes
+//**************************************************************************************************
+static void RECORD_MAN_ConvertRecords(const uint32_t nLast, const uint32_t nNext, const uint32_t nSizeOld)
+{
+    uint32_t nBase = ((nNext * nSizeOld) + RECORD_MAN_SIZE_OF_RECORD_BYTES - 1U) /
+                     RECORD_MAN_SIZE_OF_RECORD_BYTES;
+    uint32_t nSlot = 0U;
+    uint32_t nRecord = 0U;
+    uint32_t nPressure = 0U;
+    float fPressure = 0.0f;
+    uint8_t *const pRecord = RECORD_MAN_aRecordDataPackage;
+
+    // The slots right after the old records are erased, unless the records were written there
+    while ((nBase < RECORD_MAN_nMaxQtyRecords) && (FALSE == RECORD_MAN_IsSlotBlank(nBase)))
+    {
+        nBase++;
+    }
+
+    nSlot = nBase;
+    for (nRecord = nLast; (nRecord < nNext) && (nSlot < RECORD_MAN_nMaxQtyRecords); nRecord++)
+    {
+        if ((RESULT_OK == W25Q_ReadData(nRecord * nSizeOld,
+                                        pRecord,
+                                        nSizeOld)) &&
+            (pRecord[nSizeOld - 1U] == CH_SUM_CalculateCRC8(pRecord, nSizeOld - 1U)))
+        {
+            if (RECORD_MAN_V1_SIZE_OF_RECORD_BYTES == nSizeOld)
+            {
+                memcpy(&pRecord[RECORD_MAN_OFFSET_WIND_GUST],
+                       &pRecord[RECORD_MAN_OFFSET_WIND_SPEED],
+                       RECORD_MAN_SIZEOF_ITEM);
+                memset(&pRecord[RECORD_MAN_OFFSET_WIND_GUST + RECORD_MAN_SIZEOF_ITEM], 0,
+                       RECORD_MAN_SIZE_OF_RECORD_BYTES - 1U - (RECORD_MAN_OFFSET_WIND_GUST + RECORD_MAN_SIZEOF_ITEM));
+            }
+            else
+            {
+                DoNothing();
+            }
+
+            memcpy(&fPressure, &pRecord[RECORD_MAN_OFFSET_PRESSURE], RECORD_MAN_SIZEOF_ITEM);
+            nPressure = ((fPressure > 0.0f) && (fPressure < RECORD_MAN_MAX_OLD_PRESSURE_PA)) ?
+                        (uint32_t)(((double)fPressure * (double)RECORD_MAN_PRESSURE_SCALE) + 0.5) : 0U;
+            memcpy(&pRecord[RECORD_MAN_OFFSET_PRESSURE], &nPressure, RECORD_MAN_SIZEOF_ITEM);
+
+            pRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES - 1U] = \
+                    CH_SUM_CalculateCRC8(pRecord, RECORD_MAN_SIZE_OF_RECORD_BYTES - 1U);
+
+            // The slot is used even if the write fails, the CRC check skips it
+            (void)W25Q_WriteData(nSlot * RECORD_MAN_SIZE_OF_RECORD_BYTES,
+                                 pRecord,
+                                 RECORD_MAN_SIZE_OF_RECORD_BYTES);
+            nSlot++;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    printf("RECORD_MAN: %lu of %lu unsent records are converted to the layout version %u\r\n",
+           (unsigned long)(nSlot - nBase),
+           (unsigned long)((nNext > nLast) ? (nNext - nLast) : 0U),
+           (unsigned int)RECORD_MAN_LAYOUT_VERSION);
+
+    if ((RESULT_OK != EMEEP_Store(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                  (U8*)&(nSlot),
+                                  RECORD_MAN_SIZE_VIR_ADR)) ||
+        (RESULT_OK != EMEEP_Store(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                                  (U8*)&(nBase),
+                                  RECORD_MAN_SIZE_VIR_ADR)))
+    {
+        printf("EMEEP_Store ERROR\r\n");
+    }
+    else
+    {
+        DoNothing();
+    }
+} // end of RECORD_MAN_ConvertRecords()
+
+
+
+//**************************************************************************************************
+// @Function      RECORD_MAN_IsSlotBlank()
+//--------------------------------------------------------------------------------------------------
+// @Description   Checks the slot of the record is erased.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE - all bytes of the slot are 0xFF
+//                FALSE - the slot is written or can't be read
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nNumberRecord - number of the record
+//**************************************************************************************************
+static BOOLEAN RECORD_MAN_IsSlotBlank(const uint32_t nNumberRecord)
+{
+    uint8_t aSlot[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+    BOOLEAN bBlank = FALSE;
+    uint32_t nByte = 0U;
+
+    if (RESULT_OK == W25Q_ReadData(nNumberRecord * RECORD_MAN_SIZE_OF_RECORD_BYTES,
+                                   aSlot,
+                                   RECORD_MAN_SIZE_OF_RECORD_BYTES))
+    {
+        bBlank = TRUE;
+        for (nByte = 0U; nByte < RECORD_MAN_SIZE_OF_RECORD_BYTES; nByte++)
+        {
+            if (0xFFU != aSlot[nByte])
+            {
+                bBlank = FALSE;
+            }
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return bBlank;
+} // end of RECORD_MAN_IsSlotBlank()
+
+
+
 //****************************************** end of file *******************************************
\ No newline at end of file
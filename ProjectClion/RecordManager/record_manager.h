@@ -53,10 +53,26 @@
 #define RECORD_MAN_MAX_SIZE_RECORD                 (100U)
 
 // Virtual address
+// LAST_RECORD - number of the first record not acknowledged by the server
+// NEXT_RECORD - number of the record to be written next
 #define RECORD_MAN_VIR_ADR32_LAST_RECORD             (0U)
 #define RECORD_MAN_VIR_ADR32_NEXT_RECORD             (4U)
 #define RECORD_MAN_VIR_ADR_ALARM_SENS                (8U)
 #define RECORD_MAN_VIR_ADR_ALARM_GSM                 (12U)
+// State of the upload policy of the GSM task
+#define RECORD_MAN_VIR_ADR_GSM_POLICY                (16U)
+
+// Virtual address of the DS18B20 ROM table, bank 1: quantity + ID array
+#define RECORD_MAN_VIR_ADR_DS18B20_QTY               (0x00010000UL)
+#define RECORD_MAN_VIR_ADR_DS18B20_ID                (0x00010004UL)
+// Layout version of the records, bank 1 after the ID array
+#define RECORD_MAN_VIR_ADR_LAYOUT                    (0x00010034UL)
+
+// Max quantity of ID in the DS18B20 ROM table
+#define RECORD_MAN_DS18B20_MAX_QTY_ID                (6U)
+
+// Size of one DS18B20 ID
+#define RECORD_MAN_SIZE_DS18B20_ID                   (8U)
 
 // Size record adr
 #define RECORD_MAN_SIZE_VIR_ADR                      (4U)
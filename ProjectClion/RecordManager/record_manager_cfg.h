@@ -24,9 +24,10 @@ typedef struct RECORD_MAN_TYPE_RECORD_struct
     uint32_t nUnixTime;
     float fTemperature;
     float fHumidity;
-    float fPressure;
+    uint32_t nPressure;     // Pa x RECORD_MAN_PRESSURE_SCALE in every build of the BMP280 compensation
     float fWindSpeed;
     float fBatteryVoltage;
+    float fWindGust;
 }RECORD_MAN_TYPE_RECORD;
 
 
@@ -39,10 +40,25 @@ typedef struct RECORD_MAN_TYPE_RECORD_struct
 #define RECORD_MAN_SIZEOF_ITEM                  (4U)
 
 // Specify number of record's items
-#define RECORD_MAN_NUM_ITEMS                    (6U)
+#define RECORD_MAN_NUM_ITEMS                    (7U)
 
 // Specify size of record in bytes + checksum
 #define RECORD_MAN_SIZE_OF_RECORD_BYTES         (RECORD_MAN_SIZEOF_ITEM * (RECORD_MAN_NUM_ITEMS + 1U))
+// Specify layout version of the records, it's kept in EMEEP and checked by RECORD_MAN_Init()
+// 1 - 6 items, 28 bytes
+// 2 - 7 items, fWindGust is added, 32 bytes
+// 3 - 7 items, the float Pa of the pressure is replaced by nPressure, 32 bytes
+#define RECORD_MAN_LAYOUT_VERSION               (3U)
+
+// Specify scale of the pressure in the record, units per Pa
+#define RECORD_MAN_PRESSURE_SCALE               (100U)
+
+// Specify quantity of sectors at the end of the flash memory reserved for the
+// emulated EEPROM. Records are stored below this area, its size is calculated
+// from the end of EMEEP bank 0 found at run time (see EMEEP_BANKS_AT_FLASH_END).
+// Layout: EMEEP bank 0 - sectors N-2..N-1, bank 1 - N-4..N-3, N-5 is spare.
+// The previous layout reserved 3 sectors, see RECORD_MAN_UpgradeLayout().
+#define RECORD_MAN_QTY_RESERVED_SECTORS         (5U)
 
 // Specify storage mode of record
 // valid value: RECORD_MAN_MODE_STORAGE_FIXED, RECORD_MAN_MODE_STORAGE_VARIABLE
@@ -612,15 +612,21 @@ static void TASK_MASTER_SetPeriodAlarmGSM(const char* data)
 static void TASK_MASTER_ClearFlash(const char* data)
 {
     U32 AdrNext = 0U;
+    U32 nBankStart = 0U;
+    U32 nBankEnd = 0U;
     STD_RESULT enResult = RESULT_OK;
+    const W25Q_GEOMETRY *pGeometry = W25Q_GetGeometry();
     // Write new alarm value in EEPROM
     // Attempt get mutex
     if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, 10000 / portTICK_PERIOD_MS))
     {
 
-        if (RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
-                                     (U8*)&(AdrNext),
-                                     RECORD_MAN_SIZE_VIR_ADR))
+        if ((RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                      (U8*)&(AdrNext),
+                                      RECORD_MAN_SIZE_VIR_ADR)) &&
+            (RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                                      (U8*)&(AdrNext),
+                                      RECORD_MAN_SIZE_VIR_ADR)))
         {
             printf("task_terminal: AdrNext was clear\r\n");
         }
@@ -637,13 +643,14 @@ static void TASK_MASTER_ClearFlash(const char* data)
         printf("task_terminal: Mutex of record manager is busy\r\n");
     }
 
-    // Clear FLASH
+    // Clear FLASH below the banks of EEPROM, they may be kept below the end of the flash
+    (void) EMEEP_GetBankArea(0U, &nBankStart, &nBankEnd);
     taskENTER_CRITICAL();
-    for (int nNumberSector = 0;
-         nNumberSector < (W25Q_CAPACITY_ALL_MEMORY_BYTES - (3U * W25Q_CAPACITY_SECTOR_BYTES)) / W25Q_CAPACITY_SECTOR_BYTES;
+    for (U32 nNumberSector = 0;
+         nNumberSector < (((nBankEnd + 1U) / pGeometry->nSectorBytes) - RECORD_MAN_QTY_RESERVED_SECTORS);
          nNumberSector++)
     {
-        U32 adr = nNumberSector * W25Q_CAPACITY_SECTOR_BYTES;
+        U32 adr = nNumberSector * pGeometry->nSectorBytes;
         if (RESULT_OK == W25Q_EraseBlock(adr , W25Q_BLOCK_MEMORY_4KB))
         {
             DoNothing();
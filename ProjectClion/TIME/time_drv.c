@@ -340,6 +340,36 @@ U32 TIME_GetUnixTimestamp(void)
 
 
 
+//**************************************************************************************************
+// @Function      TIME_GetTimeMs()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get time of RTC, ms.
+//--------------------------------------------------------------------------------------------------
+// @Notes         RTC keeps counting in STOP2 while SysTick is stopped, so the intervals over
+//                the STOP2 are measured by this time. The value wraps, take only the difference
+//                of two values in the unsigned arithmetic.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Time, ms.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+U32 TIME_GetTimeMs(void)
+{
+    U32 nSeconds = 0U;
+    U32 nMs = 0U;
+
+    // The sub seconds are read with the time
+    nSeconds = TIME_GetUnixTimestamp();
+
+    // The sub seconds count down from the synchronous prescaler
+    nMs = ((sTimeCurrent.SecondFraction - sTimeCurrent.SubSeconds) * 1000U) / \
+           (sTimeCurrent.SecondFraction + 1U);
+
+    return ((nSeconds * 1000U) + nMs);
+} // end of TIME_GetTimeMs()
+
+
+
 //**************************************************************************************************
 // @Function      TIME_SetAlarm()
 //--------------------------------------------------------------------------------------------------
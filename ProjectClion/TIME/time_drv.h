@@ -82,6 +82,9 @@ extern void TIME_Init(void);
 // Get Unix timestamp
 extern U32 TIME_GetUnixTimestamp(void);
 
+// Get time of RTC, ms
+extern U32 TIME_GetTimeMs(void);
+
 // Set alarm
 extern void TIME_SetAlarm(const TIME_type time, U32 nAlarmName);
 
@@ -47,6 +47,10 @@
 #define TIME_ALARM_GSM_MINUTES                (TIME_RTC_TIME_MINUTES_DEF + 1U)
 #define TIME_ALARM_GSM_SECONDS                (TIME_RTC_TIME_SECONDS_DEF)
 #define TIME_ALARM_GSM_MASK                   (RTC_ALARMMASK_DATEWEEKDAY)
+// Period of the GSM alarm, s: the offsets of the alarm from the current time, less than 24 h
+#define TIME_ALARM_GSM_PERIOD_S               ((TIME_ALARM_GSM_HOURS * 3600U) + \
+                                               (TIME_ALARM_GSM_MINUTES * 60U) + \
+                                               TIME_ALARM_GSM_SECONDS)
 
 
 
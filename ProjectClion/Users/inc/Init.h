@@ -62,6 +62,12 @@ extern I2C_HandleTypeDef I2CBMP280Handler;
 
 extern ADC_HandleTypeDef ADC_Handle;
 
+// DMA handler of the ADC regular sequence
+extern DMA_HandleTypeDef ADC_DmaHandle;
+
+// Timer of the ADC trigger
+extern TIM_HandleTypeDef ADC_TriggerTimHandle;
+
 
 
 //**************************************************************************************************
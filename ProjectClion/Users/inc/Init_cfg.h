@@ -78,13 +78,15 @@
 #define INIT_BAT_PORT                            GPIOA
 #define INIT_BAT_PIN                             GPIO_PIN_4
 #define INIT_BAT_AN_CH                           ADC_CHANNEL_9
-#define INIT_BAT_RANK                            ADC_INJECTED_RANK_1
+#define INIT_BAT_RANK                            ADC_REGULAR_RANK_1
+#define INIT_BAT_INDEX                           (0U)
 
 // Configure analog pin for anemometr
 #define INIT_ANEMOMETER_PORT                     GPIOC
 #define INIT_ANEMOMETER_PIN                      GPIO_PIN_5
 #define INIT_ANEMOMETER_AN_CH                    ADC_CHANNEL_14
-#define INIT_ANEMOMETER_RANK                     ADC_INJECTED_RANK_2
+#define INIT_ANEMOMETER_RANK                     ADC_REGULAR_RANK_2
+#define INIT_ANEMOMETER_INDEX                    (1U)
 
 // Configure DC/DC control GSM pin
 #define INIT_DC_GSM_PORT                         GPIOC
@@ -96,6 +98,22 @@
 
 // Configure ADC
 #define INIT_ADC_NUM                             ADC1
+// Quantity of channels in the regular sequence
+#define INIT_ADC_QTY_CH                          (2U)
+// Oversampler: 256 samples, the sum is shifted back to 10 bits
+#define INIT_ADC_OVERSAMPLING_RATIO              ADC_OVERSAMPLING_RATIO_256
+#define INIT_ADC_OVERSAMPLING_SHIFT              ADC_RIGHTBITSHIFT_8
+// DMA of the ADC, see the DMA request mapping of the reference manual
+#define INIT_ADC_DMA_CHANNEL                     DMA1_Channel1
+#define INIT_ADC_DMA_REQUEST                     DMA_REQUEST_0
+#define INIT_ADC_DMA_IRQn                        DMA1_Channel1_IRQn
+// Timer of the ADC trigger, its update starts the sequence and paces the wind samples
+#define INIT_ADC_TRIGGER_TIM                     TIM2
+#define INIT_ADC_TRIGGER                         ADC_EXTERNALTRIG_T2_TRGO
+// Prescaler of the trigger timer, 80 MHz / 8000 = 10 kHz
+#define INIT_ADC_TRIGGER_PSC                     (7999U)
+// Ticks of the trigger timer in 1 ms
+#define INIT_ADC_TRIGGER_TICKS_PER_MS            (10U)
 
 // Configure LED2 pin PA5
 #define INIT_LED2_PORT                          GPIOA
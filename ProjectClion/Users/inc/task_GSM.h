@@ -69,6 +69,9 @@ extern TaskHandle_t TASK_GSM_hHandlerTask;
 // GSM task
 extern void vTaskGSM(void *pvParameters);
 
+// Upload policy, decides whether to power the modem on the GSM alarm
+extern BOOLEAN TASK_GSM_IsUploadDue(void);
+
 
 
 #endif // #ifndef TASK_GSM_H
@@ -22,10 +22,93 @@
 //**************************************************************************************************
 
 // Prm vTaskGSM
-#define TASK_GSM_STACK_DEPTH          (256U)
+// Stack, words. The host test measures 944 bytes of the frames of the task and of coreMQTT
+// on x86-64 without printf, the target adds printf with float and the FPU context.
+// 256 words were about full, the free stack is printed after every wakeup.
+#define TASK_GSM_STACK_DEPTH          (512U)
 #define TASK_GSM_PARAMETERS           (NULL)
 #define TASK_GSM_PRIORITY             (1U)
 
+// Quantity of records sent between two updates of the upload cursor
+#define TASK_GSM_BATCH_QTY_RECORDS    (10U)
+
+// Max quantity of batches sent in one session, the rest of the backlog
+// is sent in the next sessions
+#define TASK_GSM_MAX_BATCHES_PER_SESSION  (10U)
+
+// Max quantity of sessions after one GSM alarm, the sessions run back to back on
+// the cached connection while the backlog is left. The records of one wakeup must
+// exceed the records of the longest wait of the upload policy, otherwise the backlog
+// grows: 3000 against 2884 of the record every minute at the 4th alarm every 12 h
+// 1 min, when the oldest record reaches TASK_GSM_POLICY_MAX_AGE_S.
+#define TASK_GSM_MAX_CYCLES_PER_WAKEUP    (30U)
+
+// Upload policy. The GSM alarm of TIME_ALARM_GSM_* is the upload opportunity, the
+// modem is powered when the oldest pending record is old enough. The wait is one
+// period of the alarm in the good conditions, so every alarm is taken, and is doubled
+// for every failed session in a row, for the low battery and for the poor signal, so
+// the doubled wait skips every other alarm. The wait ends half a period before the
+// alarm, the jitter of the records doesn't move the session to the next alarm.
+// Max doubling of the wait
+#define TASK_GSM_POLICY_MAX_SHIFT         (3U)
+// Max age of the oldest pending record, s. Limits the data latency of the doubled
+// waits, must be longer than two periods of the GSM alarm.
+#define TASK_GSM_POLICY_MAX_AGE_S         (172800U)
+// Battery voltage of the last record, V
+#define TASK_GSM_POLICY_BATTERY_LOW_V     (3.6F)
+#define TASK_GSM_POLICY_BATTERY_CRITICAL_V (3.4F)
+// RSSI of AT+CSQ below which the signal is poor, 0...31
+#define TASK_GSM_POLICY_CSQ_POOR          (10U)
+
+// MQTT broker: the host and the port of AT+CIPSTART, the topic of the channel feed,
+// all fields of a record are published at once
+#define TASK_GSM_BROKER_HOST              ("mqtt3.thingspeak.com")
+#define TASK_GSM_BROKER_PORT              (1883U)
+#define TASK_GSM_TOPIC_PUBLISH            ("channels/1851639/publish")
+
+// MQTT QoS of the records. mqtt3.thingspeak.com supports QoS 0 only, QoS 1 is for the
+// brokers which send PUBACK.
+// Valid values: TASK_GSM_MQTT_QOS_0 - the batch is confirmed by PINGRESP after it
+//               TASK_GSM_MQTT_QOS_1 - the record is confirmed by PUBACK of the broker
+#define TASK_GSM_MQTT_QOS_0               (0U)
+#define TASK_GSM_MQTT_QOS_1               (1U)
+#define TASK_GSM_MQTT_QOS                 (TASK_GSM_MQTT_QOS_0)
+
+// Max quantity of QoS 1 records in flight, not greater than MQTT_STATE_ARRAY_MAX_COUNT
+#define TASK_GSM_WINDOW_SIZE              (4U)
+
+// Transport of the MQTT packets
+// Valid values: TASK_GSM_TRANSPORT_CIPSEND     - every packet is sent by AT+CIPSEND
+//               TASK_GSM_TRANSPORT_TRANSPARENT - AT+CIPMODE=1, the packets are written
+//                                                to the modem as is
+#define TASK_GSM_TRANSPORT_CIPSEND        (0U)
+#define TASK_GSM_TRANSPORT_TRANSPARENT    (1U)
+#define TASK_GSM_TRANSPORT                (TASK_GSM_TRANSPORT_TRANSPARENT)
+
+// Timeouts of the modem responses, ms
+// Simple AT command, also the period of the polling
+#define TASK_GSM_AT_TIMEOUT_MS            (1000U)
+// Modem answers "AT" after power on
+#define TASK_GSM_STARTUP_TIMEOUT_MS       (10000U)
+// GPRS attach
+#define TASK_GSM_NETWORK_TIMEOUT_MS       (30000U)
+// "SHUT OK" of AT+CIPSHUT
+#define TASK_GSM_SHUT_TIMEOUT_MS          (10000U)
+// "CONNECT OK" of AT+CIPSTART
+#define TASK_GSM_CONNECT_TIMEOUT_MS       (30000U)
+// "SEND OK" after the data of AT+CIPSEND
+#define TASK_GSM_SEND_TIMEOUT_MS          (10000U)
+// "CLOSE OK" of AT+CIPCLOSE
+#define TASK_GSM_CLOSE_TIMEOUT_MS         (5000U)
+// CONNACK of the broker
+#define TASK_GSM_CONNACK_TIMEOUT_MS       (10000U)
+// Max blocking of one call of the transport receive
+#define TASK_GSM_RECV_TIMEOUT_MS          (20U)
+// PUBACK of all records of the batch, PINGRESP of the QoS 0 batch
+#define TASK_GSM_PUBACK_TIMEOUT_MS        (10000U)
+// Guard time before and after "+++" of the transparent mode
+#define TASK_GSM_ESCAPE_GUARD_MS          (1200U)
+
 #define SECRET_MQTT_USERNAME            "NSMjKhsxJT0DPRUdLA44Gw0"
 #define SECRET_MQTT_CLIENT_ID           "NSMjKhsxJT0DPRUdLA44Gw0"
 #define SECRET_MQTT_PASSWORD            "1rYHUximMilQSJ8Z+X68Sk2b"
@@ -24,6 +24,58 @@
 // BPM280 device address
 #define TASK_READ_SEN_BMP280_ADR                (0x76U)
 
+// DS18B20 resolution, the conversion time is 94/188/375/750 ms for 9/10/11/12 bits
+// Valid values: DS18B20_RESOLUTION_9_BIT..DS18B20_RESOLUTION_12_BIT
+#define TASK_READ_SEN_DS18B20_RESOLUTION        (DS18B20_RESOLUTION_12_BIT)
+
+// Max quantity of DS18B20 sensors on the 1-Wire bus (soil and air probes)
+// Valid values: [1 ; RECORD_MAN_DS18B20_MAX_QTY_ID]
+#define TASK_READ_SEN_DS18B20_MAX_QTY           (2U)
+
+// Type of the anemometer
+// TASK_READ_SEN_ANEMOMETER_ANALOG - voltage output, powered and sampled by ADC during the measurement
+// TASK_READ_SEN_ANEMOMETER_PULSE  - pulse output, always powered, pulses are counted by LPTIM
+//                                   between the measurements, see ANEMOMETER module
+#define TASK_READ_SEN_ANEMOMETER_ANALOG         (0U)
+#define TASK_READ_SEN_ANEMOMETER_PULSE          (1U)
+#define TASK_READ_SEN_ANEMOMETER_TYPE           (TASK_READ_SEN_ANEMOMETER_ANALOG)
+
+// Settling time of the anemometer after power on, ms
+// Valid values: [DS18B20 conversion time + DS18B20_CONVERSION_MARGIN_MS ; ...], the other sensors
+// are read within it
+#define TASK_READ_SEN_ANEMOMETER_SETTLE_MS      (1000U)
+
+// Window of the wind samples, the record keeps the mean and the gust of the window, ms.
+// The window follows the settling, the trigger timer of the ADC takes the samples from the power on
+// while the other sensors convert and the CPU sleeps in the idle hook (vApplicationIdleHook()).
+// The cycle of the measurement is the window and the samples of the settling before its first one,
+// 10 s by default. The mean and the gust need the whole window, a shorter cycle needs a shorter one.
+#define TASK_READ_SEN_WIND_WINDOW_MS            (10000U)
+
+// Period of the wind samples in the window, ms
+// Valid values: [1 ; TASK_READ_SEN_WIND_WINDOW_MS]
+#define TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS     (1000U)
+
+// Interrupt of the ADC DMA
+#define TASK_READ_SEN_ADC_DMA_IRQHandler        DMA1_Channel1_IRQHandler
+
+// Priority of the ADC DMA interrupt, the interrupt uses the RTOS API
+// Valid values: [configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY ; 15]
+#define TASK_READ_SEN_ADC_IRQ_PRIORITY          (5U)
+
+// Timeout of the I2C transfer of the BMP280, ms
+#define TASK_READ_SEN_I2C_TIMEOUT_MS            (10U)
+
+// Interrupts of the BMP280 I2C
+#define TASK_READ_SEN_I2C_EV_IRQn               I2C1_EV_IRQn
+#define TASK_READ_SEN_I2C_ER_IRQn               I2C1_ER_IRQn
+#define TASK_READ_SEN_I2C_EV_IRQHandler         I2C1_EV_IRQHandler
+#define TASK_READ_SEN_I2C_ER_IRQHandler         I2C1_ER_IRQHandler
+
+// Priority of the I2C interrupts, the interrupts use the RTOS API
+// Valid values: [configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY ; 15]
+#define TASK_READ_SEN_I2C_IRQ_PRIORITY          (5U)
+
 // Prm vTaskSensorsRead
 #define TASK_SEN_R_STACK_DEPTH          (256U)
 #define TASK_SEN_R_PARAMETERS           (NULL)
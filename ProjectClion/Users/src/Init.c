@@ -78,6 +78,12 @@ TIM_HandleTypeDef    TimDelayHandle;
 // ADC Handler
 ADC_HandleTypeDef ADC_Handle;
 
+// DMA handler of the ADC regular sequence
+DMA_HandleTypeDef ADC_DmaHandle;
+
+// Timer of the ADC trigger
+TIM_HandleTypeDef ADC_TriggerTimHandle;
+
 //#define TERMINAL_RX_BUF_SIZE            (512U)
 //uint8_t TERMINAL_BufRx[TERMINAL_RX_BUF_SIZE];
 
@@ -144,6 +150,7 @@ void Init(void)
     __HAL_RCC_USART2_CLK_ENABLE();
     __HAL_RCC_USART3_CLK_ENABLE();
     __HAL_RCC_TIM6_CLK_ENABLE();
+    __HAL_RCC_TIM2_CLK_ENABLE();
     __HAL_RCC_I2C1_CLK_ENABLE();
     __HAL_RCC_ADC_CLK_ENABLE();
 //    __HAL_RCC_ADC_CONFIG(RCC_ADCCLKSOURCE_SYSCLK);
@@ -328,6 +335,22 @@ void Init(void)
 
     HAL_TIM_Base_Init(&TimDelayHandle);
 
+    // The update of the trigger timer starts the ADC sequence, the period is set by the start
+    ADC_TriggerTimHandle.Instance = INIT_ADC_TRIGGER_TIM;
+    ADC_TriggerTimHandle.Init.Period            = 0xFFFFFFFFUL;
+    ADC_TriggerTimHandle.Init.Prescaler         = INIT_ADC_TRIGGER_PSC;
+    ADC_TriggerTimHandle.Init.ClockDivision     = 0;
+    ADC_TriggerTimHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    ADC_TriggerTimHandle.Init.RepetitionCounter = 0;
+    ADC_TriggerTimHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    HAL_TIM_Base_Init(&ADC_TriggerTimHandle);
+
+    TIM_MasterConfigTypeDef TIM_MasterConf;
+    TIM_MasterConf.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    TIM_MasterConf.MasterOutputTrigger2 = TIM_TRGO2_RESET;
+    TIM_MasterConf.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    HAL_TIMEx_MasterConfigSynchronization(&ADC_TriggerTimHandle, &TIM_MasterConf);
+
     //ADC set
     ADC_Handle.Instance = INIT_ADC_NUM;
     ADC_Handle.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
@@ -337,40 +360,51 @@ void Init(void)
     ADC_Handle.Init.EOCSelection = ADC_EOC_SEQ_CONV;
     ADC_Handle.Init.LowPowerAutoWait = DISABLE;
     ADC_Handle.Init.ContinuousConvMode = DISABLE;
-    ADC_Handle.Init.NbrOfConversion = 0U;
+    ADC_Handle.Init.NbrOfConversion = INIT_ADC_QTY_CH;
     ADC_Handle.Init.DiscontinuousConvMode = DISABLE;
-    ADC_Handle.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+    // Every sequence is started by the trigger timer, the CPU sleeps in the idle hook while the window
+    // is sampled
+    ADC_Handle.Init.ExternalTrigConv = INIT_ADC_TRIGGER;
+    ADC_Handle.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
     ADC_Handle.Init.DMAContinuousRequests = DISABLE;
     ADC_Handle.Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
-    ADC_Handle.Init.OversamplingMode = DISABLE;
-    ADC_Handle.InjectionConfig.ChannelCount = 2U;
-    ADC_Handle.InjectionConfig.ContextQueue = 1U;
+    // Every conversion of the sequence is the average of the oversampler
+    ADC_Handle.Init.OversamplingMode = ENABLE;
+    ADC_Handle.Init.Oversampling.Ratio = INIT_ADC_OVERSAMPLING_RATIO;
+    ADC_Handle.Init.Oversampling.RightBitShift = INIT_ADC_OVERSAMPLING_SHIFT;
+    ADC_Handle.Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    ADC_Handle.Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
     HAL_ADC_Init(&ADC_Handle);
 
-    ADC_InjectionConfTypeDef ADC_InjectionConf;
-    ADC_InjectionConf.InjectedChannel = INIT_BAT_AN_CH;
-    ADC_InjectionConf.InjectedRank = INIT_BAT_RANK;
-    ADC_InjectionConf.InjectedSingleDiff = ADC_SINGLE_ENDED;
-    ADC_InjectionConf.InjectedNbrOfConversion = 2;
-    ADC_InjectionConf.InjectedSamplingTime = ADC_SAMPLETIME_47CYCLES_5;
-    ADC_InjectionConf.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
-    ADC_InjectionConf.AutoInjectedConv = DISABLE;
-    ADC_InjectionConf.InjecOversamplingMode = DISABLE;
-    ADC_InjectionConf.InjectedDiscontinuousConvMode = DISABLE;
-    ADC_InjectionConf.InjectedOffsetNumber = ADC_OFFSET_NONE;
-    HAL_ADCEx_InjectedConfigChannel(&ADC_Handle, &ADC_InjectionConf);
-
-    ADC_InjectionConf.InjectedChannel = INIT_ANEMOMETER_AN_CH;
-    ADC_InjectionConf.InjectedRank = INIT_ANEMOMETER_RANK;
-    ADC_InjectionConf.InjectedSingleDiff = ADC_SINGLE_ENDED;
-    ADC_InjectionConf.InjectedNbrOfConversion = 2;
-    ADC_InjectionConf.InjectedSamplingTime = ADC_SAMPLETIME_47CYCLES_5;
-    ADC_InjectionConf.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
-    ADC_InjectionConf.AutoInjectedConv = DISABLE;
-    ADC_InjectionConf.InjecOversamplingMode = DISABLE;
-    ADC_InjectionConf.InjectedDiscontinuousConvMode = DISABLE;
-    ADC_InjectionConf.InjectedOffsetNumber = ADC_OFFSET_NONE;
-    HAL_ADCEx_InjectedConfigChannel(&ADC_Handle, &ADC_InjectionConf);
+    ADC_ChannelConfTypeDef ADC_ChannelConf;
+    ADC_ChannelConf.Channel = INIT_BAT_AN_CH;
+    ADC_ChannelConf.Rank = INIT_BAT_RANK;
+    ADC_ChannelConf.SamplingTime = ADC_SAMPLETIME_47CYCLES_5;
+    ADC_ChannelConf.SingleDiff = ADC_SINGLE_ENDED;
+    ADC_ChannelConf.OffsetNumber = ADC_OFFSET_NONE;
+    ADC_ChannelConf.Offset = 0U;
+    HAL_ADC_ConfigChannel(&ADC_Handle, &ADC_ChannelConf);
+
+    ADC_ChannelConf.Channel = INIT_ANEMOMETER_AN_CH;
+    ADC_ChannelConf.Rank = INIT_ANEMOMETER_RANK;
+    ADC_ChannelConf.SamplingTime = ADC_SAMPLETIME_47CYCLES_5;
+    ADC_ChannelConf.SingleDiff = ADC_SINGLE_ENDED;
+    ADC_ChannelConf.OffsetNumber = ADC_OFFSET_NONE;
+    ADC_ChannelConf.Offset = 0U;
+    HAL_ADC_ConfigChannel(&ADC_Handle, &ADC_ChannelConf);
+
+    // DMA moves the results of the sequence
+    ADC_DmaHandle.Instance                 = INIT_ADC_DMA_CHANNEL;
+    ADC_DmaHandle.Init.Request             = INIT_ADC_DMA_REQUEST;
+    ADC_DmaHandle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    ADC_DmaHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    ADC_DmaHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    ADC_DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    ADC_DmaHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    ADC_DmaHandle.Init.Mode                = DMA_NORMAL;
+    ADC_DmaHandle.Init.Priority            = DMA_PRIORITY_LOW;
+    HAL_DMA_Init(&ADC_DmaHandle);
+    __HAL_LINKDMA(&ADC_Handle, DMA_Handle, ADC_DmaHandle);
 
     HAL_ADCEx_Calibration_Start(&ADC_Handle, ADC_SINGLE_ENDED);
 
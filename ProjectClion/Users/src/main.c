@@ -35,12 +35,16 @@
 // Project Includes
 //**************************************************************************************************
 
+// Native header
+#include "main.h"
+
 // drivers
 #include "OneWire.h"
 //#include "usart_drv.h"
 #include "Init.h"
 #include "ds18b20.h"
 #include "am2305_drv.h"
+#include "anemometer_drv.h"
 #include "record_manager.h"
 #include "ftoa.h"
 #include "printf.h"
@@ -118,8 +122,7 @@ typedef enum
 // Declarations of local (private) functions
 //**************************************************************************************************
 
-// System clock configuration
-static void SystemClock_Config(void);
+// None.
 
 
 
@@ -157,6 +160,10 @@ void main(void)
     // Init OneWire
     ONE_WIRE_init();
     AM2305_Init();
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+    // Start counting of the pulse anemometer
+    ANEMOMETER_Init();
+#endif
 //    USART_init();
 
     RECORD_MAN_xMutex = xSemaphoreCreateMutex();
@@ -217,23 +224,61 @@ void _putchar(char character)
 
 
 //**************************************************************************************************
-//==================================================================================================
-// Definitions of local (private) functions
-//==================================================================================================
+// @Function      vApplicationStackOverflowHook()
+//--------------------------------------------------------------------------------------------------
+// @Description   FreeRTOS hook of the stack overflow of the task.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called at the context switch, configCHECK_FOR_STACK_OVERFLOW = 2. The memory
+//                below the stack is corrupted, the target is reset. The records and the upload
+//                cursor are in the flash, the next upload resumes from the cursor.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    xTask - task of the overflow
+//                pcTaskName - name of the task
+//**************************************************************************************************
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    (void)xTask;
+    printf("Stack overflow: %s\r\n", pcTaskName);
+    NVIC_SystemReset();
+}// end of vApplicationStackOverflowHook
+
+
+
+//**************************************************************************************************
+// @Function      vApplicationIdleHook()
+//--------------------------------------------------------------------------------------------------
+// @Description   FreeRTOS hook of the idle task, the CPU sleeps until the next interrupt.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called by the idle task when no other task is ready, configUSE_IDLE_HOOK = 1.
+//                The core clock stops in the sleep mode, the peripherals and DMA keep running:
+//                the tick, the trigger timer of the ADC and the end of the transfers wake the
+//                CPU. The STOP2 mode between the measurements is entered by the master task.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
 //**************************************************************************************************
+void vApplicationIdleHook(void)
+{
+    HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+}// end of vApplicationIdleHook
+
+
 
 //**************************************************************************************************
 // @Function      SystemClock_Config()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Configure the system clock to 80 MHz, PLL from MSI.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         Called again after the wake up from STOP2, the CPU is clocked by MSI then.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
 // @Parameters    None.
 //**************************************************************************************************
-static void SystemClock_Config(void)
+void SystemClock_Config(void)
 {
     RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
     RCC_OscInitTypeDef RCC_OscInitStruct = {0};
@@ -271,4 +316,12 @@ static void SystemClock_Config(void)
 } // end of SystemClock_Config()
 
 
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
 //****************************************** end of file *******************************************
\ No newline at end of file
@@ -44,8 +44,15 @@
 // Get eeprom interface
 #include "eeprom_emulation.h"
 
+// Get AT command engine of the modem
+#include "gsm_at.h"
+
+// Get period of the GSM alarm
+#include "time_drv.h"
+
 #include "printf.h"
 #include "string.h"
+#include "stdlib.h"
 #include "ftoa.h"
 #include "Init.h"
 
@@ -55,7 +62,52 @@
 // Verification of the imported configuration parameters
 //**************************************************************************************************
 
-// None.
+#if (0U == TASK_GSM_BATCH_QTY_RECORDS)
+#error "TASK_GSM_BATCH_QTY_RECORDS must be greater than 0"
+#endif
+
+#if (0U == TASK_GSM_MAX_BATCHES_PER_SESSION)
+#error "TASK_GSM_MAX_BATCHES_PER_SESSION must be greater than 0"
+#endif
+
+#if ((TASK_GSM_MQTT_QOS_0 != TASK_GSM_MQTT_QOS) && (TASK_GSM_MQTT_QOS_1 != TASK_GSM_MQTT_QOS))
+#error "TASK_GSM_MQTT_QOS is not valid"
+#endif
+
+#if ((TASK_GSM_TRANSPORT_CIPSEND != TASK_GSM_TRANSPORT) && \
+     (TASK_GSM_TRANSPORT_TRANSPARENT != TASK_GSM_TRANSPORT))
+#error "TASK_GSM_TRANSPORT is not valid"
+#endif
+
+#if (0U == TASK_GSM_WINDOW_SIZE)
+#error "TASK_GSM_WINDOW_SIZE must be greater than 0"
+#endif
+
+// Every PUBLISH of the window occupies the record of coreMQTT until PUBACK
+#if ((TASK_GSM_MQTT_QOS_1 == TASK_GSM_MQTT_QOS) && \
+     (TASK_GSM_WINDOW_SIZE > MQTT_STATE_ARRAY_MAX_COUNT))
+#error "TASK_GSM_WINDOW_SIZE must not be greater than MQTT_STATE_ARRAY_MAX_COUNT"
+#endif
+
+#if (0U == TASK_GSM_MAX_CYCLES_PER_WAKEUP)
+#error "TASK_GSM_MAX_CYCLES_PER_WAKEUP must be greater than 0"
+#endif
+
+#if ((0U == TIME_ALARM_GSM_PERIOD_S) || (TIME_ALARM_GSM_PERIOD_S >= 86400U))
+#error "TIME_ALARM_GSM_PERIOD_S must be within 24 h"
+#endif
+
+#if (TASK_GSM_POLICY_MAX_SHIFT > 8U)
+#error "TASK_GSM_POLICY_MAX_SHIFT is too big"
+#endif
+
+#if (TASK_GSM_POLICY_MAX_AGE_S <= (2U * TIME_ALARM_GSM_PERIOD_S))
+#error "TASK_GSM_POLICY_MAX_AGE_S must be longer than two periods of the GSM alarm"
+#endif
+
+#if (100U != RECORD_MAN_PRESSURE_SCALE)
+#error "The upload prints the hundredths of the pressure, RECORD_MAN_PRESSURE_SCALE must be 100"
+#endif
 
 
 
@@ -72,7 +124,27 @@ TaskHandle_t TASK_GSM_hHandlerTask;
 // Declarations of local (private) data types
 //**************************************************************************************************
 
-// None.
+// State of the upload policy, kept in EEPROM over the standby
+typedef struct
+{
+    // Failed sessions in a row
+    uint8_t nQtyFailures;
+    // RSSI of AT+CSQ of the last session
+    uint8_t nCsq;
+} TASK_GSM_TYPE_POLICY;
+
+// Cached state of the connection, every state includes the previous
+typedef enum
+{
+    // Modem is powered off
+    TASK_GSM_LINK_OFF = 0U,
+    // Modem answers and is attached to GPRS
+    TASK_GSM_LINK_READY,
+    // TCP connection to the broker is open
+    TASK_GSM_LINK_TCP,
+    // MQTT session is connected
+    TASK_GSM_LINK_MQTT
+} TASK_GSM_LINK_STATE;
 
 
 
@@ -80,8 +152,14 @@ TaskHandle_t TASK_GSM_hHandlerTask;
 // Definitions of local (private) constants
 //**************************************************************************************************
 
-// Mutex delay
-#define TASK_GSM_MUTEX_DELAY                (0U)
+// Mutex delay, ms
+#define TASK_GSM_MUTEX_DELAY                (1000U)
+
+// RSSI of AT+CSQ, not detectable
+#define TASK_GSM_CSQ_UNKNOWN                (99U)
+
+// RSSI was not measured yet
+#define TASK_GSM_CSQ_NOT_MEASURED           (0xFFU)
 
 // Size of send buffer
 #define TASK_GSM_SIZE_OF_SEND_BUF           (0x800U)
@@ -89,14 +167,41 @@ TaskHandle_t TASK_GSM_hHandlerTask;
 // Size of printf buffer
 #define TASK_GSM_SIZE_BUFF_PRINT            (64U)
 
+// Max data length of AT+CIPSEND
+#define TASK_GSM_MAX_LEN_CIPSEND            (1460U)
+
+// Size of the buffer of AT command, AT+CIPSTART with the host of the broker fits it
+#define TASK_GSM_SIZE_BUFF_CMD              (64U)
+
+// Size of the buffer of the data dropped after DISCONNECT, "\r\nCLOSED\r\n" fits it
+#define TASK_GSM_SIZE_DROP                  (16U)
+
+// Timeout of one call of MQTT_ProcessLoop(), ms
+#define TASK_GSM_PROCESS_LOOP_MS            (100U)
+
+// Size of payload buffer
+#define TASK_GSM_SIZE_PAYLOAD               (128U)
+
+// Quantity of record fields in payload
+#define TASK_GSM_QTY_FIELDS                 (6U)
+
 
 
 //**************************************************************************************************
 // Definitions of static global (private) variables
 //**************************************************************************************************
 
-// Buf for record
-static uint8_t TASK_GSM_aDataRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES];
+// Batch of records to send, word aligned for access to the float fields
+static uint32_t TASK_GSM_aBatch[TASK_GSM_BATCH_QTY_RECORDS][RECORD_MAN_SIZE_OF_RECORD_BYTES / sizeof(uint32_t)];
+
+// Checksum of the record in the batch is valid
+static BOOLEAN TASK_GSM_aBatchValid[TASK_GSM_BATCH_QTY_RECORDS];
+
+// Packet ID of PUBLISH of the record in the batch
+static uint16_t TASK_GSM_aBatchPacketId[TASK_GSM_BATCH_QTY_RECORDS];
+
+// The record in the batch is acknowledged
+static BOOLEAN TASK_GSM_aBatchAcked[TASK_GSM_BATCH_QTY_RECORDS];
 
 // Transport interface for mqtt
 static TransportInterface_t transport;
@@ -119,27 +224,28 @@ static RECORD_MAN_TYPE_RECORD RECORD_MAN_aRecord;
 // Printf buffer
 static char TASK_GSM_aBufferPrintf[TASK_GSM_SIZE_BUFF_PRINT];
 
-static const int8_t MQTT_AT[] = {"AT\r"};
-static const int8_t MQTT_AT_CIPSTATUS[] = {"AT+CIPSTATUS\r"};
-static const int8_t MQTT_AT_CSTT[] = {"AT+CSTT=\"internet\"\r"};
-static const int8_t MQTT_AT_CIICR[] = {"AT+CIICR\r"};
-static const int8_t MQTT_AT_CIFSR[] = {"AT+CIFSR\r"};
-//static const int8_t MQTT_AT_CIPSTART[] = {"AT+CIPSTART=\"TCP\",\"dev.rightech.io\",\"1883\"\r"};
-static const int8_t MQTT_AT_CIPSTART[] = {"AT+CIPSTART=\"TCP\",\"m7.wqtt.ru\",\"12542\"\r"};
-static const int8_t MQTT_AT_CIPSEND[] = {"AT+CIPSEND\r"};
-static const int8_t MQTT_AT_CIPSEND_QTY_SEND[] = {"AT+CIPSEND?\r"};
-static const int8_t MQTT_AT_CIPQSEND[] = {"AT+CIPQSEND?\r"};
-static const int8_t MQTT_AT_CIPMODE[] = {"AT+CIPMODE=1\r"};
-static const int8_t MQTT_AT_CIPMUX[] = {"AT+CIPMUX=0\r"};
-static const int8_t MQTT_AT_SAPBR_3_1[] = {"AT+SAPBR=3,1,\"CONTYPE\",\"GPRS\"\r"};
-static const int8_t MQTT_AT_SAPBR_3_1_APN[] = {"AT+SAPBR=3,1,\"APN\",\"internet\"\r"};
-static const int8_t MQTT_AT_SAPBR_1_1_[] = {"AT+SAPBR=1,1\r"};
-static const int8_t MQTT_AT_SAPBR_2_1_[] = {"AT+SAPBR=2,1\r"};
-
-static const char MQTT_TYPE[] = {"MQIsdp"};
-static const char MQTT_CID[] = {"meteostation"};
-static const char MQTT_TOPIC[] = {"base/state/temperature"};
-static const char MQTT_MESSAGE[] = {"23"};
+// AT command buffer
+static char TASK_GSM_aBufferCmd[TASK_GSM_SIZE_BUFF_CMD];
+
+// Payload buffer
+static char TASK_GSM_aPayload[TASK_GSM_SIZE_PAYLOAD];
+
+// RSSI of AT+CSQ of the current session
+static uint8_t TASK_GSM_nCsq = TASK_GSM_CSQ_NOT_MEASURED;
+
+// Cached state of the connection
+static TASK_GSM_LINK_STATE TASK_GSM_enLink = TASK_GSM_LINK_OFF;
+
+static const char MQTT_AT[] = {"AT\r"};
+static const char MQTT_AT_CIPSTATUS[] = {"AT+CIPSTATUS\r"};
+static const char MQTT_AT_CIPMODE[] = {"AT+CIPMODE=1\r"};
+static const char MQTT_AT_E0[] = {"ATE0\r"};
+static const char MQTT_AT_CIPHEAD[] = {"AT+CIPHEAD=1\r"};
+static const char MQTT_AT_CGATT[] = {"AT+CGATT?\r"};
+static const char MQTT_AT_CSQ[] = {"AT+CSQ\r"};
+static const char MQTT_AT_CIPSHUT[] = {"AT+CIPSHUT\r"};
+static const char MQTT_AT_CIPCLOSE[] = {"AT+CIPCLOSE\r"};
+static const char MQTT_AT_ESCAPE[] = {"+++"};
 static const char MQTT_USER_NAME[] = {"u_I8KUVV"};
 static const char MQTT_PSW[] = {"D1MoanFH"};
 
@@ -154,9 +260,6 @@ static int32_t TASK_GSM_SendMessage(NetworkContext_t * pNetworkContext,
                                     const void * pBuffer,
                                     size_t bytesToSend);
 
-// Put char function
-static void TASK_GSM_PutChar(const char character);
-
 // Receive message from GSM module
 static int32_t TASK_GSM_ReceiveMessage(NetworkContext_t * pContext,
                                        void * pBuffer,
@@ -170,14 +273,68 @@ static void TASK_GSM_EventCallback(MQTTContext_t * pContext,
                                    MQTTPacketInfo_t * pPacketInfo,
                                    MQTTDeserializedInfo_t * pDeserializedInfo);
 
-// Put string to GSM module
-static void TASK_GSM_PutString(const char* s);
+// Send all not acknowledged records to server
+static uint32_t TASK_GSM_UploadBacklog(BOOLEAN *pSessionOk, BOOLEAN *pBacklogLeft);
+
+// Get quantity and age of the pending records and the battery voltage of the last record
+static STD_RESULT TASK_GSM_GetBacklog(uint32_t *pQtyPending,
+                                      uint32_t *pAgeS,
+                                      float *pBatteryVoltage);
+
+// Load the state of the upload policy
+static void TASK_GSM_LoadPolicy(TASK_GSM_TYPE_POLICY *pPolicy);
 
-// Task delay
-static void TASK_GSM_Delay(TickType_t ms);
+// Store the state of the upload policy
+static void TASK_GSM_StorePolicy(const TASK_GSM_TYPE_POLICY *pPolicy);
 
-// Send MQTT message to server
-static void TASK_GSM_SendMQTTMessage(RECORD_MAN_TYPE_RECORD stRecord);
+// Update the state of the upload policy after the session
+static void TASK_GSM_UpdatePolicy(BOOLEAN bSessionOk);
+
+// Load the next batch of records
+static STD_RESULT TASK_GSM_LoadBatch(uint32_t *pCursor, uint32_t *pQtyRecords);
+
+// Store the upload cursor
+static STD_RESULT TASK_GSM_StoreCursor(uint32_t nCursor);
+
+// Connect to MQTT broker
+static STD_RESULT TASK_GSM_Connect(void);
+
+// Check that the cached TCP connection is alive
+static void TASK_GSM_CheckLink(void);
+
+// Publish record to server
+static STD_RESULT TASK_GSM_PublishRecord(const RECORD_MAN_TYPE_RECORD *pRecord,
+                                         uint16_t *pPacketId);
+
+// Publish batch through the send window
+static STD_RESULT TASK_GSM_PublishBatch(uint32_t nCursor, uint32_t nQtyRecords);
+
+// Get quantity of the acknowledged records from the start of the batch
+static uint32_t TASK_GSM_GetQtyAcked(uint32_t nQtyRecords);
+
+// Get quantity of the published records waiting for PUBACK
+static uint32_t TASK_GSM_GetQtyInFlight(uint32_t nQtyRecords);
+
+#if (TASK_GSM_MQTT_QOS_0 == TASK_GSM_MQTT_QOS)
+// Confirm the QoS 0 records sent before by PINGRESP
+static STD_RESULT TASK_GSM_ConfirmByPing(void);
+#endif
+
+// Encode record to payload
+static uint32_t TASK_GSM_EncodeRecord(const RECORD_MAN_TYPE_RECORD *pRecord,
+                                      char *pBuffer,
+                                      uint32_t nSize);
+
+// Disconnect from MQTT broker
+static void TASK_GSM_Disconnect(void);
+
+// Wait for the modem and the network
+static STD_RESULT TASK_GSM_StartUp(void);
+
+// Repeat the command until the expected response
+static STD_RESULT TASK_GSM_Poll(const char *pCommand,
+                                const char *pExpected,
+                                uint32_t nTimeoutMs);
 
 
 
@@ -192,9 +349,10 @@ static void TASK_GSM_SendMQTTMessage(RECORD_MAN_TYPE_RECORD stRecord);
 //**************************************************************************************************
 // @Function      vTaskGSM()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Uploads the backlog after the GSM alarm.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         While the backlog is left the cycles run back to back on the cached
+//                connection, the modem is powered off after the last cycle.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
@@ -202,8 +360,12 @@ static void TASK_GSM_SendMQTTMessage(RECORD_MAN_TYPE_RECORD stRecord);
 //**************************************************************************************************
 void vTaskGSM(void *pvParameters)
 {
-    uint32_t nQtyBytes = 0U;
-    uint32_t nNextRecord = 0U;
+    TickType_t nTickPowerOn = 0U;
+    uint32_t nModemOnMs = 0U;
+    uint32_t nQtySent = 0U;
+    uint32_t nQtyCycles = 0U;
+    BOOLEAN bSessionOk = FALSE;
+    BOOLEAN bBacklogLeft = FALSE;
 
     // Set transport interface members.
     transport.send = TASK_GSM_SendMessage;
@@ -213,65 +375,168 @@ void vTaskGSM(void *pvParameters)
     fixedBuffer.pBuffer = TASK_GSM_SendBuffer;
     fixedBuffer.size = TASK_GSM_SIZE_OF_SEND_BUF;
 
+    // Init AT command engine
+    GSM_AT_Init();
+
     for(;;)
     {
-
-        // Attempt get mutex
-        if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_GSM_MUTEX_DELAY))
+        if (TASK_GSM_LINK_OFF == TASK_GSM_enLink)
         {
             // Power GSM ON
             HAL_GPIO_WritePin(INIT_DC_GSM_PORT, INIT_DC_GSM_PIN, GPIO_PIN_RESET);
+            nTickPowerOn = xTaskGetTickCount();
+            TASK_GSM_nCsq = TASK_GSM_CSQ_NOT_MEASURED;
+            nQtySent = 0U;
+            nQtyCycles = 0U;
+        }
+        else
+        {
+            DoNothing();
+        }
 
-            // Get the next - 1 record
-            EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
-                       (U8*)&nNextRecord,
-                       RECORD_MAN_SIZE_VIR_ADR);
+        // Send all records which were not acknowledged yet
+        nQtySent += TASK_GSM_UploadBacklog(&bSessionOk, &bBacklogLeft);
+        nQtyCycles++;
 
-            if (0 != nNextRecord)
+        if ((TRUE == bSessionOk) &&
+            (TRUE == bBacklogLeft) &&
+            (nQtyCycles < TASK_GSM_MAX_CYCLES_PER_WAKEUP))
+        {
+            // Catch up the backlog on the cached connection
+            printf("TASK_GSM: Backlog is left, the connection is kept\r\n");
+        }
+        else
+        {
+            if (TASK_GSM_LINK_TCP <= TASK_GSM_enLink)
             {
-                nNextRecord -= 1U;
+                TASK_GSM_Disconnect();
             }
             else
             {
                 DoNothing();
             }
 
-            // Load record
-            if (RESULT_OK == RECORD_MAN_Load(nNextRecord,
-                                             TASK_GSM_aDataRecord,
-                                              &nQtyBytes))
-            {
-                printf("Record Load OK\r\n");
-                printf("Sending data to the server...\r\n");
-                TASK_GSM_SendMQTTMessage(*(RECORD_MAN_TYPE_RECORD*)TASK_GSM_aDataRecord);
-            }
-            else
-            {
-                printf("Record Load error\r\n");
-            }
+            // Power GSM OFF
+            HAL_GPIO_WritePin(INIT_DC_GSM_PORT, INIT_DC_GSM_PIN, GPIO_PIN_SET);
+            TASK_GSM_enLink = TASK_GSM_LINK_OFF;
+
+            // Result of the last session of the wakeup for the next upload decision
+            TASK_GSM_UpdatePolicy(bSessionOk);
+
+            // Modem on time of the session
+            nModemOnMs = (uint32_t)(xTaskGetTickCount() - nTickPowerOn) * portTICK_RATE_MS;
+            printf("TASK_GSM: %lu records sent in %lu cycles, modem on %lu ms, %lu ms per record\r\n",
+                   (unsigned long)nQtySent,
+                   (unsigned long)nQtyCycles,
+                   (unsigned long)nModemOnMs,
+                   (unsigned long)((0U != nQtySent) ? (nModemOnMs / nQtySent) : 0U));
+            // Free stack of the deepest session, TASK_GSM_STACK_DEPTH is sized from it
+            printf("TASK_GSM: Free stack %lu words\r\n",
+                   (unsigned long)uxTaskGetStackHighWaterMark(NULL));
+
+            // Blocking task GSM
+            vTaskSuspend(TASK_GSM_hHandlerTask);
+        }
+    }
+} // end of vTaskGSM()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_IsUploadDue()
+//--------------------------------------------------------------------------------------------------
+// @Description   Upload policy. Decides on the GSM alarm whether the session is worth powering
+//                the modem. The session starts when the oldest pending record waited for
+//                the periods of the GSM alarm or is older than TASK_GSM_POLICY_MAX_AGE_S.
+//                The wait is doubled for every failed session in a row, for the low battery
+//                and for the poor signal, so in the poor conditions the station skips the
+//                alarms, batches more and connects less often.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The age is taken from the time of the records, the skipped alarms are not
+//                counted, so nothing is stored in EEPROM on the postponed upload.
+//                The modem is never powered below TASK_GSM_POLICY_BATTERY_CRITICAL_V.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE - resume the GSM task
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+BOOLEAN TASK_GSM_IsUploadDue(void)
+{
+    BOOLEAN bDue = FALSE;
+    TASK_GSM_TYPE_POLICY stPolicy;
+    uint32_t nQtyPending = 0U;
+    uint32_t nAgeS = 0U;
+    uint32_t nShift = 0U;
+    uint32_t nWaitS = 0U;
+    float fBatteryVoltage = 0.0F;
+
+    TASK_GSM_LoadPolicy(&stPolicy);
+
+    if (RESULT_OK != TASK_GSM_GetBacklog(&nQtyPending, &nAgeS, &fBatteryVoltage))
+    {
+        // The backlog is unknown, let the session check it
+        bDue = TRUE;
+    }
+    else if (0U == nQtyPending)
+    {
+        DoNothing();
+    }
+    else if (fBatteryVoltage < TASK_GSM_POLICY_BATTERY_CRITICAL_V)
+    {
+        printf("TASK_GSM: Battery is too low for the modem\r\n");
+    }
+    else
+    {
+        nShift = stPolicy.nQtyFailures;
 
+        if (fBatteryVoltage < TASK_GSM_POLICY_BATTERY_LOW_V)
+        {
+            nShift++;
+        }
+        else
+        {
+            DoNothing();
+        }
 
-            // Update last record number
-            EMEEP_Store(RECORD_MAN_VIR_ADR32_LAST_RECORD,
-                        (U8*)&nNextRecord,
-                        RECORD_MAN_SIZE_VIR_ADR);
+        if ((TASK_GSM_CSQ_NOT_MEASURED != stPolicy.nCsq) &&
+            ((TASK_GSM_CSQ_UNKNOWN == stPolicy.nCsq) || (stPolicy.nCsq < TASK_GSM_POLICY_CSQ_POOR)))
+        {
+            nShift++;
+        }
+        else
+        {
+            DoNothing();
+        }
 
-            // Return mutex
-            xSemaphoreGive(RECORD_MAN_xMutex);
+        if (nShift > TASK_GSM_POLICY_MAX_SHIFT)
+        {
+            nShift = TASK_GSM_POLICY_MAX_SHIFT;
         }
         else
         {
-            printf("TASK_GSM: Mutex of record manager is busy\r\n");
+            DoNothing();
         }
 
-        // Power GSM OFF
-        HAL_GPIO_WritePin(INIT_DC_GSM_PORT, INIT_DC_GSM_PIN, GPIO_PIN_SET);
+        // The periods of the alarm less the half one
+        nWaitS = (TIME_ALARM_GSM_PERIOD_S << nShift) - (TIME_ALARM_GSM_PERIOD_S / 2U);
+        if ((nAgeS >= nWaitS) ||
+            (nAgeS >= TASK_GSM_POLICY_MAX_AGE_S))
+        {
+            bDue = TRUE;
+        }
+        else
+        {
+            printf("TASK_GSM: Upload is postponed\r\n");
+        }
 
-        // Blocking task GSM
-        vTaskSuspend(TASK_GSM_hHandlerTask);
-//        vTaskDelay(1000/portTICK_RATE_MS);
+        printf("TASK_GSM: %lu records pending, age %lu s, wait %lu s\r\n",
+               (unsigned long)nQtyPending,
+               (unsigned long)nAgeS,
+               (unsigned long)nWaitS);
     }
-} // end of vTaskGSM()
+
+    return bDue;
+} // end of TASK_GSM_IsUploadDue()
 
 
 
@@ -284,321 +549,1360 @@ void vTaskGSM(void *pvParameters)
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_SendMQTTMessage()
+// @Function      TASK_GSM_UploadBacklog()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Store and forward uploader. Walks from the last acknowledged record to the
+//                head of the record area in batches and advances the persisted cursor over
+//                the acknowledged records after each batch.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         The cursor is stored in EEPROM once per batch, so after a power loss the
+//                upload resumes from the first not acknowledged record. A record which was
+//                delivered but whose PUBACK was lost is sent twice.
+//                The connection is left open, it is closed by the caller.
 //--------------------------------------------------------------------------------------------------
-// @ReturnValue   None.
+// @ReturnValue   Quantity of records sent.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    None.
+// @Parameters    pSessionOk   - [out] TRUE - the backlog or the batch limit of the session is
+//                               reached without errors
+//                pBacklogLeft - [out] TRUE - the batch limit is reached, the backlog may be left
 //**************************************************************************************************
-static void TASK_GSM_SendMQTTMessage(RECORD_MAN_TYPE_RECORD stRecord)
+static uint32_t TASK_GSM_UploadBacklog(BOOLEAN *pSessionOk, BOOLEAN *pBacklogLeft)
 {
-    uint16_t packetId;
+    STD_RESULT enResult = RESULT_OK;
+    BOOLEAN bConnected = FALSE;
+    uint32_t nQtySent = 0U;
+    uint32_t nCursor = 0U;
+    uint32_t nQtyRecords = 0U;
+    uint32_t nQtyBatches = 0U;
+    uint32_t nQtyAcked = 0U;
+
+    do
+    {
+        // Copy the next batch to RAM, the record manager is not locked during sending
+        enResult = TASK_GSM_LoadBatch(&nCursor, &nQtyRecords);
 
-    TASK_GSM_Delay(8000);
+        if ((RESULT_OK == enResult) && (0U != nQtyRecords))
+        {
+            if (FALSE == bConnected)
+            {
+                printf("Sending data to the server...\r\n");
+                enResult = TASK_GSM_Connect();
+                bConnected = TRUE;
+            }
+            else
+            {
+                DoNothing();
+            }
 
-    // Init MQTT
-    MQTT_Init( &MQTT_Context,
-               &transport,
-               TASK_GSM_GetTimeStampMs,
-               TASK_GSM_EventCallback,
-               &fixedBuffer);
-    MQTTConnectInfo_t connectInfo = { 0 };
-    MQTTPublishInfo_t willInfo = { 0 };
-    bool sessionPresent;
+            if (RESULT_OK == enResult)
+            {
+                enResult = TASK_GSM_PublishBatch(nCursor, nQtyRecords);
+            }
+            else
+            {
+                DoNothing();
+            }
 
-    // True for creating a new session with broker, false if we want to resume an old one.
-    connectInfo.cleanSession = true;
+            // Advance the cursor over the acknowledged records, one EEPROM write per batch
+            nQtyAcked = TASK_GSM_GetQtyAcked(nQtyRecords);
+            if (0U != nQtyAcked)
+            {
+                nCursor += nQtyAcked;
+                if (RESULT_OK != TASK_GSM_StoreCursor(nCursor))
+                {
+                    enResult = RESULT_NOT_OK;
+                }
+                else
+                {
+                    DoNothing();
+                }
+                nQtySent += nQtyAcked;
+            }
+            else
+            {
+                DoNothing();
+            }
 
-    // Client ID must be unique to broker. This field is required.
-//    connectInfo.pClientIdentifier = "meteostation";
-    connectInfo.pClientIdentifier = SECRET_MQTT_CLIENT_ID;
-    connectInfo.clientIdentifierLength = strlen(connectInfo.pClientIdentifier);
+            // The rest of the batch is published again in the next session
+            if (nQtyAcked < nQtyRecords)
+            {
+                printf("TASK_GSM: Records from %lu are not acknowledged\r\n", (unsigned long)nCursor);
+                enResult = RESULT_NOT_OK;
+            }
+            else
+            {
+                DoNothing();
+            }
 
-    // The following fields are optional.
-    // Value for keep alive.
-    connectInfo.keepAliveSeconds = 60;
-    // Optional username and password.
-    connectInfo.pUserName = SECRET_MQTT_USERNAME;
-//    connectInfo.pUserName = NULL;
-    connectInfo.userNameLength = strlen( connectInfo.pUserName );
-//    connectInfo.userNameLength = 0;
-    connectInfo.pPassword = SECRET_MQTT_PASSWORD;
-//    connectInfo.pPassword = NULL;
-    connectInfo.passwordLength = strlen( connectInfo.pPassword );
-//    connectInfo.passwordLength = 0;
+            nQtyBatches++;
+        }
+        else
+        {
+            DoNothing();
+        }
+    } while ((RESULT_OK == enResult) &&
+             (0U != nQtyRecords) &&
+             (nQtyBatches < TASK_GSM_MAX_BATCHES_PER_SESSION));
 
-    // The last will and testament is optional, it will be published by the broker
-    // should this client disconnect without sending a DISCONNECT packet.
-    willInfo.qos = MQTTQoS0;
-//    willInfo.pTopicName = "base/state/humidity";
-    willInfo.pTopicName = "channels/1843720/publish/fields/field1";
-    willInfo.topicNameLength = strlen( willInfo.pTopicName );
-    willInfo.pPayload = "25";
-    willInfo.payloadLength = strlen( "100" );
+    *pSessionOk = (RESULT_OK == enResult) ? TRUE : FALSE;
+    *pBacklogLeft = ((RESULT_OK == enResult) && (0U != nQtyRecords)) ? TRUE : FALSE;
 
-    TASK_GSM_PutString( MQTT_AT_CIPSTATUS);
-    TASK_GSM_Delay(2000);
+    return nQtySent;
+} // end of TASK_GSM_UploadBacklog()
 
-    // Start up connection
-//    TASK_GSM_PutString( "AT+CIPSTART=\"TCP\",\"dev.rightech.io\",\"1883\"\r");
-    TASK_GSM_PutString( "AT+CIPSTART=\"TCP\",\"mqtt3.thingspeak.com\",\"1883\"\r");
 
-    //TASK_GSM_PutString( MQTT_AT_CIPSTART);
-    TASK_GSM_Delay(8000);
 
-    TASK_GSM_PutString( MQTT_AT_CIPSTATUS);
-    TASK_GSM_Delay(2000);
+//**************************************************************************************************
+// @Function      TASK_GSM_GetBacklog()
+//--------------------------------------------------------------------------------------------------
+// @Description   Gets quantity of the records not acknowledged by the server, the age of the
+//                oldest of them and the battery voltage of the last record.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The age is the time between the first pending record and the last record.
+//                The voltage of the corrupted record is taken as TASK_GSM_POLICY_BATTERY_LOW_V,
+//                the age of the corrupted record as TASK_GSM_POLICY_MAX_AGE_S, the session
+//                skips it.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - data is valid
+//                RESULT_NOT_OK - the record manager is busy or EEPROM error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pQtyPending     - [out] quantity of the pending records
+//                pAgeS           - [out] age of the oldest pending record, s
+//                pBatteryVoltage - [out] battery voltage, V
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_GetBacklog(uint32_t *pQtyPending,
+                                      uint32_t *pAgeS,
+                                      float *pBatteryVoltage)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+    uint32_t aRecord[RECORD_MAN_SIZE_OF_RECORD_BYTES / sizeof(uint32_t)];
+    uint32_t nCursor = 0U;
+    uint32_t nHead = 0U;
+    uint32_t nQtyBytes = 0U;
+    uint32_t nLastTime = 0U;
+
+    *pQtyPending = 0U;
+    *pAgeS = 0U;
+    *pBatteryVoltage = TASK_GSM_POLICY_BATTERY_LOW_V;
 
-    if (MQTTNotConnected == MQTT_Context.connectStatus)
+    // Attempt get mutex
+    if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_GSM_MUTEX_DELAY / portTICK_RATE_MS))
     {
-        TASK_GSM_PutString( MQTT_AT_CIPSEND);
-        TASK_GSM_Delay(2000);
-        MQTT_Connect(&MQTT_Context,
-                     &connectInfo,
-                     &willInfo,
-                     100,
-                     &sessionPresent);
-
-        TASK_GSM_PutChar( 0x1a);
-        TASK_GSM_Delay(2000);
+        if ((RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                                     (U8*)&nCursor,
+                                     RECORD_MAN_SIZE_VIR_ADR)) &&
+            (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                     (U8*)&nHead,
+                                     RECORD_MAN_SIZE_VIR_ADR)))
+        {
+            // The record area was cleared, everything is pending
+            *pQtyPending = (nCursor > nHead) ? nHead : (nHead - nCursor);
 
-        ftoa(stRecord.fTemperature, TASK_GSM_aBufferPrintf, 3);
-        packetId = MQTT_GetPacketId(&MQTT_Context);
-        publishInfo.qos = MQTTQoS0;
-        publishInfo.pTopicName = "channels/1851639/publish/fields/field1";
-        publishInfo.topicNameLength = strlen(publishInfo.pTopicName);
-        publishInfo.pPayload = TASK_GSM_aBufferPrintf;
-        publishInfo.payloadLength = strlen(TASK_GSM_aBufferPrintf);
-        TASK_GSM_PutString( MQTT_AT_CIPSEND);
-        TASK_GSM_Delay(4000);
-        MQTT_Publish(&MQTT_Context, &publishInfo, packetId);
-        TASK_GSM_PutChar( 0x1a);
-        TASK_GSM_Delay(4000);
-
-        ftoa(stRecord.fHumidity, TASK_GSM_aBufferPrintf, 3);
-        packetId = MQTT_GetPacketId(&MQTT_Context);
-        publishInfo.qos = MQTTQoS0;
-        publishInfo.pTopicName = "channels/1851639/publish/fields/field2";
-        publishInfo.topicNameLength = strlen(publishInfo.pTopicName);
-        publishInfo.pPayload = TASK_GSM_aBufferPrintf;
-        publishInfo.payloadLength = strlen(TASK_GSM_aBufferPrintf);
-        TASK_GSM_PutString( MQTT_AT_CIPSEND);
-        TASK_GSM_Delay(4000);
-        MQTT_Publish(&MQTT_Context, &publishInfo, packetId);
-        TASK_GSM_PutChar( 0x1a);
-        TASK_GSM_Delay(4000);
-
-        ftoa(stRecord.fPressure, TASK_GSM_aBufferPrintf, 3);
-        packetId = MQTT_GetPacketId(&MQTT_Context);
-        publishInfo.qos = MQTTQoS0;
-        publishInfo.pTopicName = "channels/1851639/publish/fields/field3";
-        publishInfo.topicNameLength = strlen(publishInfo.pTopicName);
-        publishInfo.pPayload = TASK_GSM_aBufferPrintf;
-        publishInfo.payloadLength = strlen(TASK_GSM_aBufferPrintf);
-        TASK_GSM_PutString( MQTT_AT_CIPSEND);
-        TASK_GSM_Delay(4000);
-        MQTT_Publish(&MQTT_Context, &publishInfo, packetId);
-        TASK_GSM_PutChar( 0x1a);
-        TASK_GSM_Delay(4000);
-
-        ftoa(stRecord.fBatteryVoltage, TASK_GSM_aBufferPrintf, 3);
-        packetId = MQTT_GetPacketId(&MQTT_Context);
-        publishInfo.qos = MQTTQoS0;
-        publishInfo.pTopicName = "channels/1851639/publish/fields/field4";
-        publishInfo.topicNameLength = strlen(publishInfo.pTopicName);
-        publishInfo.pPayload = TASK_GSM_aBufferPrintf;
-        publishInfo.payloadLength = strlen(TASK_GSM_aBufferPrintf);
-        TASK_GSM_PutString( MQTT_AT_CIPSEND);
-        TASK_GSM_Delay(4000);
-        MQTT_Publish(&MQTT_Context, &publishInfo, packetId);
-        TASK_GSM_PutChar( 0x1a);
-        TASK_GSM_Delay(4000);
-
-        ftoa(stRecord.fWindSpeed, TASK_GSM_aBufferPrintf, 3);
-        packetId = MQTT_GetPacketId(&MQTT_Context);
-        publishInfo.qos = MQTTQoS0;
-        publishInfo.pTopicName = "channels/1851639/publish/fields/field5";
-        publishInfo.topicNameLength = strlen(publishInfo.pTopicName);
-        publishInfo.pPayload = TASK_GSM_aBufferPrintf;
-        publishInfo.payloadLength = strlen(TASK_GSM_aBufferPrintf);
-        TASK_GSM_PutString( MQTT_AT_CIPSEND);
-        TASK_GSM_Delay(4000);
-        MQTT_Publish(&MQTT_Context, &publishInfo, packetId);
-        TASK_GSM_PutChar( 0x1a);
-        TASK_GSM_Delay(4000);
+            if ((0U != nHead) &&
+                (RESULT_OK == RECORD_MAN_Load(nHead - 1U, (uint8_t*)aRecord, &nQtyBytes)))
+            {
+                *pBatteryVoltage = ((RECORD_MAN_TYPE_RECORD*)aRecord)->fBatteryVoltage;
+                nLastTime = ((RECORD_MAN_TYPE_RECORD*)aRecord)->nUnixTime;
+            }
+            else
+            {
+                DoNothing();
+            }
 
-        TASK_GSM_PutString( MQTT_AT_CIPSEND);
-        TASK_GSM_Delay(4000);
-        MQTT_Disconnect(&MQTT_Context);
-        TASK_GSM_PutChar( 0x1a);
-        TASK_GSM_Delay(2000);
+            if (0U == *pQtyPending)
+            {
+                DoNothing();
+            }
+            else if (RESULT_OK == RECORD_MAN_Load(nHead - *pQtyPending, (uint8_t*)aRecord, &nQtyBytes))
+            {
+                if (nLastTime > ((RECORD_MAN_TYPE_RECORD*)aRecord)->nUnixTime)
+                {
+                    *pAgeS = nLastTime - ((RECORD_MAN_TYPE_RECORD*)aRecord)->nUnixTime;
+                }
+                else
+                {
+                    DoNothing();
+                }
+            }
+            else
+            {
+                *pAgeS = TASK_GSM_POLICY_MAX_AGE_S;
+            }
 
-        TASK_GSM_PutString( MQTT_AT_CIPSTATUS);
-        TASK_GSM_Delay(2000);
+            enResult = RESULT_OK;
+        }
+        else
+        {
+            printf("TASK_GSM: EMEEP_Load ERROR\r\n");
+        }
 
+        // Return mutex
+        xSemaphoreGive(RECORD_MAN_xMutex);
+    }
+    else
+    {
+        printf("TASK_GSM: Mutex of record manager is busy\r\n");
     }
 
-} // end of TASK_GSM_SendMQTTMessage()
+    return enResult;
+} // end of TASK_GSM_GetBacklog()
 
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_SendMessage()
+// @Function      TASK_GSM_LoadPolicy()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Loads the state of the upload policy from EEPROM.
 //--------------------------------------------------------------------------------------------------
-// @Notes         If no data is transmitted over the network due to a full TX buffer and
-//                no network error has occurred, this MUST return zero as the return value.
-//                A zero return value SHOULD represent that the send operation can be retried by
-//                calling the API function. Zero MUST NOT be returned if a network disconnection
-//                has occurred.
+// @Notes         The initial state is returned if the state was never stored.
 //--------------------------------------------------------------------------------------------------
-// @ReturnValue   The number of bytes sent or a negative value to indicate error.
+// @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    None.
+// @Parameters    pPolicy - [out] state of the upload policy
 //**************************************************************************************************
-static int32_t TASK_GSM_SendMessage(NetworkContext_t * pNetworkContext,
-                                    const void * pBuffer,
-                                    size_t bytesToSend)
+static void TASK_GSM_LoadPolicy(TASK_GSM_TYPE_POLICY *pPolicy)
 {
-    HAL_UART_Transmit(&UartGSMHandler,
-                       pBuffer,
-                       bytesToSend,
-                       10000);
+    STD_RESULT enResult = RESULT_NOT_OK;
 
-    return bytesToSend;
-} // end of TASK_GSM_SendMessage()
+    // Attempt get mutex
+    if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_GSM_MUTEX_DELAY / portTICK_RATE_MS))
+    {
+        enResult = EMEEP_Load(RECORD_MAN_VIR_ADR_GSM_POLICY,
+                              (U8*)pPolicy,
+                              sizeof(TASK_GSM_TYPE_POLICY));
+
+        // Return mutex
+        xSemaphoreGive(RECORD_MAN_xMutex);
+    }
+    else
+    {
+        printf("TASK_GSM: Mutex of record manager is busy\r\n");
+    }
+
+    if (RESULT_OK != enResult)
+    {
+        pPolicy->nQtyFailures = 0U;
+        pPolicy->nCsq = TASK_GSM_CSQ_NOT_MEASURED;
+    }
+    else
+    {
+        DoNothing();
+    }
+} // end of TASK_GSM_LoadPolicy()
 
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_ReceiveMessage()
+// @Function      TASK_GSM_StorePolicy()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Stores the state of the upload policy in EEPROM.
 //--------------------------------------------------------------------------------------------------
 // @Notes         None.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    None.
+// @Parameters    pPolicy - state of the upload policy
 //**************************************************************************************************
-static int32_t TASK_GSM_ReceiveMessage(NetworkContext_t * pContext,
-                                        void * pBuffer,
-                                        size_t bytes)
+static void TASK_GSM_StorePolicy(const TASK_GSM_TYPE_POLICY *pPolicy)
 {
-    return 0;
-} // end of TASK_GSM_ReceiveMessage()
+    // Attempt get mutex
+    if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_GSM_MUTEX_DELAY / portTICK_RATE_MS))
+    {
+        if (RESULT_OK != EMEEP_Store(RECORD_MAN_VIR_ADR_GSM_POLICY,
+                                     (const U8*)pPolicy,
+                                     sizeof(TASK_GSM_TYPE_POLICY)))
+        {
+            printf("TASK_GSM: EMEEP_Store ERROR\r\n");
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        // Return mutex
+        xSemaphoreGive(RECORD_MAN_xMutex);
+    }
+    else
+    {
+        printf("TASK_GSM: Mutex of record manager is busy\r\n");
+    }
+} // end of TASK_GSM_StorePolicy()
 
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_GetTimeStampMs()
+// @Function      TASK_GSM_UpdatePolicy()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Updates the state of the upload policy after the wakeup: counts the failed
+//                wakeups in a row and keeps RSSI of the last session.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         RSSI of the previous session is kept if the modem didn't answer AT+CSQ.
+//                The state is stored only if it was changed, the wakeups of the good network
+//                don't write EEPROM.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    None.
+// @Parameters    bSessionOk - the session was successful
 //**************************************************************************************************
-static uint32_t TASK_GSM_GetTimeStampMs(void)
+static void TASK_GSM_UpdatePolicy(BOOLEAN bSessionOk)
 {
-    return 0;
-} // end of TASK_GSM_GetTimeStampMs()
+    TASK_GSM_TYPE_POLICY stPolicy;
+    TASK_GSM_TYPE_POLICY stPrevPolicy;
+
+    TASK_GSM_LoadPolicy(&stPolicy);
+    stPrevPolicy = stPolicy;
+
+    if (TRUE == bSessionOk)
+    {
+        stPolicy.nQtyFailures = 0U;
+    }
+    else if (stPolicy.nQtyFailures < UINT8_MAX)
+    {
+        stPolicy.nQtyFailures++;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    if (TASK_GSM_CSQ_NOT_MEASURED != TASK_GSM_nCsq)
+    {
+        stPolicy.nCsq = TASK_GSM_nCsq;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    if ((stPrevPolicy.nQtyFailures != stPolicy.nQtyFailures) ||
+        (stPrevPolicy.nCsq != stPolicy.nCsq))
+    {
+        TASK_GSM_StorePolicy(&stPolicy);
+    }
+    else
+    {
+        DoNothing();
+    }
+} // end of TASK_GSM_UpdatePolicy()
 
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_EventCallback()
+// @Function      TASK_GSM_LoadBatch()
 //--------------------------------------------------------------------------------------------------
-// @Description   Callback function for receiving packets.
+// @Description   Reads the upload cursor and the head of the record area from EEPROM and
+//                loads up to TASK_GSM_BATCH_QTY_RECORDS records starting at the cursor.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Records with a wrong checksum are marked as not valid in the batch.
+//                The records of the batch are not sent and not acknowledged.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - the batch was loaded, *pQtyRecords may be zero
+//                RESULT_NOT_OK - the record manager is busy or EEPROM error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pCursor     - [out] number of the first record of the batch
+//                pQtyRecords - [out] quantity of records in the batch
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_LoadBatch(uint32_t *pCursor, uint32_t *pQtyRecords)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+    uint32_t nCursor = 0U;
+    uint32_t nHead = 0U;
+    uint32_t nQtyBytes = 0U;
+    uint32_t nItem = 0U;
+
+    *pQtyRecords = 0U;
+
+    // Attempt get mutex
+    if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_GSM_MUTEX_DELAY / portTICK_RATE_MS))
+    {
+        if ((RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                                     (U8*)&nCursor,
+                                     RECORD_MAN_SIZE_VIR_ADR)) &&
+            (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR32_NEXT_RECORD,
+                                     (U8*)&nHead,
+                                     RECORD_MAN_SIZE_VIR_ADR)))
+        {
+            // The record area was cleared, start from the beginning
+            if (nCursor > nHead)
+            {
+                nCursor = 0U;
+            }
+            else
+            {
+                DoNothing();
+            }
+
+            *pQtyRecords = nHead - nCursor;
+            if (*pQtyRecords > TASK_GSM_BATCH_QTY_RECORDS)
+            {
+                *pQtyRecords = TASK_GSM_BATCH_QTY_RECORDS;
+            }
+            else
+            {
+                DoNothing();
+            }
+
+            for (nItem = 0U; nItem < *pQtyRecords; nItem++)
+            {
+                // Nothing of the new batch is sent, the flags of the previous batch are
+                // dropped before the connection, which may fail
+                TASK_GSM_aBatchPacketId[nItem] = MQTT_PACKET_ID_INVALID;
+                TASK_GSM_aBatchAcked[nItem] = FALSE;
+
+                if (RESULT_OK == RECORD_MAN_Load(nCursor + nItem,
+                                                 (uint8_t*)TASK_GSM_aBatch[nItem],
+                                                 &nQtyBytes))
+                {
+                    TASK_GSM_aBatchValid[nItem] = TRUE;
+                }
+                else
+                {
+                    TASK_GSM_aBatchValid[nItem] = FALSE;
+                }
+            }
+
+            *pCursor = nCursor;
+            enResult = RESULT_OK;
+        }
+        else
+        {
+            printf("TASK_GSM: EMEEP_Load ERROR\r\n");
+        }
+
+        // Return mutex
+        xSemaphoreGive(RECORD_MAN_xMutex);
+    }
+    else
+    {
+        printf("TASK_GSM: Mutex of record manager is busy\r\n");
+    }
+
+    return enResult;
+} // end of TASK_GSM_LoadBatch()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_StoreCursor()
+//--------------------------------------------------------------------------------------------------
+// @Description   Stores the number of the first not acknowledged record in EEPROM.
 //--------------------------------------------------------------------------------------------------
 // @Notes         None.
 //--------------------------------------------------------------------------------------------------
-// @ReturnValue   None.
+// @ReturnValue   RESULT_OK     - the cursor was stored
+//                RESULT_NOT_OK - the record manager is busy or EEPROM error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCursor - number of the first not acknowledged record
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_StoreCursor(uint32_t nCursor)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+
+    // Attempt get mutex
+    if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_GSM_MUTEX_DELAY / portTICK_RATE_MS))
+    {
+        enResult = EMEEP_Store(RECORD_MAN_VIR_ADR32_LAST_RECORD,
+                               (U8*)&nCursor,
+                               RECORD_MAN_SIZE_VIR_ADR);
+
+        // Return mutex
+        xSemaphoreGive(RECORD_MAN_xMutex);
+    }
+    else
+    {
+        printf("TASK_GSM: Mutex of record manager is busy\r\n");
+    }
+
+    return enResult;
+} // end of TASK_GSM_StoreCursor()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_Connect()
+//--------------------------------------------------------------------------------------------------
+// @Description   Starts up the modem, the TCP connection and connects to the MQTT broker.
+//                The steps already done according to the cached state are skipped.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The session is persistent (cleanSession = false), so the broker keeps it
+//                when the TCP connection is opened again.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - MQTT session is connected
+//                RESULT_NOT_OK - error
 //--------------------------------------------------------------------------------------------------
 // @Parameters    None.
 //**************************************************************************************************
-static void TASK_GSM_EventCallback(MQTTContext_t * pContext,
-                                   MQTTPacketInfo_t * pPacketInfo,
-                                   MQTTDeserializedInfo_t * pDeserializedInfo)
+static STD_RESULT TASK_GSM_Connect(void)
 {
+    STD_RESULT enResult = RESULT_OK;
+    MQTTConnectInfo_t connectInfo = { 0 };
+    bool sessionPresent = false;
+    int nLength = 0;
 
-} // end of TASK_GSM_EventCallback()
+    // The cached connection may be lost since the last cycle
+    TASK_GSM_CheckLink();
+
+    // Wait for the modem and the network
+    if (TASK_GSM_LINK_OFF == TASK_GSM_enLink)
+    {
+        enResult = TASK_GSM_StartUp();
+        if (RESULT_OK == enResult)
+        {
+            TASK_GSM_enLink = TASK_GSM_LINK_READY;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    // Init MQTT for the new session
+    if (TASK_GSM_LINK_MQTT != TASK_GSM_enLink)
+    {
+        MQTT_Init( &MQTT_Context,
+                   &transport,
+                   TASK_GSM_GetTimeStampMs,
+                   TASK_GSM_EventCallback,
+                   &fixedBuffer);
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    // True for creating a new session with broker, false if we want to resume an old one.
+    // The session is kept, the not acknowledged records are published again from the cursor
+    connectInfo.cleanSession = false;
+
+    // Client ID must be unique to broker. This field is required.
+//    connectInfo.pClientIdentifier = "meteostation";
+    connectInfo.pClientIdentifier = SECRET_MQTT_CLIENT_ID;
+    connectInfo.clientIdentifierLength = strlen(connectInfo.pClientIdentifier);
+
+    // The following fields are optional.
+    // Value for keep alive.
+    connectInfo.keepAliveSeconds = 60;
+    // Optional username and password.
+    connectInfo.pUserName = SECRET_MQTT_USERNAME;
+//    connectInfo.pUserName = NULL;
+    connectInfo.userNameLength = strlen( connectInfo.pUserName );
+//    connectInfo.userNameLength = 0;
+    connectInfo.pPassword = SECRET_MQTT_PASSWORD;
+//    connectInfo.pPassword = NULL;
+    connectInfo.passwordLength = strlen( connectInfo.pPassword );
+//    connectInfo.passwordLength = 0;
+
+    // AT+CIPSTART of the broker of the configuration
+    nLength = snprintf(TASK_GSM_aBufferCmd, sizeof(TASK_GSM_aBufferCmd),
+                       "AT+CIPSTART=\"TCP\",\"%s\",\"%u\"\r",
+                       TASK_GSM_BROKER_HOST, (unsigned int)TASK_GSM_BROKER_PORT);
+    if ((nLength <= 0) || ((uint32_t)nLength >= sizeof(TASK_GSM_aBufferCmd)))
+    {
+        printf("TASK_GSM: Host of the broker is too long\r\n");
+        enResult = RESULT_NOT_OK;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    // Start up connection
+    if (RESULT_OK != enResult)
+    {
+        printf("TASK_GSM: Modem is not ready\r\n");
+    }
+    else if (TASK_GSM_LINK_READY == TASK_GSM_enLink)
+    {
+        GSM_AT_Purge();
+
+        if ((GSM_AT_RESP_OK == GSM_AT_Command(MQTT_AT_CIPSHUT,
+                                              "SHUT OK",
+                                              TASK_GSM_SHUT_TIMEOUT_MS)) &&
+            (GSM_AT_RESP_OK == GSM_AT_Command(TASK_GSM_aBufferCmd,
+#if (TASK_GSM_TRANSPORT_TRANSPARENT == TASK_GSM_TRANSPORT)
+                                              "CONNECT",
+#else
+                                              "CONNECT OK",
+#endif
+                                              TASK_GSM_CONNECT_TIMEOUT_MS)))
+        {
+#if (TASK_GSM_TRANSPORT_TRANSPARENT == TASK_GSM_TRANSPORT)
+            // The modem is in the data mode after "CONNECT"
+            GSM_AT_SetDataMode(TRUE);
+#endif
+            TASK_GSM_enLink = TASK_GSM_LINK_TCP;
+        }
+        else
+        {
+            printf("TASK_GSM: TCP connection ERROR\r\n");
+            enResult = RESULT_NOT_OK;
+        }
+    }
+    else
+    {
+        // TCP connection is cached
+        DoNothing();
+    }
+
+    // CONNECT and wait for CONNACK
+    if ((RESULT_OK == enResult) &&
+        (TASK_GSM_LINK_TCP == TASK_GSM_enLink))
+    {
+        if (MQTTSuccess != MQTT_Connect(&MQTT_Context,
+                                        &connectInfo,
+                                        NULL,
+                                        TASK_GSM_CONNACK_TIMEOUT_MS,
+                                        &sessionPresent))
+        {
+            printf("TASK_GSM: MQTT_Connect ERROR\r\n");
+            enResult = RESULT_NOT_OK;
+        }
+        else
+        {
+            printf("TASK_GSM: MQTT session present %u\r\n", (unsigned int)sessionPresent);
+            TASK_GSM_enLink = TASK_GSM_LINK_MQTT;
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return enResult;
+} // end of TASK_GSM_Connect()
 
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_PutString()
+// @Function      TASK_GSM_CheckLink()
 //--------------------------------------------------------------------------------------------------
-// @Description   Callback function for receiving packets.
+// @Description   Checks that the cached TCP connection is alive, otherwise the cached state
+//                falls back to the attached modem.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         In the transparent mode the modem can't answer the commands, the connection
+//                is alive until the modem reports "CLOSED".
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
 // @Parameters    None.
 //**************************************************************************************************
-static void TASK_GSM_PutString(const char* s)
+static void TASK_GSM_CheckLink(void)
 {
-    uint32_t len = strlen(s);
+    BOOLEAN bAlive = FALSE;
 
-    if (0 < len)
+    if (TASK_GSM_LINK_TCP <= TASK_GSM_enLink)
     {
-        HAL_UART_Transmit(&UartGSMHandler,
-                           s,
-                           len,
-                           10000);
+#if (TASK_GSM_TRANSPORT_TRANSPARENT == TASK_GSM_TRANSPORT)
+        bAlive = (FALSE == GSM_AT_IsClosed()) ? TRUE : FALSE;
+#else
+        if ((FALSE == GSM_AT_IsClosed()) &&
+            (GSM_AT_RESP_OK == GSM_AT_Command(MQTT_AT_CIPSTATUS,
+                                              "STATE: CONNECT OK",
+                                              TASK_GSM_AT_TIMEOUT_MS)))
+        {
+            bAlive = TRUE;
+        }
+        else
+        {
+            DoNothing();
+        }
+#endif
+
+        if (FALSE == bAlive)
+        {
+            printf("TASK_GSM: Cached connection is lost\r\n");
+            TASK_GSM_enLink = TASK_GSM_LINK_READY;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+} // end of TASK_GSM_CheckLink()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_PublishRecord()
+//--------------------------------------------------------------------------------------------------
+// @Description   Publishes all fields of the record in one PUBLISH packet.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - PUBLISH packet was sent, "SEND OK" received
+//                RESULT_NOT_OK - error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pRecord   - record to publish
+//                pPacketId - [out] packet ID of PUBLISH, not changed on error
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_PublishRecord(const RECORD_MAN_TYPE_RECORD *pRecord,
+                                         uint16_t *pPacketId)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+    uint16_t packetId;
+    size_t nRemainingLength = 0U;
+    size_t nPacketSize = 0U;
+
+#if (TASK_GSM_MQTT_QOS_1 == TASK_GSM_MQTT_QOS)
+    publishInfo.qos = MQTTQoS1;
+#else
+    publishInfo.qos = MQTTQoS0;
+#endif
+    publishInfo.pTopicName = TASK_GSM_TOPIC_PUBLISH;
+    publishInfo.topicNameLength = strlen(publishInfo.pTopicName);
+    publishInfo.pPayload = TASK_GSM_aPayload;
+    publishInfo.payloadLength = TASK_GSM_EncodeRecord(pRecord,
+                                                      TASK_GSM_aPayload,
+                                                      TASK_GSM_SIZE_PAYLOAD);
+
+    if ((0U != publishInfo.payloadLength) &&
+        (MQTTSuccess == MQTT_GetPublishPacketSize(&publishInfo,
+                                                  &nRemainingLength,
+                                                  &nPacketSize)))
+    {
+        printf("TASK_GSM: Payload %lu bytes, packet %lu bytes\r\n",
+               (unsigned long)publishInfo.payloadLength,
+               (unsigned long)nPacketSize);
+
+        packetId = MQTT_GetPacketId(&MQTT_Context);
+        if (MQTTSuccess == MQTT_Publish(&MQTT_Context, &publishInfo, packetId))
+        {
+            *pPacketId = packetId;
+            enResult = RESULT_OK;
+        }
+        else
+        {
+            printf("TASK_GSM: MQTT_Publish ERROR\r\n");
+        }
+    }
+    else
+    {
+        printf("TASK_GSM: Payload encoding ERROR\r\n");
+    }
+
+    return enResult;
+} // end of TASK_GSM_PublishRecord()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_PublishBatch()
+//--------------------------------------------------------------------------------------------------
+// @Description   Sliding window publisher. Keeps up to TASK_GSM_WINDOW_SIZE records of the
+//                batch in flight and publishes the next record as soon as any PUBACK frees
+//                the window.
+//--------------------------------------------------------------------------------------------------
+// @Notes         PUBACK is handled by TASK_GSM_EventCallback() and may come in any order.
+//                After the publish error the records in flight are still waited for.
+//                With QoS 0 the whole batch is sent at once and confirmed by one PINGRESP.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - all records are acknowledged
+//                RESULT_NOT_OK - publish error, PUBACK timeout or the connection error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCursor     - number of the first record of the batch
+//                nQtyRecords - quantity of records in the batch
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_PublishBatch(uint32_t nCursor, uint32_t nQtyRecords)
+{
+    STD_RESULT enResult = RESULT_OK;
+    BOOLEAN bDone = FALSE;
+    uint32_t nNext = 0U;
+    uint32_t nQtyInFlight = 0U;
+    uint32_t nQtyInFlightPrev = 0U;
+    TickType_t nAckTick = xTaskGetTickCount();
+
+    while (FALSE == bDone)
+    {
+        // PUBACK timeout is counted from the last PUBACK, it is checked before the window is
+        // filled again, otherwise the new PUBLISH hides the PUBACK with the small window
+        nQtyInFlight = TASK_GSM_GetQtyInFlight(nQtyRecords);
+        if (nQtyInFlight < nQtyInFlightPrev)
+        {
+            nAckTick = xTaskGetTickCount();
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        // Fill the window
+        while ((RESULT_OK == enResult) &&
+               (nNext < nQtyRecords) &&
+               (nQtyInFlight < TASK_GSM_WINDOW_SIZE))
+        {
+            if (TRUE == TASK_GSM_aBatchValid[nNext])
+            {
+                enResult = TASK_GSM_PublishRecord((RECORD_MAN_TYPE_RECORD*)TASK_GSM_aBatch[nNext],
+                                                  &TASK_GSM_aBatchPacketId[nNext]);
+#if (TASK_GSM_MQTT_QOS_0 == TASK_GSM_MQTT_QOS)
+                // No PUBACK with QoS 0, the record is sent, PINGRESP confirms the batch
+                TASK_GSM_aBatchAcked[nNext] = (RESULT_OK == enResult) ? TRUE : FALSE;
+#else
+                nQtyInFlight++;
+#endif
+            }
+            else
+            {
+                // Corrupted record can't be sent, skip it
+                printf("TASK_GSM: Record %lu skipped\r\n", (unsigned long)(nCursor + nNext));
+                TASK_GSM_aBatchAcked[nNext] = TRUE;
+            }
+            nNext++;
+        }
+
+        nQtyInFlightPrev = nQtyInFlight;
+
+        if (0U == nQtyInFlight)
+        {
+            if ((RESULT_OK == enResult) && (nQtyRecords != TASK_GSM_GetQtyAcked(nQtyRecords)))
+            {
+                enResult = RESULT_NOT_OK;
+            }
+            else
+            {
+                DoNothing();
+            }
+            bDone = TRUE;
+        }
+        else if ((xTaskGetTickCount() - nAckTick) >= (TASK_GSM_PUBACK_TIMEOUT_MS / portTICK_RATE_MS))
+        {
+            printf("TASK_GSM: PUBACK timeout\r\n");
+            enResult = RESULT_NOT_OK;
+            bDone = TRUE;
+        }
+        else if (MQTTSuccess != MQTT_ProcessLoop(&MQTT_Context, TASK_GSM_PROCESS_LOOP_MS))
+        {
+            printf("TASK_GSM: MQTT_ProcessLoop ERROR\r\n");
+            enResult = RESULT_NOT_OK;
+            bDone = TRUE;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+#if (TASK_GSM_MQTT_QOS_0 == TASK_GSM_MQTT_QOS)
+    if ((RESULT_OK != enResult) || (RESULT_OK != TASK_GSM_ConfirmByPing()))
+    {
+        // Nothing of the batch is confirmed, the cursor stays
+        for (uint32_t nItem = 0U; nItem < nQtyRecords; nItem++)
+        {
+            TASK_GSM_aBatchAcked[nItem] = FALSE;
+        }
+        enResult = RESULT_NOT_OK;
+    }
+    else
+    {
+        DoNothing();
+    }
+#endif
+
+    return enResult;
+} // end of TASK_GSM_PublishBatch()
 
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_GetQtyAcked()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get quantity of the acknowledged records from the start of the batch.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The cursor can't pass the not acknowledged record, the records after it are
+//                published again in the next session.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Quantity of the acknowledged records before the first not acknowledged.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nQtyRecords - quantity of records in the batch
+//**************************************************************************************************
+static uint32_t TASK_GSM_GetQtyAcked(uint32_t nQtyRecords)
+{
+    uint32_t nQtyAcked = 0U;
+
+    while ((nQtyAcked < nQtyRecords) && (TRUE == TASK_GSM_aBatchAcked[nQtyAcked]))
+    {
+        nQtyAcked++;
     }
 
-}// end of TASK_GSM_PutString()
+    return nQtyAcked;
+} // end of TASK_GSM_GetQtyAcked()
 
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_PutChar()
+// @Function      TASK_GSM_GetQtyInFlight()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Get quantity of the published records waiting for PUBACK.
 //--------------------------------------------------------------------------------------------------
 // @Notes         None.
 //--------------------------------------------------------------------------------------------------
+// @ReturnValue   Quantity of the records in flight.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nQtyRecords - quantity of records in the batch
+//**************************************************************************************************
+static uint32_t TASK_GSM_GetQtyInFlight(uint32_t nQtyRecords)
+{
+    uint32_t nQtyInFlight = 0U;
+    uint32_t nItem = 0U;
+
+    for (nItem = 0U; nItem < nQtyRecords; nItem++)
+    {
+        if ((MQTT_PACKET_ID_INVALID != TASK_GSM_aBatchPacketId[nItem]) &&
+            (FALSE == TASK_GSM_aBatchAcked[nItem]))
+        {
+            nQtyInFlight++;
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    return nQtyInFlight;
+} // end of TASK_GSM_GetQtyInFlight()
+
+
+
+#if (TASK_GSM_MQTT_QOS_0 == TASK_GSM_MQTT_QOS)
+//**************************************************************************************************
+// @Function      TASK_GSM_ConfirmByPing()
+//--------------------------------------------------------------------------------------------------
+// @Description   Confirms the QoS 0 records sent before by PINGREQ and PINGRESP.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The broker handles the packets of the connection in order, so PINGRESP
+//                comes after it got all PUBLISH packets sent before PINGREQ. "SEND OK" of
+//                the modem only means the data left the modem, and there is no "SEND OK"
+//                in the transparent mode.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - PINGRESP received
+//                RESULT_NOT_OK - PINGRESP timeout or the connection error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_ConfirmByPing(void)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+    BOOLEAN bDone = FALSE;
+    TickType_t nStartTick = xTaskGetTickCount();
+
+    if (MQTTSuccess == MQTT_Ping(&MQTT_Context))
+    {
+        while (FALSE == bDone)
+        {
+            if (false == MQTT_Context.waitingForPingResp)
+            {
+                enResult = RESULT_OK;
+                bDone = TRUE;
+            }
+            else if ((xTaskGetTickCount() - nStartTick) >= (TASK_GSM_PUBACK_TIMEOUT_MS / portTICK_RATE_MS))
+            {
+                printf("TASK_GSM: PINGRESP timeout\r\n");
+                bDone = TRUE;
+            }
+            else if (MQTTSuccess != MQTT_ProcessLoop(&MQTT_Context, TASK_GSM_PROCESS_LOOP_MS))
+            {
+                printf("TASK_GSM: MQTT_ProcessLoop ERROR\r\n");
+                bDone = TRUE;
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+    }
+    else
+    {
+        printf("TASK_GSM: MQTT_Ping ERROR\r\n");
+    }
+
+    return enResult;
+} // end of TASK_GSM_ConfirmByPing()
+#endif
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_EncodeRecord()
+//--------------------------------------------------------------------------------------------------
+// @Description   Encodes all fields of the record in the ThingSpeak channel feed format:
+//                "field1=<T>&field2=<RH>&field3=<P>&field4=<U>&field5=<wind>&field6=<gust>".
+//--------------------------------------------------------------------------------------------------
+// @Notes         The payload is not null terminated when the buffer is full.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Length of the payload, 0 if the buffer is too small.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pRecord - record to encode
+//                pBuffer - [out] payload
+//                nSize   - size of the payload buffer
+//**************************************************************************************************
+static uint32_t TASK_GSM_EncodeRecord(const RECORD_MAN_TYPE_RECORD *pRecord,
+                                      char *pBuffer,
+                                      uint32_t nSize)
+{
+    uint32_t nLength = 0U;
+    uint32_t nField = 0U;
+    int32_t nQty = 0;
+
+    for (nField = 1U; (nField <= TASK_GSM_QTY_FIELDS) && (nLength < nSize); nField++)
+    {
+        switch (nField)
+        {
+            case 1U:
+                ftoa(pRecord->fTemperature, TASK_GSM_aBufferPrintf, 3);
+                break;
+            case 2U:
+                ftoa(pRecord->fHumidity, TASK_GSM_aBufferPrintf, 3);
+                break;
+            case 3U:
+                // Integer Pa and hundredths
+                (void)snprintf(TASK_GSM_aBufferPrintf, sizeof(TASK_GSM_aBufferPrintf), "%lu.%02lu",
+                               (unsigned long)(pRecord->nPressure / RECORD_MAN_PRESSURE_SCALE),
+                               (unsigned long)(pRecord->nPressure % RECORD_MAN_PRESSURE_SCALE));
+                break;
+            case 4U:
+                ftoa(pRecord->fBatteryVoltage, TASK_GSM_aBufferPrintf, 3);
+                break;
+            case 5U:
+                ftoa(pRecord->fWindSpeed, TASK_GSM_aBufferPrintf, 3);
+                break;
+            default:
+                ftoa(pRecord->fWindGust, TASK_GSM_aBufferPrintf, 3);
+                break;
+        }
+
+        nQty = snprintf(&pBuffer[nLength],
+                        nSize - nLength,
+                        "%sfield%lu=%s",
+                        (1U == nField) ? "" : "&",
+                        (unsigned long)nField,
+                        TASK_GSM_aBufferPrintf);
+        if ((0 < nQty) && ((uint32_t)nQty < (nSize - nLength)))
+        {
+            nLength += (uint32_t)nQty;
+        }
+        else
+        {
+            // Buffer is too small
+            nLength = nSize;
+        }
+    }
+
+    if (nLength >= nSize)
+    {
+        nLength = 0U;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return nLength;
+} // end of TASK_GSM_EncodeRecord()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_Disconnect()
+//--------------------------------------------------------------------------------------------------
+// @Description   Disconnects from the MQTT broker.
+//--------------------------------------------------------------------------------------------------
+// @Notes         In the transparent mode the broker usually closes the connection after
+//                DISCONNECT and the modem leaves the data mode itself with "CLOSED". It is
+//                waited for during the guard time, only the open connection is switched to
+//                the command mode by "+++" with the guard time after it.
+//--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
 // @Parameters    None.
 //**************************************************************************************************
-static void TASK_GSM_PutChar(const char character)
+static void TASK_GSM_Disconnect(void)
 {
-    HAL_UART_Transmit(&UartGSMHandler,
-                       &character,
-                       1,
-                       10000);
-} // end of TASK_GSM_PutChar()
+#if (TASK_GSM_TRANSPORT_TRANSPARENT == TASK_GSM_TRANSPORT)
+    uint8_t aDrop[TASK_GSM_SIZE_DROP];
+    TickType_t nStartTick = 0U;
+#endif
+
+    (void)MQTT_Disconnect(&MQTT_Context);
+
+#if (TASK_GSM_TRANSPORT_TRANSPARENT == TASK_GSM_TRANSPORT)
+    // Nothing is sent during the wait, it is the guard time before "+++"
+    nStartTick = xTaskGetTickCount();
+    while ((FALSE == GSM_AT_IsClosed()) &&
+           ((xTaskGetTickCount() - nStartTick) < (TASK_GSM_ESCAPE_GUARD_MS / portTICK_RATE_MS)))
+    {
+        (void)GSM_AT_Read(aDrop, sizeof(aDrop), TASK_GSM_RECV_TIMEOUT_MS);
+    }
+
+    if (FALSE == GSM_AT_IsClosed())
+    {
+        GSM_AT_SetDataMode(FALSE);
+        (void)GSM_AT_Write(MQTT_AT_ESCAPE, sizeof(MQTT_AT_ESCAPE) - 1U);
+        (void)GSM_AT_Command(NULL, NULL, TASK_GSM_ESCAPE_GUARD_MS + TASK_GSM_AT_TIMEOUT_MS);
+    }
+    else
+    {
+        DoNothing();
+    }
+#endif
 
+    // Close TCP connection, the server may close it after DISCONNECT itself
+    (void)GSM_AT_Command(MQTT_AT_CIPCLOSE, "CLOSE OK", TASK_GSM_CLOSE_TIMEOUT_MS);
+    TASK_GSM_enLink = TASK_GSM_LINK_READY;
+} // end of TASK_GSM_Disconnect()
 
 
 
 //**************************************************************************************************
-// @Function      TASK_GSM_Delay()
+// @Function      TASK_GSM_StartUp()
+//--------------------------------------------------------------------------------------------------
+// @Description   Waits for the modem after power on and for the GPRS attach.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The first "AT" commands also set the baud rate of the modem.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - the modem is attached to GPRS
+//                RESULT_NOT_OK - timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_StartUp(void)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+
+    if ((RESULT_OK == TASK_GSM_Poll(MQTT_AT, NULL, TASK_GSM_STARTUP_TIMEOUT_MS)) &&
+        (GSM_AT_RESP_OK == GSM_AT_Command(MQTT_AT_E0, NULL, TASK_GSM_AT_TIMEOUT_MS)) &&
+        (GSM_AT_RESP_OK == GSM_AT_Command(MQTT_AT_CIPHEAD, NULL, TASK_GSM_AT_TIMEOUT_MS)) &&
+#if (TASK_GSM_TRANSPORT_TRANSPARENT == TASK_GSM_TRANSPORT)
+        (GSM_AT_RESP_OK == GSM_AT_Command(MQTT_AT_CIPMODE, NULL, TASK_GSM_AT_TIMEOUT_MS)) &&
+#endif
+        (RESULT_OK == TASK_GSM_Poll(MQTT_AT_CGATT, "+CGATT: 1", TASK_GSM_NETWORK_TIMEOUT_MS)))
+    {
+        enResult = RESULT_OK;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    // Signal quality for the upload policy, "+CSQ: <rssi>,<ber>"
+    if (GSM_AT_RESP_OK == GSM_AT_Command(MQTT_AT_CSQ, "+CSQ:", TASK_GSM_AT_TIMEOUT_MS))
+    {
+        TASK_GSM_nCsq = (uint8_t)strtoul(GSM_AT_GetResponse() + (sizeof("+CSQ:") - 1U), NULL, 10);
+        printf("TASK_GSM: CSQ %u\r\n", (unsigned int)TASK_GSM_nCsq);
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return enResult;
+} // end of TASK_GSM_StartUp()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_Poll()
+//--------------------------------------------------------------------------------------------------
+// @Description   Repeats the command until the expected response or the timeout.
+//--------------------------------------------------------------------------------------------------
+// @Notes         A command without the expected response takes TASK_GSM_AT_TIMEOUT_MS, it is
+//                the period of the polling.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK     - expected response received
+//                RESULT_NOT_OK - timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pCommand   - command with "\r"
+//                pExpected  - expected response, NULL - "OK"
+//                nTimeoutMs - timeout, ms
+//**************************************************************************************************
+static STD_RESULT TASK_GSM_Poll(const char *pCommand,
+                                const char *pExpected,
+                                uint32_t nTimeoutMs)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+    TickType_t nStartTick = xTaskGetTickCount();
+
+    while ((RESULT_NOT_OK == enResult) &&
+           ((xTaskGetTickCount() - nStartTick) < (nTimeoutMs / portTICK_RATE_MS)))
+    {
+        switch (GSM_AT_Command(pCommand, pExpected, TASK_GSM_AT_TIMEOUT_MS))
+        {
+            case GSM_AT_RESP_OK:
+                enResult = RESULT_OK;
+                break;
+            case GSM_AT_RESP_ERROR:
+                // The modem is not ready, wait the period of the polling
+                vTaskDelay(TASK_GSM_AT_TIMEOUT_MS / portTICK_RATE_MS);
+                break;
+            default:
+                DoNothing();
+                break;
+        }
+    }
+
+    return enResult;
+} // end of TASK_GSM_Poll()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_SendMessage()
+//--------------------------------------------------------------------------------------------------
+// @Description   Transport send of coreMQTT. In the transparent mode the data is written to
+//                the modem as is. Otherwise the data is sent by "AT+CIPSEND=<len>", the modem
+//                sends the data as soon as <len> bytes are received, so the answer of the
+//                server can be received before the next call.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Not more than TASK_GSM_MAX_LEN_CIPSEND bytes are sent per AT+CIPSEND.
+//                If no data is transmitted over the network due to a full TX buffer and
+//                no network error has occurred, this MUST return zero as the return value.
+//                A zero return value SHOULD represent that the send operation can be retried by
+//                calling the API function. Zero MUST NOT be returned if a network disconnection
+//                has occurred.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   The number of bytes sent or a negative value to indicate error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static int32_t TASK_GSM_SendMessage(NetworkContext_t * pNetworkContext,
+                                    const void * pBuffer,
+                                    size_t bytesToSend)
+{
+    int32_t nQtySent = -1;
+
+#if (TASK_GSM_TRANSPORT_TRANSPARENT == TASK_GSM_TRANSPORT)
+    if ((FALSE == GSM_AT_IsClosed()) &&
+        (RESULT_OK == GSM_AT_Write(pBuffer, bytesToSend)))
+    {
+        nQtySent = (int32_t)bytesToSend;
+    }
+    else
+    {
+        printf("TASK_GSM: Transparent send ERROR\r\n");
+    }
+#else
+    if (bytesToSend > TASK_GSM_MAX_LEN_CIPSEND)
+    {
+        bytesToSend = TASK_GSM_MAX_LEN_CIPSEND;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    sprintf(TASK_GSM_aBufferCmd, "AT+CIPSEND=%lu\r", (unsigned long)bytesToSend);
+
+    if ((FALSE == GSM_AT_IsClosed()) &&
+        (GSM_AT_RESP_OK == GSM_AT_Command(TASK_GSM_aBufferCmd,
+                                          GSM_AT_PROMPT,
+                                          TASK_GSM_AT_TIMEOUT_MS)) &&
+        (RESULT_OK == GSM_AT_Write(pBuffer, bytesToSend)) &&
+        (GSM_AT_RESP_OK == GSM_AT_Command(NULL,
+                                          "SEND OK",
+                                          TASK_GSM_SEND_TIMEOUT_MS)))
+    {
+        nQtySent = (int32_t)bytesToSend;
+    }
+    else
+    {
+        printf("TASK_GSM: CIPSEND ERROR\r\n");
+    }
+#endif
+
+    return nQtySent;
+} // end of TASK_GSM_SendMessage()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_ReceiveMessage()
+//--------------------------------------------------------------------------------------------------
+// @Description   Transport receive of coreMQTT. Reads the data received by the modem from
+//                the "+IPD" frames or in the transparent mode.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Blocks not longer than TASK_GSM_RECV_TIMEOUT_MS, so coreMQTT doesn't spin
+//                while it waits for the packet.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   The number of bytes received, 0 - no data, negative value - the connection
+//                is closed.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static int32_t TASK_GSM_ReceiveMessage(NetworkContext_t * pContext,
+                                        void * pBuffer,
+                                        size_t bytes)
+{
+    return GSM_AT_Read(pBuffer, bytes, TASK_GSM_RECV_TIMEOUT_MS);
+} // end of TASK_GSM_ReceiveMessage()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_GetTimeStampMs()
+//--------------------------------------------------------------------------------------------------
+// @Description   Time base of coreMQTT.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Wraps around after 49 days, coreMQTT handles the overflow.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Time from the start of the scheduler, ms.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static uint32_t TASK_GSM_GetTimeStampMs(void)
+{
+    return (uint32_t)(xTaskGetTickCount() * portTICK_RATE_MS);
+} // end of TASK_GSM_GetTimeStampMs()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_GSM_EventCallback()
 //--------------------------------------------------------------------------------------------------
 // @Description   Callback function for receiving packets.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         Called by coreMQTT for CONNACK, PUBACK, PINGRESP etc. PUBACK marks the
+//                record of the batch acknowledged.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    None.
+// @Parameters    pContext          - MQTT context
+//                pPacketInfo       - received packet
+//                pDeserializedInfo - deserialized packet
 //**************************************************************************************************
-static void TASK_GSM_Delay(TickType_t ms)
+static void TASK_GSM_EventCallback(MQTTContext_t * pContext,
+                                   MQTTPacketInfo_t * pPacketInfo,
+                                   MQTTDeserializedInfo_t * pDeserializedInfo)
 {
-    TickType_t currentTick = xTaskGetTickCount();
+    uint32_t nItem = 0U;
+
+    if (MQTT_PACKET_TYPE_PUBACK == pPacketInfo->type)
+    {
+        for (nItem = 0U; nItem < TASK_GSM_BATCH_QTY_RECORDS; nItem++)
+        {
+            if ((MQTT_PACKET_ID_INVALID != TASK_GSM_aBatchPacketId[nItem]) &&
+                (pDeserializedInfo->packetIdentifier == TASK_GSM_aBatchPacketId[nItem]))
+            {
+                TASK_GSM_aBatchAcked[nItem] = TRUE;
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+} // end of TASK_GSM_EventCallback()
+
 
-    while ((xTaskGetTickCount() - currentTick) < ms);
-} // end of TASK_GSM_Delay()
 
 //****************************************** end of file *******************************************
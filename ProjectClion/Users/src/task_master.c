@@ -1,282 +1,352 @@
-#include <sys/cdefs.h>
-//**************************************************************************************************
-// @Module        TASK_MASTER
-// @Filename      task_master.c
-//--------------------------------------------------------------------------------------------------
-// @Platform      stm32l4
-//--------------------------------------------------------------------------------------------------
-// @Compatible    stm32l476, stm32l452
-//--------------------------------------------------------------------------------------------------
-// @Description   Implementation of the W25Q functionality.
-//
-//
-//                Abbreviations:
-//                  None.
-//
-//
-//                Global (public) functions:
-//
-//
-//                Local (private) functions:
-//
-//
-//--------------------------------------------------------------------------------------------------
-// @Version       1.0.0
-//--------------------------------------------------------------------------------------------------
-// @Date          xx.xx.xxxx
-//--------------------------------------------------------------------------------------------------
-// @History       Version  Author      Comment
-// XX.XX.XXXX     1.0.0    KPS         First release.
-//**************************************************************************************************
-
-
-
-//**************************************************************************************************
-// Project Includes
-//**************************************************************************************************
-
-// Native header
-#include "task_master.h"
-
-// Get terminal inteface
-#include "term-srv.h"
-
-// Init interface
-#include "Init.h"
-
-// STD lib
-#include "string.h"
-
-// Get record manager interface
-#include "record_manager.h"
-
-// Get task read sensors
-#include "task_read_sensors.h"
-
-// Get task GSM interface
-#include "task_GSM.h"
-
-#include "W25Q_drv.h"
-
-#include "stdlib.h"
-
-#include "eeprom_emulation.h"
-
-#include "printf.h"
-
-#include "time_drv.h"
-
-#include "task_terminal.h"
-
-
-
-//**************************************************************************************************
-// Verification of the imported configuration parameters
-//**************************************************************************************************
-
-// None.
-
-
-//**************************************************************************************************
-// Definitions of global (public) variables
-//**************************************************************************************************
-
-// None.
-
-
-//**************************************************************************************************
-// Declarations of local (private) data types
-//*************************************************************************************************
-
-// None.
-
-
-
-//**************************************************************************************************
-// Definitions of local (private) constants
-//**************************************************************************************************
-
-// Mutex Acquisition Delay
-#define TASK_MASTER_MUTEX_DELAY                 (1000U)
-
-// Number of entries to send to the server
-#define TASK_GSM_QTY_REC_TO_SEND                (10U)
-
-
-
-//**************************************************************************************************
-// Definitions of static global (private) variables
-//**************************************************************************************************
-
-// Buff for record
-static uint8_t TASK_MASTER_aRecord[RECORD_MAN_MAX_SIZE_RECORD];
-
-/* Buffer used for displaying Time */
-static uint8_t aShowTime[50] = {0};
-
-static TIME_type sTime;
-
-static TIME_type AlarmSens;
-static TIME_type AlarmGSM;
-
-
-//**************************************************************************************************
-// Declarations of local (private) functions
-//**************************************************************************************************
-
-// None.
-
-
-
-//**************************************************************************************************
-//==================================================================================================
-// Definitions of global (public) functions
-//==================================================================================================
-//**************************************************************************************************
-
-//**************************************************************************************************
-// @Function      vTaskMaster()
-//--------------------------------------------------------------------------------------------------
-// @Description   None.
-//--------------------------------------------------------------------------------------------------
-// @Notes         None.
-//--------------------------------------------------------------------------------------------------
-// @ReturnValue   None.
-//--------------------------------------------------------------------------------------------------
-// @Parameters    None.
-//**************************************************************************************************
-_Noreturn void vTaskMaster(void *pvParameters)
-{
-    TaskStatus_t xTaskStatus;
-
-//    W25Q_EraseBlock(0,W25Q_BLOCK_MEMORY_ALL);
-//while(1);
-
-    // Load alarm sens value
-    if (0U)//(RESULT_OK == TIME_LoadAlarm(&AlarmSens, TIME_ALARM_SENS))
-    {
-        DoNothing();
-    }
-    else
-    {
-//        printf("task_master ERROR: TIME_LoadAlarm RESULT_NOT_OK\r\n");
-        // Set sensors alarm
-        AlarmSens.tm_hour = TIME_ALARM_SENS_HOURS;
-        AlarmSens.tm_min = TIME_ALARM_SENS_MINUTES;
-        AlarmSens.tm_sec = TIME_ALARM_SENS_SECONDS;
-    }
-
-
-
-    // Load alarm gsm value
-    if (0)//(RESULT_OK == TIME_LoadAlarm(&AlarmGSM, TIME_ALARM_GSM))
-    {
-        DoNothing();
-    }
-    else
-    {
-//        printf("task_master ERROR: TIME_LoadAlarm RESULT_NOT_OK\r\n");
-        // Set sensors alarm
-        AlarmGSM.tm_hour = TIME_ALARM_GSM_HOURS;
-        AlarmGSM.tm_min = TIME_ALARM_GSM_MINUTES;
-        AlarmGSM.tm_sec = TIME_ALARM_GSM_SECONDS;
-    }
-
-
-    for(;;)
-    {
-        // Update dump eeprom
-//        RECORD_MAN_UpdateDumpMem();
-//        vTaskResume(TASK_READ_SEN_hHandlerTask);
-//        vTaskDelay(2000/portTICK_RATE_MS);
-
-        vTaskDelay(3000/portTICK_RATE_MS);
-        // Show current time
-        TIME_TimeShow();
-
-        // Check sensors alarm
-        if (TRUE == TIME_CheckAlarm(TIME_ALARM_SENS))
-        {
-            printf("The SENSORS alarm clock rang\r\n");
-
-            // Start measure
-            vTaskResume(TASK_READ_SEN_hHandlerTask);
-
-            vTaskDelay(5000/portTICK_RATE_MS);
-
-            // Set Alarm sens
-            TIME_SetAlarm(AlarmSens, TIME_ALARM_SENS);
-        }
-        else
-        {
-            DoNothing();
-        }
-
-        // Check GSM alarm
-        if (TRUE == TIME_CheckAlarm(TIME_ALARM_GSM))
-        {
-            printf("The GSM alarm clock rang\r\n");
-
-            // Send data to server
-            vTaskResume(TASK_GSM_hHandlerTask);
-
-            // Set Alarm GSM
-            TIME_SetAlarm(AlarmGSM, TIME_ALARM_GSM);
-        }
-        else
-        {
-            DoNothing();
-        }
-
-
-
-        // Check TASK_GSM state
-        vTaskGetInfo(TASK_GSM_hHandlerTask,&xTaskStatus,pdTRUE,eInvalid );
-
-        if (eSuspended == xTaskStatus.eCurrentState)
-        {
-            // Check TASK_READ_SEN state
-            vTaskGetInfo(TASK_READ_SEN_hHandlerTask,&xTaskStatus,pdTRUE,eInvalid );
-
-            if (eSuspended == xTaskStatus.eCurrentState)
-            {
-                if (TASK_TERMINAL_TIMEOUT <= TASK_TERMINAL_nTimeOut)
-                {
-
-                    printf("Go to standBy mode\r\n");
-
-                    // Enable pullUp for power control GSM
-                    HAL_PWREx_EnableGPIOPullUp(PWR_GPIO_C, PWR_GPIO_BIT_4);
-                    HAL_PWREx_EnablePullUpPullDownConfig();
-
-                    // Go to StandBy
-                    HAL_PWR_EnterSTANDBYMode();
-                }
-                else
-                {
-                    DoNothing();
-                }
-            }
-            else
-            {
-                DoNothing();
-            }
-        }
-        else
-        {
-            DoNothing();
-        }
-    }
-} // end of vTaskMaster()
-
-
-
-//**************************************************************************************************
-//==================================================================================================
-// Definitions of local (private) functions
-//==================================================================================================
-//**************************************************************************************************
-
-// None.
-
+#include <sys/cdefs.h>
+//**************************************************************************************************
+// @Module        TASK_MASTER
+// @Filename      task_master.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      stm32l4
+//--------------------------------------------------------------------------------------------------
+// @Compatible    stm32l476, stm32l452
+//--------------------------------------------------------------------------------------------------
+// @Description   Implementation of the W25Q functionality.
+//
+//
+//                Abbreviations:
+//                  None.
+//
+//
+//                Global (public) functions:
+//
+//
+//                Local (private) functions:
+//
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          xx.xx.xxxx
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "task_master.h"
+
+// Get terminal inteface
+#include "term-srv.h"
+
+// Init interface
+#include "Init.h"
+
+// STD lib
+#include "string.h"
+
+// Get record manager interface
+#include "record_manager.h"
+
+// Get task read sensors
+#include "task_read_sensors.h"
+
+// Get task GSM interface
+#include "task_GSM.h"
+
+#include "W25Q_drv.h"
+
+#include "stdlib.h"
+
+#include "eeprom_emulation.h"
+
+#include "printf.h"
+
+#include "time_drv.h"
+
+#include "anemometer_drv.h"
+
+#include "task_terminal.h"
+
+// Get clock configuration
+#include "main.h"
+
+
+
+//**************************************************************************************************
+// Verification of the imported configuration parameters
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//*************************************************************************************************
+
+// None.
+
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Mutex Acquisition Delay
+#define TASK_MASTER_MUTEX_DELAY                 (1000U)
+
+// Number of entries to send to the server
+#define TASK_GSM_QTY_REC_TO_SEND                (10U)
+
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// Buff for record
+static uint8_t TASK_MASTER_aRecord[RECORD_MAN_MAX_SIZE_RECORD];
+
+/* Buffer used for displaying Time */
+static uint8_t aShowTime[50] = {0};
+
+static TIME_type sTime;
+
+static TIME_type AlarmSens;
+static TIME_type AlarmGSM;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+// Stop the CPU until an alarm, the pulse counter keeps counting
+static void TASK_MASTER_EnterStop2(void);
+#endif
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+//**************************************************************************************************
+// @Function      vTaskMaster()
+//--------------------------------------------------------------------------------------------------
+// @Description   None.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+_Noreturn void vTaskMaster(void *pvParameters)
+{
+    TaskStatus_t xTaskStatus;
+
+//    W25Q_EraseBlock(0,W25Q_BLOCK_MEMORY_ALL);
+//while(1);
+
+    // Load alarm sens value
+    if (0U)//(RESULT_OK == TIME_LoadAlarm(&AlarmSens, TIME_ALARM_SENS))
+    {
+        DoNothing();
+    }
+    else
+    {
+//        printf("task_master ERROR: TIME_LoadAlarm RESULT_NOT_OK\r\n");
+        // Set sensors alarm
+        AlarmSens.tm_hour = TIME_ALARM_SENS_HOURS;
+        AlarmSens.tm_min = TIME_ALARM_SENS_MINUTES;
+        AlarmSens.tm_sec = TIME_ALARM_SENS_SECONDS;
+    }
+
+
+
+    // Load alarm gsm value
+    if (0)//(RESULT_OK == TIME_LoadAlarm(&AlarmGSM, TIME_ALARM_GSM))
+    {
+        DoNothing();
+    }
+    else
+    {
+//        printf("task_master ERROR: TIME_LoadAlarm RESULT_NOT_OK\r\n");
+        // Set sensors alarm
+        AlarmGSM.tm_hour = TIME_ALARM_GSM_HOURS;
+        AlarmGSM.tm_min = TIME_ALARM_GSM_MINUTES;
+        AlarmGSM.tm_sec = TIME_ALARM_GSM_SECONDS;
+    }
+
+
+    for(;;)
+    {
+        // Update dump eeprom
+//        RECORD_MAN_UpdateDumpMem();
+//        vTaskResume(TASK_READ_SEN_hHandlerTask);
+//        vTaskDelay(2000/portTICK_RATE_MS);
+
+        vTaskDelay(3000/portTICK_RATE_MS);
+        // Show current time
+        TIME_TimeShow();
+
+#if (ON == W25Q_AUTO_POWER_DOWN_EN)
+        // Power down idle flash
+        W25Q_PowerProcess();
+#endif
+
+        // Check sensors alarm
+        if (TRUE == TIME_CheckAlarm(TIME_ALARM_SENS))
+        {
+            printf("The SENSORS alarm clock rang\r\n");
+
+            // Start measure
+            vTaskResume(TASK_READ_SEN_hHandlerTask);
+
+            vTaskDelay(5000/portTICK_RATE_MS);
+
+            // Set Alarm sens
+            TIME_SetAlarm(AlarmSens, TIME_ALARM_SENS);
+        }
+        else
+        {
+            DoNothing();
+        }
+
+        // Check GSM alarm
+        if (TRUE == TIME_CheckAlarm(TIME_ALARM_GSM))
+        {
+            printf("The GSM alarm clock rang\r\n");
+
+            // Send data to server if the upload policy decides so
+            if (TRUE == TASK_GSM_IsUploadDue())
+            {
+                vTaskResume(TASK_GSM_hHandlerTask);
+            }
+            else
+            {
+                DoNothing();
+            }
+
+            // Set Alarm GSM
+            TIME_SetAlarm(AlarmGSM, TIME_ALARM_GSM);
+        }
+        else
+        {
+            DoNothing();
+        }
+
+
+
+        // Check TASK_GSM state
+        vTaskGetInfo(TASK_GSM_hHandlerTask,&xTaskStatus,pdTRUE,eInvalid );
+
+        if (eSuspended == xTaskStatus.eCurrentState)
+        {
+            // Check TASK_READ_SEN state
+            vTaskGetInfo(TASK_READ_SEN_hHandlerTask,&xTaskStatus,pdTRUE,eInvalid );
+
+            if (eSuspended == xTaskStatus.eCurrentState)
+            {
+                if (TASK_TERMINAL_TIMEOUT <= TASK_TERMINAL_nTimeOut)
+                {
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+                    // STANDBY resets LPTIM1 and the supply of the anemometer, the pulses
+                    // of the sleep would be lost
+                    printf("Go to STOP2 mode\r\n");
+
+                    // Flash keeps deep power-down during STOP2
+                    W25Q_PowerDown();
+
+                    TASK_MASTER_EnterStop2();
+#else
+                    printf("Go to standBy mode\r\n");
+
+                    // Flash keeps deep power-down during standby
+                    W25Q_PowerDown();
+
+                    // Enable pullUp for power control GSM
+                    HAL_PWREx_EnableGPIOPullUp(PWR_GPIO_C, PWR_GPIO_BIT_4);
+                    HAL_PWREx_EnablePullUpPullDownConfig();
+
+                    // Go to StandBy
+                    HAL_PWR_EnterSTANDBYMode();
+#endif
+                }
+                else
+                {
+                    DoNothing();
+                }
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+} // end of vTaskMaster()
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+//**************************************************************************************************
+// @Function      TASK_MASTER_EnterStop2()
+//--------------------------------------------------------------------------------------------------
+// @Description   Stop the CPU until the alarm of the sensors or of GSM.
+//--------------------------------------------------------------------------------------------------
+// @Notes         LPTIM1 and RTC keep counting in STOP2, the GPIO keep the supply of
+//                the anemometer. The alarms wake up the CPU by the event of EXTI, the flags of
+//                the alarms stay set for the loop of the master. The wake up timer of the
+//                anemometer interrupts every gust window, the CPU stops again after it. The ticks of RTOS don't count
+//                during the stop, the anemometer takes the time from RTC.
+//                The CPU is clocked by MSI after the wake up, the clock is restored.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void TASK_MASTER_EnterStop2(void)
+{
+    vTaskSuspendAll();
+
+    // The interrupt of the alarms isn't used, wake up by the event
+    __HAL_RTC_ALARM_EXTI_ENABLE_EVENT();
+
+    // Other interrupts wake up the CPU too, stop again until an alarm
+    do
+    {
+        HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFE);
+    }
+    while ((FALSE == TIME_CheckAlarm(TIME_ALARM_SENS)) && (FALSE == TIME_CheckAlarm(TIME_ALARM_GSM)));
+
+    __HAL_RTC_ALARM_EXTI_CLEAR_FLAG();
+
+    SystemClock_Config();
+
+    (void)xTaskResumeAll();
+} // end of TASK_MASTER_EnterStop2()
+#endif
+
 //****************************************** end of file *******************************************
\ No newline at end of file
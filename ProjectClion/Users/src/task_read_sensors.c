@@ -41,13 +41,14 @@
 // Get record manager interface
 #include "record_manager.h"
 
-// Get LL HAL
-#include "stm32l4xx_ll_i2c.h"
+// Get EMEEP interface
+#include "eeprom_emulation.h"
 
 // drivers
 #include "ds18b20.h"
 #include "am2305_drv.h"
 #include "bmp2.h"
+#include "anemometer_drv.h"
 
 #include "stdlib.h"
 #include "printf.h"
@@ -62,7 +63,34 @@
 // Verification of the imported configuration parameters
 //**************************************************************************************************
 
-// None.
+#if ((TASK_READ_SEN_DS18B20_MAX_QTY < 1U) || (TASK_READ_SEN_DS18B20_MAX_QTY > RECORD_MAN_DS18B20_MAX_QTY_ID))
+#error TASK_READ_SEN configuration: TASK_READ_SEN_DS18B20_MAX_QTY must be [1 ; RECORD_MAN_DS18B20_MAX_QTY_ID].
+#endif
+
+// The fixed point path expects the pressure as Pa x 256, only the 64-bit compensation gives it
+#if defined(BMP2_32BIT_COMPENSATION)
+#error TASK_READ_SEN configuration: use BMP2_64BIT_COMPENSATION for the fixed point pressure.
+#endif
+
+#if ((TASK_READ_SEN_ANEMOMETER_ANALOG != TASK_READ_SEN_ANEMOMETER_TYPE) && \
+     (TASK_READ_SEN_ANEMOMETER_PULSE != TASK_READ_SEN_ANEMOMETER_TYPE))
+#error TASK_READ_SEN configuration: TASK_READ_SEN_ANEMOMETER_TYPE must be ANALOG or PULSE.
+#endif
+
+#if ((TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS < 1U) || (TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS > TASK_READ_SEN_WIND_WINDOW_MS))
+#error TASK_READ_SEN configuration: TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS must be [1 ; TASK_READ_SEN_WIND_WINDOW_MS].
+#endif
+
+#if (TASK_READ_SEN_ANEMOMETER_SETTLE_MS < 1U)
+#error TASK_READ_SEN configuration: TASK_READ_SEN_ANEMOMETER_SETTLE_MS must not be 0.
+#endif
+
+// The conversions are collected within the settling, the cycle is the wind sampling only. The longest one
+// is DS18B20 at 12 bits, 750 ms and the margin of its wait.
+#if ((TASK_READ_SEN_ANEMOMETER_ANALOG == TASK_READ_SEN_ANEMOMETER_TYPE) && \
+     (TASK_READ_SEN_ANEMOMETER_SETTLE_MS < (750U + DS18B20_CONVERSION_MARGIN_MS)))
+#error TASK_READ_SEN configuration: TASK_READ_SEN_ANEMOMETER_SETTLE_MS must cover the DS18B20 conversion.
+#endif
 
 
 
@@ -112,6 +140,50 @@ TaskHandle_t    TASK_READ_SEN_hHandlerTask;
 #define TASK_READ_SEN_ANEMOMETER_WIND_COEFFICIENT       (float)(6.0)
 #define TASK_READ_SEN_ANEMOMETER_CORRECTION_FACTOR      (float)(1.0)
 
+// BMP280 forced measurement time if it can't be computed, ms
+#define TASK_READ_SEN_BMP280_MEAS_TIME_MS               (100U)
+
+#ifdef BMP2_64BIT_COMPENSATION
+// Fractional bits of the fixed point pressure, Pa x 256
+#define TASK_READ_SEN_BMP280_PRESSURE_FRAC_BITS         (8U)
+// Pressure of the record, 110000 Pa x 256 x 100 fits into 32 bits
+#define TASK_READ_SEN_BMP280_PRESSURE_RECORD(nPressure) \
+    (((uint32_t)(nPressure) * RECORD_MAN_PRESSURE_SCALE) >> TASK_READ_SEN_BMP280_PRESSURE_FRAC_BITS)
+// Integer part and hundredths of the fixed point pressure, Pa
+#define TASK_READ_SEN_BMP280_PRESSURE_PA(nPressure)     ((uint32_t)(nPressure) >> TASK_READ_SEN_BMP280_PRESSURE_FRAC_BITS)
+#define TASK_READ_SEN_BMP280_PRESSURE_CENTI_PA(nPressure) \
+    ((((uint32_t)(nPressure) & ((1UL << TASK_READ_SEN_BMP280_PRESSURE_FRAC_BITS) - 1UL)) * 100UL) >> \
+     TASK_READ_SEN_BMP280_PRESSURE_FRAC_BITS)
+#endif
+
+// ADC sequence conversion timeout, ms
+#define TASK_READ_SEN_ADC_TIMEOUT_MS                    (100U)
+
+// Delay of the single ADC sequence from the start, ms
+#define TASK_READ_SEN_ADC_SCAN_DELAY_MS                 (1U)
+
+// Wind speed of one ADC count of the anemometer channel, m/s
+#define TASK_READ_SEN_ANEMOMETER_SPEED_PER_COUNT        (((TASK_READ_SEN_ADC_E_M_R * \
+                                                           TASK_READ_SEN_ANEMOMETER_CORRECTION_FACTOR) * \
+                                                          TASK_READ_SEN_ANEMOMETER_RES_COEFFICIENT) * \
+                                                         TASK_READ_SEN_ANEMOMETER_WIND_COEFFICIENT)
+
+// Quantity of the wind samples in the window
+#define TASK_READ_SEN_WIND_QTY_SAMPLES      (TASK_READ_SEN_WIND_WINDOW_MS / TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS)
+
+// Samples before the end of the settling, the sample k is taken (k + 1) periods after the power on
+#define TASK_READ_SEN_WIND_QTY_SETTLE_SAMPLES \
+    (((TASK_READ_SEN_ANEMOMETER_SETTLE_MS + TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS - 1U) / \
+      TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS) - 1U)
+
+// ADC sequences of the settling and of the window
+#define TASK_READ_SEN_WIND_QTY_SEQUENCES    (TASK_READ_SEN_WIND_QTY_SETTLE_SAMPLES + TASK_READ_SEN_WIND_QTY_SAMPLES)
+
+// Samples of the gust, the same gust window as the pulse anemometer
+#define TASK_READ_SEN_WIND_QTY_GUST_SAMPLES \
+    ((ANEMOMETER_GUST_WINDOW_MS > TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS) ? \
+     (ANEMOMETER_GUST_WINDOW_MS / TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS) : 1U)
+
 
 
 //**************************************************************************************************
@@ -145,11 +217,20 @@ static struct bmp2_dev bmp280;
 
 static uint8_t TASK_READ_SEN_BMP280_DEV_ADR = TASK_READ_SEN_BMP280_ADR;
 
-// Temperature of DS18B20 sensor
-static float TASK_READ_SEN_fDS18B20_temp = 0.0f;
+// Temperature of DS18B20 sensors
+static float TASK_READ_SEN_aDS18B20_temp[TASK_READ_SEN_DS18B20_MAX_QTY];
+
+// ROM table of DS18B20 sensors on the bus
+static uint64_t TASK_READ_SEN_aDS18B20_ID[TASK_READ_SEN_DS18B20_MAX_QTY];
 
-// Id of DS18B20
-static uint64_t TASK_READ_SEN_nDS18B20_ID = 0;//0xd501211280621728U;
+// Quantity of DS18B20 sensors in the ROM table
+static uint32_t TASK_READ_SEN_nDS18B20_Qty = 0U;
+
+// ROM table must be enumerated again
+static BOOLEAN TASK_READ_SEN_bDS18B20_Rescan = FALSE;
+
+// Resolution of DS18B20
+static const uint8_t TASK_READ_SEN_nDS18B20_Resolution = TASK_READ_SEN_DS18B20_RESOLUTION;
 
 // AM2305 humidity
 static float TASK_READ_SEN_AM2305_fHumidity = 0.0f;
@@ -160,9 +241,44 @@ static float TASK_READ_SEN_AM2305_fTemperature = 0.0f;
 // Battery voltage
 static float TASK_READ_SEN_fBatVoltage = 0.0f;
 
-// Battery voltage
+// Mean wind speed of the window
 static float TASK_READ_SEN_fAnemometer = 0.0f;
 
+// Wind gust of the window
+static float TASK_READ_SEN_fWindGust = 0.0f;
+
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+// Results of the ADC sequence
+static uint32_t TASK_READ_SEN_aADC[INIT_ADC_QTY_CH];
+#else
+// Results of the ADC sequences of the settling and of the wind window
+static uint32_t TASK_READ_SEN_aWindADC[TASK_READ_SEN_WIND_QTY_SEQUENCES * INIT_ADC_QTY_CH];
+
+// Wind window is started
+static BOOLEAN TASK_READ_SEN_bWindStarted = FALSE;
+
+// Tick of the anemometer power on
+static TickType_t TASK_READ_SEN_nAnemometerTick = 0U;
+#endif
+
+// Task waiting for the end of the ADC sequence
+static TaskHandle_t TASK_READ_SEN_hADCTask = NULL;
+
+// The ADC sequences are done or failed
+static volatile BOOLEAN TASK_READ_SEN_bADCDone = FALSE;
+
+// Tick of the BMP280 measurement start
+static TickType_t TASK_READ_SEN_nBmp280Tick = 0U;
+
+// BMP280 measurement time, ms
+static uint32_t TASK_READ_SEN_nBmp280TimeMs = TASK_READ_SEN_BMP280_MEAS_TIME_MS;
+
+// DS18B20 conversion is started
+static BOOLEAN TASK_READ_SEN_bDS18B20Started = FALSE;
+
+// Task waiting for the end of the I2C transfer
+static TaskHandle_t TASK_READ_SEN_hI2CTask = NULL;
+
 
 
 //**************************************************************************************************
@@ -175,9 +291,55 @@ static int8_t user_i2c_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, v
 // I2C write
 static int8_t user_i2c_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, void *intf_ptr);
 
+// Wait the end of the I2C transfer
+static int8_t TASK_READ_SEN_I2CWait(void);
+
+// Wake the task waiting for the I2C transfer
+static void TASK_READ_SEN_I2CNotifyFromISR(const I2C_HandleTypeDef *const hi2c);
+
+// Wake the task waiting for the ADC sequence
+static void TASK_READ_SEN_ADCNotifyFromISR(const ADC_HandleTypeDef *const hadc);
+
 // Delay function for BME280 driver
 static void user_delay_us(uint32_t period, void *intf_ptr);
 
+// Start conversions of all sensors
+static void TASK_READ_SEN_StartMeasure(void);
+
+// Collect results of all sensors
+static void TASK_READ_SEN_CollectMeasure(void);
+
+// Wait the rest of the time from the start tick
+static void TASK_READ_SEN_WaitSince(const TickType_t nStartTick, const uint32_t nTimeMs);
+
+// Load ROM table of DS18B20 sensors
+static STD_RESULT TASK_READ_SEN_LoadDS18B20Table(void);
+
+// Enumerate DS18B20 sensors and store ROM table
+static STD_RESULT TASK_READ_SEN_ScanDS18B20Table(void);
+
+// Set resolution of all DS18B20 sensors
+static void TASK_READ_SEN_SetDS18B20Resolution(void);
+
+// Start the ADC sequences paced by the trigger timer
+static STD_RESULT TASK_READ_SEN_StartADC(uint32_t *const pBuffer,
+                                         const uint32_t nQtySequences,
+                                         const uint32_t nPeriodMs);
+
+// Wait for the end of the ADC sequences
+static STD_RESULT TASK_READ_SEN_WaitADC(const TickType_t nStartTick, const uint32_t nTimeMs);
+
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+// Convert the ADC sequence
+static STD_RESULT TASK_READ_SEN_ScanADC(void);
+
+// Measure battery voltage, get wind of the pulse anemometer
+static void TASK_READ_SEN_MeasurePulseWind(void);
+#else
+// Measure battery voltage and wind over the window
+static void TASK_READ_SEN_MeasureAnalog(void);
+#endif
+
 
 
 //**************************************************************************************************
@@ -203,18 +365,17 @@ void vTaskReadSensors(void *pvParameters)
 {
     uint32_t nQtyRecords = 0U;
 
-    STD_RESULT result = RESULT_NOT_OK;
-
-    // Power ON anemometer
-    HAL_GPIO_WritePin(INIT_PWR_ANEMOMETER_PORT, INIT_PWR_ANEMOMETER_PIN, GPIO_PIN_SET);
-
     bmp280.intf_ptr = &TASK_READ_SEN_BMP280_DEV_ADR;
     bmp280.intf = BMP2_I2C_INTF;
     bmp280.read = user_i2c_read;
     bmp280.write = user_i2c_write;
     bmp280.delay_us = user_delay_us;
 
-    taskENTER_CRITICAL();
+    // BMP280 transfers are driven by the I2C interrupts
+    HAL_NVIC_SetPriority(TASK_READ_SEN_I2C_EV_IRQn, TASK_READ_SEN_I2C_IRQ_PRIORITY, 0U);
+    HAL_NVIC_SetPriority(TASK_READ_SEN_I2C_ER_IRQn, TASK_READ_SEN_I2C_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(TASK_READ_SEN_I2C_EV_IRQn);
+    HAL_NVIC_EnableIRQ(TASK_READ_SEN_I2C_ER_IRQn);
 
     if (BMP2_OK == bmp2_init(&bmp280))
     {
@@ -248,108 +409,56 @@ void vTaskReadSensors(void *pvParameters)
     {
         printf("BMP280 wasn't configure\r\n");
     }
-    taskEXIT_CRITICAL();
 
 
-    taskENTER_CRITICAL();
-    if (RESULT_OK == DS18B20_GetID(DS18B20_ONE_WIRE_CH,&TASK_READ_SEN_nDS18B20_ID))
+    // ROM table is enumerated once and then taken from EMEEP
+    if ((RESULT_OK == TASK_READ_SEN_LoadDS18B20Table()) ||
+        (RESULT_OK == TASK_READ_SEN_ScanDS18B20Table()))
     {
-        printf("DS18B20 read ID OK\r\n");
+        TASK_READ_SEN_SetDS18B20Resolution();
     }
     else
     {
-        printf("DS18B20 read ID FAIL\r\n");
+        printf("DS18B20 ROM table FAIL\r\n");
     }
-    taskEXIT_CRITICAL();
 
     HAL_ADCEx_Calibration_Start(&ADC_Handle,ADC_SINGLE_ENDED);
 
-    for(;;)
-    {
-        // Pressure measure
-        taskENTER_CRITICAL();
-        // Start one measure in force mode
-        bmp2_set_power_mode(BMP2_POWERMODE_FORCED, &bmp280Config, &bmp280);
-
-        // Delay 100 ms
-        user_delay_us(100000,0);
-
-        // Get measure data BMP280
-        bmp2_get_sensor_data(&bmp280Data, &bmp280);
-        taskEXIT_CRITICAL();
-
-        ftoa((float)bmp280Data.pressure, bufferPrintf, 1);
-        printf("Pressure = %s\r\n",bufferPrintf);
-
-        // Temperature measure
-        taskENTER_CRITICAL();
-        result = DS18B20_GetTemperature(DS18B20_ONE_WIRE_CH,&TASK_READ_SEN_nDS18B20_ID,&TASK_READ_SEN_fDS18B20_temp);
+    // End of the ADC sequence is signaled by the DMA interrupt
+    HAL_NVIC_SetPriority(INIT_ADC_DMA_IRQn, TASK_READ_SEN_ADC_IRQ_PRIORITY, 0U);
+    HAL_NVIC_EnableIRQ(INIT_ADC_DMA_IRQn);
 
-        if (result == RESULT_NOT_OK)
-        {
-            printf("DS18B20 isn't OK\r\n");
-        }
-        else
-        {
-            ftoa(TASK_READ_SEN_fDS18B20_temp, bufferPrintf, 4);
-            printf("tDS = %s\r\n",bufferPrintf);
-        }
-        taskEXIT_CRITICAL();
-
-        // Humidity measure
-        taskENTER_CRITICAL();
-        result = AM2305_GetHumidityTemperature(&TASK_READ_SEN_AM2305_fHumidity,
-                                               &TASK_READ_SEN_AM2305_fTemperature);
-        taskEXIT_CRITICAL();
-        if (result == RESULT_NOT_OK)
-        {
-            printf("AM2305 isn't OK\r\n");
-        }
-        else
-        {
-            ftoa(TASK_READ_SEN_AM2305_fTemperature, bufferPrintf, 4);
-            printf("tAM = %s\r\n",bufferPrintf);
-            ftoa(TASK_READ_SEN_AM2305_fHumidity, bufferPrintf, 3);
-            printf("humidity = %s\r\n",bufferPrintf);
-        }
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+    // Pulse anemometer counts all the time between the measurements
+    HAL_GPIO_WritePin(INIT_PWR_ANEMOMETER_PORT, INIT_PWR_ANEMOMETER_PIN, GPIO_PIN_SET);
+#endif
 
-        // Battery voltage measure
-        HAL_ADCEx_InjectedStart(&ADC_Handle);
-        user_delay_us(1000000,0);
-        if (HAL_OK == HAL_ADCEx_InjectedPollForConversion(&ADC_Handle, 1000))
-        {
-            uint32_t temp = 0;
-            temp = HAL_ADCEx_InjectedGetValue(&ADC_Handle, INIT_BAT_RANK);
-            TASK_READ_SEN_fBatVoltage = (((float)temp * TASK_READ_SEN_ADC_E_M_R) * TASK_READ_SEN_BAT_CORRECTION_FACTOR) * \
-                                            TASK_READ_SEN_BAT_RES_COEFFICIENT;
-            ftoa(TASK_READ_SEN_fBatVoltage, bufferPrintf, 2);
-            printf("Battery voltage is %s\r\n", bufferPrintf);
-//            printf("Battery CODE voltage is %d\r\n", temp);
-
-            temp = HAL_ADCEx_InjectedGetValue(&ADC_Handle, INIT_ANEMOMETER_RANK);
-            TASK_READ_SEN_fAnemometer = ((((float)temp * TASK_READ_SEN_ADC_E_M_R) * TASK_READ_SEN_ANEMOMETER_CORRECTION_FACTOR) * \
-                                            TASK_READ_SEN_ANEMOMETER_RES_COEFFICIENT) * TASK_READ_SEN_ANEMOMETER_WIND_COEFFICIENT;
-            ftoa(TASK_READ_SEN_fAnemometer, bufferPrintf, 2);
-//            printf("Anemometer voltage is %s\r\n", bufferPrintf);
-            printf("Wind speed m/s %s\r\n", bufferPrintf);
-//            printf("Anemometer CODE voltage is %d\r\n", temp);
-        }
-        else
-        {
-            printf("Battery voltage FAIL measurement\r\n");
-        }
+    for(;;)
+    {
+        // Start all conversions, the sensors convert in parallel
+        TASK_READ_SEN_StartMeasure();
 
+        // Collect results, every result is waited only for the rest of its own time
+        TASK_READ_SEN_CollectMeasure();
 
-        // Save data
-        TASK_READ_SENS_stMeasData.fTemperature = TASK_READ_SEN_fDS18B20_temp;
+        // Save data, the record keeps the first sensor of the ROM table
+        TASK_READ_SENS_stMeasData.fTemperature = TASK_READ_SEN_aDS18B20_temp[0];
         TASK_READ_SENS_stMeasData.fHumidity = TASK_READ_SEN_AM2305_fHumidity;
-        TASK_READ_SENS_stMeasData.fPressure = (float)bmp280Data.pressure;
+#ifdef BMP2_64BIT_COMPENSATION
+        // The record keeps the fixed point Pa, no float math
+        TASK_READ_SENS_stMeasData.nPressure = TASK_READ_SEN_BMP280_PRESSURE_RECORD(bmp280Data.pressure);
+#else
+        TASK_READ_SENS_stMeasData.nPressure = (uint32_t)(bmp280Data.pressure * RECORD_MAN_PRESSURE_SCALE);
+#endif
         TASK_READ_SENS_stMeasData.fWindSpeed = TASK_READ_SEN_fAnemometer;
         TASK_READ_SENS_stMeasData.fBatteryVoltage = TASK_READ_SEN_fBatVoltage;
+        TASK_READ_SENS_stMeasData.fWindGust = TASK_READ_SEN_fWindGust;
         TASK_READ_SENS_stMeasData.nUnixTime = TIME_GetUnixTimestamp();
 
+#if (TASK_READ_SEN_ANEMOMETER_ANALOG == TASK_READ_SEN_ANEMOMETER_TYPE)
         // Power OFF anemometer
         HAL_GPIO_WritePin(INIT_PWR_ANEMOMETER_PORT, INIT_PWR_ANEMOMETER_PIN, GPIO_PIN_RESET);
+#endif
 
         // Attempt get mutex
         if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_READ_SENS_MUTEX_DELAY))
@@ -376,6 +485,23 @@ void vTaskReadSensors(void *pvParameters)
 
 //        vTaskDelay(1000/portTICK_RATE_MS);
 
+        // Sensor was replaced or added
+        if (TRUE == TASK_READ_SEN_bDS18B20_Rescan)
+        {
+            if (RESULT_OK == TASK_READ_SEN_ScanDS18B20Table())
+            {
+                TASK_READ_SEN_SetDS18B20Resolution();
+            }
+            else
+            {
+                printf("DS18B20 ROM table FAIL\r\n");
+            }
+        }
+        else
+        {
+            DoNothing();
+        }
+
         // Blocking vTaskReadSensors
         vTaskSuspend(TASK_READ_SEN_hHandlerTask);
     }
@@ -385,267 +511,943 @@ void vTaskReadSensors(void *pvParameters)
 
 
 //**************************************************************************************************
-//==================================================================================================
-// Definitions of local (private) functions
-//==================================================================================================
+// @Function      TASK_READ_SEN_I2C_EV_IRQHandler()
+//--------------------------------------------------------------------------------------------------
+// @Description   Event interrupt of the BMP280 I2C.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
 //**************************************************************************************************
+void TASK_READ_SEN_I2C_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&I2CBMP280Handler);
+}// end of TASK_READ_SEN_I2C_EV_IRQHandler()
 
 
 
 //**************************************************************************************************
-// @Function      user_i2c_read()
+// @Function      TASK_READ_SEN_I2C_ER_IRQHandler()
 //--------------------------------------------------------------------------------------------------
-// @Description   Read data from I2C
+// @Description   Error interrupt of the BMP280 I2C.
 //--------------------------------------------------------------------------------------------------
 // @Notes         None.
 //--------------------------------------------------------------------------------------------------
-// @ReturnValue   0 - success,
-//                non-zero - fail
+// @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    reg_addr - address register for read
-//                reg_data - pointer data to write
-//                len - length data to read
-//                intf_ptr can be used as a variable to store the I2C address of the device
+// @Parameters    None.
 //**************************************************************************************************
-static int8_t user_i2c_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, void *intf_ptr)
+void TASK_READ_SEN_I2C_ER_IRQHandler(void)
 {
-    int8_t rslt = 0; /* Return 0 for Success, non-zero for failure */
-    uint32_t nCntBytes = 0U;
+    HAL_I2C_ER_IRQHandler(&I2CBMP280Handler);
+}// end of TASK_READ_SEN_I2C_ER_IRQHandler()
 
-    // Wait BUSY flag
-    while (TRUE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance))
-    {
-        DoNothing();
-    }
 
-    /*
-     * The parameter intf_ptr can be used as a variable to store the I2C address of the device
-     */
 
-    /*
-     * Data on the bus should be like
-     * |------------+---------------------|
-     * | I2C action | Data                |
-     * |------------+---------------------|
-     * | Start      | -                   |
-     * | Write      | (reg_addr)          |
-     * | Stop       | -                   |
-     * | Start      | -                   |
-     * | Read       | (reg_data[0])       |
-     * | Read       | (....)              |
-     * | Read       | (reg_data[len - 1]) |
-     * | Stop       | -                   |
-     * |------------+---------------------|
-     */
+//**************************************************************************************************
+// @Function      HAL_I2C_MemRxCpltCallback()
+//--------------------------------------------------------------------------------------------------
+// @Description   End of the I2C reception.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Overrides the weak HAL callback.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hi2c - I2C handler
+//**************************************************************************************************
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    TASK_READ_SEN_I2CNotifyFromISR(hi2c);
+}// end of HAL_I2C_MemRxCpltCallback()
 
-    // Disable auto end mode
-    LL_I2C_DisableAutoEndMode(I2CBMP280Handler.Instance);
 
-    // Disable reload mode
-    LL_I2C_DisableReloadMode(I2CBMP280Handler.Instance);
 
-    // Set slave address
-    LL_I2C_SetSlaveAddr(I2CBMP280Handler.Instance, (*(uint8_t*)intf_ptr) << 1U);
+//**************************************************************************************************
+// @Function      HAL_I2C_MemTxCpltCallback()
+//--------------------------------------------------------------------------------------------------
+// @Description   End of the I2C transmission.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Overrides the weak HAL callback.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hi2c - I2C handler
+//**************************************************************************************************
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    TASK_READ_SEN_I2CNotifyFromISR(hi2c);
+}// end of HAL_I2C_MemTxCpltCallback()
 
-    // Transfer request
-    LL_I2C_SetTransferRequest(I2CBMP280Handler.Instance,LL_I2C_REQUEST_WRITE);
 
-    // Set transfer size
-    LL_I2C_SetTransferSize(I2CBMP280Handler.Instance,1U);
 
-    // Generate start condition
-    LL_I2C_GenerateStartCondition(I2CBMP280Handler.Instance);
+//**************************************************************************************************
+// @Function      HAL_I2C_ErrorCallback()
+//--------------------------------------------------------------------------------------------------
+// @Description   Error of the I2C transfer.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Overrides the weak HAL callback. The waiting task checks the error code.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hi2c - I2C handler
+//**************************************************************************************************
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    TASK_READ_SEN_I2CNotifyFromISR(hi2c);
+}// end of HAL_I2C_ErrorCallback()
 
-    // Wait transmit start bit
-    while (FALSE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance))
-    {
-        DoNothing();
-    }
 
-    while ((FALSE == LL_I2C_IsActiveFlag_TC(I2CBMP280Handler.Instance)) && \
-           (FALSE == LL_I2C_IsActiveFlag_NACK(I2CBMP280Handler.Instance)) && \
-           (TRUE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance)))
-    {
-        // Write register address
-        if (TRUE == LL_I2C_IsActiveFlag_TXIS(I2CBMP280Handler.Instance))
-        {
-            LL_I2C_TransmitData8(I2CBMP280Handler.Instance, reg_addr);
-        }
-        else
-        {
-            DoNothing();
-        }
-    }
 
-    // Disable auto end mode
-    LL_I2C_DisableAutoEndMode(I2CBMP280Handler.Instance);
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_ADC_DMA_IRQHandler()
+//--------------------------------------------------------------------------------------------------
+// @Description   Interrupt of the ADC DMA.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void TASK_READ_SEN_ADC_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&ADC_DmaHandle);
+}// end of TASK_READ_SEN_ADC_DMA_IRQHandler()
 
-    // Disable reload mode
-    LL_I2C_DisableReloadMode(I2CBMP280Handler.Instance);
 
-    // Set slave address
-    LL_I2C_SetSlaveAddr(I2CBMP280Handler.Instance, (*(uint8_t*)intf_ptr) << 1U);
 
-    // Transfer request
-    LL_I2C_SetTransferRequest(I2CBMP280Handler.Instance,LL_I2C_REQUEST_READ);
+//**************************************************************************************************
+// @Function      HAL_ADC_ConvCpltCallback()
+//--------------------------------------------------------------------------------------------------
+// @Description   End of the ADC sequence.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Overrides the weak HAL callback.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hadc - ADC handler
+//**************************************************************************************************
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    TASK_READ_SEN_ADCNotifyFromISR(hadc);
+}// end of HAL_ADC_ConvCpltCallback()
 
-    // Set transfer size
-    LL_I2C_SetTransferSize(I2CBMP280Handler.Instance,len);
 
-    // Generate start condition
-    LL_I2C_GenerateStartCondition(I2CBMP280Handler.Instance);
 
-    while ((FALSE == LL_I2C_IsActiveFlag_TC(I2CBMP280Handler.Instance)) && \
-           (FALSE == LL_I2C_IsActiveFlag_NACK(I2CBMP280Handler.Instance)) && \
-           (TRUE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance)))
-    {
-        if (TRUE == LL_I2C_IsActiveFlag_RXNE(I2CBMP280Handler.Instance))
-        {
-            reg_data[nCntBytes] = LL_I2C_ReceiveData8(I2CBMP280Handler.Instance);
-            nCntBytes++;
-        }
-        else
-        {
-            DoNothing();
-        }
-    }
+//**************************************************************************************************
+// @Function      HAL_ADC_ErrorCallback()
+//--------------------------------------------------------------------------------------------------
+// @Description   Error of the ADC sequence.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Overrides the weak HAL callback. The waiting task checks the error code.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hadc - ADC handler
+//**************************************************************************************************
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+    TASK_READ_SEN_ADCNotifyFromISR(hadc);
+}// end of HAL_ADC_ErrorCallback()
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_StartMeasure()
+//--------------------------------------------------------------------------------------------------
+// @Description   Start conversions of all sensors.
+//--------------------------------------------------------------------------------------------------
+// @Notes         BMP280 forced measurement, DS18B20 conversion and anemometer settling
+//                and window run in parallel. The window is the longest, the cycle ends at its
+//                last sample, TASK_READ_SEN_WIND_QTY_SEQUENCES periods after the power on. The
+//                other results are collected within the settling and add nothing to it.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void TASK_READ_SEN_StartMeasure(void)
+{
+    uint32_t nMeasTimeUs = 0U;
+
+#if (TASK_READ_SEN_ANEMOMETER_ANALOG == TASK_READ_SEN_ANEMOMETER_TYPE)
+    // Power ON anemometer, it settles while the other sensors convert
+    HAL_GPIO_WritePin(INIT_PWR_ANEMOMETER_PORT, INIT_PWR_ANEMOMETER_PIN, GPIO_PIN_SET);
+    TASK_READ_SEN_nAnemometerTick = xTaskGetTickCount();
+
+    // The trigger timer samples the settling and the window, DMA keeps all sequences
+    TASK_READ_SEN_bWindStarted = (RESULT_OK == TASK_READ_SEN_StartADC(TASK_READ_SEN_aWindADC,
+                                                                      TASK_READ_SEN_WIND_QTY_SEQUENCES,
+                                                                      TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS)) ? TRUE : FALSE;
+#endif
 
-    // Generate stop
-    LL_I2C_GenerateStopCondition(I2CBMP280Handler.Instance);
+    // Start one measure BMP280 in force mode
+    bmp2_set_power_mode(BMP2_POWERMODE_FORCED, &bmp280Config, &bmp280);
+    TASK_READ_SEN_nBmp280Tick = xTaskGetTickCount();
 
-    if (len == nCntBytes)
+    if (BMP2_OK == bmp2_compute_meas_time(&nMeasTimeUs, &bmp280Config, &bmp280))
     {
-        rslt = 0U;
+        TASK_READ_SEN_nBmp280TimeMs = (nMeasTimeUs + 999U) / 1000U;
     }
     else
     {
-        rslt = 1U;
+        TASK_READ_SEN_nBmp280TimeMs = TASK_READ_SEN_BMP280_MEAS_TIME_MS;
     }
 
-    return rslt;
-}// end of user_i2c_read()
+    // Start conversion of all DS18B20 by one broadcast, the bus is free while they convert
+    DS18B20_EnterCritical();
+    TASK_READ_SEN_bDS18B20Started = (RESULT_OK == DS18B20_StartConversionAll(DS18B20_ONE_WIRE_CH)) ? TRUE : FALSE;
+    DS18B20_ExitCritical();
+}// end of TASK_READ_SEN_StartMeasure()
 
 
 
 //**************************************************************************************************
-// @Function      user_i2c_write()
+// @Function      TASK_READ_SEN_CollectMeasure()
 //--------------------------------------------------------------------------------------------------
-// @Description   Write data to I2C
+// @Description   Collect results of all sensors started by TASK_READ_SEN_StartMeasure().
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         Results are collected in order of readiness, the task sleeps between them.
 //--------------------------------------------------------------------------------------------------
-// @ReturnValue   0 - success,
-//                non-zero - fail
+// @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    reg_addr - address register to write
-//                reg_data - pointer data to write
-//                len - length data to write
-//                intf_ptr can be used as a variable to store the I2C address of the device
+// @Parameters    None.
 //**************************************************************************************************
-static int8_t user_i2c_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, void *intf_ptr)
+static void TASK_READ_SEN_CollectMeasure(void)
 {
-    int8_t rslt = 0; /* Return 0 for Success, non-zero for failure */
+    STD_RESULT result = RESULT_NOT_OK;
+    uint32_t nSensor = 0U;
+
+    // Pressure measure
+    TASK_READ_SEN_WaitSince(TASK_READ_SEN_nBmp280Tick, TASK_READ_SEN_nBmp280TimeMs);
+
+    // Get measure data BMP280
+    bmp2_get_sensor_data(&bmp280Data, &bmp280);
+
+#ifdef BMP2_64BIT_COMPENSATION
+    // Pressure Pa x 256, temperature centi-degC
+    printf("Pressure = %lu.%02lu\r\n",
+           (unsigned long)TASK_READ_SEN_BMP280_PRESSURE_PA(bmp280Data.pressure),
+           (unsigned long)TASK_READ_SEN_BMP280_PRESSURE_CENTI_PA(bmp280Data.pressure));
+    printf("Temperature BMP280 = %s%ld.%02ld\r\n",
+           (bmp280Data.temperature < 0) ? "-" : "",
+           (long)(labs((long)bmp280Data.temperature) / 100L),
+           (long)(labs((long)bmp280Data.temperature) % 100L));
+#else
+    ftoa((float)bmp280Data.pressure, bufferPrintf, 1);
+    printf("Pressure = %s\r\n",bufferPrintf);
+    ftoa((float)bmp280Data.temperature, bufferPrintf, 2);
+    printf("Temperature BMP280 = %s\r\n",bufferPrintf);
+#endif
+
+    // Humidity measure, AM2305 has own bus and is read while DS18B20 converts
+    AM2305_EnterCritical();
+    result = AM2305_GetHumidityTemperature(&TASK_READ_SEN_AM2305_fHumidity,
+                                           &TASK_READ_SEN_AM2305_fTemperature);
+    AM2305_ExitCritical();
+    if (result == RESULT_NOT_OK)
+    {
+        printf("AM2305 isn't OK\r\n");
+    }
+    else
+    {
+        ftoa(TASK_READ_SEN_AM2305_fTemperature, bufferPrintf, 4);
+        printf("tAM = %s\r\n",bufferPrintf);
+        ftoa(TASK_READ_SEN_AM2305_fHumidity, bufferPrintf, 3);
+        printf("humidity = %s\r\n",bufferPrintf);
+    }
 
-    uint32_t nCntBytes = 0U;
+    // Temperature measure, one conversion time for all sensors and a short read of each
+    if ((TRUE == TASK_READ_SEN_bDS18B20Started) &&
+        (RESULT_OK == DS18B20_WaitConversion(DS18B20_ONE_WIRE_CH, TASK_READ_SEN_nDS18B20_Resolution)))
+    {
+        for (nSensor = 0U; nSensor < TASK_READ_SEN_nDS18B20_Qty; nSensor++)
+        {
+            DS18B20_EnterCritical();
+            result = DS18B20_ReadResult(DS18B20_ONE_WIRE_CH,
+                                        &TASK_READ_SEN_aDS18B20_ID[nSensor],
+                                        &TASK_READ_SEN_aDS18B20_temp[nSensor]);
+            DS18B20_ExitCritical();
 
-    // Wait BUSY flag
-    while (TRUE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance))
+            if (result == RESULT_NOT_OK)
+            {
+                printf("DS18B20 #%d isn't OK\r\n", nSensor);
+                TASK_READ_SEN_bDS18B20_Rescan = TRUE;
+            }
+            else
+            {
+                ftoa(TASK_READ_SEN_aDS18B20_temp[nSensor], bufferPrintf, 4);
+                printf("tDS #%d = %s\r\n", nSensor, bufferPrintf);
+            }
+        }
+    }
+    else
     {
-        DoNothing();
+        printf("DS18B20 isn't OK\r\n");
     }
 
-    /*
-     * The parameter intf_ptr can be used as a variable to store the I2C address of the device
-     */
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+    // Battery voltage measure, wind is counted over the whole interval since the last measure
+    TASK_READ_SEN_MeasurePulseWind();
+#else
+    // Battery voltage and wind measure, the window is sampled since the power on
+    TASK_READ_SEN_MeasureAnalog();
+#endif
+}// end of TASK_READ_SEN_CollectMeasure()
 
-    /*
-     * Data on the bus should be like
-     * |------------+---------------------|
-     * | I2C action | Data                |
-     * |------------+---------------------|
-     * | Start      | -                   |
-     * | Write      | (reg_addr)          |
-     * | Write      | (reg_data[0])       |
-     * | Write      | (....)              |
-     * | Write      | (reg_data[len - 1]) |
-     * | Stop       | -                   |
-     * |------------+---------------------|
-     */
 
-// Disable auto end mode
-    LL_I2C_DisableAutoEndMode(I2CBMP280Handler.Instance);
 
-    // Disable reload mode
-    LL_I2C_DisableReloadMode(I2CBMP280Handler.Instance);
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_MeasurePulseWind()
+//--------------------------------------------------------------------------------------------------
+// @Description   Measure battery voltage, get mean wind speed and gust of the pulse anemometer.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The mean and the gust cover the whole interval since the last measure.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void TASK_READ_SEN_MeasurePulseWind(void)
+{
+    if (RESULT_OK == TASK_READ_SEN_ScanADC())
+    {
+        TASK_READ_SEN_fBatVoltage = (((float)TASK_READ_SEN_aADC[INIT_BAT_INDEX] * TASK_READ_SEN_ADC_E_M_R) * \
+                                        TASK_READ_SEN_BAT_CORRECTION_FACTOR) * TASK_READ_SEN_BAT_RES_COEFFICIENT;
+        ftoa(TASK_READ_SEN_fBatVoltage, bufferPrintf, 2);
+        printf("Battery voltage is %s\r\n", bufferPrintf);
+    }
+    else
+    {
+        printf("Battery voltage FAIL measurement\r\n");
+    }
+
+    if (RESULT_OK == ANEMOMETER_GetWind(&TASK_READ_SEN_fAnemometer, &TASK_READ_SEN_fWindGust))
+    {
+        ftoa(TASK_READ_SEN_fAnemometer, bufferPrintf, 2);
+        printf("Wind speed m/s %s\r\n", bufferPrintf);
+        ftoa(TASK_READ_SEN_fWindGust, bufferPrintf, 2);
+        printf("Wind gust m/s %s\r\n", bufferPrintf);
+    }
+    else
+    {
+        printf("Wind FAIL measurement\r\n");
+    }
+}// end of TASK_READ_SEN_MeasurePulseWind()
+
+#else
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_MeasureAnalog()
+//--------------------------------------------------------------------------------------------------
+// @Description   Measure battery voltage, mean wind speed and wind gust over the window.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The sequences are started by TASK_READ_SEN_StartMeasure() and paced by the
+//                trigger timer, the task sleeps until the last one. The samples of the settling
+//                are dropped. Every sample is averaged by the oversampler.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void TASK_READ_SEN_MeasureAnalog(void)
+{
+    if ((TRUE == TASK_READ_SEN_bWindStarted) &&
+        (RESULT_OK == TASK_READ_SEN_WaitADC(TASK_READ_SEN_nAnemometerTick,
+                                            (TASK_READ_SEN_WIND_QTY_SEQUENCES * TASK_READ_SEN_WIND_SAMPLE_PERIOD_MS) +
+                                            TASK_READ_SEN_ADC_TIMEOUT_MS)) &&
+        (RESULT_OK == ANEMOMETER_GetWindOfSamples(&TASK_READ_SEN_aWindADC[(TASK_READ_SEN_WIND_QTY_SETTLE_SAMPLES *
+                                                                           INIT_ADC_QTY_CH) + INIT_ANEMOMETER_INDEX],
+                                                  INIT_ADC_QTY_CH,
+                                                  TASK_READ_SEN_WIND_QTY_SAMPLES,
+                                                  TASK_READ_SEN_WIND_QTY_GUST_SAMPLES,
+                                                  TASK_READ_SEN_ANEMOMETER_SPEED_PER_COUNT,
+                                                  &TASK_READ_SEN_fAnemometer,
+                                                  &TASK_READ_SEN_fWindGust)))
+    {
+        // Battery voltage of the last sequence, the anemometer load is on
+        TASK_READ_SEN_fBatVoltage = (((float)TASK_READ_SEN_aWindADC[((TASK_READ_SEN_WIND_QTY_SEQUENCES - 1U) *
+                                                                     INIT_ADC_QTY_CH) + INIT_BAT_INDEX] * \
+                                      TASK_READ_SEN_ADC_E_M_R) * \
+                                        TASK_READ_SEN_BAT_CORRECTION_FACTOR) * TASK_READ_SEN_BAT_RES_COEFFICIENT;
+        ftoa(TASK_READ_SEN_fBatVoltage, bufferPrintf, 2);
+        printf("Battery voltage is %s\r\n", bufferPrintf);
+
+        ftoa(TASK_READ_SEN_fAnemometer, bufferPrintf, 2);
+        printf("Wind speed m/s %s\r\n", bufferPrintf);
+        ftoa(TASK_READ_SEN_fWindGust, bufferPrintf, 2);
+        printf("Wind gust m/s %s\r\n", bufferPrintf);
+    }
+    else
+    {
+        printf("Battery voltage FAIL measurement\r\n");
+    }
+}// end of TASK_READ_SEN_MeasureAnalog()
+#endif
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_StartADC()
+//--------------------------------------------------------------------------------------------------
+// @Description   Start the ADC sequences paced by the trigger timer.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The first sequence is converted one period after the start. DMA stores
+//                the results of all sequences, its interrupt ends them.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - the sequences are started
+//                RESULT_NOT_OK - error
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pBuffer - results, INIT_ADC_QTY_CH words for every sequence
+//                nQtySequences - quantity of the sequences
+//                nPeriodMs - period of the sequences, ms
+//**************************************************************************************************
+static STD_RESULT TASK_READ_SEN_StartADC(uint32_t *const pBuffer,
+                                         const uint32_t nQtySequences,
+                                         const uint32_t nPeriodMs)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+
+    TASK_READ_SEN_bADCDone = FALSE;
+
+    __HAL_TIM_SET_AUTORELOAD(&ADC_TriggerTimHandle, (nPeriodMs * INIT_ADC_TRIGGER_TICKS_PER_MS) - 1U);
+    __HAL_TIM_SET_COUNTER(&ADC_TriggerTimHandle, 0U);
+
+    if ((HAL_OK == HAL_ADC_Start_DMA(&ADC_Handle, pBuffer, nQtySequences * INIT_ADC_QTY_CH)) &&
+        (HAL_OK == HAL_TIM_Base_Start(&ADC_TriggerTimHandle)))
+    {
+        result = RESULT_OK;
+    }
+    else
+    {
+        (void)HAL_ADC_Stop_DMA(&ADC_Handle);
+    }
+
+    return result;
+}// end of TASK_READ_SEN_StartADC()
+
 
-    // Set slave address
-    LL_I2C_SetSlaveAddr(I2CBMP280Handler.Instance, (*(uint8_t*)intf_ptr) << 1U);
 
-    // Transfer request
-    LL_I2C_SetTransferRequest(I2CBMP280Handler.Instance,LL_I2C_REQUEST_WRITE);
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_WaitADC()
+//--------------------------------------------------------------------------------------------------
+// @Description   Wait for the end of the ADC sequences started by TASK_READ_SEN_StartADC().
+//--------------------------------------------------------------------------------------------------
+// @Notes         The interrupt notifies the task only while it waits here, so the sequences
+//                don't wake the other waits of the task. The timer and the ADC are stopped.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - the sequences are converted
+//                RESULT_NOT_OK - error or timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nStartTick - tick of the start
+//                nTimeMs - timeout since the start, ms
+//**************************************************************************************************
+static STD_RESULT TASK_READ_SEN_WaitADC(const TickType_t nStartTick, const uint32_t nTimeMs)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    const TickType_t nTimeTicks = (TickType_t)(nTimeMs / portTICK_RATE_MS) + 1U;
+    TickType_t nElapsed = 0U;
+    BOOLEAN bWait = FALSE;
 
-    // Set transfer size
-    LL_I2C_SetTransferSize(I2CBMP280Handler.Instance,len + 1U);
+    // Drop a notification of the previous wait
+    (void)ulTaskNotifyTake(pdTRUE, 0U);
 
-    // Generate start condition
-    LL_I2C_GenerateStartCondition(I2CBMP280Handler.Instance);
+    taskENTER_CRITICAL();
+    bWait = (FALSE == TASK_READ_SEN_bADCDone) ? TRUE : FALSE;
+    TASK_READ_SEN_hADCTask = (TRUE == bWait) ? xTaskGetCurrentTaskHandle() : NULL;
+    taskEXIT_CRITICAL();
 
-    // Wait transmit start bit
-    while (FALSE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance))
+    nElapsed = xTaskGetTickCount() - nStartTick;
+    if ((TRUE == bWait) && (nElapsed < nTimeTicks))
+    {
+        (void)ulTaskNotifyTake(pdTRUE, nTimeTicks - nElapsed);
+    }
+    else
     {
         DoNothing();
     }
 
-    while ((FALSE == LL_I2C_IsActiveFlag_TXIS(I2CBMP280Handler.Instance)) && \
-           (FALSE == LL_I2C_IsActiveFlag_NACK(I2CBMP280Handler.Instance)) && \
-           (TRUE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance)))
+    TASK_READ_SEN_hADCTask = NULL;
+
+    (void)HAL_TIM_Base_Stop(&ADC_TriggerTimHandle);
+
+    if ((TRUE == TASK_READ_SEN_bADCDone) &&
+        (HAL_ADC_ERROR_NONE == HAL_ADC_GetError(&ADC_Handle)))
+    {
+        result = RESULT_OK;
+    }
+    else
     {
         DoNothing();
     }
+    (void)HAL_ADC_Stop_DMA(&ADC_Handle);
 
-    // Write register address
-    if (TRUE == LL_I2C_IsActiveFlag_TXIS(I2CBMP280Handler.Instance))
+    return result;
+}// end of TASK_READ_SEN_WaitADC()
+
+
+
+#if (TASK_READ_SEN_ANEMOMETER_PULSE == TASK_READ_SEN_ANEMOMETER_TYPE)
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_ScanADC()
+//--------------------------------------------------------------------------------------------------
+// @Description   Convert the ADC regular sequence.
+//--------------------------------------------------------------------------------------------------
+// @Notes         DMA stores the results in TASK_READ_SEN_aADC, the task sleeps until
+//                the end of the sequence.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - the sequence is converted
+//                RESULT_NOT_OK - error or timeout
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT TASK_READ_SEN_ScanADC(void)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    const TickType_t nStartTick = xTaskGetTickCount();
+
+    if (RESULT_OK == TASK_READ_SEN_StartADC(TASK_READ_SEN_aADC, 1U, TASK_READ_SEN_ADC_SCAN_DELAY_MS))
     {
-        LL_I2C_TransmitData8(I2CBMP280Handler.Instance, reg_addr);
+        result = TASK_READ_SEN_WaitADC(nStartTick, TASK_READ_SEN_ADC_SCAN_DELAY_MS + TASK_READ_SEN_ADC_TIMEOUT_MS);
     }
     else
     {
+        DoNothing();
+    }
+
+    return result;
+}// end of TASK_READ_SEN_ScanADC()
+#endif
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_WaitSince()
+//--------------------------------------------------------------------------------------------------
+// @Description   Sleep the rest of the time counted from the start tick.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Doesn't sleep if the time has already passed.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nStartTick - tick of the start.
+//                nTimeMs - time to wait from the start, ms.
+//**************************************************************************************************
+static void TASK_READ_SEN_WaitSince(const TickType_t nStartTick, const uint32_t nTimeMs)
+{
+    // One more tick covers the part of the tick before the start
+    const TickType_t nTimeTicks = (TickType_t)(nTimeMs / portTICK_RATE_MS) + 1U;
+    const TickType_t nElapsed = xTaskGetTickCount() - nStartTick;
 
+    if (nElapsed < nTimeTicks)
+    {
+        vTaskDelay(nTimeTicks - nElapsed);
+    }
+    else
+    {
         DoNothing();
     }
+}// end of TASK_READ_SEN_WaitSince()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_LoadDS18B20Table()
+//--------------------------------------------------------------------------------------------------
+// @Description   Load ROM table of DS18B20 sensors from EMEEP.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - table was loaded and isn't empty
+//                RESULT_NOT_OK - table wasn't loaded
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT TASK_READ_SEN_LoadDS18B20Table(void)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint32_t nQty = 0U;
+
+    if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_READ_SENS_MUTEX_DELAY))
+    {
+        if ((RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR_DS18B20_QTY,
+                                     (U8*)&nQty,
+                                     RECORD_MAN_SIZE_VIR_ADR)) &&
+            (0U < nQty) &&
+            (TASK_READ_SEN_DS18B20_MAX_QTY >= nQty) &&
+            (RESULT_OK == EMEEP_Load(RECORD_MAN_VIR_ADR_DS18B20_ID,
+                                     (U8*)TASK_READ_SEN_aDS18B20_ID,
+                                     nQty * RECORD_MAN_SIZE_DS18B20_ID)))
+        {
+            TASK_READ_SEN_nDS18B20_Qty = nQty;
+            printf("DS18B20 ROM table loaded, %d sensors\r\n", nQty);
+            result = RESULT_OK;
+        }
+        else
+        {
+            result = RESULT_NOT_OK;
+        }
+
+        // Return mutex
+        xSemaphoreGive(RECORD_MAN_xMutex);
+    }
+    else
+    {
+        printf("TASK_READ_SENS: Mutex of record manager is busy\r\n");
+    }
+
+    return result;
+}// end of TASK_READ_SEN_LoadDS18B20Table()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_ScanDS18B20Table()
+//--------------------------------------------------------------------------------------------------
+// @Description   Enumerate DS18B20 sensors by Search ROM and store ROM table to EMEEP.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The table is stored only if it was changed.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - at least one sensor was found
+//                RESULT_NOT_OK - no sensors on the bus
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT TASK_READ_SEN_ScanDS18B20Table(void)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint64_t aID[TASK_READ_SEN_DS18B20_MAX_QTY];
+    uint8_t nFound = 0U;
+    uint32_t nQty = 0U;
 
-    while ((FALSE == LL_I2C_IsActiveFlag_TC(I2CBMP280Handler.Instance)) && \
-           (FALSE == LL_I2C_IsActiveFlag_NACK(I2CBMP280Handler.Instance)) && \
-           (TRUE == LL_I2C_IsActiveFlag_BUSY(I2CBMP280Handler.Instance)))
+    TASK_READ_SEN_bDS18B20_Rescan = FALSE;
+
+    if (RESULT_OK == DS18B20_SearchROM(DS18B20_ONE_WIRE_CH, aID, TASK_READ_SEN_DS18B20_MAX_QTY, &nFound))
     {
-        if (TRUE == LL_I2C_IsActiveFlag_TXIS(I2CBMP280Handler.Instance))
+        nQty = nFound;
+        printf("DS18B20 search ROM OK, %d sensors\r\n", nQty);
+        result = RESULT_OK;
+
+        if ((nQty != TASK_READ_SEN_nDS18B20_Qty) ||
+            (0 != memcmp(aID, TASK_READ_SEN_aDS18B20_ID, nQty * RECORD_MAN_SIZE_DS18B20_ID)))
         {
-            LL_I2C_TransmitData8(I2CBMP280Handler.Instance,reg_data[nCntBytes]);
-            nCntBytes++;
+            memcpy(TASK_READ_SEN_aDS18B20_ID, aID, nQty * RECORD_MAN_SIZE_DS18B20_ID);
+            TASK_READ_SEN_nDS18B20_Qty = nQty;
+
+            if (pdTRUE == xSemaphoreTake(RECORD_MAN_xMutex, TASK_READ_SENS_MUTEX_DELAY))
+            {
+                if ((RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR_DS18B20_ID,
+                                              (U8*)TASK_READ_SEN_aDS18B20_ID,
+                                              nQty * RECORD_MAN_SIZE_DS18B20_ID)) &&
+                    (RESULT_OK == EMEEP_Store(RECORD_MAN_VIR_ADR_DS18B20_QTY,
+                                              (U8*)&nQty,
+                                              RECORD_MAN_SIZE_VIR_ADR)))
+                {
+                    printf("DS18B20 ROM table stored\r\n");
+                }
+                else
+                {
+                    printf("DS18B20 ROM table store ERROR\r\n");
+                }
+
+                // Return mutex
+                xSemaphoreGive(RECORD_MAN_xMutex);
+            }
+            else
+            {
+                printf("TASK_READ_SENS: Mutex of record manager is busy\r\n");
+            }
         }
         else
         {
             DoNothing();
         }
     }
+    else
+    {
+        printf("DS18B20 search ROM FAIL\r\n");
+    }
+
+    return result;
+}// end of TASK_READ_SEN_ScanDS18B20Table()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_SetDS18B20Resolution()
+//--------------------------------------------------------------------------------------------------
+// @Description   Set resolution of all DS18B20 sensors of the ROM table.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void TASK_READ_SEN_SetDS18B20Resolution(void)
+{
+    uint32_t nSensor = 0U;
+    STD_RESULT result = RESULT_NOT_OK;
+
+    for (nSensor = 0U; nSensor < TASK_READ_SEN_nDS18B20_Qty; nSensor++)
+    {
+        DS18B20_EnterCritical();
+        result = DS18B20_SetResolution(DS18B20_ONE_WIRE_CH,
+                                       &TASK_READ_SEN_aDS18B20_ID[nSensor],
+                                       &TASK_READ_SEN_nDS18B20_Resolution);
+        DS18B20_ExitCritical();
+
+        if (RESULT_OK == result)
+        {
+            printf("DS18B20 #%d resolution set OK\r\n", nSensor);
+        }
+        else
+        {
+            printf("DS18B20 #%d resolution set FAIL\r\n", nSensor);
+        }
+    }
+}// end of TASK_READ_SEN_SetDS18B20Resolution()
+
+
+
+//**************************************************************************************************
+// @Function      user_i2c_read()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read data from I2C
+//--------------------------------------------------------------------------------------------------
+// @Notes         The register address is written, then the burst is read after the repeated
+//                start. The task sleeps until the end of the transfer.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   0 - success,
+//                non-zero - fail
+//--------------------------------------------------------------------------------------------------
+// @Parameters    reg_addr - address register for read
+//                reg_data - pointer data to write
+//                len - length data to read
+//                intf_ptr can be used as a variable to store the I2C address of the device
+//**************************************************************************************************
+static int8_t user_i2c_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, void *intf_ptr)
+{
+    int8_t rslt = 1; /* Return 0 for Success, non-zero for failure */
+
+    /*
+     * Data on the bus should be like
+     * |------------+---------------------|
+     * | I2C action | Data                |
+     * |------------+---------------------|
+     * | Start      | -                   |
+     * | Write      | (reg_addr)          |
+     * | Restart    | -                   |
+     * | Read       | (reg_data[0])       |
+     * | Read       | (....)              |
+     * | Read       | (reg_data[len - 1]) |
+     * | Stop       | -                   |
+     * |------------+---------------------|
+     */
+
+    TASK_READ_SEN_hI2CTask = xTaskGetCurrentTaskHandle();
+    // Drop a notification of the previous transfer
+    (void)ulTaskNotifyTake(pdTRUE, 0U);
+
+    if (HAL_OK == HAL_I2C_Mem_Read_IT(&I2CBMP280Handler,
+                                      (uint16_t)((*(uint8_t*)intf_ptr) << 1U),
+                                      reg_addr,
+                                      I2C_MEMADD_SIZE_8BIT,
+                                      reg_data,
+                                      (uint16_t)len))
+    {
+        rslt = TASK_READ_SEN_I2CWait();
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    TASK_READ_SEN_hI2CTask = NULL;
+
+    return rslt;
+}// end of user_i2c_read()
+
+
+
+//**************************************************************************************************
+// @Function      user_i2c_write()
+//--------------------------------------------------------------------------------------------------
+// @Description   Write data to I2C
+//--------------------------------------------------------------------------------------------------
+// @Notes         The task sleeps until the end of the transfer.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   0 - success,
+//                non-zero - fail
+//--------------------------------------------------------------------------------------------------
+// @Parameters    reg_addr - address register to write
+//                reg_data - pointer data to write
+//                len - length data to write
+//                intf_ptr can be used as a variable to store the I2C address of the device
+//**************************************************************************************************
+static int8_t user_i2c_write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, void *intf_ptr)
+{
+    int8_t rslt = 1; /* Return 0 for Success, non-zero for failure */
 
-    // Generate stop
-    LL_I2C_GenerateStopCondition(I2CBMP280Handler.Instance);
+    /*
+     * Data on the bus should be like
+     * |------------+---------------------|
+     * | I2C action | Data                |
+     * |------------+---------------------|
+     * | Start      | -                   |
+     * | Write      | (reg_addr)          |
+     * | Write      | (reg_data[0])       |
+     * | Write      | (....)              |
+     * | Write      | (reg_data[len - 1]) |
+     * | Stop       | -                   |
+     * |------------+---------------------|
+     */
 
-    if (len == nCntBytes)
+    TASK_READ_SEN_hI2CTask = xTaskGetCurrentTaskHandle();
+    // Drop a notification of the previous transfer
+    (void)ulTaskNotifyTake(pdTRUE, 0U);
+
+    // HAL only reads the buffer of the transmission
+    if (HAL_OK == HAL_I2C_Mem_Write_IT(&I2CBMP280Handler,
+                                       (uint16_t)((*(uint8_t*)intf_ptr) << 1U),
+                                       reg_addr,
+                                       I2C_MEMADD_SIZE_8BIT,
+                                       (uint8_t*)reg_data,
+                                       (uint16_t)len))
     {
-        rslt = 0U;
+        rslt = TASK_READ_SEN_I2CWait();
     }
     else
     {
-        rslt = 1U;
+        DoNothing();
     }
 
+    TASK_READ_SEN_hI2CTask = NULL;
+
     return rslt;
 }// end of user_i2c_write()
 
 
 
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_I2CWait()
+//--------------------------------------------------------------------------------------------------
+// @Description   Wait the end of the I2C transfer of the BMP280.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The interface is initialized again if the transfer hangs, so the next transfer
+//                starts on the free bus.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   0 - success,
+//                non-zero - fail
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static int8_t TASK_READ_SEN_I2CWait(void)
+{
+    int8_t rslt = 1;
+
+    if (0U == ulTaskNotifyTake(pdTRUE, TASK_READ_SEN_I2C_TIMEOUT_MS / portTICK_RATE_MS))
+    {
+        // Timeout, abort the transfer
+        HAL_NVIC_DisableIRQ(TASK_READ_SEN_I2C_EV_IRQn);
+        HAL_NVIC_DisableIRQ(TASK_READ_SEN_I2C_ER_IRQn);
+        (void)HAL_I2C_DeInit(&I2CBMP280Handler);
+        (void)HAL_I2C_Init(&I2CBMP280Handler);
+        HAL_NVIC_EnableIRQ(TASK_READ_SEN_I2C_EV_IRQn);
+        HAL_NVIC_EnableIRQ(TASK_READ_SEN_I2C_ER_IRQn);
+        printf("BMP280 I2C timeout\r\n");
+    }
+    else if (HAL_I2C_ERROR_NONE == HAL_I2C_GetError(&I2CBMP280Handler))
+    {
+        rslt = 0;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return rslt;
+}// end of TASK_READ_SEN_I2CWait()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_I2CNotifyFromISR()
+//--------------------------------------------------------------------------------------------------
+// @Description   Wake the task waiting for the I2C transfer of the BMP280.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called by HAL callbacks of the end and error of the transfer.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hi2c - I2C handler of the callback
+//**************************************************************************************************
+static void TASK_READ_SEN_I2CNotifyFromISR(const I2C_HandleTypeDef *const hi2c)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if ((&I2CBMP280Handler == hi2c) && (NULL != TASK_READ_SEN_hI2CTask))
+    {
+        vTaskNotifyGiveFromISR(TASK_READ_SEN_hI2CTask, &xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}// end of TASK_READ_SEN_I2CNotifyFromISR()
+
+
+
+//**************************************************************************************************
+// @Function      TASK_READ_SEN_ADCNotifyFromISR()
+//--------------------------------------------------------------------------------------------------
+// @Description   Wake the task waiting for the ADC sequence.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called by HAL callbacks of the end and error of the sequence.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    hadc - ADC handler of the callback
+//**************************************************************************************************
+static void TASK_READ_SEN_ADCNotifyFromISR(const ADC_HandleTypeDef *const hadc)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (&ADC_Handle == hadc)
+    {
+        TASK_READ_SEN_bADCDone = TRUE;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    if ((&ADC_Handle == hadc) && (NULL != TASK_READ_SEN_hADCTask))
+    {
+        vTaskNotifyGiveFromISR(TASK_READ_SEN_hADCTask, &xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}// end of TASK_READ_SEN_ADCNotifyFromISR()
+
+
+
 //**************************************************************************************************
 // @Function      user_delay_ms()
 //--------------------------------------------------------------------------------------------------
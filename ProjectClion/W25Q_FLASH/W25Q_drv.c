@@ -37,19 +37,50 @@
 // Native header
 #include "W25Q_drv.h"
 
+#if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+// QUADSPI backend
+#include "W25Q_qspi.h"
+#else
 // LL HAL
 #include "stm32l4xx_ll_spi.h"
 #include "stm32l4xx_ll_gpio.h"
+#endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
 
 #include "Init.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
+
+#include <string.h>
 
 //**************************************************************************************************
 // Verification of the imported configuration parameters
 //**************************************************************************************************
 
-// None.
+#if (W25Q_BACKEND_SPI != W25Q_BACKEND) && (W25Q_BACKEND_QSPI != W25Q_BACKEND)
+#error "W25Q_BACKEND must be W25Q_BACKEND_SPI or W25Q_BACKEND_QSPI"
+#endif
+
+#if (ON == W25Q_SFDP_EN) && (0U == W25Q_SFDP_QTY_ATTEMPTS)
+#error "W25Q_SFDP_QTY_ATTEMPTS must be greater than 0"
+#endif
+
+#if (0U == W25Q_POLL_INITIAL_US)
+#error "W25Q_POLL_INITIAL_US must be greater than 0"
+#endif
+
+#if (ON == W25Q_CACHE_EN) && (0U == W25Q_CACHE_QTY_LINES)
+#error "W25Q_CACHE_QTY_LINES must be greater than 0"
+#endif
+
+#if (ON == W25Q_CACHE_EN) && ((0U == W25Q_CACHE_LINE_BYTES) || \
+                              (0U != (W25Q_CACHE_LINE_BYTES & (W25Q_CACHE_LINE_BYTES - 1U))))
+#error "W25Q_CACHE_LINE_BYTES must be a power of 2"
+#endif
+
+#if (ON == W25Q_LATENCY_HISTOGRAM_EN) && (0U == W25Q_LATENCY_HISTOGRAM_BUCKETS)
+#error "W25Q_LATENCY_HISTOGRAM_BUCKETS must be greater than 0"
+#endif
 
 
 //**************************************************************************************************
@@ -76,6 +107,17 @@ typedef struct W25Q_TIMES_ITEM_str
     uint32_t nQuantityTimeout;
 }W25Q_TIMES_ITEM;
 
+#if (ON == W25Q_CACHE_EN)
+// Cached page
+typedef struct W25Q_CACHE_LINE_str
+{
+    uint32_t nAddress;
+    uint32_t nLastUse;
+    BOOLEAN  bValid;
+    uint8_t  aData[W25Q_CACHE_LINE_BYTES];
+}W25Q_CACHE_LINE;
+#endif // #if (ON == W25Q_CACHE_EN)
+
 typedef struct W25Q_TIMES_str
 {
     W25Q_TIMES_ITEM nPageProgram;
@@ -160,6 +202,8 @@ typedef struct W25Q_TIMES_str
 #define W25Q_CMD_RST_EN                 (0x66U)
 // Reset Device
 #define W25Q_CMD_RST_DEVICE             (99U)
+// Enter 4-Byte Address Mode
+#define W25Q_CMD_ENTER_4B_MODE          (0xB7U)
 
 
 // timeout value in US
@@ -181,11 +225,45 @@ typedef struct W25Q_TIMES_str
 #define W25Q_REG1_SEC_BIT           (1<<6U)
 #define W25Q_REG1_SRP_BIT           (1<<7U)
 
+#define W25Q_REG2_QE_BIT            (1<<1U)
+
+// Bit definition status reg-3 of the parts above 16 MB
+#define W25Q_REG3_ADS_BIT           (1<<0)
+
 #define W25Q_SIZE_ADR_WORD_BYTES    (3U)
+#define W25Q_SIZE_ADR4_WORD_BYTES   (4U)
 #define W25Q_SIZE_CMD_WORD_BYTES    (1U)
 // Page size bytes
 #define W25Q_SIZE_PAGE_BYTES        (256U)
 
+// SFDP
+// Signature "SFDP"
+#define W25Q_SFDP_SIGNATURE             (0x50444653UL)
+// Size of SFDP header and parameter header
+#define W25Q_SFDP_HEADER_SIZE           (8U)
+// Dummy bytes after address of the Read SFDP instruction
+#define W25Q_SFDP_DUMMY_BYTES           (1U)
+// JEDEC Basic Flash Parameter Table ID (LSB)
+#define W25Q_SFDP_BFPT_ID               (0x00U)
+// Quantity of the BFPT DWORDs used by the driver
+#define W25Q_SFDP_BFPT_QTY_DWORDS       (11U)
+// Minimal quantity of the BFPT DWORDs (JESD216)
+#define W25Q_SFDP_BFPT_MIN_DWORDS       (9U)
+// BFPT DWORD1: address bytes
+#define W25Q_SFDP_ADR_BYTES_POS         (17U)
+#define W25Q_SFDP_ADR_BYTES_MASK        (0x3UL)
+#define W25Q_SFDP_ADR_BYTES_4_ONLY      (2U)
+// BFPT DWORD2: density
+#define W25Q_SFDP_DENSITY_POW2_BIT      (0x80000000UL)
+// Maximal supported density, 2^N bits (4 GB)
+#define W25Q_SFDP_DENSITY_MAX_POW2      (34U)
+// Maximal size of the block, bytes (2^N)
+#define W25Q_SFDP_BLOCK_MAX_POW2        (16U)
+// Size of 32 KB block, bytes
+#define W25Q_SIZE_BLOCK_32KB_BYTES      (32768UL)
+// Capacity available with 3-byte address
+#define W25Q_CAPACITY_3B_ADR_BYTES      (16777216UL)
+
 // Timings
 #define W25Q_PAGE_PRM_TIME_US       (3000UL)
 #define W25Q_4KB_ER_TIME_US         (10000UL)//(400000UL)
@@ -217,8 +295,50 @@ static const W25Q_TIMES W25Q_Times= {
         {W25Q_NONE_TIME_US,W25Q_NONE_QTY_TIMEOUT}
         };
 
+#if (W25Q_BACKEND_SPI == W25Q_BACKEND)
 // SPI handler
 SPI_HandleTypeDef SpiHandle;
+#endif // #if (W25Q_BACKEND_SPI == W25Q_BACKEND)
+
+// Geometry of the flash memory
+static W25Q_GEOMETRY W25Q_Geometry = {
+        W25Q_CAPACITY_ALL_MEMORY_BYTES,
+        W25Q_CAPACITY_SECTOR_BYTES,
+        W25Q_CAPACITY_BLOCK,
+        W25Q_SIZE_PAGE_BYTES,
+        W25Q_QTY_SECTORS,
+        W25Q_QTY_BLOCKS,
+        W25Q_SIZE_ADR_WORD_BYTES,
+        FALSE
+        };
+
+// Mutex of the driver, the flash is shared by the tasks
+static SemaphoreHandle_t W25Q_xMutex = NULL;
+
+#if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+// Latency histograms of the flash operations
+static W25Q_LATENCY_HIST W25Q_aLatencyHist[W25Q_OP_QTY];
+#endif // #if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+
+#if (ON == W25Q_CACHE_EN)
+// Cached pages
+static W25Q_CACHE_LINE W25Q_aCache[W25Q_CACHE_QTY_LINES];
+// Use counter for LRU replacement
+static uint32_t W25Q_nCacheUseCnt = 0U;
+// Page cache statistics
+static W25Q_CACHE_STAT W25Q_CacheStat;
+#endif // #if (ON == W25Q_CACHE_EN)
+
+#if (ON == W25Q_AUTO_POWER_DOWN_EN)
+// Quantity of the operations in progress
+static uint32_t W25Q_nPowerRefCnt = 0U;
+// Tick of the last access
+static TickType_t W25Q_nLastAccessTick = 0U;
+// Tick of the last deep power-down
+static TickType_t W25Q_nPowerDownTick = 0U;
+// Power management statistics
+static W25Q_POWER_STAT W25Q_PowerStat;
+#endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
 
 
 
@@ -226,14 +346,70 @@ SPI_HandleTypeDef SpiHandle;
 // Declarations of local (private) functions
 //**************************************************************************************************
 
+// Send instruction and transfer data over the selected backend.
+static STD_RESULT W25Q_Transfer(uint8_t *const pCmd,
+                                const uint32_t lenCmd,
+                                uint8_t *const pData,
+                                const uint32_t lenData,
+                                const BOOLEAN bWrite);
+#if (W25Q_BACKEND_SPI == W25Q_BACKEND)
 // Set CS pin level.
 static void W25Q_SPI_SetCS(SPI_CS_LEVEL csLevel);
 // Read data from SPI.
 static STD_RESULT W25Q_ReadWriteSPI(uint8_t *dataPut, const uint32_t lenPut, uint8_t *dataGet, uint32_t lenGet);
-// read status regs.
-static STD_RESULT W25Q_ReadStatusReg(const uint8_t regNumber,uint8_t *const status);
 // write spi data.
 static STD_RESULT W25Q_WriteSPI(uint8_t *data, const uint32_t len);
+#else
+// Set the QE bit for the quad instructions.
+static STD_RESULT W25Q_EnableQuad(void);
+#endif // #if (W25Q_BACKEND_SPI == W25Q_BACKEND)
+// read status regs.
+static STD_RESULT W25Q_ReadStatusReg(const uint8_t regNumber,uint8_t *const status);
+// Enter deep power-down.
+static STD_RESULT W25Q_EnterPowerDown(void);
+// Release from deep power-down.
+static STD_RESULT W25Q_ReleasePowerDown(void);
+// Take the mutex of the driver.
+static void W25Q_Lock(void);
+// Give the mutex of the driver.
+static void W25Q_Unlock(void);
+#if (ON == W25Q_AUTO_POWER_DOWN_EN)
+// Take the chip for an operation, wake it up if needed.
+static void W25Q_PowerAcquire(void);
+// Return the chip after an operation.
+static void W25Q_PowerRelease(void);
+#else
+#define W25Q_PowerAcquire()     W25Q_Lock()
+#define W25Q_PowerRelease()     W25Q_Unlock()
+#endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+// Read data over SPI or QUADSPI.
+static STD_RESULT W25Q_ReadDataSPI(const uint32_t adr, uint8_t *const data, const uint32_t len);
+#if (ON == W25Q_CACHE_EN)
+// Read data through the page cache.
+static STD_RESULT W25Q_CacheRead(const uint32_t adr, uint8_t *const data, const uint32_t len);
+// Invalidate cached pages of the area.
+static void W25Q_CacheInvalidate(const uint32_t adr, const uint32_t len);
+#endif // #if (ON == W25Q_CACHE_EN)
+// Put address of the instruction.
+static uint32_t W25Q_SetAddress(uint8_t *const pAddress, const uint32_t adr);
+#if (ON == W25Q_SFDP_EN)
+// Detect geometry and switch the addressing of the chip.
+static STD_RESULT W25Q_DetectGeometry(void);
+// Read geometry from the SFDP table.
+static STD_RESULT W25Q_ReadGeometrySFDP(W25Q_GEOMETRY *const pGeometry);
+// Read data from the SFDP table.
+static STD_RESULT W25Q_ReadSFDP(const uint32_t adr, uint8_t *const data, const uint32_t len);
+#endif // #if (ON == W25Q_SFDP_EN)
+// Wait while W25Q is busy.
+static STD_RESULT W25Q_WaitWhileBusy(const W25Q_TIMES_ITEM *const pTimes,
+                                     const W25Q_OPERATION enOperation);
+#if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+// Add latency of the operation to the histogram.
+static void W25Q_UpdateLatencyHist(const W25Q_OPERATION enOperation,
+                                   const uint32_t nTimeUs,
+                                   const uint32_t nPolls,
+                                   const BOOLEAN bTimeout);
+#endif // #if (ON == W25Q_LATENCY_HISTOGRAM_EN)
 
 
 
@@ -246,16 +422,32 @@ static STD_RESULT W25Q_WriteSPI(uint8_t *data, const uint32_t len);
 //**************************************************************************************************
 // @Function      W25Q_Init()
 //--------------------------------------------------------------------------------------------------
-// @Description   Init SPI interface.
+// @Description   Init SPI or QUADSPI interface.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         The interface is selected by W25Q_BACKEND. The geometry is detected by the
+//                SFDP table, parts above 16 MB are switched to 4-byte addressing. On error the
+//                chip must not be used: the addresses of the data are unknown.
 //--------------------------------------------------------------------------------------------------
-// @ReturnValue   None.
+// @ReturnValue   RESULT_OK - geometry is detected, RESULT_NOT_OK - SFDP or 4-byte mode error.
 //--------------------------------------------------------------------------------------------------
 // @Parameters    None.
 //**************************************************************************************************
-void W25Q_Init(void)
+STD_RESULT W25Q_Init(void)
 {
+    STD_RESULT enResult = RESULT_OK;
+
+    if (NULL == W25Q_xMutex)
+    {
+        W25Q_xMutex = xSemaphoreCreateRecursiveMutex();
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+    W25Q_QSPI_Init();
+    #else
     GPIO_InitTypeDef  GPIO_InitStruct = {0};
 
     // Configure the CS pin SPI for W25Q
@@ -307,8 +499,36 @@ void W25Q_Init(void)
     HAL_SPI_Init(&SpiHandle);
 
     LL_SPI_Enable(SpiHandle.Instance);
+    #endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
 
     pW25Q_Delay = W25Q_Delay;
+
+    // The chip keeps deep power-down over the MCU standby
+    W25Q_ReleasePowerDown();
+
+    #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+    W25Q_nLastAccessTick = xTaskGetTickCount();
+    #endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+
+    #if (ON == W25Q_SFDP_EN)
+    // The geometry and the addressing are detected again after a glitch of the bus,
+    // the default geometry is never used in place of the detected one
+    enResult = RESULT_NOT_OK;
+    for (uint32_t i = 0U; (i < W25Q_SFDP_QTY_ATTEMPTS) && (RESULT_OK != enResult); i++)
+    {
+        enResult = W25Q_DetectGeometry();
+    }
+    #endif // #if (ON == W25Q_SFDP_EN)
+
+    #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+    // Memory-mapped window follows the detected capacity
+    W25Q_QSPI_SetFlashSize(W25Q_Geometry.nCapacityBytes);
+
+    // On error the quad reads fail and the geometry is still valid
+    (void) W25Q_EnableQuad();
+    #endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+
+    return enResult;
 }// end of W25Q_Init()
 
 
@@ -336,7 +556,9 @@ STD_RESULT W25Q_ReadUniqueID(uint64_t* ID)
     dataPut[3] = (uint8_t)0xff;
     dataPut[4] = (uint8_t)0xff;
 
-    result = W25Q_ReadWriteSPI(dataPut,5U, (uint8_t*)ID, 8U);
+    W25Q_PowerAcquire();
+    result = W25Q_Transfer(dataPut,5U, (uint8_t*)ID, 8U, FALSE);
+    W25Q_PowerRelease();
 
     return result;
 }//end of W25Q_ReadUniqueID
@@ -363,7 +585,9 @@ STD_RESULT W25Q_ReadManufactureID(uint16_t* ID)
     dataPut[2] = (uint8_t)(0);
     dataPut[3] = (uint8_t)(0);
 
-    result = W25Q_ReadWriteSPI(dataPut,4U, (uint8_t*)ID, 2U);
+    W25Q_PowerAcquire();
+    result = W25Q_Transfer(dataPut,4U, (uint8_t*)ID, 2U, FALSE);
+    W25Q_PowerRelease();
 
     return result;
 }// W25Q_ReadManufactureID
@@ -374,7 +598,9 @@ STD_RESULT W25Q_ReadManufactureID(uint16_t* ID)
 //--------------------------------------------------------------------------------------------------
 // @Description   Read W25Q Flash Data.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         Reads up to one page go through the page cache (W25Q_CACHE_EN),
+//                longer reads go directly to the flash. The cache is shared by the tasks,
+//                the lookup and the fill run with the mutex of the driver taken.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
@@ -385,41 +611,26 @@ STD_RESULT W25Q_ReadManufactureID(uint16_t* ID)
 STD_RESULT W25Q_ReadData(const uint32_t adr,uint8_t* data, const uint32_t len)
 {
     STD_RESULT result = RESULT_OK;
-    uint8_t status=0;
-    uint8_t cmd = 0;
-    uint32_t timeoutCnt=0;
-    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR_WORD_BYTES];
 
-    //check BUSY W25Q
-    cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
-    status = 0xff;
-    for(uint32_t nQtyTimeout=0;nQtyTimeout < W25Q_Times.nNone.nQuantityTimeout;nQtyTimeout++)
+    #if (ON == W25Q_CACHE_EN)
+    W25Q_Lock();
+    if (len <= W25Q_CACHE_LINE_BYTES)
     {
-        if (RESULT_OK == W25Q_ReadWriteSPI(&cmd, W25Q_SIZE_CMD_WORD_BYTES, &status, 1))
-        {
-            if ((status & W25Q_REG1_BUSY_BIT) == 0)
-            {
-                // Read data
-                dataPut[0] = (uint8_t)W25Q_CMD_READ_DATA;
-                dataPut[1] = (uint8_t)(adr>>16);
-                dataPut[2] = (uint8_t)(adr>>8);
-                dataPut[3] = (uint8_t)adr;
-
-                if (RESULT_NOT_OK == W25Q_ReadWriteSPI(dataPut,
-                                                       W25Q_SIZE_CMD_WORD_BYTES + W25Q_SIZE_ADR_WORD_BYTES, \
-                                                data,
-                                                len))
-                {
-                    result = RESULT_NOT_OK;
-                }
-                break;
-            }
-            else
-            {
-                pW25Q_Delay(W25Q_Times.nNone.nTimeout+W25Q_Times.nNone.nTimeout/10);
-            }
-        }
+        result = W25Q_CacheRead(adr, data, len);
+    }
+    else
+    {
+        // Long reads don't evict the cached pages
+        W25Q_CacheStat.nBypass++;
+        W25Q_CacheStat.nBytesRequested += len;
+        W25Q_CacheStat.nBytesSpi += len;
+
+        result = W25Q_ReadDataSPI(adr, data, len);
     }
+    W25Q_Unlock();
+    #else
+    result = W25Q_ReadDataSPI(adr, data, len);
+    #endif // #if (ON == W25Q_CACHE_EN)
 
     return result;
 
@@ -444,82 +655,70 @@ STD_RESULT W25Q_WriteData(uint32_t adr,uint8_t* data, uint32_t len)
 {
     STD_RESULT result = RESULT_OK;
     uint8_t cmd = 0;
-    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR_WORD_BYTES];
+    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR4_WORD_BYTES];
+    uint32_t lenCmd = 0;
     uint32_t len_write=0;
-    uint8_t status=0;
-    uint32_t timeoutCnt=0;
     uint32_t indexBuf=0;
 
+    W25Q_PowerAcquire();
+
     // check capacity
-    if((adr + len - 1U) < W25Q_CAPACITY_ALL_MEMORY_BYTES)
+    if((adr + len - 1U) < W25Q_Geometry.nCapacityBytes)
     {
+        #if (ON == W25Q_CACHE_EN)
+        W25Q_CacheInvalidate(adr, len);
+        #endif // #if (ON == W25Q_CACHE_EN)
+
         while(len != 0)
         {
+            // Program up to the end of the current page
+            len_write = W25Q_Geometry.nPageBytes - (adr & (W25Q_Geometry.nPageBytes - 1U));
+            if (len < len_write)
+            {
+                len_write = len;
+            }
+
             //check BUSY W25Q
-            cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
-            status = 0xff;
-            for(uint32_t nQtyTimeout=0;nQtyTimeout < W25Q_Times.nPageProgram.nQuantityTimeout;nQtyTimeout++)
+            if (RESULT_OK == W25Q_WaitWhileBusy(&W25Q_Times.nNone, W25Q_OP_WAIT_READY))
             {
-                if (RESULT_OK ==  W25Q_ReadWriteSPI(&cmd,
-                                                    W25Q_SIZE_CMD_WORD_BYTES,
-                                                    &status,
-                                                    1))
+                // Write enable instruction
+                cmd = (uint8_t) W25Q_CMD_WRITE_EN;
+                if (RESULT_OK == W25Q_Transfer(&cmd,
+                                               W25Q_SIZE_CMD_WORD_BYTES,
+                                               0,
+                                               0,
+                                               FALSE))
                 {
-                    if ((status & W25Q_REG1_BUSY_BIT) == 0U)
+                    dataPut[0] = (uint8_t) W25Q_CMD_PAGE_PROGRAM;
+                    lenCmd = W25Q_SIZE_CMD_WORD_BYTES + W25Q_SetAddress(&dataPut[1], adr);
+                    if (RESULT_OK == W25Q_Transfer(dataPut,
+                                                   lenCmd,
+                                                   &data[indexBuf],
+                                                   len_write,
+                                                   TRUE))
                     {
-                        // Write enable instruction
-                        cmd = (uint8_t) W25Q_CMD_WRITE_EN;
-                        if (RESULT_OK == W25Q_ReadWriteSPI(&cmd,
-                                                           W25Q_SIZE_CMD_WORD_BYTES,
-                                                           0,
-                                                           0))
-                        {
-                            cmd = (uint8_t) W25Q_CMD_PAGE_PROGRAM;
-                            len_write = W25Q_SIZE_PAGE_BYTES - (adr & 0xff);
-                            if (len >= len_write)
-                            {
-                                dataPut[0] = cmd;
-                                dataPut[1] = (uint8_t)(adr>>16);
-                                dataPut[2] = (uint8_t)(adr>>8);
-                                dataPut[3] = (uint8_t)adr;
-                                if (RESULT_OK == W25Q_ReadWriteSPI(dataPut,
-                                                                   W25Q_SIZE_CMD_WORD_BYTES + W25Q_SIZE_ADR_WORD_BYTES,
-                                                                   &data[indexBuf],
-                                                                   len_write))
-                                {
-                                    adr += len_write;
-                                    len -= len_write;
-                                    indexBuf += len_write;
-                                    break;
-                                }
-                            }
-                            else
-                            {
-                                dataPut[0] = cmd;
-                                dataPut[1] = (uint8_t)(adr>>16);
-                                dataPut[2] = (uint8_t)(adr>>8);
-                                dataPut[3] = (uint8_t)adr;
-                                if (RESULT_OK == W25Q_ReadWriteSPI(dataPut,
-                                                                   W25Q_SIZE_CMD_WORD_BYTES + W25Q_SIZE_ADR_WORD_BYTES,
-                                                                   &data[indexBuf],
-                                                                   len))
-                                {
-                                    len=0;
-                                    break;
-                                }
-                            }
-                        }
+                        // Wait for the end of the page program
+                        result = W25Q_WaitWhileBusy(&W25Q_Times.nPageProgram, W25Q_OP_PAGE_PROGRAM);
+
+                        adr += len_write;
+                        len -= len_write;
+                        indexBuf += len_write;
                     }
                     else
                     {
-                        pW25Q_Delay(W25Q_Times.nPageProgram.nTimeout + W25Q_Times.nPageProgram.nTimeout/10);
+                        result = RESULT_NOT_OK;
                     }
                 }
+                else
+                {
+                    result = RESULT_NOT_OK;
+                }
             }
-            if ((status & W25Q_REG1_BUSY_BIT) == W25Q_REG1_BUSY_BIT)
+            else
             {
                 result = RESULT_NOT_OK;
             }
+
             if (RESULT_NOT_OK == result)
             {
                 break;
@@ -531,6 +730,8 @@ STD_RESULT W25Q_WriteData(uint32_t adr,uint8_t* data, uint32_t len)
         result = RESULT_NOT_OK;
     }
 
+    W25Q_PowerRelease();
+
     return result;
 
 }//end of W25Q_WriteData()
@@ -553,78 +754,74 @@ STD_RESULT W25Q_EraseBlock(const uint32_t adr, W25Q_TYPE_BLOCKS typeBlock)
 {
     STD_RESULT result = RESULT_OK;
     uint8_t cmd = 0;
-    uint8_t status=0;
-    uint32_t timeoutCnt=0;
-    uint32_t timeErase=0;
-    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR_WORD_BYTES];
-    uint8_t lenWrite=0;
+    uint32_t nSizeBlock = 0U;
+    const W25Q_TIMES_ITEM *pTimes = NULL;
+    W25Q_OPERATION enOperation = W25Q_OP_ERASE_4KB;
+    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR4_WORD_BYTES];
+    BOOLEAN bAddress = TRUE;
+    uint32_t lenWrite=0;
+
+    // erase BLOCK
+    switch(typeBlock)
+    {
+        case W25Q_BLOCK_MEMORY_4KB:
+            cmd = (uint8_t)W25Q_CMD_SECTOR_ERASE;
+            pTimes = &W25Q_Times.nErase4K;
+            enOperation = W25Q_OP_ERASE_4KB;
+            nSizeBlock = W25Q_Geometry.nSectorBytes;
+            break;
+        case W25Q_BLOCK_MEMORY_32KB:
+            cmd = (uint8_t)W25Q_CMD_BLOCK_ERASE_32;
+            pTimes = &W25Q_Times.nErase32K;
+            enOperation = W25Q_OP_ERASE_32KB;
+            nSizeBlock = W25Q_SIZE_BLOCK_32KB_BYTES;
+            break;
+        case W25Q_BLOCK_MEMORY_64KB:
+            cmd = (uint8_t)W25Q_CMD_BLOCK_ERASE_64;
+            pTimes = &W25Q_Times.nErase64K;
+            enOperation = W25Q_OP_ERASE_64KB;
+            nSizeBlock = W25Q_Geometry.nBlockBytes;
+            break;
+        case W25Q_BLOCK_MEMORY_ALL:
+            cmd = (uint8_t)W25Q_CMD_CHIP_ERASE;
+            pTimes = &W25Q_Times.nEraseChip;
+            enOperation = W25Q_OP_ERASE_CHIP;
+            nSizeBlock = W25Q_Geometry.nCapacityBytes;
+            bAddress = FALSE;
+            break;
+        default:
+            result = RESULT_NOT_OK;
+            break;
+    }
+
+    W25Q_PowerAcquire();
 
     // check adr
-    if(adr < W25Q_CAPACITY_ALL_MEMORY_BYTES)
+    if ((RESULT_OK == result) && (adr < W25Q_Geometry.nCapacityBytes))
     {
+        #if (ON == W25Q_CACHE_EN)
+        // The chip erases the whole block the address belongs to
+        W25Q_CacheInvalidate((TRUE == bAddress) ? (adr & ~(nSizeBlock - 1U)) : 0U, nSizeBlock);
+        #endif // #if (ON == W25Q_CACHE_EN)
+
         //check BUSY W25Q
-        cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
-        W25Q_ReadWriteSPI(&cmd, W25Q_SIZE_CMD_WORD_BYTES, &status, 1);
-        if ((status & W25Q_REG1_BUSY_BIT) == 0)
+        if (RESULT_OK == W25Q_WaitWhileBusy(&W25Q_Times.nNone, W25Q_OP_WAIT_READY))
         {
             // Write enable instruction
-            cmd = (uint8_t) W25Q_CMD_WRITE_EN;
-            if (RESULT_OK == W25Q_ReadWriteSPI(&cmd, W25Q_SIZE_CMD_WORD_BYTES, 0, 0))
+            dataPut[0] = (uint8_t) W25Q_CMD_WRITE_EN;
+            if (RESULT_OK == W25Q_Transfer(dataPut, W25Q_SIZE_CMD_WORD_BYTES, 0, 0, FALSE))
             {
-                // erase BLOCK
-                switch(typeBlock)
+                dataPut[0] = cmd;
+                lenWrite = W25Q_SIZE_CMD_WORD_BYTES;
+                if (TRUE == bAddress)
                 {
-                    case W25Q_BLOCK_MEMORY_4KB:
-                        cmd = (uint8_t)W25Q_CMD_SECTOR_ERASE;
-                        timeErase = W25Q_Times.nErase4K.nTimeout + W25Q_Times.nErase4K.nTimeout / 10;
-                        timeoutCnt = W25Q_Times.nErase4K.nQuantityTimeout;
-                        lenWrite = W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR_WORD_BYTES;
-                        break;
-                    case W25Q_BLOCK_MEMORY_32KB:
-                        cmd = (uint8_t)W25Q_CMD_BLOCK_ERASE_32;
-                        timeErase = W25Q_Times.nErase32K.nTimeout + W25Q_Times.nErase32K.nTimeout / 10;
-                        timeoutCnt = W25Q_Times.nErase32K.nQuantityTimeout;
-                        lenWrite = W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR_WORD_BYTES;
-                        break;
-                    case W25Q_BLOCK_MEMORY_64KB:
-                        cmd = (uint8_t)W25Q_CMD_BLOCK_ERASE_64;
-                        timeErase = W25Q_Times.nErase64K.nTimeout + W25Q_Times.nErase64K.nTimeout / 10;
-                        timeoutCnt = W25Q_Times.nErase64K.nQuantityTimeout;
-                        lenWrite = W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR_WORD_BYTES;
-                        break;
-                    case W25Q_BLOCK_MEMORY_ALL:
-                        cmd = (uint8_t)W25Q_CMD_CHIP_ERASE;
-                        timeErase = W25Q_Times.nEraseChip.nTimeout + W25Q_Times.nEraseChip.nTimeout / 10;
-                        timeoutCnt = W25Q_Times.nEraseChip.nQuantityTimeout;
-                        lenWrite = W25Q_SIZE_CMD_WORD_BYTES;
-                        break;
-                    default:cmd = (uint8_t)W25Q_CMD_SECTOR_ERASE;
+                    lenWrite += W25Q_SetAddress(&dataPut[1], adr);
                 }
-                dataPut[0] = cmd;
-                dataPut[1] = (uint8_t)(adr>>16);
-                dataPut[2] = (uint8_t)(adr>>8);
-                dataPut[3] = (uint8_t)adr;
 
-                if (RESULT_OK == W25Q_ReadWriteSPI(dataPut, lenWrite,0, 0))
+                if (RESULT_OK == W25Q_Transfer(dataPut, lenWrite,0, 0, FALSE))
                 {
                     // wait for erasure
-                    // check BUSY W25Q
-                    cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
-                    W25Q_ReadWriteSPI(&cmd, W25Q_SIZE_CMD_WORD_BYTES, &status, 1);
-                    while(((status & W25Q_REG1_BUSY_BIT) == W25Q_REG1_BUSY_BIT) && (timeoutCnt!=0))
-                    {
-                        pW25Q_Delay(timeErase);
-                        W25Q_ReadWriteSPI(&cmd, W25Q_SIZE_CMD_WORD_BYTES, &status, 1);
-                        timeoutCnt--;
-                    }
-                    if ((status & W25Q_REG1_BUSY_BIT) == 0)
-                    {
-                        result = RESULT_OK;
-                    }
-                    else
-                    {
-                        result = RESULT_NOT_OK;
-                    }
+                    result = W25Q_WaitWhileBusy(pTimes, enOperation);
                 }
                 else
                 {
@@ -646,6 +843,8 @@ STD_RESULT W25Q_EraseBlock(const uint32_t adr, W25Q_TYPE_BLOCKS typeBlock)
         result = RESULT_NOT_OK;
     }
 
+    W25Q_PowerRelease();
+
     return result;
 
 }// end of W25Q_EraseBlock()
@@ -667,41 +866,33 @@ STD_RESULT W25Q_EraseBlock(const uint32_t adr, W25Q_TYPE_BLOCKS typeBlock)
 STD_RESULT W25Q_GetLock(const uint32_t adr, uint8_t *const lock)
 {
     STD_RESULT result = RESULT_OK;
-    uint8_t status=0;
-    uint8_t cmd = 0;
-    uint32_t timeoutCnt=0;
-    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR_WORD_BYTES];
+    uint32_t lenCmd = 0;
+    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR4_WORD_BYTES];
+
+    W25Q_PowerAcquire();
 
     //check BUSY W25Q
-    cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
-    status = 0xff;
-    for(uint32_t nQtyTimeout=0;nQtyTimeout < W25Q_Times.nNone.nQuantityTimeout;nQtyTimeout++)
+    if (RESULT_OK == W25Q_WaitWhileBusy(&W25Q_Times.nNone, W25Q_OP_WAIT_READY))
     {
-        if (RESULT_OK == W25Q_ReadWriteSPI(&cmd, W25Q_SIZE_CMD_WORD_BYTES, &status, 1))
+        // Read data
+        dataPut[0] = (uint8_t)W25Q_CMD_READ_BLOCK_LOCK;
+        lenCmd = W25Q_SIZE_CMD_WORD_BYTES + W25Q_SetAddress(&dataPut[1], adr);
+
+        if (RESULT_NOT_OK == W25Q_Transfer(dataPut,
+                                           lenCmd,
+                                           lock,
+                                           1U,
+                                           FALSE))
         {
-            if ((status & W25Q_REG1_BUSY_BIT) == 0)
-            {
-                // Read data
-                dataPut[0] = (uint8_t)W25Q_CMD_READ_BLOCK_LOCK;
-                dataPut[1] = (uint8_t)(adr>>16);
-                dataPut[2] = (uint8_t)(adr>>8);
-                dataPut[3] = (uint8_t)adr;
-
-                if (RESULT_NOT_OK == W25Q_ReadWriteSPI(dataPut,
-                                                       W25Q_SIZE_CMD_WORD_BYTES + W25Q_SIZE_ADR_WORD_BYTES, \
-                                                lock,
-                                                       1U))
-                {
-                    result = RESULT_NOT_OK;
-                }
-                break;
-            }
-            else
-            {
-                pW25Q_Delay(W25Q_Times.nNone.nTimeout+W25Q_Times.nNone.nTimeout/10);
-            }
+            result = RESULT_NOT_OK;
         }
     }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    W25Q_PowerRelease();
 
     return result;
 }// end of W25Q_GetLock
@@ -722,46 +913,41 @@ STD_RESULT W25Q_GetLock(const uint32_t adr, uint8_t *const lock)
 STD_RESULT W25Q_UnLockGlobal(void)
 {
     STD_RESULT result = RESULT_OK;
-    uint8_t status = 0;
     uint8_t cmd = 0;
-    uint32_t timeoutCnt = 0;
     uint8_t dataPut = 0;
 
+    W25Q_PowerAcquire();
+
     //check BUSY W25Q
-    cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
-    status = 0xff;
-    for(uint32_t nQtyTimeout=0;nQtyTimeout < W25Q_Times.nNone.nQuantityTimeout;nQtyTimeout++)
+    if (RESULT_OK == W25Q_WaitWhileBusy(&W25Q_Times.nNone, W25Q_OP_WAIT_READY))
     {
-        if (RESULT_OK == W25Q_ReadWriteSPI(&cmd,
-                                           W25Q_SIZE_CMD_WORD_BYTES,
-                                           &status,
-                                           1))
+        // Write enable instruction
+        cmd = (uint8_t) W25Q_CMD_WRITE_EN;
+        if (RESULT_OK == W25Q_Transfer(&cmd, W25Q_SIZE_CMD_WORD_BYTES, 0, 0, FALSE))
         {
-            // Write enable instruction
-            cmd = (uint8_t) W25Q_CMD_WRITE_EN;
-            if (RESULT_OK == W25Q_ReadWriteSPI(&cmd, W25Q_SIZE_CMD_WORD_BYTES, 0, 0))
-            {
-                if ((status & W25Q_REG1_BUSY_BIT) == 0)
-                {
-                    // Write cmd
-                    dataPut = (uint8_t) W25Q_CMD_GLOBAL_BLOCK_UNLOCK;
+            // Write cmd
+            dataPut = (uint8_t) W25Q_CMD_GLOBAL_BLOCK_UNLOCK;
 
-                    if (RESULT_NOT_OK == W25Q_ReadWriteSPI(&dataPut,
-                                                           W25Q_SIZE_CMD_WORD_BYTES,
-                                                           0,
-                                                           0))
-                    {
-                        result = RESULT_NOT_OK;
-                    }
-                    break;
-                }
+            if (RESULT_NOT_OK == W25Q_Transfer(&dataPut,
+                                               W25Q_SIZE_CMD_WORD_BYTES,
+                                               0,
+                                               0,
+                                               FALSE))
+            {
+                result = RESULT_NOT_OK;
             }
         }
         else
         {
-            pW25Q_Delay(W25Q_Times.nNone.nTimeout + W25Q_Times.nNone.nTimeout / 10);
+            result = RESULT_NOT_OK;
         }
     }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    W25Q_PowerRelease();
 
     return result;
 }// end of W25Q_UnLockGlobal
@@ -788,7 +974,7 @@ STD_RESULT W25Q_IsAreaBlank(const uint32_t nAddress, const uint32_t nSize, BOOLE
 
     for (uint32_t i = 0; i < nSize; i++)
     {
-        if (RESULT_OK == W25Q_ReadData(nAdr,&data, 1U))
+        if (RESULT_OK == W25Q_ReadData(nAdr++,&data, 1U))
         {
             if (0xFF != data)
             {
@@ -809,154 +995,365 @@ STD_RESULT W25Q_IsAreaBlank(const uint32_t nAddress, const uint32_t nSize, BOOLE
 //**************************************************************************************************
 // @Function      W25Q_PowerDown()
 //--------------------------------------------------------------------------------------------------
-// @Description   None.
+// @Description   Enter deep power-down without the idle timeout.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         Refused while an operation is in progress. The chip is released from
+//                the deep power-down by the next access automatically.
+//                The mutex of the driver is taken, so the caller may wait for the current
+//                operation of another task.
 //--------------------------------------------------------------------------------------------------
-// @ReturnValue   None.
+// @ReturnValue   RESULT_OK - W25Q is in deep power-down, RESULT_NOT_OK - W25Q is busy.
 //--------------------------------------------------------------------------------------------------
 // @Parameters    None.
 //**************************************************************************************************
 STD_RESULT W25Q_PowerDown(void)
 {
     STD_RESULT enResult = RESULT_NOT_OK;
-    uint8_t cmd = 0;
-    uint8_t status = 0;
 
-    //check BUSY W25Q
-    cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
-    status = 0xff;
-
-    if (RESULT_OK ==  W25Q_ReadWriteSPI(&cmd,
-                                        W25Q_SIZE_CMD_WORD_BYTES,
-                                        &status,
-                                        1))
+    W25Q_Lock();
+    #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+    if (TRUE == W25Q_PowerStat.bPoweredDown)
     {
-        if ((status & W25Q_REG1_BUSY_BIT) == 0U)
-        {
-            // Power down instruction
-            cmd = (uint8_t) W25Q_CMD_POWER_DOWN;
-            if (RESULT_OK == W25Q_ReadWriteSPI(&cmd,
-                                               W25Q_SIZE_CMD_WORD_BYTES,
-                                               0,
-                                               0))
-            {
-                enResult = RESULT_OK;
-            }
-            else
-            {
-                enResult = RESULT_NOT_OK;
-            }
-        }
-        else
-        {
-            enResult = RESULT_NOT_OK;
-        }
+        enResult = RESULT_OK;
+    }
+    else if (0U == W25Q_nPowerRefCnt)
+    {
+        enResult = W25Q_EnterPowerDown();
     }
     else
     {
+        // Operation is in progress
         enResult = RESULT_NOT_OK;
     }
-
+    #else
+    enResult = W25Q_EnterPowerDown();
+    #endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+    W25Q_Unlock();
 
     return enResult;
 } // end of W25Q_PowerDown()
 
 
 
+#if (ON == W25Q_AUTO_POWER_DOWN_EN)
 //**************************************************************************************************
-//==================================================================================================
-// Definitions of local (private) functions
-//==================================================================================================
+// @Function      W25Q_PowerProcess()
+//--------------------------------------------------------------------------------------------------
+// @Description   Enter deep power-down when the chip is idle longer than W25Q_POWER_DOWN_IDLE_MS.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Should be called periodically. The chip is released from the deep power-down
+//                by the next access automatically. The mutex of the driver is taken, so
+//                the caller may wait for the current operation of another task.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
 //**************************************************************************************************
+void W25Q_PowerProcess(void)
+{
+    W25Q_Lock();
+    if ((0U == W25Q_nPowerRefCnt) &&
+        (FALSE == W25Q_PowerStat.bPoweredDown) &&
+        (((xTaskGetTickCount() - W25Q_nLastAccessTick) * portTICK_PERIOD_MS) >= W25Q_POWER_DOWN_IDLE_MS))
+    {
+        (void) W25Q_EnterPowerDown();
+    }
+    else
+    {
+        DoNothing();
+    }
+    W25Q_Unlock();
+} // end of W25Q_PowerProcess()
 
 
 
 //**************************************************************************************************
-// @Function      W25Q_ReadStatusReg()
+// @Function      W25Q_GetPowerStat()
 //--------------------------------------------------------------------------------------------------
-// @Description   Reading W25Q status reg-1 or reg-2 or reg-3.
+// @Description   Get power management statistics.
 //--------------------------------------------------------------------------------------------------
-// @Notes         None.
+// @Notes         The current deep power-down period is included in nPowerDownTimeMs.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    status - status reg-1,2,3
+// @Parameters    pStat - copy of the statistics.
 //**************************************************************************************************
-static STD_RESULT W25Q_ReadStatusReg(const uint8_t regNumber,uint8_t *const status)
+void W25Q_GetPowerStat(W25Q_POWER_STAT *const pStat)
 {
-    STD_RESULT result = RESULT_OK;
-    uint8_t cmd=0;
-
-    switch(regNumber)
+    taskENTER_CRITICAL();
+    *pStat = W25Q_PowerStat;
+    if (TRUE == W25Q_PowerStat.bPoweredDown)
     {
-        case W25Q_STATUS_REG1: cmd = (uint8_t)W25Q_CMD_READ_STATUS_REG_1;break;
-        case W25Q_STATUS_REG2: cmd = (uint8_t)W25Q_CMD_READ_STATUS_REG_2;break;
-        case W25Q_STATUS_REG3: cmd = (uint8_t)W25Q_CMD_READ_STATUS_REG_3;break;
-        default:result = RESULT_NOT_OK;
+        pStat->nPowerDownTimeMs += (xTaskGetTickCount() - W25Q_nPowerDownTick) * portTICK_PERIOD_MS;
     }
+    taskEXIT_CRITICAL();
+} // end of W25Q_GetPowerStat()
+#endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
 
-    if (RESULT_OK == result)
+
+
+#if (ON == W25Q_CACHE_EN)
+//**************************************************************************************************
+// @Function      W25Q_GetCacheStat()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get page cache statistics.
+//--------------------------------------------------------------------------------------------------
+// @Notes         nBytesSaved = nBytesRequested - nBytesSpi, it is negative when the
+//                page fills read more than was requested.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pStat - copy of the statistics.
+//**************************************************************************************************
+void W25Q_GetCacheStat(W25Q_CACHE_STAT *const pStat)
+{
+    W25Q_Lock();
+    *pStat = W25Q_CacheStat;
+    W25Q_Unlock();
+
+    if (0U != (pStat->nHits + pStat->nMisses))
     {
-        if (RESULT_NOT_OK == W25Q_ReadWriteSPI(&cmd, 1, status, 1))
-        {
-            result = RESULT_NOT_OK;
-        }
+        pStat->nHitRatePercent = (uint32_t)(((uint64_t)pStat->nHits * 100U) /
+                                            (pStat->nHits + pStat->nMisses));
+    }
+    else
+    {
+        pStat->nHitRatePercent = 0U;
     }
 
-    return result;
-}// end of W25Q_ReadStatusReg()
+    pStat->nBytesSaved = (int32_t)(pStat->nBytesRequested - pStat->nBytesSpi);
+} // end of W25Q_GetCacheStat()
 
 
 
 //**************************************************************************************************
-// @Function      W25Q_ReadWriteSPI()
+// @Function      W25Q_ResetCache()
 //--------------------------------------------------------------------------------------------------
-// @Description   Read SPI data.
+// @Description   Invalidate page cache and clear its statistics.
 //--------------------------------------------------------------------------------------------------
 // @Notes         None.
 //--------------------------------------------------------------------------------------------------
 // @ReturnValue   None.
 //--------------------------------------------------------------------------------------------------
-// @Parameters    data - pointer data.
-//                len - length data.
+// @Parameters    None.
 //**************************************************************************************************
-static STD_RESULT W25Q_ReadWriteSPI(uint8_t *dataPut, const uint32_t lenPut, uint8_t *dataGet, uint32_t lenGet)
+void W25Q_ResetCache(void)
 {
-    STD_RESULT result = RESULT_OK;
-    uint32_t cntTimeout=0;
+    W25Q_Lock();
+    for (uint32_t i = 0U; i < W25Q_CACHE_QTY_LINES; i++)
+    {
+        W25Q_aCache[i].bValid = FALSE;
+    }
 
-    // Set CS Low
-    W25Q_SPI_SetCS(LOW);
+    memset(&W25Q_CacheStat, 0, sizeof(W25Q_CacheStat));
+    W25Q_Unlock();
+} // end of W25Q_ResetCache()
+#endif // #if (ON == W25Q_CACHE_EN)
 
-    for (int i=0;i<lenPut+lenGet;i++)
-    {
-        // wait TXE flag
-        cntTimeout=0;
-        while(1)
-        {
-            if (SET == LL_SPI_IsActiveFlag_TXE(W25Q_SPI_NUM))
-            {
-                break;
-            }
-            if (cntTimeout > W25Q_QTY_TIMEOUT)
-            {
-                result = RESULT_NOT_OK;
-                break;
-            }
-            pW25Q_Delay(W25Q_TIMEOUT_US);
-            cntTimeout++;
-        }
-        if (RESULT_NOT_OK == result)
-        {
-            break;
-        }
-         // Clear RXNE
-        LL_SPI_ReceiveData8(W25Q_SPI_NUM);
 
-        if (i < lenPut)
-        {
-            taskENTER_CRITICAL();
+
+//**************************************************************************************************
+// @Function      W25Q_GetGeometry()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get geometry of the flash memory.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Geometry is detected by the SFDP table at W25Q_Init(). The default geometry
+//                from W25Q_drv_cfg.h is returned if W25Q_SFDP_EN is OFF. bSfdpValid is FALSE
+//                after the detection error, W25Q_Init() returns the error.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Pointer to the geometry.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+const W25Q_GEOMETRY* W25Q_GetGeometry(void)
+{
+    return &W25Q_Geometry;
+} // end of W25Q_GetGeometry()
+
+
+
+#if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+//**************************************************************************************************
+// @Function      W25Q_GetLatencyHist()
+//--------------------------------------------------------------------------------------------------
+// @Description   Get latency histogram of the flash operation.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Latency is the sum of the poll delays, SPI transfer time isn't included.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - histogram was copied, RESULT_NOT_OK - wrong parameters.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    enOperation - flash operation.
+//                pHist - copy of the histogram.
+//**************************************************************************************************
+STD_RESULT W25Q_GetLatencyHist(const W25Q_OPERATION enOperation, W25Q_LATENCY_HIST *const pHist)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+
+    if ((enOperation < W25Q_OP_QTY) && (NULL != pHist))
+    {
+        taskENTER_CRITICAL();
+        *pHist = W25Q_aLatencyHist[enOperation];
+        taskEXIT_CRITICAL();
+
+        enResult = RESULT_OK;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return enResult;
+} // end of W25Q_GetLatencyHist()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_ResetLatencyHist()
+//--------------------------------------------------------------------------------------------------
+// @Description   Clear latency histograms of all flash operations.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void W25Q_ResetLatencyHist(void)
+{
+    taskENTER_CRITICAL();
+    memset(W25Q_aLatencyHist, 0, sizeof(W25Q_aLatencyHist));
+    taskEXIT_CRITICAL();
+} // end of W25Q_ResetLatencyHist()
+#endif // #if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_ReadStatusReg()
+//--------------------------------------------------------------------------------------------------
+// @Description   Reading W25Q status reg-1 or reg-2 or reg-3.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    status - status reg-1,2,3
+//**************************************************************************************************
+static STD_RESULT W25Q_ReadStatusReg(const uint8_t regNumber,uint8_t *const status)
+{
+    STD_RESULT result = RESULT_OK;
+    uint8_t cmd=0;
+
+    switch(regNumber)
+    {
+        case W25Q_STATUS_REG1: cmd = (uint8_t)W25Q_CMD_READ_STATUS_REG_1;break;
+        case W25Q_STATUS_REG2: cmd = (uint8_t)W25Q_CMD_READ_STATUS_REG_2;break;
+        case W25Q_STATUS_REG3: cmd = (uint8_t)W25Q_CMD_READ_STATUS_REG_3;break;
+        default:result = RESULT_NOT_OK;
+    }
+
+    if (RESULT_OK == result)
+    {
+        if (RESULT_NOT_OK == W25Q_Transfer(&cmd, 1, status, 1, FALSE))
+        {
+            result = RESULT_NOT_OK;
+        }
+    }
+
+    return result;
+}// end of W25Q_ReadStatusReg()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_Transfer()
+//--------------------------------------------------------------------------------------------------
+// @Description   Send instruction and transfer data over the selected backend.
+//--------------------------------------------------------------------------------------------------
+// @Notes         SPI is full-duplex: the data bytes are clocked out in both directions and
+//                the received bytes are stored back to the buffer.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - transfer is done, RESULT_NOT_OK - interface error or timeout.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pCmd - instruction, address and dummy bytes.
+//                lenCmd - length of pCmd.
+//                pData - data to write or buffer to read.
+//                lenData - length data.
+//                bWrite - TRUE - data is sent to the flash, FALSE - data is read.
+//**************************************************************************************************
+static STD_RESULT W25Q_Transfer(uint8_t *const pCmd,
+                                const uint32_t lenCmd,
+                                uint8_t *const pData,
+                                const uint32_t lenData,
+                                const BOOLEAN bWrite)
+{
+    #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+    return W25Q_QSPI_Command(pCmd, lenCmd, pData, lenData, bWrite);
+    #else
+    (void) bWrite;
+    return W25Q_ReadWriteSPI(pCmd, lenCmd, pData, lenData);
+    #endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+}// end of W25Q_Transfer()
+
+
+
+#if (W25Q_BACKEND_SPI == W25Q_BACKEND)
+//**************************************************************************************************
+// @Function      W25Q_ReadWriteSPI()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read SPI data.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    data - pointer data.
+//                len - length data.
+//**************************************************************************************************
+static STD_RESULT W25Q_ReadWriteSPI(uint8_t *dataPut, const uint32_t lenPut, uint8_t *dataGet, uint32_t lenGet)
+{
+    STD_RESULT result = RESULT_OK;
+    uint32_t cntTimeout=0;
+
+    // Set CS Low
+    W25Q_SPI_SetCS(LOW);
+
+    for (int i=0;i<lenPut+lenGet;i++)
+    {
+        // wait TXE flag
+        cntTimeout=0;
+        while(1)
+        {
+            if (SET == LL_SPI_IsActiveFlag_TXE(W25Q_SPI_NUM))
+            {
+                break;
+            }
+            if (cntTimeout > W25Q_QTY_TIMEOUT)
+            {
+                result = RESULT_NOT_OK;
+                break;
+            }
+            pW25Q_Delay(W25Q_TIMEOUT_US);
+            cntTimeout++;
+        }
+        if (RESULT_NOT_OK == result)
+        {
+            break;
+        }
+         // Clear RXNE
+        LL_SPI_ReceiveData8(W25Q_SPI_NUM);
+
+        if (i < lenPut)
+        {
+            taskENTER_CRITICAL();
             LL_SPI_TransmitData8(W25Q_SPI_NUM, *dataPut);
             taskEXIT_CRITICAL();
             dataPut++;
@@ -1084,9 +1481,816 @@ static STD_RESULT W25Q_WriteSPI(uint8_t *data, const uint32_t len)
 
     return result;
 }// end of W25Q_WriteSPI()
+#else
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_EnableQuad()
+//--------------------------------------------------------------------------------------------------
+// @Description   Set the QE bit of the status reg-2 if it's cleared.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The volatile status register is written, so there is no wear of the
+//                non-volatile bits. The QE bit turns /WP and /HOLD into IO2 and IO3.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - QE bit is set, RESULT_NOT_OK - QUADSPI error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT W25Q_EnableQuad(void)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint8_t cmd = 0;
+    uint8_t status = 0;
+
+    if (RESULT_OK == W25Q_ReadStatusReg(W25Q_STATUS_REG2, &status))
+    {
+        if (0U != (status & W25Q_REG2_QE_BIT))
+        {
+            result = RESULT_OK;
+        }
+        else
+        {
+            cmd = (uint8_t) W25Q_CMD_SR_WRITE_EN;
+            if (RESULT_OK == W25Q_Transfer(&cmd, W25Q_SIZE_CMD_WORD_BYTES, 0, 0, FALSE))
+            {
+                cmd = (uint8_t) W25Q_CMD_WRITE_STATUS_REG_2;
+                status |= (uint8_t) W25Q_REG2_QE_BIT;
+                result = W25Q_Transfer(&cmd, W25Q_SIZE_CMD_WORD_BYTES, &status, 1U, TRUE);
+            }
+            else
+            {
+                result = RESULT_NOT_OK;
+            }
+        }
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+
+    return result;
+}// end of W25Q_EnableQuad()
+#endif // #if (W25Q_BACKEND_SPI == W25Q_BACKEND)
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_EnterPowerDown()
+//--------------------------------------------------------------------------------------------------
+// @Description   Send Power-down instruction if W25Q isn't busy.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - W25Q is in deep power-down, RESULT_NOT_OK - W25Q is busy or SPI error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT W25Q_EnterPowerDown(void)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+    uint8_t cmd = 0;
+    uint8_t status = 0;
+
+    //check BUSY W25Q
+    cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
+    status = 0xff;
+
+    if (RESULT_OK ==  W25Q_Transfer(&cmd,
+                                    W25Q_SIZE_CMD_WORD_BYTES,
+                                    &status,
+                                    1,
+                                    FALSE))
+    {
+        if ((status & W25Q_REG1_BUSY_BIT) == 0U)
+        {
+            // Power down instruction
+            cmd = (uint8_t) W25Q_CMD_POWER_DOWN;
+            if (RESULT_OK == W25Q_Transfer(&cmd,
+                                           W25Q_SIZE_CMD_WORD_BYTES,
+                                           0,
+                                           0,
+                                           FALSE))
+            {
+                pW25Q_Delay(W25Q_DP_TIME_US);
+
+                #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+                W25Q_PowerStat.bPoweredDown = TRUE;
+                W25Q_PowerStat.nPowerDownCnt++;
+                W25Q_nPowerDownTick = xTaskGetTickCount();
+                #endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+
+                enResult = RESULT_OK;
+            }
+            else
+            {
+                enResult = RESULT_NOT_OK;
+            }
+        }
+        else
+        {
+            enResult = RESULT_NOT_OK;
+        }
+    }
+    else
+    {
+        enResult = RESULT_NOT_OK;
+    }
+
+    return enResult;
+}// end of W25Q_EnterPowerDown()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_ReleasePowerDown()
+//--------------------------------------------------------------------------------------------------
+// @Description   Send Release Power-down instruction and wait tRES1.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The instruction is harmless when W25Q isn't powered down.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - W25Q is released, RESULT_NOT_OK - SPI error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT W25Q_ReleasePowerDown(void)
+{
+    STD_RESULT enResult = RESULT_NOT_OK;
+    uint8_t cmd = (uint8_t) W25Q_CMD_RELEASE_POWER_DOWN;
+
+    if (RESULT_OK == W25Q_Transfer(&cmd, W25Q_SIZE_CMD_WORD_BYTES, 0, 0, FALSE))
+    {
+        pW25Q_Delay(W25Q_RES1_TIME_US);
+        enResult = RESULT_OK;
+    }
+    else
+    {
+        enResult = RESULT_NOT_OK;
+    }
+
+    return enResult;
+}// end of W25Q_ReleasePowerDown()
+
+
+
+#if (ON == W25Q_AUTO_POWER_DOWN_EN)
+//**************************************************************************************************
+// @Function      W25Q_PowerAcquire()
+//--------------------------------------------------------------------------------------------------
+// @Description   Take the chip for an operation, release it from the deep power-down if needed.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Calls are nested, every call must be paired with W25Q_PowerRelease().
+//                The mutex of the driver is held until W25Q_PowerRelease(), so the SPI
+//                transfers and tRES1 run with the interrupts enabled.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void W25Q_PowerAcquire(void)
+{
+    W25Q_Lock();
+    W25Q_nPowerRefCnt++;
+
+    if (TRUE == W25Q_PowerStat.bPoweredDown)
+    {
+        // On error the next operation fails and the chip is released again next time
+        if (RESULT_OK == W25Q_ReleasePowerDown())
+        {
+            W25Q_PowerStat.bPoweredDown = FALSE;
+            W25Q_PowerStat.nWakeUpCnt++;
+            W25Q_PowerStat.nPowerDownTimeMs += (xTaskGetTickCount() - W25Q_nPowerDownTick) * portTICK_PERIOD_MS;
+        }
+    }
+}// end of W25Q_PowerAcquire()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_PowerRelease()
+//--------------------------------------------------------------------------------------------------
+// @Description   Return the chip after an operation and restart the idle timeout.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void W25Q_PowerRelease(void)
+{
+    if (0U != W25Q_nPowerRefCnt)
+    {
+        W25Q_nPowerRefCnt--;
+    }
+    W25Q_nLastAccessTick = xTaskGetTickCount();
+    W25Q_Unlock();
+}// end of W25Q_PowerRelease()
+#endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_Lock()
+//--------------------------------------------------------------------------------------------------
+// @Description   Take the mutex of the driver.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The mutex is recursive, calls are nested. Before the scheduler start there
+//                is only one thread and the mutex isn't used.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void W25Q_Lock(void)
+{
+    if ((NULL != W25Q_xMutex) &&
+        (taskSCHEDULER_NOT_STARTED != xTaskGetSchedulerState()))
+    {
+        (void) xSemaphoreTakeRecursive(W25Q_xMutex, portMAX_DELAY);
+    }
+    else
+    {
+        DoNothing();
+    }
+}// end of W25Q_Lock()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_Unlock()
+//--------------------------------------------------------------------------------------------------
+// @Description   Give the mutex of the driver.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Every call must be paired with W25Q_Lock().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static void W25Q_Unlock(void)
+{
+    if ((NULL != W25Q_xMutex) &&
+        (taskSCHEDULER_NOT_STARTED != xTaskGetSchedulerState()))
+    {
+        (void) xSemaphoreGiveRecursive(W25Q_xMutex);
+    }
+    else
+    {
+        DoNothing();
+    }
+}// end of W25Q_Unlock()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_ReadDataSPI()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read W25Q Flash Data over SPI or QUADSPI.
+//--------------------------------------------------------------------------------------------------
+// @Notes         QUADSPI backend uses the Fast Read Quad Output instruction. The status
+//                isn't polled while the memory-mapped mode is active: the mode is entered
+//                by a read only and any program/erase command leaves it.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - data was read, RESULT_NOT_OK - W25Q is busy or SPI error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    adr - absolute address flash memory
+//                data - pointer data
+//                len - length data
+//**************************************************************************************************
+static STD_RESULT W25Q_ReadDataSPI(const uint32_t adr, uint8_t *const data, const uint32_t len)
+{
+    STD_RESULT result = RESULT_OK;
+    #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+
+    W25Q_PowerAcquire();
+
+    //check BUSY W25Q
+    if ((TRUE == W25Q_QSPI_IsMemoryMapped()) ||
+        (RESULT_OK == W25Q_WaitWhileBusy(&W25Q_Times.nNone, W25Q_OP_WAIT_READY)))
+    {
+        result = W25Q_QSPI_ReadQuad(adr, W25Q_Geometry.nAddressBytes, data, len);
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+    #else
+    uint32_t lenCmd = 0;
+    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES+W25Q_SIZE_ADR4_WORD_BYTES];
+
+    W25Q_PowerAcquire();
+
+    //check BUSY W25Q
+    if (RESULT_OK == W25Q_WaitWhileBusy(&W25Q_Times.nNone, W25Q_OP_WAIT_READY))
+    {
+        // Read data
+        dataPut[0] = (uint8_t)W25Q_CMD_READ_DATA;
+        lenCmd = W25Q_SIZE_CMD_WORD_BYTES + W25Q_SetAddress(&dataPut[1], adr);
+
+        if (RESULT_NOT_OK == W25Q_Transfer(dataPut,
+                                           lenCmd,
+                                           data,
+                                           len,
+                                           FALSE))
+        {
+            result = RESULT_NOT_OK;
+        }
+    }
+    else
+    {
+        result = RESULT_NOT_OK;
+    }
+    #endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+
+    W25Q_PowerRelease();
+
+    return result;
+}// end of W25Q_ReadDataSPI()
+
+
+
+#if (ON == W25Q_CACHE_EN)
+//**************************************************************************************************
+// @Function      W25Q_CacheRead()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read data through the page cache.
+//--------------------------------------------------------------------------------------------------
+// @Notes         A missed page is read completely and replaces the least recently used page.
+//                Called with the mutex of the driver taken.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - data was read, RESULT_NOT_OK - W25Q is busy or SPI error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    adr - absolute address flash memory
+//                data - pointer data
+//                len - length data
+//**************************************************************************************************
+static STD_RESULT W25Q_CacheRead(const uint32_t adr, uint8_t *const data, const uint32_t len)
+{
+    STD_RESULT result = RESULT_OK;
+    uint32_t nOffset = 0U;
+    uint32_t nAdr = 0U;
+    uint32_t nLineAdr = 0U;
+    uint32_t nLineOffset = 0U;
+    uint32_t nChunk = 0U;
+    W25Q_CACHE_LINE *pLine = NULL;
+
+    W25Q_CacheStat.nBytesRequested += len;
+
+    while ((nOffset < len) && (RESULT_OK == result))
+    {
+        nAdr = adr + nOffset;
+        nLineAdr = nAdr & ~(W25Q_CACHE_LINE_BYTES - 1U);
+        nLineOffset = nAdr - nLineAdr;
+        nChunk = W25Q_CACHE_LINE_BYTES - nLineOffset;
+        if (nChunk > (len - nOffset))
+        {
+            nChunk = len - nOffset;
+        }
+
+        // Find the page, the least recently used page is the victim otherwise
+        pLine = &W25Q_aCache[0];
+        for (uint32_t i = 0U; i < W25Q_CACHE_QTY_LINES; i++)
+        {
+            if ((TRUE == W25Q_aCache[i].bValid) && (nLineAdr == W25Q_aCache[i].nAddress))
+            {
+                pLine = &W25Q_aCache[i];
+                break;
+            }
+            else if ((FALSE == W25Q_aCache[i].bValid) ||
+                     ((TRUE == pLine->bValid) && (W25Q_aCache[i].nLastUse < pLine->nLastUse)))
+            {
+                pLine = &W25Q_aCache[i];
+            }
+            else
+            {
+                DoNothing();
+            }
+        }
+
+        if ((TRUE == pLine->bValid) && (nLineAdr == pLine->nAddress))
+        {
+            W25Q_CacheStat.nHits++;
+        }
+        else
+        {
+            W25Q_CacheStat.nMisses++;
+            W25Q_CacheStat.nBytesSpi += W25Q_CACHE_LINE_BYTES;
+
+            pLine->bValid = FALSE;
+            if (RESULT_OK == W25Q_ReadDataSPI(nLineAdr, pLine->aData, W25Q_CACHE_LINE_BYTES))
+            {
+                pLine->nAddress = nLineAdr;
+                pLine->bValid = TRUE;
+            }
+            else
+            {
+                result = RESULT_NOT_OK;
+            }
+        }
+
+        if (RESULT_OK == result)
+        {
+            memcpy(&data[nOffset], &pLine->aData[nLineOffset], nChunk);
+            pLine->nLastUse = ++W25Q_nCacheUseCnt;
+            nOffset += nChunk;
+        }
+    }
+
+    return result;
+}// end of W25Q_CacheRead()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_CacheInvalidate()
+//--------------------------------------------------------------------------------------------------
+// @Description   Invalidate cached pages which overlap the area.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Called before the area is programmed or erased, with the mutex of
+//                the driver taken (see W25Q_PowerAcquire()).
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    adr - start address of the area
+//                len - length of the area
+//**************************************************************************************************
+static void W25Q_CacheInvalidate(const uint32_t adr, const uint32_t len)
+{
+    for (uint32_t i = 0U; i < W25Q_CACHE_QTY_LINES; i++)
+    {
+        if ((TRUE == W25Q_aCache[i].bValid) &&
+            ((W25Q_aCache[i].nAddress + W25Q_CACHE_LINE_BYTES) > adr) &&
+            (W25Q_aCache[i].nAddress < (adr + len)))
+        {
+            W25Q_aCache[i].bValid = FALSE;
+            W25Q_CacheStat.nInvalidations++;
+        }
+    }
+}// end of W25Q_CacheInvalidate()
+#endif // #if (ON == W25Q_CACHE_EN)
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_SetAddress()
+//--------------------------------------------------------------------------------------------------
+// @Description   Put address of the instruction MSB first.
+//--------------------------------------------------------------------------------------------------
+// @Notes         3 or 4 bytes depending on the detected geometry.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   Quantity of the address bytes.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pAddress - buffer of the address bytes.
+//                adr - absolute address flash memory.
+//**************************************************************************************************
+static uint32_t W25Q_SetAddress(uint8_t *const pAddress, const uint32_t adr)
+{
+    uint32_t nIndex = 0U;
+
+    if (W25Q_SIZE_ADR4_WORD_BYTES == W25Q_Geometry.nAddressBytes)
+    {
+        pAddress[nIndex++] = (uint8_t)(adr>>24);
+    }
+    pAddress[nIndex++] = (uint8_t)(adr>>16);
+    pAddress[nIndex++] = (uint8_t)(adr>>8);
+    pAddress[nIndex++] = (uint8_t)adr;
+
+    return nIndex;
+}// end of W25Q_SetAddress()
+
+
+
+#if (ON == W25Q_SFDP_EN)
+//**************************************************************************************************
+// @Function      W25Q_ReadGeometrySFDP()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read geometry from the JEDEC Basic Flash Parameter Table (JESD216).
+//--------------------------------------------------------------------------------------------------
+// @Notes         Sector is the smallest erase type, block is the largest erase type up to 64 KB.
+//                pGeometry isn't changed on error.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - geometry was read, RESULT_NOT_OK - SFDP isn't supported or invalid.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pGeometry - geometry of the flash memory.
+//**************************************************************************************************
+static STD_RESULT W25Q_ReadGeometrySFDP(W25Q_GEOMETRY *const pGeometry)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint8_t aHeader[W25Q_SFDP_HEADER_SIZE];
+    uint32_t aBfpt[W25Q_SFDP_BFPT_QTY_DWORDS];
+    uint32_t nQtyDwords = 0U;
+    uint32_t nTableAdr = 0U;
+    uint32_t nDensity = 0U;
+    uint32_t nCapacityBytes = 0U;
+    uint32_t nSectorPow2 = 0xFFU;
+    uint32_t nBlockPow2 = 0U;
+    uint32_t nPageBytes = W25Q_SIZE_PAGE_BYTES;
+
+    // SFDP header
+    if ((RESULT_OK == W25Q_ReadSFDP(0U, aHeader, W25Q_SFDP_HEADER_SIZE)) &&
+        (W25Q_SFDP_SIGNATURE == ((uint32_t)aHeader[0] | ((uint32_t)aHeader[1] << 8U) |
+                                 ((uint32_t)aHeader[2] << 16U) | ((uint32_t)aHeader[3] << 24U))))
+    {
+        // The first parameter header is always the Basic Flash Parameter Table
+        if ((RESULT_OK == W25Q_ReadSFDP(W25Q_SFDP_HEADER_SIZE, aHeader, W25Q_SFDP_HEADER_SIZE)) &&
+            (W25Q_SFDP_BFPT_ID == aHeader[0]) &&
+            (W25Q_SFDP_BFPT_MIN_DWORDS <= aHeader[3]))
+        {
+            nQtyDwords = aHeader[3];
+            if (nQtyDwords > W25Q_SFDP_BFPT_QTY_DWORDS)
+            {
+                nQtyDwords = W25Q_SFDP_BFPT_QTY_DWORDS;
+            }
+            nTableAdr = (uint32_t)aHeader[4] | ((uint32_t)aHeader[5] << 8U) | ((uint32_t)aHeader[6] << 16U);
+
+            // DWORDs are little endian as the MCU
+            if (RESULT_OK == W25Q_ReadSFDP(nTableAdr, (uint8_t*)aBfpt, nQtyDwords * 4U))
+            {
+                result = RESULT_OK;
+            }
+        }
+    }
+
+    if (RESULT_OK == result)
+    {
+        // DWORD2: density in bits
+        nDensity = aBfpt[1];
+        if (0U == (nDensity & W25Q_SFDP_DENSITY_POW2_BIT))
+        {
+            nCapacityBytes = (nDensity / 8U) + 1U;
+        }
+        else if ((nDensity & ~W25Q_SFDP_DENSITY_POW2_BIT) <= W25Q_SFDP_DENSITY_MAX_POW2)
+        {
+            nCapacityBytes = 1UL << ((nDensity & ~W25Q_SFDP_DENSITY_POW2_BIT) - 3U);
+        }
+        else
+        {
+            result = RESULT_NOT_OK;
+        }
+
+        // DWORD8, DWORD9: erase types, size 2^N bytes, 0 - not supported
+        for (uint32_t i = 0U; i < 4U; i++)
+        {
+            uint32_t nPow2 = (aBfpt[7U + (i / 2U)] >> (16U * (i % 2U))) & 0xFFU;
+
+            if (0U != nPow2)
+            {
+                if (nPow2 < nSectorPow2)
+                {
+                    nSectorPow2 = nPow2;
+                }
+                if ((nPow2 > nBlockPow2) && (nPow2 <= W25Q_SFDP_BLOCK_MAX_POW2))
+                {
+                    nBlockPow2 = nPow2;
+                }
+            }
+        }
+
+        // DWORD11: page size 2^N bytes (JESD216A and later)
+        if (W25Q_SFDP_BFPT_QTY_DWORDS <= nQtyDwords)
+        {
+            nPageBytes = 1UL << ((aBfpt[10] >> 4U) & 0xFU);
+        }
+
+        if ((RESULT_OK == result) && (0U != nBlockPow2) &&
+            (0U != nCapacityBytes) && ((1UL << nBlockPow2) <= nCapacityBytes))
+        {
+            pGeometry->nCapacityBytes = nCapacityBytes;
+            pGeometry->nSectorBytes = 1UL << nSectorPow2;
+            pGeometry->nBlockBytes = 1UL << nBlockPow2;
+            pGeometry->nPageBytes = nPageBytes;
+            pGeometry->nAddressBytes = W25Q_SIZE_ADR_WORD_BYTES;
+            pGeometry->bSfdpValid = TRUE;
+
+            // The driver supports 3-byte and 3/4-byte parts only
+            if (W25Q_SFDP_ADR_BYTES_4_ONLY ==
+                    ((aBfpt[0] >> W25Q_SFDP_ADR_BYTES_POS) & W25Q_SFDP_ADR_BYTES_MASK))
+            {
+                pGeometry->bSfdpValid = FALSE;
+                result = RESULT_NOT_OK;
+            }
+        }
+        else
+        {
+            result = RESULT_NOT_OK;
+        }
+    }
+
+    return result;
+}// end of W25Q_ReadGeometrySFDP()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_DetectGeometry()
+//--------------------------------------------------------------------------------------------------
+// @Description   Detect geometry by the SFDP table and switch the addressing of the chip.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Parts above 16 MB are switched to 4-byte addressing, the mode is checked by the
+//                ADS bit of the status reg-3. The geometry is changed on success only.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - geometry is detected, RESULT_NOT_OK - SFDP or 4-byte mode error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT W25Q_DetectGeometry(void)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    W25Q_GEOMETRY stGeometry = W25Q_Geometry;
+    uint8_t cmd = (uint8_t)W25Q_CMD_ENTER_4B_MODE;
+    uint8_t status = 0U;
+
+    W25Q_Geometry.bSfdpValid = FALSE;
+
+    if (RESULT_OK == W25Q_ReadGeometrySFDP(&stGeometry))
+    {
+        result = RESULT_OK;
+
+        // Addresses above 16 MB need 4-byte addressing
+        if (W25Q_CAPACITY_3B_ADR_BYTES < stGeometry.nCapacityBytes)
+        {
+            if ((RESULT_OK == W25Q_Transfer(&cmd, W25Q_SIZE_CMD_WORD_BYTES, 0, 0, FALSE)) &&
+                (RESULT_OK == W25Q_ReadStatusReg(W25Q_STATUS_REG3, &status)) &&
+                (0U != (status & W25Q_REG3_ADS_BIT)))
+            {
+                stGeometry.nAddressBytes = W25Q_SIZE_ADR4_WORD_BYTES;
+            }
+            else
+            {
+                result = RESULT_NOT_OK;
+            }
+        }
+        else
+        {
+            DoNothing();
+        }
+    }
+
+    if (RESULT_OK == result)
+    {
+        stGeometry.nQtySectors = stGeometry.nCapacityBytes / stGeometry.nSectorBytes;
+        stGeometry.nQtyBlocks = stGeometry.nCapacityBytes / stGeometry.nBlockBytes;
+        W25Q_Geometry = stGeometry;
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return result;
+}// end of W25Q_DetectGeometry()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_ReadSFDP()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read data from the SFDP table.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Read SFDP instruction always uses 3-byte address and 8 dummy clocks.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - data was read, RESULT_NOT_OK - SPI error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    adr - address in the SFDP table.
+//                data - pointer data.
+//                len - length data.
+//**************************************************************************************************
+static STD_RESULT W25Q_ReadSFDP(const uint32_t adr, uint8_t *const data, const uint32_t len)
+{
+    uint8_t dataPut[W25Q_SIZE_CMD_WORD_BYTES + W25Q_SIZE_ADR_WORD_BYTES + W25Q_SFDP_DUMMY_BYTES];
+
+    dataPut[0] = (uint8_t)W25Q_CMD_READ_SFDP_REG;
+    dataPut[1] = (uint8_t)(adr>>16);
+    dataPut[2] = (uint8_t)(adr>>8);
+    dataPut[3] = (uint8_t)adr;
+    dataPut[4] = (uint8_t)0xFF;
+
+    return W25Q_Transfer(dataPut, sizeof(dataPut), data, len, FALSE);
+}// end of W25Q_ReadSFDP()
+#endif // #if (ON == W25Q_SFDP_EN)
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_WaitWhileBusy()
+//--------------------------------------------------------------------------------------------------
+// @Description   Poll status reg-1 until the BUSY bit is cleared.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The first delay is W25Q_POLL_INITIAL_US, every next delay is doubled and
+//                limited by the datasheet time of the operation. The total wait is limited
+//                by the same budget as the fixed polling had: (time + 10%) * quantity.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - W25Q is ready, RESULT_NOT_OK - timeout or SPI error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pTimes - datasheet time and quantity of timeouts of the operation.
+//                enOperation - operation for the latency histogram.
+//**************************************************************************************************
+static STD_RESULT W25Q_WaitWhileBusy(const W25Q_TIMES_ITEM *const pTimes,
+                                     const W25Q_OPERATION enOperation)
+{
+    STD_RESULT result = RESULT_NOT_OK;
+    uint8_t cmd = (uint8_t) W25Q_CMD_READ_STATUS_REG_1;
+    uint8_t status = 0xff;
+    uint32_t nStepUs = W25Q_POLL_INITIAL_US;
+    uint32_t nElapsedUs = 0U;
+    uint32_t nPolls = 0U;
+    const uint32_t nMaxStepUs = pTimes->nTimeout + pTimes->nTimeout / 10U;
+    const uint32_t nBudgetUs = nMaxStepUs * pTimes->nQuantityTimeout;
+
+    while (RESULT_OK == W25Q_Transfer(&cmd, W25Q_SIZE_CMD_WORD_BYTES, &status, 1, FALSE))
+    {
+        nPolls++;
+
+        if ((status & W25Q_REG1_BUSY_BIT) == 0U)
+        {
+            result = RESULT_OK;
+            break;
+        }
+        else if (nElapsedUs >= nBudgetUs)
+        {
+            break;
+        }
+        else
+        {
+            // Limit delay by the datasheet time and by the rest of the budget
+            if (nStepUs > nMaxStepUs)
+            {
+                nStepUs = nMaxStepUs;
+            }
+            if (nStepUs > (nBudgetUs - nElapsedUs))
+            {
+                nStepUs = nBudgetUs - nElapsedUs;
+            }
+
+            pW25Q_Delay(nStepUs);
+            nElapsedUs += nStepUs;
+            nStepUs <<= 1U;
+        }
+    }
+
+    #if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+    W25Q_UpdateLatencyHist(enOperation,
+                           nElapsedUs,
+                           nPolls,
+                           (RESULT_OK == result) ? FALSE : TRUE);
+    #endif // #if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+
+    return result;
+}// end of W25Q_WaitWhileBusy()
+
+
+
+#if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+//**************************************************************************************************
+// @Function      W25Q_UpdateLatencyHist()
+//--------------------------------------------------------------------------------------------------
+// @Description   Add latency of the operation to the histogram.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Bucket N holds latencies 2^N..2^(N+1)-1 us, bucket 0 holds 0..1 us.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    enOperation - flash operation.
+//                nTimeUs - latency, us.
+//                nPolls - quantity of status polls.
+//                bTimeout - TRUE if operation wasn't finished in time.
+//**************************************************************************************************
+static void W25Q_UpdateLatencyHist(const W25Q_OPERATION enOperation,
+                                   const uint32_t nTimeUs,
+                                   const uint32_t nPolls,
+                                   const BOOLEAN bTimeout)
+{
+    W25Q_LATENCY_HIST *const pHist = &W25Q_aLatencyHist[enOperation];
+    uint32_t nBucket = 0U;
+    uint32_t nTime = nTimeUs;
+
+    while ((nTime > 1U) && (nBucket < (W25Q_LATENCY_HISTOGRAM_BUCKETS - 1U)))
+    {
+        nTime >>= 1U;
+        nBucket++;
+    }
+
+    pHist->aBuckets[nBucket]++;
+    pHist->nCount++;
+    pHist->nPolls += nPolls;
+    pHist->nTotalUs += nTimeUs;
+
+    if (nTimeUs > pHist->nMaxUs)
+    {
+        pHist->nMaxUs = nTimeUs;
+    }
+
+    if (TRUE == bTimeout)
+    {
+        pHist->nTimeouts++;
+    }
+}// end of W25Q_UpdateLatencyHist()
+#endif // #if (ON == W25Q_LATENCY_HISTOGRAM_EN)
 
 
 
+#if (W25Q_BACKEND_SPI == W25Q_BACKEND)
 //**************************************************************************************************
 // @Function      W25Q_SPI_SetCS()
 //--------------------------------------------------------------------------------------------------
@@ -1109,6 +2313,7 @@ static void W25Q_SPI_SetCS(SPI_CS_LEVEL csLevel)
         LL_GPIO_SetOutputPin(W25Q_SPI_CS_PORT,W25Q_SPI_CS_PIN);
     }
 }// end of W25Q_SPI_SetCS()
+#endif // #if (W25Q_BACKEND_SPI == W25Q_BACKEND)
 
 
 //****************************************** end of file *******************************************
\ No newline at end of file
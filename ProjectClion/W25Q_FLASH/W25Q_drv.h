@@ -42,6 +42,64 @@ typedef enum W25Q_TYPE_BLOCKS_enum
     W25Q_BLOCK_MEMORY_ALL
 }W25Q_TYPE_BLOCKS;
 
+// Geometry of the flash memory
+typedef struct W25Q_GEOMETRY_str
+{
+    uint32_t nCapacityBytes;
+    uint32_t nSectorBytes;
+    uint32_t nBlockBytes;
+    uint32_t nPageBytes;
+    uint32_t nQtySectors;
+    uint32_t nQtyBlocks;
+    uint8_t  nAddressBytes;
+    BOOLEAN  bSfdpValid;
+}W25Q_GEOMETRY;
+
+// Power management statistics
+typedef struct W25Q_POWER_STAT_str
+{
+    uint32_t nPowerDownCnt;
+    uint32_t nWakeUpCnt;
+    uint32_t nPowerDownTimeMs;
+    BOOLEAN  bPoweredDown;
+}W25Q_POWER_STAT;
+
+// Page cache statistics
+typedef struct W25Q_CACHE_STAT_str
+{
+    uint32_t nHits;
+    uint32_t nMisses;
+    uint32_t nBypass;
+    uint32_t nInvalidations;
+    uint32_t nBytesRequested;
+    uint32_t nBytesSpi;
+    uint32_t nHitRatePercent;
+    int32_t  nBytesSaved;
+}W25Q_CACHE_STAT;
+
+// Flash operations traced by the latency histogram
+typedef enum W25Q_OPERATION_enum
+{
+    W25Q_OP_PAGE_PROGRAM = 0,
+    W25Q_OP_ERASE_4KB,
+    W25Q_OP_ERASE_32KB,
+    W25Q_OP_ERASE_64KB,
+    W25Q_OP_ERASE_CHIP,
+    W25Q_OP_WAIT_READY,
+    W25Q_OP_QTY
+}W25Q_OPERATION;
+
+// Latency histogram of one flash operation
+typedef struct W25Q_LATENCY_HIST_str
+{
+    uint32_t aBuckets[W25Q_LATENCY_HISTOGRAM_BUCKETS];
+    uint32_t nCount;
+    uint32_t nPolls;
+    uint32_t nTimeouts;
+    uint32_t nMaxUs;
+    uint64_t nTotalUs;
+}W25Q_LATENCY_HIST;
+
 
 //**************************************************************************************************
 // Definitions of global (public) constants
@@ -62,7 +120,7 @@ typedef enum W25Q_TYPE_BLOCKS_enum
 //**************************************************************************************************
 
 // Init W25Q interface
-extern void W25Q_Init(void);
+extern STD_RESULT W25Q_Init(void);
 
 // Read unique ID
 extern STD_RESULT W25Q_ReadUniqueID(uint64_t* ID);
@@ -91,6 +149,33 @@ extern STD_RESULT W25Q_IsAreaBlank(const uint32_t nAddress, const uint32_t nSize
 // Power down
 extern STD_RESULT W25Q_PowerDown(void);
 
+// Get geometry of the flash memory
+extern const W25Q_GEOMETRY* W25Q_GetGeometry(void);
+
+#if (ON == W25Q_CACHE_EN)
+// Get page cache statistics
+extern void W25Q_GetCacheStat(W25Q_CACHE_STAT *const pStat);
+
+// Invalidate page cache and clear its statistics
+extern void W25Q_ResetCache(void);
+#endif // #if (ON == W25Q_CACHE_EN)
+
+#if (ON == W25Q_AUTO_POWER_DOWN_EN)
+// Enter deep power-down after the idle timeout
+extern void W25Q_PowerProcess(void);
+
+// Get power management statistics
+extern void W25Q_GetPowerStat(W25Q_POWER_STAT *const pStat);
+#endif // #if (ON == W25Q_AUTO_POWER_DOWN_EN)
+
+#if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+// Get latency histogram of the operation
+extern STD_RESULT W25Q_GetLatencyHist(const W25Q_OPERATION enOperation, W25Q_LATENCY_HIST *const pHist);
+
+// Clear all latency histograms
+extern void W25Q_ResetLatencyHist(void);
+#endif // #if (ON == W25Q_LATENCY_HISTOGRAM_EN)
+
 
 
 #endif // #ifndef W25Q_H
@@ -32,6 +32,13 @@
 // Valid values: ON / OFF
 #define MODULE_INTERNAL_DIAGNOSTICS             (OFF)
 
+// Interface to the flash memory, selected at build time.
+// W25Q_BACKEND_SPI  - SPI1, single line, byte polling.
+// W25Q_BACKEND_QSPI - QUADSPI, quad output fast read (see W25Q_qspi.c).
+#define W25Q_BACKEND_SPI                   (0U)
+#define W25Q_BACKEND_QSPI                  (1U)
+#define W25Q_BACKEND                       (W25Q_BACKEND_SPI)
+
 // Confugure SPI for W25Q
 #define W25Q_SPI_NUM                       SPI1
 #define W25Q_SPI_SCK_PIN                   GPIO_PIN_3
@@ -46,10 +53,41 @@
 #define W25Q_SPI_MOSI_AF                   GPIO_AF5_SPI1
 #define W25Q_SPI_MISO_AF                   GPIO_AF5_SPI1
 
+// Configure QUADSPI for W25Q.
+// QUADSPI pins of STM32L476 differ from SPI1: IO0/IO1 are PB1/PB0 and CLK/NCS
+// are shared with USART3 of the GSM, so the board must be reworked before
+// W25Q_BACKEND_QSPI is selected.
+#define W25Q_QSPI_CLK_PIN                  GPIO_PIN_10
+#define W25Q_QSPI_CLK_PORT                 GPIOB
+#define W25Q_QSPI_NCS_PIN                  GPIO_PIN_11
+#define W25Q_QSPI_NCS_PORT                 GPIOB
+#define W25Q_QSPI_IO0_PIN                  GPIO_PIN_1
+#define W25Q_QSPI_IO0_PORT                 GPIOB
+#define W25Q_QSPI_IO1_PIN                  GPIO_PIN_0
+#define W25Q_QSPI_IO1_PORT                 GPIOB
+#define W25Q_QSPI_IO2_PIN                  GPIO_PIN_7
+#define W25Q_QSPI_IO2_PORT                 GPIOA
+#define W25Q_QSPI_IO3_PIN                  GPIO_PIN_6
+#define W25Q_QSPI_IO3_PORT                 GPIOA
+#define W25Q_QSPI_AF                       GPIO_AF10_QUADSPI
+// QUADSPI clock = HCLK / (prescaler + 1)
+#define W25Q_QSPI_CLOCK_PRESCALER          (1U)
+// Timeout of the QUADSPI transfer, ms
+#define W25Q_QSPI_TIMEOUT_MS               (100U)
+
+// Enable/disable reads through the memory-mapped QUADSPI mode.
+// Any other command leaves the memory-mapped mode until the next read.
+// Valid values: ON / OFF
+#define W25Q_QSPI_MEMORY_MAPPED_EN         (OFF)
+// Release NCS after the idle time in the memory-mapped mode, QUADSPI clocks
+#define W25Q_QSPI_MAPPED_TIMEOUT_CLK       (16U)
+
 // User specify pointer delay function
 #define W25Q_Delay                   INIT_Delay
 
 // Capacity W25Q
+// Default geometry. It is used when W25Q_SFDP_EN is OFF, otherwise the geometry
+// is detected at W25Q_Init() (see W25Q_GetGeometry()).
 // Total memory capacity
 #define W25Q_CAPACITY_ALL_MEMORY_BYTES    (16777216UL)// (134217728UL) bits
 // Quantity of blocks
@@ -61,6 +99,45 @@
 // Capacity sector
 #define W25Q_CAPACITY_SECTOR_BYTES        (4096UL)
 
+// Enable/disable detection of the geometry by the SFDP table at W25Q_Init().
+// Parts above 16 MB are switched to 4-byte addressing.
+// Valid values: ON / OFF
+#define W25Q_SFDP_EN                      (ON)
+// Attempts to read the SFDP table and to enter 4-byte addressing. W25Q_Init()
+// returns an error after the last one, the default geometry is not used then.
+#define W25Q_SFDP_QTY_ATTEMPTS            (3U)
+
+// Enable/disable automatic deep power-down. The chip is powered down by
+// W25Q_PowerProcess() after the idle timeout and released on the next access.
+// Valid values: ON / OFF
+#define W25Q_AUTO_POWER_DOWN_EN           (ON)
+// Idle time before the deep power-down, ms
+#define W25Q_POWER_DOWN_IDLE_MS           (1000UL)
+// Time to enter the deep power-down tDP, us
+#define W25Q_DP_TIME_US                   (3U)
+// Time to release from the deep power-down tRES1, us
+#define W25Q_RES1_TIME_US                 (3U)
+
+// Enable/disable read-through LRU cache of the flash pages in front of W25Q_ReadData().
+// Writes and erases invalidate the cached pages.
+// Valid values: ON / OFF
+#define W25Q_CACHE_EN                     (ON)
+// Quantity of the cached pages
+#define W25Q_CACHE_QTY_LINES              (4U)
+// Size of the cached page, bytes. Valid values: power of 2
+#define W25Q_CACHE_LINE_BYTES             (256U)
+
+// Adaptive polling of the BUSY bit.
+// Delay before the second status poll, us. Every next delay is doubled
+// and limited by the datasheet maximum time of the operation.
+#define W25Q_POLL_INITIAL_US              (50UL)
+
+// Enable/disable the latency histogram of the flash operations.
+// Valid values: ON / OFF
+#define W25Q_LATENCY_HISTOGRAM_EN         (ON)
+// Quantity of log2 buckets of the histogram (bucket N holds 2^N..2^(N+1)-1 us)
+#define W25Q_LATENCY_HISTOGRAM_BUCKETS    (24U)
+
 #endif // #ifndef W25Q_CFG_H
 
 //****************************************** end of file *******************************************
@@ -0,0 +1,470 @@
+//**************************************************************************************************
+// @Module        W25Q
+// @Filename      W25Q_qspi.c
+//--------------------------------------------------------------------------------------------------
+// @Platform      stm32
+//--------------------------------------------------------------------------------------------------
+// @Compatible    stm32l4
+//--------------------------------------------------------------------------------------------------
+// @Description   QUADSPI backend of the W25Q driver.
+//
+//
+//                Abbreviations:
+//                  QSPI - QUADSPI peripheral.
+//
+//
+//                Global (public) functions:
+//                  W25Q_QSPI_Init()
+//                  W25Q_QSPI_SetFlashSize()
+//                  W25Q_QSPI_Command()
+//                  W25Q_QSPI_ReadQuad()
+//                  W25Q_QSPI_IsMemoryMapped()
+//
+//                Local (private) functions:
+//                  W25Q_QSPI_LeaveMemoryMapped()
+//                  W25Q_QSPI_AddressSize()
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          xx.xx.xxxx
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+// Native header
+#include "W25Q_qspi.h"
+
+#include <string.h>
+
+#if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+
+//**************************************************************************************************
+// Verification of the imported configuration parameters
+//**************************************************************************************************
+
+#if (W25Q_QSPI_CLOCK_PRESCALER > 255U)
+#error "W25Q_QSPI_CLOCK_PRESCALER must be less than 256"
+#endif
+
+
+//**************************************************************************************************
+// Definitions of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of local (private) data types
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Definitions of local (private) constants
+//**************************************************************************************************
+
+// Fast Read Quad Output instruction
+#define W25Q_QSPI_CMD_FAST_READ_QUAD    (0x6BU)
+// Dummy clocks of the Fast Read Quad Output instruction
+#define W25Q_QSPI_FAST_READ_DUMMY       (8U)
+// Max size of the address phase, bytes
+#define W25Q_QSPI_MAX_ADR_BYTES         (4U)
+// FIFO threshold, bytes
+#define W25Q_QSPI_FIFO_THRESHOLD        (4U)
+
+
+//**************************************************************************************************
+// Definitions of static global (private) variables
+//**************************************************************************************************
+
+// QSPI handler
+static QSPI_HandleTypeDef W25Q_QSPI_Handle;
+
+// Size of the flash memory
+static uint32_t W25Q_QSPI_nFlashBytes = W25Q_CAPACITY_ALL_MEMORY_BYTES;
+
+// Memory-mapped mode is active
+static BOOLEAN W25Q_QSPI_bMemoryMapped = FALSE;
+
+
+//**************************************************************************************************
+// Declarations of local (private) functions
+//**************************************************************************************************
+
+// Abort the memory-mapped mode before an indirect command
+static STD_RESULT W25Q_QSPI_LeaveMemoryMapped(void);
+
+// Get size of the address phase
+static uint32_t W25Q_QSPI_AddressSize(const uint32_t nAddressBytes);
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of global (public) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_QSPI_Init()
+//--------------------------------------------------------------------------------------------------
+// @Description   Init QUADSPI interface.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Flash size is set by default geometry, see W25Q_QSPI_SetFlashSize().
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+void W25Q_QSPI_Init(void)
+{
+    GPIO_InitTypeDef  GPIO_InitStruct = {0};
+
+    __HAL_RCC_QSPI_CLK_ENABLE();
+
+    // Configure the pins QUADSPI for W25Q
+    GPIO_InitStruct.Mode       = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull       = GPIO_NOPULL;
+    GPIO_InitStruct.Speed      = GPIO_SPEED_FREQ_VERY_HIGH;
+    GPIO_InitStruct.Alternate  = W25Q_QSPI_AF;
+
+    GPIO_InitStruct.Pin = W25Q_QSPI_CLK_PIN;
+    HAL_GPIO_Init(W25Q_QSPI_CLK_PORT, &GPIO_InitStruct);
+
+    GPIO_InitStruct.Pin = W25Q_QSPI_IO0_PIN;
+    HAL_GPIO_Init(W25Q_QSPI_IO0_PORT, &GPIO_InitStruct);
+
+    GPIO_InitStruct.Pin = W25Q_QSPI_IO1_PIN;
+    HAL_GPIO_Init(W25Q_QSPI_IO1_PORT, &GPIO_InitStruct);
+
+    // /WP and /HOLD must not float while the lines are released
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+
+    GPIO_InitStruct.Pin = W25Q_QSPI_NCS_PIN;
+    HAL_GPIO_Init(W25Q_QSPI_NCS_PORT, &GPIO_InitStruct);
+
+    GPIO_InitStruct.Pin = W25Q_QSPI_IO2_PIN;
+    HAL_GPIO_Init(W25Q_QSPI_IO2_PORT, &GPIO_InitStruct);
+
+    GPIO_InitStruct.Pin = W25Q_QSPI_IO3_PIN;
+    HAL_GPIO_Init(W25Q_QSPI_IO3_PORT, &GPIO_InitStruct);
+
+    W25Q_QSPI_Handle.Instance                = QUADSPI;
+    W25Q_QSPI_Handle.Init.ClockPrescaler     = W25Q_QSPI_CLOCK_PRESCALER;
+    W25Q_QSPI_Handle.Init.FifoThreshold      = W25Q_QSPI_FIFO_THRESHOLD;
+    W25Q_QSPI_Handle.Init.SampleShifting     = QSPI_SAMPLE_SHIFTING_HALFCYCLE;
+    W25Q_QSPI_Handle.Init.ChipSelectHighTime = QSPI_CS_HIGH_TIME_2_CYCLE;
+    W25Q_QSPI_Handle.Init.ClockMode          = QSPI_CLOCK_MODE_0;
+
+    W25Q_QSPI_SetFlashSize(W25Q_QSPI_nFlashBytes);
+}// end of W25Q_QSPI_Init()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_QSPI_SetFlashSize()
+//--------------------------------------------------------------------------------------------------
+// @Description   Set size of the flash memory and (re)init QUADSPI.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Size limits the memory-mapped window.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   None.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nCapacityBytes - size of the flash memory, power of 2.
+//**************************************************************************************************
+void W25Q_QSPI_SetFlashSize(const uint32_t nCapacityBytes)
+{
+    uint32_t nAddressBits = 0U;
+
+    while ((nAddressBits < 32U) && ((1UL << nAddressBits) < nCapacityBytes))
+    {
+        nAddressBits++;
+    }
+
+    (void) W25Q_QSPI_LeaveMemoryMapped();
+
+    W25Q_QSPI_nFlashBytes = nCapacityBytes;
+
+    // FSIZE + 1 is quantity of the address bits
+    W25Q_QSPI_Handle.Init.FlashSize = (0U != nAddressBits) ? (nAddressBits - 1U) : 0U;
+    HAL_QSPI_Init(&W25Q_QSPI_Handle);
+}// end of W25Q_QSPI_SetFlashSize()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_QSPI_Command()
+//--------------------------------------------------------------------------------------------------
+// @Description   Send the command with the optional data phase in the single line mode.
+//--------------------------------------------------------------------------------------------------
+// @Notes         Bytes after the instruction are sent as the address phase, so the bus
+//                sees the same bits as with the SPI backend (dummy bytes included).
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - command is done, RESULT_NOT_OK - QUADSPI error or timeout.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    pCmd - instruction and address.
+//                lenCmd - length of the instruction and address, 1..5 bytes.
+//                pData - data to write or buffer to read.
+//                lenData - length data, 0 - no data phase.
+//                bWrite - TRUE - data is sent to the flash, FALSE - data is read.
+//**************************************************************************************************
+STD_RESULT W25Q_QSPI_Command(const uint8_t *const pCmd,
+                             const uint32_t lenCmd,
+                             uint8_t *const pData,
+                             const uint32_t lenData,
+                             const BOOLEAN bWrite)
+{
+    STD_RESULT result = RESULT_OK;
+    QSPI_CommandTypeDef sCommand = {0};
+    uint32_t nAddressBytes = 0U;
+
+    if ((0U == lenCmd) || ((lenCmd - 1U) > W25Q_QSPI_MAX_ADR_BYTES) ||
+        ((0U != lenData) && (NULL == pData)))
+    {
+        result = RESULT_NOT_OK;
+    }
+    else
+    {
+        result = W25Q_QSPI_LeaveMemoryMapped();
+    }
+
+    if (RESULT_OK == result)
+    {
+        nAddressBytes = lenCmd - 1U;
+
+        sCommand.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+        sCommand.Instruction       = pCmd[0];
+        sCommand.AddressMode       = (0U != nAddressBytes) ? QSPI_ADDRESS_1_LINE : QSPI_ADDRESS_NONE;
+        sCommand.AddressSize       = W25Q_QSPI_AddressSize(nAddressBytes);
+        sCommand.Address           = 0U;
+        for (uint32_t i = 1U; i < lenCmd; i++)
+        {
+            sCommand.Address = (sCommand.Address << 8U) | pCmd[i];
+        }
+        sCommand.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+        sCommand.DummyCycles       = 0U;
+        sCommand.DataMode          = (0U != lenData) ? QSPI_DATA_1_LINE : QSPI_DATA_NONE;
+        sCommand.NbData            = lenData;
+        sCommand.DdrMode           = QSPI_DDR_MODE_DISABLE;
+        sCommand.DdrHoldHalfCycle  = QSPI_DDR_HHC_ANALOG_DELAY;
+        sCommand.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+        if (HAL_OK != HAL_QSPI_Command(&W25Q_QSPI_Handle, &sCommand, W25Q_QSPI_TIMEOUT_MS))
+        {
+            result = RESULT_NOT_OK;
+        }
+        else if (0U == lenData)
+        {
+            DoNothing();
+        }
+        else if (TRUE == bWrite)
+        {
+            if (HAL_OK != HAL_QSPI_Transmit(&W25Q_QSPI_Handle, pData, W25Q_QSPI_TIMEOUT_MS))
+            {
+                result = RESULT_NOT_OK;
+            }
+        }
+        else
+        {
+            if (HAL_OK != HAL_QSPI_Receive(&W25Q_QSPI_Handle, pData, W25Q_QSPI_TIMEOUT_MS))
+            {
+                result = RESULT_NOT_OK;
+            }
+        }
+    }
+
+    return result;
+}// end of W25Q_QSPI_Command()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_QSPI_ReadQuad()
+//--------------------------------------------------------------------------------------------------
+// @Description   Read data by the Fast Read Quad Output instruction.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The QE bit of the status reg-2 must be set. With W25Q_QSPI_MEMORY_MAPPED_EN
+//                the data is copied from the memory-mapped window, the mode stays active
+//                until the next command.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - data was read, RESULT_NOT_OK - QUADSPI error or timeout.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    adr - absolute address flash memory.
+//                nAddressBytes - 3 or 4 byte addressing.
+//                pData - pointer data.
+//                len - length data.
+//**************************************************************************************************
+STD_RESULT W25Q_QSPI_ReadQuad(const uint32_t adr,
+                              const uint8_t nAddressBytes,
+                              uint8_t *const pData,
+                              const uint32_t len)
+{
+    STD_RESULT result = RESULT_OK;
+    QSPI_CommandTypeDef sCommand = {0};
+
+    if ((NULL == pData) || (0U == len) ||
+        (adr >= W25Q_QSPI_nFlashBytes) || (len > (W25Q_QSPI_nFlashBytes - adr)))
+    {
+        result = RESULT_NOT_OK;
+    }
+    else
+    {
+        sCommand.InstructionMode   = QSPI_INSTRUCTION_1_LINE;
+        sCommand.Instruction       = W25Q_QSPI_CMD_FAST_READ_QUAD;
+        sCommand.AddressMode       = QSPI_ADDRESS_1_LINE;
+        sCommand.AddressSize       = W25Q_QSPI_AddressSize(nAddressBytes);
+        sCommand.Address           = adr;
+        sCommand.AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+        sCommand.DummyCycles       = W25Q_QSPI_FAST_READ_DUMMY;
+        sCommand.DataMode          = QSPI_DATA_4_LINES;
+        sCommand.NbData            = len;
+        sCommand.DdrMode           = QSPI_DDR_MODE_DISABLE;
+        sCommand.DdrHoldHalfCycle  = QSPI_DDR_HHC_ANALOG_DELAY;
+        sCommand.SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+
+        #if (ON == W25Q_QSPI_MEMORY_MAPPED_EN)
+        if (FALSE == W25Q_QSPI_bMemoryMapped)
+        {
+            QSPI_MemoryMappedTypeDef sMemMappedCfg = {0};
+
+            sMemMappedCfg.TimeOutActivation = QSPI_TIMEOUT_COUNTER_ENABLE;
+            sMemMappedCfg.TimeOutPeriod     = W25Q_QSPI_MAPPED_TIMEOUT_CLK;
+
+            if (HAL_OK == HAL_QSPI_MemoryMapped(&W25Q_QSPI_Handle, &sCommand, &sMemMappedCfg))
+            {
+                W25Q_QSPI_bMemoryMapped = TRUE;
+            }
+            else
+            {
+                result = RESULT_NOT_OK;
+            }
+        }
+
+        if (RESULT_OK == result)
+        {
+            memcpy(pData, (const uint8_t*)(QSPI_BASE + adr), len);
+        }
+        #else
+        if (HAL_OK != HAL_QSPI_Command(&W25Q_QSPI_Handle, &sCommand, W25Q_QSPI_TIMEOUT_MS))
+        {
+            result = RESULT_NOT_OK;
+        }
+        else if (HAL_OK != HAL_QSPI_Receive(&W25Q_QSPI_Handle, pData, W25Q_QSPI_TIMEOUT_MS))
+        {
+            result = RESULT_NOT_OK;
+        }
+        else
+        {
+            DoNothing();
+        }
+        #endif // #if (ON == W25Q_QSPI_MEMORY_MAPPED_EN)
+    }
+
+    return result;
+}// end of W25Q_QSPI_ReadQuad()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_QSPI_IsMemoryMapped()
+//--------------------------------------------------------------------------------------------------
+// @Description   Check the memory-mapped mode.
+//--------------------------------------------------------------------------------------------------
+// @Notes         The mode is entered by a read only, so the flash isn't busy while it's active.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   TRUE - memory-mapped mode is active, FALSE - indirect mode.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+BOOLEAN W25Q_QSPI_IsMemoryMapped(void)
+{
+    return W25Q_QSPI_bMemoryMapped;
+}// end of W25Q_QSPI_IsMemoryMapped()
+
+
+
+//**************************************************************************************************
+//==================================================================================================
+// Definitions of local (private) functions
+//==================================================================================================
+//**************************************************************************************************
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_QSPI_LeaveMemoryMapped()
+//--------------------------------------------------------------------------------------------------
+// @Description   Abort the memory-mapped mode.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   RESULT_OK - indirect mode is active, RESULT_NOT_OK - abort error.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    None.
+//**************************************************************************************************
+static STD_RESULT W25Q_QSPI_LeaveMemoryMapped(void)
+{
+    STD_RESULT result = RESULT_OK;
+
+    if (TRUE == W25Q_QSPI_bMemoryMapped)
+    {
+        if (HAL_OK == HAL_QSPI_Abort(&W25Q_QSPI_Handle))
+        {
+            W25Q_QSPI_bMemoryMapped = FALSE;
+        }
+        else
+        {
+            result = RESULT_NOT_OK;
+        }
+    }
+    else
+    {
+        DoNothing();
+    }
+
+    return result;
+}// end of W25Q_QSPI_LeaveMemoryMapped()
+
+
+
+//**************************************************************************************************
+// @Function      W25Q_QSPI_AddressSize()
+//--------------------------------------------------------------------------------------------------
+// @Description   Convert size of the address in bytes to the QUADSPI address size.
+//--------------------------------------------------------------------------------------------------
+// @Notes         None.
+//--------------------------------------------------------------------------------------------------
+// @ReturnValue   QSPI_ADDRESS_8_BITS..QSPI_ADDRESS_32_BITS.
+//--------------------------------------------------------------------------------------------------
+// @Parameters    nAddressBytes - size of the address, bytes.
+//**************************************************************************************************
+static uint32_t W25Q_QSPI_AddressSize(const uint32_t nAddressBytes)
+{
+    uint32_t nSize = QSPI_ADDRESS_24_BITS;
+
+    switch (nAddressBytes)
+    {
+        case 1U: nSize = QSPI_ADDRESS_8_BITS; break;
+        case 2U: nSize = QSPI_ADDRESS_16_BITS; break;
+        case 4U: nSize = QSPI_ADDRESS_32_BITS; break;
+        default: nSize = QSPI_ADDRESS_24_BITS; break;
+    }
+
+    return nSize;
+}// end of W25Q_QSPI_AddressSize()
+
+#endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+
+//****************************************** end of file *******************************************
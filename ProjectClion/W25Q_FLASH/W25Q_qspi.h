@@ -0,0 +1,79 @@
+//**************************************************************************************************
+// @Module        W25Q
+// @Filename      W25Q_qspi.h
+//--------------------------------------------------------------------------------------------------
+// @Description   Interface of the QUADSPI backend of the W25Q driver.
+//
+//--------------------------------------------------------------------------------------------------
+// @Version       1.0.0
+//--------------------------------------------------------------------------------------------------
+// @Date          xx.xx.xxxx
+//--------------------------------------------------------------------------------------------------
+// @History       Version  Author      Comment
+// XX.XX.XXXX     1.0.0    KPS         First release.
+//**************************************************************************************************
+
+#ifndef W25Q_QSPI_H
+#define W25Q_QSPI_H
+
+
+//**************************************************************************************************
+// Project Includes
+//**************************************************************************************************
+
+#include "W25Q_drv.h"
+
+//**************************************************************************************************
+// Declarations of global (public) data types
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Definitions of global (public) constants
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of global (public) variables
+//**************************************************************************************************
+
+// None.
+
+
+//**************************************************************************************************
+// Declarations of global (public) functions
+//**************************************************************************************************
+
+#if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+// Init QUADSPI interface
+extern void W25Q_QSPI_Init(void);
+
+// Set size of the flash memory
+extern void W25Q_QSPI_SetFlashSize(const uint32_t nCapacityBytes);
+
+// Single line command with the optional data phase
+extern STD_RESULT W25Q_QSPI_Command(const uint8_t *const pCmd,
+                                    const uint32_t lenCmd,
+                                    uint8_t *const pData,
+                                    const uint32_t lenData,
+                                    const BOOLEAN bWrite);
+
+// Quad output fast read
+extern STD_RESULT W25Q_QSPI_ReadQuad(const uint32_t adr,
+                                     const uint8_t nAddressBytes,
+                                     uint8_t *const pData,
+                                     const uint32_t len);
+
+// Memory-mapped mode is active
+extern BOOLEAN W25Q_QSPI_IsMemoryMapped(void);
+#endif // #if (W25Q_BACKEND_QSPI == W25Q_BACKEND)
+
+
+
+#endif // #ifndef W25Q_QSPI_H
+
+//****************************************** end of file *******************************************
@@ -1813,17 +1813,17 @@ MQTTStatus_t MQTT_Connect( MQTTContext_t * pContext,
     /* Read CONNACK from transport layer. */
     if( status == MQTTSuccess )
     {
-//        status = receiveConnack( pContext,
-//                                 timeoutMs,
-//                                 pConnectInfo->cleanSession,
-//                                 &incomingPacket,
-//                                 pSessionPresent );
+        status = receiveConnack( pContext,
+                                 timeoutMs,
+                                 pConnectInfo->cleanSession,
+                                 &incomingPacket,
+                                 pSessionPresent );
     }
 
     if( status == MQTTSuccess )
     {
         /* Resend PUBRELs when reestablishing a session, or clear records for new sessions. */
-//        status = handleSessionResumption( pContext, *pSessionPresent );
+        status = handleSessionResumption( pContext, *pSessionPresent );
     }
 
     if( status == MQTTSuccess )